@@ -1,6 +1,22 @@
 HEADERS += \
     $${INCLUDE_DIR}/boost/numeric/ublas/detail/vector_assign.hpp \
+    $${INCLUDE_DIR}/boost/numeric/ublas/detail/workspace.hpp \
     $${INCLUDE_DIR}/boost/numeric/ublas/detail/temporary.hpp \
+    $${INCLUDE_DIR}/boost/numeric/ublas/detail/strassen.hpp \
+    $${INCLUDE_DIR}/boost/numeric/ublas/detail/gemm.hpp \
+    $${INCLUDE_DIR}/boost/numeric/ublas/detail/simd.hpp \
+    $${INCLUDE_DIR}/boost/numeric/ublas/detail/simd_kernels.hpp \
+    $${INCLUDE_DIR}/boost/numeric/ublas/detail/thread_pool.hpp \
+    $${INCLUDE_DIR}/boost/numeric/ublas/detail/matrix_chain.hpp \
+    $${INCLUDE_DIR}/boost/numeric/ublas/detail/getrf.hpp \
+    $${INCLUDE_DIR}/boost/numeric/ublas/detail/trsm.hpp \
+    $${INCLUDE_DIR}/boost/numeric/ublas/detail/potrf.hpp \
+    $${INCLUDE_DIR}/boost/numeric/ublas/detail/geqrf.hpp \
+    $${INCLUDE_DIR}/boost/numeric/ublas/detail/spmv.hpp \
+    $${INCLUDE_DIR}/boost/numeric/ublas/detail/spgemm.hpp \
+    $${INCLUDE_DIR}/boost/numeric/ublas/detail/triplet_sort.hpp \
+    $${INCLUDE_DIR}/boost/numeric/ublas/detail/text_io.hpp \
+    $${INCLUDE_DIR}/boost/numeric/ublas/detail/dense_traits.hpp \
     $${INCLUDE_DIR}/boost/numeric/ublas/detail/returntype_deduction.hpp \
     $${INCLUDE_DIR}/boost/numeric/ublas/detail/raw.hpp \
     $${INCLUDE_DIR}/boost/numeric/ublas/detail/matrix_assign.hpp \
@@ -29,8 +29,10 @@ HEADERS += \
     $${INCLUDE_DIR}/boost/numeric/ublas/operations.hpp \
     $${INCLUDE_DIR}/boost/numeric/ublas/operation_blocked.hpp \
     $${INCLUDE_DIR}/boost/numeric/ublas/operation.hpp \
+    $${INCLUDE_DIR}/boost/numeric/ublas/qr.hpp \
     $${INCLUDE_DIR}/boost/numeric/ublas/matrix_sparse.hpp \
     $${INCLUDE_DIR}/boost/numeric/ublas/matrix_proxy.hpp \
+    $${INCLUDE_DIR}/boost/numeric/ublas/matrix_market.hpp \
     $${INCLUDE_DIR}/boost/numeric/ublas/matrix_expression.hpp \
     $${INCLUDE_DIR}/boost/numeric/ublas/matrix.hpp \
     $${INCLUDE_DIR}/boost/numeric/ublas/lu.hpp \
@@ -41,7 +43,9 @@ HEADERS += \
     $${INCLUDE_DIR}/boost/numeric/ublas/expression_types.hpp \
     $${INCLUDE_DIR}/boost/numeric/ublas/exception.hpp \
     $${INCLUDE_DIR}/boost/numeric/ublas/doxydoc.hpp \
+    $${INCLUDE_DIR}/boost/numeric/ublas/cholesky.hpp \
     $${INCLUDE_DIR}/boost/numeric/ublas/blas.hpp \
+    $${INCLUDE_DIR}/boost/numeric/ublas/binary_io.hpp \
     $${INCLUDE_DIR}/boost/numeric/ublas/banded.hpp \
     $${INCLUDE_DIR}/boost/numeric/ublas/assignment.hpp \
     $${INCLUDE_DIR}/boost/numeric/ublas/matrix_vector.hpp
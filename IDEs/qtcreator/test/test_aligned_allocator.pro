@@ -0,0 +1,14 @@
+TEMPLATE = app
+TARGET = test_aligned_allocator
+
+include (configuration.pri)
+
+HEADERS += \
+    ../../../test/utils.hpp
+
+SOURCES += \
+    ../../../test/test_aligned_allocator.cpp
+
+INCLUDEPATH += \
+    ../../../include
+LIBS += -lpthread
@@ -0,0 +1,14 @@
+TEMPLATE = app
+TARGET = test_assemble
+
+include (configuration.pri)
+
+HEADERS += \
+    ../../../test/utils.hpp
+
+SOURCES += \
+    ../../../test/test_assemble.cpp
+
+INCLUDEPATH += \
+    ../../../include
+LIBS += -lpthread
@@ -0,0 +1,14 @@
+TEMPLATE = app
+TARGET = test_binary_io
+
+include (configuration.pri)
+
+HEADERS += \
+    ../../../test/utils.hpp
+
+SOURCES += \
+    ../../../test/test_binary_io.cpp
+
+INCLUDEPATH += \
+    ../../../include
+LIBS += -lpthread
@@ -0,0 +1,15 @@
+TEMPLATE = app
+TARGET = test_cholesky
+
+include (configuration.pri)
+
+HEADERS += \
+    ../../../test/utils.hpp \
+    ../../../test/common/random.hpp
+
+SOURCES += \
+    ../../../test/test_cholesky.cpp
+
+INCLUDEPATH += \
+    ../../../include
+LIBS += -lpthread
@@ -0,0 +1,14 @@
+TEMPLATE = app
+TARGET = test_coordinate_radix_sort
+
+include (configuration.pri)
+
+HEADERS += \
+    ../../../test/utils.hpp
+
+SOURCES += \
+    ../../../test/test_coordinate_radix_sort.cpp
+
+INCLUDEPATH += \
+    ../../../include
+LIBS += -lpthread
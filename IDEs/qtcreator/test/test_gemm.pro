@@ -0,0 +1,13 @@
+TEMPLATE = app
+TARGET = test_gemm
+
+include (configuration.pri)
+
+HEADERS += \
+    ../../../test/utils.hpp
+
+SOURCES += \
+    ../../../test/test_gemm.cpp
+
+INCLUDEPATH += \
+    ../../../include
@@ -0,0 +1,14 @@
+TEMPLATE = app
+TARGET = test_leading_dimension
+
+include (configuration.pri)
+
+HEADERS += \
+    ../../../test/utils.hpp
+
+SOURCES += \
+    ../../../test/test_leading_dimension.cpp
+
+INCLUDEPATH += \
+    ../../../include
+LIBS += -lpthread
@@ -0,0 +1,15 @@
+TEMPLATE = app
+TARGET = test_lu_factorize
+
+include (configuration.pri)
+
+HEADERS += \
+    ../../../test/utils.hpp \
+    ../../../test/common/random.hpp
+
+SOURCES += \
+    ../../../test/test_lu_factorize.cpp
+
+INCLUDEPATH += \
+    ../../../include
+LIBS += -lpthread
@@ -0,0 +1,14 @@
+TEMPLATE = app
+TARGET = test_map_hash
+
+include (configuration.pri)
+
+HEADERS += \
+    ../../../test/utils.hpp
+
+SOURCES += \
+    ../../../test/test_map_hash.cpp
+
+INCLUDEPATH += \
+    ../../../include
+LIBS += -lpthread
@@ -0,0 +1,14 @@
+TEMPLATE = app
+TARGET = test_matrix_chain
+
+include (configuration.pri)
+
+HEADERS += \
+    ../../../test/utils.hpp
+
+SOURCES += \
+    ../../../test/test_matrix_chain.cpp
+
+INCLUDEPATH += \
+    ../../../include
+LIBS += -lpthread
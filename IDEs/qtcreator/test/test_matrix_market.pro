@@ -0,0 +1,14 @@
+TEMPLATE = app
+TARGET = test_matrix_market
+
+include (configuration.pri)
+
+HEADERS += \
+    ../../../test/utils.hpp
+
+SOURCES += \
+    ../../../test/test_matrix_market.cpp
+
+INCLUDEPATH += \
+    ../../../include
+LIBS += -lpthread
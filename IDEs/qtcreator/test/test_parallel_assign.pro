@@ -0,0 +1,14 @@
+TEMPLATE = app
+TARGET = test_parallel_assign
+
+include (configuration.pri)
+
+HEADERS += \
+    ../../../test/utils.hpp
+
+SOURCES += \
+    ../../../test/test_parallel_assign.cpp
+
+INCLUDEPATH += \
+    ../../../include
+LIBS += -lpthread
@@ -0,0 +1,15 @@
+TEMPLATE = app
+TARGET = test_qr
+
+include (configuration.pri)
+
+HEADERS += \
+    ../../../test/utils.hpp \
+    ../../../test/common/random.hpp
+
+SOURCES += \
+    ../../../test/test_qr.cpp
+
+INCLUDEPATH += \
+    ../../../include
+LIBS += -lpthread
@@ -0,0 +1,15 @@
+TEMPLATE = app
+TARGET = test_sell
+
+include (configuration.pri)
+
+HEADERS += \
+    ../../../test/utils.hpp \
+    ../../../test/common/random.hpp
+
+SOURCES += \
+    ../../../test/test_sell.cpp
+
+INCLUDEPATH += \
+    ../../../include
+LIBS += -lpthread
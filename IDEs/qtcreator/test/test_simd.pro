@@ -0,0 +1,13 @@
+TEMPLATE = app
+TARGET = test_simd
+
+include (configuration.pri)
+
+HEADERS += \
+    ../../../test/utils.hpp
+
+SOURCES += \
+    ../../../test/test_simd.cpp
+
+INCLUDEPATH += \
+    ../../../include
@@ -0,0 +1,15 @@
+TEMPLATE = app
+TARGET = test_spgemm
+
+include (configuration.pri)
+
+HEADERS += \
+    ../../../test/utils.hpp \
+    ../../../test/common/random.hpp
+
+SOURCES += \
+    ../../../test/test_spgemm.cpp
+
+INCLUDEPATH += \
+    ../../../include
+LIBS += -lpthread
@@ -0,0 +1,15 @@
+TEMPLATE = app
+TARGET = test_spmv
+
+include (configuration.pri)
+
+HEADERS += \
+    ../../../test/utils.hpp \
+    ../../../test/common/random.hpp
+
+SOURCES += \
+    ../../../test/test_spmv.cpp
+
+INCLUDEPATH += \
+    ../../../include
+LIBS += -lpthread
@@ -0,0 +1,13 @@
+TEMPLATE = app
+TARGET = test_strassen
+
+include (configuration.pri)
+
+HEADERS += \
+    ../../../test/utils.hpp
+
+SOURCES += \
+    ../../../test/test_strassen.cpp
+
+INCLUDEPATH += \
+    ../../../include
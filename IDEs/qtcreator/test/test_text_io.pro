@@ -0,0 +1,14 @@
+TEMPLATE = app
+TARGET = test_text_io
+
+include (configuration.pri)
+
+HEADERS += \
+    ../../../test/utils.hpp
+
+SOURCES += \
+    ../../../test/test_text_io.cpp
+
+INCLUDEPATH += \
+    ../../../include
+LIBS += -lpthread
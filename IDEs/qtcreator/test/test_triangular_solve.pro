@@ -0,0 +1,15 @@
+TEMPLATE = app
+TARGET = test_triangular_solve
+
+include (configuration.pri)
+
+HEADERS += \
+    ../../../test/utils.hpp \
+    ../../../test/common/random.hpp
+
+SOURCES += \
+    ../../../test/test_triangular_solve.cpp
+
+INCLUDEPATH += \
+    ../../../include
+LIBS += -lpthread
@@ -33,6 +33,27 @@ SUBDIRS += \
     test_inplace_solve_mvov \
     test_lu \
     test_matrix_vector \
+    test_strassen \
+    test_gemm \
+    test_simd \
+    test_parallel_assign \
+    test_matrix_chain \
+    test_lu_factorize \
+    test_triangular_solve \
+    test_cholesky \
+    test_qr \
+    test_spmv \
+    test_sell \
+    test_bsr \
+    test_spgemm \
+    test_assemble \
+    test_coordinate_radix_sort \
+    test_map_hash \
+    test_binary_io \
+    test_text_io \
+    test_matrix_market \
+    test_aligned_allocator \
+    test_leading_dimension \
     test_ticket7296 \
     test_triangular \
     triangular_access \
@@ -68,6 +89,27 @@ test_inplace_solve_sparse.file = test/test_inplace_solve_sparse.pro
 test_inplace_solve_mvov.file = test/test_inplace_solve_mvov.pro
 test_lu.file = test/test_lu.pro
 test_matrix_vector.file = test/test_matrix_vector.pro
+test_strassen.file = test/test_strassen.pro
+test_gemm.file = test/test_gemm.pro
+test_simd.file = test/test_simd.pro
+test_parallel_assign.file = test/test_parallel_assign.pro
+test_matrix_chain.file = test/test_matrix_chain.pro
+test_lu_factorize.file = test/test_lu_factorize.pro
+test_triangular_solve.file = test/test_triangular_solve.pro
+test_cholesky.file = test/test_cholesky.pro
+test_qr.file = test/test_qr.pro
+test_spmv.file = test/test_spmv.pro
+test_sell.file = test/test_sell.pro
+test_bsr.file = test/test_bsr.pro
+test_spgemm.file = test/test_spgemm.pro
+test_assemble.file = test/test_assemble.pro
+test_coordinate_radix_sort.file = test/test_coordinate_radix_sort.pro
+test_map_hash.file = test/test_map_hash.pro
+test_binary_io.file = test/test_binary_io.pro
+test_text_io.file = test/test_text_io.pro
+test_matrix_market.file = test/test_matrix_market.pro
+test_aligned_allocator.file = test/test_aligned_allocator.pro
+test_leading_dimension.file = test/test_leading_dimension.pro
 test_ticket7296.file = test/test_ticket7296.pro
 test_triangular.file = test/test_triangular.pro
 triangular_access.file = test/triangular_access.pro
@@ -0,0 +1,128 @@
+//
+//  Copyright (c) 2017 uBLAS developers
+//
+//  Distributed under the Boost Software License, Version 1.0. (See
+//  accompanying file LICENSE_1_0.txt or copy at
+//  http://www.boost.org/LICENSE_1_0.txt)
+//
+#define BOOST_UBLAS_TYPE_CHECK 0
+#define BOOST_UBLAS_SHALLOW_ARRAY_ADAPTOR
+
+#include <boost/numeric/ublas/binary_io.hpp>
+#include <boost/numeric/ublas/io.hpp>
+#include <boost/archive/binary_iarchive.hpp>
+#include <boost/archive/binary_oarchive.hpp>
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+
+using namespace boost::numeric::ublas;
+
+// Writing and reading back a dense matrix<double> and a compressed_matrix,
+// through the text operators of io.hpp (dense only, as they print every
+// element), Boost.Serialization binary archives, save_binary and load_binary,
+// and mapping the binary file, summing the values so that every page is
+// loaded. The dense matrix is (n, n), n given as first argument, 2000 by
+// default; the compressed matrix has 10 n^2 / 4 rows of 4 elements, at
+// least 4 rows.
+// Files are written to the working directory and removed; the times of reads
+// include the page cache, not the disk.
+
+double seconds_since(std::chrono::steady_clock::time_point start) {
+	return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+static const char *path = "bench10_binary_io.bin";
+
+template<class M>
+void text(const M &m) {
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+	{
+		std::ofstream os(path);
+		os << m;
+	}
+	const double write = seconds_since(start);
+	start = std::chrono::steady_clock::now();
+	M r;
+	std::ifstream is(path);
+	is >> r;
+	std::cout << "text:\t\twrite " << write << " s\tread " << seconds_since(start) << " s\n";
+}
+
+template<class M>
+void serialization(const M &m) {
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+	{
+		std::ofstream os(path, std::ios_base::binary);
+		boost::archive::binary_oarchive oa(os);
+		oa << m;
+	}
+	const double write = seconds_since(start);
+	start = std::chrono::steady_clock::now();
+	M r;
+	std::ifstream is(path, std::ios_base::binary);
+	boost::archive::binary_iarchive ia(is);
+	ia >> r;
+	std::cout << "serialization:\twrite " << write << " s\tread " << seconds_since(start) << " s\n";
+}
+
+template<class M>
+void binary(const M &m) {
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+	{
+		std::ofstream os(path, std::ios_base::binary);
+		save_binary(os, m);
+	}
+	const double write = seconds_since(start);
+	start = std::chrono::steady_clock::now();
+	M r;
+	std::ifstream is(path, std::ios_base::binary);
+	load_binary(is, r);
+	std::cout << "binary:\t\twrite " << write << " s\tread " << seconds_since(start) << " s\n";
+}
+
+double sum(const double *p, std::size_t n) {
+	double s = 0.0;
+	for (std::size_t k = 0; k < n; k++)
+		s += p[k];
+	return s;
+}
+
+int main(int argc, char *argv[]) {
+	const std::size_t n = argc > 1 ? std::size_t(std::atoll(argv[1])) : 2000;
+
+	matrix<double> D(n, n);
+	for (std::size_t k = 0; k < n * n; k++)
+		D.data()[k] = 1.0 / double(k % 97 + 1);
+	std::cout << "Dense:\t\t(" << n << ", " << n << ")\n";
+	text(D);
+	serialization(D);
+	binary(D);
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+	{
+		mapped_binary_file f(path);
+		matrix<double, row_major, shallow_array_adaptor<double> > v(f.dense_view<double, row_major>());
+		const double s = sum(&v.data()[0], n * n);
+		std::cout << "mapped:\t\topen and sum " << seconds_since(start) << " s\t" << (s == sum(&D.data()[0], n * n) ? "equal" : "different") << "\n";
+	}
+
+	const std::size_t rows = (std::max)(10 * n * n / 4, std::size_t(4));
+	compressed_matrix<double> C(rows, rows, 4 * rows);
+	for (std::size_t i = 0; i < rows; i++)
+		for (std::size_t k = 0; k < 4; k++)
+			C.push_back(i, k * (rows / 4) + i % (rows / 4), 1.0 / double(i % 89 + k + 1));
+	std::cout << "Compressed:\t(" << rows << ", " << rows << ")\t" << C.nnz() << " elements\n";
+	serialization(C);
+	binary(C);
+	start = std::chrono::steady_clock::now();
+	{
+		mapped_compressed_matrix<double> v(path);
+		const double s = sum(&v.value_data()[0], v.nnz());
+		std::cout << "mapped:\t\topen and sum " << seconds_since(start) << " s\t" << (s == sum(&C.value_data()[0], C.nnz()) ? "equal" : "different") << "\n";
+	}
+	std::remove(path);
+	return 0;
+}
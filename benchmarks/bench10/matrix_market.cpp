@@ -0,0 +1,87 @@
+//
+//  Copyright (c) 2017 uBLAS developers
+//
+//  Distributed under the Boost Software License, Version 1.0. (See
+//  accompanying file LICENSE_1_0.txt or copy at
+//  http://www.boost.org/LICENSE_1_0.txt)
+//
+#define BOOST_UBLAS_TYPE_CHECK 0
+
+#include <boost/numeric/ublas/matrix_market.hpp>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <sstream>
+#include <string>
+
+using namespace boost::numeric::ublas;
+
+// Reading a coordinate Matrix Market file of a (n, n) matrix with 10 random
+// elements per row, n given as argument, 10^6 by default. read_matrix_market
+// into a compressed_matrix is timed against the loader most code carries:
+// extracting the banner, the sizes and every entry with operator>> and
+// appending them to a coordinate_matrix, which is then converted.
+
+double seconds_since(std::chrono::steady_clock::time_point start) {
+	return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+typedef compressed_matrix<double> matrix_type;
+
+void naive_read(std::istream &is, matrix_type &m) {
+	std::string line;
+	std::getline(is, line);
+	while (is.peek() == '%')
+		std::getline(is, line);
+	std::size_t size1, size2, entries;
+	is >> size1 >> size2 >> entries;
+	coordinate_matrix<double> c(size1, size2, entries);
+	for (std::size_t k = 0; k < entries; k++) {
+		std::size_t i, j;
+		double t;
+		is >> i >> j >> t;
+		c.append_element(i - 1, j - 1, t);
+	}
+	m = c;
+}
+
+int main(int argc, char *argv[]) {
+	const std::size_t n = argc > 1 ? std::size_t(std::atoll(argv[1])) : 1000000;
+	matrix_type m(n, n);
+	unsigned long long seed = 1;
+	for (std::size_t i = 0; i < n; i++)
+		for (std::size_t k = 0; k < 10; k++) {
+			seed = seed * 6364136223846793005ull + 1442695040888963407ull;
+			m(i, std::size_t(seed >> 33) % n) = double(seed >> 11) / double(1ull << 53) * 2.0 - 1.0;
+		}
+
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+	std::ostringstream os;
+	write_matrix_market(os, m);
+	const double write = seconds_since(start);
+	const std::string text = os.str();
+	std::cout << "Threads:\t" << detail::thread_pool::instance().size() << "\n";
+	std::cout << "Matrix:\t\t(" << n << ", " << n << "), " << m.nnz() << " elements, " << double(text.size()) / 1e6
+	          << " MB\n";
+	std::cout << "write:\t\t" << write << " s\n";
+
+	start = std::chrono::steady_clock::now();
+	std::istringstream is(text);
+	matrix_type r;
+	read_matrix_market(is, r);
+	const double read = seconds_since(start);
+
+	start = std::chrono::steady_clock::now();
+	std::istringstream ns(text);
+	matrix_type s;
+	naive_read(ns, s);
+	const double naive = seconds_since(start);
+
+	const bool equal = is && r.nnz() == m.nnz() && s.nnz() == m.nnz() &&
+	                   std::equal(r.value_data().begin(), r.value_data().begin() + r.nnz(), m.value_data().begin()) &&
+	                   std::equal(s.value_data().begin(), s.value_data().begin() + s.nnz(), m.value_data().begin());
+	std::cout << "read:\t\t" << read << " s\n";
+	std::cout << "operator>>:\t" << naive << " s\n";
+	std::cout << "speedup:\t" << naive / read << "\t" << (equal ? "equal" : "different") << "\n";
+	return 0;
+}
@@ -0,0 +1,66 @@
+//
+//  Copyright (c) 2017 uBLAS developers
+//
+//  Distributed under the Boost Software License, Version 1.0. (See
+//  accompanying file LICENSE_1_0.txt or copy at
+//  http://www.boost.org/LICENSE_1_0.txt)
+//
+#define BOOST_UBLAS_TYPE_CHECK 0
+
+#include <boost/numeric/ublas/matrix.hpp>
+#include <boost/numeric/ublas/io.hpp>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <locale>
+#include <sstream>
+#include <string>
+
+using namespace boost::numeric::ublas;
+
+// Writing and reading an (n, n) matrix<double> in the text format of io.hpp
+// with 17 significant digits, n given as argument, 1000 by default. The
+// buffered routines run on streams with the classic locale; the generic
+// element by element operators are timed on streams imbued with a copy of
+// the classic locale, which formats the same way but is not taken over.
+// Throughput counts the characters of the text.
+
+double seconds_since(std::chrono::steady_clock::time_point start) {
+	return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+void run(const char *name, const matrix<double> &m, const std::locale &locale) {
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+	std::ostringstream os;
+	os.imbue(locale);
+	os.precision(17);
+	os << m;
+	const double write = seconds_since(start);
+	const std::string text = os.str();
+
+	start = std::chrono::steady_clock::now();
+	std::istringstream is(text);
+	is.imbue(locale);
+	matrix<double> r;
+	is >> r;
+	const double read = seconds_since(start);
+	const double megabytes = double(text.size()) / 1e6;
+	std::cout << name << "\twrite " << write << " s (" << megabytes / write << " MB/s)\tread " << read << " s ("
+	          << megabytes / read << " MB/s)\t" << (is && r.size1() == m.size1() && norm_inf(r - m) == 0.0 ? "equal" : "different")
+	          << "\n";
+}
+
+int main(int argc, char *argv[]) {
+	const std::size_t n = argc > 1 ? std::size_t(std::atoll(argv[1])) : 1000;
+	matrix<double> m(n, n);
+	unsigned long long seed = 1;
+	for (std::size_t k = 0; k < n * n; k++) {
+		seed = seed * 6364136223846793005ull + 1442695040888963407ull;
+		m.data()[k] = double(seed >> 11) / double(1ull << 53) * 2.0 - 1.0;
+	}
+	std::cout << "Threads:\t" << detail::thread_pool::instance().size() << "\n";
+	std::cout << "Matrix:\t\t(" << n << ", " << n << ")\n";
+	run("buffered:", m, std::locale::classic());
+	run("generic:", m, std::locale(std::locale::classic(), new std::numpunct<char>()));
+	return 0;
+}
@@ -0,0 +1,100 @@
+//
+//  Copyright (c) 2017 uBLAS developers
+//
+//  Distributed under the Boost Software License, Version 1.0. (See
+//  accompanying file LICENSE_1_0.txt or copy at
+//  http://www.boost.org/LICENSE_1_0.txt)
+//
+#define BOOST_UBLAS_TYPE_CHECK 0
+
+#include <boost/numeric/ublas/matrix.hpp>
+#include <boost/numeric/ublas/vector.hpp>
+#include <chrono>
+#include <iostream>
+
+using namespace boost::numeric::ublas;
+
+// inner_prod, prod (matrix, vector) and prod (matrix, matrix) of double
+// containers of the default allocator against aligned_vector and
+// aligned_matrix, whose kernels take aligned loads. The vectors fit in the
+// first level cache, where loads that straddle cache lines cost the most;
+// rows of 1024 elements are whole cache lines, rows of 1020 are not and keep
+// the unaligned loads after the first row. Times are per call, after one
+// call that is not timed.
+
+double seconds_since(std::chrono::steady_clock::time_point start) {
+	return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+template<class V>
+void fill(V &v, unsigned long long &seed) {
+	for (std::size_t k = 0; k < v.data().size(); k++) {
+		seed = seed * 6364136223846793005ull + 1442695040888963407ull;
+		v.data()[k] = double(seed >> 11) / double(1ull << 53) * 2.0 - 1.0;
+	}
+}
+
+template<class V>
+double time_inner_prod(std::size_t n, std::size_t repeats, double &t) {
+	unsigned long long seed = 1;
+	V x(n), y(n);
+	fill(x, seed);
+	fill(y, seed);
+	t += inner_prod(x, y);
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+	for (std::size_t r = 0; r < repeats; r++)
+		t += inner_prod(x, y);
+	return seconds_since(start) / double(repeats);
+}
+
+template<class M, class V>
+double time_matrix_vector(std::size_t size1, std::size_t size2, std::size_t repeats, double &t) {
+	unsigned long long seed = 2;
+	M a(size1, size2);
+	V x(size2), y(size1);
+	fill(a, seed);
+	fill(x, seed);
+	noalias(y) = prod(a, x);
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+	for (std::size_t r = 0; r < repeats; r++) {
+		noalias(y) = prod(a, x);
+		t += y(0);
+	}
+	return seconds_since(start) / double(repeats);
+}
+
+template<class M>
+double time_matrix_matrix(std::size_t n, std::size_t repeats, double &t) {
+	unsigned long long seed = 3;
+	M a(n, n), b(n, n), c(n, n);
+	fill(a, seed);
+	fill(b, seed);
+	noalias(c) = prod(a, b);
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+	for (std::size_t r = 0; r < repeats; r++) {
+		noalias(c) = prod(a, b);
+		t += c(0, 0);
+	}
+	return seconds_since(start) / double(repeats);
+}
+
+void report(const char *name, double plain, double aligned) {
+	std::cout << name << "\t" << plain * 1e6 << " us\t" << aligned * 1e6 << " us\t" << plain / aligned << "\n";
+}
+
+int main() {
+	typedef vector<double> plain_vector;
+	typedef matrix<double> plain_matrix;
+	typedef aligned_vector<double> fast_vector;
+	typedef aligned_matrix<double> fast_matrix;
+	double t = 0;
+	std::cout << "operation\t\t\tdefault\t\taligned\t\tspeedup\n";
+	report("inner_prod 1000\t\t", time_inner_prod<plain_vector>(1000, 2000000, t), time_inner_prod<fast_vector>(1000, 2000000, t));
+	report("inner_prod 4000\t\t", time_inner_prod<plain_vector>(4000, 500000, t), time_inner_prod<fast_vector>(4000, 500000, t));
+	report("prod (256, 1024) x\t", time_matrix_vector<plain_matrix, plain_vector>(256, 1024, 2000, t),
+	       time_matrix_vector<fast_matrix, fast_vector>(256, 1024, 2000, t));
+	report("prod (256, 1020) x\t", time_matrix_vector<plain_matrix, plain_vector>(256, 1020, 2000, t),
+	       time_matrix_vector<fast_matrix, fast_vector>(256, 1020, 2000, t));
+	report("prod (256, 256) (256, 256)", time_matrix_matrix<plain_matrix>(256, 20, t), time_matrix_matrix<fast_matrix>(256, 20, t));
+	return t == 0.5;
+}
@@ -0,0 +1,103 @@
+//
+//  Copyright (c) 2017 uBLAS developers
+//
+//  Distributed under the Boost Software License, Version 1.0. (See
+//  accompanying file LICENSE_1_0.txt or copy at
+//  http://www.boost.org/LICENSE_1_0.txt)
+//
+#define BOOST_UBLAS_TYPE_CHECK 0
+
+#include <boost/numeric/ublas/matrix.hpp>
+#include <boost/numeric/ublas/matrix_proxy.hpp>
+#include <chrono>
+#include <iostream>
+
+using namespace boost::numeric::ublas;
+
+// Row major (n, n) matrices of double with rows of n elements against rows
+// padded by padded_leading_dimension, over sizes around powers of two. The
+// elements of a column of an unpadded matrix of 1024 or 2048 columns lie a
+// multiple of 4096 bytes apart and share a few cache sets; walking columns,
+// transposing and the packing of the blocked product then miss in every
+// cache level. Times are per call, after one call that is not timed.
+
+double seconds_since(std::chrono::steady_clock::time_point start) {
+	return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+typedef matrix<double> matrix_type;
+
+matrix_type make_matrix(std::size_t n, std::size_t ld) {
+	matrix_type m(n, n, ld, 0.0);
+	unsigned long long seed = n;
+	for (std::size_t i = 0; i < n; i++)
+		for (std::size_t j = 0; j < n; j++) {
+			seed = seed * 6364136223846793005ull + 1442695040888963407ull;
+			m(i, j) = double(seed >> 11) / double(1ull << 53) * 2.0 - 1.0;
+		}
+	return m;
+}
+
+// Sums every column through matrix_column
+double time_columns(std::size_t n, std::size_t ld, std::size_t repeats, double &t) {
+	matrix_type a(make_matrix(n, ld));
+	std::chrono::steady_clock::time_point start;
+	for (std::size_t r = 0; r <= repeats; r++) {
+		if (r == 1)
+			start = std::chrono::steady_clock::now();
+		for (std::size_t j = 0; j < n; j++)
+			t += sum(column(a, j));
+	}
+	return seconds_since(start) / double(repeats);
+}
+
+double time_transpose(std::size_t n, std::size_t ld, std::size_t repeats, double &t) {
+	matrix_type a(make_matrix(n, ld)), b(n, n, ld, 0.0);
+	std::chrono::steady_clock::time_point start;
+	for (std::size_t r = 0; r <= repeats; r++) {
+		if (r == 1)
+			start = std::chrono::steady_clock::now();
+		noalias(b) = trans(a);
+		t += b(1, 0);
+	}
+	return seconds_since(start) / double(repeats);
+}
+
+double time_product(std::size_t n, std::size_t ld, std::size_t repeats, double &t) {
+	matrix_type a(make_matrix(n, ld)), b(make_matrix(n, ld)), c(n, n, ld, 0.0);
+	std::chrono::steady_clock::time_point start;
+	for (std::size_t r = 0; r <= repeats; r++) {
+		if (r == 1)
+			start = std::chrono::steady_clock::now();
+		noalias(c) = prod(a, b);
+		t += c(0, 0);
+	}
+	return seconds_since(start) / double(repeats);
+}
+
+void report(const char *name, std::size_t n, std::size_t ld, double plain, double padded) {
+	std::cout << name << "\t" << n << "\t" << ld << "\t" << plain * 1e3 << " ms\t" << padded * 1e3 << " ms\t"
+	          << plain / padded << "\n";
+}
+
+int main() {
+	const std::size_t sizes[] = {1000, 1023, 1024, 1025, 2000, 2047, 2048, 2049};
+	const std::size_t product_sizes[] = {500, 511, 512, 513, 1000, 1024};
+	double t = 0;
+	std::cout << "operation\tn\tld\tunpadded\tpadded\t\tspeedup\n";
+	for (std::size_t k = 0; k < sizeof(sizes) / sizeof(sizes[0]); k++) {
+		const std::size_t n = sizes[k], ld = padded_leading_dimension<double>(n);
+		const std::size_t repeats = n > 1500 ? 3 : 10;
+		report("columns\t", n, ld, time_columns(n, n, repeats, t), time_columns(n, ld, repeats, t));
+	}
+	for (std::size_t k = 0; k < sizeof(sizes) / sizeof(sizes[0]); k++) {
+		const std::size_t n = sizes[k], ld = padded_leading_dimension<double>(n);
+		const std::size_t repeats = n > 1500 ? 3 : 10;
+		report("transpose", n, ld, time_transpose(n, n, repeats, t), time_transpose(n, ld, repeats, t));
+	}
+	for (std::size_t k = 0; k < sizeof(product_sizes) / sizeof(product_sizes[0]); k++) {
+		const std::size_t n = product_sizes[k], ld = padded_leading_dimension<double>(n);
+		report("prod\t", n, ld, time_product(n, n, 2, t), time_product(n, ld, 2, t));
+	}
+	return t == 0.5;
+}
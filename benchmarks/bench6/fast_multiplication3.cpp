@@ -0,0 +1,64 @@
+//
+//  Copyright (c) 2017 uBLAS developers
+//
+//  Distributed under the Boost Software License, Version 1.0. (See
+//  accompanying file LICENSE_1_0.txt or copy at
+//  http://www.boost.org/LICENSE_1_0.txt)
+//
+#include <boost/numeric/ublas/matrix.hpp>
+#include <boost/numeric/ublas/storage.hpp>
+#include <boost/timer.hpp>
+
+using namespace boost::numeric::ublas;
+
+// Compares prod (the packed kernel for dense matrices, with Strassen steps
+// above the cutoff) against Strassen's algorithm and the packed kernel on
+// copies of the operands, and reports the scratch memory prod had to allocate.
+int main() {
+	typedef detail::workspace_arena<double> arena_type;
+	boost::timer timer;
+	double elapsed_time;
+
+	int N=1024;
+	matrix<double> A, B, C;
+	while(N <= 4096) {
+		A.resize(N,N); B.resize(N,N); C.resize(N,N);
+		for(int i=0; i<N; i++) {
+			for(int j=0; j<N; j++) {
+				A(i,j) = (i + j) % 7;	B(i, j) = (i * j) % 5;
+			} 
+		}
+		double flops = 2.0 * N * N * N;
+
+		arena_type::instance().reset_statistics();
+		timer.restart();
+		C = prod(A, B);
+		elapsed_time = timer.elapsed();
+		std::size_t first_bytes = arena_type::instance().bytes_allocated();
+
+		arena_type::instance().reset_statistics();
+		timer.restart();
+		C = prod(A, B);
+		double reuse_time = timer.elapsed();
+		std::size_t reuse_bytes = arena_type::instance().bytes_allocated();
+
+		timer.restart();
+		detail::strassen_prod<double> (N, N, N, A, B, C, true);
+		double strassen_time = timer.elapsed();
+
+		timer.restart();
+		detail::strassen_prod<double> (N, N, N, A, B, C, false);
+		double plain_time = timer.elapsed();
+
+		std::cout << "Matrix dimensions:\t(" << N << ", " << N << ")\t(" << N << ", " << N << ")\n"; 
+		std::cout << "prod:\t" << elapsed_time << " s\t" << flops / elapsed_time * 1e-9 << " GFLOP/s\t"
+		          << first_bytes << " bytes allocated\n";
+		std::cout << "prod (reused):\t" << reuse_time << " s\t" << flops / reuse_time * 1e-9 << " GFLOP/s\t"
+		          << reuse_bytes << " bytes allocated\n";
+		std::cout << "strassen:\t" << strassen_time << " s\t" << flops / strassen_time * 1e-9 << " GFLOP/s\n";
+		std::cout << "plain prod:\t" << plain_time << " s\t" << flops / plain_time * 1e-9 << " GFLOP/s\n";
+		N *= 2;
+	}
+
+	return 0;
+}
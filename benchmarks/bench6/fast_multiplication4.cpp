@@ -0,0 +1,77 @@
+//
+//  Copyright (c) 2017 uBLAS developers
+//
+//  Distributed under the Boost Software License, Version 1.0. (See
+//  accompanying file LICENSE_1_0.txt or copy at
+//  http://www.boost.org/LICENSE_1_0.txt)
+//
+#include <boost/numeric/ublas/matrix.hpp>
+#include <boost/numeric/ublas/matrix_proxy.hpp>
+#include <boost/numeric/ublas/storage.hpp>
+#include <boost/timer.hpp>
+
+using namespace boost::numeric::ublas;
+
+// Sweeps square and rectangular products whose dimensions are not powers of
+// two. For each shape the packed kernel is compared with Strassen-Winograd at
+// the measured cutoff, and with Strassen on operands padded to the next power
+// of two, which is what the product used to do.
+
+std::size_t next_power (std::size_t n) {
+	std::size_t p = 1;
+	while (p < n)
+		p <<= 1;
+	return p;
+}
+
+template<class M>
+void fill (M &m) {
+	for (std::size_t i = 0; i < m.size1 (); i++)
+		for (std::size_t j = 0; j < m.size2 (); j++)
+			m (i, j) = double ((i * 7 + j * 3) % 11) - 5.0;
+}
+
+int main() {
+	typedef detail::dense_matrix_traits<matrix<double> > traits;
+	boost::timer timer;
+
+	timer.restart();
+	std::size_t cutoff = detail::strassen_calibrate<double> ();
+	std::cout << "Strassen cutoff:\t" << cutoff << "\t(measured in " << timer.elapsed() << " s)\n";
+
+	const std::size_t shapes [][3] = {
+		{ 1000, 1000, 1000 }, { 1500, 1500, 1500 }, { 2049, 2049, 2049 }, { 3000, 3000, 3000 },
+		{ 2049, 1023, 1537 }, { 3000, 700, 3000 }, { 1200, 2500, 900 }
+	};
+	for (std::size_t s = 0; s < sizeof (shapes) / sizeof (shapes [0]); s++) {
+		const std::size_t M = shapes [s] [0], K = shapes [s] [1], N = shapes [s] [2];
+		matrix<double> A (M, K), B (K, N), C (M, N);
+		fill (A); fill (B);
+		double flops = 2.0 * M * K * N;
+
+		timer.restart();
+		detail::gemm (M, N, K, 1.0, traits::data (A), K, 1, traits::data (B), N, 1, 0.0, traits::data (C), N, 1);
+		double gemm_time = timer.elapsed();
+
+		timer.restart();
+		detail::strassen_gemm (M, N, K, 1.0, traits::data (A), K, 1, traits::data (B), N, 1, 0.0, traits::data (C), N, 1);
+		double strassen_time = timer.elapsed();
+
+		// Padded to a power of two in every dimension, as a single square product
+		const std::size_t P = next_power ((std::max) (M, (std::max) (K, N)));
+		matrix<double> AP (P, P), BP (P, P), CP (P, P);
+		AP.clear (); BP.clear ();
+		project (AP, range (0, M), range (0, K)) = A;
+		project (BP, range (0, K), range (0, N)) = B;
+		timer.restart();
+		detail::strassen_gemm (P, P, P, 1.0, traits::data (AP), P, 1, traits::data (BP), P, 1, 0.0, traits::data (CP), P, 1);
+		double padded_time = timer.elapsed();
+
+		std::cout << "Dimensions:\t(" << M << ", " << K << ")\t(" << K << ", " << N << ")\n";
+		std::cout << "gemm:\t" << gemm_time << " s\t" << flops / gemm_time * 1e-9 << " GFLOP/s\n";
+		std::cout << "strassen:\t" << strassen_time << " s\t" << flops / strassen_time * 1e-9 << " effective GFLOP/s\n";
+		std::cout << "padded strassen (" << P << "):\t" << padded_time << " s\t" << flops / padded_time * 1e-9 << " effective GFLOP/s\n";
+	}
+
+	return 0;
+}
@@ -2,14 +2,53 @@
 #include <boost/numeric/ublas/io.hpp>
 #include <boost/numeric/ublas/storage.hpp>
 #include <boost/timer.hpp>
+#include <algorithm>
+#include <vector>
 
 using namespace boost::numeric::ublas;
 
+// A * B * C * D with the optimal parenthesisation, one product at a time
+void serial_chain(const matrix<double> &A, const matrix<double> &B,
+                  const matrix<double> &C, const matrix<double> &D, matrix<double> &E) {
+	detail::chain_operands<double> operands;
+	operands.push_back(A); operands.push_back(B);
+	operands.push_back(C); operands.push_back(D);
+	detail::chain_plan plan(operands.dimensions());
+	E.resize(A.size1(), D.size2(), false);
+	detail::chain_evaluator<double>(plan, operands.operands(), false).evaluate(&E.data()[0], E.size2(), 1);
+}
+
+// The same, but through the row by row copies assignments used to make
+void buffered_chain(const matrix<double> &A, const matrix<double> &B,
+                    const matrix<double> &C, const matrix<double> &D, matrix<double> &E) {
+	detail::chain_operands<double> operands;
+	operands.push_back(A); operands.push_back(B);
+	operands.push_back(C); operands.push_back(D);
+	detail::chain_plan plan(operands.dimensions());
+	std::size_t size1 = A.size1(), size2 = D.size2();
+	std::vector<double> result(size1 * size2);
+	detail::chain_evaluator<double>(plan, operands.operands(), true).evaluate(&result[0], size2, 1);
+	double **rows = new double*[size1];
+	for(std::size_t i=0;i<size1;i++) {
+		rows[i] = new double[size2];
+		std::copy(&result[i * size2], &result[i * size2] + size2, rows[i]);
+	}
+	matrix<double> temporary(size1, size2);
+	for(std::size_t i=0;i<size1;i++) {
+		for(std::size_t j=0;j<size2;j++){
+			temporary(i,j) = rows[i][j];
+		}
+		delete [] rows[i];
+	}
+	delete [] rows;
+	E = temporary;
+}
+
 int main() {
 	boost::timer timer;
-	double elapsed_time;
+	double parallel_time, serial_time, naive_time, buffered_time;
 
-	matrix<int> A, B, C, D, E;
+	matrix<double> A, B, C, D, E, F, G;
 	int AR = 500, BR = 400, CR = 300, DR = 200, DC = 100;
 	while(AR <= 2000) {
 		A.resize(AR,BR); B.resize(BR,CR); C.resize(CR,DR); D.resize(DR,DC);
@@ -35,16 +74,31 @@ int main() {
 			}
 		}
 
+		// A destination of the right size receives the product directly
+		E.resize(AR, DC, false);
 		timer.restart();
 		E = A * B * C * D;
-		elapsed_time = timer.elapsed();
+		parallel_time = timer.elapsed();
+		timer.restart();
+		serial_chain(A, B, C, D, F);
+		serial_time = timer.elapsed();
+		timer.restart();
+		buffered_chain(A, B, C, D, F);
+		buffered_time = timer.elapsed();
+		timer.restart();
+		G = prod(matrix<double>(prod(matrix<double>(prod(A, B)), C)), D);
+		naive_time = timer.elapsed();
+
 		std::cout << "(" << AR << ", " << BR << ") * (";
 		std::cout << "(" << BR << ", " << CR << ") * (";
 		std::cout << "(" << CR << ", " << DR << ") * (";
 		std::cout << "(" << DR << ", " << DC << ")\n";
-		std::cout << "Time taken:\t" << elapsed_time << "\n";
+		std::cout << "Time taken:\t" << parallel_time << "\n";
+		std::cout << "Serial plan:\t" << serial_time << "\t(speedup " << serial_time / parallel_time << ")\n";
+		std::cout << "With copies:\t" << buffered_time << "\t(speedup " << buffered_time / parallel_time << ")\n";
+		std::cout << "Left to right:\t" << naive_time << "\t(speedup " << naive_time / parallel_time << ")\n";
 		AR += 100; BR += 100; CR += 100; DR += 100; DC += 100;
 	}
 
 	return 0;
-}
\ No newline at end of file
+}
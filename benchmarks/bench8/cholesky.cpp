@@ -0,0 +1,73 @@
+//
+//  Copyright (c) 2017 uBLAS developers
+//
+//  Distributed under the Boost Software License, Version 1.0. (See
+//  accompanying file LICENSE_1_0.txt or copy at
+//  http://www.boost.org/LICENSE_1_0.txt)
+//
+#define BOOST_UBLAS_TYPE_CHECK 0
+
+#include <boost/numeric/ublas/matrix.hpp>
+#include <boost/numeric/ublas/symmetric.hpp>
+#include <boost/numeric/ublas/cholesky.hpp>
+#include <boost/numeric/ublas/lu.hpp>
+#include <chrono>
+#include <iostream>
+
+using namespace boost::numeric::ublas;
+
+// cholesky_factorize on dense and packed symmetric storage against
+// lu_factorize of the same symmetric positive definite matrix. Times are wall
+// clock, the trailing updates run on all threads of the pool.
+
+double seconds_since(std::chrono::steady_clock::time_point start) {
+	return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+// B B^T + n I
+matrix<double> make_spd(std::size_t n) {
+	matrix<double> b(n, n);
+	unsigned seed = 1;
+	for (std::size_t i = 0; i < n; i++)
+		for (std::size_t j = 0; j < n; j++) {
+			seed = seed * 1103515245u + 12345u;
+			b(i, j) = double((seed >> 8) % 2001) / 1000.0 - 1.0;
+		}
+	matrix<double> a(prod(b, trans(b)));
+	for (std::size_t i = 0; i < n; i++)
+		a(i, i) += double(n);
+	return a;
+}
+
+void report(const char *name, double elapsed, double flops) {
+	std::cout << name << ":\t" << elapsed << " s\t" << flops / elapsed * 1e-9 << " GFLOP/s\n";
+}
+
+int main() {
+	std::cout << "Threads:\t" << detail::thread_pool::instance().size() << "\n";
+	for (std::size_t N = 500; N <= 4000; N *= 2) {
+		const matrix<double> A(make_spd(N));
+		const double n = double(N);
+		std::cout << "Matrix dimensions:\t(" << N << ", " << N << ")\n";
+		{
+			matrix<double> L(A);
+			std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+			cholesky_factorize(L);
+			report("cholesky_factorize dense", seconds_since(start), n * n * n / 3.0);
+		}
+		{
+			symmetric_matrix<double, lower> L(A);
+			std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+			cholesky_factorize(L);
+			report("cholesky_factorize packed", seconds_since(start), n * n * n / 3.0);
+		}
+		{
+			matrix<double> LU(A);
+			permutation_matrix<> pm(N);
+			std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+			lu_factorize(LU, pm);
+			report("lu_factorize", seconds_since(start), 2.0 * n * n * n / 3.0);
+		}
+	}
+	return 0;
+}
@@ -0,0 +1,72 @@
+//
+//  Copyright (c) 2017 uBLAS developers
+//
+//  Distributed under the Boost Software License, Version 1.0. (See
+//  accompanying file LICENSE_1_0.txt or copy at
+//  http://www.boost.org/LICENSE_1_0.txt)
+//
+#define BOOST_UBLAS_TYPE_CHECK 0
+
+#include <boost/numeric/ublas/matrix.hpp>
+#include <boost/numeric/ublas/vector.hpp>
+#include <boost/numeric/ublas/qr.hpp>
+#include <boost/numeric/ublas/cholesky.hpp>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+
+using namespace boost::numeric::ublas;
+
+// Tall and skinny least squares: least_squares_solve against the normal
+// equations A^T A x = A^T b formed with prod (trans (A), A) and solved by
+// cholesky_factorize. The columns of A share a common part and differ over six
+// orders of magnitude; the normal equations square its condition number, which
+// shows in the reported error || x - x_exact || for a consistent right hand
+// side.
+// Times are wall clock. The number of columns is given as argument, 200 by
+// default.
+
+double seconds_since(std::chrono::steady_clock::time_point start) {
+	return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+double random_value(unsigned &seed) {
+	seed = seed * 1103515245u + 12345u;
+	return double((seed >> 8) % 2001) / 1000.0 - 1.0;
+}
+
+void report(const char *name, double elapsed, double error) {
+	std::cout << name << ":\t" << elapsed << " s\terror " << error << "\n";
+}
+
+int main(int argc, char *argv[]) {
+	const std::size_t N = argc > 1 ? std::size_t(std::atoi(argv[1])) : 200;
+	std::cout << "Threads:\t" << detail::thread_pool::instance().size() << "\n";
+	for (std::size_t M = 25000; M <= 200000; M *= 2) {
+		matrix<double> A(M, N);
+		vector<double> x(N);
+		unsigned seed = 1;
+		for (std::size_t i = 0; i < M; i++)
+			for (std::size_t j = 0; j < N; j++)
+				A(i, j) = random_value(seed) * std::pow(10.0, -6.0 * double(j) / double(N)) + (j == 0 ? 0.0 : A(i, 0));
+		for (std::size_t j = 0; j < N; j++)
+			x(j) = random_value(seed);
+		const vector<double> b(prod(A, x));
+		std::cout << "Matrix dimensions:\t(" << M << ", " << N << ")\n";
+		{
+			std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+			const vector<double> solution(least_squares_solve(A, b));
+			report("least_squares_solve", seconds_since(start), norm_2(solution - x));
+		}
+		{
+			std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+			matrix<double> normal(prod(trans(A), A));
+			vector<double> solution(prod(trans(A), b));
+			cholesky_factorize(normal);
+			cholesky_substitute(normal, solution);
+			report("normal equations", seconds_since(start), norm_2(solution - x));
+		}
+	}
+	return 0;
+}
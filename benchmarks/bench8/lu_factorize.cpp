@@ -0,0 +1,77 @@
+//
+//  Copyright (c) 2017 uBLAS developers
+//
+//  Distributed under the Boost Software License, Version 1.0. (See
+//  accompanying file LICENSE_1_0.txt or copy at
+//  http://www.boost.org/LICENSE_1_0.txt)
+//
+#define BOOST_UBLAS_TYPE_CHECK 0
+
+#include <boost/numeric/ublas/matrix.hpp>
+#include <boost/numeric/ublas/lu.hpp>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+
+using namespace boost::numeric::ublas;
+
+// Blocked lu_factorize against the unblocked rank one update algorithm, run
+// on the same data held in a std::vector, which keeps it off the blocked
+// path. Times are wall clock, the blocked trailing updates run on all threads
+// of the pool. The unblocked algorithm is only timed up to the order given as
+// argument, 1000 by default.
+
+typedef matrix<double, row_major, std::vector<double> > unblocked_matrix;
+
+double seconds_since(std::chrono::steady_clock::time_point start) {
+	return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+template<class M>
+void fill(M &m) {
+	unsigned seed = 1;
+	for (std::size_t i = 0; i < m.size1(); i++)
+		for (std::size_t j = 0; j < m.size2(); j++) {
+			seed = seed * 1103515245u + 12345u;
+			m(i, j) = double((seed >> 8) % 2001) / 1000.0 - 1.0;
+		}
+}
+
+// || A x - b ||_inf / (|| A ||_inf || x ||_inf) for b = A (1, ..., 1)
+template<class M>
+double residual(const M &a, const M &lu, const permutation_matrix<> &pm) {
+	vector<double> x(a.size1()), b(a.size1());
+	for (std::size_t i = 0; i < x.size(); i++)
+		x(i) = 1.0;
+	b = prod(a, x);
+	x = b;
+	lu_substitute(lu, pm, x);
+	return norm_inf(prod(a, x) - b) / (norm_inf(a) * norm_inf(x));
+}
+
+template<class M>
+void run(const char *name, const M &a) {
+	M lu(a);
+	permutation_matrix<> pm(a.size1());
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+	lu_factorize(lu, pm);
+	double elapsed = seconds_since(start);
+	double n = double(a.size1());
+	std::cout << name << ":\t" << elapsed << " s\t" << 2.0 / 3.0 * n * n * n / elapsed * 1e-9 << " GFLOP/s\t"
+	          << "residual " << residual(a, lu, pm) << "\n";
+}
+
+int main(int argc, char *argv[]) {
+	std::size_t unblocked_limit = argc > 1 ? std::atoi(argv[1]) : 1000;
+	std::cout << "Threads:\t" << detail::thread_pool::instance().size() << "\n";
+	for (std::size_t N = 500; N <= 4000; N *= 2) {
+		matrix<double> A(N, N);
+		fill(A);
+		std::cout << "Matrix dimensions:\t(" << N << ", " << N << ")\n";
+		run("blocked lu_factorize", A);
+		if (N <= unblocked_limit)
+			run("unblocked lu_factorize", unblocked_matrix(A));
+	}
+	return 0;
+}
@@ -0,0 +1,70 @@
+//
+//  Copyright (c) 2017 uBLAS developers
+//
+//  Distributed under the Boost Software License, Version 1.0. (See
+//  accompanying file LICENSE_1_0.txt or copy at
+//  http://www.boost.org/LICENSE_1_0.txt)
+//
+#define BOOST_UBLAS_TYPE_CHECK 0
+
+#include <boost/numeric/ublas/matrix.hpp>
+#include <boost/numeric/ublas/lu.hpp>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+
+using namespace boost::numeric::ublas;
+
+// lu_substitute with a block of right hand sides: the blocked triangular
+// solves against the unblocked column by column substitution, run on the same
+// right hand sides held in a std::vector, which keeps them off the blocked
+// path. Times are wall clock, the blocked solves split the right hand sides
+// across the threads of the pool. The unblocked solves are only timed up to
+// the order given as argument, 2000 by default.
+
+typedef matrix<double, row_major, std::vector<double> > unblocked_matrix;
+
+double seconds_since(std::chrono::steady_clock::time_point start) {
+	return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+template<class M>
+void fill(M &m, unsigned seed) {
+	for (std::size_t i = 0; i < m.size1(); i++)
+		for (std::size_t j = 0; j < m.size2(); j++) {
+			seed = seed * 1103515245u + 12345u;
+			m(i, j) = double((seed >> 8) % 2001) / 1000.0 - 1.0;
+		}
+}
+
+template<class M>
+void run(const char *name, const matrix<double> &a, const matrix<double> &lu, const permutation_matrix<> &pm, const M &b) {
+	M x(b);
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+	lu_substitute(lu, pm, x);
+	double elapsed = seconds_since(start);
+	double n = double(b.size1()), k = double(b.size2());
+	matrix<double> r(prod(a, matrix<double>(x)) - b);
+	std::cout << name << ":\t" << elapsed << " s\t" << 2.0 * n * n * k / elapsed * 1e-9 << " GFLOP/s\t"
+	          << "residual " << norm_inf(r) / (norm_inf(a) * norm_inf(x)) << "\n";
+}
+
+int main(int argc, char *argv[]) {
+	std::size_t unblocked_limit = argc > 1 ? std::atoi(argv[1]) : 2000;
+	const std::size_t K = 512;
+	std::cout << "Threads:\t" << detail::thread_pool::instance().size() << "\n";
+	for (std::size_t N = 500; N <= 4000; N *= 2) {
+		matrix<double> A(N, N), B(N, K);
+		fill(A, 1);
+		fill(B, 2);
+		matrix<double> LU(A);
+		permutation_matrix<> pm(N);
+		lu_factorize(LU, pm);
+		std::cout << "Matrix dimensions:\t(" << N << ", " << N << ") right hand sides:\t" << K << "\n";
+		run("blocked lu_substitute", A, LU, pm, B);
+		if (N <= unblocked_limit)
+			run("unblocked lu_substitute", A, LU, pm, unblocked_matrix(B));
+	}
+	return 0;
+}
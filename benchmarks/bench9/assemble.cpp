@@ -0,0 +1,79 @@
+//
+//  Copyright (c) 2017 uBLAS developers
+//
+//  Distributed under the Boost Software License, Version 1.0. (See
+//  accompanying file LICENSE_1_0.txt or copy at
+//  http://www.boost.org/LICENSE_1_0.txt)
+//
+#define BOOST_UBLAS_TYPE_CHECK 0
+
+#include <boost/numeric/ublas/matrix_sparse.hpp>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+
+using namespace boost::numeric::ublas;
+
+// Building a compressed_matrix from unordered triplets, one in ten of them a
+// duplicate: compressed_matrix::assemble against a coordinate_matrix filled
+// with append_element and converted, and against inserting with operator ()
+// on a hundredth of the triplets only, as it grows quadratically. Times are wall
+// clock, assemble uses all threads of the pool. The number of triplets is
+// given as argument, 10^7 by default, on a matrix with a tenth as many rows.
+
+double seconds_since(std::chrono::steady_clock::time_point start) {
+	return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+int main(int argc, char *argv[]) {
+	const std::size_t n = argc > 1 ? std::size_t(std::atoll(argv[1])) : 10000000;
+	const std::size_t size = (std::max)(n / 10, std::size_t(1));
+	std::cout << "Threads:\t" << detail::thread_pool::instance().size() << "\n";
+	std::cout << "Triplets:\t" << n << " on (" << size << ", " << size << ")\n";
+
+	std::vector<std::size_t> rows(n), columns(n);
+	std::vector<double> values(n);
+	unsigned long long seed = 1;
+	for (std::size_t k = 0; k < n; k++) {
+		if (k % 10 == 9) {
+			rows[k] = rows[k - 9];
+			columns[k] = columns[k - 9];
+		} else {
+			seed = seed * 6364136223846793005ull + 1442695040888963407ull;
+			rows[k] = std::size_t(seed >> 20) % size;
+			columns[k] = std::size_t(seed >> 40) % size;
+		}
+		values[k] = 1.0 / double(k % 13 + 1);
+	}
+
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+	compressed_matrix<double> A(size, size);
+	A.assemble(rows.begin(), rows.end(), columns.begin(), values.begin());
+	std::cout << "assemble:\t" << seconds_since(start) << " s\t" << A.nnz() << " elements\n";
+
+	start = std::chrono::steady_clock::now();
+	coordinate_matrix<double> C(size, size, n);
+	for (std::size_t k = 0; k < n; k++)
+		C.append_element(rows[k], columns[k], values[k]);
+	const compressed_matrix<double> B(C);
+	std::cout << "coordinate_matrix:\t" << seconds_since(start) << " s\t" << B.nnz() << " elements\n";
+
+	// Duplicates may be summed in another order
+	double difference = A.nnz() == B.nnz() ? 0.0 : 1.0;
+	for (std::size_t p = 0; p < (std::min)(A.nnz(), B.nnz()); p++)
+		if (A.index2_data()[p] != B.index2_data()[p])
+			difference = 1.0;
+		else
+			difference = (std::max)(difference, std::abs(A.value_data()[p] - B.value_data()[p]));
+	std::cout << "difference:\t" << difference << "\n";
+
+	start = std::chrono::steady_clock::now();
+	compressed_matrix<double> D(size, size);
+	for (std::size_t k = 0; k < n / 100; k++)
+		D(rows[k], columns[k]) += values[k];
+	std::cout << "operator () on " << n / 100 << ":\t" << seconds_since(start) << " s\n";
+	return 0;
+}
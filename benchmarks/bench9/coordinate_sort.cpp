@@ -0,0 +1,89 @@
+//
+//  Copyright (c) 2017 uBLAS developers
+//
+//  Distributed under the Boost Software License, Version 1.0. (See
+//  accompanying file LICENSE_1_0.txt or copy at
+//  http://www.boost.org/LICENSE_1_0.txt)
+//
+#define BOOST_UBLAS_TYPE_CHECK 0
+
+#include <boost/numeric/ublas/matrix_sparse.hpp>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+
+using namespace boost::numeric::ublas;
+
+// coordinate_matrix::sort on unordered elements, one in ten of them a
+// duplicate, once sorted in a single pass and once with a sort every tenth of
+// the elements, which merges them into the sorted ones. The radix sort runs on
+// a square matrix; the comparison sort it replaces is reached with the same
+// elements on a matrix whose second dimension is too wide to pack the indices
+// into one key. Times are wall clock, the radix sort uses all threads of the
+// pool. The number of elements is given as argument, 10^7 by default, on a
+// matrix with a tenth as many rows.
+
+double seconds_since(std::chrono::steady_clock::time_point start) {
+	return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+struct elements {
+	std::vector<std::size_t> rows, columns;
+	std::vector<double> values;
+};
+
+double fill_and_sort(coordinate_matrix<double> &m, const elements &e, std::size_t batch) {
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+	for (std::size_t k = 0; k < e.rows.size(); k++) {
+		m.append_element(e.rows[k], e.columns[k], e.values[k]);
+		if (k % batch == batch - 1)
+			m.sort();
+	}
+	m.sort();
+	return seconds_since(start);
+}
+
+int main(int argc, char *argv[]) {
+	const std::size_t n = argc > 1 ? std::size_t(std::atoll(argv[1])) : 10000000;
+	const std::size_t size = (std::max)(n / 10, std::size_t(1));
+	const std::size_t wide = std::size_t(-1) / size + 1;
+	std::cout << "Threads:\t" << detail::thread_pool::instance().size() << "\n";
+	std::cout << "Elements:\t" << n << " on (" << size << ", " << size << ")\n";
+
+	elements e;
+	e.rows.resize(n);
+	e.columns.resize(n);
+	e.values.resize(n);
+	unsigned long long seed = 1;
+	for (std::size_t k = 0; k < n; k++) {
+		if (k % 10 == 9) {
+			e.rows[k] = e.rows[k - 9];
+			e.columns[k] = e.columns[k - 9];
+		} else {
+			seed = seed * 6364136223846793005ull + 1442695040888963407ull;
+			e.rows[k] = std::size_t(seed >> 20) % size;
+			e.columns[k] = std::size_t(seed >> 40) % size;
+		}
+		e.values[k] = 1.0 / double(k % 13 + 1);
+	}
+
+	for (int batches = 1; batches <= 10; batches += 9) {
+		const std::size_t batch = (std::max)(n / batches, std::size_t(1));
+		coordinate_matrix<double> A(size, size, n), B(size, wide, n);
+		const double radix = fill_and_sort(A, e, batch);
+		const double comparison = fill_and_sort(B, e, batch);
+
+		double difference = A.nnz() == B.nnz() ? 0.0 : 1.0;
+		for (std::size_t p = 0; p < (std::min)(A.nnz(), B.nnz()); p++)
+			if (A.index1_data()[p] != B.index1_data()[p] || A.index2_data()[p] != B.index2_data()[p])
+				difference = 1.0;
+			else
+				difference = (std::max)(difference, std::abs(A.value_data()[p] - B.value_data()[p]));
+		std::cout << batches << " sort" << (batches > 1 ? "s" : "") << ":\tradix " << radix << " s\tcomparison "
+		          << comparison << " s\t" << A.nnz() << " elements\tdifference " << difference << "\n";
+	}
+	return 0;
+}
@@ -0,0 +1,84 @@
+//
+//  Copyright (c) 2017 uBLAS developers
+//
+//  Distributed under the Boost Software License, Version 1.0. (See
+//  accompanying file LICENSE_1_0.txt or copy at
+//  http://www.boost.org/LICENSE_1_0.txt)
+//
+#define BOOST_UBLAS_TYPE_CHECK 0
+
+#include <boost/numeric/ublas/matrix_sparse.hpp>
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+
+using namespace boost::numeric::ublas;
+
+// Accumulating elements in random order, one in ten of them a duplicate, with
+// m (i, j) += t into a mapped_matrix over each storage, then converting the
+// result to a compressed_matrix, with freeze and with the generic assignment.
+// map_array only accumulates a hundredth of the elements, as its insertions
+// cost linear time each. The number of elements is given as argument, 2 10^6
+// by default, on a matrix with a tenth as many rows.
+
+double seconds_since(std::chrono::steady_clock::time_point start) {
+	return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+template<class A>
+double accumulate(mapped_matrix<double, row_major, A> &m, const std::vector<std::size_t> &rows,
+                  const std::vector<std::size_t> &columns, std::size_t n) {
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+	for (std::size_t k = 0; k < n; k++)
+		m(rows[k], columns[k]) += 1.0 / double(k % 13 + 1);
+	return seconds_since(start);
+}
+
+// Both conversions start from the elements as accumulated, the first ordered
+// access of map_hash sorting them
+template<class A>
+void convert(const char *name, const mapped_matrix<double, row_major, A> &m) {
+	const mapped_matrix<double, row_major, A> n(m);
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+	compressed_matrix<double> F;
+	m.freeze(F);
+	const double freeze = seconds_since(start);
+	start = std::chrono::steady_clock::now();
+	const compressed_matrix<double> C(n);
+	const double assign = seconds_since(start);
+	std::cout << name << " to compressed_matrix:\tfreeze " << freeze << " s\tassignment " << assign << " s\t"
+	          << (std::equal(F.value_data().begin(), F.value_data().begin() + F.nnz(), C.value_data().begin()) &&
+	              F.nnz() == C.nnz() ? "equal" : "different") << "\n";
+}
+
+int main(int argc, char *argv[]) {
+	const std::size_t n = argc > 1 ? std::size_t(std::atoll(argv[1])) : 2000000;
+	const std::size_t size = (std::max)(n / 10, std::size_t(1));
+	std::cout << "Elements:\t" << n << " on (" << size << ", " << size << ")\n";
+
+	std::vector<std::size_t> rows(n), columns(n);
+	unsigned long long seed = 1;
+	for (std::size_t k = 0; k < n; k++) {
+		if (k % 10 == 9) {
+			rows[k] = rows[k - 9];
+			columns[k] = columns[k - 9];
+		} else {
+			seed = seed * 6364136223846793005ull + 1442695040888963407ull;
+			rows[k] = std::size_t(seed >> 20) % size;
+			columns[k] = std::size_t(seed >> 40) % size;
+		}
+	}
+
+	mapped_matrix<double, row_major, map_hash<std::size_t, double> > H(size, size);
+	std::cout << "map_hash:\t" << accumulate(H, rows, columns, n) << " s\t" << H.nnz() << " elements\n";
+	mapped_matrix<double> S(size, size);
+	std::cout << "map_std:\t" << accumulate(S, rows, columns, n) << " s\t" << S.nnz() << " elements\n";
+	mapped_matrix<double, row_major, map_array<std::size_t, double> > A(size, size);
+	std::cout << "map_array on " << n / 100 << ":\t" << accumulate(A, rows, columns, n / 100) << " s\n";
+
+	convert("map_hash", H);
+	convert("map_std", S);
+	return 0;
+}
@@ -0,0 +1,95 @@
+//
+//  Copyright (c) 2017 uBLAS developers
+//
+//  Distributed under the Boost Software License, Version 1.0. (See
+//  accompanying file LICENSE_1_0.txt or copy at
+//  http://www.boost.org/LICENSE_1_0.txt)
+//
+#define BOOST_UBLAS_TYPE_CHECK 0
+
+#include <boost/numeric/ublas/matrix_sparse.hpp>
+#include <boost/numeric/ublas/vector.hpp>
+#include <boost/numeric/ublas/operation.hpp>
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+
+using namespace boost::numeric::ublas;
+
+// sliced_ell_matrix against compressed_matrix for y = A x, both through their
+// kernels, over three distributions of the row lengths: constant, uniform
+// between 0 and 32, and a power law with a few very long rows. The SELL
+// matrix is built with the default chunk height 8 and sigma 256; the padding
+// it stores is reported as a fraction of the elements. Times are wall clock
+// per product, the kernels use all threads of the pool. The order of the
+// matrices is given as argument, 1 << 20 by default.
+
+double seconds_since(std::chrono::steady_clock::time_point start) {
+	return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+enum distribution { constant, uniform, power_law };
+
+std::size_t row_length(distribution d, std::size_t i, unsigned &seed) {
+	seed = seed * 1103515245u + 12345u;
+	switch (d) {
+	case constant:
+		return 16;
+	case uniform:
+		return (seed >> 8) % 33;
+	default:
+		return 64 / (i % 64 + 1) + (i % 4096 == 0 ? 4096 : 0);
+	}
+}
+
+// Columns near the diagonal, as from a discretisation, with random ones
+compressed_matrix<double> make_matrix(std::size_t n, distribution d) {
+	compressed_matrix<double> m(n, n);
+	unsigned seed = 1;
+	std::vector<std::size_t> columns;
+	for (std::size_t i = 0; i < n; i++) {
+		const std::size_t length = row_length(d, i, seed);
+		columns.clear();
+		for (std::size_t k = 0; k < length; k++) {
+			seed = seed * 1103515245u + 12345u;
+			columns.push_back(k % 2 == 0 ? (i + (seed >> 8) % 256) % n : (seed >> 4) % n);
+		}
+		std::sort(columns.begin(), columns.end());
+		columns.erase(std::unique(columns.begin(), columns.end()), columns.end());
+		for (std::size_t k = 0; k < columns.size(); k++)
+			m.push_back(i, columns[k], 1.0 / double(k + 1));
+	}
+	return m;
+}
+
+template<class M>
+double time_prod(const M &a, const vector<double> &x, vector<double> &y, std::size_t repeat) {
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+	for (std::size_t r = 0; r < repeat; r++)
+		noalias(y) = prod(a, x);
+	return seconds_since(start) / double(repeat);
+}
+
+void report(const char *name, double elapsed, std::size_t nnz) {
+	std::cout << name << ":\t" << elapsed << " s\t" << 2.0 * double(nnz) / elapsed * 1e-9 << " GFLOP/s\n";
+}
+
+int main(int argc, char *argv[]) {
+	const std::size_t N = argc > 1 ? std::size_t(std::atoi(argv[1])) : std::size_t(1) << 20;
+	const char *names[] = { "constant", "uniform", "power law" };
+	std::cout << "Threads:\t" << detail::thread_pool::instance().size() << "\n";
+	const vector<double> x(N, 1.0);
+	vector<double> y(N), z(N);
+	for (int d = constant; d <= power_law; d++) {
+		const compressed_matrix<double> A(make_matrix(N, distribution(d)));
+		const sliced_ell_matrix<double> S(A);
+		std::cout << "Row lengths " << names[d] << ":\t(" << N << ", " << N << "), " << A.nnz() << " elements, padding "
+		          << double(S.value_data().size() - S.nnz()) / double(S.nnz()) << "\n";
+		report("compressed_matrix", time_prod(A, x, y, 20), A.nnz());
+		report("sliced_ell_matrix", time_prod(S, x, z, 20), A.nnz());
+		std::cout << "difference:\t" << norm_inf(y - z) << "\n";
+	}
+	return 0;
+}
@@ -0,0 +1,71 @@
+//
+//  Copyright (c) 2017 uBLAS developers
+//
+//  Distributed under the Boost Software License, Version 1.0. (See
+//  accompanying file LICENSE_1_0.txt or copy at
+//  http://www.boost.org/LICENSE_1_0.txt)
+//
+#define BOOST_UBLAS_TYPE_CHECK 0
+
+#include <boost/numeric/ublas/matrix_sparse.hpp>
+#include <boost/numeric/ublas/operation_sparse.hpp>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+
+using namespace boost::numeric::ublas;
+
+// C = A A for compressed_matrix, through the two pass kernel and through the
+// row by row sparse_prod it replaces, on a graph with edges to 4 nearby and
+// 4 random vertices per vertex, the product of a coarsening step. Times are
+// wall clock per product, the kernel uses all threads of the pool. The
+// number of vertices is given as argument, 1 << 16 by default.
+
+double seconds_since(std::chrono::steady_clock::time_point start) {
+	return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+compressed_matrix<double> make_graph(std::size_t n) {
+	coordinate_matrix<double> m(n, n, 9 * n);
+	unsigned seed = 1;
+	for (std::size_t i = 0; i < n; i++) {
+		m.append_element(i, i, 1.0);
+		for (std::size_t k = 0; k < 8; k++) {
+			seed = seed * 1103515245u + 12345u;
+			const std::size_t j = k < 4 ? (i + 1 + (seed >> 8) % 64) % n : (seed >> 4) % n;
+			m.append_element(i, j, 1.0 / double(k + 2));
+		}
+	}
+	return compressed_matrix<double>(m);
+}
+
+int main(int argc, char *argv[]) {
+	const std::size_t n = argc > 1 ? std::size_t(std::atoi(argv[1])) : std::size_t(1) << 16;
+	std::cout << "Threads:\t" << detail::thread_pool::instance().size() << "\n";
+	const compressed_matrix<double> A(make_graph(n));
+	std::cout << "A:\t(" << n << ", " << n << "), " << A.nnz() << " elements\n";
+
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+	compressed_matrix<double> C(prod(A, A));
+	const double kernel = seconds_since(start);
+
+	compressed_matrix<double> D(n, n);
+	start = std::chrono::steady_clock::now();
+	sparse_prod(A, A, D, full(), row_major_tag());
+	const double rows = seconds_since(start);
+
+	std::cout << "C:\t" << C.nnz() << " elements\n";
+	std::cout << "prod (two pass):\t" << kernel << " s\n";
+	std::cout << "sparse_prod (row by row):\t" << rows << " s\n";
+	// Both are stored by rows in column order: compare the arrays
+	double difference = C.nnz() == D.nnz() ? 0.0 : 1.0;
+	for (std::size_t p = 0; p < (std::min)(C.nnz(), D.nnz()); p++)
+		if (C.index2_data()[p] != D.index2_data()[p])
+			difference = 1.0;
+		else
+			difference = (std::max)(difference, std::abs(C.value_data()[p] - D.value_data()[p]));
+	std::cout << "difference:\t" << difference << "\n";
+	return 0;
+}
@@ -0,0 +1,108 @@
+//
+//  Copyright (c) 2017 uBLAS developers
+//
+//  Distributed under the Boost Software License, Version 1.0. (See
+//  accompanying file LICENSE_1_0.txt or copy at
+//  http://www.boost.org/LICENSE_1_0.txt)
+//
+#define BOOST_UBLAS_TYPE_CHECK 0
+
+#include <boost/numeric/ublas/matrix_sparse.hpp>
+#include <boost/numeric/ublas/vector.hpp>
+#include <boost/numeric/ublas/operation.hpp>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+
+using namespace boost::numeric::ublas;
+
+// compressed_matrix times a vector, and its transpose times a vector, through
+// the sparse kernels against the evaluation they replace, forced here by a
+// result vector without raw storage: the serial CSR loop of axpy_prod and the
+// iterator based prod (trans (A), x). Rows have power law lengths. Times are
+// wall clock per product, the kernels use all threads of the pool. The order
+// of the matrix is given as argument, 1 << 20 by default.
+
+typedef vector<double, std::vector<double> > generic_vector;
+
+double seconds_since(std::chrono::steady_clock::time_point start) {
+	return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+// Row i holds about 64 / (i % 64 + 1) elements, some rows are much longer
+compressed_matrix<double> make_matrix(std::size_t n) {
+	compressed_matrix<double> m(n, n);
+	unsigned seed = 1;
+	std::vector<std::size_t> columns;
+	for (std::size_t i = 0; i < n; i++) {
+		std::size_t length = 64 / (i % 64 + 1) + (i % 4096 == 0 ? 4096 : 0);
+		columns.clear();
+		for (std::size_t k = 0; k < length; k++) {
+			seed = seed * 1103515245u + 12345u;
+			columns.push_back((seed >> 4) % n);
+		}
+		std::sort(columns.begin(), columns.end());
+		columns.erase(std::unique(columns.begin(), columns.end()), columns.end());
+		for (std::size_t k = 0; k < columns.size(); k++)
+			m.push_back(i, columns[k], 1.0 / double(k + 1));
+	}
+	return m;
+}
+
+template<class F>
+double time_per_call(F f, std::size_t repeat) {
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+	for (std::size_t r = 0; r < repeat; r++)
+		f();
+	return seconds_since(start) / double(repeat);
+}
+
+struct kernel_prod {
+	const compressed_matrix<double> *a; const vector<double> *x; vector<double> *y;
+	void operator()() const { noalias(*y) = prod(*a, *x); }
+};
+struct generic_prod {
+	const compressed_matrix<double> *a; const vector<double> *x; generic_vector *y;
+	void operator()() const { axpy_prod(*a, *x, *y, true); }
+};
+struct kernel_trans_prod {
+	const compressed_matrix<double> *a; const vector<double> *x; vector<double> *y;
+	void operator()() const { noalias(*y) = prod(trans(*a), *x); }
+};
+struct generic_trans_prod {
+	const compressed_matrix<double> *a; const vector<double> *x; generic_vector *y;
+	void operator()() const { noalias(*y) = prod(trans(*a), *x); }
+};
+
+void report(const char *name, double elapsed, std::size_t nnz) {
+	std::cout << name << ":\t" << elapsed << " s\t" << 2.0 * double(nnz) / elapsed * 1e-9 << " GFLOP/s\n";
+}
+
+int main(int argc, char *argv[]) {
+	const std::size_t N = argc > 1 ? std::size_t(std::atoi(argv[1])) : std::size_t(1) << 20;
+	std::cout << "Threads:\t" << detail::thread_pool::instance().size() << "\n";
+	const compressed_matrix<double> A(make_matrix(N));
+	const vector<double> x(N, 1.0);
+	vector<double> y(N);
+	generic_vector z(N);
+	std::cout << "Matrix dimensions:\t(" << N << ", " << N << "), " << A.nnz() << " elements\n";
+	kernel_prod kp = { &A, &x, &y };
+	report("prod (A, x)", time_per_call(kp, 10), A.nnz());
+	generic_prod gp = { &A, &x, &z };
+	report("serial CSR loop", time_per_call(gp, 10), A.nnz());
+	kernel_trans_prod ktp = { &A, &x, &y };
+	report("prod (trans (A), x)", time_per_call(ktp, 10), A.nnz());
+	// Far slower: only timed once, on the leading rows
+	const std::size_t M = (std::min)(N, std::size_t(1) << 14);
+	const compressed_matrix<double> B(make_matrix(M));
+	const vector<double> b(M, 1.0);
+	vector<double> c(M);
+	generic_vector d(M);
+	kernel_trans_prod kb = { &B, &b, &c };
+	generic_trans_prod gb = { &B, &b, &d };
+	std::cout << "Matrix dimensions:\t(" << M << ", " << M << "), " << B.nnz() << " elements\n";
+	report("prod (trans (A), x)", time_per_call(kb, 10), B.nnz());
+	report("iterator prod (trans (A), x)", time_per_call(gb, 1), B.nnz());
+	return 0;
+}
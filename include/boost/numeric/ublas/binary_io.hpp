@@ -0,0 +1,448 @@
+//
+//  Copyright (c) 2017
+//  uBLAS developers
+//
+//  Distributed under the Boost Software License, Version 1.0. (See
+//  accompanying file LICENSE_1_0.txt or copy at
+//  http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#ifndef _BOOST_UBLAS_BINARY_IO_
+#define _BOOST_UBLAS_BINARY_IO_
+
+#include <complex>
+#include <cstddef>
+#include <cstring>
+#include <istream>
+#include <ostream>
+
+#include <boost/cstdint.hpp>
+#include <boost/static_assert.hpp>
+#include <boost/type_traits/is_same.hpp>
+#include <boost/interprocess/file_mapping.hpp>
+#include <boost/interprocess/mapped_region.hpp>
+
+#include <boost/numeric/ublas/matrix.hpp>
+#include <boost/numeric/ublas/matrix_sparse.hpp>
+#include <boost/numeric/ublas/experimental/sparse_view.hpp>
+
+// Binary format of dense and compressed matrices.
+//
+// A file holds one matrix: a header of 64 bytes, then the arrays of its
+// storage as they are in memory, each starting at a multiple of 64 bytes from
+// the beginning of the file, the gaps filled with zeros. The header, in the
+// byte order of the machine that wrote it, is
+//
+//   offset  size  field
+//        0     8  magic "uBLASbin"
+//        8     4  format version, 1
+//       12     4  0x01020304, telling the byte order
+//       16     1  kind: 1 dense matrix, 2 compressed matrix
+//       17     1  value type: 1 float, 2 double, 3 complex<float>,
+//                 4 complex<double>, 5 int32, 6 int64
+//       18     1  layout: 0 row major, 1 column major
+//       19     1  index base of the indices of a compressed matrix
+//       20     2  size of a value in bytes
+//       22     2  size of an index in bytes, 0 for a dense matrix
+//       24     8  size1
+//       32     8  size2
+//       40     8  number of values
+//       48    16  reserved, zeros
+//
+// A dense matrix then stores its size1 size2 values in the order of its
+// layout. A compressed matrix stores its major pointers, one more than its
+// rows (row major) or columns (column major), its minor indices and its
+// values, as many as it has elements.
+//
+// save_binary and load_binary write and read the format through streams,
+// copying the arrays in single blocks. mapped_binary_file maps a file into
+// memory and exposes its arrays without reading or copying them, a dense
+// matrix through a shallow_array_adaptor; mapped_compressed_matrix is a
+// compressed_matrix_view over a mapped file.
+
+namespace boost { namespace numeric { namespace ublas {
+
+namespace detail {
+
+    // Codes of the value types; other types are not part of the format
+    template<class T>
+    struct binary_value_code;
+    template<>
+    struct binary_value_code<float> { static const unsigned char value = 1; };
+    template<>
+    struct binary_value_code<double> { static const unsigned char value = 2; };
+    template<>
+    struct binary_value_code<std::complex<float> > { static const unsigned char value = 3; };
+    template<>
+    struct binary_value_code<std::complex<double> > { static const unsigned char value = 4; };
+    template<>
+    struct binary_value_code<boost::int32_t> { static const unsigned char value = 5; };
+    template<>
+    struct binary_value_code<boost::int64_t> { static const unsigned char value = 6; };
+
+    struct binary_header {
+        char magic [8];
+        boost::uint32_t version, byte_order;
+        unsigned char kind, value_code, layout, index_base;
+        boost::uint16_t value_size, index_size;
+        boost::uint64_t size1, size2, size;
+        boost::uint64_t reserved [2];
+    };
+    BOOST_STATIC_ASSERT (sizeof (binary_header) == 64);
+
+    static const std::size_t binary_alignment = 64;
+    static const unsigned char binary_dense = 1, binary_compressed = 2;
+
+    // Offset of the array after one ending at offset
+    inline std::size_t binary_align (std::size_t offset) {
+        return (offset + binary_alignment - 1) / binary_alignment * binary_alignment;
+    }
+
+    template<class T, class L>
+    binary_header make_binary_header (unsigned char kind, std::size_t size1, std::size_t size2, std::size_t size,
+                                      std::size_t index_base, std::size_t index_size) {
+        binary_header h;
+        std::memset (&h, 0, sizeof (h));
+        std::memcpy (h.magic, "uBLASbin", 8);
+        h.version = 1;
+        h.byte_order = 0x01020304;
+        h.kind = kind;
+        h.value_code = binary_value_code<T>::value;
+        h.layout = boost::is_same<typename L::orientation_category, row_major_tag>::value ? 0 : 1;
+        h.index_base = (unsigned char) index_base;
+        h.value_size = sizeof (T);
+        h.index_size = (boost::uint16_t) index_size;
+        h.size1 = size1;
+        h.size2 = size2;
+        h.size = size;
+        return h;
+    }
+
+    // Whether h is a header of this version of the format, written on a
+    // machine of the same byte order
+    inline bool binary_header_valid (const binary_header &h) {
+        return std::memcmp (h.magic, "uBLASbin", 8) == 0 && h.version == 1 && h.byte_order == 0x01020304;
+    }
+
+    // Whether h describes a matrix of the given kind with values of type T,
+    // layout L and the given index base and size
+    template<class T, class L>
+    bool binary_header_matches (const binary_header &h, unsigned char kind,
+                                std::size_t index_base, std::size_t index_size) {
+        const binary_header e = make_binary_header<T, L> (kind, 0, 0, 0, index_base, index_size);
+        return binary_header_valid (h) && h.kind == e.kind && h.value_code == e.value_code && h.layout == e.layout &&
+               h.index_base == e.index_base && h.value_size == e.value_size && h.index_size == e.index_size &&
+               (kind != binary_dense || h.size == h.size1 * h.size2);
+    }
+
+    // Offset of the end of the values of a compressed matrix, after its
+    // header, major pointers and indices, each aligned
+    inline std::size_t binary_compressed_end (const binary_header &h, std::size_t size_major) {
+        return binary_align (binary_align (sizeof (h) + (size_major + 1) * h.index_size) +
+                             h.size * h.index_size) + h.size * h.value_size;
+    }
+
+    inline void write_binary_padding (std::ostream &os, std::size_t offset) {
+        static const char zeros [binary_alignment] = {};
+        os.write (zeros, binary_align (offset) - offset);
+    }
+
+    // Writes the n elements at p and the padding after them, offset being
+    // the number of bytes written so far; returns the new offset
+    template<class T>
+    std::size_t write_binary_array (std::ostream &os, std::size_t offset, const T *p, std::size_t n) {
+        if (n > 0)
+            os.write (reinterpret_cast<const char *> (p), std::streamsize (n * sizeof (T)));
+        write_binary_padding (os, offset + n * sizeof (T));
+        return binary_align (offset + n * sizeof (T));
+    }
+
+    template<class T>
+    std::size_t read_binary_array (std::istream &is, std::size_t offset, T *p, std::size_t n) {
+        if (n > 0)
+            is.read (reinterpret_cast<char *> (p), std::streamsize (n * sizeof (T)));
+        is.ignore (std::streamsize (binary_align (offset + n * sizeof (T)) - offset - n * sizeof (T)));
+        return binary_align (offset + n * sizeof (T));
+    }
+
+}
+
+    /** \brief Writes the dense matrix \c m to \c os in the binary format of
+     * binary_io.hpp.
+     *
+     * The stream should be opened in binary mode. The values are written as
+     * one block; see \c mapped_binary_file to use them in place afterwards.
+     */
+    template<class T, class L, class A>
+    std::ostream &save_binary (std::ostream &os, const matrix<T, L, A> &m) {
+        const std::size_t size = m.size1 () * m.size2 ();
+        const detail::binary_header h (detail::make_binary_header<T, L> (detail::binary_dense, m.size1 (), m.size2 (), size, 0, 0));
+        os.write (reinterpret_cast<const char *> (&h), sizeof (h));
+        const std::size_t size_major = L::size_M (m.size1 (), m.size2 ()), size_minor = L::size_m (m.size1 (), m.size2 ());
+        if (m.leading_dimension () == size_minor) {
+            detail::write_binary_array (os, sizeof (h), size > 0 ? &m.data () [0] : static_cast<const T *> (0), size);
+            return os;
+        }
+        // The padding of the rows or columns is left out
+        for (std::size_t k = 0; size_minor > 0 && k < size_major; ++ k)
+            os.write (reinterpret_cast<const char *> (&m.data () [k * m.leading_dimension ()]), std::streamsize (size_minor * sizeof (T)));
+        detail::write_binary_padding (os, sizeof (h) + size * sizeof (T));
+        return os;
+    }
+
+    /** \brief Writes the compressed matrix \c m to \c os in the binary format
+     * of binary_io.hpp: its major pointers, minor indices and values.
+     */
+    template<class T, class L, std::size_t IB, class IA, class TA>
+    std::ostream &save_binary (std::ostream &os, const compressed_matrix<T, L, IB, IA, TA> &m) {
+        typedef typename IA::value_type index_type;
+        const std::size_t size_major = L::size_M (m.size1 (), m.size2 ()), nnz = m.nnz ();
+        const detail::binary_header h (detail::make_binary_header<T, L> (detail::binary_compressed, m.size1 (), m.size2 (), nnz,
+                                                                         IB, sizeof (index_type)));
+        os.write (reinterpret_cast<const char *> (&h), sizeof (h));
+        // The pointers of the majors past filled1 repeat the last one
+        const std::size_t filled1 = m.filled1 ();
+        os.write (reinterpret_cast<const char *> (&m.index1_data () [0]), std::streamsize (filled1 * sizeof (index_type)));
+        for (std::size_t k = filled1; k < size_major + 1; ++ k)
+            os.write (reinterpret_cast<const char *> (&m.index1_data () [filled1 - 1]), sizeof (index_type));
+        std::size_t offset = sizeof (h) + (size_major + 1) * sizeof (index_type);
+        detail::write_binary_padding (os, offset);
+        offset = detail::write_binary_array (os, detail::binary_align (offset), nnz > 0 ? &m.index2_data () [0] : static_cast<const index_type *> (0), nnz);
+        detail::write_binary_array (os, offset, nnz > 0 ? &m.value_data () [0] : static_cast<const T *> (0), nnz);
+        return os;
+    }
+
+    /** \brief Reads into the dense matrix \c m, resized, a matrix written by
+     * \c save_binary with the same value type and layout.
+     *
+     * Sets the failbit of \c is when the header does not match.
+     */
+    template<class T, class L, class A>
+    std::istream &load_binary (std::istream &is, matrix<T, L, A> &m) {
+        detail::binary_header h;
+        if (! is.read (reinterpret_cast<char *> (&h), sizeof (h)))
+            return is;
+        if (! detail::binary_header_matches<T, L> (h, detail::binary_dense, 0, 0)) {
+            is.setstate (std::ios_base::failbit);
+            return is;
+        }
+        m.resize (std::size_t (h.size1), std::size_t (h.size2), false);
+        const std::size_t size = std::size_t (h.size);
+        detail::read_binary_array (is, sizeof (h), size > 0 ? &m.data () [0] : static_cast<T *> (0), size);
+        return is;
+    }
+
+    /** \brief Reads into the compressed matrix \c m, resized, a matrix written
+     * by \c save_binary with the same value type, layout, index base and
+     * index size.
+     *
+     * Sets the failbit of \c is when the header does not match.
+     */
+    template<class T, class L, std::size_t IB, class IA, class TA>
+    std::istream &load_binary (std::istream &is, compressed_matrix<T, L, IB, IA, TA> &m) {
+        typedef typename IA::value_type index_type;
+        detail::binary_header h;
+        if (! is.read (reinterpret_cast<char *> (&h), sizeof (h)))
+            return is;
+        if (! detail::binary_header_matches<T, L> (h, detail::binary_compressed, IB, sizeof (index_type))) {
+            is.setstate (std::ios_base::failbit);
+            return is;
+        }
+        m.resize (std::size_t (h.size1), std::size_t (h.size2), false);
+        const std::size_t size_major = L::size_M (m.size1 (), m.size2 ()), nnz = std::size_t (h.size);
+        m.reserve (nnz, false);
+        std::size_t offset = detail::read_binary_array (is, sizeof (h), &m.index1_data () [0], size_major + 1);
+        offset = detail::read_binary_array (is, offset, nnz > 0 ? &m.index2_data () [0] : static_cast<index_type *> (0), nnz);
+        detail::read_binary_array (is, offset, nnz > 0 ? &m.value_data () [0] : static_cast<T *> (0), nnz);
+        if (is)
+            m.set_filled (size_major + 1, nnz);
+        return is;
+    }
+
+    /** \brief A file in the binary format of binary_io.hpp mapped into memory,
+     * whose arrays are used in place.
+     *
+     * Opening the file only reads its header; the pages of the arrays are
+     * loaded when first accessed and are shared between all the processes
+     * mapping the file. The mapping is copy on write: writing to the elements
+     * of a view changes this process's copy of the page only, never the
+     * file. Views refer to the mapping and must not outlive it.
+     *
+     * Opening raises \c bad_argument when the file is not in the format or
+     * is truncated; a view raises \c bad_argument when the value type,
+     * layout, index base or index size do not match the file.
+     */
+    class mapped_binary_file {
+    public:
+        explicit
+        mapped_binary_file (const char *path):
+            file_ (path, boost::interprocess::read_only) {
+            // An empty file cannot be mapped
+            try {
+                boost::interprocess::mapped_region (file_, boost::interprocess::copy_on_write).swap (region_);
+            } catch (const boost::interprocess::interprocess_exception &) {
+                bad_argument ().raise ();
+            }
+            const std::size_t size = region_.get_size ();
+            // Each stored value and major pointer takes at least a byte, which
+            // keeps the products below from overflowing
+            bool valid = size >= sizeof (detail::binary_header) && detail::binary_header_valid (header ()) &&
+                         nnz () <= size;
+            if (valid && is_dense ())
+                valid = size >= sizeof (detail::binary_header) + nnz () * header ().value_size;
+            else if (valid && is_compressed ())
+                // The padding after the values may be missing
+                valid = size_major () < size && size >= detail::binary_compressed_end (header (), size_major ());
+            else
+                valid = false;
+            if (! valid)
+                bad_argument ().raise ();
+        }
+
+        // Accessors
+        const detail::binary_header &header () const {
+            return *static_cast<const detail::binary_header *> (region_.get_address ());
+        }
+        bool is_dense () const {
+            return header ().kind == detail::binary_dense;
+        }
+        bool is_compressed () const {
+            return header ().kind == detail::binary_compressed;
+        }
+        std::size_t size1 () const {
+            return std::size_t (header ().size1);
+        }
+        std::size_t size2 () const {
+            return std::size_t (header ().size2);
+        }
+        // Number of stored values
+        std::size_t nnz () const {
+            return std::size_t (header ().size);
+        }
+
+#ifdef BOOST_UBLAS_SHALLOW_ARRAY_ADAPTOR
+        /** \brief The dense matrix of the file, of value type \c T and layout
+         * \c L, over the values in place.
+         */
+        template<class T, class L>
+        matrix<T, L, shallow_array_adaptor<T> > dense_view () const {
+            if (! detail::binary_header_matches<T, L> (header (), detail::binary_dense, 0, 0))
+                bad_argument ().raise ();
+            return matrix<T, L, shallow_array_adaptor<T> > (size1 (), size2 (),
+                                                           shallow_array_adaptor<T> (nnz (), at<T> (sizeof (detail::binary_header))));
+        }
+        template<class T>
+        matrix<T, row_major, shallow_array_adaptor<T> > dense_view () const {
+            return dense_view<T, row_major> ();
+        }
+#endif
+
+        /** \brief The arrays of the compressed matrix of the file: its major
+         * pointers, minor indices and values.
+         */
+        template<class T, class L, std::size_t IB, class I>
+        c_array_view<const I> index1_data () const {
+            check_compressed<T, L, IB, I> ();
+            return c_array_view<const I> (size_major () + 1, at<const I> (sizeof (detail::binary_header)));
+        }
+        template<class T, class L, std::size_t IB, class I>
+        c_array_view<const I> index2_data () const {
+            check_compressed<T, L, IB, I> ();
+            return c_array_view<const I> (nnz (), at<const I> (index2_offset (sizeof (I))));
+        }
+        template<class T, class L, std::size_t IB, class I>
+        c_array_view<const T> value_data () const {
+            check_compressed<T, L, IB, I> ();
+            return c_array_view<const T> (nnz (), at<const T> (detail::binary_align (index2_offset (sizeof (I)) + nnz () * sizeof (I))));
+        }
+
+    private:
+        std::size_t size_major () const {
+            return header ().layout == 0 ? size1 () : size2 ();
+        }
+        std::size_t index2_offset (std::size_t index_size) const {
+            return detail::binary_align (sizeof (detail::binary_header) + (size_major () + 1) * index_size);
+        }
+        template<class T, class L, std::size_t IB, class I>
+        void check_compressed () const {
+            if (! detail::binary_header_matches<T, L> (header (), detail::binary_compressed, IB, sizeof (I)))
+                bad_argument ().raise ();
+        }
+        template<class T>
+        T *at (std::size_t offset) const {
+            return reinterpret_cast<T *> (static_cast<char *> (region_.get_address ()) + offset);
+        }
+
+        boost::interprocess::file_mapping file_;
+        boost::interprocess::mapped_region region_;
+    };
+
+namespace detail {
+
+    // The mapping and the arrays of a mapped_compressed_matrix, constructed
+    // before the view referring to them
+    template<class T, class L, std::size_t IB, class I>
+    struct mapped_compressed_arrays {
+        explicit
+        mapped_compressed_arrays (const char *path):
+            file_ (path),
+            index1_data_ (file_.index1_data<T, L, IB, I> ()),
+            index2_data_ (file_.index2_data<T, L, IB, I> ()),
+            value_data_ (file_.value_data<T, L, IB, I> ()) {}
+
+        mapped_binary_file file_;
+        c_array_view<const I> index1_data_, index2_data_;
+        c_array_view<const T> value_data_;
+    };
+
+}
+
+    /** \brief The compressed matrix of a file in the binary format of
+     * binary_io.hpp, used in place through a compressed_matrix_view over
+     * the mapped file.
+     *
+     * \c T, \c L, \c IB and \c I are the value type, layout, index base and
+     * index type the file was written with; see \c mapped_binary_file for
+     * the mapping and the errors. The matrix cannot be copied, as the view
+     * refers to its own arrays.
+     */
+    template<class T, class L = row_major, std::size_t IB = 0, class I = std::size_t>
+    class mapped_compressed_matrix:
+        private detail::mapped_compressed_arrays<T, L, IB, I>,
+        public compressed_matrix_view<L, IB, c_array_view<const I>, c_array_view<const I>, c_array_view<const T> > {
+
+        typedef detail::mapped_compressed_arrays<T, L, IB, I> arrays_type;
+        typedef compressed_matrix_view<L, IB, c_array_view<const I>, c_array_view<const I>, c_array_view<const T> > view_type;
+
+    public:
+        explicit
+        mapped_compressed_matrix (const char *path):
+            arrays_type (path),
+            view_type (arrays_type::file_.size1 (), arrays_type::file_.size2 (), arrays_type::file_.nnz (),
+                       arrays_type::index1_data_, arrays_type::index2_data_, arrays_type::value_data_) {}
+
+        // Accessors
+        const mapped_binary_file &file () const {
+            return arrays_type::file_;
+        }
+        std::size_t nnz () const {
+            return arrays_type::file_.nnz ();
+        }
+        const c_array_view<const I> &index1_data () const {
+            return arrays_type::index1_data_;
+        }
+        const c_array_view<const I> &index2_data () const {
+            return arrays_type::index2_data_;
+        }
+        const c_array_view<const T> &value_data () const {
+            return arrays_type::value_data_;
+        }
+
+    private:
+        mapped_compressed_matrix (const mapped_compressed_matrix &);
+        mapped_compressed_matrix &operator = (const mapped_compressed_matrix &);
+    };
+
+}}}
+
+#endif
@@ -0,0 +1,265 @@
+//
+//  Copyright (c) 2017
+//  uBLAS developers
+//
+//  Distributed under the Boost Software License, Version 1.0. (See
+//  accompanying file LICENSE_1_0.txt or copy at
+//  http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#ifndef _BOOST_UBLAS_CHOLESKY_
+#define _BOOST_UBLAS_CHOLESKY_
+
+#include <boost/numeric/ublas/operation.hpp>
+#include <boost/numeric/ublas/matrix_proxy.hpp>
+#include <boost/numeric/ublas/vector.hpp>
+#include <boost/numeric/ublas/triangular.hpp>
+#include <boost/numeric/ublas/symmetric.hpp>
+#include <boost/numeric/ublas/hermitian.hpp>
+#include <boost/numeric/ublas/detail/dense_traits.hpp>
+#include <boost/numeric/ublas/detail/potrf.hpp>
+#include <boost/numeric/ublas/detail/trsm.hpp>
+#include <boost/type_traits/is_base_of.hpp>
+#include <boost/type_traits/is_convertible.hpp>
+#include <boost/type_traits/is_same.hpp>
+
+// Cholesky factorizations of symmetric and hermitian positive definite
+// matrices in the spirit of LAPACK's potrf: A = L L^H, or A = L D L^H with L
+// unit lower and without square roots. Only the lower triangle of A is read,
+// L (and D on the diagonal) overwrites it. Works on dense matrices, on
+// symmetric_matrix and hermitian_matrix with either packed triangle, and on
+// symmetric_adaptor and hermitian_adaptor.
+
+namespace boost { namespace numeric { namespace ublas {
+
+namespace detail {
+
+    // Assignment to an element on or below the diagonal
+    template<class M, class T>
+    BOOST_UBLAS_INLINE
+    void cholesky_assign (M &m, std::size_t i, std::size_t j, const T &t) {
+        m (i, j) = t;
+    }
+    // Hermitian containers refuse references into the other triangle
+    template<class T, class TRI, class L, class A, class U>
+    BOOST_UBLAS_INLINE
+    void cholesky_assign (hermitian_matrix<T, TRI, L, A> &m, std::size_t i, std::size_t j, const U &t) {
+        m.insert_element (i, j, t);
+    }
+    template<class M, class TRI, class U>
+    BOOST_UBLAS_INLINE
+    void cholesky_assign (hermitian_adaptor<M, TRI> &m, std::size_t i, std::size_t j, const U &t) {
+        m.insert_element (i, j, t);
+    }
+
+    // Lower triangle of any matrix through its element access
+    template<class M>
+    struct cholesky_element_access {
+        typedef typename M::value_type value_type;
+        M *m;
+
+        // Rows [i0, i1) and columns [j0, j1) into t, row major with leading
+        // dimension ld, zero above the diagonal
+        void load (std::size_t i0, std::size_t i1, std::size_t j0, std::size_t j1, value_type *t, std::size_t ld) const {
+            const M &cm = *m;
+            for (std::size_t i = i0; i < i1; ++ i)
+                for (std::size_t j = j0; j < j1; ++ j)
+                    t [(i - i0) * ld + (j - j0)] = j <= i ? value_type (cm (i, j)) : value_type ();
+        }
+        void store (std::size_t i0, std::size_t i1, std::size_t j0, std::size_t j1, const value_type *t, std::size_t ld) const {
+            for (std::size_t i = i0; i < i1; ++ i) {
+                const std::size_t j_end = (std::min) (i + 1, j1);
+                for (std::size_t j = j0; j < j_end; ++ j)
+                    cholesky_assign (*m, i, j, t [(i - i0) * ld + (j - j0)]);
+            }
+        }
+    };
+
+    // Lower triangle of a dense matrix through its storage
+    template<class T>
+    struct cholesky_strided_access {
+        T *data;
+        std::ptrdiff_t stride1, stride2;
+
+        void load (std::size_t i0, std::size_t i1, std::size_t j0, std::size_t j1, T *t, std::size_t ld) const {
+            for (std::size_t i = i0; i < i1; ++ i) {
+                const T *row = data + std::ptrdiff_t (i) * stride1;
+                for (std::size_t j = j0; j < j1; ++ j)
+                    t [(i - i0) * ld + (j - j0)] = j <= i ? row [std::ptrdiff_t (j) * stride2] : T ();
+            }
+        }
+        void store (std::size_t i0, std::size_t i1, std::size_t j0, std::size_t j1, const T *t, std::size_t ld) const {
+            for (std::size_t i = i0; i < i1; ++ i) {
+                T *row = data + std::ptrdiff_t (i) * stride1;
+                const std::size_t j_end = (std::min) (i + 1, j1);
+                for (std::size_t j = j0; j < j_end; ++ j)
+                    row [std::ptrdiff_t (j) * stride2] = t [(i - i0) * ld + (j - j0)];
+            }
+        }
+    };
+
+    template<class M>
+    BOOST_UBLAS_INLINE
+    typename M::size_type cholesky_factorize (M &m, bool ldlt, boost::mpl::false_) {
+        typedef typename M::value_type value_type;
+        // Distinct elements of dense and packed storage are distinct objects
+        const bool parallel = boost::is_convertible<typename M::storage_category, packed_proxy_tag>::value;
+        cholesky_element_access<M> access = { &m };
+        return potrf<value_type> (ldlt, m.size1 (), access, parallel);
+    }
+    template<class M>
+    BOOST_UBLAS_INLINE
+    typename M::size_type cholesky_factorize (M &m, bool ldlt, boost::mpl::true_) {
+        typedef dense_matrix_traits<M> traits;
+        typedef typename M::value_type value_type;
+        cholesky_strided_access<value_type> access = { traits::data (m), traits::stride1 (m), traits::stride2 (m) };
+        return potrf<value_type> (ldlt, m.size1 (), access, true);
+    }
+    template<class M>
+    BOOST_UBLAS_INLINE
+    typename M::size_type cholesky_factorize (M &m, bool ldlt) {
+        BOOST_UBLAS_CHECK (m.size1 () == m.size2 (), bad_size ());
+        return cholesky_factorize (m, ldlt, boost::mpl::bool_<dense_matrix_traits<M>::value> ());
+    }
+
+    template<class M, class E>
+    BOOST_UBLAS_INLINE
+    bool blocked_cholesky_substitute (const M &, E &, bool, boost::mpl::false_) {
+        return false;
+    }
+    template<class M, class E>
+    BOOST_UBLAS_INLINE
+    bool blocked_cholesky_substitute (const M &m, E &e, bool ldlt, boost::mpl::true_) {
+        typedef typename E::value_type value_type;
+        typedef dense_matrix_traits<M> traits1;
+        typedef dense_matrix_traits<E> traits2;
+
+        BOOST_UBLAS_CHECK (m.size1 () == m.size2 (), bad_size ());
+        BOOST_UBLAS_CHECK (m.size2 () == e.size1 (), bad_size ());
+        const std::size_t size = e.size1 (), size2 = e.size2 ();
+        const value_type *a = traits1::data (m);
+        value_type *b = traits2::data (e);
+        // A single block is the unblocked algorithm anyway
+        if (size <= std::size_t (BOOST_UBLAS_FACTORIZE_BLOCK) || a == b)
+            return false;
+        const std::ptrdiff_t a1 = traits1::stride1 (m), a2 = traits1::stride2 (m);
+        const std::ptrdiff_t b1 = traits2::stride1 (e), b2 = traits2::stride2 (e);
+        trsm (false, ldlt, size, size2, a, a1, a2, b, b1, b2);
+        if (ldlt) {
+            for (std::size_t i = 0; i < size; ++ i) {
+                const value_type d = a [std::ptrdiff_t (i) * (a1 + a2)];
+                for (std::size_t l = 0; l < size2; ++ l)
+                    b [std::ptrdiff_t (i) * b1 + std::ptrdiff_t (l) * b2] /= d;
+            }
+        }
+        // L^T is the upper triangle of the transposed storage
+        trsm (true, ldlt, size, size2, a, a2, a1, b, b1, b2);
+        return true;
+    }
+
+    // Both triangular solves through trsm when the factor and the right hand
+    // sides are real and dense. Returns false, without touching e, otherwise.
+    template<class M, class E>
+    BOOST_UBLAS_INLINE
+    bool blocked_cholesky_substitute (const M &m, E &e, bool ldlt) {
+        typedef typename E::value_type value_type;
+        typedef boost::mpl::bool_<dense_matrix_traits<M>::value &&
+                                  dense_matrix_traits<E>::value &&
+                                  boost::is_base_of<matrix_container<E>, E>::value &&
+                                  boost::is_same<typename M::value_type, value_type>::value &&
+                                  boost::is_same<typename type_traits<value_type>::real_type, value_type>::value> dispatch;
+        return blocked_cholesky_substitute (m, e, ldlt, dispatch ());
+    }
+
+}
+
+    // Cholesky factorization A = L L^H of a symmetric or hermitian positive
+    // definite matrix. Returns 0, or one past the first column whose pivot is
+    // not positive; the columns before it are factored.
+    template<class M>
+    typename M::size_type cholesky_factorize (M &m) {
+        typedef typename M::size_type size_type;
+#if BOOST_UBLAS_TYPE_CHECK
+        typedef matrix<typename M::value_type> matrix_type;
+
+        matrix_type cm (m);
+#endif
+        size_type singular = detail::cholesky_factorize (m, false);
+#if BOOST_UBLAS_TYPE_CHECK
+        matrix_type lm (m);
+        BOOST_UBLAS_CHECK (singular != 0 ||
+                           detail::expression_type_check (prod (triangular_adaptor<matrix_type, lower> (lm),
+                                                                herm (triangular_adaptor<matrix_type, lower> (lm))),
+                                                          hermitian_adaptor<matrix_type, lower> (cm)), internal_logic ());
+#endif
+        return singular;
+    }
+
+    // Cholesky substitution: solves L L^H x = b over b
+    template<class M, class E>
+    void cholesky_substitute (const M &m, vector_expression<E> &e) {
+        typedef triangular_adaptor<const M, lower> factor_type;
+        inplace_solve (factor_type (m), e, lower_tag ());
+        inplace_solve (herm (factor_type (m)), e, upper_tag ());
+    }
+    template<class M, class E>
+    void cholesky_substitute (const M &m, matrix_expression<E> &e) {
+        typedef triangular_adaptor<const M, lower> factor_type;
+        if (detail::blocked_cholesky_substitute (m, e (), false))
+            return;
+        inplace_solve (factor_type (m), e, lower_tag ());
+        inplace_solve (herm (factor_type (m)), e, upper_tag ());
+    }
+
+    // Factorization A = L D L^H, L unit lower and D diagonal, of a symmetric
+    // or hermitian matrix whose leading minors are non singular. D is stored
+    // on the diagonal. Returns 0, or one past the first zero pivot.
+    template<class M>
+    typename M::size_type ldlt_factorize (M &m) {
+        typedef typename M::size_type size_type;
+#if BOOST_UBLAS_TYPE_CHECK
+        typedef matrix<typename M::value_type> matrix_type;
+
+        matrix_type cm (m);
+#endif
+        size_type singular = detail::cholesky_factorize (m, true);
+#if BOOST_UBLAS_TYPE_CHECK
+        matrix_type lm (m);
+        // L D, the columns of the unit lower factor scaled by the pivots
+        const triangular_adaptor<matrix_type, unit_lower> l (lm);
+        matrix_type ldm (l);
+        for (size_type j = 0; j < ldm.size2 (); ++ j)
+            for (size_type i = j; i < ldm.size1 (); ++ i)
+                ldm (i, j) *= lm (j, j);
+        BOOST_UBLAS_CHECK (singular != 0 ||
+                           detail::expression_type_check (prod (ldm, herm (l)),
+                                                          hermitian_adaptor<matrix_type, lower> (cm)), internal_logic ());
+#endif
+        return singular;
+    }
+
+    // L D L^H substitution: solves L D L^H x = b over b
+    template<class M, class E>
+    void ldlt_substitute (const M &m, vector_expression<E> &e) {
+        typedef typename M::size_type size_type;
+        typedef triangular_adaptor<const M, unit_lower> factor_type;
+        inplace_solve (factor_type (m), e, unit_lower_tag ());
+        for (size_type i = 0; i < e ().size (); ++ i)
+            e () (i) /= m (i, i);
+        inplace_solve (herm (factor_type (m)), e, unit_upper_tag ());
+    }
+    template<class M, class E>
+    void ldlt_substitute (const M &m, matrix_expression<E> &e) {
+        typedef typename M::size_type size_type;
+        typedef triangular_adaptor<const M, unit_lower> factor_type;
+        if (detail::blocked_cholesky_substitute (m, e (), true))
+            return;
+        inplace_solve (factor_type (m), e, unit_lower_tag ());
+        for (size_type i = 0; i < e ().size1 (); ++ i)
+            row (e (), i) /= m (i, i);
+        inplace_solve (herm (factor_type (m)), e, unit_upper_tag ());
+    }
+
+}}}
+
+#endif
@@ -279,6 +279,117 @@ bool disable_type_check<Dummy>::value = false;
 #define BOOST_UBLAS_BOUNDED_ARRAY_ALIGN
 #endif
 
+// Default alignment of aligned_allocator, and so of aligned_vector and
+// aligned_matrix: a cache line, which is also the width of the widest SIMD
+// registers
+#ifndef BOOST_UBLAS_ALIGNED_ALLOCATOR_ALIGN
+#define BOOST_UBLAS_ALIGNED_ALLOCATOR_ALIGN 64
+#endif
+
+// Alignment of the scratch memory used by the dense product kernels
+#ifndef BOOST_UBLAS_WORKSPACE_ALIGN
+#define BOOST_UBLAS_WORKSPACE_ALIGN 64
+#endif
+
+// Order from which dense products take Strassen steps; below it the recursion
+// falls back to the packed product. detail::strassen_calibrate<T> () replaces
+// it with one measured on the running machine.
+#ifndef BOOST_UBLAS_STRASSEN_CUTOFF
+#define BOOST_UBLAS_STRASSEN_CUTOFF 1024
+#endif
+
+// Largest order timed when measuring the Strassen cutoff
+#ifndef BOOST_UBLAS_STRASSEN_CALIBRATION_LIMIT
+#define BOOST_UBLAS_STRASSEN_CALIBRATION_LIMIT 1024
+#endif
+
+// Cache blocking of the packed dense product: MC x KC panels of the left
+// operand are kept in L2, KC x NC panels of the right operand in L3, and an
+// MR x NR block of the result is accumulated in registers.
+#ifndef BOOST_UBLAS_GEMM_MC
+#define BOOST_UBLAS_GEMM_MC 128
+#endif
+#ifndef BOOST_UBLAS_GEMM_KC
+#define BOOST_UBLAS_GEMM_KC 256
+#endif
+#ifndef BOOST_UBLAS_GEMM_NC
+#define BOOST_UBLAS_GEMM_NC 4096
+#endif
+#ifndef BOOST_UBLAS_GEMM_MR
+#define BOOST_UBLAS_GEMM_MR 4
+#endif
+#ifndef BOOST_UBLAS_GEMM_NR
+#define BOOST_UBLAS_GEMM_NR 8
+#endif
+
+// Dense kernels choose between SSE2, AVX2 and AVX-512 code at run time (see
+// detail/simd.hpp). Define to always run the portable loops.
+// #define BOOST_UBLAS_NO_SIMD_DISPATCH
+
+// Parallel assignment: parallel (noalias (lhs)) = rhs_expression
+// Number of threads of the shared pool, 0 for one per hardware thread
+#ifndef BOOST_UBLAS_THREADS
+#define BOOST_UBLAS_THREADS 0
+#endif
+// Smallest number of elements worth splitting across threads; smaller
+// assignments run serially
+#ifndef BOOST_UBLAS_PARALLEL_THRESHOLD
+#define BOOST_UBLAS_PARALLEL_THRESHOLD 65536
+#endif
+// Define to make parallel assignments serial and never start threads
+// #define BOOST_UBLAS_NO_THREADS
+
+// Matrix chain products (A * B * C ...): subchains of at least this many
+// multiply-adds are evaluated concurrently
+#ifndef BOOST_UBLAS_CHAIN_PARALLEL_COST
+#define BOOST_UBLAS_CHAIN_PARALLEL_COST (1 << 20)
+#endif
+// Bytes of intermediate results a chain product may hold at a time before
+// it stops running subchains concurrently
+#ifndef BOOST_UBLAS_CHAIN_MEMORY_LIMIT
+#define BOOST_UBLAS_CHAIN_MEMORY_LIMIT (std::size_t (1) << 28)
+#endif
+// Cost of a multiply-add of the sparse chain product kernels relative to one
+// of the packed GEMM kernel
+#ifndef BOOST_UBLAS_CHAIN_SPARSE_PENALTY
+#define BOOST_UBLAS_CHAIN_SPARSE_PENALTY 4
+#endif
+// Number of chain plans kept for reuse, keyed on the operand dimensions; 0
+// plans every chain afresh
+#ifndef BOOST_UBLAS_CHAIN_PLAN_CACHE_SIZE
+#define BOOST_UBLAS_CHAIN_PLAN_CACHE_SIZE 256
+#endif
+
+// Dense factorizations (lu_factorize, cholesky_factorize, qr_factorize) and
+// triangular solves with matrix right hand sides (inplace_solve): width of the
+// panels of the blocked algorithms, and the multiply-adds of an update from
+// which it is split across threads
+#ifndef BOOST_UBLAS_FACTORIZE_BLOCK
+#define BOOST_UBLAS_FACTORIZE_BLOCK 64
+#endif
+#ifndef BOOST_UBLAS_FACTORIZE_PARALLEL_COST
+#define BOOST_UBLAS_FACTORIZE_PARALLEL_COST (1 << 20)
+#endif
+
+// Sparse matrix-vector products with at least this many stored elements, and
+// sparse matrix products with at least this many multiply-adds, are split
+// across threads
+#ifndef BOOST_UBLAS_SPARSE_PARALLEL_NNZ
+#define BOOST_UBLAS_SPARSE_PARALLEL_NNZ 65536
+#endif
+
+// Text input and output of io.hpp: matrices are parsed and formatted in blocks
+// of rows of about this many elements, split across threads
+#ifndef BOOST_UBLAS_TEXT_BLOCK_SIZE
+#define BOOST_UBLAS_TEXT_BLOCK_SIZE 65536
+#endif
+
+// Matrix Market files of matrix_market.hpp are read and parsed in chunks of
+// this many bytes
+#ifndef BOOST_UBLAS_MATRIX_MARKET_CHUNK
+#define BOOST_UBLAS_MATRIX_MARKET_CHUNK (std::size_t (1) << 24)
+#endif
+
 // Enable different sparse element proxies
 #ifndef BOOST_UBLAS_NO_ELEMENT_PROXIES
 // Sparse proxies prevent reference invalidation problems in expressions such as:
@@ -78,6 +78,8 @@ namespace boost { namespace numeric { namespace ublas {
 
     private:
         closure_type lval_;
+
+        template<class> friend class parallel_proxy;
     };
 
     // Improve syntax of efficient assignment where no aliases of LHS appear on the RHS
@@ -93,6 +95,69 @@ namespace boost { namespace numeric { namespace ublas {
         return noalias_proxy<const C> (lvalue);
     }
 
+    // Selects the multithreaded dense assignments
+    struct parallel_tag {};
+
+    namespace detail {
+        // Parallel assignment of vectors (vector_assign.hpp) and matrices
+        // (matrix_assign.hpp). Returns false, without touching the left hand
+        // side, when the assignment should rather run serially.
+        template<class TC>
+        struct parallel_assigner;
+    }
+
+    // Assignment proxy.
+    // As noalias_proxy, but large dense assignments are split across threads
+    template<class C>
+    class parallel_proxy:
+        private nonassignable {
+        typedef detail::parallel_assigner<typename C::type_category> assigner_type;
+    public:
+        typedef typename C::closure_type closure_type;
+
+        BOOST_UBLAS_INLINE
+        parallel_proxy (const noalias_proxy<C>& p):
+            nonassignable (), lval_ (p.lval_) {}
+        BOOST_UBLAS_INLINE
+        parallel_proxy (const parallel_proxy& p):
+            nonassignable (), lval_ (p.lval_) {}
+
+        template <class E>
+        BOOST_UBLAS_INLINE
+        closure_type &operator= (const E& e) {
+            if (! assigner_type::assign (lval_, e))
+                lval_.assign (e);
+            return lval_;
+        }
+
+        template <class E>
+        BOOST_UBLAS_INLINE
+        closure_type &operator+= (const E& e) {
+            if (! assigner_type::plus_assign (lval_, e))
+                lval_.plus_assign (e);
+            return lval_;
+        }
+
+        template <class E>
+        BOOST_UBLAS_INLINE
+        closure_type &operator-= (const E& e) {
+            if (! assigner_type::minus_assign (lval_, e))
+                lval_.minus_assign (e);
+            return lval_;
+        }
+
+    private:
+        closure_type lval_;
+    };
+
+    // Multithreaded no alias assignment
+    //  parallel(noalias(lhs)) = rhs_expression
+    template <class C>
+    BOOST_UBLAS_INLINE
+    parallel_proxy<C> parallel (const noalias_proxy<C>& p) {
+        return parallel_proxy<C> (p);
+    }
+
     // Possible future compatible syntax where lvalue possible has an unsafe alias on the RHS
     //  safe(lhs) = rhs_expression
     template <class C>
@@ -0,0 +1,272 @@
+//
+//  Copyright (c) 2017
+//  uBLAS developers
+//
+//  Distributed under the Boost Software License, Version 1.0. (See
+//  accompanying file LICENSE_1_0.txt or copy at
+//  http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#ifndef _BOOST_UBLAS_DENSE_TRAITS_
+#define _BOOST_UBLAS_DENSE_TRAITS_
+
+#include <algorithm>
+#include <cstddef>
+
+#include <boost/mpl/if.hpp>
+#include <boost/type_traits/is_const.hpp>
+#include <boost/type_traits/is_same.hpp>
+#include <boost/type_traits/alignment_of.hpp>
+#include <boost/numeric/ublas/detail/config.hpp>
+
+// Raw access to the storage of dense containers for the optimised kernels.
+// Only containers whose elements are known to be contiguous are described;
+// every other expression reports value == false and keeps the generic
+// evaluation. alignment is the alignment in bytes data () is known to have at
+// compile time.
+
+namespace boost { namespace numeric { namespace ublas { namespace detail {
+
+    // Alignment of the first element of a storage array
+    template<class A>
+    struct storage_alignment {
+        static const std::size_t value = boost::alignment_of<typename A::value_type>::value;
+    };
+
+    template<class T, std::size_t Align>
+    struct storage_alignment<unbounded_array<T, aligned_allocator<T, Align> > > {
+        static const std::size_t value = Align;
+    };
+
+    // Direct access to the storage of dense vectors: element i lives at
+    // data (v) [i].
+    template<class V>
+    struct dense_vector_traits {
+        static const bool value = false;
+        static const std::size_t alignment = 1;
+    };
+
+    template<class V>
+    struct dense_vector_traits<const V>:
+        public dense_vector_traits<V> {};
+
+    // Both array types hand out plain pointers as iterators
+    template<class V>
+    struct dense_array_vector_traits {
+        typedef V vector_type;
+        typedef typename V::value_type value_type;
+        static const bool value = true;
+        static const std::size_t alignment = storage_alignment<typename V::array_type>::value;
+
+        static BOOST_UBLAS_INLINE
+        const value_type *data (const vector_type &v) {
+            return v.data ().begin ();
+        }
+        static BOOST_UBLAS_INLINE
+        value_type *data (vector_type &v) {
+            return v.data ().begin ();
+        }
+    };
+
+    template<class T, class A>
+    struct dense_vector_traits<vector<T, unbounded_array<T, A> > >:
+        public dense_array_vector_traits<vector<T, unbounded_array<T, A> > > {};
+
+    template<class T, std::size_t N, class A>
+    struct dense_vector_traits<vector<T, bounded_array<T, N, A> > >:
+        public dense_array_vector_traits<vector<T, bounded_array<T, N, A> > > {};
+
+    template<class T, std::size_t N>
+    struct dense_vector_traits<bounded_vector<T, N> >:
+        public dense_array_vector_traits<vector<T, bounded_array<T, N> > > {};
+
+    template<class T, std::size_t N>
+    struct dense_vector_traits<c_vector<T, N> > {
+        typedef c_vector<T, N> vector_type;
+        static const bool value = true;
+        static const std::size_t alignment = boost::alignment_of<T>::value;
+
+        static BOOST_UBLAS_INLINE
+        const T *data (const vector_type &v) {
+            return v.data ();
+        }
+        static BOOST_UBLAS_INLINE
+        T *data (vector_type &v) {
+            return v.data ();
+        }
+    };
+
+    // Closures of dense vectors
+    template<class E>
+    struct dense_vector_traits<vector_reference<E> > {
+        typedef dense_vector_traits<E> referred_traits;
+        static const bool value = referred_traits::value;
+        static const std::size_t alignment = referred_traits::alignment;
+
+        static BOOST_UBLAS_INLINE
+        const typename E::value_type *data (const vector_reference<E> &v) {
+            return referred_traits::data (v.expression ());
+        }
+    };
+
+    // Direct access to the storage of dense matrices: element (i, j) lives at
+    // data (m) [i * stride1 (m) + j * stride2 (m)].
+    template<class M>
+    struct dense_matrix_traits {
+        static const bool value = false;
+        static const std::size_t alignment = 1;
+    };
+
+    template<class M>
+    struct dense_matrix_traits<const M>:
+        public dense_matrix_traits<M> {};
+
+    template<class T, class L, class A>
+    struct dense_matrix_traits<matrix<T, L, unbounded_array<T, A> > > {
+        typedef matrix<T, L, unbounded_array<T, A> > matrix_type;
+        typedef boost::is_same<typename L::orientation_category, row_major_tag> is_row_major;
+        static const bool value = true;
+        static const std::size_t alignment = storage_alignment<unbounded_array<T, A> >::value;
+
+        static BOOST_UBLAS_INLINE
+        const T *data (const matrix_type &m) {
+            return m.data ().begin ();
+        }
+        static BOOST_UBLAS_INLINE
+        T *data (matrix_type &m) {
+            return m.data ().begin ();
+        }
+        static BOOST_UBLAS_INLINE
+        std::ptrdiff_t stride1 (const matrix_type &m) {
+            return is_row_major::value ? std::ptrdiff_t (m.leading_dimension ()) : 1;
+        }
+        static BOOST_UBLAS_INLINE
+        std::ptrdiff_t stride2 (const matrix_type &m) {
+            return is_row_major::value ? 1 : std::ptrdiff_t (m.leading_dimension ());
+        }
+    };
+
+    template<class T, std::size_t N, std::size_t M>
+    struct dense_matrix_traits<c_matrix<T, N, M> > {
+        typedef c_matrix<T, N, M> matrix_type;
+        static const bool value = true;
+        static const std::size_t alignment = boost::alignment_of<T>::value;
+
+        static BOOST_UBLAS_INLINE
+        const T *data (const matrix_type &m) {
+            return m.data ();
+        }
+        static BOOST_UBLAS_INLINE
+        T *data (matrix_type &m) {
+            return m.data ();
+        }
+        static BOOST_UBLAS_INLINE
+        std::ptrdiff_t stride1 (const matrix_type &) {
+            return M;
+        }
+        static BOOST_UBLAS_INLINE
+        std::ptrdiff_t stride2 (const matrix_type &) {
+            return 1;
+        }
+    };
+
+    // Closures of dense matrices
+    template<class E>
+    struct dense_matrix_traits<matrix_reference<E> > {
+        typedef dense_matrix_traits<E> referred_traits;
+        static const bool value = referred_traits::value;
+        static const std::size_t alignment = referred_traits::alignment;
+
+        static BOOST_UBLAS_INLINE
+        const typename E::value_type *data (const matrix_reference<E> &m) {
+            return referred_traits::data (m.expression ());
+        }
+        // Writable unless the referred matrix is const
+        static BOOST_UBLAS_INLINE
+        typename boost::mpl::if_<boost::is_const<E>,
+                                 const typename E::value_type *,
+                                 typename E::value_type *>::type
+        data (matrix_reference<E> &m) {
+            return referred_traits::data (m.expression ());
+        }
+        static BOOST_UBLAS_INLINE
+        std::ptrdiff_t stride1 (const matrix_reference<E> &m) {
+            return referred_traits::stride1 (m.expression ());
+        }
+        static BOOST_UBLAS_INLINE
+        std::ptrdiff_t stride2 (const matrix_reference<E> &m) {
+            return referred_traits::stride2 (m.expression ());
+        }
+    };
+
+    // Ranges of dense matrices share the storage and strides of the matrix
+    // they refer to, starting at element (start1, start2)
+    template<class M>
+    struct dense_matrix_traits<matrix_range<M> > {
+        typedef matrix_range<M> matrix_type;
+        typedef dense_matrix_traits<typename matrix_type::matrix_closure_type> referred_traits;
+        typedef typename M::value_type value_type;
+        typedef typename boost::mpl::if_<boost::is_const<M>,
+                                         const value_type *,
+                                         value_type *>::type pointer;
+        static const bool value = referred_traits::value;
+        // The range may start anywhere
+        static const std::size_t alignment = boost::alignment_of<value_type>::value;
+
+        static BOOST_UBLAS_INLINE
+        const value_type *data (const matrix_type &m) {
+            return referred_traits::data (m.data ()) + offset (m);
+        }
+        static BOOST_UBLAS_INLINE
+        pointer data (matrix_type &m) {
+            return referred_traits::data (m.data ()) + offset (m);
+        }
+        static BOOST_UBLAS_INLINE
+        std::ptrdiff_t stride1 (const matrix_type &m) {
+            return referred_traits::stride1 (m.data ());
+        }
+        static BOOST_UBLAS_INLINE
+        std::ptrdiff_t stride2 (const matrix_type &m) {
+            return referred_traits::stride2 (m.data ());
+        }
+
+    private:
+        static BOOST_UBLAS_INLINE
+        std::ptrdiff_t offset (const matrix_type &m) {
+            return std::ptrdiff_t (m.start1 ()) * stride1 (m) + std::ptrdiff_t (m.start2 ()) * stride2 (m);
+        }
+    };
+
+    // [first, last) of the storage the elements of a dense matrix lie in,
+    // empty for an empty matrix
+    template<class M>
+    BOOST_UBLAS_INLINE
+    void dense_storage_span (const M &m, const typename M::value_type *&first, const typename M::value_type *&last) {
+        typedef dense_matrix_traits<M> traits;
+        const typename M::value_type *p = traits::data (m);
+        if (m.size1 () == 0 || m.size2 () == 0) {
+            first = last = p;
+            return;
+        }
+        const std::ptrdiff_t d1 = std::ptrdiff_t (m.size1 () - 1) * traits::stride1 (m);
+        const std::ptrdiff_t d2 = std::ptrdiff_t (m.size2 () - 1) * traits::stride2 (m);
+        first = p + (std::min) (std::ptrdiff_t (0), d1) + (std::min) (std::ptrdiff_t (0), d2);
+        last = p + (std::max) (std::ptrdiff_t (0), d1) + (std::max) (std::ptrdiff_t (0), d2) + 1;
+    }
+
+    // Whether the storage spans of two dense matrices meet. Ranges of one
+    // matrix whose rows interleave count as overlapping even when they share
+    // no element.
+    template<class M1, class M2>
+    BOOST_UBLAS_INLINE
+    bool dense_storage_overlaps (const M1 &m1, const M2 &m2) {
+        const typename M1::value_type *first1, *last1;
+        const typename M2::value_type *first2, *last2;
+        dense_storage_span (m1, first1, last1);
+        dense_storage_span (m2, first2, last2);
+        return first1 != last1 && first2 != last2 && first1 < last2 && first2 < last1;
+    }
+
+}}}}
+
+#endif
@@ -0,0 +1,169 @@
+//
+//  Copyright (c) 2017
+//  uBLAS developers
+//
+//  Distributed under the Boost Software License, Version 1.0. (See
+//  accompanying file LICENSE_1_0.txt or copy at
+//  http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#ifndef _BOOST_UBLAS_GEMM_
+#define _BOOST_UBLAS_GEMM_
+
+#include <algorithm>
+#include <cstddef>
+
+#include <boost/numeric/ublas/detail/config.hpp>
+#include <boost/numeric/ublas/detail/workspace.hpp>
+#include <boost/numeric/ublas/detail/simd.hpp>
+
+// Cache blocked dense matrix product C = alpha A B + beta C.
+//
+// The operands are described by a pointer and a row and column stride, so
+// row major, column major and transposed storage all go through the same code.
+// Following the GotoBLAS scheme, KC x NC panels of B and MC x KC panels of A
+// are packed into contiguous workspace (B in slivers of NR columns, A in
+// slivers of MR rows) and an MR x NR register tile of C is updated by the
+// micro kernel for every pair of slivers.
+
+namespace boost { namespace numeric { namespace ublas { namespace detail {
+
+    struct gemm_blocking {
+        static const std::size_t mc = BOOST_UBLAS_GEMM_MC;
+        static const std::size_t kc = BOOST_UBLAS_GEMM_KC;
+        static const std::size_t nc = BOOST_UBLAS_GEMM_NC;
+        static const std::size_t mr = BOOST_UBLAS_GEMM_MR;
+        static const std::size_t nr = BOOST_UBLAS_GEMM_NR;
+
+        BOOST_STATIC_ASSERT (mc % mr == 0 && nc % nr == 0);
+    };
+
+    // Pack an mc x kc block of A into slivers of MR rows, zero padded
+    template<class T>
+    BOOST_UBLAS_INLINE
+    void gemm_pack_a (std::size_t mc, std::size_t kc,
+                      const T *a, std::ptrdiff_t a1, std::ptrdiff_t a2, T *ap) {
+        const std::size_t mr = gemm_blocking::mr;
+        for (std::size_t i = 0; i < mc; i += mr) {
+            const std::size_t rows = (std::min) (mr, mc - i);
+            const T *ai = a + std::ptrdiff_t (i) * a1;
+            for (std::size_t p = 0; p < kc; ++ p, ap += mr) {
+                const T *aip = ai + std::ptrdiff_t (p) * a2;
+                std::size_t r = 0;
+                for (; r < rows; ++ r)
+                    ap [r] = aip [std::ptrdiff_t (r) * a1];
+                for (; r < mr; ++ r)
+                    ap [r] = T ();
+            }
+        }
+    }
+
+    // Pack a kc x nc block of B into slivers of NR columns, zero padded
+    template<class T>
+    BOOST_UBLAS_INLINE
+    void gemm_pack_b (std::size_t kc, std::size_t nc,
+                      const T *b, std::ptrdiff_t b1, std::ptrdiff_t b2, T *bp) {
+        const std::size_t nr = gemm_blocking::nr;
+        for (std::size_t j = 0; j < nc; j += nr) {
+            const std::size_t cols = (std::min) (nr, nc - j);
+            const T *bj = b + std::ptrdiff_t (j) * b2;
+            for (std::size_t p = 0; p < kc; ++ p, bp += nr) {
+                const T *bpj = bj + std::ptrdiff_t (p) * b1;
+                std::size_t c = 0;
+                for (; c < cols; ++ c)
+                    bp [c] = bpj [std::ptrdiff_t (c) * b2];
+                for (; c < nr; ++ c)
+                    bp [c] = T ();
+            }
+        }
+    }
+
+    // C (rows x cols) = beta C + alpha Ap Bp for one MR x NR tile
+    template<class T>
+    BOOST_UBLAS_INLINE
+    void gemm_micro_kernel (std::size_t kc, const T &alpha, const T *ap, const T *bp,
+                            const T &beta, T *c, std::ptrdiff_t c1, std::ptrdiff_t c2,
+                            std::size_t rows, std::size_t cols) {
+        const std::size_t mr = gemm_blocking::mr;
+        const std::size_t nr = gemm_blocking::nr;
+        T ab [mr * nr];
+        if (! simd_gemm_tile<gemm_blocking::mr, gemm_blocking::nr> (kc, ap, bp, ab)) {
+            for (std::size_t i = 0; i < mr * nr; ++ i)
+                ab [i] = T ();
+            for (std::size_t p = 0; p < kc; ++ p, ap += mr, bp += nr)
+                for (std::size_t i = 0; i < mr; ++ i) {
+                    const T ai = ap [i];
+                    for (std::size_t j = 0; j < nr; ++ j)
+                        ab [i * nr + j] += ai * bp [j];
+                }
+        }
+        if (beta == T ()) {
+            for (std::size_t i = 0; i < rows; ++ i)
+                for (std::size_t j = 0; j < cols; ++ j)
+                    c [std::ptrdiff_t (i) * c1 + std::ptrdiff_t (j) * c2] = alpha * ab [i * nr + j];
+        } else {
+            for (std::size_t i = 0; i < rows; ++ i)
+                for (std::size_t j = 0; j < cols; ++ j) {
+                    T &cij = c [std::ptrdiff_t (i) * c1 + std::ptrdiff_t (j) * c2];
+                    cij = beta * cij + alpha * ab [i * nr + j];
+                }
+        }
+    }
+
+    // C (m x n) = beta C + alpha A (m x k) B (k x n). As in BLAS, C is not
+    // read when beta is zero.
+    template<class T>
+    void gemm (std::size_t m, std::size_t n, std::size_t k, const T &alpha,
+               const T *a, std::ptrdiff_t a1, std::ptrdiff_t a2,
+               const T *b, std::ptrdiff_t b1, std::ptrdiff_t b2,
+               const T &beta, T *c, std::ptrdiff_t c1, std::ptrdiff_t c2) {
+        const std::size_t mr = gemm_blocking::mr;
+        const std::size_t nr = gemm_blocking::nr;
+        const std::size_t mc_block = gemm_blocking::mc;
+        const std::size_t kc_block = gemm_blocking::kc;
+        const std::size_t nc_block = gemm_blocking::nc;
+        if (m == 0 || n == 0)
+            return;
+        if (k == 0 || alpha == T ()) {
+            for (std::size_t i = 0; i < m; ++ i)
+                for (std::size_t j = 0; j < n; ++ j) {
+                    T &cij = c [std::ptrdiff_t (i) * c1 + std::ptrdiff_t (j) * c2];
+                    cij = beta == T () ? T () : beta * cij;
+                }
+            return;
+        }
+
+        const std::size_t mc_max = (std::min) (mc_block, (m + mr - 1) / mr * mr);
+        const std::size_t kc_max = (std::min) (kc_block, k);
+        const std::size_t nc_max = (std::min) (nc_block, (n + nr - 1) / nr * nr);
+        workspace<T> ws (mc_max * kc_max + kc_max * nc_max);
+        T *ap = ws.data ();
+        T *bp = ap + mc_max * kc_max;
+
+        for (std::size_t jc = 0; jc < n; jc += nc_block) {
+            const std::size_t nc = (std::min) (nc_block, n - jc);
+            for (std::size_t pc = 0; pc < k; pc += kc_block) {
+                const std::size_t kc = (std::min) (kc_block, k - pc);
+                // Only the first pass over k scales C by beta
+                const T beta_pc = pc == 0 ? beta : T (1);
+                gemm_pack_b (kc, nc, b + std::ptrdiff_t (pc) * b1 + std::ptrdiff_t (jc) * b2, b1, b2, bp);
+                for (std::size_t ic = 0; ic < m; ic += mc_block) {
+                    const std::size_t mc = (std::min) (mc_block, m - ic);
+                    gemm_pack_a (mc, kc, a + std::ptrdiff_t (ic) * a1 + std::ptrdiff_t (pc) * a2, a1, a2, ap);
+                    for (std::size_t jr = 0; jr < nc; jr += nr) {
+                        const std::size_t cols = (std::min) (nr, nc - jr);
+                        for (std::size_t ir = 0; ir < mc; ir += mr) {
+                            const std::size_t rows = (std::min) (mr, mc - ir);
+                            T *cij = c + std::ptrdiff_t (ic + ir) * c1 + std::ptrdiff_t (jc + jr) * c2;
+                            gemm_micro_kernel (kc, alpha, ap + ir * kc, bp + jr * kc,
+                                               beta_pc, cij, c1, c2, rows, cols);
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+}}}}
+
+#endif
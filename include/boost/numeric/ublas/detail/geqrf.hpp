@@ -0,0 +1,326 @@
+//
+//  Copyright (c) 2017
+//  uBLAS developers
+//
+//  Distributed under the Boost Software License, Version 1.0. (See
+//  accompanying file LICENSE_1_0.txt or copy at
+//  http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#ifndef _BOOST_UBLAS_GEQRF_
+#define _BOOST_UBLAS_GEQRF_
+
+#include <algorithm>
+#include <cstddef>
+#include <vector>
+
+#include <boost/numeric/ublas/detail/config.hpp>
+#include <boost/numeric/ublas/detail/gemm.hpp>
+#include <boost/numeric/ublas/detail/thread_pool.hpp>
+#include <boost/numeric/ublas/detail/workspace.hpp>
+#include <boost/numeric/ublas/traits.hpp>
+
+// Blocked Householder QR factorization on strided dense storage, as LAPACK's
+// geqrf, and its tall and skinny variant TSQR.
+//
+// A = Q R with Q = H (0) H (1) ... H (k - 1), H (j) = I - tau (j) v (j) v (j)^H.
+// R overwrites the upper triangle of A and the vectors v (j), whose leading
+// one is implicit, the part below the diagonal. A panel of
+// BOOST_UBLAS_FACTORIZE_BLOCK reflectors is computed one column at a time,
+// then applied to the rest of the matrix in the compact WY form
+// I - V T V^H, that is two gemm calls. The columns right of the panel are
+// independent of each other and are updated in parallel.
+
+namespace boost { namespace numeric { namespace ublas { namespace detail {
+
+    // Reflector H with H^H (alpha, x) = (beta, 0), beta real, as LAPACK's
+    // larfg: alpha is replaced by beta, x by v without its leading one, and
+    // tau is returned. tau is zero when there is nothing to annihilate.
+    template<class T>
+    T householder (std::size_t n, T &alpha, T *x, std::ptrdiff_t incx) {
+        typedef typename type_traits<T>::real_type real_type;
+        // Scaled, so that the squares neither overflow nor underflow
+        real_type scale = real_type ();
+        for (std::size_t i = 0; i < n; ++ i)
+            scale = (std::max) (scale, type_traits<T>::type_abs (x [std::ptrdiff_t (i) * incx]));
+        real_type sum = real_type ();
+        if (scale != real_type ()) {
+            for (std::size_t i = 0; i < n; ++ i) {
+                const real_type t = type_traits<T>::type_abs (x [std::ptrdiff_t (i) * incx]) / scale;
+                sum += t * t;
+            }
+        }
+        if (scale == real_type () && type_traits<T>::imag (alpha) == real_type ())
+            return T ();
+        const real_type alpha_abs = type_traits<T>::type_abs (alpha);
+        const real_type big = (std::max) (scale, alpha_abs);
+        const real_type a = alpha_abs / big, s = scale / big;
+        real_type beta = big * type_traits<real_type>::type_sqrt (a * a + s * s * sum);
+        if (type_traits<T>::real (alpha) >= real_type ())
+            beta = - beta;
+        const T tau = (T (beta) - alpha) / T (beta);
+        const T inv = T (1) / (alpha - T (beta));
+        for (std::size_t i = 0; i < n; ++ i)
+            x [std::ptrdiff_t (i) * incx] *= inv;
+        alpha = T (beta);
+        return tau;
+    }
+
+    // Unblocked factorization of columns [j0, j1) over rows [j0, m), the
+    // reflectors are only applied within the panel
+    template<class T>
+    void geqrf_panel (std::size_t m, std::size_t j0, std::size_t j1,
+                      T *a, std::ptrdiff_t a1, std::ptrdiff_t a2, T *tau) {
+        for (std::size_t j = j0; j < j1; ++ j) {
+            T *v = a + std::ptrdiff_t (j) * (a1 + a2);
+            tau [j] = householder (m - j - 1, *v, v + a1, a1);
+            const T ctau = type_traits<T>::conj (tau [j]);
+            if (ctau == T ())
+                continue;
+            for (std::size_t c = j + 1; c < j1; ++ c) {
+                T *col = a + std::ptrdiff_t (j) * a1 + std::ptrdiff_t (c) * a2;
+                T w = col [0];
+                for (std::size_t i = 1; i < m - j; ++ i)
+                    w += type_traits<T>::conj (v [std::ptrdiff_t (i) * a1]) * col [std::ptrdiff_t (i) * a1];
+                w *= ctau;
+                col [0] -= w;
+                for (std::size_t i = 1; i < m - j; ++ i)
+                    col [std::ptrdiff_t (i) * a1] -= v [std::ptrdiff_t (i) * a1] * w;
+            }
+        }
+    }
+
+    // Applies H (j0)^H ... H (j1 - 1)^H one at a time to columns [0, k) of the
+    // rows [j0, m) of B; the cheaper way for few columns
+    template<class T>
+    void geqrf_apply_reflectors (std::size_t m, std::size_t j0, std::size_t j1,
+                                 const T *a, std::ptrdiff_t a1, std::ptrdiff_t a2, const T *tau,
+                                 std::size_t k, T *b, std::ptrdiff_t b1, std::ptrdiff_t b2) {
+        for (std::size_t j = j0; j < j1; ++ j) {
+            const T *v = a + std::ptrdiff_t (j) * (a1 + a2);
+            const T ctau = type_traits<T>::conj (tau [j]);
+            if (ctau == T ())
+                continue;
+            for (std::size_t c = 0; c < k; ++ c) {
+                T *col = b + std::ptrdiff_t (j) * b1 + std::ptrdiff_t (c) * b2;
+                T w = col [0];
+                for (std::size_t i = 1; i < m - j; ++ i)
+                    w += type_traits<T>::conj (v [std::ptrdiff_t (i) * a1]) * col [std::ptrdiff_t (i) * b1];
+                w *= ctau;
+                col [0] -= w;
+                for (std::size_t i = 1; i < m - j; ++ i)
+                    col [std::ptrdiff_t (i) * b1] -= v [std::ptrdiff_t (i) * a1] * w;
+            }
+        }
+    }
+
+    // Compact WY form of the reflectors [j0, j1): V with its unit diagonal,
+    // rows x w and row major, V^H, w x rows and row major, and the upper
+    // triangular T, w x w, with H (j0) ... H (j1 - 1) = I - V T V^H. As
+    // LAPACK's larft.
+    template<class T>
+    void geqrf_wy (std::size_t m, std::size_t j0, std::size_t j1,
+                   const T *a, std::ptrdiff_t a1, std::ptrdiff_t a2, const T *tau,
+                   T *v, T *vh, T *t) {
+        const std::size_t rows = m - j0, w = j1 - j0;
+        for (std::size_t r = 0; r < rows; ++ r)
+            for (std::size_t c = 0; c < w; ++ c) {
+                const T e = r == c ? T (1) : r > c ? a [std::ptrdiff_t (j0 + r) * a1 + std::ptrdiff_t (j0 + c) * a2] : T ();
+                v [r * w + c] = e;
+                vh [c * rows + r] = type_traits<T>::conj (e);
+            }
+        // T (0:i, i) = - tau (i) T (0:i, 0:i) V (:, 0:i)^H v (i)
+        workspace<T> gram (w * w);
+        T *g = gram.data ();
+        gemm (w, w, rows, T (1), vh, std::ptrdiff_t (rows), 1, v, std::ptrdiff_t (w), 1, T (), g, std::ptrdiff_t (w), 1);
+        for (std::size_t i = 0; i < w; ++ i) {
+            const T ti = tau [j0 + i];
+            for (std::size_t r = 0; r < i; ++ r) {
+                T s = T ();
+                for (std::size_t k = r; k < i; ++ k)
+                    s += t [r * w + k] * g [k * w + i];
+                t [r * w + i] = - ti * s;
+            }
+            t [i * w + i] = ti;
+            for (std::size_t r = i + 1; r < w; ++ r)
+                t [r * w + i] = T ();
+        }
+    }
+
+    // Columns [first, last) of C, rows x n at c: C = (I - V T V^H)^H C
+    template<class T>
+    struct geqrf_update {
+        std::size_t rows, w;
+        const T *v, *vh, *t;
+        T *c;
+        std::ptrdiff_t c1, c2;
+
+        void operator () (std::size_t first, std::size_t last) const {
+            const std::size_t block = BOOST_UBLAS_FACTORIZE_BLOCK;
+            workspace<T> product (w * (std::min) (block, last - first));
+            for (std::size_t j0 = first; j0 < last; j0 += block) {
+                const std::size_t cols = (std::min) (j0 + block, last) - j0;
+                T *cj = c + std::ptrdiff_t (j0) * c2;
+                T *p = product.data ();
+                // P = V^H C, then P = T^H P bottom up, then C -= V P
+                gemm (w, cols, rows, T (1), vh, std::ptrdiff_t (rows), 1, cj, c1, c2,
+                      T (), p, std::ptrdiff_t (cols), 1);
+                for (std::size_t r = w; r -- > 0;) {
+                    for (std::size_t j = 0; j < cols; ++ j) {
+                        T s = T ();
+                        for (std::size_t k = 0; k <= r; ++ k)
+                            s += type_traits<T>::conj (t [k * w + r]) * p [k * cols + j];
+                        p [r * cols + j] = s;
+                    }
+                }
+                gemm (rows, cols, w, T (-1), v, std::ptrdiff_t (w), 1, p, std::ptrdiff_t (cols), 1,
+                      T (1), cj, c1, c2);
+            }
+        }
+    };
+
+    // Applies the block reflector of [j0, j1) to columns [first, last) of the
+    // rows [j0, m) of C, in parallel when it pays
+    template<class T>
+    void geqrf_apply_block (std::size_t m, std::size_t j0, std::size_t j1,
+                            const T *a, std::ptrdiff_t a1, std::ptrdiff_t a2, const T *tau,
+                            std::size_t first, std::size_t last, T *c, std::ptrdiff_t c1, std::ptrdiff_t c2) {
+        const std::size_t block = BOOST_UBLAS_FACTORIZE_BLOCK;
+        const std::size_t rows = m - j0, w = j1 - j0;
+        workspace<T> v (rows * w), vh (w * rows), t (w * w);
+        geqrf_wy (m, j0, j1, a, a1, a2, tau, v.data (), vh.data (), t.data ());
+        geqrf_update<T> update = { rows, w, v.data (), vh.data (), t.data (),
+                                   c + std::ptrdiff_t (j0) * c1, c1, c2 };
+        thread_pool &pool = thread_pool::instance ();
+        const double cost = 2 * double (rows) * double (last - first) * double (w);
+        if (pool.size () > 1 && cost >= double (BOOST_UBLAS_FACTORIZE_PARALLEL_COST))
+            pool.parallel_for (first, last, block, update);
+        else
+            update (first, last);
+    }
+
+    // A = Q R for the m x n matrix at a, tau receives the min (m, n) scalars
+    // of the reflectors
+    template<class T>
+    void geqrf (std::size_t m, std::size_t n, T *a, std::ptrdiff_t a1, std::ptrdiff_t a2, T *tau) {
+        const std::size_t block = BOOST_UBLAS_FACTORIZE_BLOCK;
+        const std::size_t size = (std::min) (m, n);
+        for (std::size_t j0 = 0; j0 < size; j0 += block) {
+            const std::size_t j1 = (std::min) (j0 + block, size);
+            geqrf_panel (m, j0, j1, a, a1, a2, tau);
+            if (j1 < n)
+                geqrf_apply_block (m, j0, j1, a, a1, a2, tau, j1, n, a, a1, a2);
+        }
+    }
+
+    // B = Q^H B for the k columns of the m x k matrix at b, Q from geqrf of
+    // the m x n matrix at a
+    template<class T>
+    void geqrf_apply (std::size_t m, std::size_t n, const T *a, std::ptrdiff_t a1, std::ptrdiff_t a2, const T *tau,
+                      std::size_t k, T *b, std::ptrdiff_t b1, std::ptrdiff_t b2) {
+        const std::size_t block = BOOST_UBLAS_FACTORIZE_BLOCK;
+        const std::size_t size = (std::min) (m, n);
+        for (std::size_t j0 = 0; j0 < size; j0 += block) {
+            const std::size_t j1 = (std::min) (j0 + block, size);
+            if (k < j1 - j0)
+                geqrf_apply_reflectors (m, j0, j1, a, a1, a2, tau, k, b, b1, b2);
+            else
+                geqrf_apply_block (m, j0, j1, a, a1, a2, tau, 0, k, b, b1, b2);
+        }
+    }
+
+    // Tall and skinny QR. The rows are split into blocks of at least n rows
+    // that are factored independently and in parallel; their R factors,
+    // stacked, are factored once more. Q is kept as that tree of reflectors.
+    template<class T>
+    class tsqr {
+    public:
+        // Factors the m x n matrix at a, m >= n, in place over parts row blocks
+        tsqr (std::size_t m, std::size_t n, T *a, std::ptrdiff_t a1, std::ptrdiff_t a2, std::size_t parts):
+            m_ (m), n_ (n), parts_ ((std::max) (std::size_t (1), (std::min) (parts, m / (std::max) (n, std::size_t (1))))),
+            a_ (a), a1_ (a1), a2_ (a2),
+            tau_ (parts_ * n), stacked_ (parts_ * n * n), stacked_tau_ (n) {
+            factor_blocks functor = { this };
+            run (functor);
+            // Upper triangles of the block factors, one below the other
+            for (std::size_t p = 0; p < parts_; ++ p)
+                for (std::size_t i = 0; i < n_; ++ i)
+                    for (std::size_t j = 0; j < n_; ++ j)
+                        stacked_ [(p * n_ + i) * n_ + j] = j >= i ? a_ [std::ptrdiff_t (first_row (p) + i) * a1_ + std::ptrdiff_t (j) * a2_] : T ();
+            geqrf (parts_ * n_, n_, stacked_.data (), std::ptrdiff_t (n_), 1, stacked_tau_.data ());
+        }
+
+        // R, n x n upper triangular and row major
+        const T *r () const {
+            return stacked_.data ();
+        }
+
+        // The first n rows of Q^H B for the m x k matrix at b, into x, n x k
+        // and row major
+        void apply (std::size_t k, T *b, std::ptrdiff_t b1, std::ptrdiff_t b2, T *x) const {
+            apply_blocks functor = { this, k, b, b1, b2 };
+            run (functor);
+            std::vector<T> top (parts_ * n_ * k);
+            for (std::size_t p = 0; p < parts_; ++ p)
+                for (std::size_t i = 0; i < n_; ++ i)
+                    for (std::size_t c = 0; c < k; ++ c)
+                        top [(p * n_ + i) * k + c] = b [std::ptrdiff_t (first_row (p) + i) * b1 + std::ptrdiff_t (c) * b2];
+            geqrf_apply (parts_ * n_, n_, stacked_.data (), std::ptrdiff_t (n_), 1, stacked_tau_.data (),
+                         k, top.data (), std::ptrdiff_t (k), 1);
+            std::copy (top.begin (), top.begin () + n_ * k, x);
+        }
+
+    private:
+        std::size_t first_row (std::size_t p) const {
+            return m_ / parts_ * p;
+        }
+        std::size_t last_row (std::size_t p) const {
+            return p + 1 == parts_ ? m_ : m_ / parts_ * (p + 1);
+        }
+
+        struct factor_blocks {
+            tsqr *self;
+            void operator () (std::size_t p) const {
+                const std::size_t r0 = self->first_row (p);
+                geqrf (self->last_row (p) - r0, self->n_, self->a_ + std::ptrdiff_t (r0) * self->a1_,
+                       self->a1_, self->a2_, self->tau_.data () + p * self->n_);
+            }
+        };
+        struct apply_blocks {
+            const tsqr *self;
+            std::size_t k;
+            T *b;
+            std::ptrdiff_t b1, b2;
+            void operator () (std::size_t p) const {
+                const std::size_t r0 = self->first_row (p);
+                geqrf_apply (self->last_row (p) - r0, self->n_, self->a_ + std::ptrdiff_t (r0) * self->a1_,
+                             self->a1_, self->a2_, self->tau_.data () + p * self->n_,
+                             k, b + std::ptrdiff_t (r0) * b1, b1, b2);
+            }
+        };
+        // One block per task, the pool balances them
+        template<class F>
+        struct each_block {
+            F f;
+            void operator () (std::size_t first, std::size_t last) const {
+                for (std::size_t p = first; p < last; ++ p)
+                    f (p);
+            }
+        };
+        template<class F>
+        void run (const F &f) const {
+            each_block<F> blocks = { f };
+            thread_pool::instance ().parallel_for (0, parts_, 1, blocks);
+        }
+
+        std::size_t m_, n_, parts_;
+        T *a_;
+        std::ptrdiff_t a1_, a2_;
+        std::vector<T> tau_;
+        std::vector<T> stacked_;
+        std::vector<T> stacked_tau_;
+    };
+
+}}}}
+
+#endif
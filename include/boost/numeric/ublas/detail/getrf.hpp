@@ -0,0 +1,127 @@
+//
+//  Copyright (c) 2017
+//  uBLAS developers
+//
+//  Distributed under the Boost Software License, Version 1.0. (See
+//  accompanying file LICENSE_1_0.txt or copy at
+//  http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#ifndef _BOOST_UBLAS_GETRF_
+#define _BOOST_UBLAS_GETRF_
+
+#include <algorithm>
+#include <cstddef>
+
+#include <boost/numeric/ublas/detail/config.hpp>
+#include <boost/numeric/ublas/detail/gemm.hpp>
+#include <boost/numeric/ublas/detail/thread_pool.hpp>
+#include <boost/numeric/ublas/traits.hpp>
+
+// Blocked LU factorization with partial pivoting on strided dense storage.
+//
+// The matrix is factored a panel of BOOST_UBLAS_FACTORIZE_BLOCK columns at a
+// time, right looking as in LAPACK's getrf. The panel itself is factored
+// column by column with the same pivot choice, row swaps and rank one updates
+// as the unblocked lu_factorize, so the factors only differ from it by the
+// rounding of the trailing updates, which go through gemm. The columns right
+// of the panel are independent of each other and are updated in parallel.
+
+namespace boost { namespace numeric { namespace ublas { namespace detail {
+
+    // Unblocked factorization of columns [j0, j1) over rows [j0, m). Rows are
+    // swapped across all n columns. singular is set to one past the first zero
+    // pivot, as lu_factorize reports it.
+    template<class T, class PM>
+    void getrf_panel (std::size_t m, std::size_t n, std::size_t j0, std::size_t j1,
+                      T *a, std::ptrdiff_t a1, std::ptrdiff_t a2, PM &pm, std::size_t &singular) {
+        typedef typename type_traits<T>::real_type real_type;
+        for (std::size_t i = j0; i < j1; ++ i) {
+            T *ai = a + std::ptrdiff_t (i) * a1;
+            T *aci = a + std::ptrdiff_t (i) * a2;
+            // First row of largest norm_inf, as index_norm_inf picks it
+            std::size_t pivot = i;
+            real_type norm = real_type ();
+            for (std::size_t r = i; r < m; ++ r) {
+                const real_type t (type_traits<T>::norm_inf (aci [std::ptrdiff_t (r) * a1]));
+                if (t > norm) {
+                    pivot = r;
+                    norm = t;
+                }
+            }
+            if (aci [std::ptrdiff_t (pivot) * a1] != T ()) {
+                if (pivot != i) {
+                    pm (i) = pivot;
+                    T *ap = a + std::ptrdiff_t (pivot) * a1;
+                    for (std::size_t c = 0; c < n; ++ c)
+                        std::swap (ai [std::ptrdiff_t (c) * a2], ap [std::ptrdiff_t (c) * a2]);
+                } else {
+                    BOOST_UBLAS_CHECK (std::size_t (pm (i)) == pivot, external_logic ());
+                }
+                const T inv = T (1) / ai [std::ptrdiff_t (i) * a2];
+                for (std::size_t r = i + 1; r < m; ++ r)
+                    aci [std::ptrdiff_t (r) * a1] *= inv;
+            } else if (singular == 0) {
+                singular = i + 1;
+            }
+            for (std::size_t r = i + 1; r < m; ++ r) {
+                T *ar = a + std::ptrdiff_t (r) * a1;
+                const T l = ar [std::ptrdiff_t (i) * a2];
+                for (std::size_t c = i + 1; c < j1; ++ c)
+                    ar [std::ptrdiff_t (c) * a2] -= l * ai [std::ptrdiff_t (c) * a2];
+            }
+        }
+    }
+
+    // Columns [first, last) right of the factored panel [j0, j1):
+    // U12 = L11^-1 A12, then A22 -= L21 U12
+    template<class T>
+    struct getrf_update {
+        std::size_t m, j0, j1;
+        T *a;
+        std::ptrdiff_t a1, a2;
+
+        void operator () (std::size_t first, std::size_t last) const {
+            // Row by row, exactly as the unblocked rank one updates reach it
+            for (std::size_t i = j0; i < j1; ++ i) {
+                const T *ai = a + std::ptrdiff_t (i) * a1;
+                for (std::size_t r = i + 1; r < j1; ++ r) {
+                    T *ar = a + std::ptrdiff_t (r) * a1;
+                    const T l = ar [std::ptrdiff_t (i) * a2];
+                    for (std::size_t c = first; c < last; ++ c)
+                        ar [std::ptrdiff_t (c) * a2] -= l * ai [std::ptrdiff_t (c) * a2];
+                }
+            }
+            gemm (m - j1, last - first, j1 - j0, T (-1),
+                  a + std::ptrdiff_t (j1) * a1 + std::ptrdiff_t (j0) * a2, a1, a2,
+                  a + std::ptrdiff_t (j0) * a1 + std::ptrdiff_t (first) * a2, a1, a2,
+                  T (1), a + std::ptrdiff_t (j1) * a1 + std::ptrdiff_t (first) * a2, a1, a2);
+        }
+    };
+
+    // PA = LU for the m x n matrix at a, L unit lower and U upper stored over
+    // A, with pm and the return value as for lu_factorize
+    template<class T, class PM>
+    std::size_t getrf (std::size_t m, std::size_t n, T *a, std::ptrdiff_t a1, std::ptrdiff_t a2, PM &pm) {
+        const std::size_t block = BOOST_UBLAS_FACTORIZE_BLOCK;
+        const std::size_t size = (std::min) (m, n);
+        thread_pool &pool = thread_pool::instance ();
+        std::size_t singular = 0;
+        for (std::size_t j0 = 0; j0 < size; j0 += block) {
+            const std::size_t j1 = (std::min) (j0 + block, size);
+            getrf_panel (m, n, j0, j1, a, a1, a2, pm, singular);
+            if (j1 == n)
+                continue;
+            getrf_update<T> update = { m, j0, j1, a, a1, a2 };
+            const double cost = double (m - j1) * double (n - j1) * double (j1 - j0);
+            if (pool.size () > 1 && cost >= double (BOOST_UBLAS_FACTORIZE_PARALLEL_COST))
+                pool.parallel_for (j1, n, block, update);
+            else
+                update (j1, n);
+        }
+        return singular;
+    }
+
+}}}}
+
+#endif
@@ -13,7 +13,14 @@
 #ifndef _BOOST_UBLAS_MATRIX_ASSIGN_
 #define _BOOST_UBLAS_MATRIX_ASSIGN_
 
+#include <boost/mpl/has_xxx.hpp>
 #include <boost/numeric/ublas/traits.hpp>
+#include <boost/numeric/ublas/matrix_expression.hpp>
+#include <boost/numeric/ublas/detail/dense_traits.hpp>
+#include <boost/numeric/ublas/detail/gemm.hpp>
+#include <boost/numeric/ublas/detail/strassen.hpp>
+#include <boost/numeric/ublas/detail/matrix_chain.hpp>
+#include <boost/numeric/ublas/detail/thread_pool.hpp>
 // Required for make_conformant storage
 #include <vector>
 #include <algorithm>
@@ -577,19 +584,95 @@ namespace detail {
         }
     }
 
-    template<typename E>
-    static BOOST_UBLAS_INLINE
-    auto getSize(const matrix_expression<E> &e) {
-        auto E1 = e().expression1();
-        auto E2 = e().expression2();
-
-        auto Max = std::max(E1.size1(), std::max(E1.size2(), std::max(E2.size1(), E2.size2())));
-        auto Size = 1;
-        while(Size < Max)
-            Size <<= 1;
-        return Size;
+namespace detail {
+
+    template<class M, class E1, class E2>
+    BOOST_UBLAS_INLINE
+    bool gemm_prod (M &, const E1 &, const E2 &,
+                    const typename M::value_type &, const typename M::value_type &,
+                    boost::mpl::false_) {
+        return false;
+    }
+    template<class M, class E1, class E2>
+    BOOST_UBLAS_INLINE
+    bool gemm_prod (M &m, const E1 &e1, const E2 &e2,
+                    const typename M::value_type &alpha, const typename M::value_type &beta,
+                    boost::mpl::true_) {
+        typedef dense_matrix_traits<M> traits;
+        typedef dense_matrix_traits<E1> traits1;
+        typedef dense_matrix_traits<E2> traits2;
+        // The kernel writes C while A and B are still being read, so C must
+        // not share storage with either; ranges of one matrix may overlap
+        // without starting at the same element
+        if (dense_storage_overlaps (m, e1) || dense_storage_overlaps (m, e2))
+            return false;
+        typedef typename M::value_type value_type;
+        const std::size_t size1 (m.size1 ()), size2 (m.size2 ());
+        const std::size_t size (BOOST_UBLAS_SAME (e1.size2 (), e2.size1 ()));
+        // Products large enough for Strassen steps recurse into the same kernel
+        if (strassen_pays<value_type> (size1, size2, size))
+            strassen_gemm (size1, size2, size, alpha,
+                           traits1::data (e1), traits1::stride1 (e1), traits1::stride2 (e1),
+                           traits2::data (e2), traits2::stride1 (e2), traits2::stride2 (e2),
+                           beta, traits::data (m), traits::stride1 (m), traits::stride2 (m));
+        else
+            gemm (size1, size2, size, alpha,
+                  traits1::data (e1), traits1::stride1 (e1), traits1::stride2 (e1),
+                  traits2::data (e2), traits2::stride1 (e2), traits2::stride2 (e2),
+                  beta, traits::data (m), traits::stride1 (m), traits::stride2 (m));
+        return true;
     }
- 
+
+    // m = beta m + alpha e1 e2 through the packed product kernel. Returns
+    // false, without touching m, unless all three matrices expose dense
+    // storage of the same value type.
+    template<class M, class E1, class E2>
+    BOOST_UBLAS_INLINE
+    bool gemm_prod (M &m, const E1 &e1, const E2 &e2,
+                    const typename M::value_type &alpha, const typename M::value_type &beta) {
+        typedef boost::mpl::bool_<dense_matrix_traits<M>::value &&
+                                  dense_matrix_traits<E1>::value &&
+                                  dense_matrix_traits<E2>::value &&
+                                  boost::is_same<typename M::value_type, typename E1::value_type>::value &&
+                                  boost::is_same<typename M::value_type, typename E2::value_type>::value> is_dense;
+        return gemm_prod (m, e1, e2, alpha, beta, is_dense ());
+    }
+
+    // Matrix assignments of expressions with a kernel of their own, such as
+    // the products of block compressed matrices of spmv.hpp, specialise this
+    // on the expression type. apply returns false, without touching m, when
+    // the kernel does not take the assignment.
+    template<class E>
+    struct matrix_assign_kernel {
+        template<template <class T1, class T2> class F, class M>
+        static BOOST_UBLAS_INLINE
+        bool apply (M &, const E &) {
+            return false;
+        }
+    };
+
+    // Matrix product assignment through the packed product kernel
+    template<template <class T1, class T2> class F, class M, class E>
+    BOOST_UBLAS_INLINE
+    bool gemm_assign (M &m, const matrix_expression<E> &e, boost::mpl::false_) {
+        return false;
+    }
+    template<template <class T1, class T2> class F, class M, class E>
+    BOOST_UBLAS_INLINE
+    bool gemm_assign (M &m, const matrix_expression<E> &e, boost::mpl::true_) {
+        typedef typename M::value_type value_type;
+        typedef assign_scale_traits<F> assign_traits;
+        return gemm_prod (m, e ().expression1 (), e ().expression2 (),
+                          value_type (assign_traits::alpha), value_type (assign_traits::beta));
+    }
+    template<template <class T1, class T2> class F, class M, class E>
+    BOOST_UBLAS_INLINE
+    bool gemm_assign (M &m, const matrix_expression<E> &e) {
+        return gemm_assign<F> (m, e, boost::mpl::bool_<assign_scale_traits<F>::value> ());
+    }
+
+}
+
     // Explicitly indexing row major
     template<template <class T1, class T2> class F, class M, class E,
                                         class M1, class M2, class TV>
@@ -601,15 +684,14 @@ namespace detail {
         
         size_type size1 (BOOST_UBLAS_SAME (m.size1 (), e ().size1 ()));
         size_type size2 (BOOST_UBLAS_SAME (m.size2 (), e ().size2 ()));
-        
-        size_type row = e().size1();
-        size_type col = e().size2();
-        size_type Size = getSize(e);
-        
+
+        if (detail::gemm_assign<F> (m, e))
+            return;
+
         type **C;
-        C = new type*[Size];
-        for(int i=0; i<Size; i++) {
-            C[i] = new int[Size]();
+        C = new type*[size1];
+        for(size_type i=0; i<size1; i++) {
+            C[i] = new type[size2];
         }
         e () (C);
 
@@ -623,7 +705,7 @@ namespace detail {
 #endif
         }
         
-        for(int i=0; i<Size; i++) {
+        for(size_type i=0; i<size1; i++) {
             delete [] C[i];
         }
         delete [] C;
@@ -660,13 +742,13 @@ namespace detail {
         size_type size2 (BOOST_UBLAS_SAME (m.size2 (), e ().size2 ()));
         size_type size1 (BOOST_UBLAS_SAME (m.size1 (), e ().size1 ()));
 
-        size_type row = e().size1();
-        size_type col = e().size2();
-        size_type Size = getSize(e);
+        if (detail::gemm_assign<F> (m, e))
+            return;
+
         type **C;
-        C = new type*[Size];
-        for(int i=0; i<Size; i++) {
-            C[i] = new int[Size];
+        C = new type*[size1];
+        for(size_type i=0; i<size1; i++) {
+            C[i] = new type[size2];
         }
         e () (C);
 
@@ -679,7 +761,7 @@ namespace detail {
             DD (size1, 2, r, (functor_type::apply (m (i, j), e () (i, j)), ++ i));
 #endif
         }
-        for(int i=0; i<Size; i++) {
+        for(size_type i=0; i<size1; i++) {
             delete [] C[i];
         }
         delete [] C;
@@ -704,11 +786,27 @@ namespace detail {
         }
     }
 
+namespace detail {
+    BOOST_MPL_HAS_XXX_TRAIT_DEF (functor_type)
+
+    // Functor of an expression; containers and proxies have none
+    struct no_functor {};
+
+    template<class E, bool = has_functor_type<E>::value>
+    struct expression_functor {
+        typedef typename E::functor_type type;
+    };
+    template<class E>
+    struct expression_functor<E, false> {
+        typedef no_functor type;
+    };
+}
+
     // Segrigating matrix product & other operations based on functor type
     template<template <class T1, class T2> class F, class M, class C, class E>
     void indexing_matrix_assign_controller (M &m, const matrix_expression<E> &e, C) {
         typedef C orientation_category;
-        typedef typename E::functor_type functor_type;
+        typedef typename detail::expression_functor<E>::type functor_type;
         indexing_matrix_assign<F>(m, e, orientation_category(), functor_type()); 
     }    
 
@@ -730,7 +828,7 @@ namespace detail {
             size2 >= BOOST_UBLAS_ITERATOR_THRESHOLD)
             iterating_matrix_assign<F> (m, e, orientation_category ());
         else
-            indexing_matrix_assign_controller<F> (m, e, C);
+            indexing_matrix_assign_controller<F> (m, e, orientation_category ());
 #endif
     }
     // Packed (proxy) row major case
@@ -748,8 +846,8 @@ namespace detail {
 #if BOOST_UBLAS_TYPE_CHECK
         typedef typename M::value_type value_type;
         matrix<value_type, row_major> cm (m.size1 (), m.size2 ());
-        indexing_matrix_assign<scalar_assign> (cm, m, row_major_tag ());
-        indexing_matrix_assign<F> (cm, e, row_major_tag ());
+        indexing_matrix_assign_controller<scalar_assign> (cm, m, row_major_tag ());
+        indexing_matrix_assign_controller<F> (cm, e, row_major_tag ());
 #endif
         typename M::iterator1 it1 (m.begin1 ());
         typename M::iterator1 it1_end (m.end1 ());
@@ -912,8 +1010,8 @@ namespace detail {
 #if BOOST_UBLAS_TYPE_CHECK
         typedef typename M::value_type value_type;
         matrix<value_type, column_major> cm (m.size1 (), m.size2 ());
-        indexing_matrix_assign<scalar_assign> (cm, m, column_major_tag ());
-        indexing_matrix_assign<F> (cm, e, column_major_tag ());
+        indexing_matrix_assign_controller<scalar_assign> (cm, m, column_major_tag ());
+        indexing_matrix_assign_controller<F> (cm, e, column_major_tag ());
 #endif
         typename M::iterator2 it2 (m.begin2 ());
         typename M::iterator2 it2_end (m.end2 ());
@@ -1160,8 +1258,8 @@ namespace detail {
 #if BOOST_UBLAS_TYPE_CHECK
         typedef typename M::value_type value_type;
         matrix<value_type, row_major> cm (m.size1 (), m.size2 ());
-        indexing_matrix_assign<scalar_assign> (cm, m, row_major_tag ());
-        indexing_matrix_assign<F> (cm, e, row_major_tag ());
+        indexing_matrix_assign_controller<scalar_assign> (cm, m, row_major_tag ());
+        indexing_matrix_assign_controller<F> (cm, e, row_major_tag ());
 #endif
         detail::make_conformant (m, e, row_major_tag (), conformant_restrict_type ());
 
@@ -1315,8 +1413,8 @@ namespace detail {
 #if BOOST_UBLAS_TYPE_CHECK
         typedef typename M::value_type value_type;
         matrix<value_type, column_major> cm (m.size1 (), m.size2 ());
-        indexing_matrix_assign<scalar_assign> (cm, m, column_major_tag ());
-        indexing_matrix_assign<F> (cm, e, column_major_tag ());
+        indexing_matrix_assign_controller<scalar_assign> (cm, m, column_major_tag ());
+        indexing_matrix_assign_controller<F> (cm, e, column_major_tag ());
 #endif
         detail::make_conformant (m, e, column_major_tag (), conformant_restrict_type ());
 
@@ -1459,6 +1557,8 @@ namespace detail {
     template<template <class T1, class T2> class F, class M, class E>
     BOOST_UBLAS_INLINE
     void matrix_assign (M &m, const matrix_expression<E> &e) {
+        if (detail::matrix_assign_kernel<E>::template apply<F> (m, e ()))
+            return;
         typedef typename matrix_assign_traits<typename M::storage_category,
                                               F<typename M::reference, typename E::value_type>::computed,
                                               typename E::const_iterator1::iterator_category,
@@ -1486,6 +1586,121 @@ namespace detail {
         matrix_assign<F, conformant_restrict_type> (m, e, storage_category (), orientation_category ());
     }
 
+namespace detail {
+
+    // Assigns the rows (row major) or columns (column major) [first, last)
+    // on one thread of the pool
+    template<template <class T1, class T2> class F, class M, class E, class C>
+    class matrix_assign_range {
+    public:
+        typedef typename M::size_type size_type;
+
+        BOOST_UBLAS_INLINE
+        matrix_assign_range (M &m, const E &e):
+            m_ (&m), e_ (&e) {}
+
+        BOOST_UBLAS_INLINE
+        void operator () (size_type first, size_type last) const {
+            apply (first, last, C ());
+        }
+
+    private:
+        typedef F<typename M::reference, typename E::value_type> functor_type;
+
+        BOOST_UBLAS_INLINE
+        void apply (size_type first, size_type last, row_major_tag) const {
+            const size_type size2 = m_->size2 ();
+            for (size_type i = first; i < last; ++ i)
+                for (size_type j = 0; j < size2; ++ j)
+                    functor_type::apply ((*m_) (i, j), (*e_) (i, j));
+        }
+        BOOST_UBLAS_INLINE
+        void apply (size_type first, size_type last, column_major_tag) const {
+            const size_type size1 = m_->size1 ();
+            for (size_type j = first; j < last; ++ j)
+                for (size_type i = 0; i < size1; ++ i)
+                    functor_type::apply ((*m_) (i, j), (*e_) (i, j));
+        }
+
+        M *m_;
+        const E *e_;
+    };
+
+    // Matrix products have their own kernel (see gemm_assign), which splitting
+    // the result into element wise ranges would bypass
+    template<class E>
+    struct is_matrix_prod_expression:
+        boost::mpl::false_ {};
+    template<class E1, class E2, class M1, class M2, class TV>
+    struct is_matrix_prod_expression<matrix_matrix_binary<E1, E2, matrix_matrix_prod<M1, M2, TV> > >:
+        boost::mpl::true_ {};
+
+}
+
+    // Multithreaded dense (proxy) case. The rows or columns, following the
+    // orientation of m, are split across detail::thread_pool; m must have
+    // dense storage and must not alias e.
+    template<template <class T1, class T2> class F, class M, class E>
+    // BOOST_UBLAS_INLINE This function seems to be big. So we do not let the compiler inline it.
+    void matrix_assign (M &m, const matrix_expression<E> &e, parallel_tag) {
+        typedef typename M::size_type size_type;
+        typedef typename boost::mpl::if_<boost::is_same<typename M::orientation_category, unknown_orientation_tag>,
+                                          typename E::orientation_category ,
+                                          typename M::orientation_category >::type orientation_category;
+        size_type size1 (BOOST_UBLAS_SAME (m.size1 (), e ().size1 ()));
+        size_type size2 (BOOST_UBLAS_SAME (m.size2 (), e ().size2 ()));
+        size_type outer = boost::is_same<orientation_category, column_major_tag>::value ? size2 : size1;
+        detail::thread_pool::instance ().parallel_for (0, outer, 1,
+            detail::matrix_assign_range<F, M, E, orientation_category> (m, e ()));
+    }
+
+namespace detail {
+
+    template<>
+    struct parallel_assigner<matrix_tag> {
+        // Dense element wise assignments large enough to be worth the threads
+        template<template <class T1, class T2> class F, class M, class E>
+        static BOOST_UBLAS_INLINE
+        bool use_threads (const M &m, const matrix_expression<E> &e) {
+            typedef typename matrix_assign_traits<typename M::storage_category,
+                                                  F<typename M::reference, typename E::value_type>::computed,
+                                                  typename E::const_iterator1::iterator_category,
+                                                  typename E::const_iterator2::iterator_category>::storage_category storage_category;
+            return boost::is_convertible<storage_category, dense_proxy_tag>::value &&
+                   ! is_matrix_prod_expression<E>::value &&
+                   thread_pool::instance ().size () > 1 &&
+                   BOOST_UBLAS_SAME (m.size1 (), e ().size1 ()) *
+                   BOOST_UBLAS_SAME (m.size2 (), e ().size2 ()) >= std::size_t (BOOST_UBLAS_PARALLEL_THRESHOLD);
+        }
+
+        template<template <class T1, class T2> class F, class M, class E>
+        static BOOST_UBLAS_INLINE
+        bool apply (M &m, const matrix_expression<E> &e) {
+            if (! use_threads<F> (m, e))
+                return false;
+            matrix_assign<F> (m, e, parallel_tag ());
+            return true;
+        }
+
+        template<class M, class E>
+        static BOOST_UBLAS_INLINE
+        bool assign (M &m, const E &e) {
+            return apply<scalar_assign> (m, e);
+        }
+        template<class M, class E>
+        static BOOST_UBLAS_INLINE
+        bool plus_assign (M &m, const E &e) {
+            return apply<scalar_plus_assign> (m, e);
+        }
+        template<class M, class E>
+        static BOOST_UBLAS_INLINE
+        bool minus_assign (M &m, const E &e) {
+            return apply<scalar_minus_assign> (m, e);
+        }
+    };
+
+}
+
     template<class E1, class E2>
     BOOST_UBLAS_INLINE
     void matrix_data_assign (E1 &m, E2 &temporary) {
@@ -1496,58 +1711,122 @@ namespace detail {
         } 
     }
 
-    template<class M, class E>
-    BOOST_UBLAS_INLINE
-    void chain_matrix_assign(M &m, const E &O) {
-        // Take into consideration Orientation Category
-        // AND storage category.
-        typedef typename boost::mpl::if_<boost::is_same<typename M::orientation_category, unknown_orientation_tag>,
-                                          typename E::orientation_category ,
-                                          typename M::orientation_category >::type orientation_category;
-        chain_matrix_assign(m, O, orientation_category());
-    } 
+namespace detail {
 
-    template<class M, class E>
-    BOOST_UBLAS_INLINE
-    void chain_matrix_assign(M &m, const E &O, row_major_tag) {
+    // How an assignment functor combines a chain product p with m:
+    // accumulate gives m + p, negate -p
+    template<class F>
+    struct chain_assign_mode;
+    template<class T1, class T2>
+    struct chain_assign_mode<scalar_assign<T1, T2> > {
+        static const bool accumulate = false;
+        static const bool negate = false;
+    };
+    template<class T1, class T2>
+    struct chain_assign_mode<scalar_plus_assign<T1, T2> > {
+        static const bool accumulate = true;
+        static const bool negate = false;
+    };
+    template<class T1, class T2>
+    struct chain_assign_mode<scalar_minus_assign<T1, T2> > {
+        static const bool accumulate = true;
+        static const bool negate = true;
+    };
+
+    // Dense targets receive the product in their own storage, unless they
+    // hold one of the operands
+    template<class M, class T>
+    void chain_product_assign (M &m, const chain_operands<T> &operands, const chain_evaluator<T> &evaluator,
+                               const T &alpha, const T &beta, boost::mpl::true_) {
+        typedef dense_matrix_traits<M> traits;
+        if (m.size1 () == 0 || m.size2 () == 0)
+            return;
+        T *c = traits::data (m);
+        const std::ptrdiff_t c1 = traits::stride1 (m), c2 = traits::stride2 (m);
+        const T *c_last = c + std::ptrdiff_t (m.size1 () - 1) * c1 + std::ptrdiff_t (m.size2 () - 1) * c2 + 1;
+        if (! operands.overlaps (c, c_last))
+            evaluator.evaluate (c, c1, c2, alpha, beta);
+        else
+            chain_product_assign (m, operands, evaluator, alpha, beta, boost::mpl::false_ ());
+    }
+    // Everything else goes through a buffer
+    template<class M, class T>
+    void chain_product_assign (M &m, const chain_operands<T> &, const chain_evaluator<T> &evaluator,
+                               const T &alpha, const T &beta, boost::mpl::false_) {
         typedef typename M::size_type size_type;
-        typedef typename M::value_type value_type;
-        
-        //std::vector<std::vector<value_type> > C;
-        value_type **C;
-        size_type size1_ = O.size1(), size2_ = O.size2();
-
-        O(C);
-        for(size_type i=0; i<m.size1(); i++) {
-            for(size_type j=0; j<m.size2(); j++) {
-                m(i,j) = C[i][j];
+        const size_type size1 = m.size1 (), size2 = m.size2 ();
+        workspace<T> result (size1 * size2);
+        evaluator.evaluate (result.data (), std::ptrdiff_t (size2), 1);
+        for (size_type i = 0; i < size1; ++ i)
+            for (size_type j = 0; j < size2; ++ j) {
+                const T &r = result.data () [i * size2 + j];
+                if (beta == T ())
+                    m (i, j) = alpha * r;
+                else if (r != T ())
+                    m (i, j) += alpha * r;
             }
-        }
-        for(size_type i=0; i<size1_;i++) {
-            delete [] C[i];
-        }
-        delete [] C;
     }
 
+    // Sums of chains nest in any order
+    template<class M, class E1, class E2>
+    void chain_assign (M &m, const binop<E1, E2, addOp> &o, bool accumulate, bool negate);
+    template<class M, class E1, class E2>
+    void chain_assign (M &m, const binop<E1, E2, subOp> &o, bool accumulate, bool negate);
+
+    // Terms of a sum that are not products
     template<class M, class E>
-    BOOST_UBLAS_INLINE
-    void chain_matrix_assign(M &m, const E &O, column_major_tag) {
-        typedef typename M::size_type size_type;
+    void chain_assign (M &m, const matrix_expression<E> &e, bool accumulate, bool negate) {
+        if (accumulate && negate)
+            matrix_assign<scalar_minus_assign> (m, e);
+        else if (accumulate)
+            matrix_assign<scalar_plus_assign> (m, e);
+        else if (negate)
+            matrix_assign<scalar_assign> (m, - e);
+        else
+            matrix_assign<scalar_assign> (m, e);
+    }
+
+    // m = beta m + alpha A0 ... An-1 where beta is 0 or 1 and alpha is 1 or -1
+    template<class M, class E1, class E2>
+    void chain_assign (M &m, const binop<E1, E2, multOp> &o, bool accumulate, bool negate) {
         typedef typename M::value_type value_type;
-        
-        std::vector<std::vector<value_type> > C;
-        O(C);
-        
-        for(size_type j=0; j<m.size2(); j++) {
-            for(size_type i=0; i<m.size1(); i++) {
-                m(i,j) = C[i][j];
-            }
-        }
+        chain_operands<value_type> operands;
+        binop<E1, E2, multOp>::getOperands (o, operands);
+        chain_plan_cache::plan_pointer plan = chain_plan_cache::instance ().find (operands.dimensions (), operands.levels ());
+        BOOST_UBLAS_CHECK (m.size1 () == plan->rows (0), bad_size ());
+        BOOST_UBLAS_CHECK (m.size2 () == plan->columns (plan->size () - 1), bad_size ());
+        const value_type alpha = negate ? - value_type (1) : value_type (1);
+        const value_type beta = accumulate ? value_type (1) : value_type ();
+        chain_evaluator<value_type> evaluator (*plan, operands.operands (), true);
+        chain_product_assign (m, operands, evaluator, alpha, beta,
+                              boost::mpl::bool_<dense_matrix_traits<M>::value> ());
+    }
+    // Sums and differences of chains are accumulated term by term
+    template<class M, class E1, class E2>
+    void chain_assign (M &m, const binop<E1, E2, addOp> &o, bool accumulate, bool negate) {
+        chain_assign (m, o.left, accumulate, negate);
+        chain_assign (m, o.right, true, negate);
+    }
+    template<class M, class E1, class E2>
+    void chain_assign (M &m, const binop<E1, E2, subOp> &o, bool accumulate, bool negate) {
+        chain_assign (m, o.left, accumulate, negate);
+        chain_assign (m, o.right, true, ! negate);
+    }
 
-        for(size_type i=0; i<C.size();i++) {
-            C[i].clear();
-        }
-        C.clear();
+}
+
+    // Assignment of matrix chains (binop expressions). Products are
+    // evaluated by detail::chain_evaluator straight into dense targets.
+    template<template <class T1, class T2> class F, class M, class E>
+    BOOST_UBLAS_INLINE
+    void chain_matrix_assign (M &m, const E &o) {
+        typedef detail::chain_assign_mode<F<typename M::reference, typename M::value_type> > mode;
+        detail::chain_assign (m, o, mode::accumulate, mode::negate);
+    }
+    template<class M, class E>
+    BOOST_UBLAS_INLINE
+    void chain_matrix_assign (M &m, const E &o) {
+        chain_matrix_assign<scalar_assign> (m, o);
     }
 
     template<class SC, class RI1, class RI2>
@@ -0,0 +1,813 @@
+//
+//  Copyright (c) 2017
+//  uBLAS developers
+//
+//  Distributed under the Boost Software License, Version 1.0. (See
+//  accompanying file LICENSE_1_0.txt or copy at
+//  http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#ifndef _BOOST_UBLAS_MATRIX_CHAIN_
+#define _BOOST_UBLAS_MATRIX_CHAIN_
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <deque>
+#include <vector>
+
+#include <boost/functional/hash.hpp>
+#include <boost/mpl/bool.hpp>
+#include <boost/shared_ptr.hpp>
+#include <boost/unordered_map.hpp>
+#include <boost/type_traits/is_same.hpp>
+#include <boost/numeric/ublas/detail/config.hpp>
+#include <boost/numeric/ublas/detail/dense_traits.hpp>
+#include <boost/numeric/ublas/detail/gemm.hpp>
+#include <boost/numeric/ublas/detail/thread_pool.hpp>
+#include <boost/numeric/ublas/detail/workspace.hpp>
+
+#ifndef BOOST_UBLAS_NO_THREADS
+#include <mutex>
+#endif
+
+// Evaluation of matrix chain products A0 A1 ... An-1.
+//
+// chain_plan finds the cheapest parenthesisation by dynamic programming over
+// the operand dimensions and annotates every node of the optimal tree with
+// its multiply-add count and with the temporary storage its evaluation needs.
+// chain_evaluator walks that tree: every product goes through the packed GEMM
+// kernel and intermediate results are leased from the workspace arena. Two
+// independent subchains run on the thread pool at the same time when both are
+// expensive enough and their combined storage fits the memory budget;
+// otherwise they run one after the other, in the order that needs less
+// storage. Plans only depend on the dimensions, chain_plan_cache keeps them
+// for chains of the same shape.
+//
+// Operands that are mostly zero (sparse, banded or triangular matrices, as
+// measured when they are copied) make the products they take part in cheaper:
+// such a product skips the zeros of its sparser factor, which costs
+// BOOST_UBLAS_CHAIN_SPARSE_PENALTY times a GEMM multiply-add per nonzero, and
+// the plan picks that kernel wherever it beats GEMM.
+
+namespace boost { namespace numeric { namespace ublas { namespace detail {
+
+    class chain_plan {
+    public:
+        typedef std::size_t size_type;
+
+        // How a product of two subchains is formed
+        enum kernel_type {
+            gemm_kernel,
+            // Skipping the zeros of the left or right factor
+            sparse_left_kernel,
+            sparse_right_kernel
+        };
+
+        // Operand k is dims [k] x dims [k + 1] with at most 2^-levels [k] of
+        // its elements nonzero; no levels means dense operands
+        explicit
+        chain_plan (const std::vector<size_type> &dims,
+                    const std::vector<size_type> &levels = std::vector<size_type> ()):
+            n_ (dims.size () - 1), dims_ (dims),
+            split_ (n_ * n_, 0), cost_ (n_ * n_, 0.), density_ (n_ * n_, 1.), kernel_ (n_ * n_, gemm_kernel),
+            peak_ (n_ * n_, 0), left_first_ (n_ * n_, true) {
+            BOOST_UBLAS_CHECK (dims.size () >= 2, bad_size ());
+            BOOST_UBLAS_CHECK (levels.empty () || levels.size () == n_, bad_size ());
+            for (size_type k = 0; k < levels.size (); ++ k)
+                density_ [index (k, k)] = std::ldexp (1., - int (levels [k]));
+            // cost (i, j) is the cheapest way to form Ai ... Aj
+            for (size_type length = 2; length <= n_; ++ length)
+                for (size_type i = 0; i + length <= n_; ++ i) {
+                    const size_type j = i + length - 1;
+                    for (size_type k = i; k < j; ++ k) {
+                        kernel_type kernel;
+                        const double c = cost_ [index (i, k)] + cost_ [index (k + 1, j)] +
+                                         product_cost (i, k, j, kernel);
+                        if (k == i || c < cost_ [index (i, j)]) {
+                            cost_ [index (i, j)] = c;
+                            split_ [index (i, j)] = k;
+                            kernel_ [index (i, j)] = kernel;
+                        }
+                    }
+                    // Each of the inner products is taken to be nonzero
+                    // independently of the others
+                    const size_type k = split (i, j);
+                    const double p = density (i, k) * density (k + 1, j);
+                    density_ [index (i, j)] = p >= 1. ? 1. : - std::expm1 (double (dims_ [k + 1]) * std::log1p (- p));
+                }
+            annotate (0, n_ - 1);
+        }
+
+        // Number of operands
+        BOOST_UBLAS_INLINE
+        size_type size () const {
+            return n_;
+        }
+        // Shape of the product Ai ... Aj
+        BOOST_UBLAS_INLINE
+        size_type rows (size_type i) const {
+            return dims_ [i];
+        }
+        BOOST_UBLAS_INLINE
+        size_type columns (size_type j) const {
+            return dims_ [j + 1];
+        }
+        // The optimal tree forms Ai ... Aj as (Ai ... Ak) (Ak+1 ... Aj)
+        BOOST_UBLAS_INLINE
+        size_type split (size_type i, size_type j) const {
+            return split_ [index (i, j)];
+        }
+        // Work needed for Ai ... Aj, in GEMM multiply-adds
+        BOOST_UBLAS_INLINE
+        double cost (size_type i, size_type j) const {
+            return cost_ [index (i, j)];
+        }
+        // Estimated fraction of nonzero elements of Ai ... Aj
+        BOOST_UBLAS_INLINE
+        double density (size_type i, size_type j) const {
+            return density_ [index (i, j)];
+        }
+        // How (Ai ... Ak) (Ak+1 ... Aj) is multiplied
+        BOOST_UBLAS_INLINE
+        kernel_type kernel (size_type i, size_type j) const {
+            return kernel_type (kernel_ [index (i, j)]);
+        }
+        // Elements of temporary storage for Ai ... Aj, the result included
+        // unless it is an operand, when the subchains run one after the other
+        BOOST_UBLAS_INLINE
+        size_type peak (size_type i, size_type j) const {
+            return peak_ [index (i, j)];
+        }
+        BOOST_UBLAS_INLINE
+        size_type result_size (size_type i, size_type j) const {
+            return i == j ? 0 : rows (i) * columns (j);
+        }
+        // Whether Ai ... Ak should be evaluated before Ak+1 ... Aj
+        BOOST_UBLAS_INLINE
+        bool left_first (size_type i, size_type j) const {
+            return left_first_ [index (i, j)];
+        }
+
+    private:
+        BOOST_UBLAS_INLINE
+        size_type index (size_type i, size_type j) const {
+            return i * n_ + j;
+        }
+
+        // Work of (Ai ... Ak) (Ak+1 ... Aj) and the kernel that does it best.
+        // The sparse kernels scan their factor once and then multiply its
+        // nonzeros only.
+        double product_cost (size_type i, size_type k, size_type j, kernel_type &kernel) const {
+            const double penalty = BOOST_UBLAS_CHAIN_SPARSE_PENALTY;
+            const double m = double (dims_ [i]), l = double (dims_ [k + 1]), n = double (dims_ [j + 1]);
+            const double dense = m * l * n;
+            const double left = m * l + penalty * density (i, k) * dense;
+            const double right = l * n + penalty * density (k + 1, j) * dense;
+            kernel = gemm_kernel;
+            double cost = dense;
+            if (left < cost) {
+                kernel = sparse_left_kernel;
+                cost = left;
+            }
+            if (right < cost) {
+                kernel = sparse_right_kernel;
+                cost = right;
+            }
+            return cost;
+        }
+
+        // Peak storage of the nodes of the optimal tree below (i, j)
+        void annotate (size_type i, size_type j) {
+            if (i == j)
+                return;
+            const size_type k = split (i, j);
+            annotate (i, k);
+            annotate (k + 1, j);
+            const size_type left_peak = peak (i, k), right_peak = peak (k + 1, j);
+            // The first result stays alive while the second subchain runs
+            const size_type left_then_right = (std::max) (left_peak, result_size (i, k) + right_peak);
+            const size_type right_then_left = (std::max) (right_peak, result_size (k + 1, j) + left_peak);
+            left_first_ [index (i, j)] = left_then_right <= right_then_left;
+            peak_ [index (i, j)] = result_size (i, j) + (std::min) (left_then_right, right_then_left);
+        }
+
+        size_type n_;
+        std::vector<size_type> dims_;
+        std::vector<size_type> split_;
+        std::vector<double> cost_;
+        std::vector<double> density_;
+        std::vector<unsigned char> kernel_;
+        std::vector<size_type> peak_;
+        std::vector<bool> left_first_;
+    };
+
+    // Plans of the chains evaluated so far, keyed on their dimensions and
+    // sparsity levels. Once
+    // BOOST_UBLAS_CHAIN_PLAN_CACHE_SIZE plans are kept the cache starts over;
+    // plans in use stay alive until their evaluation ends.
+    class chain_plan_cache:
+        private boost::noncopyable {
+    public:
+        typedef std::size_t size_type;
+        typedef boost::shared_ptr<const chain_plan> plan_pointer;
+
+        BOOST_UBLAS_INLINE
+        chain_plan_cache ():
+            plans_ (), hits_ (0), misses_ (0) {}
+
+        // Shared cache of the chain products
+        static
+        chain_plan_cache &instance () {
+            static chain_plan_cache cache;
+            return cache;
+        }
+
+        // The plan for operands of the given dimensions and sparsity levels
+        // (see chain_plan), planned on a miss
+        plan_pointer find (const std::vector<size_type> &dims,
+                           const std::vector<size_type> &levels = std::vector<size_type> ()) {
+            const size_type capacity = BOOST_UBLAS_CHAIN_PLAN_CACHE_SIZE;
+            // Dense operands have level 0, so that keys of n operands all
+            // have 2 n + 1 entries
+            std::vector<size_type> key (dims);
+            key.resize (2 * dims.size () - 1, 0);
+            std::copy (levels.begin (), levels.end (), key.begin () + dims.size ());
+            {
+#ifndef BOOST_UBLAS_NO_THREADS
+                std::lock_guard<std::mutex> lock (mutex_);
+#endif
+                map_type::const_iterator it = plans_.find (key);
+                if (it != plans_.end ()) {
+                    ++ hits_;
+                    return it->second;
+                }
+                ++ misses_;
+            }
+            // Plan outside the lock; a concurrent miss on the same shape
+            // keeps the plan inserted first
+            plan_pointer plan (new chain_plan (dims, levels));
+            if (capacity == 0)
+                return plan;
+#ifndef BOOST_UBLAS_NO_THREADS
+            std::lock_guard<std::mutex> lock (mutex_);
+#endif
+            if (plans_.size () >= capacity)
+                plans_.clear ();
+            return plans_.insert (map_type::value_type (key, plan)).first->second;
+        }
+
+        // Lookups that found a plan, and those that had to plan
+        size_type hits () const {
+#ifndef BOOST_UBLAS_NO_THREADS
+            std::lock_guard<std::mutex> lock (mutex_);
+#endif
+            return hits_;
+        }
+        size_type misses () const {
+#ifndef BOOST_UBLAS_NO_THREADS
+            std::lock_guard<std::mutex> lock (mutex_);
+#endif
+            return misses_;
+        }
+        // Number of plans kept
+        size_type size () const {
+#ifndef BOOST_UBLAS_NO_THREADS
+            std::lock_guard<std::mutex> lock (mutex_);
+#endif
+            return plans_.size ();
+        }
+        // Drops the plans and resets the counters
+        void clear () {
+#ifndef BOOST_UBLAS_NO_THREADS
+            std::lock_guard<std::mutex> lock (mutex_);
+#endif
+            plans_.clear ();
+            hits_ = misses_ = 0;
+        }
+
+    private:
+        typedef boost::unordered_map<std::vector<size_type>, plan_pointer,
+                                     boost::hash<std::vector<size_type> > > map_type;
+
+        map_type plans_;
+        size_type hits_;
+        size_type misses_;
+#ifndef BOOST_UBLAS_NO_THREADS
+        mutable std::mutex mutex_;
+#endif
+    };
+
+    template<class T>
+    struct chain_sparse_rows;
+
+    // Operand of a chain: element (i, j) is data [i * stride1 + j * stride2],
+    // or, when data is null, the operand holds the nonzeros of sparse only
+    template<class T>
+    struct chain_operand {
+        const T *data;
+        std::ptrdiff_t stride1;
+        std::ptrdiff_t stride2;
+        const chain_sparse_rows<T> *sparse;
+    };
+
+    // The nonzeros of an operand row by row: row i holds
+    // (index [q], value [q]) for q in [start [i], start [i + 1])
+    template<class T>
+    struct chain_sparse_rows {
+        typedef std::size_t size_type;
+
+        std::vector<size_type> start, index;
+        std::vector<T> value;
+
+        BOOST_UBLAS_INLINE
+        chain_sparse_rows ():
+            start (), index (), value () {}
+
+        // The nonzeros of the size1 x size2 dense operand a
+        void assign (const chain_operand<T> &a, size_type size1, size_type size2) {
+            start.assign (size1 + 1, 0);
+            index.clear ();
+            value.clear ();
+            for (size_type i = 0; i < size1; ++ i) {
+                for (size_type j = 0; j < size2; ++ j) {
+                    const T &aij = a.data [std::ptrdiff_t (i) * a.stride1 + std::ptrdiff_t (j) * a.stride2];
+                    if (aij != T ()) {
+                        index.push_back (j);
+                        value.push_back (aij);
+                    }
+                }
+                start [i + 1] = index.size ();
+            }
+        }
+    };
+
+    // The operands of a chain, left to right. Dense matrices of the chain's
+    // value type are used in place. Sparse matrices are copied once into
+    // sparse rows, visiting their stored elements only; other expressions,
+    // such as packed or structured ones, into dense copies. Copies record how
+    // sparse they are.
+    template<class T>
+    class chain_operands:
+        private boost::noncopyable {
+    public:
+        typedef std::size_t size_type;
+
+        BOOST_UBLAS_INLINE
+        chain_operands ():
+            operands_ (), dims_ (), levels_ (), copies_ (), sparse_copies_ () {}
+
+        template<class E>
+        BOOST_UBLAS_INLINE
+        void push_back (const E &e) {
+            typedef boost::mpl::bool_<dense_matrix_traits<E>::value &&
+                                      boost::is_same<typename E::value_type, T>::value> is_dense;
+            if (dims_.empty ())
+                dims_.push_back (e.size1 ());
+            else
+                BOOST_UBLAS_CHECK (dims_.back () == e.size1 (), bad_size ());
+            dims_.push_back (e.size2 ());
+            push_back (e, is_dense ());
+        }
+
+        BOOST_UBLAS_INLINE
+        const std::vector<chain_operand<T> > &operands () const {
+            return operands_;
+        }
+        BOOST_UBLAS_INLINE
+        const std::vector<size_type> &dimensions () const {
+            return dims_;
+        }
+        // At most 2^-levels () [k] of the elements of operand k are nonzero
+        BOOST_UBLAS_INLINE
+        const std::vector<size_type> &levels () const {
+            return levels_;
+        }
+
+        // Whether the storage of an operand meets [first, last)
+        bool overlaps (const T *first, const T *last) const {
+            for (size_type k = 0; k < operands_.size (); ++ k) {
+                const chain_operand<T> &a = operands_ [k];
+                if (a.data == 0 || dims_ [k] == 0 || dims_ [k + 1] == 0)
+                    continue;
+                const T *a_first = a.data + (std::min) (std::ptrdiff_t (0), std::ptrdiff_t (dims_ [k] - 1) * a.stride1) +
+                                            (std::min) (std::ptrdiff_t (0), std::ptrdiff_t (dims_ [k + 1] - 1) * a.stride2);
+                const T *a_last = a.data + (std::max) (std::ptrdiff_t (0), std::ptrdiff_t (dims_ [k] - 1) * a.stride1) +
+                                           (std::max) (std::ptrdiff_t (0), std::ptrdiff_t (dims_ [k + 1] - 1) * a.stride2) + 1;
+                if (a_first < last && first < a_last)
+                    return true;
+            }
+            return false;
+        }
+
+    private:
+        template<class E>
+        BOOST_UBLAS_INLINE
+        void push_back (const E &e, boost::mpl::true_) {
+            typedef dense_matrix_traits<E> traits;
+            chain_operand<T> operand = { traits::data (e), traits::stride1 (e), traits::stride2 (e), 0 };
+            operands_.push_back (operand);
+            levels_.push_back (0);
+        }
+        template<class E>
+        BOOST_UBLAS_INLINE
+        void push_back (const E &e, boost::mpl::false_) {
+            typedef typename E::storage_category storage_category;
+            push_back (e, boost::mpl::bool_<boost::is_same<storage_category, sparse_tag>::value ||
+                                            boost::is_same<storage_category, sparse_proxy_tag>::value> (),
+                       boost::is_same<typename E::orientation_category, column_major_tag> ());
+        }
+        template<class E, class C>
+        void push_back (const E &e, boost::mpl::false_, C column_major) {
+            const size_type size1 = e.size1 (), size2 = e.size2 ();
+            copies_.push_back (std::vector<T> (size1 * size2));
+            std::vector<T> &copy = copies_.back ();
+            // The iterators only visit the stored elements of structured
+            // matrices
+            copy_elements (e, copy, size2, column_major);
+            size_type non_zeros = 0;
+            for (size_type i = 0; i < copy.size (); ++ i)
+                if (copy [i] != T ())
+                    ++ non_zeros;
+            levels_.push_back (level (non_zeros, copy.size ()));
+            // Moving the vectors in copies_ keeps their buffers in place
+            chain_operand<T> operand = { copy.empty () ? 0 : &copy [0], std::ptrdiff_t (size2), 1, 0 };
+            operands_.push_back (operand);
+        }
+        template<class E, class C>
+        void push_back (const E &e, boost::mpl::true_, C column_major) {
+            const size_type size1 = e.size1 (), size2 = e.size2 ();
+            // Elements of a deque stay in place as it grows
+            sparse_copies_.push_back (chain_sparse_rows<T> ());
+            chain_sparse_rows<T> &rows = sparse_copies_.back ();
+            // Counts the nonzeros of every row, then stores them
+            rows.start.assign (size1 + 1, 0);
+            count_elements (e, rows.start, column_major);
+            for (size_type i = 0; i < size1; ++ i)
+                rows.start [i + 1] += rows.start [i];
+            rows.index.resize (rows.start [size1]);
+            rows.value.resize (rows.start [size1]);
+            std::vector<size_type> next (rows.start.begin (), rows.start.end () - 1);
+            store_elements (e, rows, next, column_major);
+            levels_.push_back (level (rows.start [size1], size1 * size2));
+            chain_operand<T> operand = { 0, std::ptrdiff_t (size2), 1, &rows };
+            operands_.push_back (operand);
+        }
+
+        template<class E>
+        static
+        void copy_elements (const E &e, std::vector<T> &copy, size_type size2, boost::false_type) {
+            typedef typename E::const_iterator1 iterator1_type;
+            typedef typename E::const_iterator2 iterator2_type;
+            for (iterator1_type it1 = e.begin1 (); it1 != e.end1 (); ++ it1)
+                for (iterator2_type it2 = it1.begin (); it2 != it1.end (); ++ it2)
+                    copy [it2.index1 () * size2 + it2.index2 ()] = *it2;
+        }
+        template<class E>
+        static
+        void copy_elements (const E &e, std::vector<T> &copy, size_type size2, boost::true_type) {
+            typedef typename E::const_iterator1 iterator1_type;
+            typedef typename E::const_iterator2 iterator2_type;
+            for (iterator2_type it2 = e.begin2 (); it2 != e.end2 (); ++ it2)
+                for (iterator1_type it1 = it2.begin (); it1 != it2.end (); ++ it1)
+                    copy [it1.index1 () * size2 + it1.index2 ()] = *it1;
+        }
+
+        // start [i + 1] += number of stored nonzeros of row i
+        template<class E>
+        static
+        void count_elements (const E &e, std::vector<size_type> &start, boost::false_type) {
+            typedef typename E::const_iterator1 iterator1_type;
+            typedef typename E::const_iterator2 iterator2_type;
+            for (iterator1_type it1 = e.begin1 (); it1 != e.end1 (); ++ it1)
+                for (iterator2_type it2 = it1.begin (); it2 != it1.end (); ++ it2)
+                    if (T (*it2) != T ())
+                        ++ start [it2.index1 () + 1];
+        }
+        template<class E>
+        static
+        void count_elements (const E &e, std::vector<size_type> &start, boost::true_type) {
+            typedef typename E::const_iterator1 iterator1_type;
+            typedef typename E::const_iterator2 iterator2_type;
+            for (iterator2_type it2 = e.begin2 (); it2 != e.end2 (); ++ it2)
+                for (iterator1_type it1 = it2.begin (); it1 != it2.end (); ++ it1)
+                    if (T (*it1) != T ())
+                        ++ start [it1.index1 () + 1];
+        }
+
+        // Stores the stored nonzeros of row i from next [i] on
+        template<class E>
+        static
+        void store_elements (const E &e, chain_sparse_rows<T> &rows, std::vector<size_type> &next, boost::false_type) {
+            typedef typename E::const_iterator1 iterator1_type;
+            typedef typename E::const_iterator2 iterator2_type;
+            for (iterator1_type it1 = e.begin1 (); it1 != e.end1 (); ++ it1)
+                for (iterator2_type it2 = it1.begin (); it2 != it1.end (); ++ it2) {
+                    const T value (*it2);
+                    if (value != T ()) {
+                        const size_type q = next [it2.index1 ()] ++;
+                        rows.index [q] = it2.index2 ();
+                        rows.value [q] = value;
+                    }
+                }
+        }
+        template<class E>
+        static
+        void store_elements (const E &e, chain_sparse_rows<T> &rows, std::vector<size_type> &next, boost::true_type) {
+            typedef typename E::const_iterator1 iterator1_type;
+            typedef typename E::const_iterator2 iterator2_type;
+            for (iterator2_type it2 = e.begin2 (); it2 != e.end2 (); ++ it2)
+                for (iterator1_type it1 = it2.begin (); it1 != it2.end (); ++ it1) {
+                    const T value (*it1);
+                    if (value != T ()) {
+                        const size_type q = next [it1.index1 ()] ++;
+                        rows.index [q] = it1.index2 ();
+                        rows.value [q] = value;
+                    }
+                }
+        }
+
+        // Largest level l, up to 30, with non_zeros <= 2^-l size
+        static
+        size_type level (size_type non_zeros, size_type size) {
+            const size_type max_level = 30;
+            size_type l = 0;
+            while (l < max_level && non_zeros <= (size >> (l + 1)))
+                ++ l;
+            return l;
+        }
+
+        std::vector<chain_operand<T> > operands_;
+        std::vector<size_type> dims_;
+        std::vector<size_type> levels_;
+        std::vector<std::vector<T> > copies_;
+        std::deque<chain_sparse_rows<T> > sparse_copies_;
+    };
+
+    template<class T>
+    class chain_evaluator {
+    public:
+        typedef std::size_t size_type;
+
+        // Runs serially unless parallel is set. Subchains only run
+        // concurrently while the intermediate results fit in budget elements.
+        BOOST_UBLAS_INLINE
+        chain_evaluator (const chain_plan &plan, const std::vector<chain_operand<T> > &operands, bool parallel,
+                         size_type budget = BOOST_UBLAS_CHAIN_MEMORY_LIMIT / sizeof (T)):
+            plan_ (plan), operands_ (operands),
+            pool_ (parallel && thread_pool::instance ().size () > 1 ? &thread_pool::instance () : 0),
+            budget_ (budget) {}
+
+        // c = beta c + alpha A0 ... An-1 where element (i, j) of c is
+        // c [i * c1 + j * c2]. As in gemm, c is not read when beta is zero.
+        // c must not overlap any operand.
+        BOOST_UBLAS_INLINE
+        void evaluate (T *c, std::ptrdiff_t c1, std::ptrdiff_t c2,
+                       const T &alpha = T (1), const T &beta = T ()) const {
+            evaluate (0, plan_.size () - 1, c, c1, c2, budget_, alpha, beta);
+        }
+
+    private:
+        // budget is the storage, in elements, that the evaluation of (i, j)
+        // may lease besides the result c
+        void evaluate (size_type i, size_type j, T *c, std::ptrdiff_t c1, std::ptrdiff_t c2, size_type budget,
+                       const T &alpha, const T &beta) const {
+            if (i == j) {
+                const chain_operand<T> &a = operands_ [i];
+                if (a.sparse) {
+                    for (size_type r = 0; r < plan_.rows (i); ++ r) {
+                        T *cr = c + std::ptrdiff_t (r) * c1;
+                        scale_row (cr, c2, plan_.columns (j), beta);
+                        for (size_type q = a.sparse->start [r]; q < a.sparse->start [r + 1]; ++ q)
+                            cr [std::ptrdiff_t (a.sparse->index [q]) * c2] += alpha * a.sparse->value [q];
+                    }
+                    return;
+                }
+                for (size_type r = 0; r < plan_.rows (i); ++ r)
+                    for (size_type s = 0; s < plan_.columns (j); ++ s) {
+                        T &crs = c [std::ptrdiff_t (r) * c1 + std::ptrdiff_t (s) * c2];
+                        const T &ars = a.data [std::ptrdiff_t (r) * a.stride1 + std::ptrdiff_t (s) * a.stride2];
+                        crs = beta == T () ? alpha * ars : beta * crs + alpha * ars;
+                    }
+                return;
+            }
+            const size_type k = plan_.split (i, j);
+            const size_type left_size = plan_.result_size (i, k), right_size = plan_.result_size (k + 1, j);
+            if (pool_ && left_size != 0 && right_size != 0 &&
+                plan_.cost (i, k) >= double (BOOST_UBLAS_CHAIN_PARALLEL_COST) &&
+                plan_.cost (k + 1, j) >= double (BOOST_UBLAS_CHAIN_PARALLEL_COST) &&
+                plan_.peak (i, k) + plan_.peak (k + 1, j) <= budget) {
+                workspace<T> left (left_size), right (right_size);
+                subchain left_task = { this, i, k, left.data (), budget - plan_.peak (k + 1, j) };
+                subchain right_task = { this, k + 1, j, right.data (), budget - plan_.peak (i, k) };
+                pool_->parallel_invoke (left_task, right_task);
+                multiply (plan_.kernel (i, j), operand (i, k, left.data ()), operand (k + 1, j, right.data ()),
+                          plan_.rows (i), plan_.columns (j), plan_.columns (k), alpha, beta, c, c1, c2);
+            } else if (plan_.left_first (i, j)) {
+                workspace<T> left (left_size);
+                evaluate (i, k, left.data (), budget);
+                workspace<T> right (right_size);
+                evaluate (k + 1, j, right.data (), budget - (std::min) (budget, left_size));
+                multiply (plan_.kernel (i, j), operand (i, k, left.data ()), operand (k + 1, j, right.data ()),
+                          plan_.rows (i), plan_.columns (j), plan_.columns (k), alpha, beta, c, c1, c2);
+            } else {
+                workspace<T> right (right_size);
+                evaluate (k + 1, j, right.data (), budget);
+                workspace<T> left (left_size);
+                evaluate (i, k, left.data (), budget - (std::min) (budget, right_size));
+                multiply (plan_.kernel (i, j), operand (i, k, left.data ()), operand (k + 1, j, right.data ()),
+                          plan_.rows (i), plan_.columns (j), plan_.columns (k), alpha, beta, c, c1, c2);
+            }
+        }
+
+        // Evaluates a product of two or more operands into a row major
+        // buffer, budget including the buffer; single operands are used where
+        // they are
+        BOOST_UBLAS_INLINE
+        void evaluate (size_type i, size_type j, T *buffer, size_type budget) const {
+            if (i != j)
+                evaluate (i, j, buffer, std::ptrdiff_t (plan_.columns (j)), 1,
+                          budget - (std::min) (budget, plan_.result_size (i, j)), T (1), T ());
+        }
+        BOOST_UBLAS_INLINE
+        chain_operand<T> operand (size_type i, size_type j, const T *buffer) const {
+            if (i == j)
+                return operands_ [i];
+            chain_operand<T> result = { buffer, std::ptrdiff_t (plan_.columns (j)), 1, 0 };
+            return result;
+        }
+
+        // The nonzeros of the size1 x size2 operand a, scanned into rows
+        // unless a holds them already
+        static
+        const chain_sparse_rows<T> &sparse_rows (const chain_operand<T> &a, size_type size1, size_type size2,
+                                                 chain_sparse_rows<T> &rows) {
+            if (a.sparse)
+                return *a.sparse;
+            rows.assign (a, size1, size2);
+            return rows;
+        }
+        // The size1 x size2 operand a with its elements in storage, scattered
+        // into buffer when a only holds its nonzeros
+        static
+        chain_operand<T> dense_operand (const chain_operand<T> &a, size_type size1, size_type size2, T *buffer) {
+            if (! a.sparse)
+                return a;
+            std::fill (buffer, buffer + size1 * size2, T ());
+            for (size_type i = 0; i < size1; ++ i)
+                for (size_type q = a.sparse->start [i]; q < a.sparse->start [i + 1]; ++ q)
+                    buffer [i * size2 + a.sparse->index [q]] = a.sparse->value [q];
+            chain_operand<T> result = { buffer, std::ptrdiff_t (size2), 1, 0 };
+            return result;
+        }
+
+        // c (m x n) = beta c + alpha a (m x k) b (k x n), large products
+        // split by rows
+        void multiply (chain_plan::kernel_type kernel, const chain_operand<T> &a, const chain_operand<T> &b,
+                       size_type m, size_type n, size_type k, const T &alpha, const T &beta,
+                       T *c, std::ptrdiff_t c1, std::ptrdiff_t c2) const {
+            const bool split = pool_ && double (m) * double (n) * double (k) >= double (BOOST_UBLAS_CHAIN_PARALLEL_COST);
+            if (kernel == chain_plan::sparse_left_kernel) {
+                chain_sparse_rows<T> scanned;
+                sparse_left_rows rows = { &sparse_rows (a, m, k, scanned), &b, n, &alpha, &beta, c, c1, c2 };
+                if (split)
+                    pool_->parallel_for (0, m, 1, rows);
+                else
+                    rows (0, m);
+            } else if (kernel == chain_plan::sparse_right_kernel) {
+                chain_sparse_rows<T> scanned;
+                sparse_right_rows rows = { &a, &sparse_rows (b, k, n, scanned), n, k, &alpha, &beta, c, c1, c2 };
+                if (split)
+                    pool_->parallel_for (0, m, 1, rows);
+                else
+                    rows (0, m);
+            } else {
+                // Sparse operands are expanded for the packed kernel, which
+                // the plan only picks when they are dense enough
+                workspace<T> a_buffer (a.sparse ? m * k : 0), b_buffer (b.sparse ? k * n : 0);
+                const chain_operand<T> dense_a (dense_operand (a, m, k, a_buffer.data ()));
+                const chain_operand<T> dense_b (dense_operand (b, k, n, b_buffer.data ()));
+                gemm_rows rows = { &dense_a, &dense_b, n, k, &alpha, &beta, c, c1, c2 };
+                if (split)
+                    pool_->parallel_for (0, m, gemm_blocking::mr, rows);
+                else
+                    rows (0, m);
+            }
+        }
+
+        // Rows [first, last) of a product
+        struct gemm_rows {
+            const chain_operand<T> *a, *b;
+            size_type n, k;
+            const T *alpha, *beta;
+            T *c;
+            std::ptrdiff_t c1, c2;
+
+            BOOST_UBLAS_INLINE
+            void operator () (size_type first, size_type last) const {
+                gemm (last - first, n, k, *alpha,
+                      a->data + std::ptrdiff_t (first) * a->stride1, a->stride1, a->stride2,
+                      b->data, b->stride1, b->stride2,
+                      *beta, c + std::ptrdiff_t (first) * c1, c1, c2);
+            }
+        };
+
+        // c (i, :) = beta c (i, :), c is not read when beta is zero
+        static BOOST_UBLAS_INLINE
+        void scale_row (T *ci, std::ptrdiff_t c2, size_type n, const T &beta) {
+            if (beta == T ())
+                for (size_type j = 0; j < n; ++ j)
+                    ci [std::ptrdiff_t (j) * c2] = T ();
+            else if (beta != T (1))
+                for (size_type j = 0; j < n; ++ j)
+                    ci [std::ptrdiff_t (j) * c2] *= beta;
+        }
+
+        // c (i, :) += a b (p, :) for an operand b
+        static BOOST_UBLAS_INLINE
+        void add_row (T *ci, std::ptrdiff_t c2, size_type n, const T &a, const chain_operand<T> &b, size_type p) {
+            if (b.sparse)
+                for (size_type q = b.sparse->start [p]; q < b.sparse->start [p + 1]; ++ q)
+                    ci [std::ptrdiff_t (b.sparse->index [q]) * c2] += a * b.sparse->value [q];
+            else {
+                const T *bp = b.data + std::ptrdiff_t (p) * b.stride1;
+                for (size_type j = 0; j < n; ++ j)
+                    ci [std::ptrdiff_t (j) * c2] += a * bp [std::ptrdiff_t (j) * b.stride2];
+            }
+        }
+
+        // Rows of a product whose left factor is sparse: every nonzero
+        // a (i, p) adds a row of b
+        struct sparse_left_rows {
+            const chain_sparse_rows<T> *a;
+            const chain_operand<T> *b;
+            size_type n;
+            const T *alpha, *beta;
+            T *c;
+            std::ptrdiff_t c1, c2;
+
+            void operator () (size_type first, size_type last) const {
+                for (size_type i = first; i < last; ++ i) {
+                    T *ci = c + std::ptrdiff_t (i) * c1;
+                    scale_row (ci, c2, n, *beta);
+                    for (size_type q = a->start [i]; q < a->start [i + 1]; ++ q)
+                        add_row (ci, c2, n, *alpha * a->value [q], *b, a->index [q]);
+                }
+            }
+        };
+
+        // Rows of a product whose right factor is sparse: every nonzero
+        // a (i, p) adds the nonzeros of row p of b
+        struct sparse_right_rows {
+            const chain_operand<T> *a;
+            const chain_sparse_rows<T> *b;
+            size_type n, k;
+            const T *alpha, *beta;
+            T *c;
+            std::ptrdiff_t c1, c2;
+
+            void operator () (size_type first, size_type last) const {
+                for (size_type i = first; i < last; ++ i) {
+                    T *ci = c + std::ptrdiff_t (i) * c1;
+                    scale_row (ci, c2, n, *beta);
+                    if (a->sparse)
+                        for (size_type q = a->sparse->start [i]; q < a->sparse->start [i + 1]; ++ q)
+                            add_nonzeros (ci, c2, *alpha * a->sparse->value [q], a->sparse->index [q]);
+                    else
+                        for (size_type p = 0; p < k; ++ p) {
+                            const T &aip = a->data [std::ptrdiff_t (i) * a->stride1 + std::ptrdiff_t (p) * a->stride2];
+                            if (aip != T ())
+                                add_nonzeros (ci, c2, *alpha * aip, p);
+                        }
+                }
+            }
+            // c (i, :) += s b (p, :)
+            BOOST_UBLAS_INLINE
+            void add_nonzeros (T *ci, std::ptrdiff_t c2, const T &s, size_type p) const {
+                for (size_type q = b->start [p]; q < b->start [p + 1]; ++ q)
+                    ci [std::ptrdiff_t (b->index [q]) * c2] += s * b->value [q];
+            }
+        };
+
+        // One side of a split evaluated on the pool
+        struct subchain {
+            const chain_evaluator *evaluator;
+            size_type i, j;
+            T *buffer;
+            size_type budget;
+
+            BOOST_UBLAS_INLINE
+            void operator () () const {
+                evaluator->evaluate (i, j, buffer, budget);
+            }
+        };
+
+        const chain_plan &plan_;
+        const std::vector<chain_operand<T> > &operands_;
+        thread_pool *pool_;
+        size_type budget_;
+    };
+
+}}}}
+
+#endif
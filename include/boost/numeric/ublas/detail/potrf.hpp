@@ -0,0 +1,139 @@
+//
+//  Copyright (c) 2017
+//  uBLAS developers
+//
+//  Distributed under the Boost Software License, Version 1.0. (See
+//  accompanying file LICENSE_1_0.txt or copy at
+//  http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#ifndef _BOOST_UBLAS_POTRF_
+#define _BOOST_UBLAS_POTRF_
+
+#include <algorithm>
+#include <cstddef>
+
+#include <boost/numeric/ublas/detail/config.hpp>
+#include <boost/numeric/ublas/detail/gemm.hpp>
+#include <boost/numeric/ublas/detail/thread_pool.hpp>
+#include <boost/numeric/ublas/detail/workspace.hpp>
+#include <boost/numeric/ublas/traits.hpp>
+
+// Blocked Cholesky factorizations A = L L^H and A = L D L^H of the lower
+// triangle of a symmetric or hermitian matrix, right looking as in LAPACK's
+// potrf.
+//
+// The matrix is reached through an accessor, so that packed storage and the
+// symmetric and hermitian adaptors are factored in place. Each panel of
+// BOOST_UBLAS_FACTORIZE_BLOCK columns is copied into a dense buffer and
+// factored there; the trailing matrix is then updated a strip of columns at
+// a time, each strip copied out, updated by one gemm against the buffered
+// panel and copied back. Only elements on or below the diagonal are ever read
+// or written. The strips are independent of each other and are updated in
+// parallel when the accessor allows it.
+
+namespace boost { namespace numeric { namespace ublas { namespace detail {
+
+    // Factors the panel P of r rows and w columns, row major with leading
+    // dimension w, whose first w rows are the diagonal block. Returns one past
+    // the first column whose pivot is not positive (L L^H) or zero (L D L^H).
+    template<class T>
+    std::size_t potrf_panel (bool ldlt, std::size_t r, std::size_t w, T *p) {
+        typedef typename type_traits<T>::real_type real_type;
+        for (std::size_t c = 0; c < w; ++ c) {
+            real_type d = type_traits<T>::real (p [c * w + c]);
+            if (ldlt ? d == real_type () : ! (d > real_type ()))
+                return c + 1;
+            T scale;
+            if (ldlt) {
+                scale = T (1) / T (d);
+            } else {
+                d = type_traits<real_type>::type_sqrt (d);
+                scale = T (1) / T (d);
+                for (std::size_t i = c + 1; i < r; ++ i)
+                    p [i * w + c] *= scale;
+            }
+            p [c * w + c] = T (d);
+            // Rank one update of the columns right of c, lower part only
+            for (std::size_t i = c + 1; i < r; ++ i) {
+                T l = p [i * w + c];
+                if (ldlt)
+                    l *= scale;
+                const std::size_t k_end = (std::min) (i + 1, w);
+                for (std::size_t k = c + 1; k < k_end; ++ k)
+                    p [i * w + k] -= l * type_traits<T>::conj (p [k * w + c]);
+            }
+            if (ldlt) {
+                for (std::size_t i = c + 1; i < r; ++ i)
+                    p [i * w + c] *= scale;
+            }
+        }
+        return 0;
+    }
+
+    // Columns [first, last) of the trailing matrix from row first down:
+    // A22 -= L21 R, with R = (D) L21^H
+    template<class Access, class T>
+    struct potrf_update {
+        Access access;
+        std::size_t j1, n, w;
+        const T *l;     // L21, n - j1 rows, row major with leading dimension w
+        const T *r;     // R, w rows, row major with leading dimension n - j1
+
+        void operator () (std::size_t first, std::size_t last) const {
+            const std::size_t block = BOOST_UBLAS_FACTORIZE_BLOCK;
+            workspace<T> tile ((n - first) * (std::min) (block, last - first));
+            for (std::size_t c0 = first; c0 < last; c0 += block) {
+                const std::size_t c1 = (std::min) (c0 + block, last);
+                const std::size_t rows = n - c0, cols = c1 - c0;
+                T *t = tile.data ();
+                access.load (c0, n, c0, c1, t, cols);
+                gemm (rows, cols, w, T (-1),
+                      l + (c0 - j1) * w, std::ptrdiff_t (w), 1,
+                      r + (c0 - j1), std::ptrdiff_t (n - j1), 1,
+                      T (1), t, std::ptrdiff_t (cols), 1);
+                access.store (c0, n, c0, c1, t, cols);
+            }
+        }
+    };
+
+    // Factors the n x n matrix behind access, L unit lower when ldlt is set
+    // with D on the diagonal. Returns one past the first failed pivot, the
+    // columns up to it are factored.
+    template<class T, class Access>
+    std::size_t potrf (bool ldlt, std::size_t n, const Access &access, bool parallel) {
+        typedef typename type_traits<T>::real_type real_type;
+        const std::size_t block = BOOST_UBLAS_FACTORIZE_BLOCK;
+        thread_pool &pool = thread_pool::instance ();
+        for (std::size_t j0 = 0; j0 < n; j0 += block) {
+            const std::size_t j1 = (std::min) (j0 + block, n);
+            const std::size_t w = j1 - j0, rows = n - j0;
+            workspace<T> panel (rows * w);
+            T *p = panel.data ();
+            access.load (j0, n, j0, j1, p, w);
+            const std::size_t failed = potrf_panel (ldlt, rows, w, p);
+            access.store (j0, n, j0, j1, p, w);
+            if (failed != 0)
+                return j0 + failed;
+            if (j1 == n)
+                break;
+            workspace<T> adjoint (w * (n - j1));
+            T *r = adjoint.data ();
+            for (std::size_t k = 0; k < w; ++ k) {
+                const real_type d = ldlt ? type_traits<T>::real (p [k * w + k]) : real_type (1);
+                for (std::size_t j = 0; j < n - j1; ++ j)
+                    r [k * (n - j1) + j] = type_traits<T>::conj (p [(w + j) * w + k]) * T (d);
+            }
+            potrf_update<Access, T> update = { access, j1, n, w, p + w * w, r };
+            const double cost = double (n - j1) * double (n - j1) * double (w) / 2;
+            if (parallel && pool.size () > 1 && cost >= double (BOOST_UBLAS_FACTORIZE_PARALLEL_COST))
+                pool.parallel_for (j1, n, block, update);
+            else
+                update (j1, n);
+        }
+        return 0;
+    }
+
+}}}}
+
+#endif
@@ -52,6 +52,10 @@ namespace boost { namespace numeric { namespace ublas { namespace raw {
     BOOST_UBLAS_INLINE
     int leading_dimension( const matrix_reference<M> &m ) ;
 
+    template < typename T, typename L, typename A >
+    BOOST_UBLAS_INLINE
+    int leading_dimension( const matrix<T, L, A> &m ) ;
+
     template < typename V >
     BOOST_UBLAS_INLINE
     int stride( const V &v ) ;
@@ -91,6 +95,13 @@ namespace boost { namespace numeric { namespace ublas { namespace raw {
     BOOST_UBLAS_INLINE
     int stride2( const c_matrix<T, M, N> &m ) ;
 
+    template < typename T, typename L, typename A >
+    BOOST_UBLAS_INLINE
+    int stride1( const matrix<T, L, A> &m ) ;
+    template < typename T, typename L, typename A >
+    BOOST_UBLAS_INLINE
+    int stride2( const matrix<T, L, A> &m ) ;
+
     template < typename M >
     BOOST_UBLAS_INLINE
     int stride1( const matrix_range<M> &m ) ;
@@ -402,6 +413,13 @@ namespace boost { namespace numeric { namespace ublas { namespace raw {
         return leading_dimension( m.expression() ) ;
     }
 
+    // Dense matrices may pad their rows or columns
+    template < typename T, typename L, typename A >
+    BOOST_UBLAS_INLINE
+    int leading_dimension( const matrix<T, L, A> &m ) {
+        return m.leading_dimension() ;
+    }
+
     template < typename V >
     BOOST_UBLAS_INLINE
     int stride( const V &v ) {
@@ -465,6 +483,17 @@ namespace boost { namespace numeric { namespace ublas { namespace raw {
         return 1 ;
     }
 
+    template < typename T, typename L, typename A >
+    BOOST_UBLAS_INLINE
+    int stride1( const matrix<T, L, A> &m ) {
+        return L::fast_i() ? 1 : int( m.leading_dimension() ) ;
+    }
+    template < typename T, typename L, typename A >
+    BOOST_UBLAS_INLINE
+    int stride2( const matrix<T, L, A> &m ) {
+        return L::fast_j() ? 1 : int( m.leading_dimension() ) ;
+    }
+
     template < typename M >
     BOOST_UBLAS_INLINE
     int stride1( const matrix_range<M> &m ) {
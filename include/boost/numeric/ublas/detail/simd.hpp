@@ -0,0 +1,653 @@
+//
+//  Copyright (c) 2017
+//  uBLAS developers
+//
+//  Distributed under the Boost Software License, Version 1.0. (See
+//  accompanying file LICENSE_1_0.txt or copy at
+//  http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#ifndef _BOOST_UBLAS_SIMD_
+#define _BOOST_UBLAS_SIMD_
+
+#include <complex>
+#include <cstddef>
+
+#include <boost/mpl/and.hpp>
+#include <boost/mpl/bool.hpp>
+#include <boost/type_traits/is_same.hpp>
+#include <boost/numeric/ublas/detail/config.hpp>
+#include <boost/numeric/ublas/detail/dense_traits.hpp>
+
+// Explicitly vectorised kernels for dense float, double and complex data.
+//
+// The kernels are compiled for SSE2, AVX2 (with FMA) and AVX-512F in the same
+// binary and the widest instruction set supported by the processor is chosen
+// at run time from CPUID, so one build runs everywhere. Every entry point
+// returns false when it cannot handle its arguments (no SIMD support, value
+// type not covered, non unit strides); the callers then run their portable
+// loops. Results may differ from the portable loops in the last bits, since
+// the kernels sum in a different order.
+
+#if !defined (BOOST_UBLAS_NO_SIMD_DISPATCH) && (defined (__GNUC__) || defined (__clang__)) && \
+    (defined (__x86_64__) || defined (__i386__))
+#define BOOST_UBLAS_SIMD_DISPATCH
+#include <immintrin.h>
+#endif
+
+namespace boost { namespace numeric { namespace ublas { namespace detail {
+
+    // Instruction sets, in increasing order of capability
+    enum simd_isa {
+        simd_none,
+        simd_sse2,
+        simd_avx2,
+        simd_avx512
+    };
+
+    // Widest instruction set supported by the processor and the OS
+    inline simd_isa simd_supported_isa () {
+#ifdef BOOST_UBLAS_SIMD_DISPATCH
+        __builtin_cpu_init ();
+        if (__builtin_cpu_supports ("avx512f"))
+            return simd_avx512;
+        if (__builtin_cpu_supports ("avx2") && __builtin_cpu_supports ("fma"))
+            return simd_avx2;
+        if (__builtin_cpu_supports ("sse2"))
+            return simd_sse2;
+#endif
+        return simd_none;
+    }
+
+    inline simd_isa &simd_isa_selection () {
+        static simd_isa isa = simd_supported_isa ();
+        return isa;
+    }
+
+    // Instruction set used by the kernels
+    inline simd_isa simd_active_isa () {
+        return simd_isa_selection ();
+    }
+
+    // Restrict the kernels to at most isa, e.g. to compare against the portable
+    // loops with simd_none. Returns the instruction set actually selected.
+    // Not synchronised: meant for tests and benchmarks, before any other
+    // thread runs the kernels.
+    inline simd_isa simd_select_isa (simd_isa isa) {
+        const simd_isa supported = simd_supported_isa ();
+        simd_isa_selection () = isa < supported ? isa : supported;
+        return simd_isa_selection ();
+    }
+
+#ifdef BOOST_UBLAS_SIMD_DISPATCH
+
+#if defined (__clang__)
+#pragma clang attribute push (__attribute__ ((target ("sse2"))), apply_to = function)
+#else
+#pragma GCC push_options
+#pragma GCC target ("sse2")
+#endif
+    namespace simd_sse2_kernels {
+        template<class T>
+        struct ops;
+
+        template<>
+        struct ops<double> {
+            typedef __m128d reg;
+            enum { width = 2 };
+            static inline reg zero () { return _mm_setzero_pd (); }
+            static inline reg set1 (double a) { return _mm_set1_pd (a); }
+            static inline reg set_pair (double a0, double a1) { return _mm_setr_pd (a0, a1); }
+            static inline reg load (const double *p) { return _mm_loadu_pd (p); }
+            static inline void store (double *p, reg a) { _mm_storeu_pd (p, a); }
+            static inline reg load_aligned (const double *p) { return _mm_load_pd (p); }
+            static inline void store_aligned (double *p, reg a) { _mm_store_pd (p, a); }
+            static inline reg add (reg a, reg b) { return _mm_add_pd (a, b); }
+            static inline reg mul (reg a, reg b) { return _mm_mul_pd (a, b); }
+            static inline reg fmadd (reg a, reg b, reg c) { return _mm_add_pd (_mm_mul_pd (a, b), c); }
+            static inline reg swap_pairs (reg a) { return _mm_shuffle_pd (a, a, 1); }
+            static inline reg gather (const double *p, const std::size_t *k) { return _mm_setr_pd (p [k [0]], p [k [1]]); }
+        };
+
+        template<>
+        struct ops<float> {
+            typedef __m128 reg;
+            enum { width = 4 };
+            static inline reg zero () { return _mm_setzero_ps (); }
+            static inline reg set1 (float a) { return _mm_set1_ps (a); }
+            static inline reg set_pair (float a0, float a1) { return _mm_setr_ps (a0, a1, a0, a1); }
+            static inline reg load (const float *p) { return _mm_loadu_ps (p); }
+            static inline void store (float *p, reg a) { _mm_storeu_ps (p, a); }
+            static inline reg load_aligned (const float *p) { return _mm_load_ps (p); }
+            static inline void store_aligned (float *p, reg a) { _mm_store_ps (p, a); }
+            static inline reg add (reg a, reg b) { return _mm_add_ps (a, b); }
+            static inline reg mul (reg a, reg b) { return _mm_mul_ps (a, b); }
+            static inline reg fmadd (reg a, reg b, reg c) { return _mm_add_ps (_mm_mul_ps (a, b), c); }
+            static inline reg swap_pairs (reg a) { return _mm_shuffle_ps (a, a, 0xb1); }
+            static inline reg gather (const float *p, const std::size_t *k) {
+                return _mm_setr_ps (p [k [0]], p [k [1]], p [k [2]], p [k [3]]);
+            }
+        };
+
+#include <boost/numeric/ublas/detail/simd_kernels.hpp>
+    }
+#if defined (__clang__)
+#pragma clang attribute pop
+#else
+#pragma GCC pop_options
+#endif
+
+#if defined (__clang__)
+#pragma clang attribute push (__attribute__ ((target ("avx2,fma"))), apply_to = function)
+#else
+#pragma GCC push_options
+#pragma GCC target ("avx2,fma")
+#endif
+    namespace simd_avx2_kernels {
+        template<class T>
+        struct ops;
+
+        template<>
+        struct ops<double> {
+            typedef __m256d reg;
+            enum { width = 4 };
+            static inline reg zero () { return _mm256_setzero_pd (); }
+            static inline reg set1 (double a) { return _mm256_set1_pd (a); }
+            static inline reg set_pair (double a0, double a1) { return _mm256_setr_pd (a0, a1, a0, a1); }
+            static inline reg load (const double *p) { return _mm256_loadu_pd (p); }
+            static inline void store (double *p, reg a) { _mm256_storeu_pd (p, a); }
+            static inline reg load_aligned (const double *p) { return _mm256_load_pd (p); }
+            static inline void store_aligned (double *p, reg a) { _mm256_store_pd (p, a); }
+            static inline reg add (reg a, reg b) { return _mm256_add_pd (a, b); }
+            static inline reg mul (reg a, reg b) { return _mm256_mul_pd (a, b); }
+            static inline reg fmadd (reg a, reg b, reg c) { return _mm256_fmadd_pd (a, b, c); }
+            static inline reg swap_pairs (reg a) { return _mm256_permute_pd (a, 0x5); }
+            static inline reg gather (const double *p, const std::size_t *k) {
+#ifdef __x86_64__
+                return _mm256_i64gather_pd (p, _mm256_loadu_si256 ((const __m256i *) k), 8);
+#else
+                return _mm256_i32gather_pd (p, _mm_loadu_si128 ((const __m128i *) k), 8);
+#endif
+            }
+        };
+
+        template<>
+        struct ops<float> {
+            typedef __m256 reg;
+            enum { width = 8 };
+            static inline reg zero () { return _mm256_setzero_ps (); }
+            static inline reg set1 (float a) { return _mm256_set1_ps (a); }
+            static inline reg set_pair (float a0, float a1) { return _mm256_setr_ps (a0, a1, a0, a1, a0, a1, a0, a1); }
+            static inline reg load (const float *p) { return _mm256_loadu_ps (p); }
+            static inline void store (float *p, reg a) { _mm256_storeu_ps (p, a); }
+            static inline reg load_aligned (const float *p) { return _mm256_load_ps (p); }
+            static inline void store_aligned (float *p, reg a) { _mm256_store_ps (p, a); }
+            static inline reg add (reg a, reg b) { return _mm256_add_ps (a, b); }
+            static inline reg mul (reg a, reg b) { return _mm256_mul_ps (a, b); }
+            static inline reg fmadd (reg a, reg b, reg c) { return _mm256_fmadd_ps (a, b, c); }
+            static inline reg swap_pairs (reg a) { return _mm256_permute_ps (a, 0xb1); }
+            static inline reg gather (const float *p, const std::size_t *k) {
+#ifdef __x86_64__
+                return _mm256_set_m128 (_mm256_i64gather_ps (p, _mm256_loadu_si256 ((const __m256i *) (k + 4)), 4),
+                                        _mm256_i64gather_ps (p, _mm256_loadu_si256 ((const __m256i *) k), 4));
+#else
+                return _mm256_i32gather_ps (p, _mm256_loadu_si256 ((const __m256i *) k), 4);
+#endif
+            }
+        };
+
+#include <boost/numeric/ublas/detail/simd_kernels.hpp>
+    }
+#if defined (__clang__)
+#pragma clang attribute pop
+#else
+#pragma GCC pop_options
+#endif
+
+#if defined (__clang__)
+#pragma clang attribute push (__attribute__ ((target ("avx512f,avx2,fma"))), apply_to = function)
+#else
+#pragma GCC push_options
+#pragma GCC target ("avx512f,avx2,fma")
+#endif
+    namespace simd_avx512_kernels {
+        template<class T>
+        struct ops;
+
+        template<>
+        struct ops<double> {
+            typedef __m512d reg;
+            enum { width = 8 };
+            static inline reg zero () { return _mm512_setzero_pd (); }
+            static inline reg set1 (double a) { return _mm512_set1_pd (a); }
+            static inline reg set_pair (double a0, double a1) { return _mm512_set_pd (a1, a0, a1, a0, a1, a0, a1, a0); }
+            static inline reg load (const double *p) { return _mm512_loadu_pd (p); }
+            static inline void store (double *p, reg a) { _mm512_storeu_pd (p, a); }
+            static inline reg load_aligned (const double *p) { return _mm512_load_pd (p); }
+            static inline void store_aligned (double *p, reg a) { _mm512_store_pd (p, a); }
+            static inline reg add (reg a, reg b) { return _mm512_add_pd (a, b); }
+            static inline reg mul (reg a, reg b) { return _mm512_mul_pd (a, b); }
+            static inline reg fmadd (reg a, reg b, reg c) { return _mm512_fmadd_pd (a, b, c); }
+            static inline reg swap_pairs (reg a) { return _mm512_shuffle_pd (a, a, 0x55); }
+            static inline reg gather (const double *p, const std::size_t *k) {
+                // The masked forms with a zero source, the plain ones leave
+                // their destination formally uninitialized
+#ifdef __x86_64__
+                return _mm512_mask_i64gather_pd (_mm512_setzero_pd (), 0xff, _mm512_loadu_si512 (k), p, 8);
+#else
+                return _mm512_mask_i32gather_pd (_mm512_setzero_pd (), 0xff, _mm256_loadu_si256 ((const __m256i *) k), p, 8);
+#endif
+            }
+        };
+
+        template<>
+        struct ops<float> {
+            typedef __m512 reg;
+            enum { width = 16 };
+            static inline reg zero () { return _mm512_setzero_ps (); }
+            static inline reg set1 (float a) { return _mm512_set1_ps (a); }
+            static inline reg set_pair (float a0, float a1) {
+                return _mm512_set_ps (a1, a0, a1, a0, a1, a0, a1, a0, a1, a0, a1, a0, a1, a0, a1, a0);
+            }
+            static inline reg load (const float *p) { return _mm512_loadu_ps (p); }
+            static inline void store (float *p, reg a) { _mm512_storeu_ps (p, a); }
+            static inline reg load_aligned (const float *p) { return _mm512_load_ps (p); }
+            static inline void store_aligned (float *p, reg a) { _mm512_store_ps (p, a); }
+            static inline reg add (reg a, reg b) { return _mm512_add_ps (a, b); }
+            static inline reg mul (reg a, reg b) { return _mm512_mul_ps (a, b); }
+            static inline reg fmadd (reg a, reg b, reg c) { return _mm512_fmadd_ps (a, b, c); }
+            static inline reg swap_pairs (reg a) { return _mm512_shuffle_ps (a, a, 0xb1); }
+            static inline reg gather (const float *p, const std::size_t *k) {
+#ifdef __x86_64__
+                const __m256 low = _mm512_mask_i64gather_ps (_mm256_setzero_ps (), 0xff, _mm512_loadu_si512 (k), p, 4);
+                const __m256 high = _mm512_mask_i64gather_ps (_mm256_setzero_ps (), 0xff, _mm512_loadu_si512 (k + 8), p, 4);
+                const __m512d zero = _mm512_setzero_pd ();
+                const __m512d halves = _mm512_mask_insertf64x4 (zero, 0xff, zero, _mm256_castps_pd (low), 0);
+                return _mm512_castpd_ps (_mm512_mask_insertf64x4 (zero, 0xff, halves, _mm256_castps_pd (high), 1));
+#else
+                return _mm512_mask_i32gather_ps (_mm512_setzero_ps (), 0xffff, _mm512_loadu_si512 (k), p, 4);
+#endif
+            }
+        };
+
+#include <boost/numeric/ublas/detail/simd_kernels.hpp>
+    }
+#if defined (__clang__)
+#pragma clang attribute pop
+#else
+#pragma GCC pop_options
+#endif
+
+// Run statement with the kernels of the active instruction set in scope,
+// or return false from the enclosing function if there are none.
+#define BOOST_UBLAS_SIMD_DISPATCH_KERNELS(statement) \
+    switch (simd_active_isa ()) { \
+    case simd_avx512: { using namespace simd_avx512_kernels; statement; break; } \
+    case simd_avx2: { using namespace simd_avx2_kernels; statement; break; } \
+    case simd_sse2: { using namespace simd_sse2_kernels; statement; break; } \
+    default: return false; \
+    }
+
+#else
+
+#define BOOST_UBLAS_SIMD_DISPATCH_KERNELS(statement) \
+    return false;
+
+#endif
+
+    // Value types the kernels handle, complex numbers as interleaved pairs
+    struct simd_unsupported_tag {};
+    struct simd_real_tag {};
+    struct simd_complex_tag {};
+
+    template<class T>
+    struct simd_traits {
+        typedef simd_unsupported_tag category;
+        typedef T real_type;
+    };
+    template<>
+    struct simd_traits<float> {
+        typedef simd_real_tag category;
+        typedef float real_type;
+    };
+    template<>
+    struct simd_traits<double> {
+        typedef simd_real_tag category;
+        typedef double real_type;
+    };
+    template<class T>
+    struct simd_traits<std::complex<T> > {
+        typedef typename simd_traits<T>::category real_category;
+        typedef typename boost::mpl::if_<boost::is_same<real_category, simd_real_tag>,
+                                         simd_complex_tag, simd_unsupported_tag>::type category;
+        typedef T real_type;
+    };
+
+    template<class T>
+    BOOST_UBLAS_INLINE
+    const typename simd_traits<T>::real_type *simd_real_data (const T *p) {
+        return reinterpret_cast<const typename simd_traits<T>::real_type *> (p);
+    }
+    template<class T>
+    BOOST_UBLAS_INLINE
+    typename simd_traits<T>::real_type *simd_real_data (T *p) {
+        return reinterpret_cast<typename simd_traits<T>::real_type *> (p);
+    }
+
+    // Vectors of the kernels below start at multiples of simd_alignment bytes
+    // when aligned is true, which lets them use aligned loads and stores
+    const std::size_t simd_alignment = 64;
+
+    // Whether the vector at element offset of storage aligned to Alignment
+    // bytes starts at a multiple of simd_alignment; false at compile time for
+    // storage that is not aligned
+    template<std::size_t Alignment, class T>
+    BOOST_UBLAS_INLINE
+    bool simd_aligned_at (std::ptrdiff_t offset) {
+        return Alignment >= simd_alignment && (std::size_t (offset) * sizeof (T)) % simd_alignment == 0;
+    }
+
+    // t = x^T y
+    template<class T>
+    BOOST_UBLAS_INLINE
+    bool simd_dot (std::size_t, const T *, const T *, T &, bool, simd_unsupported_tag) {
+        return false;
+    }
+    template<class T>
+    BOOST_UBLAS_INLINE
+    bool simd_dot (std::size_t n, const T *x, const T *y, T &t, bool aligned, simd_real_tag) {
+        BOOST_UBLAS_SIMD_DISPATCH_KERNELS (t = aligned ? dot<aligned_access> (n, x, y) : dot<unaligned_access> (n, x, y))
+        return true;
+    }
+    template<class T>
+    BOOST_UBLAS_INLINE
+    bool simd_dot (std::size_t n, const T *x, const T *y, T &t, bool aligned, simd_complex_tag) {
+        typedef typename simd_traits<T>::real_type real_type;
+        real_type re = real_type (), im = real_type ();
+        BOOST_UBLAS_SIMD_DISPATCH_KERNELS (
+            if (aligned)
+                complex_dot<aligned_access> (2 * n, simd_real_data (x), simd_real_data (y), re, im);
+            else
+                complex_dot<unaligned_access> (2 * n, simd_real_data (x), simd_real_data (y), re, im))
+        t = T (re, im);
+        return true;
+    }
+    template<class T>
+    BOOST_UBLAS_INLINE
+    bool simd_dot (std::size_t n, const T *x, const T *y, T &t, bool aligned = false) {
+        return simd_dot (n, x, y, t, aligned, typename simd_traits<T>::category ());
+    }
+
+    // Strided variant, only unit strides are vectorised
+    template<class T>
+    BOOST_UBLAS_INLINE
+    bool simd_dot (std::size_t n, const T *x, std::ptrdiff_t sx, const T *y, std::ptrdiff_t sy, T &t, bool aligned = false) {
+        return sx == 1 && sy == 1 && simd_dot (n, x, y, t, aligned);
+    }
+
+    // t = sum |x_i|^2
+    template<class T>
+    BOOST_UBLAS_INLINE
+    bool simd_sum_squares (std::size_t, const T *, typename simd_traits<T>::real_type &, bool, simd_unsupported_tag) {
+        return false;
+    }
+    template<class T>
+    BOOST_UBLAS_INLINE
+    bool simd_sum_squares (std::size_t n, const T *x, typename simd_traits<T>::real_type &t, bool aligned, simd_real_tag) {
+        BOOST_UBLAS_SIMD_DISPATCH_KERNELS (t = aligned ? sum_squares<aligned_access> (n, x) : sum_squares<unaligned_access> (n, x))
+        return true;
+    }
+    template<class T>
+    BOOST_UBLAS_INLINE
+    bool simd_sum_squares (std::size_t n, const T *x, typename simd_traits<T>::real_type &t, bool aligned, simd_complex_tag) {
+        return simd_sum_squares (2 * n, simd_real_data (x), t, aligned, simd_real_tag ());
+    }
+    template<class T>
+    BOOST_UBLAS_INLINE
+    bool simd_sum_squares (std::size_t n, const T *x, typename simd_traits<T>::real_type &t, bool aligned = false) {
+        return simd_sum_squares (n, x, t, aligned, typename simd_traits<T>::category ());
+    }
+
+    // y += a x
+    template<class T>
+    BOOST_UBLAS_INLINE
+    bool simd_axpy (std::size_t, const T &, const T *, T *, bool, simd_unsupported_tag) {
+        return false;
+    }
+    template<class T>
+    BOOST_UBLAS_INLINE
+    bool simd_axpy (std::size_t n, const T &a, const T *x, T *y, bool aligned, simd_real_tag) {
+        BOOST_UBLAS_SIMD_DISPATCH_KERNELS (
+            if (aligned)
+                axpy<aligned_access> (n, a, x, y);
+            else
+                axpy<unaligned_access> (n, a, x, y))
+        return true;
+    }
+    template<class T>
+    BOOST_UBLAS_INLINE
+    bool simd_axpy (std::size_t n, const T &a, const T *x, T *y, bool aligned, simd_complex_tag) {
+        BOOST_UBLAS_SIMD_DISPATCH_KERNELS (
+            if (aligned)
+                complex_axpy<aligned_access> (2 * n, a.real (), a.imag (), simd_real_data (x), simd_real_data (y));
+            else
+                complex_axpy<unaligned_access> (2 * n, a.real (), a.imag (), simd_real_data (x), simd_real_data (y)))
+        return true;
+    }
+    template<class T>
+    BOOST_UBLAS_INLINE
+    bool simd_axpy (std::size_t n, const T &a, const T *x, T *y, bool aligned = false) {
+        return simd_axpy (n, a, x, y, aligned, typename simd_traits<T>::category ());
+    }
+
+    // ab (MR x NR) = ap bp for the register tile of the packed product
+    template<std::size_t MR, std::size_t NR, class T>
+    BOOST_UBLAS_INLINE
+    bool simd_gemm_tile (std::size_t, const T *, const T *, T *, simd_unsupported_tag) {
+        return false;
+    }
+    template<std::size_t MR, std::size_t NR, class T>
+    BOOST_UBLAS_INLINE
+    bool simd_gemm_tile (std::size_t kc, const T *ap, const T *bp, T *ab, simd_real_tag) {
+#ifdef BOOST_UBLAS_SIMD_DISPATCH
+        // The tile is only vectorised along rows of whole registers, with the
+        // widest ones that divide its width
+        switch (simd_active_isa ()) {
+        case simd_avx512:
+            if (simd_avx512_kernels::gemm_tile<MR, NR> (kc, ap, bp, ab))
+                return true;
+            // fall through
+        case simd_avx2:
+            if (simd_avx2_kernels::gemm_tile<MR, NR> (kc, ap, bp, ab))
+                return true;
+            // fall through
+        case simd_sse2:
+            return simd_sse2_kernels::gemm_tile<MR, NR> (kc, ap, bp, ab);
+        default:
+            return false;
+        }
+#else
+        return false;
+#endif
+    }
+    template<std::size_t MR, std::size_t NR, class T>
+    BOOST_UBLAS_INLINE
+    bool simd_gemm_tile (std::size_t kc, const T *ap, const T *bp, T *ab) {
+        // Complex tiles are left to the portable loop
+        return simd_gemm_tile<MR, NR> (kc, ap, bp, ab, typename boost::mpl::if_<
+            boost::is_same<typename simd_traits<T>::category, simd_real_tag>,
+            simd_real_tag, simd_unsupported_tag>::type ());
+    }
+
+    // acc [(c - first) C + r] = row r of chunk c of a sliced ELLPACK matrix
+    // times x, for the chunks [first, last), see sliced_ell_matrix
+    template<std::size_t C, class T, class I>
+    BOOST_UBLAS_INLINE
+    bool simd_sell_chunks (std::size_t, std::size_t, const I *, const I *, const T *, const T *, T *,
+                           simd_unsupported_tag) {
+        return false;
+    }
+    template<std::size_t C, class T>
+    BOOST_UBLAS_INLINE
+    bool simd_sell_chunks (std::size_t first, std::size_t last, const std::size_t *ptr, const std::size_t *idx,
+                           const T *val, const T *x, T *acc, simd_real_tag) {
+#ifdef BOOST_UBLAS_SIMD_DISPATCH
+        // The widest registers that divide the chunk height
+        switch (simd_active_isa ()) {
+        case simd_avx512:
+            if (simd_avx512_kernels::sell_chunks<C> (first, last, ptr, idx, val, x, acc))
+                return true;
+            // fall through
+        case simd_avx2:
+            if (simd_avx2_kernels::sell_chunks<C> (first, last, ptr, idx, val, x, acc))
+                return true;
+            // fall through
+        case simd_sse2:
+            return simd_sse2_kernels::sell_chunks<C> (first, last, ptr, idx, val, x, acc);
+        default:
+            return false;
+        }
+#else
+        return false;
+#endif
+    }
+    template<std::size_t C, class T, class I>
+    BOOST_UBLAS_INLINE
+    bool simd_sell_chunks (std::size_t first, std::size_t last, const I *ptr, const I *idx,
+                           const T *val, const T *x, T *acc) {
+        // The gathers take std::size_t indices; complex values are left to
+        // the portable loop
+        return simd_sell_chunks<C> (first, last, ptr, idx, val, x, acc, typename boost::mpl::if_<
+            boost::mpl::and_<boost::is_same<typename simd_traits<T>::category, simd_real_tag>,
+                             boost::is_same<I, std::size_t> >,
+            simd_real_tag, simd_unsupported_tag>::type ());
+    }
+
+#undef BOOST_UBLAS_SIMD_DISPATCH_KERNELS
+
+    // Expression level entry points for dense containers
+
+    template<class E1, class E2, class T>
+    BOOST_UBLAS_INLINE
+    bool simd_inner_prod (const E1 &, const E2 &, T &, boost::mpl::false_) {
+        return false;
+    }
+    template<class E1, class E2, class T>
+    BOOST_UBLAS_INLINE
+    bool simd_inner_prod (const E1 &e1, const E2 &e2, T &t, boost::mpl::true_) {
+        return simd_dot (BOOST_UBLAS_SAME (e1.size (), e2.size ()),
+                         dense_vector_traits<E1>::data (e1), dense_vector_traits<E2>::data (e2), t,
+                         simd_aligned_at<dense_vector_traits<E1>::alignment, T> (0) &&
+                         simd_aligned_at<dense_vector_traits<E2>::alignment, T> (0));
+    }
+    // t = inner_prod (e1, e2) for dense vectors of the value type of t
+    template<class E1, class E2, class T>
+    BOOST_UBLAS_INLINE
+    bool simd_inner_prod (const E1 &e1, const E2 &e2, T &t) {
+        typedef boost::mpl::bool_<dense_vector_traits<E1>::value && dense_vector_traits<E2>::value &&
+                                  boost::is_same<typename E1::value_type, T>::value &&
+                                  boost::is_same<typename E2::value_type, T>::value> is_dense;
+        return simd_inner_prod (e1, e2, t, is_dense ());
+    }
+
+    template<class E, class R>
+    BOOST_UBLAS_INLINE
+    bool simd_norm_2_square (const E &, R &, boost::mpl::false_) {
+        return false;
+    }
+    template<class E, class R>
+    BOOST_UBLAS_INLINE
+    bool simd_norm_2_square (const E &e, R &t, boost::mpl::true_) {
+        return simd_sum_squares (e.size (), dense_vector_traits<E>::data (e), t,
+                                 simd_aligned_at<dense_vector_traits<E>::alignment, typename E::value_type> (0));
+    }
+    // t = norm_2 (e)^2 for a dense vector
+    template<class E, class R>
+    BOOST_UBLAS_INLINE
+    bool simd_norm_2_square (const E &e, R &t) {
+        typedef boost::mpl::bool_<dense_vector_traits<E>::value &&
+                                  boost::is_same<typename simd_traits<typename E::value_type>::real_type, R>::value> is_dense;
+        return simd_norm_2_square (e, t, is_dense ());
+    }
+
+    template<class E1, class E2, class T>
+    BOOST_UBLAS_INLINE
+    bool simd_row_prod (const E1 &, std::size_t, const E2 &, T &, boost::mpl::false_) {
+        return false;
+    }
+    template<class E1, class E2, class T>
+    BOOST_UBLAS_INLINE
+    bool simd_row_prod (const E1 &e1, std::size_t i, const E2 &e2, T &t, boost::mpl::true_) {
+        typedef dense_matrix_traits<E1> traits1;
+        const std::ptrdiff_t offset1 = std::ptrdiff_t (i) * traits1::stride1 (e1);
+        return simd_dot (BOOST_UBLAS_SAME (e1.size2 (), e2.size ()),
+                         traits1::data (e1) + offset1, traits1::stride2 (e1), dense_vector_traits<E2>::data (e2), 1, t,
+                         simd_aligned_at<traits1::alignment, T> (offset1) &&
+                         simd_aligned_at<dense_vector_traits<E2>::alignment, T> (0));
+    }
+    // t = inner_prod (row (e1, i), e2) for a dense matrix and vector
+    template<class E1, class E2, class T>
+    BOOST_UBLAS_INLINE
+    bool simd_row_prod (const E1 &e1, std::size_t i, const E2 &e2, T &t) {
+        typedef boost::mpl::bool_<dense_matrix_traits<E1>::value && dense_vector_traits<E2>::value &&
+                                  boost::is_same<typename E1::value_type, T>::value &&
+                                  boost::is_same<typename E2::value_type, T>::value> is_dense;
+        return simd_row_prod (e1, i, e2, t, is_dense ());
+    }
+
+    template<class E1, class E2, class T>
+    BOOST_UBLAS_INLINE
+    bool simd_column_prod (const E1 &, const E2 &, std::size_t, T &, boost::mpl::false_) {
+        return false;
+    }
+    template<class E1, class E2, class T>
+    BOOST_UBLAS_INLINE
+    bool simd_column_prod (const E1 &e1, const E2 &e2, std::size_t j, T &t, boost::mpl::true_) {
+        typedef dense_matrix_traits<E2> traits2;
+        const std::ptrdiff_t offset2 = std::ptrdiff_t (j) * traits2::stride2 (e2);
+        return simd_dot (BOOST_UBLAS_SAME (e1.size (), e2.size1 ()), dense_vector_traits<E1>::data (e1), 1,
+                         traits2::data (e2) + offset2, traits2::stride1 (e2), t,
+                         simd_aligned_at<dense_vector_traits<E1>::alignment, T> (0) &&
+                         simd_aligned_at<traits2::alignment, T> (offset2));
+    }
+    // t = inner_prod (e1, column (e2, j)) for a dense vector and matrix
+    template<class E1, class E2, class T>
+    BOOST_UBLAS_INLINE
+    bool simd_column_prod (const E1 &e1, const E2 &e2, std::size_t j, T &t) {
+        typedef boost::mpl::bool_<dense_vector_traits<E1>::value && dense_matrix_traits<E2>::value &&
+                                  boost::is_same<typename E1::value_type, T>::value &&
+                                  boost::is_same<typename E2::value_type, T>::value> is_dense;
+        return simd_column_prod (e1, e2, j, t, is_dense ());
+    }
+
+    template<class E1, class E2, class T>
+    BOOST_UBLAS_INLINE
+    bool simd_element_prod (const E1 &, std::size_t, const E2 &, std::size_t, T &, boost::mpl::false_) {
+        return false;
+    }
+    template<class E1, class E2, class T>
+    BOOST_UBLAS_INLINE
+    bool simd_element_prod (const E1 &e1, std::size_t i, const E2 &e2, std::size_t j, T &t, boost::mpl::true_) {
+        typedef dense_matrix_traits<E1> traits1;
+        typedef dense_matrix_traits<E2> traits2;
+        const std::ptrdiff_t offset1 = std::ptrdiff_t (i) * traits1::stride1 (e1);
+        const std::ptrdiff_t offset2 = std::ptrdiff_t (j) * traits2::stride2 (e2);
+        return simd_dot (BOOST_UBLAS_SAME (e1.size2 (), e2.size1 ()),
+                         traits1::data (e1) + offset1, traits1::stride2 (e1),
+                         traits2::data (e2) + offset2, traits2::stride1 (e2), t,
+                         simd_aligned_at<traits1::alignment, T> (offset1) &&
+                         simd_aligned_at<traits2::alignment, T> (offset2));
+    }
+    // t = inner_prod (row (e1, i), column (e2, j)) for dense matrices
+    template<class E1, class E2, class T>
+    BOOST_UBLAS_INLINE
+    bool simd_element_prod (const E1 &e1, std::size_t i, const E2 &e2, std::size_t j, T &t) {
+        typedef boost::mpl::bool_<dense_matrix_traits<E1>::value && dense_matrix_traits<E2>::value &&
+                                  boost::is_same<typename E1::value_type, T>::value &&
+                                  boost::is_same<typename E2::value_type, T>::value> is_dense;
+        return simd_element_prod (e1, i, e2, j, t, is_dense ());
+    }
+
+}}}}
+
+#endif
@@ -0,0 +1,219 @@
+//
+//  Copyright (c) 2017
+//  uBLAS developers
+//
+//  Distributed under the Boost Software License, Version 1.0. (See
+//  accompanying file LICENSE_1_0.txt or copy at
+//  http://www.boost.org/LICENSE_1_0.txt)
+//
+
+// Vector kernels shared by all instruction sets.
+//
+// There is deliberately no include guard: simd.hpp includes this file once per
+// instruction set, inside a namespace that provides ops<T> for float and double
+// and under the matching target options, so that every copy is compiled for
+// its own instruction set.
+//
+// ops<T> supplies the register type reg, the number of elements per register
+// width and the operations zero, set1, set_pair (a0, a1, a0, a1, ...), load,
+// store (both unaligned), load_aligned, store_aligned, add, mul, fmadd
+// (a * b + c) and swap_pairs, which exchanges the real and imaginary parts of
+// interleaved complex numbers.
+
+    // Register loads and stores of the kernels on the elements of containers,
+    // aligned_access when the caller knows that every vector starts at a
+    // multiple of the register width in bytes
+    template<class T>
+    struct unaligned_access {
+        static inline typename ops<T>::reg load (const T *p) { return ops<T>::load (p); }
+        static inline void store (T *p, typename ops<T>::reg a) { ops<T>::store (p, a); }
+    };
+    template<class T>
+    struct aligned_access {
+        static inline typename ops<T>::reg load (const T *p) { return ops<T>::load_aligned (p); }
+        static inline void store (T *p, typename ops<T>::reg a) { ops<T>::store_aligned (p, a); }
+    };
+
+    template<class T>
+    inline T horizontal_sum (typename ops<T>::reg r) {
+        T buffer [ops<T>::width];
+        ops<T>::store (buffer, r);
+        T t = T ();
+        for (std::size_t i = 0; i < std::size_t (ops<T>::width); ++ i)
+            t += buffer [i];
+        return t;
+    }
+
+    // x^T y
+    template<template<class> class A, class T>
+    inline T dot (std::size_t n, const T *x, const T *y) {
+        typedef ops<T> o;
+        typedef A<T> access;
+        const std::size_t w = o::width;
+        typename o::reg acc0 = o::zero (), acc1 = o::zero ();
+        std::size_t i = 0;
+        for (; i + 2 * w <= n; i += 2 * w) {
+            acc0 = o::fmadd (access::load (x + i), access::load (y + i), acc0);
+            acc1 = o::fmadd (access::load (x + i + w), access::load (y + i + w), acc1);
+        }
+        if (i + w <= n) {
+            acc0 = o::fmadd (access::load (x + i), access::load (y + i), acc0);
+            i += w;
+        }
+        T t = horizontal_sum<T> (o::add (acc0, acc1));
+        for (; i < n; ++ i)
+            t += x [i] * y [i];
+        return t;
+    }
+
+    // x^T x
+    template<template<class> class A, class T>
+    inline T sum_squares (std::size_t n, const T *x) {
+        typedef ops<T> o;
+        typedef A<T> access;
+        const std::size_t w = o::width;
+        typename o::reg acc0 = o::zero (), acc1 = o::zero ();
+        std::size_t i = 0;
+        for (; i + 2 * w <= n; i += 2 * w) {
+            typename o::reg x0 = access::load (x + i), x1 = access::load (x + i + w);
+            acc0 = o::fmadd (x0, x0, acc0);
+            acc1 = o::fmadd (x1, x1, acc1);
+        }
+        if (i + w <= n) {
+            typename o::reg x0 = access::load (x + i);
+            acc0 = o::fmadd (x0, x0, acc0);
+            i += w;
+        }
+        T t = horizontal_sum<T> (o::add (acc0, acc1));
+        for (; i < n; ++ i)
+            t += x [i] * x [i];
+        return t;
+    }
+
+    // y += a x
+    template<template<class> class A, class T>
+    inline void axpy (std::size_t n, T a, const T *x, T *y) {
+        typedef ops<T> o;
+        typedef A<T> access;
+        const std::size_t w = o::width;
+        const typename o::reg va = o::set1 (a);
+        std::size_t i = 0;
+        for (; i + w <= n; i += w)
+            access::store (y + i, o::fmadd (va, access::load (x + i), access::load (y + i)));
+        for (; i < n; ++ i)
+            y [i] += a * x [i];
+    }
+
+    // x^T y for n / 2 interleaved complex numbers (no conjugation)
+    template<template<class> class A, class T>
+    inline void complex_dot (std::size_t n, const T *x, const T *y, T &re, T &im) {
+        typedef ops<T> o;
+        typedef A<T> access;
+        const std::size_t w = o::width;
+        // Products of equal parts (xr yr, xi yi) and of crossed parts (xr yi, xi yr)
+        typename o::reg equal = o::zero (), crossed = o::zero ();
+        std::size_t i = 0;
+        for (; i + w <= n; i += w) {
+            const typename o::reg xv = access::load (x + i), yv = access::load (y + i);
+            equal = o::fmadd (xv, yv, equal);
+            crossed = o::fmadd (xv, o::swap_pairs (yv), crossed);
+        }
+        T equal_parts [o::width];
+        o::store (equal_parts, equal);
+        re = T ();
+        for (std::size_t j = 0; j < w; j += 2)
+            re += equal_parts [j] - equal_parts [j + 1];
+        im = horizontal_sum<T> (crossed);
+        for (; i < n; i += 2) {
+            re += x [i] * y [i] - x [i + 1] * y [i + 1];
+            im += x [i] * y [i + 1] + x [i + 1] * y [i];
+        }
+    }
+
+    // y += (ar + i ai) x for n / 2 interleaved complex numbers
+    template<template<class> class A, class T>
+    inline void complex_axpy (std::size_t n, T ar, T ai, const T *x, T *y) {
+        typedef ops<T> o;
+        typedef A<T> access;
+        const std::size_t w = o::width;
+        const typename o::reg var = o::set1 (ar), vai = o::set_pair (- ai, ai);
+        std::size_t i = 0;
+        for (; i + w <= n; i += w) {
+            const typename o::reg xv = access::load (x + i);
+            access::store (y + i, o::fmadd (var, xv, o::fmadd (vai, o::swap_pairs (xv), access::load (y + i))));
+        }
+        for (; i < n; i += 2) {
+            y [i] += ar * x [i] - ai * x [i + 1];
+            y [i + 1] += ar * x [i + 1] + ai * x [i];
+        }
+    }
+
+    // acc [(c - first) C + r] = sum over k of val [ptr [c] + k C + r] x [idx [ptr [c] + k C + r]]
+    // for the chunks [first, last) of a sliced ELLPACK matrix of chunk height C,
+    // see sliced_ell_matrix. Returns false, and does nothing, unless C is a
+    // multiple of the register width.
+    template<std::size_t C, class T>
+    inline bool sell_chunks (std::size_t, std::size_t, const std::size_t *,
+                             const std::size_t *, const T *, const T *, T *, boost::mpl::false_) {
+        return false;
+    }
+    template<std::size_t C, class T>
+    inline bool sell_chunks (std::size_t first, std::size_t last, const std::size_t *ptr,
+                             const std::size_t *idx, const T *val, const T *x, T *acc, boost::mpl::true_) {
+        typedef ops<T> o;
+        const std::size_t w = o::width;
+        const std::size_t nv = C / w;
+        for (std::size_t c = first; c < last; ++ c, acc += C) {
+            typename o::reg t [nv];
+            for (std::size_t j = 0; j < nv; ++ j)
+                t [j] = o::zero ();
+            for (std::size_t p = ptr [c]; p < ptr [c + 1]; p += C)
+                for (std::size_t j = 0; j < nv; ++ j)
+                    t [j] = o::fmadd (o::load (val + p + j * w), o::gather (x, idx + p + j * w), t [j]);
+            for (std::size_t j = 0; j < nv; ++ j)
+                o::store (acc + j * w, t [j]);
+        }
+        return true;
+    }
+    template<std::size_t C, class T>
+    inline bool sell_chunks (std::size_t first, std::size_t last, const std::size_t *ptr,
+                             const std::size_t *idx, const T *val, const T *x, T *acc) {
+        return sell_chunks<C> (first, last, ptr, idx, val, x, acc,
+                               boost::mpl::bool_<C % ops<T>::width == 0> ());
+    }
+
+    // ab (MR x NR, row major) = ap bp for packed slivers of depth kc, see gemm.hpp.
+    // Returns false, and does nothing, unless NR is a multiple of the register
+    // width.
+    template<std::size_t MR, std::size_t NR, class T>
+    inline bool gemm_tile (std::size_t, const T *, const T *, T *, boost::mpl::false_) {
+        return false;
+    }
+    template<std::size_t MR, std::size_t NR, class T>
+    inline bool gemm_tile (std::size_t kc, const T *ap, const T *bp, T *ab, boost::mpl::true_) {
+        typedef ops<T> o;
+        const std::size_t w = o::width;
+        const std::size_t nv = NR / w;
+        typename o::reg c [MR] [nv];
+        for (std::size_t i = 0; i < MR; ++ i)
+            for (std::size_t j = 0; j < nv; ++ j)
+                c [i] [j] = o::zero ();
+        for (std::size_t p = 0; p < kc; ++ p, ap += MR, bp += NR) {
+            typename o::reg b [nv];
+            for (std::size_t j = 0; j < nv; ++ j)
+                b [j] = o::load (bp + j * w);
+            for (std::size_t i = 0; i < MR; ++ i) {
+                const typename o::reg a = o::set1 (ap [i]);
+                for (std::size_t j = 0; j < nv; ++ j)
+                    c [i] [j] = o::fmadd (a, b [j], c [i] [j]);
+            }
+        }
+        for (std::size_t i = 0; i < MR; ++ i)
+            for (std::size_t j = 0; j < nv; ++ j)
+                o::store (ab + i * NR + j * w, c [i] [j]);
+        return true;
+    }
+    template<std::size_t MR, std::size_t NR, class T>
+    inline bool gemm_tile (std::size_t kc, const T *ap, const T *bp, T *ab) {
+        return gemm_tile<MR, NR> (kc, ap, bp, ab, boost::mpl::bool_<NR % ops<T>::width == 0> ());
+    }
@@ -0,0 +1,276 @@
+//
+//  Copyright (c) 2017
+//  uBLAS developers
+//
+//  Distributed under the Boost Software License, Version 1.0. (See
+//  accompanying file LICENSE_1_0.txt or copy at
+//  http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#ifndef _BOOST_UBLAS_SPGEMM_
+#define _BOOST_UBLAS_SPGEMM_
+
+#include <algorithm>
+#include <cstddef>
+#include <vector>
+
+#include <boost/numeric/ublas/functional.hpp>
+#include <boost/numeric/ublas/matrix_expression.hpp>
+#include <boost/numeric/ublas/detail/config.hpp>
+#include <boost/numeric/ublas/detail/matrix_assign.hpp>
+#include <boost/numeric/ublas/detail/spmv.hpp>
+#include <boost/numeric/ublas/detail/thread_pool.hpp>
+#include <boost/numeric/ublas/detail/workspace.hpp>
+
+// Sparse matrix products C = A B of compressed matrices (Gustavson).
+//
+// Row i of C is the sum of the rows k of B scaled by the elements (i, k) of
+// A. A symbolic pass counts the distinct columns of each row of C, marking
+// the columns seen in an array indexed by column, so that the arrays of C
+// are allocated once and exactly; a numeric pass then accumulates each row
+// in a dense accumulator and writes it, sorted, to its place in C. Both
+// passes split the rows across the thread pool in ranges of equal numbers
+// of multiply-adds, each thread with an accumulator of its own. Matrices
+// stored by columns multiply as C^T = B^T A^T.
+
+namespace boost { namespace numeric { namespace ublas { namespace detail {
+
+    // Whether the product keeps the element of major index k and minor index
+    // l: all of them, or those of the triangle of the restriction TRI
+    template<class L, class TRI>
+    struct spgemm_restriction {
+        static BOOST_UBLAS_INLINE
+        bool other (std::size_t k, std::size_t l) {
+            return TRI::other (L::index_M (k, l), L::index_m (k, l));
+        }
+    };
+    template<class L>
+    struct spgemm_restriction<L, full> {
+        static BOOST_UBLAS_INLINE
+        bool other (std::size_t, std::size_t) {
+            return true;
+        }
+    };
+
+    // Multiply-adds of the rows before each row of A B, cost [0] = 0
+    template<class T, class I>
+    void spgemm_cost (const compressed_arrays<T, I> &a, const compressed_arrays<T, I> &b, std::size_t *cost) {
+        cost [0] = 0;
+        for (std::size_t i = 0; i < a.size_major; ++ i) {
+            std::size_t c = 0;
+            for (std::size_t p = a.begin (i), end = a.begin (i + 1); p < end; ++ p) {
+                const std::size_t k = a.idx [p];
+                c += b.begin (k + 1) - b.begin (k);
+            }
+            cost [i + 1] = cost [i] + c;
+        }
+    }
+
+    // Row at which part p of parts starts
+    inline std::size_t spgemm_split (const std::size_t *cost, std::size_t rows, std::size_t p, std::size_t parts) {
+        if (p >= parts)
+            return rows;
+        const std::size_t target = cost [rows] / parts * p + cost [rows] % parts * p / parts;
+        return std::size_t (std::lower_bound (cost, cost + rows + 1, target) - cost);
+    }
+
+    // Number of elements of the rows [first, last) of A B into count,
+    // marker holding b.size_minor entries
+    template<class R, class T, class I>
+    void spgemm_count (const compressed_arrays<T, I> &a, const compressed_arrays<T, I> &b,
+                       std::size_t first, std::size_t last, std::size_t *count, std::size_t *marker) {
+        std::fill (marker, marker + b.size_minor, std::size_t (-1));
+        for (std::size_t i = first; i < last; ++ i) {
+            std::size_t n = 0;
+            for (std::size_t p = a.begin (i), end = a.begin (i + 1); p < end; ++ p) {
+                const std::size_t k = a.idx [p];
+                for (std::size_t q = b.begin (k), end_k = b.begin (k + 1); q < end_k; ++ q) {
+                    const std::size_t j = b.idx [q];
+                    if (marker [j] != i && R::other (i, j)) {
+                        marker [j] = i;
+                        ++ n;
+                    }
+                }
+            }
+            count [i] = n;
+        }
+    }
+
+    // The rows [first, last) of A B into the arrays of C, whose ptr is set;
+    // returns the number of elements that summed to zero, which are left in
+    // place with their values
+    template<class R, class T, class I>
+    std::size_t spgemm_fill (const compressed_arrays<T, I> &a, const compressed_arrays<T, I> &b,
+                             std::size_t first, std::size_t last, const I *ptr, I *idx, T *val,
+                             std::size_t *marker, T *accumulator) {
+        std::fill (marker, marker + b.size_minor, std::size_t (-1));
+        std::size_t zeros = 0;
+        for (std::size_t i = first; i < last; ++ i) {
+            I *row = idx + ptr [i], *end_row = row;
+            for (std::size_t p = a.begin (i), end = a.begin (i + 1); p < end; ++ p) {
+                const std::size_t k = a.idx [p];
+                const T t = a.val [p];
+                for (std::size_t q = b.begin (k), end_k = b.begin (k + 1); q < end_k; ++ q) {
+                    const std::size_t j = b.idx [q];
+                    if (marker [j] == i)
+                        accumulator [j] += t * b.val [q];
+                    else if (R::other (i, j)) {
+                        marker [j] = i;
+                        accumulator [j] = t * b.val [q];
+                        *end_row ++ = I (j);
+                    }
+                }
+            }
+            std::sort (row, end_row);
+            for (std::size_t q = ptr [i]; q < std::size_t (ptr [i + 1]); ++ q) {
+                val [q] = accumulator [idx [q]];
+                if (val [q] == T ())
+                    ++ zeros;
+            }
+        }
+        return zeros;
+    }
+
+    template<class R, class T, class I>
+    class spgemm_parts {
+    public:
+        BOOST_UBLAS_INLINE
+        spgemm_parts (const compressed_arrays<T, I> &a, const compressed_arrays<T, I> &b,
+                      const std::size_t *cost, std::size_t parts,
+                      std::size_t *count, const I *ptr, I *idx, T *val, std::size_t *zeros):
+            a_ (&a), b_ (&b), cost_ (cost), parts_ (parts),
+            count_ (count), ptr_ (ptr), idx_ (idx), val_ (val), zeros_ (zeros) {}
+
+        // Parts [first, last), counting when ptr is null and filling otherwise
+        void operator () (std::size_t first, std::size_t last) const {
+            workspace<std::size_t> marker (b_->size_minor);
+            workspace<T> accumulator (ptr_ ? b_->size_minor : 0);
+            for (std::size_t p = first; p < last; ++ p) {
+                const std::size_t begin = spgemm_split (cost_, a_->size_major, p, parts_);
+                const std::size_t end = spgemm_split (cost_, a_->size_major, p + 1, parts_);
+                if (! ptr_)
+                    spgemm_count<R> (*a_, *b_, begin, end, count_, marker.data ());
+                else
+                    zeros_ [p] = spgemm_fill<R> (*a_, *b_, begin, end, ptr_, idx_, val_,
+                                                 marker.data (), accumulator.data ());
+            }
+        }
+
+    private:
+        const compressed_arrays<T, I> *a_, *b_;
+        const std::size_t *cost_;
+        std::size_t parts_;
+        std::size_t *count_;
+        const I *ptr_;
+        I *idx_;
+        T *val_;
+        std::size_t *zeros_;
+    };
+
+    // c = a b restricted to TRI, all three stored in the same orientation;
+    // elements summing to zero are not stored
+    template<class TRI, class T, class L, class IA, class TA>
+    void spgemm (const compressed_matrix<T, L, 0, IA, TA> &a, const compressed_matrix<T, L, 0, IA, TA> &b,
+                 compressed_matrix<T, L, 0, IA, TA> &c) {
+        typedef typename IA::value_type index_type;
+        typedef spgemm_restriction<L, TRI> restriction;
+        BOOST_UBLAS_CHECK (a.size2 () == b.size1 (), bad_size ());
+        // By rows C = A B, by columns C^T = B^T A^T
+        const bool by_rows = boost::is_same<typename L::orientation_category, row_major_tag>::value;
+        const compressed_arrays<T, index_type> left (make_compressed_arrays (by_rows ? a : b));
+        const compressed_arrays<T, index_type> right (make_compressed_arrays (by_rows ? b : a));
+        const std::size_t rows = left.size_major;
+
+        std::vector<std::size_t> cost (rows + 1);
+        spgemm_cost (left, right, &cost [0]);
+        thread_pool &pool = thread_pool::instance ();
+        const bool threads = pool.size () > 1 && cost [rows] >= std::size_t (BOOST_UBLAS_SPARSE_PARALLEL_NNZ);
+        const std::size_t parts = threads ? (std::min) (pool.size (), rows) : 1;
+
+        // Symbolic pass
+        std::vector<std::size_t> count (rows + 1);
+        pool.parallel_for (0, parts, 1, spgemm_parts<restriction, T, index_type> (
+            left, right, &cost [0], parts, &count [0], 0, 0, 0, 0));
+        std::size_t nnz = 0;
+        for (std::size_t i = 0; i < rows; ++ i)
+            nnz += count [i];
+
+        // Numeric pass into arrays of the exact size
+        compressed_matrix<T, L, 0, IA, TA> r (a.size1 (), b.size2 (), nnz);
+        index_type *ptr = &r.index1_data () [0];
+        ptr [0] = 0;
+        for (std::size_t i = 0; i < rows; ++ i)
+            ptr [i + 1] = index_type (ptr [i] + count [i]);
+        index_type *idx = nnz == 0 ? 0 : &r.index2_data () [0];
+        T *val = nnz == 0 ? 0 : &r.value_data () [0];
+        std::vector<std::size_t> zeros (parts);
+        pool.parallel_for (0, parts, 1, spgemm_parts<restriction, T, index_type> (
+            left, right, &cost [0], parts, 0, ptr, idx, val, &zeros [0]));
+
+        // Cancellations are rare: squeeze them out in a serial pass
+        std::size_t zero_count = 0;
+        for (std::size_t p = 0; p < parts; ++ p)
+            zero_count += zeros [p];
+        if (zero_count > 0) {
+            std::size_t q = 0, begin = 0;
+            for (std::size_t i = 0; i < rows; ++ i) {
+                const std::size_t end = ptr [i + 1];
+                for (std::size_t p = begin; p < end; ++ p)
+                    if (val [p] != T ()) {
+                        idx [q] = idx [p];
+                        val [q] = val [p];
+                        ++ q;
+                    }
+                begin = end;
+                ptr [i + 1] = index_type (q);
+            }
+            nnz = q;
+        }
+        r.set_filled (rows + 1, nnz);
+        c.assign_temporary (r);
+    }
+
+    // Operands the kernel does not take
+    template<class TRI, class E1, class E2, class M>
+    BOOST_UBLAS_INLINE
+    bool spgemm_assign (const E1 &, const E2 &, M &) {
+        return false;
+    }
+    template<class TRI, class T, class L, class IA, class TA>
+    BOOST_UBLAS_INLINE
+    bool spgemm_assign (const compressed_matrix<T, L, 0, IA, TA> &a, const compressed_matrix<T, L, 0, IA, TA> &b,
+                        compressed_matrix<T, L, 0, IA, TA> &c) {
+        spgemm<TRI> (a, b, c);
+        return true;
+    }
+
+    // prod (A, B) of compressed matrices assigned to one stored alike; any
+    // other assignment than m = prod (A, B) adds a temporary product
+    template<class T, class L, class IA, class TA, class F>
+    struct matrix_assign_kernel<matrix_matrix_binary<compressed_matrix<T, L, 0, IA, TA>,
+                                                     compressed_matrix<T, L, 0, IA, TA>, F> > {
+        typedef compressed_matrix<T, L, 0, IA, TA> matrix_type;
+
+        template<template <class T1, class T2> class G, class M>
+        static BOOST_UBLAS_INLINE
+        bool apply (M &, const matrix_matrix_binary<matrix_type, matrix_type, F> &) {
+            return false;
+        }
+        template<template <class T1, class T2> class G>
+        static BOOST_UBLAS_INLINE
+        bool apply (matrix_type &m, const matrix_matrix_binary<matrix_type, matrix_type, F> &e) {
+            BOOST_UBLAS_CHECK (m.size1 () == e.size1 (), bad_size ());
+            BOOST_UBLAS_CHECK (m.size2 () == e.size2 (), bad_size ());
+            matrix_type r (e.size1 (), e.size2 ());
+            spgemm<full> (e.expression1 ().expression (), e.expression2 ().expression (), r);
+            if (boost::is_same<G<T, T>, scalar_assign<T, T> >::value)
+                m.assign_temporary (r);
+            else
+                matrix_assign<G> (m, r);
+            return true;
+        }
+    };
+
+}}}}
+
+#endif
@@ -0,0 +1,777 @@
+//
+//  Copyright (c) 2017
+//  uBLAS developers
+//
+//  Distributed under the Boost Software License, Version 1.0. (See
+//  accompanying file LICENSE_1_0.txt or copy at
+//  http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#ifndef _BOOST_UBLAS_SPMV_
+#define _BOOST_UBLAS_SPMV_
+
+#include <algorithm>
+#include <cstddef>
+
+#include <boost/mpl/bool.hpp>
+#include <boost/type_traits/is_same.hpp>
+#include <boost/numeric/ublas/matrix_expression.hpp>
+#include <boost/numeric/ublas/detail/config.hpp>
+#include <boost/numeric/ublas/detail/dense_traits.hpp>
+#include <boost/numeric/ublas/detail/matrix_assign.hpp>
+#include <boost/numeric/ublas/detail/simd.hpp>
+#include <boost/numeric/ublas/detail/thread_pool.hpp>
+#include <boost/numeric/ublas/detail/vector_assign.hpp>
+#include <boost/numeric/ublas/detail/workspace.hpp>
+
+// Sparse matrix-vector products y = beta y + alpha A x and y = beta y +
+// alpha A^T x on the arrays of compressed_matrix.
+//
+// A row major (CSR) matrix, or a column major (CSC) one transposed, yields
+// one element of y per stored row: these gathers split the rows across the
+// thread pool in ranges holding equal numbers of stored elements, so that a
+// few long rows do not leave threads idle. The two other cases scatter each
+// stored column into y; large scatters accumulate into one buffer per thread
+// and sum the buffers afterwards, which needs no synchronisation.
+//
+// sliced_ell_matrix products run chunk by chunk, the rows of a chunk side by
+// side in SIMD registers, with the same split of the chunks across threads.
+// block_compressed_matrix products multiply whole blocks, of a size fixed at
+// compile time, with a vector or with strips of the columns of a matrix.
+
+namespace boost { namespace numeric { namespace ublas { namespace detail {
+
+    // The arrays of a compressed matrix with index base 0: the elements of
+    // the major index k are val [ptr [k] .. ptr [k + 1]) with minor indices
+    // idx [ptr [k] .. ptr [k + 1]). Major indices from filled on are empty.
+    template<class T, class I>
+    struct compressed_arrays {
+        std::size_t size_major, size_minor, filled;
+        const I *ptr;
+        const I *idx;
+        const T *val;
+
+        // Start of the elements of k, 0 <= k <= size_major
+        BOOST_UBLAS_INLINE
+        std::size_t begin (std::size_t k) const {
+            return std::size_t (ptr [(std::min) (k, filled)]);
+        }
+        BOOST_UBLAS_INLINE
+        std::size_t nnz () const {
+            return std::size_t (ptr [filled]);
+        }
+    };
+
+    template<class A>
+    BOOST_UBLAS_INLINE
+    const typename A::value_type *compressed_array_data (const A &a) {
+        return a.size () == 0 ? 0 : &a [0];
+    }
+
+    template<class T, class L, class IA, class TA>
+    BOOST_UBLAS_INLINE
+    compressed_arrays<T, typename IA::value_type> make_compressed_arrays (const compressed_matrix<T, L, 0, IA, TA> &m) {
+        compressed_arrays<T, typename IA::value_type> a;
+        a.size_major = L::size_M (m.size1 (), m.size2 ());
+        a.size_minor = L::size_m (m.size1 (), m.size2 ());
+        a.filled = std::size_t (m.filled1 ()) - 1;
+        a.ptr = compressed_array_data (m.index1_data ());
+        a.idx = compressed_array_data (m.index2_data ());
+        a.val = compressed_array_data (m.value_data ());
+        return a;
+    }
+
+    // Major index at which part p of parts starts, the parts holding equal
+    // numbers of stored elements
+    template<class T, class I>
+    BOOST_UBLAS_INLINE
+    std::size_t compressed_split (const compressed_arrays<T, I> &a, std::size_t p, std::size_t parts) {
+        if (p >= parts)
+            return a.size_major;
+        const std::size_t target = a.nnz () / parts * p + a.nnz () % parts * p / parts;
+        return std::size_t (std::lower_bound (a.ptr, a.ptr + a.filled + 1, I (target)) - a.ptr);
+    }
+
+    // y (k) = beta y (k) + alpha (A x) (k) for the major indices [first, last)
+    template<class T, class I>
+    void compressed_gather (const compressed_arrays<T, I> &a, std::size_t first, std::size_t last,
+                            const T &alpha, const T &beta, const T *x, T *y) {
+        for (std::size_t k = first; k < last; ++ k) {
+            T t = T ();
+            for (std::size_t p = a.begin (k), end = a.begin (k + 1); p < end; ++ p)
+                t += a.val [p] * x [a.idx [p]];
+            y [k] = beta == T () ? alpha * t : beta * y [k] + alpha * t;
+        }
+    }
+
+    // z += alpha A^T x restricted to the major indices [first, last)
+    template<class T, class I>
+    void compressed_scatter (const compressed_arrays<T, I> &a, std::size_t first, std::size_t last,
+                             const T &alpha, const T *x, T *z) {
+        for (std::size_t k = first; k < last; ++ k) {
+            const T t = alpha * x [k];
+            for (std::size_t p = a.begin (k), end = a.begin (k + 1); p < end; ++ p)
+                z [a.idx [p]] += a.val [p] * t;
+        }
+    }
+
+    template<class T, class I>
+    class compressed_gather_parts {
+    public:
+        BOOST_UBLAS_INLINE
+        compressed_gather_parts (const compressed_arrays<T, I> &a, std::size_t parts,
+                                 const T &alpha, const T &beta, const T *x, T *y):
+            a_ (&a), parts_ (parts), alpha_ (alpha), beta_ (beta), x_ (x), y_ (y) {}
+
+        // Parts [first, last)
+        BOOST_UBLAS_INLINE
+        void operator () (std::size_t first, std::size_t last) const {
+            compressed_gather (*a_, compressed_split (*a_, first, parts_), compressed_split (*a_, last, parts_),
+                               alpha_, beta_, x_, y_);
+        }
+
+    private:
+        const compressed_arrays<T, I> *a_;
+        std::size_t parts_;
+        T alpha_, beta_;
+        const T *x_;
+        T *y_;
+    };
+
+    // Each part scatters into its own buffer of size_minor elements
+    template<class T, class I>
+    class compressed_scatter_parts {
+    public:
+        BOOST_UBLAS_INLINE
+        compressed_scatter_parts (const compressed_arrays<T, I> &a, std::size_t parts, const T *x, T *buffers):
+            a_ (&a), parts_ (parts), x_ (x), buffers_ (buffers) {}
+
+        BOOST_UBLAS_INLINE
+        void operator () (std::size_t first, std::size_t last) const {
+            for (std::size_t p = first; p < last; ++ p) {
+                T *z = buffers_ + p * a_->size_minor;
+                std::fill (z, z + a_->size_minor, T ());
+                compressed_scatter (*a_, compressed_split (*a_, p, parts_), compressed_split (*a_, p + 1, parts_),
+                                    T (1), x_, z);
+            }
+        }
+
+    private:
+        const compressed_arrays<T, I> *a_;
+        std::size_t parts_;
+        const T *x_;
+        T *buffers_;
+    };
+
+    // y (i) = beta y (i) + alpha sum of the buffers (i) over [first, last)
+    template<class T>
+    class compressed_reduce {
+    public:
+        BOOST_UBLAS_INLINE
+        compressed_reduce (std::size_t size, std::size_t parts, const T &alpha, const T &beta, const T *buffers, T *y):
+            size_ (size), parts_ (parts), alpha_ (alpha), beta_ (beta), buffers_ (buffers), y_ (y) {}
+
+        BOOST_UBLAS_INLINE
+        void operator () (std::size_t first, std::size_t last) const {
+            for (std::size_t i = first; i < last; ++ i) {
+                T t = T ();
+                for (std::size_t p = 0; p < parts_; ++ p)
+                    t += buffers_ [p * size_ + i];
+                y_ [i] = beta_ == T () ? alpha_ * t : beta_ * y_ [i] + alpha_ * t;
+            }
+        }
+
+    private:
+        std::size_t size_, parts_;
+        T alpha_, beta_;
+        const T *buffers_;
+        T *y_;
+    };
+
+    // y = beta y + alpha A x, or alpha A^T x when transposed, where A is
+    // stored by rows; for a matrix stored by columns the roles swap
+    template<class T, class I>
+    void compressed_prod (const compressed_arrays<T, I> &a, bool transposed,
+                          const T &alpha, const T &beta, const T *x, T *y) {
+        thread_pool &pool = thread_pool::instance ();
+        const std::size_t nnz = a.nnz ();
+        const bool threads = pool.size () > 1 && nnz >= std::size_t (BOOST_UBLAS_SPARSE_PARALLEL_NNZ);
+        if (! transposed) {
+            const std::size_t parts = threads ? pool.size () : 1;
+            pool.parallel_for (0, parts, 1, compressed_gather_parts<T, I> (a, parts, alpha, beta, x, y));
+            return;
+        }
+        // The buffers cost as much as the products once they outnumber the
+        // stored elements
+        const std::size_t parts = threads ? (std::min) (pool.size (), nnz / (std::max) (a.size_minor, std::size_t (1))) : 1;
+        if (parts <= 1) {
+            if (beta == T ())
+                std::fill (y, y + a.size_minor, T ());
+            else if (beta != T (1))
+                for (std::size_t i = 0; i < a.size_minor; ++ i)
+                    y [i] *= beta;
+            compressed_scatter (a, 0, a.size_major, alpha, x, y);
+            return;
+        }
+        workspace<T> buffers (parts * a.size_minor);
+        pool.parallel_for (0, parts, 1, compressed_scatter_parts<T, I> (a, parts, x, buffers.data ()));
+        pool.parallel_for (0, a.size_minor, (a.size_minor + pool.size () - 1) / pool.size (),
+                           compressed_reduce<T> (a.size_minor, parts, alpha, beta, buffers.data (), y));
+    }
+
+    // Raw elements of the vector operand x, copied when it has no dense
+    // storage of the matrix's value type
+    template<class T, class E>
+    BOOST_UBLAS_INLINE
+    const T *compressed_operand (const E &e, workspace<T> &, boost::mpl::true_) {
+        return dense_vector_traits<E>::data (e);
+    }
+    template<class T, class E>
+    BOOST_UBLAS_INLINE
+    const T *compressed_operand (const E &e, workspace<T> &copy, boost::mpl::false_) {
+        for (std::size_t i = 0; i < e.size (); ++ i)
+            copy.data () [i] = e (i);
+        return copy.data ();
+    }
+
+    template<template <class T1, class T2> class F, class V, class M, class E>
+    BOOST_UBLAS_INLINE
+    bool compressed_prod_assign (V &, const M &, bool, const E &, boost::mpl::false_) {
+        return false;
+    }
+    template<template <class T1, class T2> class F, class V, class M, class E>
+    BOOST_UBLAS_INLINE
+    bool compressed_prod_assign (V &v, const M &m, bool transposed, const E &e, boost::mpl::true_) {
+        typedef typename M::value_type value_type;
+        typedef assign_scale_traits<F> assign_traits;
+        typedef boost::mpl::bool_<dense_vector_traits<E>::value &&
+                                  boost::is_same<typename E::value_type, value_type>::value> is_dense;
+        BOOST_UBLAS_CHECK (v.size () == (transposed ? m.size2 () : m.size1 ()), bad_size ());
+        BOOST_UBLAS_CHECK (e.size () == (transposed ? m.size1 () : m.size2 ()), bad_size ());
+        const compressed_arrays<value_type, typename M::index_array_type::value_type> a (make_compressed_arrays (m));
+        workspace<value_type> copy (is_dense::value ? 0 : e.size ());
+        const value_type *x = compressed_operand (e, copy, is_dense ());
+        // A column major matrix holds its transpose by rows
+        const bool by_columns = boost::is_same<typename M::orientation_category, column_major_tag>::value;
+        compressed_prod (a, transposed != by_columns,
+                         value_type (assign_traits::alpha), value_type (assign_traits::beta),
+                         x, dense_vector_traits<V>::data (v));
+        return true;
+    }
+
+    // v = beta v + alpha m e, or alpha m^T e when transposed, for the
+    // assignments F that fold into that form and a dense v of the matrix's
+    // value type. Returns false, without touching v, otherwise.
+    template<template <class T1, class T2> class F, class V, class M, class E>
+    BOOST_UBLAS_INLINE
+    bool compressed_prod_assign (V &v, const M &m, bool transposed, const E &e) {
+        typedef boost::mpl::bool_<assign_scale_traits<F>::value && dense_vector_traits<V>::value &&
+                                  boost::is_same<typename V::value_type, typename M::value_type>::value> is_dense;
+        return compressed_prod_assign<F> (v, m, transposed, e, is_dense ());
+    }
+
+    // prod (A, x)
+    template<class T, class L, class IA, class TA, class E2, class F>
+    struct vector_assign_kernel<matrix_vector_binary1<compressed_matrix<T, L, 0, IA, TA>, E2, F> > {
+        template<template <class T1, class T2> class G, class V>
+        static BOOST_UBLAS_INLINE
+        bool apply (V &v, const matrix_vector_binary1<compressed_matrix<T, L, 0, IA, TA>, E2, F> &e) {
+            return compressed_prod_assign<G> (v, e.expression1 ().expression (), false, e.expression2 ());
+        }
+    };
+    // prod (trans (A), x)
+    template<class T, class L, class IA, class TA, class E2, class F>
+    struct vector_assign_kernel<matrix_vector_binary1<matrix_unary2<const compressed_matrix<T, L, 0, IA, TA>,
+                                                                    scalar_identity<T> >, E2, F> > {
+        template<template <class T1, class T2> class G, class V>
+        static BOOST_UBLAS_INLINE
+        bool apply (V &v, const matrix_vector_binary1<matrix_unary2<const compressed_matrix<T, L, 0, IA, TA>,
+                                                                    scalar_identity<T> >, E2, F> &e) {
+            return compressed_prod_assign<G> (v, e.expression1 ().expression ().expression (), true, e.expression2 ());
+        }
+    };
+    template<class T, class L, class IA, class TA, class E2, class F>
+    struct vector_assign_kernel<matrix_vector_binary1<matrix_unary2<compressed_matrix<T, L, 0, IA, TA>,
+                                                                    scalar_identity<T> >, E2, F> > {
+        template<template <class T1, class T2> class G, class V>
+        static BOOST_UBLAS_INLINE
+        bool apply (V &v, const matrix_vector_binary1<matrix_unary2<compressed_matrix<T, L, 0, IA, TA>,
+                                                                    scalar_identity<T> >, E2, F> &e) {
+            return compressed_prod_assign<G> (v, e.expression1 ().expression ().expression (), true, e.expression2 ());
+        }
+    };
+    // prod (x, A), that is A^T x
+    template<class E1, class T, class L, class IA, class TA, class F>
+    struct vector_assign_kernel<matrix_vector_binary2<E1, compressed_matrix<T, L, 0, IA, TA>, F> > {
+        template<template <class T1, class T2> class G, class V>
+        static BOOST_UBLAS_INLINE
+        bool apply (V &v, const matrix_vector_binary2<E1, compressed_matrix<T, L, 0, IA, TA>, F> &e) {
+            return compressed_prod_assign<G> (v, e.expression2 ().expression (), true, e.expression1 ());
+        }
+    };
+
+    // The arrays of a sliced ELLPACK matrix of chunk height C: chunk c holds
+    // the rows perm [c C .. (c + 1) C), its elements being
+    // val [ptr [c] .. ptr [c + 1]) column after column with the column
+    // indices idx, zeros included. Slot s stores len [s] elements.
+    template<std::size_t C, class T, class I>
+    struct sell_arrays {
+        std::size_t size1, chunks;
+        const I *ptr;
+        const I *perm;
+        const I *len;
+        const I *idx;
+        const T *val;
+
+        // Stored elements, padding included
+        BOOST_UBLAS_INLINE
+        std::size_t padded_size () const {
+            return std::size_t (ptr [chunks]);
+        }
+    };
+
+    template<class T, std::size_t C, class IA, class TA>
+    BOOST_UBLAS_INLINE
+    sell_arrays<C, T, typename IA::value_type> make_sell_arrays (const sliced_ell_matrix<T, C, IA, TA> &m) {
+        sell_arrays<C, T, typename IA::value_type> a;
+        a.size1 = m.size1 ();
+        a.chunks = m.chunks ();
+        a.ptr = compressed_array_data (m.chunk_data ());
+        a.perm = compressed_array_data (m.permutation_data ());
+        a.len = compressed_array_data (m.length_data ());
+        a.idx = compressed_array_data (m.index_data ());
+        a.val = compressed_array_data (m.value_data ());
+        return a;
+    }
+
+    // Chunk at which part p of parts starts, the parts holding equal numbers
+    // of padded elements
+    template<std::size_t C, class T, class I>
+    BOOST_UBLAS_INLINE
+    std::size_t sell_split (const sell_arrays<C, T, I> &a, std::size_t p, std::size_t parts) {
+        if (p >= parts)
+            return a.chunks;
+        const std::size_t size = a.padded_size ();
+        const std::size_t target = size / parts * p + size % parts * p / parts;
+        return std::size_t (std::lower_bound (a.ptr, a.ptr + a.chunks + 1, I (target)) - a.ptr);
+    }
+
+    // Row of slot s times x, over the stored elements only
+    template<std::size_t C, class T, class I>
+    BOOST_UBLAS_INLINE
+    T sell_row (const sell_arrays<C, T, I> &a, std::size_t s, const T *x) {
+        T t = T ();
+        for (std::size_t p = std::size_t (a.ptr [s / C]) + s % C, k = 0; k < std::size_t (a.len [s]); ++ k, p += C)
+            t += a.val [p] * x [a.idx [p]];
+        return t;
+    }
+
+    // y = beta y + alpha A x for the rows of the chunks [first, last). The
+    // chunks are multiplied a block at a time into a small buffer, which
+    // then scatters to the rows.
+    template<std::size_t C, class T, class I>
+    void sell_gather (const sell_arrays<C, T, I> &a, std::size_t first, std::size_t last,
+                      const T &alpha, const T &beta, const T *x, T *y) {
+        const std::size_t block = C < 256 ? 256 / C : 1;
+        T acc [(C < 256 ? 256 / C : 1) * C];
+        for (std::size_t c0 = first; c0 < last; c0 += block) {
+            const std::size_t c1 = (std::min) (c0 + block, last);
+            if (! simd_sell_chunks<C> (c0, c1, a.ptr, a.idx, a.val, x, acc)) {
+                for (std::size_t c = c0; c < c1; ++ c) {
+                    T *t = acc + (c - c0) * C;
+                    std::fill (t, t + C, T ());
+                    for (std::size_t p = a.ptr [c]; p < std::size_t (a.ptr [c + 1]); p += C)
+                        for (std::size_t r = 0; r < C; ++ r)
+                            t [r] += a.val [p + r] * x [a.idx [p + r]];
+                }
+            }
+            const std::size_t end = (std::min) (c1 * C, a.size1);
+            for (std::size_t s = c0 * C; s < end; ++ s) {
+                const std::size_t i = a.perm [s];
+                T &t = acc [s - c0 * C];
+                // The padding multiplies zeros by x [0], which is NaN when
+                // x [0] is infinite or NaN. Such rows are summed again over
+                // their own elements, as the compressed product does.
+                if (t != t)
+                    t = sell_row (a, s, x);
+                y [i] = beta == T () ? alpha * t : beta * y [i] + alpha * t;
+            }
+        }
+    }
+
+    template<std::size_t C, class T, class I>
+    class sell_gather_parts {
+    public:
+        BOOST_UBLAS_INLINE
+        sell_gather_parts (const sell_arrays<C, T, I> &a, std::size_t parts,
+                           const T &alpha, const T &beta, const T *x, T *y):
+            a_ (&a), parts_ (parts), alpha_ (alpha), beta_ (beta), x_ (x), y_ (y) {}
+
+        // Parts [first, last)
+        BOOST_UBLAS_INLINE
+        void operator () (std::size_t first, std::size_t last) const {
+            sell_gather (*a_, sell_split (*a_, first, parts_), sell_split (*a_, last, parts_),
+                         alpha_, beta_, x_, y_);
+        }
+
+    private:
+        const sell_arrays<C, T, I> *a_;
+        std::size_t parts_;
+        T alpha_, beta_;
+        const T *x_;
+        T *y_;
+    };
+
+    // y = beta y + alpha A x for a sliced ELLPACK matrix A
+    template<std::size_t C, class T, class I>
+    void sell_prod (const sell_arrays<C, T, I> &a, const T &alpha, const T &beta, const T *x, T *y) {
+        thread_pool &pool = thread_pool::instance ();
+        const bool threads = pool.size () > 1 && a.padded_size () >= std::size_t (BOOST_UBLAS_SPARSE_PARALLEL_NNZ);
+        const std::size_t parts = threads ? pool.size () : 1;
+        pool.parallel_for (0, parts, 1, sell_gather_parts<C, T, I> (a, parts, alpha, beta, x, y));
+    }
+
+    template<template <class T1, class T2> class F, class V, class M, class E>
+    BOOST_UBLAS_INLINE
+    bool sell_prod_assign (V &, const M &, const E &, boost::mpl::false_) {
+        return false;
+    }
+    template<template <class T1, class T2> class F, class V, class M, class E>
+    BOOST_UBLAS_INLINE
+    bool sell_prod_assign (V &v, const M &m, const E &e, boost::mpl::true_) {
+        typedef typename M::value_type value_type;
+        typedef assign_scale_traits<F> assign_traits;
+        typedef boost::mpl::bool_<dense_vector_traits<E>::value &&
+                                  boost::is_same<typename E::value_type, value_type>::value> is_dense;
+        BOOST_UBLAS_CHECK (v.size () == m.size1 (), bad_size ());
+        BOOST_UBLAS_CHECK (e.size () == m.size2 (), bad_size ());
+        workspace<value_type> copy (is_dense::value ? 0 : e.size ());
+        const value_type *x = compressed_operand (e, copy, is_dense ());
+        sell_prod (make_sell_arrays (m), value_type (assign_traits::alpha), value_type (assign_traits::beta),
+                   x, dense_vector_traits<V>::data (v));
+        return true;
+    }
+
+    // v = beta v + alpha m e for a sliced ELLPACK matrix m, the assignments
+    // F that fold into that form and a dense v of the matrix's value type.
+    // Returns false, without touching v, otherwise.
+    template<template <class T1, class T2> class F, class V, class M, class E>
+    BOOST_UBLAS_INLINE
+    bool sell_prod_assign (V &v, const M &m, const E &e) {
+        typedef boost::mpl::bool_<assign_scale_traits<F>::value && dense_vector_traits<V>::value &&
+                                  boost::is_same<typename V::value_type, typename M::value_type>::value> is_dense;
+        return sell_prod_assign<F> (v, m, e, is_dense ());
+    }
+
+    // prod (A, x)
+    template<class T, std::size_t C, class IA, class TA, class E2, class F>
+    struct vector_assign_kernel<matrix_vector_binary1<sliced_ell_matrix<T, C, IA, TA>, E2, F> > {
+        template<template <class T1, class T2> class G, class V>
+        static BOOST_UBLAS_INLINE
+        bool apply (V &v, const matrix_vector_binary1<sliced_ell_matrix<T, C, IA, TA>, E2, F> &e) {
+            return sell_prod_assign<G> (v, e.expression1 ().expression (), e.expression2 ());
+        }
+    };
+
+    // The arrays of a block compressed matrix of BR x BC blocks: the blocks
+    // of block row k are [ptr [k], ptr [k + 1]), block b in block column
+    // idx [b] with its values at val [b BR BC ..] row after row
+    template<std::size_t BR, std::size_t BC, class T, class I>
+    struct bsr_arrays {
+        std::size_t size1, size2, block_rows;
+        const I *ptr;
+        const I *idx;
+        const T *val;
+    };
+
+    template<class T, std::size_t BR, std::size_t BC, class IA, class TA>
+    BOOST_UBLAS_INLINE
+    bsr_arrays<BR, BC, T, typename IA::value_type> make_bsr_arrays (const block_compressed_matrix<T, BR, BC, IA, TA> &m) {
+        bsr_arrays<BR, BC, T, typename IA::value_type> a;
+        a.size1 = m.size1 ();
+        a.size2 = m.size2 ();
+        a.block_rows = m.block_rows ();
+        a.ptr = compressed_array_data (m.index1_data ());
+        a.idx = compressed_array_data (m.index2_data ());
+        a.val = compressed_array_data (m.value_data ());
+        return a;
+    }
+
+    // Block row at which part p of parts starts, the parts holding equal
+    // numbers of blocks
+    template<std::size_t BR, std::size_t BC, class T, class I>
+    BOOST_UBLAS_INLINE
+    std::size_t bsr_split (const bsr_arrays<BR, BC, T, I> &a, std::size_t p, std::size_t parts) {
+        if (p >= parts)
+            return a.block_rows;
+        const std::size_t size = std::size_t (a.ptr [a.block_rows]);
+        const std::size_t target = size / parts * p + size % parts * p / parts;
+        return std::size_t (std::lower_bound (a.ptr, a.ptr + a.block_rows + 1, I (target)) - a.ptr);
+    }
+
+    // y = beta y + alpha A x for the block rows [first, last). x holds
+    // whole block columns, zero padded.
+    template<std::size_t BR, std::size_t BC, class T, class I>
+    void bsr_gather (const bsr_arrays<BR, BC, T, I> &a, std::size_t first, std::size_t last,
+                     const T &alpha, const T &beta, const T *x, T *y) {
+        for (std::size_t k = first; k < last; ++ k) {
+            T t [BR];
+            for (std::size_t r = 0; r < BR; ++ r)
+                t [r] = T ();
+            for (std::size_t b = a.ptr [k]; b < std::size_t (a.ptr [k + 1]); ++ b) {
+                const T *v = a.val + b * BR * BC;
+                const T *xb = x + std::size_t (a.idx [b]) * BC;
+                for (std::size_t r = 0; r < BR; ++ r)
+                    for (std::size_t c = 0; c < BC; ++ c)
+                        t [r] += v [r * BC + c] * xb [c];
+            }
+            const std::size_t rows = (std::min) (BR, a.size1 - k * BR);
+            for (std::size_t r = 0; r < rows; ++ r) {
+                T &yr = y [k * BR + r];
+                yr = beta == T () ? alpha * t [r] : beta * yr + alpha * t [r];
+            }
+        }
+    }
+
+    // Columns of the right hand side a block row takes at a time
+    const std::size_t bsr_strip = 8;
+
+    // C = beta C + alpha A B for the block rows [first, last) and S columns
+    // from j of B and C. B holds whole block rows, zero padded.
+    template<std::size_t S, std::size_t BR, std::size_t BC, class T, class I>
+    void bsr_strip_prod (const bsr_arrays<BR, BC, T, I> &a, std::size_t first, std::size_t last, std::size_t j,
+                         const T &alpha, const T &beta,
+                         const T *b, std::ptrdiff_t b1, std::ptrdiff_t b2,
+                         T *c, std::ptrdiff_t c1, std::ptrdiff_t c2) {
+        for (std::size_t k = first; k < last; ++ k) {
+            T t [BR] [S];
+            for (std::size_t r = 0; r < BR; ++ r)
+                for (std::size_t s = 0; s < S; ++ s)
+                    t [r] [s] = T ();
+            for (std::size_t p = a.ptr [k]; p < std::size_t (a.ptr [k + 1]); ++ p) {
+                const T *v = a.val + p * BR * BC;
+                const T *bp = b + std::ptrdiff_t (std::size_t (a.idx [p]) * BC) * b1 + std::ptrdiff_t (j) * b2;
+                for (std::size_t q = 0; q < BC; ++ q, bp += b1) {
+                    T row [S];
+                    for (std::size_t s = 0; s < S; ++ s)
+                        row [s] = bp [std::ptrdiff_t (s) * b2];
+                    for (std::size_t r = 0; r < BR; ++ r)
+                        for (std::size_t s = 0; s < S; ++ s)
+                            t [r] [s] += v [r * BC + q] * row [s];
+                }
+            }
+            const std::size_t rows = (std::min) (BR, a.size1 - k * BR);
+            for (std::size_t r = 0; r < rows; ++ r)
+                for (std::size_t s = 0; s < S; ++ s) {
+                    T &cr = c [std::ptrdiff_t (k * BR + r) * c1 + std::ptrdiff_t (j + s) * c2];
+                    cr = beta == T () ? alpha * t [r] [s] : beta * cr + alpha * t [r] [s];
+                }
+        }
+    }
+
+    // Products of the block rows [first, last), by strips of columns
+    template<std::size_t BR, std::size_t BC, class T, class I>
+    void bsr_gemm (const bsr_arrays<BR, BC, T, I> &a, std::size_t first, std::size_t last, std::size_t size,
+                   const T &alpha, const T &beta,
+                   const T *b, std::ptrdiff_t b1, std::ptrdiff_t b2,
+                   T *c, std::ptrdiff_t c1, std::ptrdiff_t c2) {
+        std::size_t j = 0;
+        for (; j + bsr_strip <= size; j += bsr_strip)
+            bsr_strip_prod<bsr_strip> (a, first, last, j, alpha, beta, b, b1, b2, c, c1, c2);
+        for (; j < size; ++ j)
+            bsr_strip_prod<1> (a, first, last, j, alpha, beta, b, b1, b2, c, c1, c2);
+    }
+
+    // Threads run parts [first, last) of the block rows, for a vector or,
+    // when size is not zero, size columns of a matrix
+    template<std::size_t BR, std::size_t BC, class T, class I>
+    class bsr_parts {
+    public:
+        BOOST_UBLAS_INLINE
+        bsr_parts (const bsr_arrays<BR, BC, T, I> &a, std::size_t parts, std::size_t size,
+                   const T &alpha, const T &beta,
+                   const T *b, std::ptrdiff_t b1, std::ptrdiff_t b2,
+                   T *c, std::ptrdiff_t c1, std::ptrdiff_t c2):
+            a_ (&a), parts_ (parts), size_ (size), alpha_ (alpha), beta_ (beta),
+            b_ (b), b1_ (b1), b2_ (b2), c_ (c), c1_ (c1), c2_ (c2) {}
+
+        BOOST_UBLAS_INLINE
+        void operator () (std::size_t first, std::size_t last) const {
+            const std::size_t begin = bsr_split (*a_, first, parts_), end = bsr_split (*a_, last, parts_);
+            if (size_ == 0)
+                bsr_gather (*a_, begin, end, alpha_, beta_, b_, c_);
+            else
+                bsr_gemm (*a_, begin, end, size_, alpha_, beta_, b_, b1_, b2_, c_, c1_, c2_);
+        }
+
+    private:
+        const bsr_arrays<BR, BC, T, I> *a_;
+        std::size_t parts_, size_;
+        T alpha_, beta_;
+        const T *b_;
+        std::ptrdiff_t b1_, b2_;
+        T *c_;
+        std::ptrdiff_t c1_, c2_;
+    };
+
+    // C = beta C + alpha A B for B of size columns, or y = beta y + alpha A x
+    // when size is 0, for a block compressed matrix A
+    template<std::size_t BR, std::size_t BC, class T, class I>
+    void bsr_prod (const bsr_arrays<BR, BC, T, I> &a, std::size_t size, const T &alpha, const T &beta,
+                   const T *b, std::ptrdiff_t b1, std::ptrdiff_t b2,
+                   T *c, std::ptrdiff_t c1, std::ptrdiff_t c2) {
+        thread_pool &pool = thread_pool::instance ();
+        const std::size_t work = std::size_t (a.ptr [a.block_rows]) * BR * BC * (std::max) (size, std::size_t (1));
+        const bool threads = pool.size () > 1 && work >= std::size_t (BOOST_UBLAS_SPARSE_PARALLEL_NNZ);
+        const std::size_t parts = threads ? pool.size () : 1;
+        pool.parallel_for (0, parts, 1, bsr_parts<BR, BC, T, I> (a, parts, size, alpha, beta, b, b1, b2, c, c1, c2));
+    }
+
+    // Raw elements of the vector operand, copied when it has no dense
+    // storage of the matrix's value type or does not fill the last block
+    // column
+    template<class T, class E>
+    BOOST_UBLAS_INLINE
+    const T *bsr_operand (const E &e, std::size_t padded, workspace<T> &copy, boost::mpl::true_) {
+        if (padded == e.size ())
+            return dense_vector_traits<E>::data (e);
+        return bsr_operand (e, padded, copy, boost::mpl::false_ ());
+    }
+    template<class T, class E>
+    BOOST_UBLAS_INLINE
+    const T *bsr_operand (const E &e, std::size_t padded, workspace<T> &copy, boost::mpl::false_) {
+        for (std::size_t i = 0; i < e.size (); ++ i)
+            copy.data () [i] = e (i);
+        std::fill (copy.data () + e.size (), copy.data () + padded, T ());
+        return copy.data ();
+    }
+
+    template<template <class T1, class T2> class F, class V, class M, class E>
+    BOOST_UBLAS_INLINE
+    bool bsr_prod_assign (V &, const M &, const E &, boost::mpl::false_) {
+        return false;
+    }
+    template<template <class T1, class T2> class F, class V, class M, class E>
+    BOOST_UBLAS_INLINE
+    bool bsr_prod_assign (V &v, const M &m, const E &e, boost::mpl::true_) {
+        typedef typename M::value_type value_type;
+        typedef assign_scale_traits<F> assign_traits;
+        typedef boost::mpl::bool_<dense_vector_traits<E>::value &&
+                                  boost::is_same<typename E::value_type, value_type>::value> is_dense;
+        BOOST_UBLAS_CHECK (v.size () == m.size1 (), bad_size ());
+        BOOST_UBLAS_CHECK (e.size () == m.size2 (), bad_size ());
+        const std::size_t padded = m.block_columns () * M::block_size2;
+        workspace<value_type> copy (is_dense::value && padded == e.size () ? 0 : padded);
+        const value_type *x = bsr_operand (e, padded, copy, is_dense ());
+        bsr_prod (make_bsr_arrays (m), 0, value_type (assign_traits::alpha), value_type (assign_traits::beta),
+                  x, 1, 1, dense_vector_traits<V>::data (v), 1, 1);
+        return true;
+    }
+
+    // v = beta v + alpha m e for a block compressed matrix m, the
+    // assignments F that fold into that form and a dense v of the matrix's
+    // value type. Returns false, without touching v, otherwise.
+    template<template <class T1, class T2> class F, class V, class M, class E>
+    BOOST_UBLAS_INLINE
+    bool bsr_prod_assign (V &v, const M &m, const E &e) {
+        typedef boost::mpl::bool_<assign_scale_traits<F>::value && dense_vector_traits<V>::value &&
+                                  boost::is_same<typename V::value_type, typename M::value_type>::value> is_dense;
+        return bsr_prod_assign<F> (v, m, e, is_dense ());
+    }
+
+    // Whether the matrix operand can be read in place: dense storage of the
+    // matrix's value type, whole block rows and no storage shared with the
+    // result
+    template<class E, class T>
+    BOOST_UBLAS_INLINE
+    bool bsr_in_place (const E &, std::size_t, const T *, boost::mpl::false_) {
+        return false;
+    }
+    template<class E, class T>
+    BOOST_UBLAS_INLINE
+    bool bsr_in_place (const E &e, std::size_t padded, const T *result, boost::mpl::true_) {
+        return padded == e.size1 () && dense_matrix_traits<E>::data (e) != result;
+    }
+    template<class T, class E>
+    BOOST_UBLAS_INLINE
+    const T *bsr_matrix_operand (const E &, std::ptrdiff_t &, std::ptrdiff_t &, boost::mpl::false_) {
+        return 0;
+    }
+    template<class T, class E>
+    BOOST_UBLAS_INLINE
+    const T *bsr_matrix_operand (const E &e, std::ptrdiff_t &b1, std::ptrdiff_t &b2, boost::mpl::true_) {
+        b1 = dense_matrix_traits<E>::stride1 (e);
+        b2 = dense_matrix_traits<E>::stride2 (e);
+        return dense_matrix_traits<E>::data (e);
+    }
+
+    template<template <class T1, class T2> class F, class C, class M, class E>
+    BOOST_UBLAS_INLINE
+    bool bsr_matrix_prod_assign (C &, const M &, const E &, boost::mpl::false_) {
+        return false;
+    }
+    template<template <class T1, class T2> class F, class C, class M, class E>
+    BOOST_UBLAS_INLINE
+    bool bsr_matrix_prod_assign (C &c, const M &m, const E &e, boost::mpl::true_) {
+        typedef typename M::value_type value_type;
+        typedef assign_scale_traits<F> assign_traits;
+        typedef dense_matrix_traits<C> traits;
+        typedef boost::mpl::bool_<dense_matrix_traits<E>::value &&
+                                  boost::is_same<typename E::value_type, value_type>::value> is_dense;
+        BOOST_UBLAS_CHECK (c.size1 () == m.size1 (), bad_size ());
+        BOOST_UBLAS_CHECK (e.size1 () == m.size2 (), bad_size ());
+        BOOST_UBLAS_CHECK (c.size2 () == e.size2 (), bad_size ());
+        const std::size_t padded = m.block_columns () * M::block_size2, size = e.size2 ();
+        if (size == 0)
+            return true;
+        // Otherwise the right hand side is copied by rows, zero padded
+        const bool in_place = bsr_in_place (e, padded, traits::data (c), is_dense ());
+        workspace<value_type> copy (in_place ? 0 : padded * size);
+        std::ptrdiff_t b1 = std::ptrdiff_t (size), b2 = 1;
+        const value_type *b = copy.data ();
+        if (in_place)
+            b = bsr_matrix_operand<value_type> (e, b1, b2, is_dense ());
+        else {
+            for (std::size_t i = 0; i < e.size1 (); ++ i)
+                for (std::size_t j = 0; j < size; ++ j)
+                    copy.data () [i * size + j] = e (i, j);
+            std::fill (copy.data () + e.size1 () * size, copy.data () + padded * size, value_type ());
+        }
+        bsr_prod (make_bsr_arrays (m), size, value_type (assign_traits::alpha), value_type (assign_traits::beta),
+                  b, b1, b2, traits::data (c), traits::stride1 (c), traits::stride2 (c));
+        return true;
+    }
+
+    // c = beta c + alpha m e for a block compressed matrix m, the
+    // assignments F that fold into that form and a dense c of the matrix's
+    // value type. Returns false, without touching c, otherwise.
+    template<template <class T1, class T2> class F, class C, class M, class E>
+    BOOST_UBLAS_INLINE
+    bool bsr_matrix_prod_assign (C &c, const M &m, const E &e) {
+        typedef boost::mpl::bool_<assign_scale_traits<F>::value && dense_matrix_traits<C>::value &&
+                                  boost::is_same<typename C::value_type, typename M::value_type>::value> is_dense;
+        return bsr_matrix_prod_assign<F> (c, m, e, is_dense ());
+    }
+
+    // prod (A, x)
+    template<class T, std::size_t BR, std::size_t BC, class IA, class TA, class E2, class F>
+    struct vector_assign_kernel<matrix_vector_binary1<block_compressed_matrix<T, BR, BC, IA, TA>, E2, F> > {
+        template<template <class T1, class T2> class G, class V>
+        static BOOST_UBLAS_INLINE
+        bool apply (V &v, const matrix_vector_binary1<block_compressed_matrix<T, BR, BC, IA, TA>, E2, F> &e) {
+            return bsr_prod_assign<G> (v, e.expression1 ().expression (), e.expression2 ());
+        }
+    };
+    // prod (A, B)
+    template<class T, std::size_t BR, std::size_t BC, class IA, class TA, class E2, class F>
+    struct matrix_assign_kernel<matrix_matrix_binary<block_compressed_matrix<T, BR, BC, IA, TA>, E2, F> > {
+        template<template <class T1, class T2> class G, class M>
+        static BOOST_UBLAS_INLINE
+        bool apply (M &m, const matrix_matrix_binary<block_compressed_matrix<T, BR, BC, IA, TA>, E2, F> &e) {
+            return bsr_matrix_prod_assign<G> (m, e.expression1 ().expression (), e.expression2 ());
+        }
+    };
+
+}}}}
+
+#endif
@@ -0,0 +1,329 @@
+//
+//  Copyright (c) 2017
+//  uBLAS developers
+//
+//  Distributed under the Boost Software License, Version 1.0. (See
+//  accompanying file LICENSE_1_0.txt or copy at
+//  http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#ifndef _BOOST_UBLAS_STRASSEN_
+#define _BOOST_UBLAS_STRASSEN_
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+
+#include <boost/numeric/ublas/detail/config.hpp>
+#include <boost/numeric/ublas/detail/workspace.hpp>
+#include <boost/numeric/ublas/detail/gemm.hpp>
+
+// Strassen-Winograd product on strided dense storage.
+//
+// Operands are addressed as in gemm: a pointer plus a row and a column
+// stride, so the recursion runs on the caller's storage whatever its layout.
+// Every step splits the even part of an M x K x N product into quadrants and
+// forms Winograd's seven products with fifteen additions. Two operand sums and
+// one product are the only scratch, leased from the workspace arena. Odd
+// trailing rows, columns and inner indices are peeled off and handled by thin
+// gemm calls, so nothing is ever padded. Once the smallest dimension drops
+// below the cutoff the packed gemm kernel takes over.
+//
+// Where the cutoff lies depends on how fast gemm is compared to the extra
+// additions, so unless BOOST_UBLAS_STRASSEN_CUTOFF fixes it, it is measured
+// the first time a product large enough to care is formed.
+
+namespace boost { namespace numeric { namespace ublas { namespace detail {
+
+    // Element access through an array of row pointers
+    template<class T>
+    class row_pointer_adaptor {
+    public:
+        explicit BOOST_UBLAS_INLINE
+        row_pointer_adaptor (T **data):
+            data_ (data) {}
+
+        template<class S>
+        BOOST_UBLAS_INLINE
+        T &operator () (S i, S j) const {
+            return data_ [i] [j];
+        }
+
+    private:
+        T **data_;
+    };
+
+    // Pointer and strides of a dense block, T possibly const
+    template<class T>
+    struct strided_view {
+        T *data;
+        std::ptrdiff_t stride1;
+        std::ptrdiff_t stride2;
+
+        BOOST_UBLAS_INLINE
+        T &operator () (std::size_t i, std::size_t j) const {
+            return data [std::ptrdiff_t (i) * stride1 + std::ptrdiff_t (j) * stride2];
+        }
+        // View starting at element (i, j)
+        BOOST_UBLAS_INLINE
+        strided_view block (std::size_t i, std::size_t j) const {
+            strided_view v = { &(*this) (i, j), stride1, stride2 };
+            return v;
+        }
+    };
+
+    template<class T>
+    BOOST_UBLAS_INLINE
+    strided_view<T> make_strided_view (T *data, std::ptrdiff_t stride1, std::ptrdiff_t stride2) {
+        strided_view<T> v = { data, stride1, stride2 };
+        return v;
+    }
+
+    // Z = X + Y and Z = X - Y for m x n views. Z may be X or Y.
+    template<class X, class Y, class Z>
+    BOOST_UBLAS_INLINE
+    void strassen_add (std::size_t m, std::size_t n, const X &x, const Y &y, const Z &z) {
+        for (std::size_t i = 0; i < m; ++ i)
+            for (std::size_t j = 0; j < n; ++ j)
+                z (i, j) = x (i, j) + y (i, j);
+    }
+    template<class X, class Y, class Z>
+    BOOST_UBLAS_INLINE
+    void strassen_sub (std::size_t m, std::size_t n, const X &x, const Y &y, const Z &z) {
+        for (std::size_t i = 0; i < m; ++ i)
+            for (std::size_t j = 0; j < n; ++ j)
+                z (i, j) = x (i, j) - y (i, j);
+    }
+
+    // C (m x n) = alpha A (m x k) B (k x n) through gemm
+    template<class T, class A, class B>
+    BOOST_UBLAS_INLINE
+    void strassen_leaf (std::size_t m, std::size_t n, std::size_t k, const T &alpha,
+                        const A &a, const B &b, const T &beta, const strided_view<T> &c) {
+        gemm (m, n, k, alpha, a.data, a.stride1, a.stride2, b.data, b.stride1, b.stride2,
+              beta, c.data, c.stride1, c.stride2);
+    }
+
+    // Scratch elements needed below a Strassen step on an m x k x n product
+    inline
+    std::size_t strassen_workspace_size (std::size_t m, std::size_t n, std::size_t k, std::size_t cutoff) {
+        std::size_t size = 0;
+        while (m >= cutoff && n >= cutoff && k >= cutoff) {
+            m >>= 1, n >>= 1, k >>= 1;
+            size += m * k + k * n + m * n;
+        }
+        return size;
+    }
+
+    // C (m x n) = alpha A (m x k) B (k x n), C not overlapping A or B. w points
+    // to at least strassen_workspace_size (m, n, k, cutoff) scratch elements.
+    template<class T, class A, class B>
+    void strassen_kernel (std::size_t m, std::size_t n, std::size_t k, const T &alpha,
+                          const A &a, const B &b, const strided_view<T> &c,
+                          T *w, std::size_t cutoff) {
+        if (m < cutoff || n < cutoff || k < cutoff) {
+            strassen_leaf (m, n, k, alpha, a, b, T (), c);
+            return;
+        }
+
+        const std::size_t m2 = m >> 1, n2 = n >> 1, k2 = k >> 1;
+        const A a11 (a), a12 (a.block (0, k2)), a21 (a.block (m2, 0)), a22 (a.block (m2, k2));
+        const B b11 (b), b12 (b.block (0, n2)), b21 (b.block (k2, 0)), b22 (b.block (k2, n2));
+        const strided_view<T> c11 (c), c12 (c.block (0, n2)), c21 (c.block (m2, 0)), c22 (c.block (m2, n2));
+        const strided_view<T> x (make_strided_view (w, std::ptrdiff_t (k2), 1));
+        const strided_view<T> y (make_strided_view (x.data + m2 * k2, std::ptrdiff_t (n2), 1));
+        const strided_view<T> p (make_strided_view (y.data + k2 * n2, std::ptrdiff_t (n2), 1));
+        T *next = p.data + m2 * n2;
+
+        // Products go straight into the quadrants of C while they are free:
+        // C21 = P7 = (A11 - A21) (B22 - B12)
+        strassen_sub (m2, k2, a11, a21, x);
+        strassen_sub (k2, n2, b22, b12, y);
+        strassen_kernel (m2, n2, k2, alpha, x, y, c21, next, cutoff);
+        // C22 = P5 = (A21 + A22) (B12 - B11)
+        strassen_add (m2, k2, a21, a22, x);
+        strassen_sub (k2, n2, b12, b11, y);
+        strassen_kernel (m2, n2, k2, alpha, x, y, c22, next, cutoff);
+        // C12 = P6 = (A21 + A22 - A11) (B22 - B12 + B11)
+        strassen_sub (m2, k2, x, a11, x);
+        strassen_sub (k2, n2, b22, y, y);
+        strassen_kernel (m2, n2, k2, alpha, x, y, c12, next, cutoff);
+        // C11 = P3 = (A12 - A21 - A22 + A11) B22
+        strassen_sub (m2, k2, a12, x, x);
+        strassen_kernel (m2, n2, k2, alpha, x, b22, c11, next, cutoff);
+        // P = P1 = A11 B11
+        strassen_kernel (m2, n2, k2, alpha, a11, b11, p, next, cutoff);
+
+        strassen_add (m2, n2, p, c12, c12);         // C12 = P1 + P6
+        strassen_add (m2, n2, c12, c21, c21);       // C21 = P1 + P6 + P7
+        strassen_add (m2, n2, c12, c22, c12);       // C12 = P1 + P6 + P5
+        strassen_add (m2, n2, c21, c22, c22);       // C22 = P1 + P6 + P7 + P5
+        strassen_add (m2, n2, c12, c11, c12);       // C12 = P1 + P6 + P5 + P3
+
+        // C11 = P4 = A22 (B22 - B12 + B11 - B21)
+        strassen_sub (k2, n2, y, b21, y);
+        strassen_kernel (m2, n2, k2, alpha, a22, y, c11, next, cutoff);
+        strassen_sub (m2, n2, c21, c11, c21);       // C21 = P1 + P6 + P7 - P4
+        // C11 = P2 = A12 B21
+        strassen_kernel (m2, n2, k2, alpha, a12, b21, c11, next, cutoff);
+        strassen_add (m2, n2, p, c11, c11);         // C11 = P1 + P2
+
+        // Peel the odd inner index, the last column and the last row
+        const std::size_t me = m2 << 1, ne = n2 << 1, ke = k2 << 1;
+        if (k != ke)
+            strassen_leaf (me, ne, 1, alpha, a.block (0, ke), b.block (ke, 0), T (1), c);
+        if (n != ne)
+            strassen_leaf (me, 1, k, alpha, a, b.block (0, ne), T (), c.block (0, ne));
+        if (m != me)
+            strassen_leaf (1, n, k, alpha, a.block (me, 0), b, T (), c.block (me, 0));
+    }
+
+    // The cutoff in effect for products of T, BOOST_UBLAS_STRASSEN_CUTOFF until
+    // calibrate () replaces it with the smallest order at which a Strassen step
+    // beats gemm, measured by timing both on square products of doubling
+    // order. Orders above BOOST_UBLAS_STRASSEN_CALIBRATION_LIMIT are not timed;
+    // if Strassen never wins up to the limit, the cutoff is put just above it.
+    template<class T>
+    class strassen_calibration {
+        typedef std::chrono::steady_clock clock_type;
+
+        // Time of one run of C = A B for n x n operands
+        static double time (std::size_t n, const T *a, const T *b, T *c, T *w, std::size_t cutoff) {
+            const strided_view<const T> va (make_strided_view (a, std::ptrdiff_t (n), 1));
+            const strided_view<const T> vb (make_strided_view (b, std::ptrdiff_t (n), 1));
+            const strided_view<T> vc (make_strided_view (c, std::ptrdiff_t (n), 1));
+            clock_type::time_point start (clock_type::now ());
+            strassen_kernel (n, n, n, T (1), va, vb, vc, w, cutoff);
+            return std::chrono::duration<double> (clock_type::now () - start).count ();
+        }
+
+        static std::size_t measure () {
+            const std::size_t limit = BOOST_UBLAS_STRASSEN_CALIBRATION_LIMIT;
+            std::size_t n = first;
+            for (; n <= limit; n <<= 1) {
+                workspace<T> ws (3 * n * n + strassen_workspace_size (n, n, n, n));
+                T *a = ws.data (), *b = a + n * n, *c = b + n * n;
+                for (std::size_t i = 0; i < n * n; ++ i) {
+                    a [i] = T (int (i * 7 % 13) - 6);
+                    b [i] = T (int (i * 5 % 11) - 5);
+                }
+                // A cutoff above n runs gemm, a cutoff of n a single step. Runs
+                // alternate after a warm up and the best of each counts. The
+                // step has to save a few percent, so that timing noise alone
+                // does not pull the cutoff down.
+                double classical = 0, fast = 0;
+                for (int run = 0; run < 4; ++ run) {
+                    const double t1 = time (n, a, b, c, c + n * n, n + 1);
+                    const double t2 = time (n, a, b, c, c + n * n, n);
+                    if (run == 1 || (run > 1 && t1 < classical))
+                        classical = t1;
+                    if (run == 1 || (run > 1 && t2 < fast))
+                        fast = t2;
+                }
+                if (fast < 0.95 * classical)
+                    return n;
+            }
+            return n;
+        }
+
+    public:
+        // No order below this one is ever considered
+        static const std::size_t first = 128;
+
+        static BOOST_UBLAS_INLINE
+        std::size_t &cutoff () {
+            static std::size_t value = BOOST_UBLAS_STRASSEN_CUTOFF;
+            return value;
+        }
+
+        static BOOST_UBLAS_INLINE
+        std::size_t calibrate () {
+            cutoff () = measure ();
+            return cutoff ();
+        }
+    };
+
+    // Order from which the recursion takes Strassen steps
+    template<class T>
+    BOOST_UBLAS_INLINE
+    std::size_t strassen_cutoff () {
+        return (std::max) (strassen_calibration<T>::cutoff (), std::size_t (2));
+    }
+
+    // Measures the cutoff for products of T on the running machine, which
+    // takes a few seconds, and uses it from then on. Products are never
+    // timed otherwise; call it before any are formed concurrently.
+    template<class T>
+    BOOST_UBLAS_INLINE
+    std::size_t strassen_calibrate () {
+        return strassen_calibration<T>::calibrate ();
+    }
+
+    // Whether an m x k x n product is large enough for at least one step
+    template<class T>
+    BOOST_UBLAS_INLINE
+    bool strassen_pays (std::size_t m, std::size_t n, std::size_t k) {
+        const std::size_t order = (std::min) (m, (std::min) (n, k));
+        return order >= strassen_cutoff<T> ();
+    }
+
+    // C (m x n) = beta C + alpha A (m x k) B (k x n) with Strassen steps down
+    // to the cutoff, arguments as for gemm. C must not overlap A or B and, as
+    // in BLAS, is not read when beta is zero.
+    template<class T>
+    void strassen_gemm (std::size_t m, std::size_t n, std::size_t k, const T &alpha,
+                        const T *a, std::ptrdiff_t a1, std::ptrdiff_t a2,
+                        const T *b, std::ptrdiff_t b1, std::ptrdiff_t b2,
+                        const T &beta, T *c, std::ptrdiff_t c1, std::ptrdiff_t c2,
+                        std::size_t cutoff = strassen_cutoff<T> ()) {
+        const strided_view<const T> va (make_strided_view (a, a1, a2));
+        const strided_view<const T> vb (make_strided_view (b, b1, b2));
+        const strided_view<T> vc (make_strided_view (c, c1, c2));
+        const std::size_t scratch = strassen_workspace_size (m, n, k, cutoff);
+        if (beta == T ()) {
+            workspace<T> ws (scratch);
+            strassen_kernel (m, n, k, alpha, va, vb, vc, ws.data (), cutoff);
+            return;
+        }
+        // The recursion overwrites C, so the product is formed aside first
+        workspace<T> ws (m * n + scratch);
+        const strided_view<T> t (make_strided_view (ws.data (), std::ptrdiff_t (n), 1));
+        strassen_kernel (m, n, k, alpha, va, vb, t, ws.data () + m * n, cutoff);
+        for (std::size_t i = 0; i < m; ++ i)
+            for (std::size_t j = 0; j < n; ++ j)
+                vc (i, j) = beta * vc (i, j) + t (i, j);
+    }
+
+    // r (size1 x size2) = e1 (size1 x size) * e2 (size x size2)
+    // The operands and the result only need element access through (i, j).
+    // They are packed once into row major workspace and multiplied with
+    // Strassen steps if use_strassen is set, with gemm otherwise.
+    template<class T, class S, class E1, class E2, class R>
+    void strassen_prod (S size1, S size, S size2, const E1 &e1, const E2 &e2, R &r, bool use_strassen) {
+        workspace<T> ws (size1 * size + size * size2 + size1 * size2);
+        T *a = ws.data ();
+        T *b = a + size1 * size;
+        T *c = b + size * size2;
+
+        for (S i = 0; i < size1; ++ i)
+            for (S j = 0; j < size; ++ j)
+                a [i * size + j] = e1 (i, j);
+        for (S i = 0; i < size; ++ i)
+            for (S j = 0; j < size2; ++ j)
+                b [i * size2 + j] = e2 (i, j);
+
+        if (use_strassen)
+            strassen_gemm (size1, size2, size, T (1), a, std::ptrdiff_t (size), 1,
+                           b, std::ptrdiff_t (size2), 1, T (), c, std::ptrdiff_t (size2), 1);
+        else
+            gemm (size1, size2, size, T (1), a, std::ptrdiff_t (size), 1,
+                  b, std::ptrdiff_t (size2), 1, T (), c, std::ptrdiff_t (size2), 1);
+
+        for (S i = 0; i < size1; ++ i)
+            for (S j = 0; j < size2; ++ j)
+                r (i, j) = c [i * size2 + j];
+    }
+
+}}}}
+
+#endif
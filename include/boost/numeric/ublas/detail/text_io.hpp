@@ -0,0 +1,752 @@
+//
+//  Copyright (c) 2017
+//  uBLAS developers
+//
+//  Distributed under the Boost Software License, Version 1.0. (See
+//  accompanying file LICENSE_1_0.txt or copy at
+//  http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#ifndef _BOOST_UBLAS_TEXT_IO_
+#define _BOOST_UBLAS_TEXT_IO_
+
+#include <algorithm>
+#include <clocale>
+#include <complex>
+#include <cstddef>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <istream>
+#include <locale>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#if __cplusplus >= 201703L && defined (__has_include)
+#if __has_include (<charconv>)
+#include <charconv>
+#endif
+#endif
+#if defined (__cpp_lib_to_chars) && __cpp_lib_to_chars >= 201611L
+#define BOOST_UBLAS_TEXT_CHARCONV
+#endif
+
+#include <boost/config.hpp>
+#include <boost/mpl/bool.hpp>
+#include <boost/type_traits/is_floating_point.hpp>
+#include <boost/type_traits/is_same.hpp>
+#include <boost/numeric/ublas/detail/config.hpp>
+#include <boost/numeric/ublas/detail/thread_pool.hpp>
+
+// Buffered, locale free reading and writing of the text format of io.hpp.
+//
+// The stream operators of io.hpp hand narrow character streams of floating
+// point, integer and complex values over to these routines. Reading copies the
+// characters of one vector or matrix, up to its closing parenthesis, from the
+// stream buffer into a string, allocates the result from the sizes in the
+// header and parses the elements out of the string; writing formats blocks of
+// rows into strings written with single calls. Numbers are converted by
+// std::from_chars and std::to_chars where the library has them, otherwise by
+// strtod and sprintf of the C library, which follow LC_NUMERIC: the period is
+// swapped with its decimal point on the way in and out, so that setlocale
+// does not change the text. As the stream's locale and flags are not
+// consulted, the routines only take over streams with the classic locale,
+// decimal integers and, for output, the default float format and no field
+// width.
+//
+// The rows of a matrix are found by one scan over its parentheses; blocks of
+// rows of about BOOST_UBLAS_TEXT_BLOCK_SIZE elements are then parsed, or
+// formatted, by the threads of the pool.
+
+namespace boost { namespace numeric { namespace ublas { namespace detail {
+
+    // The value types these routines read and write: floating point types,
+    // integers other than characters and bool, and complex numbers.
+    // long long and long double need std::from_chars.
+    template<class T>
+    struct text_value { static const bool value = false; };
+    template<>
+    struct text_value<float> { static const bool value = true; };
+    template<>
+    struct text_value<double> { static const bool value = true; };
+    template<>
+    struct text_value<short> { static const bool value = true; };
+    template<>
+    struct text_value<unsigned short> { static const bool value = true; };
+    template<>
+    struct text_value<int> { static const bool value = true; };
+    template<>
+    struct text_value<unsigned int> { static const bool value = true; };
+    template<>
+    struct text_value<long> { static const bool value = true; };
+    template<>
+    struct text_value<unsigned long> { static const bool value = true; };
+#ifdef BOOST_UBLAS_TEXT_CHARCONV
+    template<>
+    struct text_value<long double> { static const bool value = true; };
+    template<>
+    struct text_value<boost::long_long_type> { static const bool value = true; };
+    template<>
+    struct text_value<boost::ulong_long_type> { static const bool value = true; };
+#endif
+    template<class T>
+    struct text_value<std::complex<T> > { static const bool value = text_value<T>::value && boost::is_floating_point<T>::value; };
+
+    // Largest output precision formatted here
+    static const std::streamsize text_precision_limit = 64;
+
+    // Whether the stream reads numbers the way these routines parse them
+    template<class T>
+    bool text_input_applies (const std::basic_istream<char, T> &is) {
+        return (is.flags () & std::ios_base::basefield) == std::ios_base::dec && is.getloc () == std::locale::classic ();
+    }
+
+    // Whether the stream writes numbers the way these routines format them
+    template<class T>
+    bool text_output_applies (const std::basic_ostream<char, T> &os) {
+        const std::ios_base::fmtflags flags = os.flags ();
+        return os.width () == 0 && os.precision () >= 0 && os.precision () < text_precision_limit &&
+               (flags & (std::ios_base::floatfield | std::ios_base::showpos | std::ios_base::showpoint | std::ios_base::uppercase)) == 0 &&
+               (flags & std::ios_base::basefield) == std::ios_base::dec && os.getloc () == std::locale::classic ();
+    }
+
+    // Parsing. The functions advance p past what they parse and return
+    // whether it was well formed; white space is skipped before every token.
+
+    inline void skip_text_space (const char *&p, const char *last) {
+        while (p != last && (*p == ' ' || *p == '\n' || *p == '\t' || *p == '\r' || *p == '\f' || *p == '\v'))
+            ++ p;
+    }
+
+    inline bool parse_text_char (const char *&p, const char *last, char c) {
+        skip_text_space (p, last);
+        if (p == last || *p != c)
+            return false;
+        ++ p;
+        return true;
+    }
+
+    inline bool parse_text_size (const char *&p, const char *last, std::size_t &size) {
+        skip_text_space (p, last);
+        if (p == last || *p < '0' || *p > '9')
+            return false;
+        std::size_t s = 0;
+        for (; p != last && *p >= '0' && *p <= '9'; ++ p) {
+            const std::size_t t = s * 10 + std::size_t (*p - '0');
+            if ((t - std::size_t (*p - '0')) / 10 != s)
+                return false;
+            s = t;
+        }
+        size = s;
+        return true;
+    }
+
+#ifdef BOOST_UBLAS_TEXT_CHARCONV
+    template<class T>
+    bool parse_text_number (const char *&p, const char *last, T &t) {
+        skip_text_space (p, last);
+        // Streams accept a plus sign, std::from_chars does not
+        if (p != last && *p == '+' && last - p > 1 && p [1] != '+' && p [1] != '-')
+            ++ p;
+        const std::from_chars_result r = std::from_chars (p, last, t);
+        if (r.ec != std::errc ())
+            return false;
+        p = r.ptr;
+        return true;
+    }
+#else
+    // Copies the number at p, not advancing past it, into the null terminated
+    // buffer for the C library
+    inline bool copy_text_number (const char *&p, const char *last, char (&buffer) [64]) {
+        skip_text_space (p, last);
+        std::size_t n = 0;
+        for (const char *q = p; q != last && n < sizeof (buffer) - 1; ++ q, ++ n) {
+            const char c = *q;
+            if (! ((c >= '0' && c <= '9') || (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || c == '.' || c == '+' || c == '-'))
+                break;
+            buffer [n] = c;
+        }
+        buffer [n] = 0;
+        return n > 0;
+    }
+    // The decimal point of LC_NUMERIC, or null for the period of the "C"
+    // locale
+    inline const char *text_decimal_point () {
+        const char *point = std::localeconv ()->decimal_point;
+        return (point [0] == '.' && point [1] == 0) || point [0] == 0 ? 0 : point;
+    }
+    inline bool parse_text_number (const char *&p, const char *last, double &t) {
+        char buffer [64], *end;
+        if (! copy_text_number (p, last, buffer))
+            return false;
+        const char *point = text_decimal_point ();
+        const char *period = std::strchr (buffer, '.');
+        if (point == 0 || period == 0) {
+            t = std::strtod (buffer, &end);
+            p += end - buffer;
+            return end != buffer;
+        }
+        // The period replaced by the decimal point, which strtod reads whole
+        // or not at all
+        const std::size_t k = std::size_t (period - buffer), n = std::strlen (point);
+        std::string local (buffer, k);
+        local.append (point, n);
+        local.append (period + 1);
+        t = std::strtod (local.c_str (), &end);
+        const std::size_t used = std::size_t (end - local.c_str ());
+        p += used > k ? used - n + 1 : used;
+        return used != 0;
+    }
+    inline bool parse_text_number (const char *&p, const char *last, float &t) {
+        double d;
+        if (! parse_text_number (p, last, d))
+            return false;
+        t = float (d);
+        return true;
+    }
+    inline bool parse_text_number (const char *&p, const char *last, long &t) {
+        char buffer [64], *end;
+        if (! copy_text_number (p, last, buffer))
+            return false;
+        t = std::strtol (buffer, &end, 10);
+        p += end - buffer;
+        return end != buffer;
+    }
+    inline bool parse_text_number (const char *&p, const char *last, unsigned long &t) {
+        char buffer [64], *end;
+        if (! copy_text_number (p, last, buffer))
+            return false;
+        t = std::strtoul (buffer, &end, 10);
+        p += end - buffer;
+        return end != buffer;
+    }
+    template<class T, class W>
+    bool parse_text_integer (const char *&p, const char *last, T &t) {
+        W w;
+        if (! parse_text_number (p, last, w) || W (T (w)) != w)
+            return false;
+        t = T (w);
+        return true;
+    }
+    inline bool parse_text_number (const char *&p, const char *last, short &t) {
+        return parse_text_integer<short, long> (p, last, t);
+    }
+    inline bool parse_text_number (const char *&p, const char *last, int &t) {
+        return parse_text_integer<int, long> (p, last, t);
+    }
+    inline bool parse_text_number (const char *&p, const char *last, unsigned short &t) {
+        return parse_text_integer<unsigned short, unsigned long> (p, last, t);
+    }
+    inline bool parse_text_number (const char *&p, const char *last, unsigned int &t) {
+        return parse_text_integer<unsigned int, unsigned long> (p, last, t);
+    }
+#endif
+
+    template<class T>
+    bool parse_text_value (const char *&p, const char *last, T &t) {
+        return parse_text_number (p, last, t);
+    }
+    // Complex numbers as std::complex reads them: re, (re) or (re,im)
+    template<class T>
+    bool parse_text_value (const char *&p, const char *last, std::complex<T> &t) {
+        T re, im = T ();
+        skip_text_space (p, last);
+        if (p == last || *p != '(') {
+            if (! parse_text_number (p, last, re))
+                return false;
+        } else {
+            ++ p;
+            if (! parse_text_number (p, last, re))
+                return false;
+            skip_text_space (p, last);
+            if (p != last && *p == ',') {
+                ++ p;
+                if (! parse_text_number (p, last, im))
+                    return false;
+            }
+            if (! parse_text_char (p, last, ')'))
+                return false;
+        }
+        t = std::complex<T> (re, im);
+        return true;
+    }
+
+    // Formatting, as a stream with the classic locale and default flags writes
+
+#ifdef BOOST_UBLAS_TEXT_CHARCONV
+    template<class T>
+    std::size_t format_text_number (char *buffer, std::size_t size, const T &t, int precision, boost::true_type) {
+        return std::size_t (std::to_chars (buffer, buffer + size, t, std::chars_format::general, precision).ptr - buffer);
+    }
+    template<class T>
+    std::size_t format_text_number (char *buffer, std::size_t size, const T &t, int, boost::false_type) {
+        return std::size_t (std::to_chars (buffer, buffer + size, t).ptr - buffer);
+    }
+#else
+    template<class T>
+    std::size_t format_text_number (char *buffer, std::size_t, const T &t, int precision, boost::true_type) {
+        const std::size_t size = std::size_t (std::sprintf (buffer, "%.*g", precision, double (t)));
+        const char *point = text_decimal_point ();
+        char *q = point == 0 ? 0 : std::strstr (buffer, point);
+        if (q == 0)
+            return size;
+        // The decimal point replaced by a period
+        const std::size_t n = std::strlen (point);
+        *q = '.';
+        std::memmove (q + 1, q + n, size - std::size_t (q - buffer) - n + 1);
+        return size - n + 1;
+    }
+    inline std::size_t format_text_number (char *buffer, std::size_t, long t, int, boost::false_type) {
+        return std::size_t (std::sprintf (buffer, "%ld", t));
+    }
+    inline std::size_t format_text_number (char *buffer, std::size_t, unsigned long t, int, boost::false_type) {
+        return std::size_t (std::sprintf (buffer, "%lu", t));
+    }
+    inline std::size_t format_text_number (char *buffer, std::size_t size, int t, int precision, boost::false_type) {
+        return format_text_number (buffer, size, long (t), precision, boost::false_type ());
+    }
+    inline std::size_t format_text_number (char *buffer, std::size_t size, short t, int precision, boost::false_type) {
+        return format_text_number (buffer, size, long (t), precision, boost::false_type ());
+    }
+    inline std::size_t format_text_number (char *buffer, std::size_t size, unsigned int t, int precision, boost::false_type) {
+        return format_text_number (buffer, size, (unsigned long) t, precision, boost::false_type ());
+    }
+    inline std::size_t format_text_number (char *buffer, std::size_t size, unsigned short t, int precision, boost::false_type) {
+        return format_text_number (buffer, size, (unsigned long) t, precision, boost::false_type ());
+    }
+#endif
+
+    template<class T>
+    void format_text_value (std::string &s, const T &t, int precision) {
+        // Room for the digits of text_precision_limit, sign, point and exponent
+        char buffer [96];
+        s.append (buffer, format_text_number (buffer, sizeof (buffer), t, precision,
+                                              typename boost::is_floating_point<T>::type ()));
+    }
+    template<class T>
+    void format_text_value (std::string &s, const std::complex<T> &t, int precision) {
+        s += '(';
+        format_text_value (s, t.real (), precision);
+        s += ',';
+        format_text_value (s, t.imag (), precision);
+        s += ')';
+    }
+
+    inline void format_text_size (std::string &s, std::size_t size) {
+        char buffer [24], *p = buffer + sizeof (buffer);
+        do {
+            *-- p = char ('0' + size % 10);
+            size /= 10;
+        } while (size > 0);
+        s.append (p, buffer + sizeof (buffer));
+    }
+
+    // The extent of the text of one vector or matrix: the header in brackets,
+    // then the body to its closing parenthesis
+    class text_extent {
+    public:
+        text_extent ():
+            header_ (0), depth_ (0), body_ (false) {}
+
+        // Takes the next character; returns 1 after the last one of the text,
+        // -1 on a character that cannot be part of it, 0 otherwise
+        int next (char c) {
+            if (! body_) {
+                body_ = c == ']';
+                // No header is that long
+                return ++ header_ > 64 ? -1 : 0;
+            }
+            if (c == '(')
+                ++ depth_;
+            else if (c == ')' && depth_ > 0)
+                return -- depth_ == 0 ? 1 : 0;
+            else if (depth_ == 0 && c != ' ' && c != '\n' && c != '\t' && c != '\r' && c != '\f' && c != '\v')
+                return -1;
+            return 0;
+        }
+
+        // Takes the n characters at p up to the one where next returns
+        // nonzero, returning its position and state, or n and 0
+        std::size_t scan (const char *p, std::size_t n, int &state) {
+            for (std::size_t k = 0; k < n; ++ k) {
+                // Within the body only parentheses matter
+                if (depth_ > 0 && p [k] != '(' && p [k] != ')')
+                    continue;
+                if ((state = next (p [k])) != 0)
+                    return k;
+            }
+            state = 0;
+            return n;
+        }
+
+    private:
+        std::size_t header_, depth_;
+        bool body_;
+    };
+
+    // Copies the text of one vector or matrix from is to text. Leading white
+    // space is skipped as by formatted input. Sets the failbit, leaving the
+    // offending character in the stream, when the text is malformed in a way
+    // that ends it early, or the failbit and eofbit when the stream ends first.
+    template<class T>
+    bool read_text (std::basic_istream<char, T> &is, std::string &text) {
+        const typename std::basic_istream<char, T>::sentry sentry (is);
+        if (! sentry)
+            return false;
+        std::basic_streambuf<char, T> &buffer = *is.rdbuf ();
+        if (! T::eq_int_type (buffer.sgetc (), T::to_int_type ('['))) {
+            is.setstate (T::eq_int_type (buffer.sgetc (), T::eof ()) ? std::ios_base::failbit | std::ios_base::eofbit : std::ios_base::failbit);
+            return false;
+        }
+        text_extent extent;
+        char chunk [4096];
+        for (;;) {
+            // The characters already in the stream buffer are taken in
+            // chunks, those after the text being put back, which cannot fail
+            // as they were not moved; others one at a time
+            std::streamsize n = (std::min) (buffer.in_avail (), std::streamsize (sizeof (chunk)));
+            if (n > 0)
+                n = buffer.sgetn (chunk, n);
+            else {
+                const typename T::int_type c = buffer.sbumpc ();
+                if (T::eq_int_type (c, T::eof ())) {
+                    is.setstate (std::ios_base::failbit | std::ios_base::eofbit);
+                    return false;
+                }
+                chunk [0] = T::to_char_type (c);
+                n = 1;
+            }
+            int state;
+            const std::streamsize k = std::streamsize (extent.scan (chunk, std::size_t (n), state));
+            if (state == 0) {
+                text.append (chunk, std::size_t (n));
+                continue;
+            }
+            const std::streamsize end = state > 0 ? k + 1 : k;
+            for (std::streamsize r = n; r > end; -- r)
+                buffer.sputbackc (chunk [r - 1]);
+            text.append (chunk, std::size_t (end));
+            if (state < 0)
+                is.setstate (std::ios_base::failbit);
+            return state > 0;
+        }
+    }
+
+    // The parsing of the rows of a matrix body ((a00,...),...,(...)) between
+    // p and last. F gives the number of elements to parse in row i,
+    // f.columns (i), at most the number of columns, and takes the elements
+    // with f (i, j, t), returning false to fail the parse. The rows are
+    // parsed by ranges in parallel; f is called concurrently for distinct
+    // elements.
+    template<class V, class F>
+    class text_rows_parser {
+    public:
+        text_rows_parser (const std::vector<const char *> &starts, std::size_t size2, F f, std::vector<char> &good, std::size_t block):
+            starts_ (starts), size2_ (size2), f_ (f), good_ (good), block_ (block) {}
+
+        void operator () (std::size_t first, std::size_t last) const {
+            for (std::size_t b = first; b < last; ++ b) {
+                const std::size_t end = (std::min) ((b + 1) * block_, starts_.size () - 1);
+                for (std::size_t i = b * block_; i < end && good_ [b]; ++ i)
+                    good_ [b] = parse_row (i);
+            }
+        }
+
+    private:
+        bool parse_row (std::size_t i) const {
+            const char *p = starts_ [i], *last = starts_ [i + 1];
+            const std::size_t columns = f_.columns (i);
+            if (! parse_text_char (p, last, '('))
+                return false;
+            V t;
+            for (std::size_t j = 0; j < columns; ++ j) {
+                if ((j > 0 && ! parse_text_char (p, last, ',')) || ! parse_text_value (p, last, t) || ! f_ (i, j, t))
+                    return false;
+            }
+            // A row not parsed to its end has been checked before
+            if (columns < size2_)
+                return true;
+            if (! parse_text_char (p, last, ')'))
+                return false;
+            if (i + 2 < starts_.size () && ! parse_text_char (p, last, ','))
+                return false;
+            skip_text_space (p, last);
+            return p == last;
+        }
+
+        const std::vector<const char *> &starts_;
+        std::size_t size2_;
+        F f_;
+        std::vector<char> &good_;
+        std::size_t block_;
+    };
+
+    // Finds the starts of the size1 rows of the matrix body at p, which ends
+    // at last with its closing parenthesis, and parses them with f
+    template<class V, class F>
+    bool parse_text_rows (const char *p, const char *last, std::size_t size1, std::size_t size2, F f) {
+        if (! parse_text_char (p, last, '('))
+            return false;
+        std::vector<const char *> starts;
+        starts.reserve (size1 + 1);
+        std::size_t depth = 1;
+        for (const char *q = p; q != last; ++ q) {
+            if (*q == '(') {
+                if (depth == 1) {
+                    if (starts.size () == size1)
+                        return false;
+                    starts.push_back (q);
+                }
+                ++ depth;
+            } else if (*q == ')')
+                -- depth;
+        }
+        if (starts.size () != size1)
+            return false;
+        if (size1 == 0) {
+            skip_text_space (p, last);
+            return last - p == 1;
+        }
+        starts.push_back (last - 1);
+        skip_text_space (p, last);
+        if (p != starts [0])
+            return false;
+        const std::size_t block = (std::max) (std::size_t (BOOST_UBLAS_TEXT_BLOCK_SIZE) / (std::max) (size2, std::size_t (1)), std::size_t (1));
+        const std::size_t blocks = (size1 + block - 1) / block;
+        std::vector<char> good (blocks, 1);
+        thread_pool::instance ().parallel_for (0, blocks, 1, text_rows_parser<V, F> (starts, size2, f, good, block));
+        return std::find (good.begin (), good.end (), 0) == good.end ();
+    }
+
+    // Element handlers of parse_text_rows
+    template<class M>
+    struct text_matrix_store {
+        explicit text_matrix_store (M &m): m_ (m) {}
+        std::size_t columns (std::size_t) const {
+            return m_.size2 ();
+        }
+        bool operator () (std::size_t i, std::size_t j, const typename M::value_type &t) const {
+            m_ (i, j) = t;
+            return true;
+        }
+        M &m_;
+    };
+    // Symmetric and hermitian matrices: the upper triangle is stored first,
+    template<class M>
+    struct text_triangle_store {
+        explicit text_triangle_store (M &m): m_ (m) {}
+        std::size_t columns (std::size_t) const {
+            return m_.size2 ();
+        }
+        bool operator () (std::size_t i, std::size_t j, const typename M::value_type &t) const {
+            if (i <= j)
+                m_.insert_element (i, j, t);
+            return true;
+        }
+        M &m_;
+    };
+    // then the lower one is checked against it
+    template<class M>
+    struct text_triangle_check {
+        explicit text_triangle_check (const M &m): m_ (m) {}
+        std::size_t columns (std::size_t i) const {
+            return i;
+        }
+        bool operator () (std::size_t i, std::size_t j, const typename M::value_type &t) const {
+            return m_ (i, j) == t;
+        }
+        const M &m_;
+    };
+
+    // Reading. Each function parses from a narrow stream into a temporary,
+    // swapped with the argument on success, and sets the failbit otherwise.
+    // It returns false, leaving the stream alone, when the stream or the
+    // value type is not one it reads.
+
+    template<class E, class T, class V, class B>
+    bool read_text_vector (std::basic_istream<E, T> &, V &, B) {
+        return false;
+    }
+    template<class T, class V>
+    bool read_text_vector (std::basic_istream<char, T> &is, V &v, boost::mpl::true_) {
+        if (! text_input_applies (is))
+            return false;
+        std::string text;
+        if (! read_text (is, text))
+            return true;
+        const char *p = text.data (), *last = p + text.size ();
+        std::size_t size;
+        bool good = parse_text_char (p, last, '[') && parse_text_size (p, last, size) && parse_text_char (p, last, ']') &&
+                    parse_text_char (p, last, '(');
+        if (good) {
+            V s (size);
+            for (std::size_t i = 0; good && i < size; ++ i)
+                good = (i == 0 || parse_text_char (p, last, ',')) && parse_text_value (p, last, s (i));
+            good = good && parse_text_char (p, last, ')') && p == last;
+            if (good)
+                v.swap (s);
+        }
+        if (! good)
+            is.setstate (std::ios_base::failbit);
+        return true;
+    }
+
+    template<class E, class T, class M, class B>
+    bool read_text_matrix (std::basic_istream<E, T> &, M &, B) {
+        return false;
+    }
+    template<class T, class M>
+    bool read_text_matrix (std::basic_istream<char, T> &is, M &m, boost::mpl::true_) {
+        if (! text_input_applies (is))
+            return false;
+        std::string text;
+        if (! read_text (is, text))
+            return true;
+        const char *p = text.data (), *last = p + text.size ();
+        std::size_t size1, size2;
+        bool good = parse_text_char (p, last, '[') && parse_text_size (p, last, size1) && parse_text_char (p, last, ',') &&
+                    parse_text_size (p, last, size2) && parse_text_char (p, last, ']');
+        if (good) {
+            M s (size1, size2);
+            good = parse_text_rows<typename M::value_type> (p, last, size1, size2, text_matrix_store<M> (s));
+            if (good)
+                m.swap (s);
+        }
+        if (! good)
+            is.setstate (std::ios_base::failbit);
+        return true;
+    }
+
+    // Symmetric and hermitian matrices, whose text holds both triangles
+    template<class E, class T, class M, class B>
+    bool read_text_triangles (std::basic_istream<E, T> &, M &, B) {
+        return false;
+    }
+    template<class T, class M>
+    bool read_text_triangles (std::basic_istream<char, T> &is, M &m, boost::mpl::true_) {
+        if (! text_input_applies (is))
+            return false;
+        std::string text;
+        if (! read_text (is, text))
+            return true;
+        const char *p = text.data (), *last = p + text.size ();
+        std::size_t size1, size2;
+        bool good = parse_text_char (p, last, '[') && parse_text_size (p, last, size1) && parse_text_char (p, last, ',') &&
+                    parse_text_size (p, last, size2) && parse_text_char (p, last, ']') && size1 == size2;
+        if (good) {
+            M s (size1, size2);
+            good = parse_text_rows<typename M::value_type> (p, last, size1, size2, text_triangle_store<M> (s)) &&
+                   parse_text_rows<typename M::value_type> (p, last, size1, size2, text_triangle_check<M> (s));
+            if (good)
+                m.swap (s);
+        }
+        if (! good)
+            is.setstate (std::ios_base::failbit);
+        return true;
+    }
+
+    // Writing. The functions return false, writing nothing, when the stream
+    // or the value type is not one they write.
+
+    template<class E, class T, class V, class B>
+    bool write_text_vector (std::basic_ostream<E, T> &, const V &, B) {
+        return false;
+    }
+    template<class T, class V>
+    bool write_text_vector (std::basic_ostream<char, T> &os, const V &v, boost::mpl::true_) {
+        if (! text_output_applies (os))
+            return false;
+        const int precision = int (os.precision ());
+        const std::size_t size = v.size ();
+        std::string s;
+        s += '[';
+        format_text_size (s, size);
+        s += "](";
+        for (std::size_t i = 0; i < size; ++ i) {
+            if (i > 0)
+                s += ',';
+            format_text_value (s, v (i), precision);
+            if (s.size () >= std::size_t (BOOST_UBLAS_TEXT_BLOCK_SIZE)) {
+                os.write (s.data (), std::streamsize (s.size ()));
+                s.clear ();
+            }
+        }
+        s += ')';
+        os.write (s.data (), std::streamsize (s.size ()));
+        return true;
+    }
+
+    // Formats blocks of rows into their strings
+    template<class M>
+    class text_rows_formatter {
+    public:
+        text_rows_formatter (const M &m, int precision, std::size_t first, std::size_t block, std::vector<std::string> &texts):
+            m_ (m), precision_ (precision), first_ (first), block_ (block), texts_ (texts) {}
+
+        void operator () (std::size_t first, std::size_t last) const {
+            for (std::size_t b = first; b < last; ++ b) {
+                std::string &s = texts_ [b];
+                s.clear ();
+                const std::size_t end = (std::min) (first_ + (b + 1) * block_, std::size_t (m_.size1 ()));
+                for (std::size_t i = first_ + b * block_; i < end; ++ i) {
+                    s += i > 0 ? ",(" : "(";
+                    for (std::size_t j = 0; j < m_.size2 (); ++ j) {
+                        if (j > 0)
+                            s += ',';
+                        format_text_value (s, m_ (i, j), precision_);
+                    }
+                    s += ')';
+                }
+            }
+        }
+
+    private:
+        const M &m_;
+        int precision_;
+        std::size_t first_, block_;
+        std::vector<std::string> &texts_;
+    };
+
+    // Matrices are formatted in parallel when their elements are stored
+    // densely, as the elements of other expressions may not be safe to read
+    // concurrently
+    template<class E, class T, class M, class B>
+    bool write_text_matrix (std::basic_ostream<E, T> &, const M &, B) {
+        return false;
+    }
+    template<class T, class M>
+    bool write_text_matrix (std::basic_ostream<char, T> &os, const M &m, boost::mpl::true_) {
+        if (! text_output_applies (os))
+            return false;
+        const std::size_t size1 = m.size1 (), size2 = m.size2 ();
+        std::string s;
+        s += '[';
+        format_text_size (s, size1);
+        s += ',';
+        format_text_size (s, size2);
+        s += "](";
+        os.write (s.data (), std::streamsize (s.size ()));
+
+        thread_pool &pool = thread_pool::instance ();
+        const std::size_t threads = boost::is_same<typename M::storage_category, dense_tag>::value ? pool.size () : 1;
+        const std::size_t block = (std::max) (std::size_t (BOOST_UBLAS_TEXT_BLOCK_SIZE) / (std::max) (size2, std::size_t (1)), std::size_t (1));
+        // Rounds of a few blocks per thread bound the memory of the strings
+        std::vector<std::string> texts (2 * threads);
+        for (std::size_t first = 0; first < size1; first += texts.size () * block) {
+            const std::size_t blocks = (std::min) (texts.size (), (size1 - first + block - 1) / block);
+            const text_rows_formatter<M> formatter (m, int (os.precision ()), first, block, texts);
+            if (threads > 1)
+                pool.parallel_for (0, blocks, 1, formatter);
+            else
+                formatter (0, blocks);
+            for (std::size_t b = 0; b < blocks; ++ b)
+                os.write (texts [b].data (), std::streamsize (texts [b].size ()));
+        }
+        os.put (')');
+        return true;
+    }
+
+}}}}
+
+#endif
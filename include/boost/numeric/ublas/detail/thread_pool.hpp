@@ -0,0 +1,277 @@
+//
+//  Copyright (c) 2017
+//  uBLAS developers
+//
+//  Distributed under the Boost Software License, Version 1.0. (See
+//  accompanying file LICENSE_1_0.txt or copy at
+//  http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#ifndef _BOOST_UBLAS_THREAD_POOL_
+#define _BOOST_UBLAS_THREAD_POOL_
+
+#include <algorithm>
+#include <cstddef>
+
+#include <boost/numeric/ublas/detail/config.hpp>
+
+#ifndef BOOST_UBLAS_NO_THREADS
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+#endif
+
+// Persistent pool of worker threads for the parallel assignments.
+//
+// Every worker owns a task queue. A parallel loop deals its chunks out to the
+// queues round robin; a worker takes tasks from the front of its own queue and,
+// once that is empty, steals from the back of the others. The calling thread
+// runs chunks as well until the whole loop is done, so a loop never waits for
+// a thread that has nothing to do. A thread waiting for its tasks keeps
+// running queued ones, which lets loops and invocations nest without
+// blocking workers.
+
+namespace boost { namespace numeric { namespace ublas { namespace detail {
+
+#ifndef BOOST_UBLAS_NO_THREADS
+
+    class thread_pool:
+        private boost::noncopyable {
+        typedef std::function<void ()> task_type;
+
+        struct queue {
+            std::mutex mutex;
+            std::deque<task_type> tasks;
+        };
+
+        // Completion state of one parallel loop, lives on the caller's stack
+        struct batch {
+            std::atomic<std::size_t> remaining;
+            std::mutex mutex;
+            std::exception_ptr error;
+        };
+    public:
+        typedef std::size_t size_type;
+
+        // Starts threads - 1 workers; the caller is the remaining thread.
+        explicit thread_pool (size_type threads):
+            queues_ (threads > 1 ? threads - 1 : 0), pending_ (0), next_ (0), stop_ (false) {
+            for (size_type i = 0; i < queues_.size (); ++ i)
+                workers_.push_back (std::thread (&thread_pool::work, this, i));
+        }
+        ~thread_pool () {
+            {
+                std::lock_guard<std::mutex> lock (mutex_);
+                stop_ = true;
+            }
+            wake_.notify_all ();
+            for (size_type i = 0; i < workers_.size (); ++ i)
+                workers_ [i].join ();
+        }
+
+        // Shared pool with BOOST_UBLAS_THREADS threads, or one per hardware
+        // thread when that is 0
+        static
+        thread_pool &instance () {
+            static thread_pool pool (BOOST_UBLAS_THREADS > 0 ? size_type (BOOST_UBLAS_THREADS) :
+                                     (std::max) (size_type (std::thread::hardware_concurrency ()), size_type (1)));
+            return pool;
+        }
+
+        // Number of threads taking part in a loop, the caller included
+        BOOST_UBLAS_INLINE
+        size_type size () const {
+            return queues_.size () + 1;
+        }
+
+        // Calls f (first, last) for consecutive ranges covering [begin, end),
+        // each at least grain long except the last one, and returns when all
+        // calls have finished. The first exception thrown by f is rethrown.
+        template<class F>
+        void parallel_for (size_type begin, size_type end, size_type grain, F f) {
+            if (begin >= end)
+                return;
+            grain = (std::max) (grain, size_type (1));
+            // A few chunks per thread to even out the load
+            size_type chunks = (std::min) ((end - begin + grain - 1) / grain, 4 * size ());
+            if (chunks <= 1 || queues_.empty ()) {
+                f (begin, end);
+                return;
+            }
+            const size_type length = (end - begin + chunks - 1) / chunks;
+            chunks = (end - begin + length - 1) / length;
+
+            batch b;
+            b.remaining = chunks;
+            // The caller keeps the first chunk for itself
+            for (size_type c = 1; c < chunks; ++ c) {
+                const size_type first = begin + c * length;
+                const size_type last = (std::min) (first + length, end);
+                submit (std::bind (&thread_pool::run_range<F>, &b, f, first, last));
+            }
+            run_range<F> (&b, f, begin, (std::min) (begin + length, end));
+            wait (b);
+        }
+
+        // Calls f () and g (), possibly at the same time, and returns when
+        // both have finished. The first exception thrown is rethrown.
+        template<class F, class G>
+        void parallel_invoke (F f, G g) {
+            if (queues_.empty ()) {
+                f ();
+                g ();
+                return;
+            }
+            batch b;
+            b.remaining = 2;
+            submit (std::bind (&thread_pool::run_call<G>, &b, g));
+            run_call<F> (&b, f);
+            wait (b);
+        }
+
+    private:
+        BOOST_UBLAS_INLINE
+        void submit (const task_type &task) {
+            {
+                std::lock_guard<std::mutex> lock (mutex_);
+                ++ pending_;
+            }
+            {
+                queue &q = queues_ [next_.fetch_add (1) % queues_.size ()];
+                std::lock_guard<std::mutex> lock (q.mutex);
+                q.tasks.push_back (task);
+            }
+            wake_.notify_one ();
+        }
+
+        // Helps with queued tasks until the batch is done
+        BOOST_UBLAS_INLINE
+        void wait (batch &b) {
+            while (b.remaining.load () != 0)
+                if (! run_one (0))
+                    std::this_thread::yield ();
+            if (b.error)
+                std::rethrow_exception (b.error);
+        }
+
+        static
+        void fail (batch *b) {
+            std::lock_guard<std::mutex> lock (b->mutex);
+            if (! b->error)
+                b->error = std::current_exception ();
+        }
+
+        template<class F>
+        static
+        void run_range (batch *b, F f, size_type first, size_type last) {
+            try {
+                f (first, last);
+            } catch (...) {
+                fail (b);
+            }
+            -- b->remaining;
+        }
+
+        template<class F>
+        static
+        void run_call (batch *b, F f) {
+            try {
+                f ();
+            } catch (...) {
+                fail (b);
+            }
+            -- b->remaining;
+        }
+
+        // Runs one task, looking at queue home first. Returns false if there
+        // was none.
+        bool run_one (size_type home) {
+            task_type task;
+            for (size_type k = 0; k < queues_.size () && ! task; ++ k) {
+                queue &q = queues_ [(home + k) % queues_.size ()];
+                std::lock_guard<std::mutex> lock (q.mutex);
+                if (q.tasks.empty ())
+                    continue;
+                // Own work from the front, stolen work from the back
+                if (k == 0) {
+                    task.swap (q.tasks.front ());
+                    q.tasks.pop_front ();
+                } else {
+                    task.swap (q.tasks.back ());
+                    q.tasks.pop_back ();
+                }
+            }
+            if (! task)
+                return false;
+            {
+                std::lock_guard<std::mutex> lock (mutex_);
+                -- pending_;
+            }
+            task ();
+            return true;
+        }
+
+        void work (size_type home) {
+            for (;;) {
+                {
+                    std::unique_lock<std::mutex> lock (mutex_);
+                    while (pending_ == 0 && ! stop_)
+                        wake_.wait (lock);
+                    if (stop_)
+                        return;
+                }
+                run_one (home);
+            }
+        }
+
+        std::vector<queue> queues_;
+        std::vector<std::thread> workers_;
+        std::mutex mutex_;
+        std::condition_variable wake_;
+        size_type pending_;
+        std::atomic<size_type> next_;
+        bool stop_;
+    };
+
+#else
+
+    // Serial stand in when threads are disabled
+    class thread_pool:
+        private boost::noncopyable {
+    public:
+        typedef std::size_t size_type;
+
+        static
+        thread_pool &instance () {
+            static thread_pool pool;
+            return pool;
+        }
+
+        BOOST_UBLAS_INLINE
+        size_type size () const {
+            return 1;
+        }
+
+        template<class F>
+        void parallel_for (size_type begin, size_type end, size_type, F f) {
+            if (begin < end)
+                f (begin, end);
+        }
+
+        template<class F, class G>
+        void parallel_invoke (F f, G g) {
+            f ();
+            g ();
+        }
+    };
+
+#endif
+
+}}}}
+
+#endif
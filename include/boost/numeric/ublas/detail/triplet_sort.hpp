@@ -0,0 +1,390 @@
+//
+//  Copyright (c) 2017
+//  uBLAS developers
+//
+//  Distributed under the Boost Software License, Version 1.0. (See
+//  accompanying file LICENSE_1_0.txt or copy at
+//  http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#ifndef _BOOST_UBLAS_TRIPLET_SORT_
+#define _BOOST_UBLAS_TRIPLET_SORT_
+
+#include <algorithm>
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+#include <boost/numeric/ublas/exception.hpp>
+#include <boost/numeric/ublas/detail/config.hpp>
+#include <boost/numeric/ublas/detail/thread_pool.hpp>
+
+// Sorting of unordered (row, column, value) triplets into compressed arrays.
+//
+// compressed_matrix::assemble counting sorts the triplets by their major
+// index in linear time: each part of the triplets counts the elements per
+// major index, the counts give every part its own offsets, and the parts then
+// scatter in parallel without synchronisation, keeping the order of the
+// triplets within each major index. Each major index is then sorted by its
+// minor indices and its duplicates are summed, in parallel over the major
+// indices, and a last serial pass closes the gaps the duplicates left.
+//
+// coordinate_matrix::sort and coordinate_vector::sort pack the indices of
+// each element into one key, major index first, and radix sort the keys
+// least significant digit first. Each pass counts the digits per part of the
+// elements and scatters the parts in parallel to their own offsets, which
+// keeps the sort stable, so that duplicates are summed in the order they were
+// appended. The elements appended since the last sort are sorted this way
+// and merged with the sorted ones.
+
+namespace boost { namespace numeric { namespace ublas { namespace detail {
+
+    // The triplets (rows [k], columns [k], values [k]), k in [0, size), of a
+    // matrix of layout L, split into parts of equal size
+    template<class L, class I1, class I2, class I3>
+    struct triplet_source {
+        std::size_t size1, size2, size;
+        I1 rows;
+        I2 columns;
+        I3 values;
+
+        BOOST_UBLAS_INLINE
+        std::size_t begin (std::size_t p, std::size_t parts) const {
+            return p >= parts ? size : size / parts * p + size % parts * p / parts;
+        }
+        BOOST_UBLAS_INLINE
+        std::size_t major (std::size_t k) const {
+            return L::index_M (std::size_t (rows [k]), std::size_t (columns [k]));
+        }
+        BOOST_UBLAS_INLINE
+        std::size_t minor (std::size_t k) const {
+            return L::index_m (std::size_t (rows [k]), std::size_t (columns [k]));
+        }
+    };
+
+    // Elements of each major index in each part, in counts [p size_major ..]
+    template<class S>
+    class triplet_count_parts {
+    public:
+        BOOST_UBLAS_INLINE
+        triplet_count_parts (const S &s, std::size_t size_major, std::size_t parts, std::size_t *counts):
+            s_ (&s), size_major_ (size_major), parts_ (parts), counts_ (counts) {}
+
+        void operator () (std::size_t first, std::size_t last) const {
+            for (std::size_t p = first; p < last; ++ p) {
+                std::size_t *c = counts_ + p * size_major_;
+                std::fill (c, c + size_major_, std::size_t (0));
+                for (std::size_t k = s_->begin (p, parts_), end = s_->begin (p + 1, parts_); k < end; ++ k) {
+                    BOOST_UBLAS_CHECK (std::size_t (s_->rows [k]) < s_->size1, bad_index ());
+                    BOOST_UBLAS_CHECK (std::size_t (s_->columns [k]) < s_->size2, bad_index ());
+                    ++ c [s_->major (k)];
+                }
+            }
+        }
+
+    private:
+        const S *s_;
+        std::size_t size_major_, parts_;
+        std::size_t *counts_;
+    };
+
+    // Each part moves its triplets to the offsets of offsets [p size_major ..]
+    template<class S, class I, class T>
+    class triplet_scatter_parts {
+    public:
+        BOOST_UBLAS_INLINE
+        triplet_scatter_parts (const S &s, std::size_t size_major, std::size_t parts, std::size_t *offsets,
+                               I *idx, T *val):
+            s_ (&s), size_major_ (size_major), parts_ (parts), offsets_ (offsets), idx_ (idx), val_ (val) {}
+
+        void operator () (std::size_t first, std::size_t last) const {
+            for (std::size_t p = first; p < last; ++ p) {
+                std::size_t *o = offsets_ + p * size_major_;
+                for (std::size_t k = s_->begin (p, parts_), end = s_->begin (p + 1, parts_); k < end; ++ k) {
+                    const std::size_t q = o [s_->major (k)] ++;
+                    idx_ [q] = I (s_->minor (k));
+                    val_ [q] = s_->values [k];
+                }
+            }
+        }
+
+    private:
+        const S *s_;
+        std::size_t size_major_, parts_;
+        std::size_t *offsets_;
+        I *idx_;
+        T *val_;
+    };
+
+    template<class I, class T>
+    struct triplet_minor_less {
+        BOOST_UBLAS_INLINE
+        bool operator () (const std::pair<I, T> &a, const std::pair<I, T> &b) const {
+            return a.first < b.first;
+        }
+    };
+
+    // Sorts the elements [first, last) of idx and val by idx, equal indices
+    // keeping their order, sums the duplicates and returns how many remain
+    template<class I, class T>
+    std::size_t triplet_sort_major (I *idx, T *val, std::size_t first, std::size_t last,
+                                    std::vector<std::pair<I, T> > &buffer) {
+        if (last - first <= 16) {
+            for (std::size_t p = first + 1; p < last; ++ p) {
+                const I i = idx [p];
+                const T t = val [p];
+                std::size_t q = p;
+                for (; q > first && i < idx [q - 1]; -- q) {
+                    idx [q] = idx [q - 1];
+                    val [q] = val [q - 1];
+                }
+                idx [q] = i;
+                val [q] = t;
+            }
+        } else {
+            buffer.clear ();
+            for (std::size_t p = first; p < last; ++ p)
+                buffer.push_back (std::make_pair (idx [p], val [p]));
+            std::stable_sort (buffer.begin (), buffer.end (), triplet_minor_less<I, T> ());
+            for (std::size_t p = first; p < last; ++ p) {
+                idx [p] = buffer [p - first].first;
+                val [p] = buffer [p - first].second;
+            }
+        }
+        std::size_t q = first;
+        for (std::size_t p = first + 1; p < last; ++ p) {
+            if (idx [p] == idx [q])
+                val [q] += val [p];
+            else {
+                ++ q;
+                idx [q] = idx [p];
+                val [q] = val [p];
+            }
+        }
+        return last == first ? 0 : q + 1 - first;
+    }
+
+    // Sorts the major indices [first, last) given by ptr, their remaining
+    // elements into counts
+    template<class I, class T>
+    class triplet_sort_parts {
+    public:
+        BOOST_UBLAS_INLINE
+        triplet_sort_parts (const std::size_t *ptr, I *idx, T *val, std::size_t *counts):
+            ptr_ (ptr), idx_ (idx), val_ (val), counts_ (counts) {}
+
+        void operator () (std::size_t first, std::size_t last) const {
+            std::vector<std::pair<I, T> > buffer;
+            for (std::size_t k = first; k < last; ++ k)
+                counts_ [k] = triplet_sort_major (idx_, val_, ptr_ [k], ptr_ [k + 1], buffer);
+        }
+
+    private:
+        const std::size_t *ptr_;
+        I *idx_;
+        T *val_;
+        std::size_t *counts_;
+    };
+
+    // Sorts the triplets of s into the compressed arrays ptr (size_major + 1
+    // elements), idx and val (s.size elements each), with index base IB;
+    // returns the number of elements once the duplicates are summed
+    template<std::size_t IB, class S, class I, class T>
+    std::size_t triplet_compress (const S &s, std::size_t size_major, I *ptr, I *idx, T *val) {
+        thread_pool &pool = thread_pool::instance ();
+        const std::size_t n = s.size;
+        const bool threads = pool.size () > 1 && n >= std::size_t (BOOST_UBLAS_SPARSE_PARALLEL_NNZ);
+        // The counts of the parts cost as much as the triplets once they
+        // outnumber them
+        const std::size_t parts = threads ? (std::max) ((std::min) (pool.size (), n / (std::max) (size_major, std::size_t (1))),
+                                                        std::size_t (1)) : 1;
+
+        std::vector<std::size_t> offsets (parts * size_major + 1);
+        pool.parallel_for (0, parts, 1, triplet_count_parts<S> (s, size_major, parts, &offsets [0]));
+        // Part p of major index k starts after all of k - 1 and the parts of
+        // k before p
+        std::vector<std::size_t> start (size_major + 1);
+        std::size_t total = 0;
+        for (std::size_t k = 0; k < size_major; ++ k) {
+            start [k] = total;
+            for (std::size_t p = 0; p < parts; ++ p) {
+                const std::size_t c = offsets [p * size_major + k];
+                offsets [p * size_major + k] = total;
+                total += c;
+            }
+        }
+        start [size_major] = total;
+        pool.parallel_for (0, parts, 1, triplet_scatter_parts<S, I, T> (s, size_major, parts, &offsets [0], idx, val));
+
+        std::vector<std::size_t> counts (size_major + 1);
+        pool.parallel_for (0, size_major, threads ? 1 : size_major,
+                           triplet_sort_parts<I, T> (&start [0], idx, val, &counts [0]));
+
+        // Close the gaps left by the duplicates, moving elements towards the
+        // front only
+        std::size_t q = 0;
+        for (std::size_t k = 0; k < size_major; ++ k) {
+            ptr [k] = I (q + IB);
+            if (q != start [k])
+                for (std::size_t p = start [k]; p < start [k] + counts [k]; ++ p, ++ q) {
+                    idx [q] = idx [p];
+                    val [q] = val [p];
+                }
+            else
+                q += counts [k];
+        }
+        ptr [size_major] = I (q + IB);
+        if (IB != 0)
+            for (std::size_t p = 0; p < q; ++ p)
+                idx [p] += IB;
+        return q;
+    }
+
+    // Bits of a radix sort digit
+    const std::size_t radix_bits = 11;
+    const std::size_t radix_size = std::size_t (1) << radix_bits;
+
+    // Digits at shift of each part of the keys, in counts [p radix_size ..]
+    class radix_count_parts {
+    public:
+        BOOST_UBLAS_INLINE
+        radix_count_parts (const std::size_t *keys, std::size_t size, std::size_t parts, std::size_t shift,
+                           std::size_t *counts):
+            keys_ (keys), size_ (size), parts_ (parts), shift_ (shift), counts_ (counts) {}
+
+        void operator () (std::size_t first, std::size_t last) const {
+            for (std::size_t p = first; p < last; ++ p) {
+                std::size_t *c = counts_ + p * radix_size;
+                std::fill (c, c + radix_size, std::size_t (0));
+                for (std::size_t k = begin (p), end = begin (p + 1); k < end; ++ k)
+                    ++ c [(keys_ [k] >> shift_) & (radix_size - 1)];
+            }
+        }
+
+        BOOST_UBLAS_INLINE
+        std::size_t begin (std::size_t p) const {
+            return p >= parts_ ? size_ : size_ / parts_ * p + size_ % parts_ * p / parts_;
+        }
+
+    private:
+        const std::size_t *keys_;
+        std::size_t size_, parts_, shift_;
+        std::size_t *counts_;
+    };
+
+    // Each part moves its keys and values to the offsets of
+    // offsets [p radix_size ..]
+    template<class T>
+    class radix_scatter_parts {
+    public:
+        BOOST_UBLAS_INLINE
+        radix_scatter_parts (const std::size_t *keys, const T *values, std::size_t size, std::size_t parts,
+                             std::size_t shift, std::size_t *offsets, std::size_t *keys_to, T *values_to):
+            count_ (keys, size, parts, shift, offsets), keys_ (keys), values_ (values), shift_ (shift),
+            offsets_ (offsets), keys_to_ (keys_to), values_to_ (values_to) {}
+
+        void operator () (std::size_t first, std::size_t last) const {
+            for (std::size_t p = first; p < last; ++ p) {
+                std::size_t *o = offsets_ + p * radix_size;
+                for (std::size_t k = count_.begin (p), end = count_.begin (p + 1); k < end; ++ k) {
+                    const std::size_t q = o [(keys_ [k] >> shift_) & (radix_size - 1)] ++;
+                    keys_to_ [q] = keys_ [k];
+                    values_to_ [q] = values_ [k];
+                }
+            }
+        }
+
+    private:
+        radix_count_parts count_;
+        const std::size_t *keys_;
+        const T *values_;
+        std::size_t shift_;
+        std::size_t *offsets_;
+        std::size_t *keys_to_;
+        T *values_to_;
+    };
+
+    // Stable sort of the size keys, carrying the values, on their low bits;
+    // the buffers hold as many elements, and the result is in keys and
+    // values
+    template<class T>
+    void radix_sort (std::size_t *keys, T *values, std::size_t size, std::size_t bits,
+                     std::size_t *keys_buffer, T *values_buffer) {
+        thread_pool &pool = thread_pool::instance ();
+        const bool threads = pool.size () > 1 && size >= std::size_t (BOOST_UBLAS_SPARSE_PARALLEL_NNZ);
+        const std::size_t parts = threads ? pool.size () : 1;
+        std::vector<std::size_t> offsets (parts * radix_size);
+        std::size_t *from_keys = keys, *to_keys = keys_buffer;
+        T *from_values = values, *to_values = values_buffer;
+        for (std::size_t shift = 0; shift < bits; shift += radix_bits) {
+            pool.parallel_for (0, parts, 1, radix_count_parts (from_keys, size, parts, shift, &offsets [0]));
+            // Digit d of part p goes after all smaller digits and the parts
+            // of d before p
+            std::size_t total = 0;
+            for (std::size_t d = 0; d < radix_size; ++ d)
+                for (std::size_t p = 0; p < parts; ++ p) {
+                    const std::size_t c = offsets [p * radix_size + d];
+                    offsets [p * radix_size + d] = total;
+                    total += c;
+                }
+            pool.parallel_for (0, parts, 1, radix_scatter_parts<T> (from_keys, from_values, size, parts, shift,
+                                                                    &offsets [0], to_keys, to_values));
+            std::swap (from_keys, to_keys);
+            std::swap (from_values, to_values);
+        }
+        if (from_keys != keys) {
+            std::copy (from_keys, from_keys + size, keys);
+            std::copy (from_values, from_values + size, values);
+        }
+    }
+
+    // Sorts the elements [sorted, filled) of the arrays of a coordinate
+    // matrix, or of a coordinate vector when index1 is null, and merges them
+    // into the sorted elements [0, sorted), stably. The indices are stored
+    // with index base base. Returns false, without sorting, when the packed
+    // indices would not fit a key.
+    template<class I, class T>
+    bool coordinate_sort (I *index1, I *index2, T *values, std::size_t sorted, std::size_t filled,
+                          std::size_t size_major, std::size_t size_minor, std::size_t base) {
+        if (size_major > 0 && size_minor > std::size_t (-1) / size_major)
+            return false;
+        std::size_t bits = 0;
+        while (bits < 8 * sizeof (std::size_t) && (size_major * size_minor - 1) >> bits != 0)
+            ++ bits;
+
+        const std::size_t size = filled - sorted;
+        std::vector<std::size_t> keys (2 * size);
+        std::vector<T> tail (2 * size);
+        for (std::size_t k = 0; k < size; ++ k) {
+            const std::size_t major = index1 ? std::size_t (index1 [sorted + k]) - base : 0;
+            keys [k] = major * size_minor + (std::size_t (index2 [sorted + k]) - base);
+            tail [k] = values [sorted + k];
+        }
+        radix_sort (&keys [0], &tail [0], size, bits, &keys [size], &tail [size]);
+
+        // Merge from the back, the sorted elements first among equal ones
+        std::size_t i = sorted, j = size, q = filled;
+        while (j > 0) {
+            const std::size_t key = i == 0 ? 0 :
+                (index1 ? std::size_t (index1 [i - 1]) - base : 0) * size_minor + (std::size_t (index2 [i - 1]) - base);
+            -- q;
+            if (i > 0 && key > keys [j - 1]) {
+                -- i;
+                if (index1)
+                    index1 [q] = index1 [i];
+                index2 [q] = index2 [i];
+                values [q] = values [i];
+            } else {
+                -- j;
+                if (index1)
+                    index1 [q] = I (keys [j] / size_minor + base);
+                index2 [q] = I (keys [j] % size_minor + base);
+                values [q] = tail [j];
+            }
+        }
+        return true;
+    }
+
+}}}}
+
+#endif
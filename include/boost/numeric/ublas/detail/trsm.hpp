@@ -0,0 +1,118 @@
+//
+//  Copyright (c) 2017
+//  uBLAS developers
+//
+//  Distributed under the Boost Software License, Version 1.0. (See
+//  accompanying file LICENSE_1_0.txt or copy at
+//  http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#ifndef _BOOST_UBLAS_TRSM_
+#define _BOOST_UBLAS_TRSM_
+
+#include <algorithm>
+#include <cstddef>
+
+#include <boost/numeric/ublas/detail/config.hpp>
+#include <boost/numeric/ublas/detail/gemm.hpp>
+#include <boost/numeric/ublas/detail/thread_pool.hpp>
+
+// Blocked triangular solve A X = B with many right hand sides on strided
+// dense storage, X overwriting B.
+//
+// A is walked in diagonal blocks of BOOST_UBLAS_FACTORIZE_BLOCK rows. Each
+// block is solved by substitution, exactly as the unblocked inplace_solve
+// does it, and the rows of B still to be solved are then updated with one
+// gemm. The columns of B are independent of each other and are solved in
+// parallel.
+
+namespace boost { namespace numeric { namespace ublas { namespace detail {
+
+    // Substitution for the diagonal block of rows [j0, j1), columns
+    // [first, last) of B
+    template<class T>
+    void trsm_block (bool upper, bool unit, std::size_t j0, std::size_t j1,
+                     const T *a, std::ptrdiff_t a1, std::ptrdiff_t a2,
+                     T *b, std::ptrdiff_t b1, std::ptrdiff_t b2,
+                     std::size_t first, std::size_t last) {
+        for (std::size_t s = j0; s < j1; ++ s) {
+            const std::size_t i = upper ? j1 - 1 - (s - j0) : s;
+            const T *aci = a + std::ptrdiff_t (i) * a2;
+            T *bi = b + std::ptrdiff_t (i) * b1;
+            for (std::size_t l = first; l < last; ++ l) {
+                T &x = bi [std::ptrdiff_t (l) * b2];
+                if (! unit)
+                    x /= aci [std::ptrdiff_t (i) * a1];
+                const T t = x;
+                if (t == T ())
+                    continue;
+                if (upper) {
+                    for (std::size_t r = j0; r < i; ++ r)
+                        b [std::ptrdiff_t (r) * b1 + std::ptrdiff_t (l) * b2] -= aci [std::ptrdiff_t (r) * a1] * t;
+                } else {
+                    for (std::size_t r = i + 1; r < j1; ++ r)
+                        b [std::ptrdiff_t (r) * b1 + std::ptrdiff_t (l) * b2] -= aci [std::ptrdiff_t (r) * a1] * t;
+                }
+            }
+        }
+    }
+
+    // Solves the columns [first, last) of B
+    template<class T>
+    struct trsm_columns {
+        bool upper, unit;
+        std::size_t n;
+        const T *a;
+        std::ptrdiff_t a1, a2;
+        T *b;
+        std::ptrdiff_t b1, b2;
+
+        void operator () (std::size_t first, std::size_t last) const {
+            const std::size_t block = BOOST_UBLAS_FACTORIZE_BLOCK;
+            T *bl = b + std::ptrdiff_t (first) * b2;
+            for (std::size_t s = 0; s < n; s += block) {
+                if (upper) {
+                    // Bottom up: rows [j0, j1), then B[0, j0) -= A[0, j0)[j0, j1) X[j0, j1)
+                    const std::size_t j1 = n - s;
+                    const std::size_t j0 = j1 - (std::min) (block, j1);
+                    trsm_block (true, unit, j0, j1, a, a1, a2, b, b1, b2, first, last);
+                    if (j0 > 0)
+                        gemm (j0, last - first, j1 - j0, T (-1),
+                              a + std::ptrdiff_t (j0) * a2, a1, a2,
+                              bl + std::ptrdiff_t (j0) * b1, b1, b2,
+                              T (1), bl, b1, b2);
+                } else {
+                    // Top down: rows [j0, j1), then B[j1, n) -= A[j1, n)[j0, j1) X[j0, j1)
+                    const std::size_t j0 = s;
+                    const std::size_t j1 = (std::min) (j0 + block, n);
+                    trsm_block (false, unit, j0, j1, a, a1, a2, b, b1, b2, first, last);
+                    if (j1 < n)
+                        gemm (n - j1, last - first, j1 - j0, T (-1),
+                              a + std::ptrdiff_t (j1) * a1 + std::ptrdiff_t (j0) * a2, a1, a2,
+                              bl + std::ptrdiff_t (j0) * b1, b1, b2,
+                              T (1), bl + std::ptrdiff_t (j1) * b1, b1, b2);
+                }
+            }
+        }
+    };
+
+    // A X = B for the n x n triangular A and the n x k matrix B, X stored
+    // over B. Only the triangle named by upper is read, its diagonal is taken
+    // as one when unit is set.
+    template<class T>
+    void trsm (bool upper, bool unit, std::size_t n, std::size_t k,
+               const T *a, std::ptrdiff_t a1, std::ptrdiff_t a2,
+               T *b, std::ptrdiff_t b1, std::ptrdiff_t b2) {
+        const std::size_t block = BOOST_UBLAS_FACTORIZE_BLOCK;
+        thread_pool &pool = thread_pool::instance ();
+        trsm_columns<T> solve = { upper, unit, n, a, a1, a2, b, b1, b2 };
+        const double cost = double (n) * double (n) * double (k);
+        if (pool.size () > 1 && k > block && cost >= double (BOOST_UBLAS_FACTORIZE_PARALLEL_COST))
+            pool.parallel_for (0, k, block, solve);
+        else
+            solve (0, k);
+    }
+
+}}}}
+
+#endif
@@ -14,6 +14,8 @@
 #define _BOOST_UBLAS_VECTOR_ASSIGN_
 
 #include <boost/numeric/ublas/functional.hpp> // scalar_assign
+#include <boost/numeric/ublas/vector_expression.hpp>
+#include <boost/numeric/ublas/detail/thread_pool.hpp>
 // Required for make_conformant storage
 #include <vector>
 
@@ -95,6 +97,63 @@ namespace detail {
             v (index [k]) = value_type/*zero*/();
     }
 
+    // v += a e and v -= a e through the SIMD kernels
+    template<template <class T1, class T2> class F, class V, class T, class E>
+    BOOST_UBLAS_INLINE
+    bool simd_axpy_assign (V &, const T &, const E &, boost::mpl::false_) {
+        return false;
+    }
+    template<template <class T1, class T2> class F, class V, class T, class E>
+    BOOST_UBLAS_INLINE
+    bool simd_axpy_assign (V &v, const T &a, const E &e, boost::mpl::true_) {
+        typedef typename V::value_type value_type;
+        return simd_axpy (BOOST_UBLAS_SAME (v.size (), e.size ()),
+                          value_type (assign_scale_traits<F>::alpha) * value_type (a),
+                          dense_vector_traits<E>::data (e), dense_vector_traits<V>::data (v),
+                          simd_aligned_at<dense_vector_traits<E>::alignment, value_type> (0) &&
+                          simd_aligned_at<dense_vector_traits<V>::alignment, value_type> (0));
+    }
+    template<template <class T1, class T2> class F, class V, class T, class E>
+    BOOST_UBLAS_INLINE
+    bool simd_axpy_assign (V &v, const T &a, const E &e) {
+        typedef boost::mpl::bool_<assign_scale_traits<F>::value && assign_scale_traits<F>::beta == 1 &&
+                                  dense_vector_traits<V>::value && dense_vector_traits<E>::value &&
+                                  boost::is_same<typename V::value_type, typename E::value_type>::value> is_dense;
+        return simd_axpy_assign<F> (v, a, e, is_dense ());
+    }
+
+    // Dense vector assignments the SIMD kernels handle: v += e, v += t * e,
+    // v += e * t and the same with -=. Returns false, without touching v, for
+    // everything else.
+    template<template <class T1, class T2> class F, class V, class E>
+    BOOST_UBLAS_INLINE
+    bool simd_vector_assign (V &v, const E &e) {
+        return simd_axpy_assign<F> (v, typename V::value_type (1), e);
+    }
+    template<template <class T1, class T2> class F, class V, class T, class E, class U>
+    BOOST_UBLAS_INLINE
+    bool simd_vector_assign (V &v, const vector_binary_scalar1<const T, E, scalar_multiplies<T, U> > &e) {
+        return simd_axpy_assign<F> (v, e.expression1 (), e.expression2 ());
+    }
+    template<template <class T1, class T2> class F, class V, class E, class T, class U>
+    BOOST_UBLAS_INLINE
+    bool simd_vector_assign (V &v, const vector_binary_scalar2<E, const T, scalar_multiplies<U, T> > &e) {
+        return simd_axpy_assign<F> (v, e.expression2 (), e.expression1 ());
+    }
+
+    // Dense vector assignments of expressions with a kernel of their own,
+    // such as the sparse matrix-vector products of spmv.hpp, specialise this
+    // on the expression type. apply returns false, without touching v, when
+    // the kernel does not take the assignment.
+    template<class E>
+    struct vector_assign_kernel {
+        template<template <class T1, class T2> class F, class V>
+        static BOOST_UBLAS_INLINE
+        bool apply (V &, const E &) {
+            return false;
+        }
+    };
+
 }//namespace detail
 
 
@@ -273,6 +332,8 @@ namespace detail {
     template<template <class T1, class T2> class F, class V, class E>
     // BOOST_UBLAS_INLINE This function seems to be big. So we do not let the compiler inline it.
     void vector_assign (V &v, const vector_expression<E> &e, dense_proxy_tag) {
+        if (detail::simd_vector_assign<F> (v, e ()))
+            return;
 #ifdef BOOST_UBLAS_USE_INDEXING
         indexing_vector_assign<F> (v, e);
 #elif BOOST_UBLAS_USE_ITERATING
@@ -481,12 +542,94 @@ namespace detail {
     template<template <class T1, class T2> class F, class V, class E>
     BOOST_UBLAS_INLINE
     void vector_assign (V &v, const vector_expression<E> &e) {
+        if (detail::vector_assign_kernel<E>::template apply<F> (v, e ()))
+            return;
         typedef typename vector_assign_traits<typename V::storage_category,
                                               F<typename V::reference, typename E::value_type>::computed,
                                               typename E::const_iterator::iterator_category>::storage_category storage_category;
         vector_assign<F> (v, e, storage_category ());
     }
 
+namespace detail {
+
+    // Assigns the elements [first, last) on one thread of the pool
+    template<template <class T1, class T2> class F, class V, class E>
+    class vector_assign_range {
+    public:
+        typedef typename V::size_type size_type;
+
+        BOOST_UBLAS_INLINE
+        vector_assign_range (V &v, const E &e):
+            v_ (&v), e_ (&e) {}
+
+        BOOST_UBLAS_INLINE
+        void operator () (size_type first, size_type last) const {
+            typedef F<typename V::reference, typename E::value_type> functor_type;
+            for (size_type i = first; i < last; ++ i)
+                functor_type::apply ((*v_) (i), (*e_) (i));
+        }
+
+    private:
+        V *v_;
+        const E *e_;
+    };
+
+}
+
+    // Multithreaded dense (proxy) case. The index range is split across
+    // detail::thread_pool; v must have dense storage and must not alias e.
+    template<template <class T1, class T2> class F, class V, class E>
+    // BOOST_UBLAS_INLINE This function seems to be big. So we do not let the compiler inline it.
+    void vector_assign (V &v, const vector_expression<E> &e, parallel_tag) {
+        typedef typename V::size_type size_type;
+        size_type size (BOOST_UBLAS_SAME (v.size (), e ().size ()));
+        detail::thread_pool::instance ().parallel_for (0, size, 1, detail::vector_assign_range<F, V, E> (v, e ()));
+    }
+
+namespace detail {
+
+    template<>
+    struct parallel_assigner<vector_tag> {
+        // Dense assignments large enough to be worth the threads
+        template<template <class T1, class T2> class F, class V, class E>
+        static BOOST_UBLAS_INLINE
+        bool use_threads (const V &v, const vector_expression<E> &e) {
+            typedef typename vector_assign_traits<typename V::storage_category,
+                                                  F<typename V::reference, typename E::value_type>::computed,
+                                                  typename E::const_iterator::iterator_category>::storage_category storage_category;
+            return boost::is_convertible<storage_category, dense_proxy_tag>::value &&
+                   thread_pool::instance ().size () > 1 &&
+                   BOOST_UBLAS_SAME (v.size (), e ().size ()) >= std::size_t (BOOST_UBLAS_PARALLEL_THRESHOLD);
+        }
+
+        template<template <class T1, class T2> class F, class V, class E>
+        static BOOST_UBLAS_INLINE
+        bool apply (V &v, const vector_expression<E> &e) {
+            if (! use_threads<F> (v, e))
+                return false;
+            vector_assign<F> (v, e, parallel_tag ());
+            return true;
+        }
+
+        template<class V, class E>
+        static BOOST_UBLAS_INLINE
+        bool assign (V &v, const E &e) {
+            return apply<scalar_assign> (v, e);
+        }
+        template<class V, class E>
+        static BOOST_UBLAS_INLINE
+        bool plus_assign (V &v, const E &e) {
+            return apply<scalar_plus_assign> (v, e);
+        }
+        template<class V, class E>
+        static BOOST_UBLAS_INLINE
+        bool minus_assign (V &v, const E &e) {
+            return apply<scalar_minus_assign> (v, e);
+        }
+    };
+
+}
+
     template<class SC, class RI>
     struct vector_swap_traits {
         typedef SC storage_category;
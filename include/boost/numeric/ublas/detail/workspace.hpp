@@ -0,0 +1,206 @@
+//
+//  Copyright (c) 2017
+//  uBLAS developers
+//
+//  Distributed under the Boost Software License, Version 1.0. (See
+//  accompanying file LICENSE_1_0.txt or copy at
+//  http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#ifndef _BOOST_UBLAS_WORKSPACE_
+#define _BOOST_UBLAS_WORKSPACE_
+
+#include <algorithm>
+#include <cstddef>
+#include <new>
+#include <vector>
+
+#include <boost/noncopyable.hpp>
+#include <boost/static_assert.hpp>
+#include <boost/type_traits/has_trivial_destructor.hpp>
+#include <boost/numeric/ublas/detail/config.hpp>
+#include <boost/numeric/ublas/exception.hpp>
+
+// Scratch memory for the dense product kernels.
+//
+// The fast multiplication paths need large temporary buffers (packed operands,
+// Strassen quadrant sums and products). Instead of going to the allocator at
+// every recursion level they lease contiguous, aligned blocks from a per thread
+// arena. The arena keeps its memory between calls, so repeated products of the
+// same shape do not allocate at all after the first one.
+
+namespace boost { namespace numeric { namespace ublas { namespace detail {
+
+    template<class T>
+    class workspace_arena:
+        private boost::noncopyable {
+        // Elements are never constructed nor destroyed individually.
+        BOOST_STATIC_ASSERT ((boost::has_trivial_destructor<T>::value));
+
+        struct block {
+            void *raw;
+            T *data;
+            std::size_t size;
+            std::size_t used;
+        };
+    public:
+        typedef std::size_t size_type;
+
+        static const size_type alignment = BOOST_UBLAS_WORKSPACE_ALIGN;
+
+        // One arena per thread and value type
+        static BOOST_UBLAS_INLINE
+        workspace_arena &instance () {
+            static thread_local workspace_arena arena;
+            return arena;
+        }
+
+        // Statistics
+        BOOST_UBLAS_INLINE
+        size_type bytes_allocated () const {
+            return bytes_allocated_;
+        }
+        BOOST_UBLAS_INLINE
+        size_type allocations () const {
+            return allocations_;
+        }
+        BOOST_UBLAS_INLINE
+        size_type capacity () const {
+            size_type c = 0;
+            for (size_type i = 0; i < blocks_.size (); ++ i)
+                c += blocks_ [i].size;
+            return c;
+        }
+        BOOST_UBLAS_INLINE
+        void reset_statistics () {
+            bytes_allocated_ = 0;
+            allocations_ = 0;
+        }
+
+        // Give all memory back to the system. Must not be called while leased.
+        BOOST_UBLAS_INLINE
+        void release () {
+            BOOST_UBLAS_CHECK (depth_ == 0, internal_logic ());
+            for (size_type i = 0; i < blocks_.size (); ++ i)
+                ::operator delete (blocks_ [i].raw);
+            blocks_.clear ();
+        }
+
+        ~workspace_arena () {
+            for (size_type i = 0; i < blocks_.size (); ++ i)
+                ::operator delete (blocks_ [i].raw);
+        }
+
+    private:
+        workspace_arena ():
+            blocks_ (), depth_ (0), peak_ (0), bytes_allocated_ (0), allocations_ (0) {}
+
+        static BOOST_UBLAS_INLINE
+        size_type round_up (size_type n) {
+            const size_type per_line = alignment / sizeof (T) > 0 ? alignment / sizeof (T) : 1;
+            return (n + per_line - 1) / per_line * per_line;
+        }
+
+        BOOST_UBLAS_INLINE
+        void add_block (size_type n) {
+            block b;
+            b.raw = ::operator new (n * sizeof (T) + alignment);
+            std::size_t address = reinterpret_cast<std::size_t> (b.raw);
+            address = (address + alignment - 1) / alignment * alignment;
+            b.data = reinterpret_cast<T *> (address);
+            b.size = n;
+            b.used = 0;
+            blocks_.push_back (b);
+            bytes_allocated_ += n * sizeof (T) + alignment;
+            ++ allocations_;
+        }
+
+        // Leases are strictly nested, so the arena works as a stack.
+        BOOST_UBLAS_INLINE
+        T *acquire (size_type n) {
+            n = round_up (n);
+            if (blocks_.empty () || blocks_.back ().size - blocks_.back ().used < n)
+                add_block ((std::max) (n, peak_));
+            block &b = blocks_.back ();
+            T *p = b.data + b.used;
+            b.used += n;
+            ++ depth_;
+            return p;
+        }
+        BOOST_UBLAS_INLINE
+        void restore (size_type blocks, size_type used) {
+            size_type in_use = 0;
+            for (size_type i = 0; i < blocks_.size (); ++ i)
+                in_use += blocks_ [i].used;
+            peak_ = (std::max) (peak_, in_use);
+            if (-- depth_ == 0) {
+                // Outermost lease gone: keep a single block that is large
+                // enough for the whole high water mark.
+                if (blocks_.back ().size < peak_) {
+                    release ();
+                    add_block (peak_);
+                } else {
+                    while (blocks_.size () > 1) {
+                        ::operator delete (blocks_.front ().raw);
+                        blocks_.erase (blocks_.begin ());
+                    }
+                }
+                blocks_.back ().used = 0;
+                return;
+            }
+            // Blocks added while this lease was alive are freed again
+            while (blocks_.size () > blocks) {
+                ::operator delete (blocks_.back ().raw);
+                blocks_.pop_back ();
+            }
+            blocks_.back ().used = used;
+        }
+
+        template<class> friend class workspace;
+
+        std::vector<block> blocks_;
+        size_type depth_;
+        size_type peak_;
+        size_type bytes_allocated_;
+        size_type allocations_;
+    };
+
+    // Scoped lease of n aligned, uninitialised elements from the thread's arena
+    template<class T>
+    class workspace:
+        private boost::noncopyable {
+    public:
+        typedef std::size_t size_type;
+        typedef workspace_arena<T> arena_type;
+
+        explicit BOOST_UBLAS_INLINE
+        workspace (size_type n):
+            arena_ (arena_type::instance ()),
+            blocks_ (arena_.blocks_.size ()),
+            used_ (arena_.blocks_.empty () ? 0 : arena_.blocks_.back ().used),
+            size_ (n), data_ (arena_.acquire (n)) {}
+        BOOST_UBLAS_INLINE
+        ~workspace () {
+            arena_.restore (blocks_, used_);
+        }
+
+        BOOST_UBLAS_INLINE
+        size_type size () const {
+            return size_;
+        }
+        BOOST_UBLAS_INLINE
+        T *data () const {
+            return data_;
+        }
+
+    private:
+        arena_type &arena_;
+        size_type blocks_;
+        size_type used_;
+        size_type size_;
+        T *data_;
+    };
+
+}}}}
+
+#endif
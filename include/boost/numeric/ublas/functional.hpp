@@ -36,6 +36,8 @@ namespace boost { namespace numeric { namespace ublas { namespace raw {
 #endif
 
 #include <boost/numeric/ublas/detail/definitions.hpp>
+#include <boost/numeric/ublas/detail/strassen.hpp>
+#include <boost/numeric/ublas/detail/simd.hpp>
 
 
 
@@ -267,6 +269,37 @@ namespace boost { namespace numeric { namespace ublas {
     const bool scalar_minus_assign<T1,T2>::computed = true;
 #endif
 
+namespace detail {
+
+    // Assignment functors that fold into t1 = beta t1 + alpha t2, so that the
+    // dense kernels can update the destination in place
+    template<template <class T1, class T2> class F>
+    struct assign_scale_traits {
+        static const bool value = false;
+        static const int alpha = 1;
+        static const int beta = 0;
+    };
+    template<>
+    struct assign_scale_traits<scalar_assign> {
+        static const bool value = true;
+        static const int alpha = 1;
+        static const int beta = 0;
+    };
+    template<>
+    struct assign_scale_traits<scalar_plus_assign> {
+        static const bool value = true;
+        static const int alpha = 1;
+        static const int beta = 1;
+    };
+    template<>
+    struct assign_scale_traits<scalar_minus_assign> {
+        static const bool value = true;
+        static const int alpha = -1;
+        static const int beta = 1;
+    };
+
+}
+
     template<class T1, class T2>
     struct scalar_multiplies_assign:
         public scalar_binary_assign_functor<T1, T2> {
@@ -438,10 +471,11 @@ namespace boost { namespace numeric { namespace ublas {
             vector_size_type size (e ().size ());
 #ifndef BOOST_UBLAS_SCALED_NORM
             real_type t = real_type ();
-            for (vector_size_type i = 0; i < size; ++ i) {
-                real_type u (type_traits<value_type>::norm_2 (e () (i)));
-                t +=  u * u;
-            }
+            if (! detail::simd_norm_2_square (e (), t))
+                for (vector_size_type i = 0; i < size; ++ i) {
+                    real_type u (type_traits<value_type>::norm_2 (e () (i)));
+                    t +=  u * u;
+                }
             return static_cast<result_type>(type_traits<real_type>::type_sqrt (t));
 #else
             real_type scale = real_type ();
@@ -534,6 +568,8 @@ namespace boost { namespace numeric { namespace ublas {
         static BOOST_UBLAS_INLINE
         result_type apply (const vector_expression<E> &e) {
             real_type t = real_type ();
+            if (detail::simd_norm_2_square (e (), t))
+                return t;
             typedef typename E::size_type vector_size_type;
             vector_size_type size (e ().size ());
             for (vector_size_type i = 0; i < size; ++ i) {
@@ -737,6 +773,8 @@ namespace boost { namespace numeric { namespace ublas {
             typedef typename E1::size_type vector_size_type;
             vector_size_type size (BOOST_UBLAS_SAME (e1 ().size (), e2 ().size ()));
             result_type t = result_type (0);
+            if (detail::simd_inner_prod (e1 (), e2 (), t))
+                return t;
 #ifndef BOOST_UBLAS_USE_DUFF_DEVICE
             for (vector_size_type i = 0; i < size; ++ i)
                 t += e1 () (i) * e2 () (i);
@@ -874,6 +912,8 @@ namespace boost { namespace numeric { namespace ublas {
                            size_type i) {
             size_type size = BOOST_UBLAS_SAME (e1 ().size2 (), e2 ().size ());
             result_type t = result_type (0);
+            if (detail::simd_row_prod (e1 (), i, e2 (), t))
+                return t;
 #ifndef BOOST_UBLAS_USE_DUFF_DEVICE
             for (size_type j = 0; j < size; ++ j)
                 t += e1 () (i, j) * e2 () (j);
@@ -1042,6 +1082,8 @@ namespace boost { namespace numeric { namespace ublas {
                            size_type i) {
             size_type size = BOOST_UBLAS_SAME (e1 ().size (), e2 ().size1 ());
             result_type t = result_type (0);
+            if (detail::simd_column_prod (e1 (), e2 (), i, t))
+                return t;
 #ifndef BOOST_UBLAS_USE_DUFF_DEVICE
             for (size_type j = 0; j < size; ++ j)
                 t += e1 () (j) * e2 () (j, i);
@@ -1224,6 +1266,8 @@ namespace boost { namespace numeric { namespace ublas {
                            size_type i, size_type j) {
             size_type size = BOOST_UBLAS_SAME (e1 ().size2 (), e2 ().size1 ());
             result_type t = result_type (0);
+            if (detail::simd_element_prod (e1 (), i, e2 (), j, t))
+                return t;
 #ifndef BOOST_UBLAS_USE_DUFF_DEVICE
             for (size_type k = 0; k < size; ++ k)
                 t += e1 () (i, k) * e2 () (k, j);
@@ -1234,261 +1278,23 @@ namespace boost { namespace numeric { namespace ublas {
             return t;
         }
 
-        template<typename T, typename size_type>
-        static BOOST_UBLAS_INLINE
-        void Trivial(T **A, T **B, T **C, size_type I, size_type J, size_type K) {
-            //int I = A.size(), K = A[0].size(), J = B[0].size();
-            for(size_type i=0; i<I; i++) {
-                for(size_type j=0; j<J; j++) {
-                    C[i][j] = 0;
-                    for(size_type k=0; k<K; k++) {
-                        C[i][j] += A[i][k] * B[k][j];
-                    }
-                }
-            }
-        }
-
-        template<typename T>
-        static BOOST_UBLAS_INLINE
-        void Matrix_Add(int N, T **X, T **Y, T **Z){
-            for(int i=0; i<N; i++){
-                for(int j=0; j<N; j++){
-                    Z[i][j] = X[i][j] + Y[i][j];
-                }
-            }
-        }
-
-        template<typename T>
-        static BOOST_UBLAS_INLINE
-        void Matrix_Sub(int N, T **X, T **Y, T **Z){
-            for(int i=0; i<N; i++){
-                for(int j=0; j<N; j++){
-                    Z[i][j] = X[i][j] - Y[i][j];
-                }
-            }
-        }
-
-        template<typename T>
-        static BOOST_UBLAS_INLINE 
-        void Strassen(size_type N, T **A, T **B, T **C) {
-            if(N == 512) {
-                Trivial(A, B, C, N, N, N);
-                return;
-            } 
-            
-            T **A11 = new T*[N]; T **A12 = new T*[N]; T **A21 = new T*[N]; T **A22 = new T*[N];
-            T **B11 = new T*[N]; T **B12 = new T*[N]; T **B21 = new T*[N]; T **B22 = new T*[N];
-            T **C11 = new T*[N]; T **C12 = new T*[N]; T **C21 = new T*[N]; T **C22 = new T*[N];
-            T **P1 = new T*[N]; T **P2 = new T*[N]; T **P3 = new T*[N]; T **P4 = new T*[N]; T **P5 = new T*[N]; T **P6 = new T*[N]; T **P7 = new T*[N];
-            T **AA = new T*[N]; T **BB = new T*[N];
-
-            for(size_type i=0; i<N; i++) {
-                A11[i] = new T[N]; A12[i] = new T[N]; A21[i] = new T[N]; A22[i] = new T[N];
-                B11[i] = new T[N]; B12[i] = new T[N]; B21[i] = new T[N]; B22[i] = new T[N];
-                C11[i] = new T[N]; C12[i] = new T[N]; C21[i] = new T[N]; C22[i] = new T[N];
-                P1[i] = new T[N]; P2[i] = new T[N]; P3[i] = new T[N]; P4[i] = new T[N]; P5[i] = new T[N]; P6[i] = new T[N]; P7[i] = new T[N];
-                AA[i] = new T[N]; BB[i] = new T[N];
-            }
-
-            size_type mid = N>>1;
-            for(uint i=0; i<N; i++){
-                for(uint j=0;j<N;j++){
-                    if(i<mid && j<mid)
-                        A11[i][j] = A[i][j];
-                    else if(i<mid)
-                        A12[i][j-mid] = A[i][j];
-                    else if(i>=mid && j<mid)
-                        A21[i-mid][j] = A[i][j];
-                    else
-                        A22[i-mid][j-mid] = A[i][j];
-
-                    if(i<mid && j<mid)
-                        B11[i][j] = B[i][j];
-                    else if(i<mid)
-                        B12[i][j-mid] = B[i][j];
-                    else if(i>=mid && j<mid)
-                        B21[i-mid][j] = B[i][j];
-                    else
-                        B22[i-mid][j-mid] = B[i][j];
-                }
-            }
-
-            Matrix_Add(N>>1, A11, A22, AA);
-            Matrix_Add(N>>1, B11, B22, BB);
-            Strassen(N>>1, AA, BB, P1);
-
-            Matrix_Add(N>>1, A21, A22, AA);
-            Strassen(N>>1, AA, B11, P2);
-
-            Matrix_Sub(N>>1, B12, B22, BB);
-            Strassen(N>>1, A11, BB, P3);
-
-            //Calculate M4 = A3 × (B2 - B0)
-            Matrix_Sub((N>>1), B21, B11, BB);
-            Strassen((N>>1), A22, BB, P4);
-
-            //Calculate M5 = (A0 + A1) × B3
-            Matrix_Add((N>>1), A11, A12, AA);
-            Strassen((N>>1), AA, B22, P5);
-
-            //Calculate M6 = (A2 - A0) × (B0 + B1)
-            Matrix_Sub((N>>1), A21, A11, AA);
-            Matrix_Add((N>>1), B11, B12, BB);
-            Strassen((N>>1), AA, BB, P6);
-
-            //Calculate M7 = (A1 - A3) × (B2 + B3)
-            Matrix_Sub((N>>1), A12, A22, AA);
-            Matrix_Add((N>>1), B21, B22, BB);
-            Strassen((N>>1), AA, BB, P7);
-
-            //Calculate C0 = M1 + M4 - M5 + M7
-            Matrix_Add((N>>1), P1, P4, AA);
-            Matrix_Sub((N>>1), P7, P5, BB);
-            Matrix_Add((N>>1), AA, BB, C11);
-
-            //Calculate C1 = M3 + M5
-            Matrix_Add((N>>1), P3, P5, C12);
-
-            //Calculate C2 = M2 + M4
-            Matrix_Add((N>>1), P2, P4, C21);
-
-            //Calculate C3 = M1 - M2 + M3 + M6
-            Matrix_Sub((N>>1), P1, P2, AA);
-            Matrix_Add((N>>1), P3, P6, BB);
-            Matrix_Add((N>>1), AA, BB, C22);
-
-            //Set the result to C[][N]
-             for(int i=0; i<N; i++) {
-                for(int j=0; j<N; j++) {
-                  if(i<mid && j<mid)
-                    C[i][j] = C11[i][j];
-                  else if(i<mid)
-                    C[i][j] = C12[i][j-mid];
-                  else if(i>=mid && j<mid)
-                    C[i][j] = C21[i-mid][j];
-                  else
-                    C[i][j] = C22[i-mid][j-mid];
-                }
-            }
-
-            for(size_type i=0; i<N; i++) {
-                delete [] A11[i]; delete [] A12[i]; delete [] A21[i]; delete [] A22[i];
-                delete [] B11[i]; delete [] B12[i]; delete [] B21[i]; delete [] B22[i];
-                delete [] C11[i]; delete [] C12[i]; delete [] C21[i]; delete [] C22[i];
-                delete [] P1[i]; delete [] P2[i]; delete [] P3[i]; delete [] P4[i]; delete [] P5[i]; delete [] P6[i]; delete [] P7[i];
-                delete [] AA[i]; delete [] BB[i];
-            }
-            delete [] A11; delete [] A12; delete [] A21; delete [] A22;
-            delete [] B11; delete [] B12; delete [] B21; delete [] B22;
-            delete [] C11; delete [] C12; delete [] C21; delete [] C22;
-            delete [] P1; delete [] P2; delete [] P3; delete [] P4; delete [] P5; delete [] P6; delete [] P7;
-            delete [] AA; delete [] BB;
-        }
-
-        template<typename T>
-        static BOOST_UBLAS_INLINE
-        T getSize(T a, T b, T c, T d) {
-            T Max = std::max(a, std::max(b, std::max(c,d)));
-            T Size = 1;
-            while(Size < Max)
-                Size <<= 1;
-            return Size;
-        }
-
-        template<typename E1, typename E2, typename T>
-        static BOOST_UBLAS_INLINE
-        void assign_values(const matrix_expression<E1> &e1,
-                           const matrix_expression<E2> &e2,
-                           T** &A, 
-                           T** &B,
-                           T** &C, 
-                           bool isLarge) {
-            
-            for(int i=0; i<e1().size1(); i++) {
-                for(int j=0; j<e1().size2(); j++) {
-                    //std::cout << i << "\t" << j << "---------->>>>>>>>>>>\n";
-                    A[i][j] = e1 () (i,j);
-                }
-            }
-            
-            for(size_type i=0; i<e2().size1(); i++) {
-                for(size_type j=0; j<e2().size2(); j++) {
-                    B[i][j] = e2 () (i,j);
-                }
-            }
-        }
-
         template<typename E1, typename E2>
         static BOOST_UBLAS_INLINE
         bool check(const matrix_expression<E1> &e1,
                    const matrix_expression<E2> &e2) {
-            typedef long long int lli;
-            lli operations = (lli) e1().size1() * (lli) e1().size2() * (lli) e2().size2();
-            if(operations > (1<<28)) 
-                return true;
-            return false;
+            return detail::strassen_pays<result_type> (e1 ().size1 (), e2 ().size2 (), e1 ().size2 ());
         }
 
+        // Whole product into an array of row pointers C [size1] [size2]
         template<class E1, class E2, typename T>
         static BOOST_UBLAS_INLINE
-        result_type apply(const matrix_expression<E1> &e1,
-                          const matrix_expression<E2> &e2,
-                          T **C) {
-            // ...
-            value_type **A, **B;
-            bool isLarge = check(e1, e2);
-            
-            BOOST_UBLAS_SAME(e1().size2(), e2().size1());
-            
-            if(isLarge) {
-                size_type size = getSize(e1().size1(), e1().size2(), e2().size1(), e2().size2());
-                A = new value_type*[size]; B = new value_type*[size];
-                for(size_type i=0;i<size; i++) {
-                    A[i] = new value_type[size]();
-                    B[i] = new value_type[size](); 
-                }
-            }
-            else {
-                size_type rowA = e1().size1(), rowB = e2().size1();
-                size_type colA = e1().size2(), colB = e2().size2();
-                A = new value_type*[rowA];    B = new value_type*[rowB];
-                for(int i=0; i<rowA; i++) {
-                    A[i] = new value_type[colA]();
-                }
-                for(int i=0; i<rowB; i++) {
-                    B[i] = new value_type[colB]();
-                }
-            }
-
-            assign_values(e1, e2, A, B, C, isLarge);
-            if(isLarge){
-                size_type size = getSize(e1().size1(), e1().size2(), e2().size1(), e2().size2());
-                Strassen(size, A, B, C);
-            }
-            else{
-                Trivial(A, B, C, e1().size1(), e2().size2(), e1().size2()); 
-            } 
-            
-            if(isLarge) {
-                size_type size = getSize(e1().size1(), e1().size2(), e2().size1(), e2().size2());
-                for(size_type i=0; i<size; i++) {
-                    delete[] A[i];
-                    delete[] B[i];
-                }
-                delete[] A; delete[] B;
-            }
-            else {
-                size_type rowA = e1().size1(), rowB = e2().size1();
-                for(size_type i=0; i<rowA; i++) {
-                    delete [] A[i];
-                }
-                delete [] A;
-                for(size_type i=0; i<rowB; i++) {
-                    delete [] B[i];
-                }
-                delete [] B;
-            }
-        } 
+        void apply(const matrix_expression<E1> &e1,
+                   const matrix_expression<E2> &e2,
+                   T **C) {
+            size_type size = BOOST_UBLAS_SAME (e1 ().size2 (), e2 ().size1 ());
+            detail::row_pointer_adaptor<T> c (C);
+            detail::strassen_prod<T> (e1 ().size1 (), size, e2 ().size2 (), e1 (), e2 (), c, check (e1, e2));
+        }
 
         // Dense case
         template<class I1, class I2>
@@ -24,6 +24,9 @@
 namespace boost { namespace numeric { namespace ublas {
 
     // Storage types
+    template<class T, std::size_t Align>
+    class aligned_allocator;
+
     template<class T, class ALLOC = std::allocator<T> >
     class unbounded_array;
 
@@ -43,6 +46,8 @@ namespace boost { namespace numeric { namespace ublas {
     class map_std;
     template<class I, class T, class ALLOC = std::allocator<std::pair<I, T> > >
     class map_array;
+    template<class I, class T, class ALLOC = std::allocator<std::pair<I, T> > >
+    class map_hash;
 
     // Expression types
     struct scalar_tag {};
@@ -223,6 +228,10 @@ namespace boost { namespace numeric { namespace ublas {
     class compressed_matrix;
     template<class T, class L = row_major, std::size_t IB = 0, class IA = unbounded_array<std::size_t>, class TA = unbounded_array<T> >
     class coordinate_matrix;
+    template<class T, std::size_t C = 8, class IA = unbounded_array<std::size_t>, class TA = unbounded_array<T> >
+    class sliced_ell_matrix;
+    template<class T, std::size_t BR, std::size_t BC, class IA = unbounded_array<std::size_t>, class TA = unbounded_array<T> >
+    class block_compressed_matrix;
 
 }}}
 
@@ -16,7 +16,9 @@
 // Only forward definition required to define stream operations
 #include <iosfwd>
 #include <sstream>
+#include <boost/mpl/bool.hpp>
 #include <boost/numeric/ublas/matrix_expression.hpp>
+#include <boost/numeric/ublas/detail/text_io.hpp>
 
 
 namespace boost { namespace numeric { namespace ublas {
@@ -48,6 +50,9 @@ namespace boost { namespace numeric { namespace ublas {
     std::basic_ostream<E, T> &operator << (std::basic_ostream<E, T> &os,
                                            const vector_expression<VE> &v) {
         typedef typename VE::size_type size_type;
+        // Narrow streams of numbers are formatted without the stream
+        if (detail::write_text_vector (os, v (), boost::mpl::bool_<detail::text_value<typename VE::value_type>::value> ()))
+            return os;
         size_type size = v ().size ();
         std::basic_ostringstream<E, T, std::allocator<E> > s;
         s.flags (os.flags ());
@@ -89,6 +94,9 @@ namespace boost { namespace numeric { namespace ublas {
     std::basic_istream<E, T> &operator >> (std::basic_istream<E, T> &is,
                                            vector<VT, VA> &v) {
         typedef typename vector<VT, VA>::size_type size_type;
+        // Narrow streams of numbers are parsed from a buffer
+        if (detail::read_text_vector (is, v, boost::mpl::bool_<detail::text_value<VT>::value> ()))
+            return is;
         E ch;
         size_type size;
         if (is >> ch && ch != '[') {
@@ -150,6 +158,9 @@ namespace boost { namespace numeric { namespace ublas {
     std::basic_ostream<E, T> &operator << (std::basic_ostream<E, T> &os,
                                            const matrix_expression<ME> &m) {
         typedef typename ME::size_type size_type;
+        // Narrow streams of numbers are formatted without the stream
+        if (detail::write_text_matrix (os, m (), boost::mpl::bool_<detail::text_value<typename ME::value_type>::value> ()))
+            return os;
         size_type size1 = m ().size1 ();
         size_type size2 = m ().size2 ();
         std::basic_ostringstream<E, T, std::allocator<E> > s;
@@ -201,6 +212,9 @@ namespace boost { namespace numeric { namespace ublas {
     std::basic_istream<E, T> &operator >> (std::basic_istream<E, T> &is,
                                            matrix<MT, MF, MA> &m) {
         typedef typename matrix<MT, MF, MA>::size_type size_type;
+        // Narrow streams of numbers are parsed from a buffer
+        if (detail::read_text_matrix (is, m, boost::mpl::bool_<detail::text_value<MT>::value> ()))
+            return is;
         E ch;
         size_type size1, size2;
         if (is >> ch && ch != '[') {
@@ -283,6 +297,9 @@ namespace boost { namespace numeric { namespace ublas {
     std::basic_istream<E, T> &operator >> (std::basic_istream<E, T> &is,
                                            symmetric_matrix<MT, MF1, MF2, MA> &m) {
         typedef typename symmetric_matrix<MT, MF1, MF2, MA>::size_type size_type;
+        // Narrow streams of numbers are parsed from a buffer
+        if (detail::read_text_triangles (is, m, boost::mpl::bool_<detail::text_value<MT>::value> ()))
+            return is;
         E ch;
         size_type size1, size2;
         MT value;
@@ -348,7 +365,96 @@ namespace boost { namespace numeric { namespace ublas {
         }
         return is;
     }
- 
+
+    /** \brief special input stream operator for hermitian matrices
+     *
+     * This is used to feed in hermitian matrices with data stored as an ASCII
+     * representation from a standard input stream, in the format of matrices:
+     * \code [<rows>,<columns>]((<m00>,<m01>,...,<m0N>),...,(<mM0>,<mM1>,...,<mMN>)) \endcode
+     *
+     * You can only put data into a valid \c hermitian_matrix<>, not in a \c matrix_expression
+     * This function also checks that each element below the diagonal is the conjugate
+     * of the one above it
+     *
+     * \param is is a standard basic input stream
+     * \param m is a \c hermitian_matrix
+     * \return a reference to the resulting input stream
+     */
+    template<class E, class T, class MT, class MF1, class MF2, class MA>
+    // BOOST_UBLAS_INLINE This function seems to be big. So we do not let the compiler inline it.
+    std::basic_istream<E, T> &operator >> (std::basic_istream<E, T> &is,
+                                           hermitian_matrix<MT, MF1, MF2, MA> &m) {
+        typedef typename hermitian_matrix<MT, MF1, MF2, MA>::size_type size_type;
+        // Narrow streams of numbers are parsed from a buffer
+        if (detail::read_text_triangles (is, m, boost::mpl::bool_<detail::text_value<MT>::value> ()))
+            return is;
+        E ch;
+        size_type size1, size2;
+        MT value;
+        if (is >> ch && ch != '[') {
+            is.putback (ch);
+            is.setstate (std::ios_base::failbit);
+        } else if (is >> size1 >> ch && ch != ',') {
+            is.putback (ch);
+            is.setstate (std::ios_base::failbit);
+        } else if (is >> size2 >> ch && (size2 != size1 || ch != ']')) { // hermitian matrix must be square
+            is.putback (ch);
+            is.setstate (std::ios_base::failbit);
+        } else if (! is.fail ()) {
+            hermitian_matrix<MT, MF1, MF2, MA> s (size1, size2);
+            const hermitian_matrix<MT, MF1, MF2, MA> &cs (s);
+            if (is >> ch && ch != '(') {
+                is.putback (ch);
+                is.setstate (std::ios_base::failbit);
+            } else if (! is.fail ()) {
+                for (size_type i = 0; i < size1; i ++) {
+                    if (is >> ch && ch != '(') {
+                        is.putback (ch);
+                        is.setstate (std::ios_base::failbit);
+                        break;
+                    }
+                    for (size_type j = 0; j < size2; j ++) {
+                        if (is >> value >> ch && ch != ',') {
+                            is.putback (ch);
+                            if (j < size2 - 1) {
+                                is.setstate (std::ios_base::failbit);
+                                break;
+                            }
+                        }
+                        if (i <= j) {
+                            // this is the first time we read this element - set the value
+                            s.insert_element (i, j, value);
+                        }
+                        else if (cs (i, j) != value) {
+                            // matrix is not hermitian
+                            is.setstate (std::ios_base::failbit);
+                            break;
+                        }
+                    }
+                    if (is >> ch && ch != ')') {
+                        is.putback (ch);
+                        is.setstate (std::ios_base::failbit);
+                        break;
+                    }
+                    if (is >> ch && ch != ',') {
+                        is.putback (ch);
+                        if (i < size1 - 1) {
+                            is.setstate (std::ios_base::failbit);
+                            break;
+                        }
+                    }
+                }
+                if (is >> ch && ch != ')') {
+                    is.putback (ch);
+                    is.setstate (std::ios_base::failbit);
+                }
+            }
+            if (! is.fail ())
+                m.swap (s);
+        }
+        return is;
+    }
+
 
 }}}
 
@@ -18,6 +18,8 @@
 #include <boost/numeric/ublas/matrix_proxy.hpp>
 #include <boost/numeric/ublas/vector.hpp>
 #include <boost/numeric/ublas/triangular.hpp>
+#include <boost/numeric/ublas/detail/dense_traits.hpp>
+#include <boost/numeric/ublas/detail/getrf.hpp>
 
 // LU factorizations in the spirit of LAPACK and Golub & van Loan
 
@@ -88,6 +90,35 @@ namespace boost { namespace numeric { namespace ublas {
         swap_rows (pm, mv, typename MV::type_category ());
     }
 
+namespace detail {
+
+    template<class M, class PM>
+    BOOST_UBLAS_INLINE
+    bool blocked_lu_factorize (M &, PM &, typename M::size_type &, boost::mpl::false_) {
+        return false;
+    }
+    template<class M, class PM>
+    BOOST_UBLAS_INLINE
+    bool blocked_lu_factorize (M &m, PM &pm, typename M::size_type &singular, boost::mpl::true_) {
+        typedef dense_matrix_traits<M> traits;
+        const std::size_t block = BOOST_UBLAS_FACTORIZE_BLOCK;
+        // A single panel is the unblocked algorithm anyway
+        if ((std::min) (m.size1 (), m.size2 ()) <= block)
+            return false;
+        singular = getrf (m.size1 (), m.size2 (), traits::data (m), traits::stride1 (m), traits::stride2 (m), pm);
+        return true;
+    }
+
+    // Partial pivoting LU factorization of dense matrices through getrf.
+    // Returns false, without touching m, for any other matrix.
+    template<class M, class PM>
+    BOOST_UBLAS_INLINE
+    bool blocked_lu_factorize (M &m, PM &pm, typename M::size_type &singular) {
+        return blocked_lu_factorize (m, pm, singular, boost::mpl::bool_<dense_matrix_traits<M>::value> ());
+    }
+
+}
+
     // LU factorization without pivoting
     template<class M>
     typename M::size_type lu_factorize (M &m) {
@@ -139,26 +170,29 @@ namespace boost { namespace numeric { namespace ublas {
         size_type size1 = m.size1 ();
         size_type size2 = m.size2 ();
         size_type size = (std::min) (size1, size2);
-        for (size_type i = 0; i < size; ++ i) {
-            matrix_column<M> mci (column (m, i));
-            matrix_row<M> mri (row (m, i));
-            size_type i_norm_inf = i + index_norm_inf (project (mci, range (i, size1)));
-            BOOST_UBLAS_CHECK (i_norm_inf < size1, external_logic ());
-            if (m (i_norm_inf, i) != value_type/*zero*/()) {
-                if (i_norm_inf != i) {
-                    pm (i) = i_norm_inf;
-                    row (m, i_norm_inf).swap (mri);
-                } else {
-                    BOOST_UBLAS_CHECK (pm (i) == i_norm_inf, external_logic ());
+        // Large dense matrices are factored blockwise
+        if (! detail::blocked_lu_factorize (m, pm, singular)) {
+            for (size_type i = 0; i < size; ++ i) {
+                matrix_column<M> mci (column (m, i));
+                matrix_row<M> mri (row (m, i));
+                size_type i_norm_inf = i + index_norm_inf (project (mci, range (i, size1)));
+                BOOST_UBLAS_CHECK (i_norm_inf < size1, external_logic ());
+                if (m (i_norm_inf, i) != value_type/*zero*/()) {
+                    if (i_norm_inf != i) {
+                        pm (i) = i_norm_inf;
+                        row (m, i_norm_inf).swap (mri);
+                    } else {
+                        BOOST_UBLAS_CHECK (pm (i) == i_norm_inf, external_logic ());
+                    }
+                    value_type m_inv = value_type (1) / m (i, i);
+                    project (mci, range (i + 1, size1)) *= m_inv;
+                } else if (singular == 0) {
+                    singular = i + 1;
                 }
-                value_type m_inv = value_type (1) / m (i, i);
-                project (mci, range (i + 1, size1)) *= m_inv;
-            } else if (singular == 0) {
-                singular = i + 1;
+                project (m, range (i + 1, size1), range (i + 1, size2)).minus_assign (
+                    outer_prod (project (mci, range (i + 1, size1)),
+                                project (mri, range (i + 1, size2))));
             }
-            project (m, range (i + 1, size1), range (i + 1, size2)).minus_assign (
-                outer_prod (project (mci, range (i + 1, size1)),
-                            project (mri, range (i + 1, size2))));
         }
 #if BOOST_UBLAS_TYPE_CHECK
         swap_rows (pm, cm);
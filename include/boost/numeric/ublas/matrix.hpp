@@ -82,6 +82,10 @@ namespace boost { namespace numeric {
      * the \f$(i.n + j)\f$-th element of the container for row major orientation or the \f$ (i + j.m) \f$-th element of 
      * the container for column major orientation. In a dense matrix all elements are represented in memory in a 
      * contiguous chunk of memory by definition.
+     *
+     * Rows (row major) or columns (column major) may be padded to a leading dimension \f$ld\f$ larger than \f$n\f$
+     * or \f$m\f$: the elements are then mapped to \f$(i.ld + j)\f$ or \f$(i + j.ld)\f$. Strides of a power of two
+     * map the elements of a column (row major) to few cache sets; \c padded_leading_dimension picks one that does not.
      * 
      * Orientation and storage can also be specified, otherwise a \c row_major and \c unbounded_array are used. It is \b not 
      * required by the storage to initialize elements of the matrix.
@@ -124,7 +128,7 @@ namespace boost { namespace numeric {
         BOOST_UBLAS_INLINE
         matrix ():
             matrix_container<self_type> (),
-            size1_ (0), size2_ (0), data_ () {}
+            size1_ (0), size2_ (0), ld_ (0), data_ () {}
     
       /** Dense matrix constructor with defined size
        * \param size1 number of rows
@@ -133,7 +137,8 @@ namespace boost { namespace numeric {
         BOOST_UBLAS_INLINE
         matrix (size_type size1, size_type size2):
             matrix_container<self_type> (),
-            size1_ (size1), size2_ (size2), data_ (layout_type::storage_size (size1, size2)) {
+            size1_ (size1), size2_ (size2), ld_ (layout_type::size_m (size1, size2)),
+            data_ (layout_type::storage_size (size1, size2)) {
         }
     
       /** Dense matrix constructor with defined size a initial value for all the matrix elements
@@ -143,7 +148,22 @@ namespace boost { namespace numeric {
        */
         matrix (size_type size1, size_type size2, const value_type &init):
             matrix_container<self_type> (),
-            size1_ (size1), size2_ (size2), data_ (layout_type::storage_size (size1, size2), init) {
+            size1_ (size1), size2_ (size2), ld_ (layout_type::size_m (size1, size2)),
+            data_ (layout_type::storage_size (size1, size2), init) {
+        }
+
+      /** Dense matrix constructor with defined size, leading dimension and an initial value for all the matrix elements
+       * \param size1 number of rows
+       * \param size2 number of columns
+       * \param ld distance in the storage between consecutive rows (row major) or columns (column major), at least
+       * \c size2 or \c size1 respectively
+       * \param init initial value assigned to all elements, and to the padding
+       */
+        matrix (size_type size1, size_type size2, size_type ld, const value_type &init):
+            matrix_container<self_type> (),
+            size1_ (size1), size2_ (size2), ld_ (ld),
+            data_ (layout_type::storage_size (storage_size1 (), storage_size2 ()), init) {
+            BOOST_UBLAS_CHECK (ld >= layout_type::size_m (size1, size2), bad_size ());
         }
 
       /** Dense matrix constructor with defined size and an initial data array
@@ -154,7 +174,7 @@ namespace boost { namespace numeric {
         BOOST_UBLAS_INLINE
         matrix (size_type size1, size_type size2, const array_type &data):
             matrix_container<self_type> (),
-            size1_ (size1), size2_ (size2), data_ (data) {}
+            size1_ (size1), size2_ (size2), ld_ (layout_type::size_m (size1, size2)), data_ (data) {}
 
       /** Copy-constructor of a dense matrix
        * \param m is a dense matrix
@@ -162,7 +182,7 @@ namespace boost { namespace numeric {
         BOOST_UBLAS_INLINE
         matrix (const matrix &m):
             matrix_container<self_type> (),
-            size1_ (m.size1_), size2_ (m.size2_), data_ (m.data_) {}
+            size1_ (m.size1_), size2_ (m.size2_), ld_ (m.ld_), data_ (m.data_) {}
 
       /** Copy-constructor of a dense matrix from a matrix expression
        * \param ae is a matrix expression
@@ -171,7 +191,8 @@ namespace boost { namespace numeric {
         BOOST_UBLAS_INLINE
         matrix (const matrix_expression<AE> &ae):
             matrix_container<self_type> (),
-            size1_ (ae ().size1 ()), size2_ (ae ().size2 ()), data_ (layout_type::storage_size (size1_, size2_)) {
+            size1_ (ae ().size1 ()), size2_ (ae ().size2 ()), ld_ (layout_type::size_m (size1_, size2_)),
+            data_ (layout_type::storage_size (size1_, size2_)) {
             matrix_assign<scalar_assign> (*this, ae);
         }
 
@@ -179,7 +200,8 @@ namespace boost { namespace numeric {
         BOOST_UBLAS_INLINE
         matrix (const binop<E1, E2, OT> &o):
             matrix_container<self_type> (),
-            size1_ (o.size1()), size2_ (o.size2()), data_ (layout_type::storage_size (size1_, size2_)) {
+            size1_ (o.size1()), size2_ (o.size2()), ld_ (layout_type::size_m (size1_, size2_)),
+            data_ (layout_type::storage_size (size1_, size2_)) {
                 chain_matrix_assign (*this, o);
         }
 
@@ -200,6 +222,15 @@ namespace boost { namespace numeric {
             return size2_;
         }
 
+      /** Return the leading dimension of the matrix, the distance in the storage between consecutive rows for row
+       * major orientation or columns for column major orientation. It is \c size2 or \c size1 unless the matrix
+       * was made or resized with a larger one
+       */
+        BOOST_UBLAS_INLINE
+        size_type leading_dimension () const {
+            return ld_;
+        }
+
         // Storage accessors
       /** Return a constant reference to the internal storage of a dense matrix, i.e. the raw data
        * It's type depends on the type used by the matrix to store its data
@@ -223,17 +254,42 @@ namespace boost { namespace numeric {
        * \param size1 the new number of rows
        * \param size2 the new number of colums
        * \param preserve a boolean to say if one wants the data to be preserved during the resizing. Default is true.
+       * The rows (row major) or columns (column major) of the resized matrix are not padded.
        */
         BOOST_UBLAS_INLINE
         void resize (size_type size1, size_type size2, bool preserve = true) {
+            resize (size1, size2, layout_type::size_m (size1, size2), preserve);
+        }
+
+      /** Resize a matrix to new dimensions and a new leading dimension
+       * \param size1 the new number of rows
+       * \param size2 the new number of colums
+       * \param ld the new leading dimension, at least \c size2 (row major) or \c size1 (column major)
+       * \param preserve a boolean to say if one wants the data to be preserved during the resizing
+       */
+        BOOST_UBLAS_INLINE
+        void resize (size_type size1, size_type size2, size_type ld, bool preserve) {
+            BOOST_UBLAS_CHECK (ld >= layout_type::size_m (size1, size2), bad_size ());
             if (preserve) {
-                self_type temporary (size1, size2);
-                detail::matrix_resize_preserve<layout_type> (*this, temporary);
+                self_type temporary;
+                temporary.resize (size1, size2, ld, false);
+                // Common elements to preserve, by major
+                const size_type major_size = layout_type::size_M ((std::min) (size1, size1_), (std::min) (size2, size2_));
+                const size_type minor_size = layout_type::size_m ((std::min) (size1, size1_), (std::min) (size2, size2_));
+                for (size_type major = 0; major != major_size; ++ major) {
+                    for (size_type minor = 0; minor != minor_size; ++ minor) {
+                        const size_type i = layout_type::index_M (major, minor);
+                        const size_type j = layout_type::index_m (major, minor);
+                        temporary.at_element (i, j) = at_element (i, j);
+                    }
+                }
+                assign_temporary (temporary);
             }
             else {
-                data ().resize (layout_type::storage_size (size1, size2));
                 size1_ = size1;
                 size2_ = size2;
+                ld_ = ld;
+                data ().resize (layout_type::storage_size (storage_size1 (), storage_size2 ()));
             }
         }
 
@@ -246,7 +302,9 @@ namespace boost { namespace numeric {
      */
         BOOST_UBLAS_INLINE
         const_reference operator () (size_type i, size_type j) const {
-            return data () [layout_type::element (i, size1_, j, size2_)];
+            BOOST_UBLAS_CHECK (i < size1_, bad_index ());
+            BOOST_UBLAS_CHECK (j < size2_, bad_index ());
+            return data () [layout_type::element (i, storage_size1 (), j, storage_size2 ())];
         }
 
     /** Access a matrix element. Here we return a reference
@@ -256,7 +314,9 @@ namespace boost { namespace numeric {
      */
         BOOST_UBLAS_INLINE
         reference at_element (size_type i, size_type j) {
-            return data () [layout_type::element (i, size1_, j, size2_)];
+            BOOST_UBLAS_CHECK (i < size1_, bad_index ());
+            BOOST_UBLAS_CHECK (j < size2_, bad_index ());
+            return data () [layout_type::element (i, storage_size1 (), j, storage_size2 ())];
         }
 
     /** Access a matrix element. Here we return a reference
@@ -318,6 +378,7 @@ namespace boost { namespace numeric {
         matrix &operator = (const matrix &m) {
             size1_ = m.size1_;
             size2_ = m.size2_;
+            ld_ = m.ld_;
             data () = m.data ();
             return *this;
         }
@@ -325,7 +386,8 @@ namespace boost { namespace numeric {
         template<class C>          // Container assignment without temporary
         BOOST_UBLAS_INLINE
         matrix &operator = (const matrix_container<C> &m) {
-            resize (m ().size1 (), m ().size2 (), false);
+            if (size1_ != m ().size1 () || size2_ != m ().size2 ())
+                resize (m ().size1 (), m ().size2 (), false);
             assign (m);
             return *this;
         }
@@ -337,17 +399,33 @@ namespace boost { namespace numeric {
         template<class AE>
         BOOST_UBLAS_INLINE
         matrix &operator = (const matrix_expression<AE> &ae) {
-            self_type temporary (ae);
+            self_type temporary;
+            resize_temporary (temporary, ae ().size1 (), ae ().size2 ());
+            matrix_assign<scalar_assign> (temporary, ae);
             return assign_temporary (temporary);
         }
 
         template<class E1, class E2, class OT>
         BOOST_UBLAS_INLINE  
         matrix &operator = (const binop<E1, E2, OT> &o) {
-            self_type temporary (o); 
+            self_type temporary;
+            resize_temporary (temporary, o.size1 (), o.size2 ());
+            chain_matrix_assign (temporary, o);
             return assign_temporary (temporary);  
         }  
 
+        // Chain products detect operands that share the storage
+        template<class E1, class E2>
+        BOOST_UBLAS_INLINE
+        matrix &operator = (const binop<E1, E2, multOp> &o) {
+            if (size1_ != o.size1 () || size2_ != o.size2 ()) {
+                self_type temporary (o);
+                return assign_temporary (temporary);
+            }
+            chain_matrix_assign<scalar_assign> (*this, o);
+            return *this;
+        }
+
         template<class AE>
         BOOST_UBLAS_INLINE
         matrix &assign (const matrix_expression<AE> &ae) {
@@ -358,23 +436,24 @@ namespace boost { namespace numeric {
         template<class E1, class E2>
         BOOST_UBLAS_INLINE
         matrix &assign (const binop<E1, E2, multOp> &o) {
-            self_type temporary = matrix_chain_controller(o);
-            matrix_assign<scalar_assign> (*this, temporary);
+            chain_matrix_assign<scalar_assign> (*this, o);
             return *this;
         }
 
         template<class AE>
         BOOST_UBLAS_INLINE
         matrix& operator += (const matrix_expression<AE> &ae) {
-            self_type temporary (*this + ae);
+            self_type temporary;
+            resize_temporary (temporary, size1_, size2_);
+            matrix_assign<scalar_assign> (temporary, *this + ae);
             return assign_temporary (temporary); 
         }
 
         template<class E1, class E2>
         BOOST_UBLAS_INLINE
         matrix& operator += (const binop<E1, E2, multOp> &o) {
-            self_type temporary (*this + matrix_chain_controller(o));
-            return assign_temporary(temporary);
+            chain_matrix_assign<scalar_plus_assign> (*this, o);
+            return *this;
         }
 
         template<class C>          // Container assignment without temporary
@@ -393,23 +472,24 @@ namespace boost { namespace numeric {
         template<class E1, class E2>
         BOOST_UBLAS_INLINE
         matrix &plus_assign (const binop<E1, E2, multOp> &o) {
-            self_type temporary = matrix_chain_controller(o);
-            matrix_assign<scalar_plus_assign> (*this, temporary);
+            chain_matrix_assign<scalar_plus_assign> (*this, o);
             return *this;
         }
 
         template<class AE>
         BOOST_UBLAS_INLINE
         matrix& operator -= (const matrix_expression<AE> &ae) {
-            self_type temporary (*this - ae);
+            self_type temporary;
+            resize_temporary (temporary, size1_, size2_);
+            matrix_assign<scalar_assign> (temporary, *this - ae);
             return assign_temporary (temporary);
         }
 
         template<class E1, class E2>
         BOOST_UBLAS_INLINE
         matrix& operator -= (const binop<E1, E2, multOp> &o) {
-            self_type temporary (*this - matrix_chain_controller(o));
-            return assign_temporary(temporary); 
+            chain_matrix_assign<scalar_minus_assign> (*this, o);
+            return *this;
         }
 
         template<class C>          // Container assignment without temporary
@@ -428,8 +508,7 @@ namespace boost { namespace numeric {
         template<class E1, class E2>
         BOOST_UBLAS_INLINE
         matrix &minus_assign (const binop<E1, E2, multOp> &o) {
-            self_type temporary = matrix_chain_controller(o);
-            matrix_assign<scalar_minus_assign> (*this, temporary);
+            chain_matrix_assign<scalar_minus_assign> (*this, o);
             return *this;
         }
 
@@ -452,6 +531,7 @@ namespace boost { namespace numeric {
             if (this != &m) {
                 std::swap (size1_, m.size1_);
                 std::swap (size2_, m.size2_);
+                std::swap (ld_, m.ld_);
                 data ().swap (m.data ());
             }
         }
@@ -460,6 +540,26 @@ namespace boost { namespace numeric {
             m1.swap (m2);
         }
 
+    private:
+        // Sizes of the storage seen by the layout: the padded one is the leading dimension
+        BOOST_UBLAS_INLINE
+        size_type storage_size1 () const {
+            return layout_type::fast_i () ? ld_ : size1_;
+        }
+        BOOST_UBLAS_INLINE
+        size_type storage_size2 () const {
+            return layout_type::fast_j () ? ld_ : size2_;
+        }
+
+        // Temporaries of assignments keep the leading dimension when the size does not change
+        BOOST_UBLAS_INLINE
+        void resize_temporary (self_type &temporary, size_type size1, size_type size2) const {
+            if (size1 == size1_ && size2 == size2_)
+                temporary.resize (size1, size2, ld_, false);
+            else
+                temporary.resize (size1, size2, false);
+        }
+
         // Iterator types
     private:
         // Use the storage array iterator
@@ -489,7 +589,7 @@ namespace boost { namespace numeric {
 #ifdef BOOST_UBLAS_USE_INDEXED_ITERATOR
             return const_iterator1 (*this, i, j);
 #else
-            return const_iterator1 (*this, data ().begin () + layout_type::address (i, size1_, j, size2_));
+            return const_iterator1 (*this, data ().begin () + layout_type::address (i, storage_size1 (), j, storage_size2 ()));
 #endif
         }
         BOOST_UBLAS_INLINE
@@ -497,7 +597,7 @@ namespace boost { namespace numeric {
 #ifdef BOOST_UBLAS_USE_INDEXED_ITERATOR
             return iterator1 (*this, i, j);
 #else
-            return iterator1 (*this, data ().begin () + layout_type::address (i, size1_, j, size2_));
+            return iterator1 (*this, data ().begin () + layout_type::address (i, storage_size1 (), j, storage_size2 ()));
 #endif
         }
         BOOST_UBLAS_INLINE
@@ -505,7 +605,7 @@ namespace boost { namespace numeric {
 #ifdef BOOST_UBLAS_USE_INDEXED_ITERATOR
             return const_iterator2 (*this, i, j);
 #else
-            return const_iterator2 (*this, data ().begin () + layout_type::address (i, size1_, j, size2_));
+            return const_iterator2 (*this, data ().begin () + layout_type::address (i, storage_size1 (), j, storage_size2 ()));
 #endif
         }
         BOOST_UBLAS_INLINE
@@ -513,7 +613,7 @@ namespace boost { namespace numeric {
 #ifdef BOOST_UBLAS_USE_INDEXED_ITERATOR
             return iterator2 (*this, i, j);
 #else
-            return iterator2 (*this, data ().begin () + layout_type::address (i, size1_, j, size2_));
+            return iterator2 (*this, data ().begin () + layout_type::address (i, storage_size1 (), j, storage_size2 ()));
 #endif
         }
 
@@ -546,28 +646,28 @@ namespace boost { namespace numeric {
             // Arithmetic
             BOOST_UBLAS_INLINE
             const_iterator1 &operator ++ () {
-                layout_type::increment_i (it_, (*this) ().size1 (), (*this) ().size2 ());
+                layout_type::increment_i (it_, (*this) ().storage_size1 (), (*this) ().storage_size2 ());
                 return *this;
             }
             BOOST_UBLAS_INLINE
             const_iterator1 &operator -- () {
-                layout_type::decrement_i (it_, (*this) ().size1 (), (*this) ().size2 ());
+                layout_type::decrement_i (it_, (*this) ().storage_size1 (), (*this) ().storage_size2 ());
                 return *this;
             }
             BOOST_UBLAS_INLINE
             const_iterator1 &operator += (difference_type n) {
-                layout_type::increment_i (it_, n, (*this) ().size1 (), (*this) ().size2 ());
+                layout_type::increment_i (it_, n, (*this) ().storage_size1 (), (*this) ().storage_size2 ());
                 return *this;
             }
             BOOST_UBLAS_INLINE
             const_iterator1 &operator -= (difference_type n) {
-                layout_type::decrement_i (it_, n, (*this) ().size1 (), (*this) ().size2 ());
+                layout_type::decrement_i (it_, n, (*this) ().storage_size1 (), (*this) ().storage_size2 ());
                 return *this;
             }
             BOOST_UBLAS_INLINE
             difference_type operator - (const const_iterator1 &it) const {
                 BOOST_UBLAS_CHECK (&(*this) () == &it (), external_logic ());
-                return layout_type::distance_i (it_ - it.it_, (*this) ().size1 (), (*this) ().size2 ());
+                return layout_type::distance_i (it_ - it.it_, (*this) ().storage_size1 (), (*this) ().storage_size2 ());
             }
 
             // Dereference
@@ -647,12 +747,12 @@ namespace boost { namespace numeric {
             BOOST_UBLAS_INLINE
             size_type index1 () const {
                 const self_type &m = (*this) ();
-                return layout_type::index_i (it_ - m.begin1 ().it_, m.size1 (), m.size2 ());
+                return layout_type::index_i (it_ - m.begin1 ().it_, m.storage_size1 (), m.storage_size2 ());
             }
             BOOST_UBLAS_INLINE
             size_type index2 () const {
                 const self_type &m = (*this) ();
-                return layout_type::index_j (it_ - m.begin1 ().it_, m.size1 (), m.size2 ());
+                return layout_type::index_j (it_ - m.begin1 ().it_, m.storage_size1 (), m.storage_size2 ());
             }
 
             // Assignment
@@ -724,28 +824,28 @@ namespace boost { namespace numeric {
             // Arithmetic
             BOOST_UBLAS_INLINE
             iterator1 &operator ++ () {
-                layout_type::increment_i (it_, (*this) ().size1 (), (*this) ().size2 ());
+                layout_type::increment_i (it_, (*this) ().storage_size1 (), (*this) ().storage_size2 ());
                 return *this;
             }
             BOOST_UBLAS_INLINE
             iterator1 &operator -- () {
-                layout_type::decrement_i (it_, (*this) ().size1 (), (*this) ().size2 ());
+                layout_type::decrement_i (it_, (*this) ().storage_size1 (), (*this) ().storage_size2 ());
                 return *this;
             }
             BOOST_UBLAS_INLINE
             iterator1 &operator += (difference_type n) {
-                layout_type::increment_i (it_, n, (*this) ().size1 (), (*this) ().size2 ());
+                layout_type::increment_i (it_, n, (*this) ().storage_size1 (), (*this) ().storage_size2 ());
                 return *this;
             }
             BOOST_UBLAS_INLINE
             iterator1 &operator -= (difference_type n) {
-                layout_type::decrement_i (it_, n, (*this) ().size1 (), (*this) ().size2 ());
+                layout_type::decrement_i (it_, n, (*this) ().storage_size1 (), (*this) ().storage_size2 ());
                 return *this;
             }
             BOOST_UBLAS_INLINE
             difference_type operator - (const iterator1 &it) const {
                 BOOST_UBLAS_CHECK (&(*this) () == &it (), external_logic ());
-                return layout_type::distance_i (it_ - it.it_, (*this) ().size1 (), (*this) ().size2 ());
+                return layout_type::distance_i (it_ - it.it_, (*this) ().storage_size1 (), (*this) ().storage_size2 ());
             }
 
             // Dereference
@@ -797,12 +897,12 @@ namespace boost { namespace numeric {
             BOOST_UBLAS_INLINE
             size_type index1 () const {
                 self_type &m = (*this) ();
-                return layout_type::index_i (it_ - m.begin1 ().it_, m.size1 (), m.size2 ());
+                return layout_type::index_i (it_ - m.begin1 ().it_, m.storage_size1 (), m.storage_size2 ());
             }
             BOOST_UBLAS_INLINE
             size_type index2 () const {
                 self_type &m = (*this) ();
-                return layout_type::index_j (it_ - m.begin1 ().it_, m.size1 (), m.size2 ());
+                return layout_type::index_j (it_ - m.begin1 ().it_, m.storage_size1 (), m.storage_size2 ());
             }
 
             // Assignment
@@ -869,28 +969,28 @@ namespace boost { namespace numeric {
             // Arithmetic
             BOOST_UBLAS_INLINE
             const_iterator2 &operator ++ () {
-                layout_type::increment_j (it_, (*this) ().size1 (), (*this) ().size2 ());
+                layout_type::increment_j (it_, (*this) ().storage_size1 (), (*this) ().storage_size2 ());
                 return *this;
             }
             BOOST_UBLAS_INLINE
             const_iterator2 &operator -- () {
-                layout_type::decrement_j (it_, (*this) ().size1 (), (*this) ().size2 ());
+                layout_type::decrement_j (it_, (*this) ().storage_size1 (), (*this) ().storage_size2 ());
                 return *this;
             }
             BOOST_UBLAS_INLINE
             const_iterator2 &operator += (difference_type n) {
-                layout_type::increment_j (it_, n, (*this) ().size1 (), (*this) ().size2 ());
+                layout_type::increment_j (it_, n, (*this) ().storage_size1 (), (*this) ().storage_size2 ());
                 return *this;
             }
             BOOST_UBLAS_INLINE
             const_iterator2 &operator -= (difference_type n) {
-                layout_type::decrement_j (it_, n, (*this) ().size1 (), (*this) ().size2 ());
+                layout_type::decrement_j (it_, n, (*this) ().storage_size1 (), (*this) ().storage_size2 ());
                 return *this;
             }
             BOOST_UBLAS_INLINE
             difference_type operator - (const const_iterator2 &it) const {
                 BOOST_UBLAS_CHECK (&(*this) () == &it (), external_logic ());
-                return layout_type::distance_j (it_ - it.it_, (*this) ().size1 (), (*this) ().size2 ());
+                return layout_type::distance_j (it_ - it.it_, (*this) ().storage_size1 (), (*this) ().storage_size2 ());
             }
 
             // Dereference
@@ -970,12 +1070,12 @@ namespace boost { namespace numeric {
             BOOST_UBLAS_INLINE
             size_type index1 () const {
                 const self_type &m = (*this) ();
-                return layout_type::index_i (it_ - m.begin2 ().it_, m.size1 (), m.size2 ());
+                return layout_type::index_i (it_ - m.begin2 ().it_, m.storage_size1 (), m.storage_size2 ());
             }
             BOOST_UBLAS_INLINE
             size_type index2 () const {
                 const self_type &m = (*this) ();
-                return layout_type::index_j (it_ - m.begin2 ().it_, m.size1 (), m.size2 ());
+                return layout_type::index_j (it_ - m.begin2 ().it_, m.storage_size1 (), m.storage_size2 ());
             }
 
             // Assignment
@@ -1047,28 +1147,28 @@ namespace boost { namespace numeric {
             // Arithmetic
             BOOST_UBLAS_INLINE
             iterator2 &operator ++ () {
-                layout_type::increment_j (it_, (*this) ().size1 (), (*this) ().size2 ());
+                layout_type::increment_j (it_, (*this) ().storage_size1 (), (*this) ().storage_size2 ());
                 return *this;
             }
             BOOST_UBLAS_INLINE
             iterator2 &operator -- () {
-                layout_type::decrement_j (it_, (*this) ().size1 (), (*this) ().size2 ());
+                layout_type::decrement_j (it_, (*this) ().storage_size1 (), (*this) ().storage_size2 ());
                 return *this;
             }
             BOOST_UBLAS_INLINE
             iterator2 &operator += (difference_type n) {
-                layout_type::increment_j (it_, n, (*this) ().size1 (), (*this) ().size2 ());
+                layout_type::increment_j (it_, n, (*this) ().storage_size1 (), (*this) ().storage_size2 ());
                 return *this;
             }
             BOOST_UBLAS_INLINE
             iterator2 &operator -= (difference_type n) {
-                layout_type::decrement_j (it_, n, (*this) ().size1 (), (*this) ().size2 ());
+                layout_type::decrement_j (it_, n, (*this) ().storage_size1 (), (*this) ().storage_size2 ());
                 return *this;
             }
             BOOST_UBLAS_INLINE
             difference_type operator - (const iterator2 &it) const {
                 BOOST_UBLAS_CHECK (&(*this) () == &it (), external_logic ());
-                return layout_type::distance_j (it_ - it.it_, (*this) ().size1 (), (*this) ().size2 ());
+                return layout_type::distance_j (it_ - it.it_, (*this) ().storage_size1 (), (*this) ().storage_size2 ());
             }
 
             // Dereference
@@ -1120,12 +1220,12 @@ namespace boost { namespace numeric {
             BOOST_UBLAS_INLINE
             size_type index1 () const {
                 self_type &m = (*this) ();
-                return layout_type::index_i (it_ - m.begin2 ().it_, m.size1 (), m.size2 ());
+                return layout_type::index_i (it_ - m.begin2 ().it_, m.storage_size1 (), m.storage_size2 ());
             }
             BOOST_UBLAS_INLINE
             size_type index2 () const {
                 self_type &m = (*this) ();
-                return layout_type::index_j (it_ - m.begin2 ().it_, m.size1 (), m.size2 ());
+                return layout_type::index_j (it_ - m.begin2 ().it_, m.storage_size1 (), m.storage_size2 ());
             }
 
             // Assignment
@@ -1237,14 +1337,39 @@ namespace boost { namespace numeric {
                 size2_ = s2;
             }
             ar & serialization::make_nvp("data",data_);
+
+            // the leading dimension follows from the size of the data
+            if (Archive::is_loading::value) {
+                const size_type size_major = layout_type::size_M (size1_, size2_);
+                ld_ = size_major != 0 ? data_.size () / size_major : layout_type::size_m (size1_, size2_);
+            }
         }
 
     private:
         size_type size1_;
         size_type size2_;
+        size_type ld_;
         array_type data_;
     };
 
+    /** \brief A leading dimension for matrices of \c T whose rows (row major) or columns (column major) hold \c size
+     * elements. Lines of an even number of whole cache lines are padded by one cache line, so that the elements of
+     * a column (row major) or a row (column major) spread over all the sets of the caches.
+     *
+     * Other sizes are returned as they are: their lines already start at different offsets within cache lines.
+     */
+    template<class T>
+    BOOST_UBLAS_INLINE
+    std::size_t padded_leading_dimension (std::size_t size) {
+        const std::size_t line = BOOST_UBLAS_ALIGNED_ALLOCATOR_ALIGN;
+        if (size == 0 || sizeof (T) > line || line % sizeof (T) != 0)
+            return size;
+        const std::size_t line_size = line / sizeof (T);
+        if (size % line_size != 0 || (size / line_size) % 2 != 0)
+            return size;
+        return size + line_size;
+    }
+
 
 #ifdef BOOST_UBLAS_CPP_GE_2011
     /** \brief A fixed size dense matrix of values of type \c T. Equivalent to a c-style 2 dimensional array.
@@ -2366,9 +2491,9 @@ namespace boost { namespace numeric {
         BOOST_UBLAS_INLINE
         bounded_matrix (const matrix_expression<AE> &ae):
             matrix_type (ae) {}
-        template<class E1, class E2>
+        template<class E1, class E2, class OT>
         BOOST_UBLAS_INLINE
-        bounded_matrix (const binop<E1, E2, multOp> &o):
+        bounded_matrix (const binop<E1, E2, OT> &o):
             matrix_type (o) {}
         BOOST_UBLAS_INLINE
         ~bounded_matrix () {}
@@ -2411,25 +2536,39 @@ namespace boost { namespace numeric {
         template<class E1, class E2>
         BOOST_UBLAS_INLINE
         bounded_matrix &operator = (const binop<E1, E2, multOp> &o) {
-            matrix_type::operator = (matrix_chain_controller(o));
+            matrix_type::operator = (o);
             return *this;
         }
 
         template<class E1, class E2>
         BOOST_UBLAS_INLINE
         bounded_matrix &operator += (const binop<E1, E2, multOp> &o) {
-            matrix_type::operator = (*this + matrix_chain_controller(o));
+            matrix_type::operator += (o);
             return *this;
         }
 
         template<class E1, class E2>
         BOOST_UBLAS_INLINE
         bounded_matrix &operator -= (const binop<E1, E2, multOp> &o) {
-            matrix_type::operator = (*this - matrix_chain_controller(o));
+            matrix_type::operator -= (o);
             return *this;
         }
     };
 
+#ifdef BOOST_UBLAS_CPP_GE_2011
+    /** \brief A dense matrix of values of type \c T whose storage starts at a multiple of \c Align bytes.
+     *
+     * Rows (for \c row_major) or columns (for \c column_major) are aligned as well when their length in bytes
+     * is a multiple of \c Align, which the SIMD kernels of matrix-vector products check at run time.
+     *
+     * \tparam T the type of object stored in the matrix (like double, float, complex, etc...)
+     * \tparam L the storage organization. It can be either \c row_major or \c column_major. Default is \c row_major
+     * \tparam Align the alignment in bytes, a power of two. Default is \c BOOST_UBLAS_ALIGNED_ALLOCATOR_ALIGN, a cache line
+     */
+    template<class T, class L = row_major, std::size_t Align = BOOST_UBLAS_ALIGNED_ALLOCATOR_ALIGN>
+    using aligned_matrix = matrix<T, L, unbounded_array<T, aligned_allocator<T, Align> > >;
+#endif
+
 
     /** \brief A dense matrix of values of type \c T stored as a vector of vectors.
     *
@@ -5242,9 +5381,12 @@ namespace boost { namespace numeric {
 
         template<class E1, class E2>
         c_matrix &operator = (const binop<E1, E2, multOp> &o) {
-            matrix<T> resultant = matrix_chain_controller(o);
-            c_matrix temporary(resultant);
-            return assign_temporary (temporary);
+            if (size1_ != o.size1 () || size2_ != o.size2 ()) {
+                self_type temporary (o);
+                return assign_temporary (temporary);
+            }
+            chain_matrix_assign<scalar_assign> (*this, o);
+            return *this;
         }
 
 
@@ -5258,7 +5400,7 @@ namespace boost { namespace numeric {
         template<class E1, class E2>
         BOOST_UBLAS_INLINE
         c_matrix &assign (const binop<E1, E2, multOp> &o) {
-            matrix_assign<scalar_assign> (*this, matrix_chain_controller(o));
+            chain_matrix_assign<scalar_assign> (*this, o);
             return *this;
         }
 
@@ -5272,8 +5414,8 @@ namespace boost { namespace numeric {
         template<class E1, class E2>
         BOOST_UBLAS_INLINE
         c_matrix& operator += (const binop<E1, E2, multOp> &o) {
-            self_type temporary (*this + matrix_chain_controller(o));
-            return assign_temporary(temporary);
+            chain_matrix_assign<scalar_plus_assign> (*this, o);
+            return *this;
         }
 
         template<class C>          // Container assignment without temporary
@@ -5292,7 +5434,7 @@ namespace boost { namespace numeric {
         template<class E1, class E2>
         BOOST_UBLAS_INLINE
         c_matrix &plus_assign (const binop<E1, E2, multOp> &o) {
-            matrix_assign<scalar_plus_assign> (*this, matrix_chain_controller(o));
+            chain_matrix_assign<scalar_plus_assign> (*this, o);
             return *this;
         }
 
@@ -5306,8 +5448,8 @@ namespace boost { namespace numeric {
         template<class E1, class E2>
         BOOST_UBLAS_INLINE
         c_matrix& operator -= (const binop<E1, E2, multOp> &o) {
-            self_type temporary (*this - matrix_chain_controller(o));
-            return assign_temporary (temporary);
+            chain_matrix_assign<scalar_minus_assign> (*this, o);
+            return *this;
         }
 
         template<class C>          // Container assignment without temporary
@@ -5326,7 +5468,7 @@ namespace boost { namespace numeric {
         template<class E1, class E2>
         BOOST_UBLAS_INLINE
         c_matrix &minus_assign (const binop<E1, E2, multOp> &o) {
-            matrix_assign<scalar_minus_assign> (*this, matrix_chain_controller(o));
+            chain_matrix_assign<scalar_minus_assign> (*this, o);
             return *this;
         }
 
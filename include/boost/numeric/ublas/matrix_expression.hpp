@@ -2849,6 +2849,9 @@ namespace boost { namespace numeric { namespace ublas {
     struct subOp {};
     struct multOp {};
 
+    template<class E1, class E2, class F>
+    class matrix_matrix_binary;
+
     template<typename E1, typename E2, typename op = valueOp>
     struct binop {
         const E1 &left;
@@ -2890,591 +2893,49 @@ namespace boost { namespace numeric { namespace ublas {
             return right.size2();
         }
 
-        template<typename T>
-        BOOST_UBLAS_INLINE
-        void operator () (T** &C) const {
-            self_type O = binop<E1, E2, op>(left, right, operator_type());
-            apply(O, C);
-        }
-
         template<typename size_type, typename T>
         BOOST_UBLAS_INLINE 
         T operator () (size_type i, size_type j) {
             return left(i, j);
         }
 
-        template<class T, class L, class A, class E>
-        static void apply(matrix<T, L, A> &M, E** &C) {
-            typedef typename matrix<T, L, A>::size_type size_type;
-            size_type size1_ = M.size1();
-            size_type size2_ = M.size2();
-
-            C = new E*[size1_];
-            for(size_type i=0; i<size1_; i++) {
-                C[i] = new E[size2_];
-            }
-
-            for(size_type i=0; i<size1_; i++) {
-                for(size_type j=0; j<size2_; j++) {
-                    C[i][j] = M(i, j);
-                }
-            }
+        template<typename E, typename O>
+        static void getOperands(const E &e, O &operands) {
+            operands.push_back(e);
         }
 
-        template<class T, std::size_t N, std::size_t M, class E>
-        static void apply(c_matrix<T, N, M> &m, E** &C) {
-            typedef typename c_matrix<T, N, M>::size_type size_type;
-            size_type size1_ = m.size1();
-            size_type size2_ = m.size2();
-
-            C = new E*[size1_];
-            for(size_type i=0; i<size1_; i++) {
-                C[i] = new E[size2_];
-            }
-
-            for(size_type i=0; i<size1_; i++) {
-                for(size_type j=0; j<size2_; j++) {
-                    C[i][j] = m(i, j);
-                }
-            }
-        }
-
-        template<class T, std::size_t M, std::size_t N, class E>
-        static void apply(bounded_matrix<T, M, N> &m, E** &C) {
-            typedef typename bounded_matrix<T, M, M>::size_type size_type;
-            size_type size1_ = m.size1();
-            size_type size2_ = m.size2();
-
-            C = new E*[size1_];
-            for(size_type i=0; i<size1_; i++) {
-                C[i] = new E[size2_];
-            }
-
-            for(size_type i=0; i<size1_; i++) {
-                for(size_type j=0; j<size2_; j++) {
-                    C[i][j] = m(i, j);
-                }
-            }
+        template<typename T1, typename T2, typename O>
+        static void getOperands(const binop<T1, T2, multOp> &o, O &operands) {
+            getOperands(o.left, operands);
+            getOperands(o.right, operands);
         }
 
-        template<class T1, class T2, class T>
-        static void apply(const binop<T1, T2, addOp> &O, T** &C) {
-            //std::vector<std::vector<T> > A, B;
-            auto Left = O.left, Right = O.right;
-
-            BOOST_UBLAS_SAME(Left.size1(), Right.size1()); 
-            BOOST_UBLAS_SAME(Left.size2(), Right.size2());
-
-            T **A, **B;
-            auto Lsize1 = Left.size1(), Lsize2 = Left.size2();
-            auto Rsize1 = Right.size1(), Rsize2 = Right.size2();
-
-            apply(Right, B);
-            apply(Left, A);
-            
-            auto size1_ = O.size1(), size2_ = O.size2();
-
-            C = new T*[Lsize1];
-            for(auto i=0; i<Lsize1; i++) {
-                C[i] = new T[Lsize2];
-            }
-
-            add(A, B, C, size1_, size2_);
-
-            for(auto i=0; i<Lsize1; i++) {
-                delete [] A[i];
-            }
-            delete [] A;
-            for(auto i=0; i<Rsize1; i++) {
-                delete []  B[i];
-            }
-            delete [] B;
+        // prod () inside a chain takes part in its parenthesisation
+        template<typename T1, typename T2, typename TV, typename O>
+        static void getOperands(const matrix_matrix_binary<T1, T2, matrix_matrix_prod<T1, T2, TV> > &e, O &operands) {
+            getOperands(e.expression1(), operands);
+            getOperands(e.expression2(), operands);
         }
+    };
 
-        template<class T1, class T2, class T>
-        static void apply(const binop<T1, T2, subOp> &O, T** &C) {
-            auto Left = O.left, Right = O.right;
-            
-            BOOST_UBLAS_SAME(Left.size1(), Right.size1());
-            BOOST_UBLAS_SAME(Left.size2(), Right.size2());
-
-            T **A, **B;
-            auto Lsize1 = Left.size1(), Lsize2 = Left.size2();
-            auto Rsize1 = Right.size1(), Rsize2 = Right.size2();
-
-            apply(Right, B);
-            apply(Left, A);
-
-            BOOST_UBLAS_SAME(Left.size1(), Right.size1());
-            BOOST_UBLAS_SAME(Left.size2(), Right.size2());
-
-            auto size1_ = O.size1(), size2_ = O.size2();
-
-            C = new T*[Lsize1];
-            for(auto i=0; i<Lsize1; i++) {
-                C[i] = new T[Lsize2];
-            }
-
-            subtract(A, B, C, size1_, size2_);
-
-            for(auto i=0; i<Lsize1; i++) {
-                delete [] A[i];
-            }
-            delete [] A;
-            for(auto i=0; i<Rsize1; i++) {
-                delete []  B[i];
-            }
-            delete [] B;
-        }
-
-        template<class T1, class T2, class T>
-        static void apply(const binop<T1, T2, multOp> &O, T** &C) {
-            matrix_chain_controller(O, C);
-        }
-
-        template<class T1, class T2, class E, class T>
-        static void add(T1** &A, T2** &B, E** &C, T size1_, T size2_) {
-            for(T i=0; i<size1_; i++) {
-                for(T j=0; j<size2_; j++) {
-                    C[i][j] = A[i][j] + B[i][j]; 
-                }
-            }
-        }
-
-        template<class T1, class T2, class E, class T>
-        static void subtract(T1** &A, T2** &B, E** &C, T size1_, T size2_) {
-            for(T i=0; i<size1_; i++) {
-                for(T j=0; j<size2_; j++) {
-                    C[i][j] = A[i][j] - B[i][j]; 
-                }
-            }
-        }
-
-        template<typename D, typename E>
-        static void preProcess(D &dimensions, E &splits) {
-            long int N = dimensions.size();
-
-            for(auto i=2; i<N;i++) {
-                BOOST_UBLAS_SAME(dimensions[i-1].second, dimensions[i].first);
-            }
-            
-            //DP.resize(N, std::vector<long int>(N, 0));
-            long long int **DP;
-            DP = new long long int*[N];
-            for(int i=0; i<N; i++) {
-                DP[i] = new long long int[N];
-            }
-            splits.resize(N, std::vector<long long int>(N, 0));
-
-            for(auto i=N-1; i>=1; i--) { 
-                for(auto j=i; j<=N-1; j++) {
-                    DP[i][j] = 1e12;
-                    for(auto k=i; k<j; k++) {
-                        long int temp = DP[i][k] + DP[k+1][j] + dimensions[i].first * dimensions[k].second * dimensions[j].second;
-                        if(DP[i][j] > temp) {
-                            DP[i][j] = temp; splits[i][j] = k;
-                        }
-                    }
-                    if(i==j)
-                        DP[i][j] = 0;    
-                }
-            }
-            for(int i=0; i<N; i++) {
-                delete [] DP[i];
-            }
-            delete [] DP;
-        }
-
-        template<typename E, typename V>
-        static void getDimensions(const E &o, V &v) {
-            v.push_back(std::make_pair(o.size1(), o.size2()));
-        }
-
-        template<typename T1, typename T2, typename V>
-        static void getDimensions(const binop<T1, T2, multOp> &o, V &v) {
-            getDimensions(o.left, v);
-            getDimensions(o.right, v);
-        }
-
-        struct dimensionWrapper {
-            int size1, size2;
-        };  
-
-        template<class E, class T, class P>
-        static dimensionWrapper Traverse(const E &O, int currInd, int TargetInd, bool &Reached, T** &C, P &dimensionC) {
-            if(currInd == TargetInd) {
-                Reached = 1;
-                dimensionWrapper dim; 
-                dimensionC.first = O.size1();  dimensionC.second = O.size2();
-                C = new T*[dimensionC.first];
-                for(int i=0; i<dimensionC.first; i++) {
-                    C[i] = new T[dimensionC.second];
-                }
-                for(int i=0; i<O.size1(); i++) {
-                    for(int j=0; j<O.size2(); j++) {
-                        C[i][j] = O(i, j);
-                    }
-                }
-            }
-        }
-
-        template<class L, class R, class T, class P>
-        static dimensionWrapper Traverse(const binop<L, R, multOp> &O, int currInd, int TargetInd, bool &Reached, T** &C, P &dimensionC) {
-            Traverse(O.right, currInd, TargetInd, Reached, C, dimensionC);
-            if(!Reached) {
-                Traverse(O.left, currInd-1, TargetInd, Reached, C, dimensionC);
-            }
-        }
- 
-
-        template<class T1, class T2, class T, class size_type, class P>
-        static dimensionWrapper Chaining(T1 &O, T2 &splits, long int i, long int j, T** &C, size_type &Size,
-                                         P &dimensionC) {
-            
-            if(i == j) {
-                bool Reached = 0;
-                return Traverse(O, Size, i, Reached, C, dimensionC);
-            }
-
-            T **A, **B;
-            P dimensionA, dimensionB;
-
-            Chaining(O, splits, i, splits[i][j], A, Size, dimensionA);
-            Chaining(O, splits, splits[i][j]+1, j, B, Size, dimensionB);
-            
-            dimensionC.first = dimensionA.first;    dimensionC.second = dimensionB.second;
-            C = new T*[dimensionC.first];
-            for(int i=0; i<dimensionC.first; i++) {
-                C[i] = new T[dimensionC.second];
-            }
-
-            size_type sqSize = getSize(std::max(dimensionA.first, dimensionA.second), 
-                                       std::max(dimensionB.first, dimensionB.second));
-            // Strassen's Algo check done
-            productController(A, B, C, 
-                              dimensionA.first, dimensionA.second,
-                              dimensionB.first, dimensionB.second,  
-                              sqSize);
-            
-            for(int i=0; i<dimensionA.first; i++) {
-                delete [] A[i];
-            }
-            delete [] A;
-            for(int i=0; i<dimensionB.first; i++) {
-                delete [] B[i];
-            }
-            delete [] B;
-
-
-            if(i == 1 && j == splits.size()-1) {
-                splits.clear();
-            }
-        }
-
-        template<class E>
-        static int getETSize(const E &O) {
-            return 1;
-        }
-
-        template<class L, class R>
-        static int getETSize(const binop<L, R, multOp> &O) {
-            return getETSize(O.left) + getETSize(O.right);
-        }
-
-        template<class T1, class T2, class T>
-        static BOOST_UBLAS_INLINE
-        void matrix_chain_controller(const binop<T1, T2, multOp> &O, T** &C) {
-            std::vector<std::pair<long long int, long long int> > Dimensions; Dimensions.push_back(std::make_pair(0,0));
-            getDimensions(O, Dimensions);
-
-            std::vector<std::vector<long long int> > splits;
-            preProcess(Dimensions, splits);
-
-            std::pair<int, int> dimensionC;
-            // Chaining mathod to be implemented
-            int Size;
-            Size = getETSize(O);
-            Chaining(O, splits, 1, Size, C, Size, dimensionC);
-        }
-
-        // Strassen's Part
-        template<typename T>
-        static T getSize(T size1, T size2) {
-            T maxSize = (size1 > size2) ? size1:size2;
-            T Size = 1;
-            while(Size < maxSize) {
-                Size <<= 1;
-            }
-            return Size;
-        }
-
-        template<typename T, typename size_type>
-        static BOOST_UBLAS_INLINE
-        void Trivial(T** &A, T** &B, T** &C, size_type I, size_type J, size_type K) {
-            //int I = A.size(), K = A[0].size(), J = B[0].size();
-            for(size_type i=0; i<I; i++) {
-                for(size_type j=0; j<J; j++) {
-                    C[i][j] = 0;
-                    for(size_type k=0; k<K; k++) {
-                        C[i][j] += A[i][k] * B[k][j];
-                    }
-                }
-            }
-        }
-
-        template<typename T>
-        static BOOST_UBLAS_INLINE
-        void Matrix_Add(int N, T** &X, T** &Y, T** &Z){
-            for(int i=0; i<N; i++){
-                for(int j=0; j<N; j++){
-                    Z[i][j] = X[i][j] + Y[i][j];
-                }
-            }
-        }
-
-        template<typename T>
-        static BOOST_UBLAS_INLINE
-        void Matrix_Sub(int N, T** &X, T** &Y, T** &Z){
-            for(int i=0; i<N; i++){
-                for(int j=0; j<N; j++){
-                    Z[i][j] = X[i][j] - Y[i][j];
-                }
-            }
-        }
-
-        template<typename T, class size_type>
-        static BOOST_UBLAS_INLINE 
-        void Strassen(size_type N, T** &A, T** &B, T** &C) {
-            if(N == 512) {
-                Trivial(A, B, C, N, N, N);
-                return;
-            } 
-            
-            T **A11 = new T*[N]; T **A12 = new T*[N]; T **A21 = new T*[N]; T **A22 = new T*[N];
-            T **B11 = new T*[N]; T **B12 = new T*[N]; T **B21 = new T*[N]; T **B22 = new T*[N];
-            T **C11 = new T*[N]; T **C12 = new T*[N]; T **C21 = new T*[N]; T **C22 = new T*[N];
-            T **P1 = new T*[N]; T **P2 = new T*[N]; T **P3 = new T*[N]; T **P4 = new T*[N]; T **P5 = new T*[N]; T **P6 = new T*[N]; T **P7 = new T*[N];
-            T **AA = new T*[N]; T **BB = new T*[N];
-
-            for(size_type i=0; i<N; i++) {
-                A11[i] = new T[N]; A12[i] = new T[N]; A21[i] = new T[N]; A22[i] = new T[N];
-                B11[i] = new T[N]; B12[i] = new T[N]; B21[i] = new T[N]; B22[i] = new T[N];
-                C11[i] = new T[N]; C12[i] = new T[N]; C21[i] = new T[N]; C22[i] = new T[N];
-                P1[i] = new T[N]; P2[i] = new T[N]; P3[i] = new T[N]; P4[i] = new T[N]; P5[i] = new T[N]; P6[i] = new T[N]; P7[i] = new T[N];
-                AA[i] = new T[N]; BB[i] = new T[N];
-            }
-
-            size_type mid = N>>1;
-            for(uint i=0; i<N; i++){
-                for(uint j=0;j<N;j++){
-                    if(i<mid && j<mid)
-                        A11[i][j] = A[i][j];
-                    else if(i<mid)
-                        A12[i][j-mid] = A[i][j];
-                    else if(i>=mid && j<mid)
-                        A21[i-mid][j] = A[i][j];
-                    else
-                        A22[i-mid][j-mid] = A[i][j];
-
-                    if(i<mid && j<mid)
-                        B11[i][j] = B[i][j];
-                    else if(i<mid)
-                        B12[i][j-mid] = B[i][j];
-                    else if(i>=mid && j<mid)
-                        B21[i-mid][j] = B[i][j];
-                    else
-                        B22[i-mid][j-mid] = B[i][j];
-                }
-            }
-
-            Matrix_Add(N>>1, A11, A22, AA);
-            Matrix_Add(N>>1, B11, B22, BB);
-            Strassen(N>>1, AA, BB, P1);
-
-            Matrix_Add(N>>1, A21, A22, AA);
-            Strassen(N>>1, AA, B11, P2);
-
-            Matrix_Sub(N>>1, B12, B22, BB);
-            Strassen(N>>1, A11, BB, P3);
-
-            //Calculate M4 = A3 × (B2 - B0)
-            Matrix_Sub((N>>1), B21, B11, BB);
-            Strassen((N>>1), A22, BB, P4);
-
-            //Calculate M5 = (A0 + A1) × B3
-            Matrix_Add((N>>1), A11, A12, AA);
-            Strassen((N>>1), AA, B22, P5);
-
-            //Calculate M6 = (A2 - A0) × (B0 + B1)
-            Matrix_Sub((N>>1), A21, A11, AA);
-            Matrix_Add((N>>1), B11, B12, BB);
-            Strassen((N>>1), AA, BB, P6);
-
-            //Calculate M7 = (A1 - A3) × (B2 + B3)
-            Matrix_Sub((N>>1), A12, A22, AA);
-            Matrix_Add((N>>1), B21, B22, BB);
-            Strassen((N>>1), AA, BB, P7);
-
-            //Calculate C0 = M1 + M4 - M5 + M7
-            Matrix_Add((N>>1), P1, P4, AA);
-            Matrix_Sub((N>>1), P7, P5, BB);
-            Matrix_Add((N>>1), AA, BB, C11);
-
-            //Calculate C1 = M3 + M5
-            Matrix_Add((N>>1), P3, P5, C12);
-
-            //Calculate C2 = M2 + M4
-            Matrix_Add((N>>1), P2, P4, C21);
-
-            //Calculate C3 = M1 - M2 + M3 + M6
-            Matrix_Sub((N>>1), P1, P2, AA);
-            Matrix_Add((N>>1), P3, P6, BB);
-            Matrix_Add((N>>1), AA, BB, C22);
-
-            //Set the result to C[][N]
-             for(int i=0; i<N; i++) {
-                for(int j=0; j<N; j++) {
-                  if(i<mid && j<mid)
-                    C[i][j] = C11[i][j];
-                  else if(i<mid)
-                    C[i][j] = C12[i][j-mid];
-                  else if(i>=mid && j<mid)
-                    C[i][j] = C21[i-mid][j];
-                  else
-                    C[i][j] = C22[i-mid][j-mid];
-                }
-            }
-
-            for(size_type i=0; i<N; i++) {
-                delete [] A11[i]; delete [] A12[i]; delete [] A21[i]; delete [] A22[i];
-                delete [] B11[i]; delete [] B12[i]; delete [] B21[i]; delete [] B22[i];
-                delete [] C11[i]; delete [] C12[i]; delete [] C21[i]; delete [] C22[i];
-                delete [] P1[i]; delete [] P2[i]; delete [] P3[i]; delete [] P4[i]; delete [] P5[i]; delete [] P6[i]; delete [] P7[i];
-                delete [] AA[i]; delete [] BB[i];
-            }
-            delete [] A11; delete [] A12; delete [] A21; delete [] A22;
-            delete [] B11; delete [] B12; delete [] B21; delete [] B22;
-            delete [] C11; delete [] C12; delete [] C21; delete [] C22;
-            delete [] P1; delete [] P2; delete [] P3; delete [] P4; delete [] P5; delete [] P6; delete [] P7;
-            delete [] AA; delete [] BB;
-        }
-
-        template<class size_type>
-        static bool check(size_type Asize1, size_type Asize2, size_type Bsize2) {
-            typedef long long int lli;
-            lli operations = (lli) Asize1 * Asize2 * Bsize2;
-            if(operations > (1<<28))
-                return true;
-            return false;
-        }
-
-        template<class T, class size_type>
-        static void allocate(T** &A, T** &B, T** &C, size_type Size) {
-            A = new T*[Size]; B = new T*[Size]; C = new T*[Size];
-            for(size_type i=0; i<Size; i++) {
-                A[i] = new T[Size](); B[i] = new T[Size](); C[i] = new T[Size]();
-            }
-        }
-
-        template<class T, class size_type>
-        static void allocate(T** &A, T** &B, T** &C, 
-                      size_type Asize1, size_type Asize2,
-                      size_type Bsize1, size_type Bsize2) {
-            A = new T*[Asize1]; B = new T*[Bsize1]; C = new T*[Asize1];
-            for(size_type i=0; i<Asize1; i++) {
-                A[i] = new T[Asize2];
-            }
-            for(size_type i=0; i<Bsize1; i++) {
-                B[i] = new T[Bsize2];
-            }
-            for(size_type i=0; i<Asize1; i++) {
-                C[i] = new T[Bsize2];
-            }
-        }
-
-        template<class T, class size_type>
-        static void deallocate(T** &A, T** &B, T** &C, size_type Size) {
-            for(size_type i=0; i<Size; i++) {
-                delete [] A[i]; delete [] B[i]; delete [] C[i];
-            }
-            delete [] A; delete [] B; delete [] C;
-        }
-
-        template<class T, class size_type>
-        static void deallocate(T** &A, T** &B, T** &C, 
-                      size_type Asize1, size_type Asize2,
-                      size_type Bsize1, size_type Bsize2) {
-            for(size_type i=0; i<Asize1; i++) {
-                delete [] A[i];
-            }
-            delete [] A;
-
-            for(size_type i=0; i<Bsize1; i++) {
-                delete [] B[i];
-            }
-            delete [] B;
-            for(size_type i=0; i<Asize1; i++) {
-                delete [] C[i];
-            }
-            delete [] C;
-        }
-
-        template<class T, class size_type>
-        static void productController(T** &matA, T** &matB, T** &matC, 
-                                      size_type Asize1, size_type Asize2,
-                                      size_type Bsize1, size_type Bsize2,
-                                      size_type Size) {
-            T **A, **B, **C;
-
-            bool isLarge = check(Asize1, Asize2, Bsize2);
-            
-            if(!isLarge) {
-                allocate(A, B, C, 
-                         Asize1, Asize2,
-                         Bsize1, Bsize2);
-            }
-            else {
-                allocate(A, B, C, Size);
-            }
-            
-            for(size_type i=0; i<Asize1; i++) {
-                for(size_type j=0; j<Asize2; j++) {
-                    A[i][j] = matA[i][j];
-                }
-            }
-            
-            for(size_type i=0; i<Bsize1; i++) {
-                for(size_type j=0; j<Bsize2; j++) {
-                    B[i][j] = matB[i][j];
-                }
-            }
-            
-            if(!isLarge) {
-                Trivial(A, B, C, Asize1, Bsize2, Asize2);
-            }
-            else{
-                Strassen(Size, A, B, C);
-            }
-            for(size_type i=0; i<Asize1; i++) {
-                for(size_type j=0; j<Bsize2; j++) {
-                    matC[i][j] = C[i][j];
-                }
-            }
-
-            if(!isLarge) {
-                deallocate(A, B, C, 
-                         Asize1, Asize2,
-                         Bsize1, Bsize2);
-            }
-            else{
-                deallocate(A, B, C, Size);
-            }
-        }
+    // Operands of a chain product: matrix expressions and other chains
+    template<typename E>
+    struct is_chain_operand {
+        template<typename X>
+        static char check (const matrix_expression<X> *);
+        static char (&check (...)) [2];
+        static const bool value = sizeof (check (static_cast<const E *> (0))) == 1;
+    };
+    template<typename E1, typename E2>
+    struct is_chain_operand<binop<E1, E2, multOp> > {
+        static const bool value = true;
     };
 
     template<typename E1, typename E2>
     BOOST_UBLAS_INLINE
-    binop<E1, E2, multOp> operator * (const E1 &left, const E2 &right) {
+    typename boost::enable_if_c<is_chain_operand<E1>::value && is_chain_operand<E2>::value,
+                                binop<E1, E2, multOp> >::type
+    operator * (const E1 &left, const E2 &right) {
         return binop<E1, E2, multOp> (left, right, multOp());
     }
 
@@ -3502,6 +2963,19 @@ namespace boost { namespace numeric { namespace ublas {
         return binop<binop<E1, E2, OT>, E, subOp> (left, right, subOp());
     }
 
+    // Both sides chains
+    template<typename E1, typename E2, typename OT1, typename E3, typename E4, typename OT2>
+    BOOST_UBLAS_INLINE
+    binop<binop<E1, E2, OT1>, binop<E3, E4, OT2>, addOp> operator + (const binop<E1, E2, OT1> &left, const binop<E3, E4, OT2> &right) {
+        return binop<binop<E1, E2, OT1>, binop<E3, E4, OT2>, addOp> (left, right, addOp());
+    }
+
+    template<typename E1, typename E2, typename OT1, typename E3, typename E4, typename OT2>
+    BOOST_UBLAS_INLINE
+    binop<binop<E1, E2, OT1>, binop<E3, E4, OT2>, subOp> operator - (const binop<E1, E2, OT1> &left, const binop<E3, E4, OT2> &right) {
+        return binop<binop<E1, E2, OT1>, binop<E3, E4, OT2>, subOp> (left, right, subOp());
+    }
+
 
     template<class E1, class E2, class F>
     struct matrix_binary_traits {
@@ -5488,8 +4962,8 @@ namespace boost { namespace numeric { namespace ublas {
             return functor_type::apply (e1_, e2_, i, j);
         }
 
-        BOOST_UBLAS_INLINE
         template<typename T>
+        BOOST_UBLAS_INLINE
         void operator () (T **C) const {
             functor_type::apply(e1_, e2_, C);
         }
@@ -0,0 +1,511 @@
+//
+//  Copyright (c) 2017
+//  uBLAS developers
+//
+//  Distributed under the Boost Software License, Version 1.0. (See
+//  accompanying file LICENSE_1_0.txt or copy at
+//  http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#ifndef _BOOST_UBLAS_MATRIX_MARKET_
+#define _BOOST_UBLAS_MATRIX_MARKET_
+
+#include <algorithm>
+#include <complex>
+#include <cstddef>
+#include <istream>
+#include <iterator>
+#include <limits>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include <boost/mpl/bool.hpp>
+#include <boost/mpl/if.hpp>
+#include <boost/static_assert.hpp>
+#include <boost/type_traits/is_convertible.hpp>
+#include <boost/type_traits/is_integral.hpp>
+#include <boost/numeric/ublas/matrix.hpp>
+#include <boost/numeric/ublas/matrix_sparse.hpp>
+#include <boost/numeric/ublas/detail/text_io.hpp>
+#include <boost/numeric/ublas/detail/thread_pool.hpp>
+
+// Reading and writing the Matrix Market exchange format.
+//
+// A file starts with the banner
+//
+//   %%MatrixMarket matrix <format> <field> <symmetry>
+//
+// where format is coordinate or array, field is real, double, integer, complex
+// or pattern and symmetry is general, symmetric, skew-symmetric or hermitian,
+// all case insensitive. Lines starting with % and blank lines follow, then the
+// sizes, "rows columns entries" for coordinate files and "rows columns" for
+// arrays, then the entries. A coordinate entry is a 1 based row and column and
+// the value: nothing for pattern, which stands for 1, and the real and the
+// imaginary part for complex. An array lists the values by columns.
+// Symmetric, skew-symmetric and hermitian files hold the lower triangle, an
+// array of a skew-symmetric matrix without the diagonal; the readers fill in
+// the upper triangle.
+//
+// read_matrix_market reads the entries in chunks of
+// BOOST_UBLAS_MATRIX_MARKET_CHUNK bytes. Each chunk is cut at its last line
+// end, split at line ends between the threads of the pool, parsed, and
+// handed in file order to the matrix: written in place into a dense matrix,
+// appended to a coordinate_matrix, or gathered into triplets from which a
+// compressed_matrix is assembled by counting sort. The memory used beyond the
+// matrix is one chunk and its parsed entries, plus the triplets for a
+// compressed_matrix.
+
+namespace boost { namespace numeric { namespace ublas {
+
+namespace detail {
+
+    struct matrix_market_header {
+        enum field_type { real, integer, complex, pattern };
+        enum symmetry_type { general, symmetric, skew_symmetric, hermitian };
+
+        bool coordinate;
+        field_type field;
+        symmetry_type symmetry;
+        std::size_t size1, size2;
+        // Entries in the file
+        std::size_t entries;
+    };
+
+    // The next word of line from p, in lower case
+    inline std::string matrix_market_word (const char *&p, const char *last) {
+        skip_text_space (p, last);
+        std::string word;
+        for (; p != last && *p != ' ' && *p != '\t' && *p != '\r'; ++ p)
+            word += *p >= 'A' && *p <= 'Z' ? char (*p - 'A' + 'a') : *p;
+        return word;
+    }
+
+    // Reads the banner, the comments and the sizes; the entries of value type
+    // V follow. Returns false on anything else or a field that V cannot hold.
+    template<class V, class T>
+    bool read_matrix_market_header (std::basic_istream<char, T> &is, matrix_market_header &h, bool complex_value) {
+        std::string line;
+        if (! std::getline (is, line))
+            return false;
+        const char *p = line.data (), *last = p + line.size ();
+        if (matrix_market_word (p, last) != "%%matrixmarket" || matrix_market_word (p, last) != "matrix")
+            return false;
+        const std::string format = matrix_market_word (p, last), field = matrix_market_word (p, last),
+                          symmetry = matrix_market_word (p, last);
+        if (format != "coordinate" && format != "array")
+            return false;
+        h.coordinate = format == "coordinate";
+        if (field == "real" || field == "double")
+            h.field = matrix_market_header::real;
+        else if (field == "integer")
+            h.field = matrix_market_header::integer;
+        else if (field == "complex" && complex_value)
+            h.field = matrix_market_header::complex;
+        else if (field == "pattern" && h.coordinate)
+            h.field = matrix_market_header::pattern;
+        else
+            return false;
+        // Integers cannot be read from numbers with fractions
+        if (boost::is_integral<V>::value && h.field != matrix_market_header::integer && h.field != matrix_market_header::pattern)
+            return false;
+        if (symmetry == "general")
+            h.symmetry = matrix_market_header::general;
+        else if (symmetry == "symmetric")
+            h.symmetry = matrix_market_header::symmetric;
+        else if (symmetry == "skew-symmetric" && h.field != matrix_market_header::pattern)
+            h.symmetry = matrix_market_header::skew_symmetric;
+        else if (symmetry == "hermitian" && h.field == matrix_market_header::complex)
+            h.symmetry = matrix_market_header::hermitian;
+        else
+            return false;
+
+        do {
+            if (! std::getline (is, line))
+                return false;
+            p = line.data ();
+            last = p + line.size ();
+            skip_text_space (p, last);
+        } while (p == last || *p == '%');
+        if (! parse_text_size (p, last, h.size1) || ! parse_text_size (p, last, h.size2))
+            return false;
+        if (h.symmetry != matrix_market_header::general && h.size1 != h.size2)
+            return false;
+        if (h.coordinate) {
+            if (! parse_text_size (p, last, h.entries))
+                return false;
+        } else if (h.symmetry == matrix_market_header::general)
+            h.entries = h.size1 * h.size2;
+        else if (h.symmetry == matrix_market_header::skew_symmetric)
+            h.entries = h.size1 * (h.size1 - (h.size1 > 0)) / 2;
+        else
+            h.entries = h.size1 * (h.size1 + 1) / 2;
+        skip_text_space (p, last);
+        return p == last;
+    }
+
+    template<class V>
+    bool parse_matrix_market_value (const char *&p, const char *last, V &t, const matrix_market_header &h) {
+        if (h.field == matrix_market_header::pattern) {
+            t = V (1);
+            return true;
+        }
+        return parse_text_number (p, last, t);
+    }
+    template<class V>
+    bool parse_matrix_market_value (const char *&p, const char *last, std::complex<V> &t, const matrix_market_header &h) {
+        V re (1), im = V ();
+        if (h.field != matrix_market_header::pattern &&
+            (! parse_text_number (p, last, re) || (h.field == matrix_market_header::complex && ! parse_text_number (p, last, im))))
+            return false;
+        t = std::complex<V> (re, im);
+        return true;
+    }
+
+    // The entries of one part of a chunk, with 0 based indices
+    template<class V>
+    struct matrix_market_part {
+        const char *first, *last;
+        std::vector<std::size_t> rows, columns;
+        std::vector<V> values;
+        bool good;
+    };
+
+    // Parses parts of a chunk
+    template<class V>
+    class matrix_market_parser {
+    public:
+        matrix_market_parser (const matrix_market_header &h, std::vector<matrix_market_part<V> > &parts):
+            h_ (h), parts_ (parts) {}
+
+        void operator () (std::size_t first, std::size_t last) const {
+            for (std::size_t k = first; k < last; ++ k)
+                parse (parts_ [k]);
+        }
+
+    private:
+        void parse (matrix_market_part<V> &part) const {
+            part.rows.clear ();
+            part.columns.clear ();
+            part.values.clear ();
+            part.good = true;
+            const char *p = part.first;
+            V t;
+            for (;;) {
+                skip_text_space (p, part.last);
+                if (p == part.last)
+                    return;
+                std::size_t i = 0, j = 0;
+                if (h_.coordinate && ! (parse_text_size (p, part.last, i) && parse_text_size (p, part.last, j) &&
+                                        i >= 1 && i <= h_.size1 && j >= 1 && j <= h_.size2)) {
+                    part.good = false;
+                    return;
+                }
+                if (! parse_matrix_market_value (p, part.last, t, h_) ||
+                    (p != part.last && *p != ' ' && *p != '\n' && *p != '\t' && *p != '\r')) {
+                    part.good = false;
+                    return;
+                }
+                if (h_.coordinate) {
+                    part.rows.push_back (i - 1);
+                    part.columns.push_back (j - 1);
+                }
+                part.values.push_back (t);
+            }
+        }
+
+        const matrix_market_header &h_;
+        std::vector<matrix_market_part<V> > &parts_;
+    };
+
+    // Hands the entries, in file order and with the upper triangle of
+    // symmetric files, to the sink s: s.add (i, j, t) for each element,
+    // skipping the zeros of arrays unless S::dense. Returns false, and sets
+    // the failbit, on malformed entries or a wrong number of them.
+    template<class V, class T, class S>
+    bool read_matrix_market_entries (std::basic_istream<char, T> &is, const matrix_market_header &h, S &s) {
+        thread_pool &pool = thread_pool::instance ();
+        std::vector<matrix_market_part<V> > parts (pool.size ());
+        std::vector<char> buffer (BOOST_UBLAS_MATRIX_MARKET_CHUNK);
+        std::size_t carry = 0, count = 0;
+        // Element of the next array entry
+        std::size_t i = h.symmetry == matrix_market_header::skew_symmetric ? 1 : 0, j = 0;
+        bool good = true, end = false;
+        while (good && ! end) {
+            is.read (&buffer [carry], std::streamsize (buffer.size () - carry));
+            std::size_t size = carry + std::size_t (is.gcount ());
+            end = ! is;
+            // Complete lines only; a longer line than the buffer grows it
+            std::size_t length = size;
+            if (! end) {
+                while (length > 0 && buffer [length - 1] != '\n')
+                    -- length;
+                if (length == 0) {
+                    carry = size;
+                    buffer.resize (2 * buffer.size ());
+                    continue;
+                }
+            }
+            // Chunks of few lines are parsed by one thread
+            const std::size_t n = std::max (std::min (parts.size (), length / BOOST_UBLAS_TEXT_BLOCK_SIZE), std::size_t (1));
+            const char *first = &buffer [0], *last = first + length;
+            for (std::size_t k = 0; k < n; ++ k) {
+                parts [k].first = first;
+                first = k + 1 < n ? std::find (first + std::min (length / n, std::size_t (last - first)), last, '\n') : last;
+                parts [k].last = first;
+            }
+            pool.parallel_for (0, n, 1, matrix_market_parser<V> (h, parts));
+
+            for (std::size_t k = 0; good && k < n; ++ k) {
+                const matrix_market_part<V> &part = parts [k];
+                good = part.good && part.values.size () <= h.entries - count;
+                if (! good)
+                    break;
+                count += part.values.size ();
+                for (std::size_t e = 0; e < part.values.size (); ++ e) {
+                    const V &t = part.values [e];
+                    if (h.coordinate) {
+                        i = part.rows [e];
+                        j = part.columns [e];
+                    }
+                    if (h.coordinate || S::dense || t != V ()) {
+                        s.add (i, j, t);
+                        if (i != j && h.symmetry == matrix_market_header::symmetric)
+                            s.add (j, i, t);
+                        else if (i != j && h.symmetry == matrix_market_header::skew_symmetric)
+                            s.add (j, i, -t);
+                        else if (i != j && h.symmetry == matrix_market_header::hermitian)
+                            s.add (j, i, type_traits<V>::conj (t));
+                    }
+                    if (! h.coordinate && ++ i == h.size1) {
+                        ++ j;
+                        i = h.symmetry == matrix_market_header::general ? 0 :
+                            h.symmetry == matrix_market_header::skew_symmetric ? j + 1 : j;
+                    }
+                }
+            }
+            carry = size - length;
+            std::copy (buffer.begin () + length, buffer.begin () + size, buffer.begin ());
+        }
+        // The short read of the last chunk is not a failure
+        if (is.eof ())
+            is.clear (std::ios_base::eofbit);
+        if (! good || count != h.entries) {
+            is.setstate (std::ios_base::failbit);
+            return false;
+        }
+        return true;
+    }
+
+    // Sinks of read_matrix_market_entries
+    template<class M>
+    struct matrix_market_dense_sink {
+        static const bool dense = true;
+        explicit matrix_market_dense_sink (M &m): m_ (m) {}
+        void add (std::size_t i, std::size_t j, const typename M::value_type &t) {
+            m_ (i, j) += t;
+        }
+        M &m_;
+    };
+    template<class M>
+    struct matrix_market_coordinate_sink {
+        static const bool dense = false;
+        explicit matrix_market_coordinate_sink (M &m): m_ (m) {}
+        void add (std::size_t i, std::size_t j, const typename M::value_type &t) {
+            m_.append_element (i, j, t);
+        }
+        M &m_;
+    };
+    template<class V>
+    struct matrix_market_triplet_sink {
+        static const bool dense = false;
+        void add (std::size_t i, std::size_t j, const V &t) {
+            rows.push_back (i);
+            columns.push_back (j);
+            values.push_back (t);
+        }
+        std::vector<std::size_t> rows, columns;
+        std::vector<V> values;
+    };
+
+    // Elements a file describes at most
+    inline std::size_t matrix_market_elements (const matrix_market_header &h) {
+        return h.symmetry == matrix_market_header::general ? h.entries : 2 * h.entries;
+    }
+
+    template<class V>
+    struct matrix_market_is_complex: boost::mpl::false_ {};
+    template<class V>
+    struct matrix_market_is_complex<std::complex<V> >: boost::mpl::true_ {};
+
+    // Digits that tell every value of type V apart
+    template<class V>
+    int matrix_market_precision () {
+        return 2 + std::numeric_limits<V>::digits * 30103 / 100000;
+    }
+
+    template<class V>
+    void format_matrix_market_value (std::string &s, const V &t) {
+        format_text_value (s, t, matrix_market_precision<V> ());
+    }
+    template<class V>
+    void format_matrix_market_value (std::string &s, const std::complex<V> &t) {
+        format_matrix_market_value (s, t.real ());
+        s += ' ';
+        format_matrix_market_value (s, t.imag ());
+    }
+
+    template<class V>
+    void format_matrix_market_banner (std::string &s, const char *format) {
+        s = "%%MatrixMarket matrix ";
+        s += format;
+        s += matrix_market_is_complex<V>::value ? " complex" : boost::is_integral<V>::value ? " integer" : " real";
+        s += " general\n";
+    }
+
+    template<class E>
+    void write_matrix_market (std::ostream &os, const E &e, sparse_tag) {
+        typedef typename E::value_type value_type;
+        std::size_t entries = 0;
+        for (typename E::const_iterator1 it1 = e.begin1 (); it1 != e.end1 (); ++ it1)
+            entries += std::size_t (std::distance (it1.begin (), it1.end ()));
+        std::string s;
+        format_matrix_market_banner<value_type> (s, "coordinate");
+        format_text_size (s, e.size1 ());
+        s += ' ';
+        format_text_size (s, e.size2 ());
+        s += ' ';
+        format_text_size (s, entries);
+        s += '\n';
+        for (typename E::const_iterator1 it1 = e.begin1 (); it1 != e.end1 (); ++ it1)
+            for (typename E::const_iterator2 it2 = it1.begin (); it2 != it1.end (); ++ it2) {
+                format_text_size (s, it2.index1 () + 1);
+                s += ' ';
+                format_text_size (s, it2.index2 () + 1);
+                s += ' ';
+                format_matrix_market_value (s, *it2);
+                s += '\n';
+                if (s.size () >= std::size_t (BOOST_UBLAS_TEXT_BLOCK_SIZE)) {
+                    os.write (s.data (), std::streamsize (s.size ()));
+                    s.clear ();
+                }
+            }
+        os.write (s.data (), std::streamsize (s.size ()));
+    }
+
+    template<class E>
+    void write_matrix_market (std::ostream &os, const E &e, dense_proxy_tag) {
+        std::string s;
+        format_matrix_market_banner<typename E::value_type> (s, "array");
+        format_text_size (s, e.size1 ());
+        s += ' ';
+        format_text_size (s, e.size2 ());
+        s += '\n';
+        for (std::size_t j = 0; j < e.size2 (); ++ j)
+            for (std::size_t i = 0; i < e.size1 (); ++ i) {
+                format_matrix_market_value (s, e (i, j));
+                s += '\n';
+                if (s.size () >= std::size_t (BOOST_UBLAS_TEXT_BLOCK_SIZE)) {
+                    os.write (s.data (), std::streamsize (s.size ()));
+                    s.clear ();
+                }
+            }
+        os.write (s.data (), std::streamsize (s.size ()));
+    }
+
+}
+
+    /** \brief Reads a matrix in the Matrix Market format into the dense
+     * matrix \c m, resized.
+     *
+     * Reads to the end of \c is. Sets the failbit, leaving \c m alone, when the
+     * file is malformed, lists the wrong number of entries or has a field the
+     * value type cannot hold: complex values for a real matrix, or real ones
+     * for an integer matrix. Entries of the same element are summed. See
+     * matrix_market.hpp for the format and the reading in chunks.
+     */
+    template<class T, class L, class A>
+    std::istream &read_matrix_market (std::istream &is, matrix<T, L, A> &m) {
+        BOOST_STATIC_ASSERT (detail::text_value<T>::value);
+        detail::matrix_market_header h;
+        if (! detail::read_matrix_market_header<T> (is, h, detail::matrix_market_is_complex<T>::value)) {
+            is.setstate (std::ios_base::failbit);
+            return is;
+        }
+        matrix<T, L, A> s (h.size1, h.size2, T ());
+        detail::matrix_market_dense_sink<matrix<T, L, A> > sink (s);
+        if (detail::read_matrix_market_entries<T> (is, h, sink))
+            m.swap (s);
+        return is;
+    }
+
+    /** \brief Reads a matrix in the Matrix Market format into the compressed
+     * matrix \c m, resized.
+     *
+     * The entries are gathered into triplets, from which the matrix is
+     * assembled by counting sort; entries of the same element are summed,
+     * explicit zeros of coordinate files are stored, zeros of arrays are not.
+     * Errors are as for dense matrices.
+     */
+    template<class T, class L, std::size_t IB, class IA, class TA>
+    std::istream &read_matrix_market (std::istream &is, compressed_matrix<T, L, IB, IA, TA> &m) {
+        BOOST_STATIC_ASSERT (detail::text_value<T>::value);
+        detail::matrix_market_header h;
+        if (! detail::read_matrix_market_header<T> (is, h, detail::matrix_market_is_complex<T>::value)) {
+            is.setstate (std::ios_base::failbit);
+            return is;
+        }
+        detail::matrix_market_triplet_sink<T> sink;
+        if (h.coordinate) {
+            sink.rows.reserve (detail::matrix_market_elements (h));
+            sink.columns.reserve (detail::matrix_market_elements (h));
+            sink.values.reserve (detail::matrix_market_elements (h));
+        }
+        if (! detail::read_matrix_market_entries<T> (is, h, sink))
+            return is;
+        compressed_matrix<T, L, IB, IA, TA> s (h.size1, h.size2);
+        s.assemble (sink.rows.begin (), sink.rows.end (), sink.columns.begin (), sink.values.begin ());
+        m.swap (s);
+        return is;
+    }
+
+    /** \brief Reads a matrix in the Matrix Market format into the coordinate
+     * matrix \c m, resized, appending the entries in file order.
+     *
+     * Errors are as for dense matrices.
+     */
+    template<class T, class L, std::size_t IB, class IA, class TA>
+    std::istream &read_matrix_market (std::istream &is, coordinate_matrix<T, L, IB, IA, TA> &m) {
+        BOOST_STATIC_ASSERT (detail::text_value<T>::value);
+        detail::matrix_market_header h;
+        if (! detail::read_matrix_market_header<T> (is, h, detail::matrix_market_is_complex<T>::value)) {
+            is.setstate (std::ios_base::failbit);
+            return is;
+        }
+        coordinate_matrix<T, L, IB, IA, TA> s (h.size1, h.size2, h.coordinate ? detail::matrix_market_elements (h) : 0);
+        detail::matrix_market_coordinate_sink<coordinate_matrix<T, L, IB, IA, TA> > sink (s);
+        if (detail::read_matrix_market_entries<T> (is, h, sink))
+            m.swap (s);
+        return is;
+    }
+
+    /** \brief Writes the matrix expression \c e in the Matrix Market format,
+     * with general symmetry.
+     *
+     * Sparse expressions are written as coordinate files of their stored
+     * elements, others as arrays. The field is complex, integer or real by the
+     * value type; values are written with the digits that tell them apart, so
+     * that reading the file gives them back exactly.
+     */
+    template<class E>
+    std::ostream &write_matrix_market (std::ostream &os, const matrix_expression<E> &e) {
+        BOOST_STATIC_ASSERT (detail::text_value<typename E::value_type>::value);
+        typedef typename boost::mpl::if_<boost::is_convertible<typename E::storage_category, sparse_tag>,
+                                         sparse_tag, dense_proxy_tag>::type category;
+        detail::write_matrix_market (os, e (), category ());
+        return os;
+    }
+
+}}}
+
+#endif
@@ -13,9 +13,15 @@
 #ifndef _BOOST_UBLAS_MATRIX_SPARSE_
 #define _BOOST_UBLAS_MATRIX_SPARSE_
 
+#include <utility>
+#include <vector>
+
 #include <boost/numeric/ublas/vector_sparse.hpp>
 #include <boost/numeric/ublas/matrix_expression.hpp>
 #include <boost/numeric/ublas/detail/matrix_assign.hpp>
+#include <boost/numeric/ublas/detail/spgemm.hpp>
+#include <boost/numeric/ublas/detail/spmv.hpp>
+#include <boost/numeric/ublas/detail/triplet_sort.hpp>
 #if BOOST_UBLAS_TYPE_CHECK
 #include <boost/numeric/ublas/matrix.hpp>
 #endif
@@ -531,6 +537,33 @@ namespace boost { namespace numeric { namespace ublas {
             m1.swap (m2);
         }
 
+        // Conversion
+        /** \brief Stores the elements into the compressed matrix \c m, resized
+         * to the size of this matrix, in one pass over them in index order.
+         *
+         * Typically the last step of an assembly, accumulated in a \c map_hash
+         * storage, before products with the compressed matrix.
+         */
+        template<std::size_t IB, class IA, class TA>
+        void freeze (compressed_matrix<T, L, IB, IA, TA> &m) const {
+            typedef typename IA::value_type index_type;
+            const size_type size_M = layout_type::size_M (size1_, size2_);
+            const size_type size_m = layout_type::size_m (size1_, size2_);
+            m.resize (size1_, size2_, false);
+            m.reserve (nnz (), false);
+            typename IA::size_type major = 0, k = 0;
+            m.index1_data () [0] = index_type (IB);
+            for (const_subiterator_type it = data ().begin (); it != data ().end (); ++ it, ++ k) {
+                for (const size_type element_M = it->first / size_m; major < element_M; )
+                    m.index1_data () [++ major] = index_type (k + IB);
+                m.index2_data () [k] = index_type (it->first % size_m + IB);
+                m.value_data () [k] = it->second;
+            }
+            while (major < size_M)
+                m.index1_data () [++ major] = index_type (k + IB);
+            m.set_filled (size_M + 1, k);
+        }
+
         // Iterator types
     private:
         // Use storage iterator
@@ -3271,6 +3304,39 @@ namespace boost { namespace numeric { namespace ublas {
             storage_invariants ();
         }
 
+        // Bulk assembly
+        /** \brief Replaces the elements by the triplets (first [k], columns [k], values [k])
+         * for k in [0, last - first), in any order; triplets of the same element are summed.
+         *
+         * The triplets are counting sorted by rows (columns for a column major matrix) in
+         * time linear in their number, using the thread pool for large assemblies, and
+         * written to the arrays in one pass: this is much faster than inserting them one
+         * by one, or through a \c coordinate_matrix. Elements summing to zero are stored.
+         * The iterators are random access; the size of the matrix does not change.
+         */
+        template<class I1, class I2, class I3>
+        void assemble (I1 first, I1 last, I2 columns, I3 values) {
+            typedef detail::triplet_source<layout_type, I1, I2, I3> source_type;
+            const source_type s = { size1_, size2_, size_type (last - first), first, columns, values };
+            reserve (s.size, false);
+            const size_type size_major = layout_type::size_M (size1_, size2_);
+            if (s.size <= capacity_)
+                filled2_ = detail::triplet_compress<IB> (s, size_major, &index1_data_ [0],
+                                                         s.size == 0 ? 0 : &index2_data_ [0],
+                                                         s.size == 0 ? 0 : &value_data_ [0]);
+            else {
+                // The capacity is bounded by size1 * size2, but the triplets
+                // are scattered before their duplicates are summed
+                std::vector<typename IA::value_type> index2 (s.size);
+                std::vector<value_type> value (s.size);
+                filled2_ = detail::triplet_compress<IB> (s, size_major, &index1_data_ [0], &index2 [0], &value [0]);
+                std::copy (index2.begin (), index2.begin () + filled2_, index2_data_.begin ());
+                std::copy (value.begin (), value.begin () + filled2_, value_data_.begin ());
+            }
+            filled1_ = size_major + 1;
+            storage_invariants ();
+        }
+
         // Iterator types
     private:
         // Use index array iterator
@@ -4707,17 +4773,20 @@ namespace boost { namespace numeric { namespace ublas {
         BOOST_UBLAS_INLINE
         void sort () const {
             if (! sorted_ && filled_ > 0) {
-                typedef index_triple_array<index_array_type, index_array_type, value_array_type> array_triple;
-                array_triple ita (filled_, index1_data_, index2_data_, value_data_);
 #ifndef BOOST_UBLAS_COO_ALWAYS_DO_FULL_SORT
-                const typename array_triple::iterator iunsorted = ita.begin () + sorted_filled_;
-                // sort new elements and merge
-                std::sort (iunsorted, ita.end ());
-                inplace_merge(0, sorted_filled_, filled_);
+                const array_size_type sorted = sorted_filled_;
 #else
-                const typename array_triple::iterator iunsorted = ita.begin ();
-                std::sort (iunsorted, ita.end ());
-#endif                
+                const array_size_type sorted = 0;
+#endif
+                // radix sort new elements and merge, unless the packed
+                // indices overflow
+                if (! detail::coordinate_sort (&index1_data_ [0], &index2_data_ [0], &value_data_ [0], sorted, filled_,
+                                               layout_type::size_M (size1_, size2_), layout_type::size_m (size1_, size2_), IB)) {
+                    typedef index_triple_array<index_array_type, index_array_type, value_array_type> array_triple;
+                    array_triple ita (filled_, index1_data_, index2_data_, value_data_);
+                    std::sort (ita.begin () + sorted, ita.end ());
+                    inplace_merge(0, sorted, filled_);
+                }
                 // sum duplicates with += and remove
                 array_size_type filled = 0;
                 for (array_size_type i = 1; i < filled_; ++ i) {
@@ -5768,6 +5837,1309 @@ namespace boost { namespace numeric { namespace ublas {
     template<class T, class L, std::size_t IB, class IA, class TA>
     const typename coordinate_matrix<T, L, IB, IA, TA>::value_type coordinate_matrix<T, L, IB, IA, TA>::zero_ = value_type/*zero*/();
 
+    // Sliced ELLPACK sparse matrix class (SELL-C-sigma)
+    /** \brief Read only sparse matrix of values of type \c T stored for fast
+     * matrix-vector products.
+     *
+     * The rows are cut into chunks of \c C rows. Each chunk stores as many
+     * columns as its longest row, one column of \c C values after the other,
+     * shorter rows being padded with zeros; a product then runs down a chunk
+     * with the \c C rows side by side in SIMD registers, whatever the row
+     * lengths. To limit the padding the rows are sorted by decreasing length
+     * within windows of \c sigma rows before they are chunked; the windows
+     * keep the rows close to their original position, and so the accesses to
+     * the vector operand local.
+     *
+     * The matrix is built from any matrix expression, typically a
+     * \c compressed_matrix or a \c coordinate_matrix, and cannot be changed
+     * afterwards except by assigning another one. \c prod and \c axpy_prod
+     * with dense vectors run a vectorised, multithreaded kernel; element
+     * access and the iterators search the rows and are meant for inspection.
+     *
+     * \tparam T the type of object stored in the matrix (like double, float, complex, etc...)
+     * \tparam C the chunk height, by default 8: a multiple of the register width of SSE2, AVX2 and AVX-512 for
+     *         \c double, and of SSE2 and AVX2 for \c float
+     * \tparam IA the type of adapted array for indices. By default, it is \c unbounded_array<std::size_t>
+     * \tparam TA the type of adapted array for values. By default, it is \c unbounded_array<T>
+     */
+    template<class T, std::size_t C, class IA, class TA>
+    class sliced_ell_matrix:
+        public matrix_container<sliced_ell_matrix<T, C, IA, TA> > {
+
+        typedef const T *const_pointer;
+        typedef sliced_ell_matrix<T, C, IA, TA> self_type;
+    public:
+#ifdef BOOST_UBLAS_ENABLE_PROXY_SHORTCUTS
+        using matrix_container<self_type>::operator ();
+#endif
+        typedef typename IA::value_type size_type;
+        typedef typename IA::size_type array_size_type;
+        typedef typename IA::difference_type difference_type;
+        typedef T value_type;
+        typedef const T &const_reference;
+        typedef const T &reference;
+        typedef IA index_array_type;
+        typedef TA value_array_type;
+        typedef const matrix_reference<const self_type> const_closure_type;
+        typedef matrix_reference<self_type> closure_type;
+        typedef compressed_vector<T, 0, IA, TA> vector_temporary_type;
+        typedef compressed_matrix<T, row_major, 0, IA, TA> matrix_temporary_type;
+        typedef sparse_tag storage_category;
+        typedef row_major_tag orientation_category;
+
+        BOOST_STATIC_CONSTANT (std::size_t, chunk_height = C);
+
+        // Construction and destruction
+        BOOST_UBLAS_INLINE
+        sliced_ell_matrix ():
+            matrix_container<self_type> (),
+            size1_ (0), size2_ (0), sigma_ (0), nnz_ (0),
+            chunk_data_ (1, 0), permutation_data_ (), length_data_ (), slot_data_ (),
+            index_data_ (), value_data_ () {}
+        BOOST_UBLAS_INLINE
+        sliced_ell_matrix (const compressed_matrix<T, row_major, 0, IA, TA> &m, size_type sigma = 32 * C):
+            matrix_container<self_type> () {
+            build (m, sigma);
+        }
+        template<class AE>
+        BOOST_UBLAS_INLINE
+        sliced_ell_matrix (const matrix_expression<AE> &ae, size_type sigma = 32 * C):
+            matrix_container<self_type> () {
+            build (matrix_temporary_type (ae), sigma);
+        }
+
+        // Accessors
+        BOOST_UBLAS_INLINE
+        size_type size1 () const {
+            return size1_;
+        }
+        BOOST_UBLAS_INLINE
+        size_type size2 () const {
+            return size2_;
+        }
+        // Window of the row sorting
+        BOOST_UBLAS_INLINE
+        size_type sigma () const {
+            return sigma_;
+        }
+        // Stored elements, without the padding
+        BOOST_UBLAS_INLINE
+        size_type nnz () const {
+            return nnz_;
+        }
+        BOOST_UBLAS_INLINE
+        size_type chunks () const {
+            return size_type (chunk_data_.size () - 1);
+        }
+
+        // Storage accessors
+        // Chunk c holds the rows permutation_data () [c C .. (c + 1) C), the
+        // slots of the chunk; the k-th element of slot s, k < length_data () [s],
+        // is at chunk_data () [c] + k C + s % C in index_data () and value_data ().
+        // slot_data () is the inverse permutation.
+        BOOST_UBLAS_INLINE
+        const index_array_type &chunk_data () const {
+            return chunk_data_;
+        }
+        BOOST_UBLAS_INLINE
+        const index_array_type &permutation_data () const {
+            return permutation_data_;
+        }
+        BOOST_UBLAS_INLINE
+        const index_array_type &length_data () const {
+            return length_data_;
+        }
+        BOOST_UBLAS_INLINE
+        const index_array_type &slot_data () const {
+            return slot_data_;
+        }
+        BOOST_UBLAS_INLINE
+        const index_array_type &index_data () const {
+            return index_data_;
+        }
+        BOOST_UBLAS_INLINE
+        const value_array_type &value_data () const {
+            return value_data_;
+        }
+
+        // Element access
+        BOOST_UBLAS_INLINE
+        const_reference operator () (size_type i, size_type j) const {
+            BOOST_UBLAS_CHECK (i < size1_, bad_index ());
+            BOOST_UBLAS_CHECK (j < size2_, bad_index ());
+            const size_type s = slot_data_ [i];
+            for (size_type k = 0; k < length_data_ [s]; ++ k) {
+                const size_type p = element (s, k);
+                if (index_data_ [p] == j)
+                    return value_data_ [p];
+            }
+            return zero_;
+        }
+
+        // Assignment
+        template<class AE>
+        BOOST_UBLAS_INLINE
+        sliced_ell_matrix &operator = (const matrix_expression<AE> &ae) {
+            self_type temporary (ae, sigma_ == 0 ? size_type (32 * C) : sigma_);
+            return assign_temporary (temporary);
+        }
+        BOOST_UBLAS_INLINE
+        sliced_ell_matrix &assign_temporary (sliced_ell_matrix &m) {
+            swap (m);
+            return *this;
+        }
+
+        // Swapping
+        BOOST_UBLAS_INLINE
+        void swap (sliced_ell_matrix &m) {
+            if (this != &m) {
+                std::swap (size1_, m.size1_);
+                std::swap (size2_, m.size2_);
+                std::swap (sigma_, m.sigma_);
+                std::swap (nnz_, m.nnz_);
+                chunk_data_.swap (m.chunk_data_);
+                permutation_data_.swap (m.permutation_data_);
+                length_data_.swap (m.length_data_);
+                slot_data_.swap (m.slot_data_);
+                index_data_.swap (m.index_data_);
+                value_data_.swap (m.value_data_);
+            }
+        }
+        BOOST_UBLAS_INLINE
+        friend void swap (sliced_ell_matrix &m1, sliced_ell_matrix &m2) {
+            m1.swap (m2);
+        }
+
+    private:
+        BOOST_UBLAS_INLINE
+        static size_type element_count (const matrix_temporary_type &m, size_type i) {
+            return i + 1 < m.filled1 () ? size_type (m.index1_data () [i + 1] - m.index1_data () [i]) : 0;
+        }
+
+        void build (const matrix_temporary_type &m, size_type sigma) {
+            BOOST_UBLAS_CHECK (sigma > 0, bad_argument ());
+            size1_ = m.size1 ();
+            size2_ = m.size2 ();
+            sigma_ = sigma;
+            nnz_ = m.nnz ();
+
+            // Decreasing lengths within each window, ties in row order
+            std::vector<std::pair<size_type, size_type> > order (size1_);
+            for (size_type i = 0; i < size1_; ++ i)
+                order [i] = std::make_pair (size2_ - element_count (m, i), i);
+            for (size_type first = 0; first < size1_; first += (std::min) (sigma, size1_ - first))
+                std::sort (order.begin () + first, order.begin () + first + (std::min) (sigma, size1_ - first));
+            permutation_data_.resize (size1_);
+            length_data_.resize (size1_);
+            slot_data_.resize (size1_);
+            for (size_type s = 0; s < size1_; ++ s) {
+                permutation_data_ [s] = order [s].second;
+                length_data_ [s] = size2_ - order [s].first;
+                slot_data_ [order [s].second] = s;
+            }
+
+            // Each chunk is as wide as its longest row
+            const size_type chunks = (size1_ + C - 1) / C;
+            chunk_data_.resize (chunks + 1);
+            chunk_data_ [0] = 0;
+            for (size_type c = 0; c < chunks; ++ c) {
+                size_type width = 0;
+                for (size_type s = c * C; s < (std::min) (size1_, (c + 1) * C); ++ s)
+                    width = (std::max) (width, size_type (length_data_ [s]));
+                chunk_data_ [c + 1] = chunk_data_ [c] + width * C;
+            }
+
+            // The padding multiplies zeros by the first element of the vector;
+            // products redo the rows this turns into NaN
+            index_data_.resize (chunk_data_ [chunks]);
+            value_data_.resize (chunk_data_ [chunks]);
+            std::fill (index_data_.begin (), index_data_.end (), size_type (0));
+            std::fill (value_data_.begin (), value_data_.end (), value_type/*zero*/());
+            for (size_type s = 0; s < size1_; ++ s) {
+                const size_type begin = m.index1_data () [permutation_data_ [s]];
+                for (size_type k = 0; k < length_data_ [s]; ++ k) {
+                    index_data_ [element (s, k)] = m.index2_data () [begin + k];
+                    value_data_ [element (s, k)] = m.value_data () [begin + k];
+                }
+            }
+        }
+
+        // Position of the k-th element of slot s
+        BOOST_UBLAS_INLINE
+        size_type element (size_type s, size_type k) const {
+            return size_type (chunk_data_ [s / C]) + k * C + s % C;
+        }
+
+        // First stored column of row i at or after j, size2 if none
+        BOOST_UBLAS_INLINE
+        size_type next_column (size_type i, size_type j) const {
+            const size_type s = slot_data_ [i];
+            for (size_type k = 0; k < length_data_ [s]; ++ k)
+                if (index_data_ [element (s, k)] >= j)
+                    return index_data_ [element (s, k)];
+            return size2_;
+        }
+        // Last stored column of row i before j
+        BOOST_UBLAS_INLINE
+        size_type previous_column (size_type i, size_type j) const {
+            const size_type s = slot_data_ [i];
+            for (size_type k = length_data_ [s]; k > 0; -- k)
+                if (index_data_ [element (s, k - 1)] < j)
+                    return index_data_ [element (s, k - 1)];
+            return 0;
+        }
+        BOOST_UBLAS_INLINE
+        bool stored (size_type i, size_type j) const {
+            return i < size1_ && next_column (i, j) == j;
+        }
+        // First row at or after i storing column j, size1 if none
+        BOOST_UBLAS_INLINE
+        size_type next_row (size_type i, size_type j) const {
+            while (i < size1_ && ! stored (i, j))
+                ++ i;
+            return i;
+        }
+        // Last row before i storing column j
+        BOOST_UBLAS_INLINE
+        size_type previous_row (size_type i, size_type j) const {
+            while (i > 0 && ! stored (-- i, j)) {}
+            return i;
+        }
+
+    public:
+        class const_iterator1;
+        class const_iterator2;
+        typedef reverse_iterator_base1<const_iterator1> const_reverse_iterator1;
+        typedef reverse_iterator_base2<const_iterator2> const_reverse_iterator2;
+
+        // Element lookup
+        BOOST_UBLAS_INLINE
+        const_iterator1 find1 (int rank, size_type i, size_type j) const {
+            if (rank == 1)
+                i = next_row (i, j);
+            return const_iterator1 (*this, rank, i, j);
+        }
+        BOOST_UBLAS_INLINE
+        const_iterator2 find2 (int rank, size_type i, size_type j) const {
+            if (rank == 1 && i < size1_)
+                j = next_column (i, j);
+            return const_iterator2 (*this, rank, i, j);
+        }
+
+        class const_iterator1:
+            public container_const_reference<sliced_ell_matrix>,
+            public bidirectional_iterator_base<sparse_bidirectional_iterator_tag,
+                                               const_iterator1, value_type> {
+        public:
+            typedef typename sliced_ell_matrix::value_type value_type;
+            typedef typename sliced_ell_matrix::difference_type difference_type;
+            typedef typename sliced_ell_matrix::const_reference reference;
+            typedef typename sliced_ell_matrix::const_pointer pointer;
+
+            typedef const_iterator2 dual_iterator_type;
+            typedef const_reverse_iterator2 dual_reverse_iterator_type;
+
+            // Construction and destruction
+            BOOST_UBLAS_INLINE
+            const_iterator1 ():
+                container_const_reference<self_type> (), rank_ (), i_ (), j_ () {}
+            BOOST_UBLAS_INLINE
+            const_iterator1 (const self_type &m, int rank, size_type i, size_type j):
+                container_const_reference<self_type> (m), rank_ (rank), i_ (i), j_ (j) {}
+
+            // Arithmetic
+            BOOST_UBLAS_INLINE
+            const_iterator1 &operator ++ () {
+                BOOST_UBLAS_CHECK (i_ < (*this) ().size1 (), bad_index ());
+                i_ = rank_ == 1 ? (*this) ().next_row (i_ + 1, j_) : i_ + 1;
+                return *this;
+            }
+            BOOST_UBLAS_INLINE
+            const_iterator1 &operator -- () {
+                BOOST_UBLAS_CHECK (i_ > 0, bad_index ());
+                i_ = rank_ == 1 ? (*this) ().previous_row (i_, j_) : i_ - 1;
+                return *this;
+            }
+
+            // Dereference
+            BOOST_UBLAS_INLINE
+            const_reference operator * () const {
+                return (*this) () (i_, j_);
+            }
+
+#ifndef BOOST_UBLAS_NO_NESTED_CLASS_RELATION
+            BOOST_UBLAS_INLINE
+#ifdef BOOST_UBLAS_MSVC_NESTED_CLASS_RELATION
+            typename self_type::
+#endif
+            const_iterator2 begin () const {
+                return (*this) ().find2 (1, i_, 0);
+            }
+            BOOST_UBLAS_INLINE
+#ifdef BOOST_UBLAS_MSVC_NESTED_CLASS_RELATION
+            typename self_type::
+#endif
+            const_iterator2 cbegin () const {
+                return begin ();
+            }
+            BOOST_UBLAS_INLINE
+#ifdef BOOST_UBLAS_MSVC_NESTED_CLASS_RELATION
+            typename self_type::
+#endif
+            const_iterator2 end () const {
+                return (*this) ().find2 (1, i_, (*this) ().size2 ());
+            }
+            BOOST_UBLAS_INLINE
+#ifdef BOOST_UBLAS_MSVC_NESTED_CLASS_RELATION
+            typename self_type::
+#endif
+            const_iterator2 cend () const {
+                return end ();
+            }
+            BOOST_UBLAS_INLINE
+#ifdef BOOST_UBLAS_MSVC_NESTED_CLASS_RELATION
+            typename self_type::
+#endif
+            const_reverse_iterator2 rbegin () const {
+                return const_reverse_iterator2 (end ());
+            }
+            BOOST_UBLAS_INLINE
+#ifdef BOOST_UBLAS_MSVC_NESTED_CLASS_RELATION
+            typename self_type::
+#endif
+            const_reverse_iterator2 crbegin () const {
+                return rbegin ();
+            }
+            BOOST_UBLAS_INLINE
+#ifdef BOOST_UBLAS_MSVC_NESTED_CLASS_RELATION
+            typename self_type::
+#endif
+            const_reverse_iterator2 rend () const {
+                return const_reverse_iterator2 (begin ());
+            }
+            BOOST_UBLAS_INLINE
+#ifdef BOOST_UBLAS_MSVC_NESTED_CLASS_RELATION
+            typename self_type::
+#endif
+            const_reverse_iterator2 crend () const {
+                return rend ();
+            }
+#endif
+
+            // Indices
+            BOOST_UBLAS_INLINE
+            size_type index1 () const {
+                return i_;
+            }
+            BOOST_UBLAS_INLINE
+            size_type index2 () const {
+                return j_;
+            }
+
+            // Assignment
+            BOOST_UBLAS_INLINE
+            const_iterator1 &operator = (const const_iterator1 &it) {
+                container_const_reference<self_type>::assign (&it ());
+                rank_ = it.rank_;
+                i_ = it.i_;
+                j_ = it.j_;
+                return *this;
+            }
+
+            // Comparison
+            BOOST_UBLAS_INLINE
+            bool operator == (const const_iterator1 &it) const {
+                BOOST_UBLAS_CHECK (&(*this) () == &it (), external_logic ());
+                return i_ == it.i_ && j_ == it.j_;
+            }
+
+        private:
+            int rank_;
+            size_type i_;
+            size_type j_;
+        };
+
+        typedef const_iterator1 iterator1;
+
+        BOOST_UBLAS_INLINE
+        const_iterator1 begin1 () const {
+            return find1 (0, 0, 0);
+        }
+        BOOST_UBLAS_INLINE
+        const_iterator1 cbegin1 () const {
+            return begin1 ();
+        }
+        BOOST_UBLAS_INLINE
+        const_iterator1 end1 () const {
+            return find1 (0, size1_, 0);
+        }
+        BOOST_UBLAS_INLINE
+        const_iterator1 cend1 () const {
+            return end1 ();
+        }
+
+        class const_iterator2:
+            public container_const_reference<sliced_ell_matrix>,
+            public bidirectional_iterator_base<sparse_bidirectional_iterator_tag,
+                                               const_iterator2, value_type> {
+        public:
+            typedef typename sliced_ell_matrix::value_type value_type;
+            typedef typename sliced_ell_matrix::difference_type difference_type;
+            typedef typename sliced_ell_matrix::const_reference reference;
+            typedef typename sliced_ell_matrix::const_pointer pointer;
+
+            typedef const_iterator1 dual_iterator_type;
+            typedef const_reverse_iterator1 dual_reverse_iterator_type;
+
+            // Construction and destruction
+            BOOST_UBLAS_INLINE
+            const_iterator2 ():
+                container_const_reference<self_type> (), rank_ (), i_ (), j_ () {}
+            BOOST_UBLAS_INLINE
+            const_iterator2 (const self_type &m, int rank, size_type i, size_type j):
+                container_const_reference<self_type> (m), rank_ (rank), i_ (i), j_ (j) {}
+
+            // Arithmetic
+            BOOST_UBLAS_INLINE
+            const_iterator2 &operator ++ () {
+                BOOST_UBLAS_CHECK (j_ < (*this) ().size2 (), bad_index ());
+                j_ = rank_ == 1 ? (*this) ().next_column (i_, j_ + 1) : j_ + 1;
+                return *this;
+            }
+            BOOST_UBLAS_INLINE
+            const_iterator2 &operator -- () {
+                BOOST_UBLAS_CHECK (j_ > 0, bad_index ());
+                j_ = rank_ == 1 ? (*this) ().previous_column (i_, j_) : j_ - 1;
+                return *this;
+            }
+
+            // Dereference
+            BOOST_UBLAS_INLINE
+            const_reference operator * () const {
+                return (*this) () (i_, j_);
+            }
+
+#ifndef BOOST_UBLAS_NO_NESTED_CLASS_RELATION
+            BOOST_UBLAS_INLINE
+#ifdef BOOST_UBLAS_MSVC_NESTED_CLASS_RELATION
+            typename self_type::
+#endif
+            const_iterator1 begin () const {
+                return (*this) ().find1 (1, 0, j_);
+            }
+            BOOST_UBLAS_INLINE
+#ifdef BOOST_UBLAS_MSVC_NESTED_CLASS_RELATION
+            typename self_type::
+#endif
+            const_iterator1 cbegin () const {
+                return begin ();
+            }
+            BOOST_UBLAS_INLINE
+#ifdef BOOST_UBLAS_MSVC_NESTED_CLASS_RELATION
+            typename self_type::
+#endif
+            const_iterator1 end () const {
+                return (*this) ().find1 (1, (*this) ().size1 (), j_);
+            }
+            BOOST_UBLAS_INLINE
+#ifdef BOOST_UBLAS_MSVC_NESTED_CLASS_RELATION
+            typename self_type::
+#endif
+            const_iterator1 cend () const {
+                return end ();
+            }
+            BOOST_UBLAS_INLINE
+#ifdef BOOST_UBLAS_MSVC_NESTED_CLASS_RELATION
+            typename self_type::
+#endif
+            const_reverse_iterator1 rbegin () const {
+                return const_reverse_iterator1 (end ());
+            }
+            BOOST_UBLAS_INLINE
+#ifdef BOOST_UBLAS_MSVC_NESTED_CLASS_RELATION
+            typename self_type::
+#endif
+            const_reverse_iterator1 crbegin () const {
+                return rbegin ();
+            }
+            BOOST_UBLAS_INLINE
+#ifdef BOOST_UBLAS_MSVC_NESTED_CLASS_RELATION
+            typename self_type::
+#endif
+            const_reverse_iterator1 rend () const {
+                return const_reverse_iterator1 (begin ());
+            }
+            BOOST_UBLAS_INLINE
+#ifdef BOOST_UBLAS_MSVC_NESTED_CLASS_RELATION
+            typename self_type::
+#endif
+            const_reverse_iterator1 crend () const {
+                return rend ();
+            }
+#endif
+
+            // Indices
+            BOOST_UBLAS_INLINE
+            size_type index1 () const {
+                return i_;
+            }
+            BOOST_UBLAS_INLINE
+            size_type index2 () const {
+                return j_;
+            }
+
+            // Assignment
+            BOOST_UBLAS_INLINE
+            const_iterator2 &operator = (const const_iterator2 &it) {
+                container_const_reference<self_type>::assign (&it ());
+                rank_ = it.rank_;
+                i_ = it.i_;
+                j_ = it.j_;
+                return *this;
+            }
+
+            // Comparison
+            BOOST_UBLAS_INLINE
+            bool operator == (const const_iterator2 &it) const {
+                BOOST_UBLAS_CHECK (&(*this) () == &it (), external_logic ());
+                return i_ == it.i_ && j_ == it.j_;
+            }
+
+        private:
+            int rank_;
+            size_type i_;
+            size_type j_;
+        };
+
+        typedef const_iterator2 iterator2;
+
+        BOOST_UBLAS_INLINE
+        const_iterator2 begin2 () const {
+            return find2 (0, 0, 0);
+        }
+        BOOST_UBLAS_INLINE
+        const_iterator2 cbegin2 () const {
+            return begin2 ();
+        }
+        BOOST_UBLAS_INLINE
+        const_iterator2 end2 () const {
+            return find2 (0, 0, size2_);
+        }
+        BOOST_UBLAS_INLINE
+        const_iterator2 cend2 () const {
+            return end2 ();
+        }
+
+        // Reverse iterators
+
+        BOOST_UBLAS_INLINE
+        const_reverse_iterator1 rbegin1 () const {
+            return const_reverse_iterator1 (end1 ());
+        }
+        BOOST_UBLAS_INLINE
+        const_reverse_iterator1 crbegin1 () const {
+            return rbegin1 ();
+        }
+        BOOST_UBLAS_INLINE
+        const_reverse_iterator1 rend1 () const {
+            return const_reverse_iterator1 (begin1 ());
+        }
+        BOOST_UBLAS_INLINE
+        const_reverse_iterator1 crend1 () const {
+            return rend1 ();
+        }
+
+        BOOST_UBLAS_INLINE
+        const_reverse_iterator2 rbegin2 () const {
+            return const_reverse_iterator2 (end2 ());
+        }
+        BOOST_UBLAS_INLINE
+        const_reverse_iterator2 crbegin2 () const {
+            return rbegin2 ();
+        }
+        BOOST_UBLAS_INLINE
+        const_reverse_iterator2 rend2 () const {
+            return const_reverse_iterator2 (begin2 ());
+        }
+        BOOST_UBLAS_INLINE
+        const_reverse_iterator2 crend2 () const {
+            return rend2 ();
+        }
+
+    private:
+        size_type size1_;
+        size_type size2_;
+        size_type sigma_;
+        size_type nnz_;
+        index_array_type chunk_data_;
+        index_array_type permutation_data_;
+        index_array_type length_data_;
+        index_array_type slot_data_;
+        index_array_type index_data_;
+        value_array_type value_data_;
+        static const value_type zero_;
+    };
+
+    template<class T, std::size_t C, class IA, class TA>
+    const typename sliced_ell_matrix<T, C, IA, TA>::value_type sliced_ell_matrix<T, C, IA, TA>::zero_ = value_type/*zero*/();
+
+    // Block compressed sparse row matrix class (BSR)
+    /** \brief Read only sparse matrix of values of type \c T stored as dense
+     * \c BR x \c BC blocks.
+     *
+     * The matrix is cut into blocks of \c BR rows and \c BC columns; the blocks
+     * holding at least one element are stored in compressed row order, each
+     * as \c BR \c BC values by rows, zeros included. Matrices from systems
+     * with several unknowns per node, for instance, have this structure; one
+     * column index per block instead of per element then saves memory
+     * bandwidth, and the products run fixed size dense block kernels that the
+     * compiler unrolls for \c BR and \c BC. Blocks across the last rows or
+     * columns, when the sizes are not multiples of the block size, are padded
+     * with zeros.
+     *
+     * The matrix is built from any matrix expression, typically a
+     * \c compressed_matrix, by finding the blocks its elements fall into;
+     * \c block_fill tells beforehand how many of the stored values a block
+     * size would waste on zeros. It cannot be changed afterwards except by
+     * assigning another one. \c prod and \c axpy_prod with dense vectors and
+     * dense matrices run multithreaded block kernels; element access and the
+     * iterators, which visit every stored value, search the blocks and are
+     * meant for inspection.
+     *
+     * \tparam T the type of object stored in the matrix (like double, float, complex, etc...)
+     * \tparam BR the number of rows of the blocks
+     * \tparam BC the number of columns of the blocks
+     * \tparam IA the type of adapted array for indices. By default, it is \c unbounded_array<std::size_t>
+     * \tparam TA the type of adapted array for values. By default, it is \c unbounded_array<T>
+     */
+    template<class T, std::size_t BR, std::size_t BC, class IA, class TA>
+    class block_compressed_matrix:
+        public matrix_container<block_compressed_matrix<T, BR, BC, IA, TA> > {
+
+        typedef const T *const_pointer;
+        typedef block_compressed_matrix<T, BR, BC, IA, TA> self_type;
+    public:
+#ifdef BOOST_UBLAS_ENABLE_PROXY_SHORTCUTS
+        using matrix_container<self_type>::operator ();
+#endif
+        typedef typename IA::value_type size_type;
+        typedef typename IA::size_type array_size_type;
+        typedef typename IA::difference_type difference_type;
+        typedef T value_type;
+        typedef const T &const_reference;
+        typedef const T &reference;
+        typedef IA index_array_type;
+        typedef TA value_array_type;
+        typedef const matrix_reference<const self_type> const_closure_type;
+        typedef matrix_reference<self_type> closure_type;
+        typedef compressed_vector<T, 0, IA, TA> vector_temporary_type;
+        typedef compressed_matrix<T, row_major, 0, IA, TA> matrix_temporary_type;
+        typedef sparse_tag storage_category;
+        typedef row_major_tag orientation_category;
+
+        BOOST_STATIC_CONSTANT (std::size_t, block_size1 = BR);
+        BOOST_STATIC_CONSTANT (std::size_t, block_size2 = BC);
+
+        // Construction and destruction
+        BOOST_UBLAS_INLINE
+        block_compressed_matrix ():
+            matrix_container<self_type> (),
+            size1_ (0), size2_ (0), nnz_ (0),
+            index1_data_ (1, 0), index2_data_ (), value_data_ () {}
+        BOOST_UBLAS_INLINE
+        block_compressed_matrix (const compressed_matrix<T, row_major, 0, IA, TA> &m):
+            matrix_container<self_type> () {
+            build (m);
+        }
+        template<class AE>
+        BOOST_UBLAS_INLINE
+        block_compressed_matrix (const matrix_expression<AE> &ae):
+            matrix_container<self_type> () {
+            build (matrix_temporary_type (ae));
+        }
+
+        // Accessors
+        BOOST_UBLAS_INLINE
+        size_type size1 () const {
+            return size1_;
+        }
+        BOOST_UBLAS_INLINE
+        size_type size2 () const {
+            return size2_;
+        }
+        // Elements of the source, without the zeros of the blocks
+        BOOST_UBLAS_INLINE
+        size_type nnz () const {
+            return nnz_;
+        }
+        BOOST_UBLAS_INLINE
+        size_type block_rows () const {
+            return (size1_ + BR - 1) / BR;
+        }
+        BOOST_UBLAS_INLINE
+        size_type block_columns () const {
+            return (size2_ + BC - 1) / BC;
+        }
+        BOOST_UBLAS_INLINE
+        size_type blocks () const {
+            return size_type (index2_data_.size ());
+        }
+
+        // Storage accessors
+        // The blocks of block row I are [index1_data () [I], index1_data () [I + 1]),
+        // block b sitting in block column index2_data () [b], sorted, with its
+        // values at value_data () [b BR BC ..] row after row.
+        BOOST_UBLAS_INLINE
+        const index_array_type &index1_data () const {
+            return index1_data_;
+        }
+        BOOST_UBLAS_INLINE
+        const index_array_type &index2_data () const {
+            return index2_data_;
+        }
+        BOOST_UBLAS_INLINE
+        const value_array_type &value_data () const {
+            return value_data_;
+        }
+
+        // Element access
+        BOOST_UBLAS_INLINE
+        const_reference operator () (size_type i, size_type j) const {
+            BOOST_UBLAS_CHECK (i < size1_, bad_index ());
+            BOOST_UBLAS_CHECK (j < size2_, bad_index ());
+            const size_type b = find_block (i / BR, j / BC);
+            if (b == npos)
+                return zero_;
+            return value_data_ [b * BR * BC + i % BR * BC + j % BC];
+        }
+
+        // Assignment
+        template<class AE>
+        BOOST_UBLAS_INLINE
+        block_compressed_matrix &operator = (const matrix_expression<AE> &ae) {
+            self_type temporary (ae);
+            return assign_temporary (temporary);
+        }
+        BOOST_UBLAS_INLINE
+        block_compressed_matrix &assign_temporary (block_compressed_matrix &m) {
+            swap (m);
+            return *this;
+        }
+
+        // Swapping
+        BOOST_UBLAS_INLINE
+        void swap (block_compressed_matrix &m) {
+            if (this != &m) {
+                std::swap (size1_, m.size1_);
+                std::swap (size2_, m.size2_);
+                std::swap (nnz_, m.nnz_);
+                index1_data_.swap (m.index1_data_);
+                index2_data_.swap (m.index2_data_);
+                value_data_.swap (m.value_data_);
+            }
+        }
+        BOOST_UBLAS_INLINE
+        friend void swap (block_compressed_matrix &m1, block_compressed_matrix &m2) {
+            m1.swap (m2);
+        }
+
+    private:
+        static const size_type npos = size_type (-1);
+
+        void build (const matrix_temporary_type &m) {
+            size1_ = m.size1 ();
+            size2_ = m.size2 ();
+            nnz_ = m.nnz ();
+            const size_type rows = block_rows (), columns = block_columns ();
+            const size_type filled = size_type (m.filled1 ()) - 1;
+
+            // The blocks of each block row, in column order; owner marks the
+            // block columns already seen in the current block row
+            std::vector<size_type> owner (columns, size_type (npos)), found;
+            index1_data_.resize (rows + 1);
+            index1_data_ [0] = 0;
+            std::vector<size_type> block_columns_found;
+            for (size_type I = 0; I < rows; ++ I) {
+                found.clear ();
+                for (size_type i = I * BR; i < (std::min) (filled, (I + 1) * BR); ++ i)
+                    for (size_type p = m.index1_data () [i]; p < m.index1_data () [i + 1]; ++ p) {
+                        const size_type J = m.index2_data () [p] / BC;
+                        if (owner [J] != I) {
+                            owner [J] = I;
+                            found.push_back (J);
+                        }
+                    }
+                std::sort (found.begin (), found.end ());
+                block_columns_found.insert (block_columns_found.end (), found.begin (), found.end ());
+                index1_data_ [I + 1] = size_type (block_columns_found.size ());
+            }
+            index2_data_.resize (block_columns_found.size ());
+            std::copy (block_columns_found.begin (), block_columns_found.end (), index2_data_.begin ());
+
+            // owner now maps the block columns of the current block row to
+            // their blocks
+            value_data_.resize (block_columns_found.size () * BR * BC);
+            std::fill (value_data_.begin (), value_data_.end (), value_type/*zero*/());
+            for (size_type I = 0; I < rows; ++ I) {
+                for (size_type b = index1_data_ [I]; b < index1_data_ [I + 1]; ++ b)
+                    owner [index2_data_ [b]] = b;
+                for (size_type i = I * BR; i < (std::min) (filled, (I + 1) * BR); ++ i)
+                    for (size_type p = m.index1_data () [i]; p < m.index1_data () [i + 1]; ++ p) {
+                        const size_type j = m.index2_data () [p];
+                        value_data_ [owner [j / BC] * BR * BC + i % BR * BC + j % BC] = m.value_data () [p];
+                    }
+            }
+        }
+
+        // Block of block row I in block column J, npos if none
+        BOOST_UBLAS_INLINE
+        size_type find_block (size_type I, size_type J) const {
+            const size_type b = first_block (I, J);
+            return b < index1_data_ [I + 1] && index2_data_ [b] == J ? b : size_type (npos);
+        }
+        // First block of block row I in block column J or after
+        BOOST_UBLAS_INLINE
+        size_type first_block (size_type I, size_type J) const {
+            return size_type (std::lower_bound (index2_data_.begin () + index1_data_ [I],
+                                                index2_data_.begin () + index1_data_ [I + 1], J) -
+                              index2_data_.begin ());
+        }
+
+        // First stored column of row i at or after j, size2 if none
+        BOOST_UBLAS_INLINE
+        size_type next_column (size_type i, size_type j) const {
+            const size_type b = first_block (i / BR, j / BC);
+            if (b == index1_data_ [i / BR + 1])
+                return size2_;
+            return (std::min) ((std::max) (j, size_type (index2_data_ [b] * BC)), size2_);
+        }
+        // Last stored column of row i before j
+        BOOST_UBLAS_INLINE
+        size_type previous_column (size_type i, size_type j) const {
+            const size_type b = first_block (i / BR, (j - 1) / BC + 1);
+            if (b == index1_data_ [i / BR])
+                return 0;
+            return (std::min) (j - 1, size_type (index2_data_ [b - 1] * BC + BC - 1));
+        }
+        BOOST_UBLAS_INLINE
+        bool stored (size_type i, size_type j) const {
+            return i < size1_ && find_block (i / BR, j / BC) != npos;
+        }
+        // First row at or after i storing column j, size1 if none
+        BOOST_UBLAS_INLINE
+        size_type next_row (size_type i, size_type j) const {
+            while (i < size1_ && ! stored (i, j))
+                i = (i / BR + 1) * BR;
+            return (std::min) (i, size1_);
+        }
+        // Last row before i storing column j
+        BOOST_UBLAS_INLINE
+        size_type previous_row (size_type i, size_type j) const {
+            while (i > 0 && ! stored (i - 1, j))
+                i = (i - 1) / BR * BR;
+            return i > 0 ? i - 1 : 0;
+        }
+
+    public:
+        class const_iterator1;
+        class const_iterator2;
+        typedef reverse_iterator_base1<const_iterator1> const_reverse_iterator1;
+        typedef reverse_iterator_base2<const_iterator2> const_reverse_iterator2;
+
+        // Element lookup
+        BOOST_UBLAS_INLINE
+        const_iterator1 find1 (int rank, size_type i, size_type j) const {
+            if (rank == 1)
+                i = next_row (i, j);
+            return const_iterator1 (*this, rank, i, j);
+        }
+        BOOST_UBLAS_INLINE
+        const_iterator2 find2 (int rank, size_type i, size_type j) const {
+            if (rank == 1 && i < size1_)
+                j = next_column (i, j);
+            return const_iterator2 (*this, rank, i, j);
+        }
+
+        class const_iterator1:
+            public container_const_reference<block_compressed_matrix>,
+            public bidirectional_iterator_base<sparse_bidirectional_iterator_tag,
+                                               const_iterator1, value_type> {
+        public:
+            typedef typename block_compressed_matrix::value_type value_type;
+            typedef typename block_compressed_matrix::difference_type difference_type;
+            typedef typename block_compressed_matrix::const_reference reference;
+            typedef typename block_compressed_matrix::const_pointer pointer;
+
+            typedef const_iterator2 dual_iterator_type;
+            typedef const_reverse_iterator2 dual_reverse_iterator_type;
+
+            // Construction and destruction
+            BOOST_UBLAS_INLINE
+            const_iterator1 ():
+                container_const_reference<self_type> (), rank_ (), i_ (), j_ () {}
+            BOOST_UBLAS_INLINE
+            const_iterator1 (const self_type &m, int rank, size_type i, size_type j):
+                container_const_reference<self_type> (m), rank_ (rank), i_ (i), j_ (j) {}
+
+            // Arithmetic
+            BOOST_UBLAS_INLINE
+            const_iterator1 &operator ++ () {
+                BOOST_UBLAS_CHECK (i_ < (*this) ().size1 (), bad_index ());
+                i_ = rank_ == 1 ? (*this) ().next_row (i_ + 1, j_) : i_ + 1;
+                return *this;
+            }
+            BOOST_UBLAS_INLINE
+            const_iterator1 &operator -- () {
+                BOOST_UBLAS_CHECK (i_ > 0, bad_index ());
+                i_ = rank_ == 1 ? (*this) ().previous_row (i_, j_) : i_ - 1;
+                return *this;
+            }
+
+            // Dereference
+            BOOST_UBLAS_INLINE
+            const_reference operator * () const {
+                return (*this) () (i_, j_);
+            }
+
+#ifndef BOOST_UBLAS_NO_NESTED_CLASS_RELATION
+            BOOST_UBLAS_INLINE
+#ifdef BOOST_UBLAS_MSVC_NESTED_CLASS_RELATION
+            typename self_type::
+#endif
+            const_iterator2 begin () const {
+                return (*this) ().find2 (1, i_, 0);
+            }
+            BOOST_UBLAS_INLINE
+#ifdef BOOST_UBLAS_MSVC_NESTED_CLASS_RELATION
+            typename self_type::
+#endif
+            const_iterator2 cbegin () const {
+                return begin ();
+            }
+            BOOST_UBLAS_INLINE
+#ifdef BOOST_UBLAS_MSVC_NESTED_CLASS_RELATION
+            typename self_type::
+#endif
+            const_iterator2 end () const {
+                return (*this) ().find2 (1, i_, (*this) ().size2 ());
+            }
+            BOOST_UBLAS_INLINE
+#ifdef BOOST_UBLAS_MSVC_NESTED_CLASS_RELATION
+            typename self_type::
+#endif
+            const_iterator2 cend () const {
+                return end ();
+            }
+            BOOST_UBLAS_INLINE
+#ifdef BOOST_UBLAS_MSVC_NESTED_CLASS_RELATION
+            typename self_type::
+#endif
+            const_reverse_iterator2 rbegin () const {
+                return const_reverse_iterator2 (end ());
+            }
+            BOOST_UBLAS_INLINE
+#ifdef BOOST_UBLAS_MSVC_NESTED_CLASS_RELATION
+            typename self_type::
+#endif
+            const_reverse_iterator2 crbegin () const {
+                return rbegin ();
+            }
+            BOOST_UBLAS_INLINE
+#ifdef BOOST_UBLAS_MSVC_NESTED_CLASS_RELATION
+            typename self_type::
+#endif
+            const_reverse_iterator2 rend () const {
+                return const_reverse_iterator2 (begin ());
+            }
+            BOOST_UBLAS_INLINE
+#ifdef BOOST_UBLAS_MSVC_NESTED_CLASS_RELATION
+            typename self_type::
+#endif
+            const_reverse_iterator2 crend () const {
+                return rend ();
+            }
+#endif
+
+            // Indices
+            BOOST_UBLAS_INLINE
+            size_type index1 () const {
+                return i_;
+            }
+            BOOST_UBLAS_INLINE
+            size_type index2 () const {
+                return j_;
+            }
+
+            // Assignment
+            BOOST_UBLAS_INLINE
+            const_iterator1 &operator = (const const_iterator1 &it) {
+                container_const_reference<self_type>::assign (&it ());
+                rank_ = it.rank_;
+                i_ = it.i_;
+                j_ = it.j_;
+                return *this;
+            }
+
+            // Comparison
+            BOOST_UBLAS_INLINE
+            bool operator == (const const_iterator1 &it) const {
+                BOOST_UBLAS_CHECK (&(*this) () == &it (), external_logic ());
+                return i_ == it.i_ && j_ == it.j_;
+            }
+
+        private:
+            int rank_;
+            size_type i_;
+            size_type j_;
+        };
+
+        typedef const_iterator1 iterator1;
+
+        BOOST_UBLAS_INLINE
+        const_iterator1 begin1 () const {
+            return find1 (0, 0, 0);
+        }
+        BOOST_UBLAS_INLINE
+        const_iterator1 cbegin1 () const {
+            return begin1 ();
+        }
+        BOOST_UBLAS_INLINE
+        const_iterator1 end1 () const {
+            return find1 (0, size1_, 0);
+        }
+        BOOST_UBLAS_INLINE
+        const_iterator1 cend1 () const {
+            return end1 ();
+        }
+
+        class const_iterator2:
+            public container_const_reference<block_compressed_matrix>,
+            public bidirectional_iterator_base<sparse_bidirectional_iterator_tag,
+                                               const_iterator2, value_type> {
+        public:
+            typedef typename block_compressed_matrix::value_type value_type;
+            typedef typename block_compressed_matrix::difference_type difference_type;
+            typedef typename block_compressed_matrix::const_reference reference;
+            typedef typename block_compressed_matrix::const_pointer pointer;
+
+            typedef const_iterator1 dual_iterator_type;
+            typedef const_reverse_iterator1 dual_reverse_iterator_type;
+
+            // Construction and destruction
+            BOOST_UBLAS_INLINE
+            const_iterator2 ():
+                container_const_reference<self_type> (), rank_ (), i_ (), j_ () {}
+            BOOST_UBLAS_INLINE
+            const_iterator2 (const self_type &m, int rank, size_type i, size_type j):
+                container_const_reference<self_type> (m), rank_ (rank), i_ (i), j_ (j) {}
+
+            // Arithmetic
+            BOOST_UBLAS_INLINE
+            const_iterator2 &operator ++ () {
+                BOOST_UBLAS_CHECK (j_ < (*this) ().size2 (), bad_index ());
+                j_ = rank_ == 1 ? (*this) ().next_column (i_, j_ + 1) : j_ + 1;
+                return *this;
+            }
+            BOOST_UBLAS_INLINE
+            const_iterator2 &operator -- () {
+                BOOST_UBLAS_CHECK (j_ > 0, bad_index ());
+                j_ = rank_ == 1 ? (*this) ().previous_column (i_, j_) : j_ - 1;
+                return *this;
+            }
+
+            // Dereference
+            BOOST_UBLAS_INLINE
+            const_reference operator * () const {
+                return (*this) () (i_, j_);
+            }
+
+#ifndef BOOST_UBLAS_NO_NESTED_CLASS_RELATION
+            BOOST_UBLAS_INLINE
+#ifdef BOOST_UBLAS_MSVC_NESTED_CLASS_RELATION
+            typename self_type::
+#endif
+            const_iterator1 begin () const {
+                return (*this) ().find1 (1, 0, j_);
+            }
+            BOOST_UBLAS_INLINE
+#ifdef BOOST_UBLAS_MSVC_NESTED_CLASS_RELATION
+            typename self_type::
+#endif
+            const_iterator1 cbegin () const {
+                return begin ();
+            }
+            BOOST_UBLAS_INLINE
+#ifdef BOOST_UBLAS_MSVC_NESTED_CLASS_RELATION
+            typename self_type::
+#endif
+            const_iterator1 end () const {
+                return (*this) ().find1 (1, (*this) ().size1 (), j_);
+            }
+            BOOST_UBLAS_INLINE
+#ifdef BOOST_UBLAS_MSVC_NESTED_CLASS_RELATION
+            typename self_type::
+#endif
+            const_iterator1 cend () const {
+                return end ();
+            }
+            BOOST_UBLAS_INLINE
+#ifdef BOOST_UBLAS_MSVC_NESTED_CLASS_RELATION
+            typename self_type::
+#endif
+            const_reverse_iterator1 rbegin () const {
+                return const_reverse_iterator1 (end ());
+            }
+            BOOST_UBLAS_INLINE
+#ifdef BOOST_UBLAS_MSVC_NESTED_CLASS_RELATION
+            typename self_type::
+#endif
+            const_reverse_iterator1 crbegin () const {
+                return rbegin ();
+            }
+            BOOST_UBLAS_INLINE
+#ifdef BOOST_UBLAS_MSVC_NESTED_CLASS_RELATION
+            typename self_type::
+#endif
+            const_reverse_iterator1 rend () const {
+                return const_reverse_iterator1 (begin ());
+            }
+            BOOST_UBLAS_INLINE
+#ifdef BOOST_UBLAS_MSVC_NESTED_CLASS_RELATION
+            typename self_type::
+#endif
+            const_reverse_iterator1 crend () const {
+                return rend ();
+            }
+#endif
+
+            // Indices
+            BOOST_UBLAS_INLINE
+            size_type index1 () const {
+                return i_;
+            }
+            BOOST_UBLAS_INLINE
+            size_type index2 () const {
+                return j_;
+            }
+
+            // Assignment
+            BOOST_UBLAS_INLINE
+            const_iterator2 &operator = (const const_iterator2 &it) {
+                container_const_reference<self_type>::assign (&it ());
+                rank_ = it.rank_;
+                i_ = it.i_;
+                j_ = it.j_;
+                return *this;
+            }
+
+            // Comparison
+            BOOST_UBLAS_INLINE
+            bool operator == (const const_iterator2 &it) const {
+                BOOST_UBLAS_CHECK (&(*this) () == &it (), external_logic ());
+                return i_ == it.i_ && j_ == it.j_;
+            }
+
+        private:
+            int rank_;
+            size_type i_;
+            size_type j_;
+        };
+
+        typedef const_iterator2 iterator2;
+
+        BOOST_UBLAS_INLINE
+        const_iterator2 begin2 () const {
+            return find2 (0, 0, 0);
+        }
+        BOOST_UBLAS_INLINE
+        const_iterator2 cbegin2 () const {
+            return begin2 ();
+        }
+        BOOST_UBLAS_INLINE
+        const_iterator2 end2 () const {
+            return find2 (0, 0, size2_);
+        }
+        BOOST_UBLAS_INLINE
+        const_iterator2 cend2 () const {
+            return end2 ();
+        }
+
+        // Reverse iterators
+
+        BOOST_UBLAS_INLINE
+        const_reverse_iterator1 rbegin1 () const {
+            return const_reverse_iterator1 (end1 ());
+        }
+        BOOST_UBLAS_INLINE
+        const_reverse_iterator1 crbegin1 () const {
+            return rbegin1 ();
+        }
+        BOOST_UBLAS_INLINE
+        const_reverse_iterator1 rend1 () const {
+            return const_reverse_iterator1 (begin1 ());
+        }
+        BOOST_UBLAS_INLINE
+        const_reverse_iterator1 crend1 () const {
+            return rend1 ();
+        }
+
+        BOOST_UBLAS_INLINE
+        const_reverse_iterator2 rbegin2 () const {
+            return const_reverse_iterator2 (end2 ());
+        }
+        BOOST_UBLAS_INLINE
+        const_reverse_iterator2 crbegin2 () const {
+            return rbegin2 ();
+        }
+        BOOST_UBLAS_INLINE
+        const_reverse_iterator2 rend2 () const {
+            return const_reverse_iterator2 (begin2 ());
+        }
+        BOOST_UBLAS_INLINE
+        const_reverse_iterator2 crend2 () const {
+            return rend2 ();
+        }
+
+    private:
+        size_type size1_;
+        size_type size2_;
+        size_type nnz_;
+        index_array_type index1_data_;
+        index_array_type index2_data_;
+        value_array_type value_data_;
+        static const value_type zero_;
+    };
+
+    template<class T, std::size_t BR, std::size_t BC, class IA, class TA>
+    const typename block_compressed_matrix<T, BR, BC, IA, TA>::value_type block_compressed_matrix<T, BR, BC, IA, TA>::zero_ = value_type/*zero*/();
+
+    /** \brief Fraction of the values of a \c block_compressed_matrix with
+     * \c br x \c bc blocks built from \c m that would hold elements of \c m,
+     * the others being zeros of the blocks; 1 for an empty matrix.
+     *
+     * Compare the candidate block sizes of a matrix with it before choosing
+     * the template arguments.
+     */
+    template<class T, class IA, class TA>
+    double block_fill (const compressed_matrix<T, row_major, 0, IA, TA> &m, std::size_t br, std::size_t bc) {
+        BOOST_UBLAS_CHECK (br > 0 && bc > 0, bad_argument ());
+        const std::size_t rows = (m.size1 () + br - 1) / br, columns = (m.size2 () + bc - 1) / bc;
+        const std::size_t filled = std::size_t (m.filled1 ()) - 1;
+        const std::size_t npos = std::size_t (-1);
+        std::vector<std::size_t> owner (columns, npos);
+        std::size_t blocks = 0;
+        for (std::size_t I = 0; I < rows; ++ I)
+            for (std::size_t i = I * br; i < (std::min) (filled, (I + 1) * br); ++ i)
+                for (std::size_t p = m.index1_data () [i]; p < std::size_t (m.index1_data () [i + 1]); ++ p) {
+                    const std::size_t J = m.index2_data () [p] / bc;
+                    if (owner [J] != I) {
+                        owner [J] = I;
+                        ++ blocks;
+                    }
+                }
+        return blocks == 0 ? 1.0 : double (m.nnz ()) / double (blocks * br * bc);
+    }
+
 }}}
 
 #endif
@@ -14,6 +14,7 @@
 #define _BOOST_UBLAS_OPERATION_
 
 #include <boost/numeric/ublas/matrix_proxy.hpp>
+#include <boost/numeric/ublas/detail/spmv.hpp>
 
 /** \file operation.hpp
  *  \brief This file contains some specialized products.
@@ -34,6 +35,10 @@ namespace boost { namespace numeric { namespace ublas {
         typedef typename V::size_type size_type;
         typedef typename V::value_type value_type;
 
+        // Dense results go through the multithreaded kernel
+        if (detail::compressed_prod_assign<scalar_plus_assign> (v, e1, false, e2 ()))
+            return v;
+
         for (size_type i = 0; i < e1.filled1 () -1; ++ i) {
             size_type begin = e1.index1_data () [i];
             size_type end = e1.index1_data () [i + 1];
@@ -53,6 +58,10 @@ namespace boost { namespace numeric { namespace ublas {
                V &v, column_major_tag) {
         typedef typename V::size_type size_type;
 
+        // Dense results go through the multithreaded kernel
+        if (detail::compressed_prod_assign<scalar_plus_assign> (v, e1, false, e2 ()))
+            return v;
+
         for (size_type j = 0; j < e1.filled1 () -1; ++ j) {
             size_type begin = e1.index1_data () [j];
             size_type end = e1.index1_data () [j + 1];
@@ -122,6 +131,81 @@ namespace boost { namespace numeric { namespace ublas {
         return v;
     }
 
+    template<class V, class T1, std::size_t C1, class IA1, class TA1, class E2>
+    BOOST_UBLAS_INLINE
+    V &
+    axpy_prod (const sliced_ell_matrix<T1, C1, IA1, TA1> &e1,
+               const vector_expression<E2> &e2,
+               V &v, bool init = true) {
+        typedef typename V::size_type size_type;
+        typedef typename V::value_type value_type;
+
+        if (init)
+            v.assign (zero_vector<value_type> (e1.size1 ()));
+
+        // Dense results go through the vectorised, multithreaded kernel
+        if (detail::sell_prod_assign<scalar_plus_assign> (v, e1, e2 ()))
+            return v;
+
+        for (size_type s = 0; s < e1.size1 (); ++ s) {
+            const size_type begin = e1.chunk_data () [s / C1] + s % C1;
+            value_type t (v (e1.permutation_data () [s]));
+            for (size_type k = 0; k < e1.length_data () [s]; ++ k)
+                t += e1.value_data () [begin + k * C1] * e2 () (e1.index_data () [begin + k * C1]);
+            v (e1.permutation_data () [s]) = t;
+        }
+        return v;
+    }
+
+    template<class V, class T1, std::size_t BR1, std::size_t BC1, class IA1, class TA1, class E2>
+    BOOST_UBLAS_INLINE
+    V &
+    axpy_prod (const block_compressed_matrix<T1, BR1, BC1, IA1, TA1> &e1,
+               const vector_expression<E2> &e2,
+               V &v, bool init = true) {
+        typedef typename V::size_type size_type;
+        typedef typename V::value_type value_type;
+
+        if (init)
+            v.assign (zero_vector<value_type> (e1.size1 ()));
+
+        // Dense results go through the multithreaded block kernel
+        if (detail::bsr_prod_assign<scalar_plus_assign> (v, e1, e2 ()))
+            return v;
+
+        for (size_type k = 0; k < e1.block_rows (); ++ k)
+            for (size_type b = e1.index1_data () [k]; b < e1.index1_data () [k + 1]; ++ b)
+                for (size_type r = 0; r < BR1 && k * BR1 + r < e1.size1 (); ++ r)
+                    for (size_type c = 0; c < BC1 && e1.index2_data () [b] * BC1 + c < e1.size2 (); ++ c)
+                        v (k * BR1 + r) += e1.value_data () [(b * BR1 + r) * BC1 + c] * e2 () (e1.index2_data () [b] * BC1 + c);
+        return v;
+    }
+
+    template<class M, class T1, std::size_t BR1, std::size_t BC1, class IA1, class TA1, class E2>
+    BOOST_UBLAS_INLINE
+    M &
+    axpy_prod (const block_compressed_matrix<T1, BR1, BC1, IA1, TA1> &e1,
+               const matrix_expression<E2> &e2,
+               M &m, bool init = true) {
+        typedef typename M::size_type size_type;
+        typedef typename M::value_type value_type;
+
+        if (init)
+            m.assign (zero_matrix<value_type> (e1.size1 (), e2 ().size2 ()));
+
+        // Dense results go through the multithreaded block kernel
+        if (detail::bsr_matrix_prod_assign<scalar_plus_assign> (m, e1, e2 ()))
+            return m;
+
+        for (size_type k = 0; k < e1.block_rows (); ++ k)
+            for (size_type b = e1.index1_data () [k]; b < e1.index1_data () [k + 1]; ++ b)
+                for (size_type r = 0; r < BR1 && k * BR1 + r < e1.size1 (); ++ r)
+                    for (size_type c = 0; c < BC1 && e1.index2_data () [b] * BC1 + c < e1.size2 (); ++ c)
+                        row (m, k * BR1 + r).plus_assign (e1.value_data () [(b * BR1 + r) * BC1 + c] *
+                                                          row (e2 (), e1.index2_data () [b] * BC1 + c));
+        return m;
+    }
+
     template<class V, class E1, class E2>
     BOOST_UBLAS_INLINE
     V &
@@ -277,6 +361,10 @@ namespace boost { namespace numeric { namespace ublas {
         typedef typename V::size_type size_type;
         typedef typename V::value_type value_type;
 
+        // Dense results go through the multithreaded kernel
+        if (detail::compressed_prod_assign<scalar_plus_assign> (v, e2, true, e1 ()))
+            return v;
+
         for (size_type j = 0; j < e2.filled1 () -1; ++ j) {
             size_type begin = e2.index1_data () [j];
             size_type end = e2.index1_data () [j + 1];
@@ -296,6 +384,10 @@ namespace boost { namespace numeric { namespace ublas {
                V &v, row_major_tag) {
         typedef typename V::size_type size_type;
 
+        // Dense results go through the multithreaded kernel
+        if (detail::compressed_prod_assign<scalar_plus_assign> (v, e2, true, e1 ()))
+            return v;
+
         for (size_type i = 0; i < e2.filled1 () -1; ++ i) {
             size_type begin = e2.index1_data () [i];
             size_type end = e2.index1_data () [i + 1];
@@ -679,7 +771,9 @@ namespace boost { namespace numeric { namespace ublas {
           <tt>M.clear()</tt> before <tt>axpy_prod</tt>. Currently \a init
           defaults to \c true, but this may change in the future.
 
-          Up to now there are no specialisations.
+          If \c M, \c A and \c X are all dense matrices with unbounded_array
+          storage or c_matrix of the same value type, the product is computed
+          by the cache blocked packed kernel in detail/gemm.hpp.
           
           \ingroup blas3
 
@@ -700,6 +794,8 @@ namespace boost { namespace numeric { namespace ublas {
         typedef typename M::storage_category storage_category;
         typedef typename M::orientation_category orientation_category;
 
+        if (detail::gemm_prod (m, e1 (), e2 (), value_type (1), init ? value_type (0) : value_type (1)))
+            return m;
         if (init)
             m.assign (zero_matrix<value_type> (e1 ().size1 (), e2 ().size2 ()));
         return axpy_prod (e1, e2, m, full (), storage_category (), orientation_category ());
@@ -712,7 +808,7 @@ namespace boost { namespace numeric { namespace ublas {
         typedef M matrix_type;
 
         matrix_type m (e1 ().size1 (), e2 ().size2 ());
-        return axpy_prod (e1, e2, m, full (), true);
+        return axpy_prod (e1, e2, m, true);
     }
 
 
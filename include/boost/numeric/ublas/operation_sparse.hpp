@@ -14,6 +14,9 @@
 #define _BOOST_UBLAS_OPERATION_SPARSE_
 
 #include <boost/numeric/ublas/traits.hpp>
+#include <boost/numeric/ublas/vector.hpp>
+#include <boost/numeric/ublas/matrix_proxy.hpp>
+#include <boost/numeric/ublas/detail/spgemm.hpp>
 
 // These scaled additions were borrowed from MTL unashamedly.
 // But Alexei Novakov had a lot of ideas to improve these. Thanks.
@@ -149,6 +152,9 @@ namespace boost { namespace numeric { namespace ublas {
         typedef TRI triangular_restriction;
         typedef typename M::orientation_category orientation_category;
 
+        // Compressed matrices stored alike run the two pass kernel of spgemm.hpp
+        if (init && detail::spgemm_assign<triangular_restriction> (e1 (), e2 (), m))
+            return m;
         if (init)
             m.assign (zero_matrix<value_type> (e1 ().size1 (), e2 ().size2 ()));
         return sparse_prod (e1, e2, m, triangular_restriction (), orientation_category ());
@@ -176,6 +182,8 @@ namespace boost { namespace numeric { namespace ublas {
         typedef typename M::value_type value_type;
         typedef typename M::orientation_category orientation_category;
 
+        if (init && detail::spgemm_assign<full> (e1 (), e2 (), m))
+            return m;
         if (init)
             m.assign (zero_matrix<value_type> (e1 ().size1 (), e2 ().size2 ()));
         return sparse_prod (e1, e2, m, full (), orientation_category ());
@@ -0,0 +1,172 @@
+//
+//  Copyright (c) 2017
+//  uBLAS developers
+//
+//  Distributed under the Boost Software License, Version 1.0. (See
+//  accompanying file LICENSE_1_0.txt or copy at
+//  http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#ifndef _BOOST_UBLAS_QR_
+#define _BOOST_UBLAS_QR_
+
+#include <vector>
+
+#include <boost/numeric/ublas/matrix.hpp>
+#include <boost/numeric/ublas/matrix_proxy.hpp>
+#include <boost/numeric/ublas/vector.hpp>
+#include <boost/numeric/ublas/triangular.hpp>
+#include <boost/numeric/ublas/detail/dense_traits.hpp>
+#include <boost/numeric/ublas/detail/geqrf.hpp>
+#include <boost/numeric/ublas/detail/thread_pool.hpp>
+
+// Householder QR factorization and linear least squares in the spirit of
+// LAPACK's geqrf, ormqr and gels: A = Q R with Q stored as reflectors below
+// the diagonal of A and the scalars tau.
+
+namespace boost { namespace numeric { namespace ublas {
+
+namespace detail {
+
+    template<class M, class T>
+    BOOST_UBLAS_INLINE
+    void qr_factorize (M &m, T *tau, boost::mpl::true_) {
+        typedef dense_matrix_traits<M> traits;
+        geqrf (m.size1 (), m.size2 (), traits::data (m), traits::stride1 (m), traits::stride2 (m), tau);
+    }
+    // Without raw storage the factorization runs on a copy
+    template<class M, class T>
+    BOOST_UBLAS_INLINE
+    void qr_factorize (M &m, T *tau, boost::mpl::false_) {
+        matrix<T, column_major> a (m);
+        qr_factorize (a, tau, boost::mpl::true_ ());
+        m.assign (a);
+    }
+
+    // b = Q^H b for the m x k column major b
+    template<class M, class T>
+    BOOST_UBLAS_INLINE
+    void qr_apply_adjoint (const M &m, const T *tau, matrix<T, column_major> &b, boost::mpl::true_) {
+        typedef dense_matrix_traits<M> traits;
+        geqrf_apply (m.size1 (), m.size2 (), traits::data (m), traits::stride1 (m), traits::stride2 (m), tau,
+                     b.size2 (), &b.data () [0], 1, std::ptrdiff_t (b.leading_dimension ()));
+    }
+    template<class M, class T>
+    BOOST_UBLAS_INLINE
+    void qr_apply_adjoint (const M &m, const T *tau, matrix<T, column_major> &b, boost::mpl::false_) {
+        const matrix<T, column_major> a (m);
+        qr_apply_adjoint (a, tau, b, boost::mpl::true_ ());
+    }
+    template<class M, class V, class T>
+    BOOST_UBLAS_INLINE
+    void qr_apply_adjoint (const M &m, const V &tau, matrix<T, column_major> &b) {
+        BOOST_UBLAS_CHECK (m.size1 () == b.size1 (), bad_size ());
+        BOOST_UBLAS_CHECK ((std::min) (m.size1 (), m.size2 ()) == tau.size (), bad_size ());
+        if (tau.size () == 0 || b.size2 () == 0)
+            return;
+        const std::vector<T> t (tau.begin (), tau.end ());
+        qr_apply_adjoint (m, &t [0], b, boost::mpl::bool_<dense_matrix_traits<M>::value> ());
+    }
+
+    // x = R^-1 (Q^H b) (0:n) for the m x n matrix a, m >= n, both overwritten.
+    // Tall and skinny matrices are factored by row blocks in parallel.
+    template<class T>
+    void least_squares_solve (matrix<T, column_major> &a, matrix<T, column_major> &b, matrix<T> &x) {
+        const std::size_t m = a.size1 (), n = a.size2 (), k = b.size2 ();
+        const std::ptrdiff_t a2 = std::ptrdiff_t (a.leading_dimension ()), b2 = std::ptrdiff_t (b.leading_dimension ());
+        const std::size_t parts = thread_pool::instance ().size ();
+        x.resize (n, k, false);
+        if (n == 0 || k == 0)
+            return;
+        matrix<T> r (n, n);
+        if (parts > 1 && m >= 4 * parts * n) {
+            const tsqr<T> factor (m, n, &a.data () [0], 1, a2, parts);
+            for (std::size_t i = 0; i < n; ++ i)
+                for (std::size_t j = 0; j < n; ++ j)
+                    r (i, j) = factor.r () [i * n + j];
+            std::vector<T> top (n * k);
+            factor.apply (k, &b.data () [0], 1, b2, &top [0]);
+            for (std::size_t i = 0; i < n; ++ i)
+                for (std::size_t j = 0; j < k; ++ j)
+                    x (i, j) = top [i * k + j];
+        } else {
+            std::vector<T> tau (n);
+            geqrf (m, n, &a.data () [0], 1, a2, &tau [0]);
+            geqrf_apply (m, n, &a.data () [0], 1, a2, &tau [0], k, &b.data () [0], 1, b2);
+            for (std::size_t i = 0; i < n; ++ i)
+                for (std::size_t j = 0; j < n; ++ j)
+                    r (i, j) = j >= i ? a (i, j) : T ();
+            for (std::size_t i = 0; i < n; ++ i)
+                for (std::size_t j = 0; j < k; ++ j)
+                    x (i, j) = b (i, j);
+        }
+        inplace_solve (r, x, upper_tag ());
+    }
+
+}
+
+    // QR factorization A = Q R. R overwrites the upper triangle of m, the
+    // Householder vectors below it describe Q together with tau, which is
+    // resized to min (size1, size2). Dense matrices and ranges of them are
+    // factored in place, other matrices through a copy.
+    template<class M, class V>
+    void qr_factorize (M &m, V &tau) {
+        typedef typename M::value_type value_type;
+        const std::size_t size = (std::min) (m.size1 (), m.size2 ());
+        std::vector<value_type> t (size);
+        if (size != 0)
+            detail::qr_factorize (m, &t [0], boost::mpl::bool_<detail::dense_matrix_traits<M>::value> ());
+        if (tau.size () != size)
+            tau.resize (size, false);
+        std::copy (t.begin (), t.end (), tau.begin ());
+    }
+
+    // e = Q^H e with Q from qr_factorize (m, tau)
+    template<class M, class V, class E>
+    void qr_apply_adjoint (const M &m, const V &tau, vector_expression<E> &e) {
+        typedef typename M::value_type value_type;
+        matrix<value_type, column_major> b (e ().size (), 1);
+        column (b, 0).assign (e);
+        detail::qr_apply_adjoint (m, tau, b);
+        e ().assign (column (b, 0));
+    }
+    template<class M, class V, class E>
+    void qr_apply_adjoint (const M &m, const V &tau, matrix_expression<E> &e) {
+        typedef typename M::value_type value_type;
+        matrix<value_type, column_major> b (e);
+        detail::qr_apply_adjoint (m, tau, b);
+        e ().assign (b);
+    }
+
+    // Linear least squares: the x minimising || A x - b ||_2 for A of full
+    // column rank with at least as many rows as columns, through the QR
+    // factorization of a copy of A and an upper triangular solve with R
+    template<class E1, class E2>
+    typename matrix_vector_solve_traits<E1, E2>::result_type
+    least_squares_solve (const matrix_expression<E1> &e1, const vector_expression<E2> &e2) {
+        typedef typename matrix_vector_solve_traits<E1, E2>::promote_type value_type;
+        BOOST_UBLAS_CHECK (e1 ().size1 () >= e1 ().size2 (), bad_size ());
+        BOOST_UBLAS_CHECK (e1 ().size1 () == e2 ().size (), bad_size ());
+        matrix<value_type, column_major> a (e1);
+        matrix<value_type, column_major> b (e2 ().size (), 1);
+        column (b, 0).assign (e2);
+        matrix<value_type> x;
+        detail::least_squares_solve (a, b, x);
+        return typename matrix_vector_solve_traits<E1, E2>::result_type (column (x, 0));
+    }
+    template<class E1, class E2>
+    typename matrix_matrix_solve_traits<E1, E2>::result_type
+    least_squares_solve (const matrix_expression<E1> &e1, const matrix_expression<E2> &e2) {
+        typedef typename matrix_matrix_solve_traits<E1, E2>::promote_type value_type;
+        BOOST_UBLAS_CHECK (e1 ().size1 () >= e1 ().size2 (), bad_size ());
+        BOOST_UBLAS_CHECK (e1 ().size1 () == e2 ().size1 (), bad_size ());
+        matrix<value_type, column_major> a (e1);
+        matrix<value_type, column_major> b (e2);
+        matrix<value_type> x;
+        detail::least_squares_solve (a, b, x);
+        return x;
+    }
+
+}}}
+
+#endif
@@ -14,6 +14,7 @@
 #define BOOST_UBLAS_STORAGE_H
 
 #include <algorithm>
+#include <new>
 #ifdef BOOST_UBLAS_SHALLOW_ARRAY_ADAPTOR
 #include <boost/shared_array.hpp>
 #endif
@@ -21,6 +22,9 @@
 #include <boost/serialization/array.hpp>
 #include <boost/serialization/collection_size_type.hpp>
 #include <boost/serialization/nvp.hpp>
+#include <boost/static_assert.hpp>
+#include <boost/throw_exception.hpp>
+#include <boost/type_traits/alignment_of.hpp>
 
 #include <boost/numeric/ublas/exception.hpp>
 #include <boost/numeric/ublas/traits.hpp>
@@ -37,6 +41,86 @@ namespace boost { namespace numeric { namespace ublas {
     };
 
 
+    // Allocator of memory aligned to Align bytes, a power of two at least the
+    // alignment of T. Each block is over-allocated from operator new and the
+    // address operator new returned is kept in front of the aligned address.
+    template<class T, std::size_t Align = BOOST_UBLAS_ALIGNED_ALLOCATOR_ALIGN>
+    class aligned_allocator {
+        BOOST_STATIC_ASSERT (Align > 0 && (Align & (Align - 1)) == 0);
+        BOOST_STATIC_ASSERT (Align >= boost::alignment_of<T>::value);
+    public:
+        typedef T value_type;
+        typedef T *pointer;
+        typedef const T *const_pointer;
+        typedef T &reference;
+        typedef const T &const_reference;
+        typedef std::size_t size_type;
+        typedef std::ptrdiff_t difference_type;
+        static const size_type alignment = Align;
+
+        template<class U>
+        struct rebind {
+            typedef aligned_allocator<U, (Align > boost::alignment_of<U>::value ? Align : boost::alignment_of<U>::value)> other;
+        };
+
+        // Construction and destruction
+        BOOST_UBLAS_INLINE
+        aligned_allocator () {}
+        template<class U, std::size_t A>
+        BOOST_UBLAS_INLINE
+        aligned_allocator (const aligned_allocator<U, A> &) {}
+
+        BOOST_UBLAS_INLINE
+        pointer address (reference r) const {
+            return &r;
+        }
+        BOOST_UBLAS_INLINE
+        const_pointer address (const_reference r) const {
+            return &r;
+        }
+        BOOST_UBLAS_INLINE
+        size_type max_size () const {
+            return (size_type (-1) - Align - sizeof (void *)) / sizeof (T);
+        }
+
+        BOOST_UBLAS_INLINE
+        pointer allocate (size_type n, const void * = 0) {
+            if (n > max_size ())
+                boost::throw_exception (std::bad_alloc ());
+            void *raw = ::operator new (n * sizeof (T) + Align - 1 + sizeof (void *));
+            const std::size_t address = (reinterpret_cast<std::size_t> (raw) + sizeof (void *) + Align - 1) & ~(Align - 1);
+            reinterpret_cast<void **> (address) [-1] = raw;
+            return reinterpret_cast<pointer> (address);
+        }
+        BOOST_UBLAS_INLINE
+        void deallocate (pointer p, size_type) {
+            if (p)
+                ::operator delete (reinterpret_cast<void **> (p) [-1]);
+        }
+
+        BOOST_UBLAS_INLINE
+        void construct (pointer p, const_reference t) {
+            new (p) T (t);
+        }
+        BOOST_UBLAS_INLINE
+        void destroy (pointer p) {
+            p->~T ();
+        }
+    };
+
+    // All aligned allocators free each other's memory
+    template<class T, std::size_t A, class U, std::size_t B>
+    BOOST_UBLAS_INLINE
+    bool operator == (const aligned_allocator<T, A> &, const aligned_allocator<U, B> &) {
+        return true;
+    }
+    template<class T, std::size_t A, class U, std::size_t B>
+    BOOST_UBLAS_INLINE
+    bool operator != (const aligned_allocator<T, A> &, const aligned_allocator<U, B> &) {
+        return false;
+    }
+
+
     // Unbounded array - with allocator
     template<class T, class ALLOC>
     class unbounded_array:
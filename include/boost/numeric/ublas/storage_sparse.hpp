@@ -14,6 +14,7 @@
 #define _BOOST_UBLAS_STORAGE_SPARSE_
 
 #include <map>
+#include <vector>
 #include <boost/serialization/collection_size_type.hpp>
 #include <boost/serialization/nvp.hpp>
 #include <boost/serialization/array.hpp>
@@ -22,6 +23,10 @@
 
 #include <boost/numeric/ublas/storage.hpp>
 
+#if defined (BOOST_UBLAS_CPP_GE_2011) && ! defined (BOOST_UBLAS_NO_THREADS)
+#include <atomic>
+#include <mutex>
+#endif
 
 namespace boost { namespace numeric { namespace ublas {
 
@@ -527,6 +532,334 @@ namespace boost { namespace numeric { namespace ublas {
     };
 
 
+    // Hash map
+    //  Elements are kept in an array in their order of insertion, with an open
+    //  addressing index on their keys (linear probing, at most half full), so
+    //  that finding and inserting an element take constant time whatever the
+    //  order of the keys. The ordered accesses, begin and lower_bound, first
+    //  sort the array by key when it is not already; elements inserted by
+    //  increasing key keep it sorted. Iterators simply are pointers into the
+    //  array: insertions and erasures invalidate them, as for map_array, and so
+    //  does the sort of the first ordered access after unordered insertions.
+    //  Const accesses from several threads are safe: the first of them sorts
+    //  the array under a lock while the others wait for it, unless
+    //  BOOST_UBLAS_NO_THREADS is defined.
+    template<class I, class T, class ALLOC>
+    class map_hash {
+    public:
+        typedef ALLOC allocator_type;
+        typedef typename ALLOC::size_type size_type;
+        typedef typename ALLOC::difference_type difference_type;
+        typedef std::pair<I,T> value_type;
+        typedef I key_type;
+        typedef T mapped_type;
+        typedef const value_type &const_reference;
+        typedef value_type &reference;
+        typedef const value_type *const_pointer;
+        typedef value_type *pointer;
+        // Iterators simply are pointers.
+        typedef const_pointer const_iterator;
+        typedef pointer iterator;
+
+        typedef const T &data_const_reference;
+        typedef T &data_reference;
+
+        // Construction and destruction
+        BOOST_UBLAS_INLINE
+        map_hash (const ALLOC &a = ALLOC()):
+            elements_ (a), index_ (), shift_ (0), sorted_ (true) {}
+        BOOST_UBLAS_INLINE
+        map_hash (const map_hash &a):
+            elements_ (a.ordered_elements ()), index_ (a.index_), shift_ (a.shift_), sorted_ (true) {}
+
+        // Reserving
+        BOOST_UBLAS_INLINE
+        void reserve (size_type capacity) {
+            if (capacity > elements_.capacity ())
+                elements_.reserve (capacity);
+            if (2 * capacity > index_.size ())
+                rehash (capacity);
+        }
+
+        // Random Access Container
+        BOOST_UBLAS_INLINE
+        size_type size () const {
+            return elements_.size ();
+        }
+        BOOST_UBLAS_INLINE
+        size_type capacity () const {
+            return elements_.capacity ();
+        }
+        BOOST_UBLAS_INLINE
+        size_type max_size () const {
+            return elements_.max_size ();
+        }
+
+        BOOST_UBLAS_INLINE
+        bool empty () const {
+            return elements_.empty ();
+        }
+
+        // Element access
+        BOOST_UBLAS_INLINE
+        data_reference operator [] (key_type i) {
+            return insert (value_type (i, mapped_type (0))).first->second;
+        }
+
+        // Assignment
+        BOOST_UBLAS_INLINE
+        map_hash &operator = (const map_hash &a) {
+            if (this != &a) {
+                elements_ = a.ordered_elements ();
+                index_ = a.index_;
+                shift_ = a.shift_;
+                sorted_ = true;
+            }
+            return *this;
+        }
+        BOOST_UBLAS_INLINE
+        map_hash &assign_temporary (map_hash &a) {
+            swap (a);
+            return *this;
+        }
+
+        // Swapping
+        BOOST_UBLAS_INLINE
+        void swap (map_hash &a) {
+            if (this != &a) {
+                elements_.swap (a.elements_);
+                index_.swap (a.index_);
+                std::swap (shift_, a.shift_);
+                const bool sorted = sorted_;
+                sorted_ = bool (a.sorted_);
+                a.sorted_ = sorted;
+            }
+        }
+        BOOST_UBLAS_INLINE
+        friend void swap (map_hash &a1, map_hash &a2) {
+            a1.swap (a2);
+        }
+
+        // Element insertion and deletion
+
+        // From Back Insertion Sequence concept
+        // BOOST_UBLAS_INLINE This function seems to be big. So we do not let the compiler inline it.
+        iterator push_back (iterator it, const value_type &p) {
+            order ();
+            if (size () == 0 || (it = end () - 1)->first < p.first)
+                return insert (p).first;
+            external_logic ().raise ();
+            return it;
+        }
+        // Form Unique Associative Container concept
+        // BOOST_UBLAS_INLINE This function seems to be big. So we do not let the compiler inline it.
+        std::pair<iterator,bool> insert (const value_type &p) {
+            if (2 * (size () + 1) > index_.size ())
+                rehash (2 * (size () + 1));
+            const size_type s = probe (p.first);
+            if (index_ [s] != 0)
+                return std::make_pair (elements () + index_ [s] - 1, false);
+            sorted_ = sorted_ && (elements_.empty () || elements_.back ().first < p.first);
+            elements_.push_back (p);
+            index_ [s] = size ();
+            return std::make_pair (end () - 1, true);
+        }
+        // Form Sorted Associative Container concept
+        // BOOST_UBLAS_INLINE This function seems to be big. So we do not let the compiler inline it.
+        iterator insert (iterator hint, const value_type &p) {
+            return insert (p).first;
+        }
+        // BOOST_UBLAS_INLINE This function seems to be big. So we do not let the compiler inline it.
+        void erase (iterator it) {
+            BOOST_UBLAS_CHECK (elements () <= it && it < end (), bad_index ());
+            elements_.erase (elements_.begin () + (it - elements ()));
+            reindex ();
+        }
+        // BOOST_UBLAS_INLINE This function seems to be big. So we do not let the compiler inline it.
+        void erase (iterator it1, iterator it2) {
+            if (it1 == it2) return /* nothing to erase */;
+            BOOST_UBLAS_CHECK (elements () <= it1 && it1 < it2 && it2 <= end (), bad_index ());
+            elements_.erase (elements_.begin () + (it1 - elements ()), elements_.begin () + (it2 - elements ()));
+            reindex ();
+        }
+        // BOOST_UBLAS_INLINE This function seems to be big. So we do not let the compiler inline it.
+        void clear () {
+            elements_.clear ();
+            std::fill (index_.begin (), index_.end (), size_type (0));
+            sorted_ = true;
+        }
+
+        // Element lookup
+        // BOOST_UBLAS_INLINE This function seems to be big. So we do not let the compiler inline it.
+        const_iterator find (key_type i) const {
+            if (empty ())
+                return end ();
+            // The index may be rebuilt by a concurrent sort
+            order ();
+            const size_type k = index_ [probe (i)];
+            return k == 0 ? end () : elements () + k - 1;
+        }
+        // BOOST_UBLAS_INLINE This function seems to be big. So we do not let the compiler inline it.
+        iterator find (key_type i) {
+            if (empty ())
+                return end ();
+            const size_type k = index_ [probe (i)];
+            return k == 0 ? end () : elements () + k - 1;
+        }
+        // BOOST_UBLAS_INLINE This function seems to be big. So we do not let the compiler inline it.
+        const_iterator lower_bound (key_type i) const {
+            order ();
+            return detail::lower_bound (begin (), end (), value_type (i, mapped_type (0)), detail::less_pair<value_type> ());
+        }
+        // BOOST_UBLAS_INLINE This function seems to be big. So we do not let the compiler inline it.
+        iterator lower_bound (key_type i) {
+            order ();
+            return detail::lower_bound (begin (), end (), value_type (i, mapped_type (0)), detail::less_pair<value_type> ());
+        }
+
+        BOOST_UBLAS_INLINE
+        const_iterator begin () const {
+            order ();
+            return elements ();
+        }
+        BOOST_UBLAS_INLINE
+        const_iterator cbegin () const {
+            return begin ();
+        }
+        BOOST_UBLAS_INLINE
+        const_iterator end () const {
+            return elements () + size ();
+        }
+        BOOST_UBLAS_INLINE
+        const_iterator cend () const {
+            return end ();
+        }
+
+        BOOST_UBLAS_INLINE
+        iterator begin () {
+            order ();
+            return elements ();
+        }
+        BOOST_UBLAS_INLINE
+        iterator end () {
+            return elements () + size ();
+        }
+
+        // Reverse iterators
+        typedef std::reverse_iterator<const_iterator> const_reverse_iterator;
+        typedef std::reverse_iterator<iterator> reverse_iterator;
+
+        BOOST_UBLAS_INLINE
+        const_reverse_iterator rbegin () const {
+            order ();
+            return const_reverse_iterator (end ());
+        }
+        BOOST_UBLAS_INLINE
+        const_reverse_iterator crbegin () const {
+            return rbegin ();
+        }
+        BOOST_UBLAS_INLINE
+        const_reverse_iterator rend () const {
+            return const_reverse_iterator (begin ());
+        }
+        BOOST_UBLAS_INLINE
+        const_reverse_iterator crend () const {
+            return rend ();
+        }
+
+        BOOST_UBLAS_INLINE
+        reverse_iterator rbegin () {
+            order ();
+            return reverse_iterator (end ());
+        }
+        BOOST_UBLAS_INLINE
+        reverse_iterator rend () {
+            return reverse_iterator (begin ());
+        }
+
+        // Allocator
+        allocator_type get_allocator () {
+            return elements_.get_allocator ();
+        }
+
+         // Serialization
+        template<class Archive>
+        void serialize(Archive & ar, const unsigned int /* file_version */){
+            order ();
+            serialization::collection_size_type s (size ());
+            ar & serialization::make_nvp("size",s);
+            if (Archive::is_loading::value) {
+                elements_.resize (s);
+                sorted_ = false;
+            }
+            ar & serialization::make_array(elements (), s);
+            if (Archive::is_loading::value)
+                rehash (s);
+        }
+
+    private:
+        BOOST_UBLAS_INLINE
+        pointer elements () const {
+            return elements_.empty () ? 0 : &elements_ [0];
+        }
+        // The slot of key i, or the empty slot it would take. The multiplicative
+        // hash keeps the high bits of the product, mixing in all the bits of
+        // the key: consecutive elements of a row and elements of a column a
+        // power of two apart both spread over the index
+        BOOST_UBLAS_INLINE
+        size_type probe (key_type i) const {
+            const size_type mask = index_.size () - 1;
+            size_type s = size_type ((std::size_t (i) * std::size_t (0x9E3779B97F4A7C15ull)) >> shift_);
+            while (index_ [s] != 0 && elements_ [index_ [s] - 1].first != i)
+                s = (s + 1) & mask;
+            return s;
+        }
+        // Sizes the index for capacity elements
+        void rehash (size_type capacity) {
+            size_type slots = 16;
+            std::size_t bits = 4;
+            for (; slots < 2 * capacity; slots <<= 1)
+                ++ bits;
+            index_.resize (slots);
+            shift_ = 8 * sizeof (std::size_t) - bits;
+            reindex ();
+        }
+        // Each slot holds the position of its element plus one, 0 when empty
+        void reindex () const {
+            std::fill (index_.begin (), index_.end (), size_type (0));
+            for (size_type k = 0; k < size (); ++ k)
+                index_ [probe (elements_ [k].first)] = k + 1;
+        }
+        void order () const {
+#if defined (BOOST_UBLAS_CPP_GE_2011) && ! defined (BOOST_UBLAS_NO_THREADS)
+            if (sorted_.load (std::memory_order_acquire))
+                return;
+            static std::mutex mutex;
+            std::lock_guard<std::mutex> lock (mutex);
+#endif
+            if (! sorted_) {
+                std::sort (elements_.begin (), elements_.end (), detail::less_pair<value_type> ());
+                reindex ();
+                sorted_ = true;
+            }
+        }
+        const std::vector<value_type, ALLOC> &ordered_elements () const {
+            order ();
+            return elements_;
+        }
+
+#if defined (BOOST_UBLAS_CPP_GE_2011) && ! defined (BOOST_UBLAS_NO_THREADS)
+        typedef std::atomic<bool> flag_type;
+#else
+        typedef bool flag_type;
+#endif
+        mutable std::vector<value_type, ALLOC> elements_;
+        mutable std::vector<size_type> index_;
+        std::size_t shift_;
+        mutable flag_type sorted_;
+    };
+
+
     namespace detail {
         template<class A, class T>
         struct map_traits {
@@ -549,6 +882,11 @@ namespace boost { namespace numeric { namespace ublas {
         void map_reserve (map_array<I, T, ALLOC> &m, typename map_array<I, T, ALLOC>::size_type capacity) {
             m.reserve (capacity);
         }
+        template<class I, class T, class ALLOC>
+        BOOST_UBLAS_INLINE
+        void map_reserve (map_hash<I, T, ALLOC> &m, typename map_hash<I, T, ALLOC>::size_type capacity) {
+            m.reserve (capacity);
+        }
 
         template<class M>
         struct map_capacity_traits {
@@ -566,6 +904,14 @@ namespace boost { namespace numeric { namespace ublas {
             }
         } ;
 
+        template<class I, class T, class ALLOC>
+        struct map_capacity_traits< map_hash<I, T, ALLOC> > {
+            typedef typename map_hash<I, T, ALLOC>::size_type type ;
+            type operator() ( map_hash<I, T, ALLOC> const& m ) const {
+               return m.capacity ();
+            }
+        } ;
+
         template<class M>
         BOOST_UBLAS_INLINE
         typename map_capacity_traits<M>::type map_capacity (M const& m) {
@@ -15,6 +15,10 @@
 
 #include <boost/numeric/ublas/matrix.hpp>
 #include <boost/numeric/ublas/detail/temporary.hpp>
+#include <boost/numeric/ublas/detail/dense_traits.hpp>
+#include <boost/numeric/ublas/detail/trsm.hpp>
+#include <boost/type_traits/is_base_of.hpp>
+#include <boost/type_traits/is_same.hpp>
 #include <boost/type_traits/remove_const.hpp>
 
 // Iterators based on ideas of Jeremy Siek
@@ -2537,6 +2541,59 @@ namespace boost { namespace numeric { namespace ublas {
         typedef matrix<promote_type> result_type;
     };
 
+namespace detail {
+
+    template<class E1, class E2>
+    BOOST_UBLAS_INLINE
+    bool blocked_inplace_solve (const E1 &, E2 &, bool, bool, boost::mpl::false_) {
+        return false;
+    }
+    template<class E1, class E2>
+    BOOST_UBLAS_INLINE
+    bool blocked_inplace_solve (const E1 &e1, E2 &e2, bool upper, bool unit, boost::mpl::true_) {
+        typedef typename E2::value_type value_type;
+        typedef dense_matrix_traits<E1> traits1;
+        typedef dense_matrix_traits<E2> traits2;
+
+        BOOST_UBLAS_CHECK (e1.size1 () == e1.size2 (), bad_size ());
+        BOOST_UBLAS_CHECK (e1.size2 () == e2.size1 (), bad_size ());
+        const std::size_t size = e2.size1 ();
+        const value_type *a = traits1::data (e1);
+        value_type *b = traits2::data (e2);
+        // A single block is the unblocked algorithm anyway
+        if (size <= std::size_t (BOOST_UBLAS_FACTORIZE_BLOCK) || a == b)
+            return false;
+        const std::ptrdiff_t a1 = traits1::stride1 (e1), a2 = traits1::stride2 (e1);
+        if (! unit) {
+            for (std::size_t n = 0; n < size; ++ n) {
+#ifndef BOOST_UBLAS_SINGULAR_CHECK
+                BOOST_UBLAS_CHECK (a [std::ptrdiff_t (n) * (a1 + a2)] != value_type/*zero*/(), singular ());
+#else
+                if (a [std::ptrdiff_t (n) * (a1 + a2)] == value_type/*zero*/())
+                    singular ().raise ();
+#endif
+            }
+        }
+        trsm (upper, unit, size, e2.size2 (), a, a1, a2,
+              b, traits2::stride1 (e2), traits2::stride2 (e2));
+        return true;
+    }
+
+    // Triangular solve through trsm when both sides are dense and B is a
+    // container of the same value type. Returns false, without touching e2,
+    // for anything else.
+    template<class E1, class E2>
+    BOOST_UBLAS_INLINE
+    bool blocked_inplace_solve (const E1 &e1, E2 &e2, bool upper, bool unit) {
+        typedef boost::mpl::bool_<dense_matrix_traits<E1>::value &&
+                                  dense_matrix_traits<E2>::value &&
+                                  boost::is_base_of<matrix_container<E2>, E2>::value &&
+                                  boost::is_same<typename E1::value_type, typename E2::value_type>::value> dispatch;
+        return blocked_inplace_solve (e1, e2, upper, unit, dispatch ());
+    }
+
+}
+
     // Operations:
     //  k * n * (n - 1) / 2 + k * n = k * n * (n + 1) / 2 multiplications,
     //  k * n * (n - 1) / 2 additions
@@ -2637,6 +2694,8 @@ namespace boost { namespace numeric { namespace ublas {
     void inplace_solve (const matrix_expression<E1> &e1, matrix_expression<E2> &e2,
                         lower_tag) {
         typedef typename E1::storage_category dispatch_category;
+        if (detail::blocked_inplace_solve (e1 (), e2 (), false, false))
+            return;
         inplace_solve (e1, e2,
                        lower_tag (), dispatch_category ());
     }
@@ -2645,6 +2704,8 @@ namespace boost { namespace numeric { namespace ublas {
     void inplace_solve (const matrix_expression<E1> &e1, matrix_expression<E2> &e2,
                         unit_lower_tag) {
         typedef typename E1::storage_category dispatch_category;
+        if (detail::blocked_inplace_solve (e1 (), e2 (), false, true))
+            return;
         inplace_solve (triangular_adaptor<const E1, unit_lower> (e1 ()), e2,
                        unit_lower_tag (), dispatch_category ());
     }
@@ -2747,6 +2808,8 @@ namespace boost { namespace numeric { namespace ublas {
     void inplace_solve (const matrix_expression<E1> &e1, matrix_expression<E2> &e2,
                         upper_tag) {
         typedef typename E1::storage_category dispatch_category;
+        if (detail::blocked_inplace_solve (e1 (), e2 (), true, false))
+            return;
         inplace_solve (e1, e2,
                        upper_tag (), dispatch_category ());
     }
@@ -2755,6 +2818,8 @@ namespace boost { namespace numeric { namespace ublas {
     void inplace_solve (const matrix_expression<E1> &e1, matrix_expression<E2> &e2,
                         unit_upper_tag) {
         typedef typename E1::storage_category dispatch_category;
+        if (detail::blocked_inplace_solve (e1 (), e2 (), true, true))
+            return;
         inplace_solve (triangular_adaptor<const E1, unit_upper> (e1 ()), e2,
                        unit_upper_tag (), dispatch_category ());
     }
@@ -1671,6 +1671,13 @@ namespace boost { namespace numeric { namespace ublas {
 	     }
 	 };
 
+#ifdef BOOST_UBLAS_CPP_GE_2011
+	 /// \brief A dense vector of values of type \c T whose storage starts at a multiple of \c Align bytes.
+	 /// The SIMD kernels of \c inner_prod, \c norm_2 and \c v \c += \c a \c * \c w see the alignment at compile time and use aligned loads.
+	 template<class T, std::size_t Align = BOOST_UBLAS_ALIGNED_ALLOCATOR_ALIGN>
+	 using aligned_vector = vector<T, unbounded_array<T, aligned_allocator<T, Align> > >;
+#endif
+
 
 
 	 // -----------------
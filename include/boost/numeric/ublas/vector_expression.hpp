@@ -1036,6 +1036,16 @@ namespace boost { namespace numeric { namespace ublas {
             return e2_.size ();
         }
 
+        // Expression accessors
+        BOOST_UBLAS_INLINE
+        const expression1_closure_type &expression1 () const {
+            return e1_;
+        }
+        BOOST_UBLAS_INLINE
+        const expression2_closure_type &expression2 () const {
+            return e2_;
+        }
+
     public:
         // Element access
         BOOST_UBLAS_INLINE
@@ -1279,6 +1289,16 @@ namespace boost { namespace numeric { namespace ublas {
             return e1_.size (); 
         }
 
+        // Expression accessors
+        BOOST_UBLAS_INLINE
+        const expression1_closure_type &expression1 () const {
+            return e1_;
+        }
+        BOOST_UBLAS_INLINE
+        const expression2_closure_type &expression2 () const {
+            return e2_;
+        }
+
     public:
         // Element access
         BOOST_UBLAS_INLINE
@@ -40,6 +40,7 @@
 
 #include <boost/numeric/ublas/storage_sparse.hpp>
 #include <boost/numeric/ublas/vector_expression.hpp>
+#include <boost/numeric/ublas/detail/triplet_sort.hpp>
 #include <boost/numeric/ublas/detail/vector_assign.hpp>
 #if BOOST_UBLAS_TYPE_CHECK
 #include <boost/numeric/ublas/vector.hpp>
@@ -572,6 +573,25 @@ namespace boost { namespace numeric { namespace ublas {
             v1.swap (v2);
         }
 
+        // Conversion
+        /** \brief Stores the elements into the compressed vector \c v, resized
+         * to the size of this vector, in one pass over them in index order.
+         *
+         * Typically the last step of an assembly, accumulated in a \c map_hash
+         * storage, before products with the compressed vector.
+         */
+        template<std::size_t IB, class IA, class TA>
+        void freeze (compressed_vector<T, IB, IA, TA> &v) const {
+            v.resize (size_, false);
+            v.reserve (nnz (), false);
+            typename IA::size_type k = 0;
+            for (const_subiterator_type it = data ().begin (); it != data ().end (); ++ it, ++ k) {
+                v.index_data () [k] = typename IA::value_type (it->first + IB);
+                v.value_data () [k] = it->second;
+            }
+            v.set_filled (k);
+        }
+
         // Iterator types
     private:
         // Use storage iterator
@@ -1643,7 +1663,7 @@ namespace boost { namespace numeric { namespace ublas {
             if (preserve) {
                 index_data_. resize (capacity_, size_type ());
                 value_data_. resize (capacity_, value_type ());
-                filled_ = (std::min) (capacity_, filled_);
+                filled_ = (std::min) (capacity_, size_type (filled_));
                 }
             else {
                 index_data_. resize (capacity_);
@@ -1904,17 +1924,14 @@ namespace boost { namespace numeric { namespace ublas {
         BOOST_UBLAS_INLINE
         void sort () const {
             if (! sorted_ && filled_ > 0) {
-                typedef index_pair_array<index_array_type, value_array_type> array_pair;
-                array_pair ipa (filled_, index_data_, value_data_);
 #ifndef BOOST_UBLAS_COO_ALWAYS_DO_FULL_SORT
-                const typename array_pair::iterator iunsorted = ipa.begin () + sorted_filled_;
-                // sort new elements and merge
-                std::sort (iunsorted, ipa.end ());
-                inplace_merge(0, sorted_filled_, filled_);
+                const size_type sorted = sorted_filled_;
 #else
-                const typename array_pair::iterator iunsorted = ipa.begin ();
-                std::sort (iunsorted, ipa.end ());
+                const size_type sorted = 0;
 #endif
+                // radix sort new elements and merge
+                detail::coordinate_sort (static_cast<typename IA::value_type *> (0), &index_data_ [0], &value_data_ [0], sorted, filled_,
+                                         1, size_, IB);
 
                 // sum duplicates with += and remove
                 size_type filled = 0;
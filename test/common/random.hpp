@@ -0,0 +1,42 @@
+// Copyright (c) 2017 uBLAS developers
+// Distributed under the Boost Software License, Version 1.0. (See
+// accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+
+// A small reproducible generator for the tests, so that every run sees the
+// same operands whatever the platform's rand ()
+
+#ifndef _HPP_RANDOM_
+#define _HPP_RANDOM_
+
+#include <complex>
+#include <cstddef>
+
+#include <boost/numeric/ublas/vector.hpp>
+
+// Uniform in [-1, 1] on a grid of 1/1000
+inline
+double random_value (unsigned &seed) {
+    seed = seed * 1103515245u + 12345u;
+    return double ((seed >> 8) % 2001) / 1000.0 - 1.0;
+}
+
+template<class T>
+void assign_random (T &t, unsigned &seed) {
+    t = T (random_value (seed));
+}
+template<class T>
+void assign_random (std::complex<T> &t, unsigned &seed) {
+    const double re = random_value (seed);
+    t = std::complex<T> (T (re), T (random_value (seed)));
+}
+
+template<class T>
+boost::numeric::ublas::vector<T> make_vector (std::size_t size, unsigned seed) {
+    boost::numeric::ublas::vector<T> v (size);
+    for (std::size_t i = 0; i < size; ++ i)
+        assign_random (v (i), seed);
+    return v;
+}
+
+#endif
@@ -173,6 +173,30 @@ void test_vector () {
 #endif
 #endif
 
+#ifdef USE_MAP_HASH
+#ifdef USE_FLOAT
+    std::cout << "float, map_hash" << std::endl;
+    test_my_vector<ublas::mapped_vector<float, ublas::map_hash<std::size_t, float> >, 3 > () ();
+#endif
+
+#ifdef USE_DOUBLE
+    std::cout << "double, map_hash" << std::endl;
+    test_my_vector<ublas::mapped_vector<double, ublas::map_hash<std::size_t, double> >, 3 > () ();
+#endif
+
+#ifdef USE_STD_COMPLEX
+#ifdef USE_FLOAT
+    std::cout << "std::complex<float>, map_hash" << std::endl;
+    test_my_vector<ublas::mapped_vector<std::complex<float>, ublas::map_hash<std::size_t, std::complex<float> > >, 3 > () ();
+#endif
+
+#ifdef USE_DOUBLE
+    std::cout << "std::complex<double>, map_hash" << std::endl;
+    test_my_vector<ublas::mapped_vector<std::complex<double>, ublas::map_hash<std::size_t, std::complex<double> > >, 3 > () ();
+#endif
+#endif
+#endif
+
 #ifdef USE_STD_MAP
 #ifdef USE_FLOAT
     std::cout << "float, std::map" << std::endl;
@@ -164,6 +164,30 @@ void test_matrix () {
 #endif
 #endif
 
+#ifdef USE_MAP_HASH
+#ifdef USE_FLOAT
+    std::cout << "float, mapped_matrix map_hash" << std::endl;
+    test_my_matrix<ublas::mapped_matrix<float, ublas::row_major, ublas::map_hash<std::size_t, float> >, 3 > () ();
+#endif
+
+#ifdef USE_DOUBLE
+    std::cout << "double, mapped_matrix map_hash" << std::endl;
+    test_my_matrix<ublas::mapped_matrix<double, ublas::row_major, ublas::map_hash<std::size_t, double> >, 3 > () ();
+#endif
+
+#ifdef USE_STD_COMPLEX
+#ifdef USE_FLOAT
+    std::cout << "std::complex<float>, mapped_matrix map_hash" << std::endl;
+    test_my_matrix<ublas::mapped_matrix<std::complex<float>, ublas::row_major, ublas::map_hash<std::size_t, std::complex<float> > >, 3 > () ();
+#endif
+
+#ifdef USE_DOUBLE
+    std::cout << "std::complex<double>, mapped_matrix map_hash" << std::endl;
+    test_my_matrix<ublas::mapped_matrix<std::complex<double>, ublas::row_major, ublas::map_hash<std::size_t, std::complex<double> > >, 3 > () ();
+#endif
+#endif
+#endif
+
 #ifdef USE_STD_MAP
 #ifdef USE_FLOAT
     std::cout << "float, mapped_matrix std::map" << std::endl;
@@ -268,6 +292,34 @@ void test_matrix () {
 #endif
 #endif
 
+#ifdef USE_MAP_HASH
+#ifdef USE_FLOAT
+    std::cout << "float,generalized_vector_of_vector map_hash" << std::endl;
+    test_my_matrix<ublas::generalized_vector_of_vector<float, ublas::row_major, ublas::vector<ublas::mapped_vector<float, ublas::map_hash<std::size_t, float> > > >, 3 > () ();
+    test_my_matrix<ublas::generalized_vector_of_vector<float, ublas::row_major, ublas::mapped_vector<ublas::mapped_vector<float, ublas::map_hash<std::size_t, float> >, ublas::map_hash<std::size_t, ublas::mapped_vector<float, ublas::map_hash<std::size_t, float> > > > >, 3 > () ();
+#endif
+
+#ifdef USE_DOUBLE
+    std::cout << "double, generalized_vector_of_vector map_hash" << std::endl;
+    test_my_matrix<ublas::generalized_vector_of_vector<double, ublas::row_major, ublas::vector<ublas::mapped_vector<double, ublas::map_hash<std::size_t, double> > > >, 3 > () ();
+    test_my_matrix<ublas::generalized_vector_of_vector<double, ublas::row_major, ublas::mapped_vector<ublas::mapped_vector<double, ublas::map_hash<std::size_t, double> >, ublas::map_hash<std::size_t, ublas::mapped_vector<double, ublas::map_hash<std::size_t, double> > > > >, 3 > () ();
+#endif
+
+#ifdef USE_STD_COMPLEX
+#ifdef USE_FLOAT
+    std::cout << "std::complex<float>, generalized_vector_of_vector map_hash" << std::endl;
+    test_my_matrix<ublas::generalized_vector_of_vector<std::complex<float>, ublas::row_major, ublas::vector<ublas::mapped_vector<std::complex<float>, ublas::map_hash<std::size_t, std::complex<float> > > > >, 3 > () ();
+    test_my_matrix<ublas::generalized_vector_of_vector<std::complex<float>, ublas::row_major, ublas::mapped_vector<ublas::mapped_vector<std::complex<float>, ublas::map_hash<std::size_t, std::complex<float> > >, ublas::map_hash<std::size_t, ublas::mapped_vector<std::complex<float>, ublas::map_hash<std::size_t, std::complex<float> > > > > >, 3 > () ();
+#endif
+
+#ifdef USE_DOUBLE
+    std::cout << "std::complex<double>, generalized_vector_of_vector map_hash" << std::endl;
+    test_my_matrix<ublas::generalized_vector_of_vector<std::complex<double>, ublas::row_major, ublas::vector<ublas::mapped_vector<std::complex<double>, ublas::map_hash<std::size_t, std::complex<double> > > > >, 3 > () ();
+    test_my_matrix<ublas::generalized_vector_of_vector<std::complex<double>, ublas::row_major, ublas::mapped_vector<ublas::mapped_vector<std::complex<double>, ublas::map_hash<std::size_t, std::complex<double> > >, ublas::map_hash<std::size_t, ublas::mapped_vector<std::complex<double>, ublas::map_hash<std::size_t, std::complex<double> > > > > >, 3 > () ();
+#endif
+#endif
+#endif
+
 #ifdef USE_STD_MAP
 #ifdef USE_FLOAT
     std::cout << "float, generalized_vector_of_vector std::map" << std::endl;
@@ -0,0 +1,165 @@
+// Copyright (c) 2017 uBLAS developers
+// Distributed under the Boost Software License, Version 1.0. (See
+// accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+
+#include <complex>
+#include <iostream>
+#include <vector>
+
+#include <boost/numeric/ublas/matrix.hpp>
+#include <boost/numeric/ublas/matrix_proxy.hpp>
+#include <boost/numeric/ublas/vector.hpp>
+
+#include "utils.hpp"
+
+namespace ublas = boost::numeric::ublas;
+namespace detail = boost::numeric::ublas::detail;
+
+static const detail::simd_isa isas [] = { detail::simd_none, detail::simd_sse2, detail::simd_avx2, detail::simd_avx512 };
+
+template<class T>
+bool aligned_to (const T *p, std::size_t alignment) {
+    return reinterpret_cast<std::size_t> (p) % alignment == 0;
+}
+
+BOOST_UBLAS_TEST_DEF ( test_aligned_allocator_blocks )
+{
+    ublas::aligned_allocator<double> a;
+    ublas::aligned_allocator<char, 256> c;
+    bool aligned = true;
+    for (std::size_t n = 1; n < 100; ++ n) {
+        double *p = a.allocate (n);
+        char *q = c.allocate (n);
+        aligned = aligned && aligned_to (p, 64) && aligned_to (q, 256);
+        // The whole block is writable
+        for (std::size_t i = 0; i < n; ++ i) {
+            p [i] = double (i);
+            q [i] = char (i);
+        }
+        a.deallocate (p, n);
+        c.deallocate (q, n);
+    }
+    BOOST_UBLAS_TEST_CHECK (aligned);
+    BOOST_UBLAS_TEST_CHECK (a == c);
+
+    // Rebound to the elements of standard containers
+    std::vector<float, ublas::aligned_allocator<float> > v (37, 1.0f);
+    v.resize (1000, 2.0f);
+    BOOST_UBLAS_TEST_CHECK (aligned_to (&v [0], 64));
+    BOOST_UBLAS_TEST_CHECK (v [36] == 1.0f && v [999] == 2.0f);
+}
+
+BOOST_UBLAS_TEST_DEF ( test_aligned_allocator_containers )
+{
+    ublas::aligned_vector<double> v (13, 1.0);
+    ublas::aligned_matrix<double> m (7, 5, 2.0);
+    ublas::aligned_matrix<float, ublas::column_major, 128> c (3, 3, 0.0f);
+    BOOST_UBLAS_TEST_CHECK (aligned_to (&v (0), 64));
+    BOOST_UBLAS_TEST_CHECK (aligned_to (&m (0, 0), 64));
+    BOOST_UBLAS_TEST_CHECK (aligned_to (&c (0, 0), 128));
+    v.resize (1000);
+    m.resize (100, 100, true);
+    BOOST_UBLAS_TEST_CHECK (aligned_to (&v (0), 64) && v (12) == 1.0);
+    BOOST_UBLAS_TEST_CHECK (aligned_to (&m (0, 0), 64) && m (6, 4) == 2.0);
+
+    // The alignment the kernels see at compile time
+    BOOST_UBLAS_TEST_CHECK ((detail::dense_vector_traits<ublas::aligned_vector<double> >::alignment == 64));
+    BOOST_UBLAS_TEST_CHECK ((detail::dense_matrix_traits<ublas::aligned_matrix<float, ublas::column_major, 128> >::alignment == 128));
+    BOOST_UBLAS_TEST_CHECK ((detail::dense_matrix_traits<ublas::matrix_reference<const ublas::aligned_matrix<double> > >::alignment == 64));
+    BOOST_UBLAS_TEST_CHECK ((detail::dense_vector_traits<ublas::vector<double> >::alignment < detail::simd_alignment));
+    BOOST_UBLAS_TEST_CHECK ((detail::dense_matrix_traits<ublas::matrix_range<ublas::aligned_matrix<double> > >::alignment < detail::simd_alignment));
+}
+
+template<class T>
+void fill (T &t, std::size_t seed) {
+    t = T (double ((seed * 7) % 11) - 5.0) / T (4);
+}
+template<class T>
+void fill (std::complex<T> &t, std::size_t seed) {
+    t = std::complex<T> (T ((seed * 7) % 11) - T (5), T ((seed * 3) % 13) - T (6)) / T (4);
+}
+
+template<class T>
+bool close (const T &x, const T &y) {
+    return std::abs (x - y) <= 1.0e-3 * (1 + std::abs (y));
+}
+template<class V>
+bool close_vector (const V &x, const V &y) {
+    bool result = x.size () == y.size ();
+    for (std::size_t i = 0; result && i < x.size (); ++ i)
+        result = close (x (i), y (i));
+    return result;
+}
+
+// The products of aligned containers, whose kernels take aligned loads where
+// rows are whole multiples of the alignment and unaligned ones elsewhere,
+// equal those of ordinary containers
+template<class T>
+bool check_products (std::size_t size1, std::size_t size2) {
+    ublas::aligned_vector<T> x (size2), y (size2), ay (size2);
+    ublas::aligned_vector<T> z (size1);
+    ublas::aligned_matrix<T> a (size1, size2);
+    ublas::aligned_matrix<T, ublas::column_major> b (size2, size1);
+    for (std::size_t j = 0; j < size2; ++ j) {
+        fill (x (j), j);
+        fill (y (j), j + 1);
+    }
+    for (std::size_t i = 0; i < size1; ++ i) {
+        fill (z (i), i + 2);
+        for (std::size_t j = 0; j < size2; ++ j) {
+            fill (a (i, j), i * 5 + j * 3);
+            fill (b (j, i), i * 3 + j * 5);
+        }
+    }
+    const ublas::vector<T> ux (x), uy (y), uz (z);
+    const ublas::matrix<T> ua (a);
+    const ublas::matrix<T, ublas::column_major> ub (b);
+    T alpha;
+    fill (alpha, 9);
+
+    ay = y;
+    ublas::noalias (ay) += alpha * static_cast<const ublas::vector_expression<ublas::aligned_vector<T> > &> (x);
+    ublas::vector<T> uay (uy);
+    ublas::noalias (uay) += alpha * static_cast<const ublas::vector_expression<ublas::vector<T> > &> (ux);
+    return close (ublas::inner_prod (x, y), ublas::inner_prod (ux, uy)) &&
+           close (ublas::norm_2 (x), ublas::norm_2 (ux)) &&
+           close_vector (ublas::vector<T> (ay), uay) &&
+           close_vector (ublas::vector<T> (ublas::prod (a, x)), ublas::vector<T> (ublas::prod (ua, ux))) &&
+           close_vector (ublas::vector<T> (ublas::prod (z, a)), ublas::vector<T> (ublas::prod (uz, ua))) &&
+           close_vector (ublas::vector<T> (ublas::prod (x, b)), ublas::vector<T> (ublas::prod (ux, ub))) &&
+           close (ublas::prod (a, b) (size1 - 1, size1 - 1), ublas::prod (ua, ub) (size1 - 1, size1 - 1));
+}
+
+template<class T>
+bool check_isas () {
+    const detail::simd_isa active = detail::simd_active_isa ();
+    bool result = true;
+    for (std::size_t k = 0; k < sizeof (isas) / sizeof (isas [0]); ++ k) {
+        if (detail::simd_select_isa (isas [k]) != isas [k])
+            continue;
+        // Rows of 112 elements are whole cache lines for every value type,
+        // rows of 103 elements only the first one
+        result = result && check_products<T> (37, 112) && check_products<T> (37, 103) && check_products<T> (3, 5);
+    }
+    detail::simd_select_isa (active);
+    return result;
+}
+
+BOOST_UBLAS_TEST_DEF ( test_aligned_allocator_products )
+{
+    BOOST_UBLAS_TEST_CHECK (check_isas<float> ());
+    BOOST_UBLAS_TEST_CHECK (check_isas<double> ());
+    BOOST_UBLAS_TEST_CHECK (check_isas<std::complex<float> > ());
+    BOOST_UBLAS_TEST_CHECK (check_isas<std::complex<double> > ());
+}
+
+int main () {
+    BOOST_UBLAS_TEST_BEGIN();
+
+    BOOST_UBLAS_TEST_DO( test_aligned_allocator_blocks );
+    BOOST_UBLAS_TEST_DO( test_aligned_allocator_containers );
+    BOOST_UBLAS_TEST_DO( test_aligned_allocator_products );
+
+    BOOST_UBLAS_TEST_END();
+}
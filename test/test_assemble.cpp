@@ -0,0 +1,162 @@
+// Copyright (c) 2017 uBLAS developers
+// Distributed under the Boost Software License, Version 1.0. (See
+// accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+
+// A small pool and a low threshold so that the assembly splits its triplets
+// across threads
+#define BOOST_UBLAS_THREADS 4
+#define BOOST_UBLAS_SPARSE_PARALLEL_NNZ 64
+
+#include <complex>
+#include <vector>
+
+#include <boost/numeric/ublas/matrix.hpp>
+#include <boost/numeric/ublas/matrix_sparse.hpp>
+
+#include "utils.hpp"
+
+namespace ublas = boost::numeric::ublas;
+
+typedef std::complex<double> complex_type;
+
+// Unordered triplets, with duplicates and a few long rows
+template<class T>
+struct triplets {
+    std::vector<std::size_t> rows, columns;
+    std::vector<T> values;
+
+    triplets (std::size_t size1, std::size_t size2, std::size_t n) {
+        unsigned seed = unsigned (n);
+        for (std::size_t k = 0; k < n; ++ k) {
+            seed = seed * 1103515245u + 12345u;
+            const std::size_t i = k % 11 == 0 ? (seed >> 4) % 3 : (seed >> 8) % size1;
+            seed = seed * 1103515245u + 12345u;
+            rows.push_back (i);
+            columns.push_back ((seed >> 8) % size2);
+            values.push_back (T (double (k % 7) - 3.0));
+        }
+    }
+};
+
+// The stored elements are sorted and distinct
+template<class M>
+bool well_formed (const M &m) {
+    bool result = m.filled1 () == m.index1_data ().size () &&
+                  m.index1_data () [0] == M::index_base () &&
+                  m.index1_data () [m.filled1 () - 1] == m.nnz () + M::index_base ();
+    for (std::size_t k = 0; k + 1 < m.filled1 (); ++ k)
+        for (std::size_t p = m.index1_data () [k] + 1; p < m.index1_data () [k + 1]; ++ p)
+            result = result && m.index2_data () [p - 1 - M::index_base ()] < m.index2_data () [p - M::index_base ()];
+    return result;
+}
+
+// assemble against the sums of the triplets into a dense matrix
+template<class M>
+bool check_assemble (std::size_t size1, std::size_t size2, std::size_t n) {
+    typedef typename M::value_type value_type;
+    const triplets<value_type> t (size1, size2, n);
+    ublas::matrix<value_type> d (size1, size2, value_type ());
+    for (std::size_t k = 0; k < n; ++ k)
+        d (t.rows [k], t.columns [k]) += t.values [k];
+
+    M m (size1, size2);
+    m.assemble (t.rows.begin (), t.rows.end (), t.columns.begin (), t.values.begin ());
+    bool result = well_formed (m) && ublas::norm_inf (ublas::matrix<value_type> (m) - d) == 0.0;
+
+    // The same elements as through a coordinate matrix, explicit zeros included
+    ublas::coordinate_matrix<value_type> c (size1, size2);
+    for (std::size_t k = 0; k < n; ++ k)
+        c.append_element (t.rows [k], t.columns [k], t.values [k]);
+    c.sort ();
+    result = result && m.nnz () == c.nnz ();
+    return result;
+}
+
+BOOST_UBLAS_TEST_DEF ( test_assemble_triplets )
+{
+    BOOST_UBLAS_TEST_CHECK ((check_assemble<ublas::compressed_matrix<double> > (300, 200, 5000)));
+    BOOST_UBLAS_TEST_CHECK ((check_assemble<ublas::compressed_matrix<double, ublas::column_major> > (300, 200, 5000)));
+    BOOST_UBLAS_TEST_CHECK ((check_assemble<ublas::compressed_matrix<double, ublas::row_major, 1> > (90, 120, 2000)));
+    BOOST_UBLAS_TEST_CHECK ((check_assemble<ublas::compressed_matrix<complex_type> > (50, 70, 700)));
+    BOOST_UBLAS_TEST_CHECK ((check_assemble<ublas::compressed_matrix<float> > (1000, 3, 100)));
+    BOOST_UBLAS_TEST_CHECK ((check_assemble<ublas::compressed_matrix<double> > (7, 5, 10)));
+    // More triplets than elements
+    BOOST_UBLAS_TEST_CHECK ((check_assemble<ublas::compressed_matrix<double> > (3, 4, 5000)));
+    BOOST_UBLAS_TEST_CHECK ((check_assemble<ublas::compressed_matrix<double, ublas::column_major, 1> > (3, 2, 100)));
+}
+
+// Many duplicates of few elements, more than the matrix holds
+BOOST_UBLAS_TEST_DEF ( test_assemble_duplicates )
+{
+    std::vector<std::size_t> rows, columns;
+    std::vector<double> values;
+    for (std::size_t k = 0; k < 40; ++ k) {
+        rows.push_back (k % 3 == 0 ? 1 : 0);
+        columns.push_back (k % 2);
+        values.push_back (1.0);
+    }
+    ublas::compressed_matrix<double> m (2, 2);
+    m.assemble (rows.begin (), rows.end (), columns.begin (), values.begin ());
+    BOOST_UBLAS_TEST_CHECK (well_formed (m));
+    BOOST_UBLAS_TEST_CHECK_EQ (m.nnz (), std::size_t (4));
+    BOOST_UBLAS_TEST_CHECK (m.nnz_capacity () <= std::size_t (4));
+    BOOST_UBLAS_TEST_CHECK_EQ (m (0, 0), 13.0);
+    BOOST_UBLAS_TEST_CHECK_EQ (m (0, 1), 13.0);
+    BOOST_UBLAS_TEST_CHECK_EQ (m (1, 0), 7.0);
+    BOOST_UBLAS_TEST_CHECK_EQ (m (1, 1), 7.0);
+}
+
+// Raw arrays, replacement of the previous elements and sums to zero
+BOOST_UBLAS_TEST_DEF ( test_assemble_replace )
+{
+    const std::size_t rows [] = { 2, 0, 2, 1, 0, 2 };
+    const int columns [] = { 1, 3, 0, 2, 3, 1 };
+    const double values [] = { 1.0, 2.0, 3.0, 4.0, -2.0, 5.0 };
+    ublas::compressed_matrix<double> m (3, 4);
+    m (0, 0) = 9.0;
+    m.assemble (rows, rows + 6, columns, values);
+    BOOST_UBLAS_TEST_CHECK (well_formed (m));
+    BOOST_UBLAS_TEST_CHECK_EQ (m.nnz (), std::size_t (4));
+    BOOST_UBLAS_TEST_CHECK_EQ (m (0, 0), 0.0);
+    BOOST_UBLAS_TEST_CHECK_EQ (m (0, 3), 0.0);
+    BOOST_UBLAS_TEST_CHECK (m.find_element (0, 3) != 0);
+    BOOST_UBLAS_TEST_CHECK_EQ (m (1, 2), 4.0);
+    BOOST_UBLAS_TEST_CHECK_EQ (m (2, 0), 3.0);
+    BOOST_UBLAS_TEST_CHECK_EQ (m (2, 1), 6.0);
+
+    // The matrix stays usable as any other
+    m (1, 0) = 7.0;
+    m.push_back (2, 3, 8.0);
+    BOOST_UBLAS_TEST_CHECK (well_formed (m));
+    BOOST_UBLAS_TEST_CHECK_EQ (m.nnz (), std::size_t (6));
+    BOOST_UBLAS_TEST_CHECK_EQ (m (1, 0), 7.0);
+    BOOST_UBLAS_TEST_CHECK_EQ (m (2, 3), 8.0);
+}
+
+// No triplets, and empty matrices
+BOOST_UBLAS_TEST_DEF ( test_assemble_empty )
+{
+    const std::size_t none [] = { 0 };
+    const double no_values [] = { 0.0 };
+    ublas::compressed_matrix<double> m (20, 10), e;
+    m (3, 4) = 1.0;
+    m.assemble (none, none, none, no_values);
+    BOOST_UBLAS_TEST_CHECK (well_formed (m));
+    BOOST_UBLAS_TEST_CHECK_EQ (m.nnz (), std::size_t (0));
+    BOOST_UBLAS_TEST_CHECK_EQ (m.size1 (), std::size_t (20));
+    e.assemble (none, none, none, no_values);
+    BOOST_UBLAS_TEST_CHECK (well_formed (e));
+    BOOST_UBLAS_TEST_CHECK_EQ (e.nnz (), std::size_t (0));
+}
+
+int main () {
+    BOOST_UBLAS_TEST_BEGIN();
+
+    BOOST_UBLAS_TEST_DO( test_assemble_triplets );
+    BOOST_UBLAS_TEST_DO( test_assemble_duplicates );
+    BOOST_UBLAS_TEST_DO( test_assemble_replace );
+    BOOST_UBLAS_TEST_DO( test_assemble_empty );
+
+    BOOST_UBLAS_TEST_END();
+}
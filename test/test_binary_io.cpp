@@ -0,0 +1,204 @@
+// Copyright (c) 2017 uBLAS developers
+// Distributed under the Boost Software License, Version 1.0. (See
+// accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+
+// Mismatched files raise bad_argument
+#undef BOOST_UBLAS_NO_EXCEPTIONS
+#define BOOST_UBLAS_SHALLOW_ARRAY_ADAPTOR
+
+#include <complex>
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+
+#include <boost/numeric/ublas/binary_io.hpp>
+
+#include "utils.hpp"
+
+namespace ublas = boost::numeric::ublas;
+
+static const char *path = "test_binary_io.bin";
+
+template<class M>
+void fill (M &m, std::size_t n) {
+    for (std::size_t k = 0; k < n; ++ k)
+        m ((k * 7) % m.size1 (), (k * 13 + k / 5) % m.size2 ()) = typename M::value_type (double (k % 11) - 5.0);
+}
+
+template<class M>
+void save (const M &m) {
+    std::ofstream os (path, std::ios_base::binary);
+    ublas::save_binary (os, m);
+}
+
+template<class M1, class M2>
+bool same (const M1 &a, const M2 &b) {
+    bool result = a.size1 () == b.size1 () && a.size2 () == b.size2 ();
+    for (std::size_t i = 0; result && i < a.size1 (); ++ i)
+        for (std::size_t j = 0; result && j < a.size2 (); ++ j)
+            result = a (i, j) == b (i, j);
+    return result;
+}
+
+// Streams and mappings of dense matrices, with the layout and value type of
+// the matrix
+template<class T, class L>
+bool check_dense (std::size_t size1, std::size_t size2) {
+    ublas::matrix<T, L> m (size1, size2, T ());
+    fill (m, size1 * size2 / 2);
+    std::stringstream s;
+    ublas::save_binary (s, m);
+    ublas::matrix<T, L> r (1, 1);
+    ublas::load_binary (s, r);
+    bool result = s && same (m, r);
+
+    save (m);
+    {
+        ublas::mapped_binary_file f (path);
+        result = result && f.is_dense () && ! f.is_compressed () && f.nnz () == size1 * size2;
+        ublas::matrix<T, L, ublas::shallow_array_adaptor<T> > v (f.dense_view<T, L> ());
+        result = result && same (m, v);
+        // Writes stay in the process's copy
+        if (size1 > 0 && size2 > 0)
+            v (0, 0) = T (42.0);
+        result = result && (size1 == 0 || size2 == 0 || f.dense_view<T, L> () (0, 0) == T (42.0));
+    }
+    ublas::mapped_binary_file g (path);
+    result = result && same (m, g.dense_view<T, L> ());
+    return result;
+}
+
+BOOST_UBLAS_TEST_DEF ( test_binary_io_dense )
+{
+    BOOST_UBLAS_TEST_CHECK ((check_dense<double, ublas::row_major> (37, 23)));
+    BOOST_UBLAS_TEST_CHECK ((check_dense<double, ublas::column_major> (37, 23)));
+    BOOST_UBLAS_TEST_CHECK ((check_dense<float, ublas::row_major> (5, 3)));
+    BOOST_UBLAS_TEST_CHECK ((check_dense<std::complex<double>, ublas::column_major> (9, 17)));
+    BOOST_UBLAS_TEST_CHECK ((check_dense<int, ublas::row_major> (4, 4)));
+    BOOST_UBLAS_TEST_CHECK ((check_dense<double, ublas::row_major> (0, 5)));
+}
+
+// Streams and mappings of compressed matrices, including ones whose last
+// majors are empty
+template<class T, class L, std::size_t IB>
+bool check_compressed (std::size_t size1, std::size_t size2, std::size_t n) {
+    typedef ublas::compressed_matrix<T, L, IB> matrix_type;
+    matrix_type m (size1, size2);
+    fill (m, n);
+    std::stringstream s;
+    ublas::save_binary (s, m);
+    matrix_type r (2, 2);
+    r (1, 1) = T (1.0);
+    ublas::load_binary (s, r);
+    bool result = s && r.nnz () == m.nnz () && same (m, r);
+    result = result && std::equal (m.value_data ().begin (), m.value_data ().begin () + m.nnz (), r.value_data ().begin ());
+    // The loaded matrix accepts new elements
+    if (size1 > 0 && size2 > 0) {
+        m (size1 - 1, size2 - 1) = T (3.0);
+        r (size1 - 1, size2 - 1) = T (3.0);
+        result = result && same (m, r);
+    }
+
+    save (m);
+    ublas::mapped_compressed_matrix<T, L, IB> v (path);
+    result = result && v.file ().is_compressed () && v.nnz () == m.nnz () && same (m, v);
+    result = result && v.index1_data ().size () == L::size_M (size1, size2) + 1;
+    return result;
+}
+
+BOOST_UBLAS_TEST_DEF ( test_binary_io_compressed )
+{
+    BOOST_UBLAS_TEST_CHECK ((check_compressed<double, ublas::row_major, 0> (60, 45, 300)));
+    BOOST_UBLAS_TEST_CHECK ((check_compressed<double, ublas::column_major, 0> (60, 45, 300)));
+    BOOST_UBLAS_TEST_CHECK ((check_compressed<double, ublas::row_major, 1> (30, 80, 100)));
+    BOOST_UBLAS_TEST_CHECK ((check_compressed<std::complex<double>, ublas::row_major, 0> (20, 20, 50)));
+    // Only the first rows filled
+    BOOST_UBLAS_TEST_CHECK ((check_compressed<double, ublas::row_major, 0> (100, 3, 3)));
+    BOOST_UBLAS_TEST_CHECK ((check_compressed<double, ublas::row_major, 0> (10, 10, 0)));
+}
+
+// Mismatches set the failbit of the stream, or raise bad_argument on mapping
+BOOST_UBLAS_TEST_DEF ( test_binary_io_mismatch )
+{
+    ublas::matrix<double> m (3, 4, 1.0);
+    std::stringstream s;
+    ublas::save_binary (s, m);
+    ublas::matrix<float> f;
+    ublas::load_binary (s, f);
+    BOOST_UBLAS_TEST_CHECK (s.fail ());
+
+    s.clear ();
+    s.seekg (0);
+    ublas::matrix<double, ublas::column_major> c;
+    ublas::load_binary (s, c);
+    BOOST_UBLAS_TEST_CHECK (s.fail ());
+
+    s.clear ();
+    s.seekg (0);
+    ublas::compressed_matrix<double> r;
+    ublas::load_binary (s, r);
+    BOOST_UBLAS_TEST_CHECK (s.fail ());
+
+    std::istringstream t ("[3,4]((1,1,1,1),(1,1,1,1),(1,1,1,1))");
+    ublas::matrix<double> d;
+    ublas::load_binary (t, d);
+    BOOST_UBLAS_TEST_CHECK (t.fail ());
+
+    // A truncated file
+    std::string bytes (s.str ());
+    {
+        std::ofstream os (path, std::ios_base::binary);
+        os.write (bytes.data (), std::streamsize (bytes.size () / 2));
+    }
+    bool raised = false;
+    try {
+        ublas::mapped_binary_file file (path);
+    } catch (const ublas::bad_argument &) {
+        raised = true;
+    }
+    BOOST_UBLAS_TEST_CHECK (raised);
+
+    // A compressed matrix whose values end at byte 200, with and without
+    // the padding after them, cut inside its values, and an empty file
+    ublas::compressed_matrix<double> e (2, 2);
+    e (1, 0) = 3.0;
+    std::ostringstream o;
+    ublas::save_binary (o, e);
+    bytes = o.str ();
+    const std::size_t lengths [] = { 256, 200, 199, 193, 0 };
+    for (std::size_t k = 0; k < sizeof (lengths) / sizeof (lengths [0]); ++ k) {
+        {
+            std::ofstream os (path, std::ios_base::binary);
+            os.write (bytes.data (), std::streamsize (lengths [k]));
+        }
+        bool opened = false;
+        try {
+            ublas::mapped_compressed_matrix<double> v (path);
+            opened = v (1, 0) == 3.0;
+        } catch (const ublas::bad_argument &) {
+        }
+        BOOST_UBLAS_TEST_CHECK (opened == (lengths [k] >= 200));
+    }
+
+    save (m);
+    raised = false;
+    try {
+        ublas::mapped_compressed_matrix<double> v (path);
+    } catch (const ublas::bad_argument &) {
+        raised = true;
+    }
+    BOOST_UBLAS_TEST_CHECK (raised);
+}
+
+int main () {
+    BOOST_UBLAS_TEST_BEGIN();
+
+    BOOST_UBLAS_TEST_DO( test_binary_io_dense );
+    BOOST_UBLAS_TEST_DO( test_binary_io_compressed );
+    BOOST_UBLAS_TEST_DO( test_binary_io_mismatch );
+
+    std::remove (path);
+
+    BOOST_UBLAS_TEST_END();
+}
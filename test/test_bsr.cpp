@@ -0,0 +1,232 @@
+// Copyright (c) 2017 uBLAS developers
+// Distributed under the Boost Software License, Version 1.0. (See
+// accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+
+// A small pool and a low threshold so that the products split their block
+// rows across threads
+#define BOOST_UBLAS_THREADS 4
+#define BOOST_UBLAS_SPARSE_PARALLEL_NNZ 64
+
+#include <complex>
+#include <vector>
+
+#include <boost/numeric/ublas/matrix.hpp>
+#include <boost/numeric/ublas/matrix_sparse.hpp>
+#include <boost/numeric/ublas/vector.hpp>
+#include <boost/numeric/ublas/operation.hpp>
+
+#include "utils.hpp"
+#include "common/random.hpp"
+
+namespace ublas = boost::numeric::ublas;
+
+using ublas::test::detail::matrix_close_to;
+using ublas::test::detail::vector_close_to;
+
+typedef std::complex<double> complex_type;
+
+// Dense 2 x 2 blocks at scattered positions, a few loose elements and empty
+// rows, so that most block sizes need padding
+template<class M>
+M make_sparse (std::size_t size1, std::size_t size2, unsigned seed) {
+    M m (size1, size2);
+    for (std::size_t i = 0; i + 5 < size1; i += 2) {
+        const std::size_t blocks = (i * 7) % 5;
+        for (std::size_t k = 0; k < blocks; ++ k) {
+            const std::size_t j = (k * 74 + i * 3) % (size2 - 1) / 2 * 2;
+            for (std::size_t r = 0; r < 2; ++ r)
+                for (std::size_t c = 0; c < 2; ++ c) {
+                    typename M::value_type t;
+                    assign_random (t, seed);
+                    m (i + r, j + c) = t;
+                }
+        }
+        if (i % 6 == 0) {
+            typename M::value_type t;
+            assign_random (t, seed);
+            m (i + 1, (i * 13) % size2) = t;
+        }
+    }
+    return m;
+}
+
+template<class T, class L>
+ublas::matrix<T, L> make_dense (std::size_t size1, std::size_t size2, unsigned seed) {
+    ublas::matrix<T, L> m (size1, size2);
+    for (std::size_t i = 0; i < size1; ++ i)
+        for (std::size_t j = 0; j < size2; ++ j)
+            assign_random (m (i, j), seed);
+    return m;
+}
+
+// prod and axpy_prod with vectors against the dense product
+template<class T, std::size_t BR, std::size_t BC>
+bool check_vector_products (std::size_t size1, std::size_t size2, double tolerance = 1e-12) {
+    typedef ublas::compressed_matrix<T> compressed_type;
+    const compressed_type c (make_sparse<compressed_type> (size1, size2, unsigned (size1)));
+    const ublas::block_compressed_matrix<T, BR, BC> a (c);
+    const ublas::matrix<T> d (c);
+    const ublas::vector<T> x (make_vector<T> (size2, 1)), y (make_vector<T> (size1, 2));
+    const ublas::vector<T> ax (ublas::prod (d, x));
+
+    bool result = a.nnz () == c.nnz ();
+    const ublas::vector<T> v (ublas::prod (a, x));
+    result = result && vector_close_to (v, ax, size1, tolerance);
+
+    // Accumulating and with an expression as the vector operand, against
+    // the product just checked, since y + ax can cancel below the tolerance
+    const ublas::vector<T> y_plus_v (y + v), y_minus_v (y_plus_v - T (2) * v), two_v (T (2) * v);
+    ublas::vector<T> u (y);
+    ublas::noalias (u) += ublas::prod (a, x);
+    result = result && vector_close_to (u, y_plus_v, size1, tolerance);
+    ublas::noalias (u) -= ublas::prod (a, T (2) * x);
+    result = result && vector_close_to (u, y_minus_v, size1, tolerance);
+
+    ublas::vector<T> s (size1);
+    ublas::axpy_prod (a, x, s, true);
+    result = result && vector_close_to (s, v, size1, tolerance);
+    ublas::axpy_prod (a, x, s, false);
+    result = result && vector_close_to (s, two_v, size1, tolerance);
+    return result;
+}
+
+// prod and axpy_prod with matrices of either orientation
+template<class T, std::size_t BR, std::size_t BC, class L>
+bool check_matrix_products (std::size_t size1, std::size_t size2, std::size_t size3) {
+    typedef ublas::compressed_matrix<T> compressed_type;
+    const compressed_type c (make_sparse<compressed_type> (size1, size2, unsigned (size2)));
+    const ublas::block_compressed_matrix<T, BR, BC> a (c);
+    const ublas::matrix<T, L> b (make_dense<T, L> (size2, size3, 3));
+    const ublas::matrix<T, L> ab (ublas::prod (ublas::matrix<T> (c), b));
+    const ublas::matrix<T, L> two_ab (T (2) * ab), minus_ab (- ab);
+
+    ublas::matrix<T, L> m (ublas::prod (a, b));
+    bool result = matrix_close_to (m, ab, size1, size3, 1e-12);
+    ublas::noalias (m) += ublas::prod (a, b);
+    result = result && matrix_close_to (m, two_ab, size1, size3, 1e-12);
+    ublas::noalias (m) -= ublas::prod (a, T (3) * b);
+    result = result && matrix_close_to (m, minus_ab, size1, size3, 1e-12);
+
+    // A sparse right hand side is copied
+    m = ublas::prod (a, compressed_type (b));
+    result = result && matrix_close_to (m, ab, size1, size3, 1e-12);
+
+    ublas::matrix<T, ublas::row_major> n (size1, size3);
+    ublas::axpy_prod (a, b, n, true);
+    result = result && matrix_close_to (n, ab, size1, size3, 1e-12);
+    ublas::axpy_prod (a, b, n, false);
+    result = result && matrix_close_to (n, two_ab, size1, size3, 1e-12);
+    return result;
+}
+
+BOOST_UBLAS_TEST_DEF ( test_bsr_vector_products )
+{
+    BOOST_UBLAS_TEST_CHECK ((check_vector_products<double, 2, 2> (300, 200)));
+    BOOST_UBLAS_TEST_CHECK ((check_vector_products<double, 1, 1> (150, 100)));
+    BOOST_UBLAS_TEST_CHECK ((check_vector_products<double, 3, 3> (151, 203)));
+    BOOST_UBLAS_TEST_CHECK ((check_vector_products<double, 4, 2> (201, 99)));
+    BOOST_UBLAS_TEST_CHECK ((check_vector_products<float, 2, 4> (120, 97, 1e-5)));
+    BOOST_UBLAS_TEST_CHECK ((check_vector_products<complex_type, 2, 2> (120, 90)));
+}
+
+BOOST_UBLAS_TEST_DEF ( test_bsr_matrix_products )
+{
+    BOOST_UBLAS_TEST_CHECK ((check_matrix_products<double, 2, 2, ublas::row_major> (120, 80, 21)));
+    BOOST_UBLAS_TEST_CHECK ((check_matrix_products<double, 2, 2, ublas::column_major> (120, 80, 21)));
+    BOOST_UBLAS_TEST_CHECK ((check_matrix_products<double, 3, 2, ublas::row_major> (101, 73, 9)));
+    BOOST_UBLAS_TEST_CHECK ((check_matrix_products<double, 4, 4, ublas::row_major> (64, 64, 3)));
+    BOOST_UBLAS_TEST_CHECK ((check_matrix_products<complex_type, 2, 2, ublas::row_major> (60, 50, 10)));
+}
+
+// Elements, iterators and block detection
+BOOST_UBLAS_TEST_DEF ( test_bsr_structure )
+{
+    typedef ublas::compressed_matrix<double> compressed_type;
+    const compressed_type c (make_sparse<compressed_type> (101, 60, 7));
+    const ublas::block_compressed_matrix<double, 3, 2> a (c);
+
+    bool equal = true;
+    for (std::size_t i = 0; i < c.size1 (); ++ i)
+        for (std::size_t j = 0; j < c.size2 (); ++ j)
+            equal = equal && a (i, j) == c (i, j);
+    BOOST_UBLAS_TEST_CHECK (equal);
+    BOOST_UBLAS_TEST_CHECK_EQ (a.block_rows (), std::size_t (34));
+    BOOST_UBLAS_TEST_CHECK_EQ (a.block_columns (), std::size_t (30));
+    BOOST_UBLAS_TEST_CHECK_EQ (a.value_data ().size (), a.blocks () * 6);
+
+    // Back through the sparse iterators, by rows and by columns; the zeros
+    // of the blocks are stored elements
+    const compressed_type back (a);
+    BOOST_UBLAS_TEST_CHECK_EQ (ublas::norm_inf (ublas::matrix<double> (back - c)), 0.0);
+    const ublas::compressed_matrix<double, ublas::column_major> by_columns (a);
+    BOOST_UBLAS_TEST_CHECK_EQ (ublas::norm_inf (ublas::matrix<double> (by_columns - c)), 0.0);
+
+    // block_fill predicts the padding of the block sizes; the 2 x 2 blocks
+    // of the source fill theirs but for the loose elements
+    const ublas::block_compressed_matrix<double, 2, 2> b (c);
+    BOOST_UBLAS_TEST_CHECK_EQ (ublas::block_fill (c, 2, 2), double (c.nnz ()) / double (b.value_data ().size ()));
+    BOOST_UBLAS_TEST_CHECK (ublas::block_fill (c, 2, 2) > 0.8);
+    BOOST_UBLAS_TEST_CHECK (ublas::block_fill (c, 2, 2) > ublas::block_fill (c, 3, 3));
+    BOOST_UBLAS_TEST_CHECK_EQ (ublas::block_fill (c, 1, 1), 1.0);
+    BOOST_UBLAS_TEST_CHECK_EQ (ublas::block_fill (c, 3, 2), double (c.nnz ()) / double (a.value_data ().size ()));
+}
+
+// Construction from other expressions, assignment and generic results
+BOOST_UBLAS_TEST_DEF ( test_bsr_sources )
+{
+    typedef ublas::coordinate_matrix<double> coordinate_type;
+    const coordinate_type m (make_sparse<coordinate_type> (90, 80, 9));
+    const ublas::vector<double> x (make_vector<double> (80, 10));
+    const ublas::vector<double> expected (ublas::prod (ublas::matrix<double> (m), x));
+
+    const ublas::vector<double> twice (2.0 * expected);
+
+    ublas::block_compressed_matrix<double, 2, 2> a (m);
+    const ublas::vector<double> ax (ublas::prod (a, x));
+    BOOST_UBLAS_TEST_CHECK_VECTOR_CLOSE (ax, expected, 90, 1e-12);
+    a = ublas::matrix<double> (2.0 * ublas::matrix<double> (m));
+    const ublas::vector<double> ax2 (ublas::prod (a, x));
+    BOOST_UBLAS_TEST_CHECK_VECTOR_CLOSE (ax2, twice, 90, 1e-12);
+
+    // Results without raw storage keep the generic evaluation
+    const ublas::block_compressed_matrix<double, 2, 2> b (m);
+    ublas::vector<double, std::vector<double> > v (ublas::prod (b, x));
+    BOOST_UBLAS_TEST_CHECK_VECTOR_CLOSE (v, expected, 90, 1e-12);
+    ublas::vector<double, std::vector<double> > w (90);
+    ublas::axpy_prod (b, x, w, true);
+    BOOST_UBLAS_TEST_CHECK_VECTOR_CLOSE (w, expected, 90, 1e-12);
+    const ublas::matrix<double> d (make_dense<double, ublas::row_major> (80, 5, 11));
+    const ublas::matrix<double> bd (ublas::prod (ublas::matrix<double> (m), d));
+    ublas::matrix<double, ublas::row_major, std::vector<double> > e (ublas::prod (b, d));
+    BOOST_UBLAS_TEST_CHECK_MATRIX_CLOSE (e, bd, 90, 5, 1e-12);
+    ublas::axpy_prod (b, d, e, true);
+    BOOST_UBLAS_TEST_CHECK_MATRIX_CLOSE (e, bd, 90, 5, 1e-12);
+}
+
+// Matrices without stored elements, and empty ones
+BOOST_UBLAS_TEST_DEF ( test_bsr_empty )
+{
+    const ublas::block_compressed_matrix<double, 2, 3> a (ublas::compressed_matrix<double> (50, 40)), b;
+    ublas::vector<double> v (50, 1.0), e;
+    BOOST_UBLAS_TEST_CHECK_EQ (a.blocks (), std::size_t (0));
+    v = ublas::prod (a, ublas::vector<double> (40, 1.0));
+    BOOST_UBLAS_TEST_CHECK_EQ (ublas::norm_inf (v), 0.0);
+    e = ublas::prod (b, ublas::vector<double> ());
+    BOOST_UBLAS_TEST_CHECK_EQ (e.size (), std::size_t (0));
+    ublas::matrix<double> m (ublas::prod (a, ublas::matrix<double> (40, 0)));
+    BOOST_UBLAS_TEST_CHECK_EQ (m.size1 (), std::size_t (50));
+    BOOST_UBLAS_TEST_CHECK_EQ (ublas::block_fill (ublas::compressed_matrix<double> (50, 40), 2, 3), 1.0);
+}
+
+int main () {
+    BOOST_UBLAS_TEST_BEGIN();
+
+    BOOST_UBLAS_TEST_DO( test_bsr_vector_products );
+    BOOST_UBLAS_TEST_DO( test_bsr_matrix_products );
+    BOOST_UBLAS_TEST_DO( test_bsr_structure );
+    BOOST_UBLAS_TEST_DO( test_bsr_sources );
+    BOOST_UBLAS_TEST_DO( test_bsr_empty );
+
+    BOOST_UBLAS_TEST_END();
+}
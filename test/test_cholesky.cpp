@@ -0,0 +1,229 @@
+// Copyright (c) 2017 uBLAS developers
+// Distributed under the Boost Software License, Version 1.0. (See
+// accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+
+// Narrow panels, a small pool and a low threshold so that the blocked
+// factorization runs many panels and splits its updates across threads
+#define BOOST_UBLAS_THREADS 4
+#define BOOST_UBLAS_FACTORIZE_BLOCK 16
+#define BOOST_UBLAS_FACTORIZE_PARALLEL_COST 1024
+
+#include <cmath>
+#include <complex>
+#include <limits>
+
+#include <boost/numeric/ublas/matrix.hpp>
+#include <boost/numeric/ublas/symmetric.hpp>
+#include <boost/numeric/ublas/hermitian.hpp>
+#include <boost/numeric/ublas/cholesky.hpp>
+
+#include "utils.hpp"
+#include "common/random.hpp"
+
+namespace ublas = boost::numeric::ublas;
+
+typedef std::complex<double> complex_type;
+
+// B B^H + size I: hermitian positive definite and well conditioned
+template<class T>
+ublas::matrix<T> make_spd (std::size_t size, unsigned seed) {
+    ublas::matrix<T> b (size, size);
+    for (std::size_t i = 0; i < size; ++ i)
+        for (std::size_t j = 0; j < size; ++ j)
+            assign_random (b (i, j), seed);
+    ublas::matrix<T> a (ublas::prod (b, ublas::herm (b)));
+    for (std::size_t i = 0; i < size; ++ i)
+        a (i, i) += T (double (size));
+    return a;
+}
+
+// Hermitian, with diagonal entries of both signs: only L D L^H applies
+ublas::matrix<double> make_indefinite (std::size_t size, unsigned seed) {
+    ublas::matrix<double> a (size, size);
+    for (std::size_t i = 0; i < size; ++ i)
+        for (std::size_t j = 0; j <= i; ++ j)
+            a (i, j) = a (j, i) = random_value (seed);
+    for (std::size_t i = 0; i < size; ++ i)
+        a (i, i) = (i % 3 == 1 ? -1.0 : 1.0) * double (size);
+    return a;
+}
+
+// Lower triangle of m, dense
+template<class M>
+ublas::matrix<typename M::value_type> lower_part (const M &m) {
+    typedef typename M::value_type value_type;
+    ublas::matrix<value_type> l (m.size1 (), m.size2 ());
+    for (std::size_t i = 0; i < m.size1 (); ++ i)
+        for (std::size_t j = 0; j < m.size2 (); ++ j)
+            l (i, j) = j <= i ? value_type (m (i, j)) : value_type ();
+    return l;
+}
+
+template<class M1, class M2>
+double relative_difference (const M1 &m1, const M2 &m2) {
+    return ublas::norm_inf (m1 - m2) / ublas::norm_inf (m2);
+}
+
+// || L L^H - A || relative to || A ||, size and machine epsilon
+template<class M, class T>
+double factorization_residual (const M &factor, const ublas::matrix<T> &a) {
+    ublas::matrix<T> l (lower_part (factor));
+    return relative_difference (ublas::prod (l, ublas::herm (l)), a) /
+           (double (a.size1 ()) * std::numeric_limits<double>::epsilon ());
+}
+
+// Dense, and packed storage of either triangle, give the same factor
+template<class T>
+bool check_cholesky (std::size_t size) {
+    typedef ublas::hermitian_matrix<T, ublas::lower> lower_type;
+    typedef ublas::hermitian_matrix<T, ublas::upper> upper_type;
+    ublas::matrix<T> a (make_spd<T> (size, unsigned (size)));
+    ublas::matrix<T> dense (a);
+    ublas::matrix<T, ublas::column_major> dense_column (a);
+    lower_type packed_lower (a);
+    upper_type packed_upper (a);
+    if (ublas::cholesky_factorize (dense) != 0 ||
+        ublas::cholesky_factorize (dense_column) != 0 ||
+        ublas::cholesky_factorize (packed_lower) != 0 ||
+        ublas::cholesky_factorize (packed_upper) != 0)
+        return false;
+    const ublas::matrix<T> l (lower_part (dense));
+    return factorization_residual (dense, a) < 10.0 &&
+           ublas::norm_inf (lower_part (dense_column) - l) == 0.0 &&
+           ublas::norm_inf (lower_part (packed_lower) - l) == 0.0 &&
+           ublas::norm_inf (lower_part (packed_upper) - l) == 0.0;
+}
+
+BOOST_UBLAS_TEST_DEF ( test_cholesky_factorize )
+{
+    BOOST_UBLAS_TEST_CHECK (check_cholesky<double> (150));
+    BOOST_UBLAS_TEST_CHECK (check_cholesky<double> (7));
+    BOOST_UBLAS_TEST_CHECK (check_cholesky<complex_type> (83));
+}
+
+BOOST_UBLAS_TEST_DEF ( test_cholesky_symmetric )
+{
+    const std::size_t size = 101;
+    ublas::matrix<double> a (make_spd<double> (size, 5));
+    ublas::matrix<double> dense (a);
+    BOOST_UBLAS_TEST_CHECK_EQ (ublas::cholesky_factorize (dense), std::size_t (0));
+
+    ublas::symmetric_matrix<double, ublas::upper> packed (a);
+    BOOST_UBLAS_TEST_CHECK_EQ (ublas::cholesky_factorize (packed), std::size_t (0));
+    BOOST_UBLAS_TEST_CHECK_EQ (ublas::norm_inf (lower_part (packed) - lower_part (dense)), 0.0);
+
+    // Only the upper triangle of the adapted matrix is stored, and written
+    ublas::matrix<double> upper (a);
+    for (std::size_t i = 0; i < size; ++ i)
+        for (std::size_t j = 0; j < i; ++ j)
+            upper (i, j) = 99.0;
+    ublas::symmetric_adaptor<ublas::matrix<double>, ublas::upper> adaptor (upper);
+    BOOST_UBLAS_TEST_CHECK_EQ (ublas::cholesky_factorize (adaptor), std::size_t (0));
+    BOOST_UBLAS_TEST_CHECK_EQ (ublas::norm_inf (lower_part (adaptor) - lower_part (dense)), 0.0);
+    bool untouched = true;
+    for (std::size_t i = 0; i < size; ++ i)
+        for (std::size_t j = 0; j < i; ++ j)
+            untouched = untouched && upper (i, j) == 99.0;
+    BOOST_UBLAS_TEST_CHECK (untouched);
+}
+
+BOOST_UBLAS_TEST_DEF ( test_cholesky_substitute )
+{
+    const std::size_t size = 120;
+    ublas::matrix<double> a (make_spd<double> (size, 9)), factor (a);
+    ublas::symmetric_matrix<double, ublas::lower> packed (a);
+    BOOST_UBLAS_TEST_CHECK_EQ (ublas::cholesky_factorize (factor), std::size_t (0));
+    BOOST_UBLAS_TEST_CHECK_EQ (ublas::cholesky_factorize (packed), std::size_t (0));
+
+    ublas::matrix<double> x (size, 30);
+    unsigned seed = 10;
+    for (std::size_t i = 0; i < x.size1 (); ++ i)
+        for (std::size_t j = 0; j < x.size2 (); ++ j)
+            x (i, j) = random_value (seed);
+    const ublas::matrix<double> b (ublas::prod (a, x));
+
+    // Dense factor and right hand sides take the blocked solves
+    ublas::matrix<double> blocked (b);
+    ublas::cholesky_substitute (factor, blocked);
+    BOOST_UBLAS_TEST_CHECK (relative_difference (blocked, x) < 1e-12);
+
+    ublas::matrix<double> generic (b);
+    ublas::cholesky_substitute (packed, generic);
+    BOOST_UBLAS_TEST_CHECK (relative_difference (generic, x) < 1e-12);
+
+    ublas::vector<double> v (ublas::column (b, 3));
+    ublas::cholesky_substitute (packed, v);
+    BOOST_UBLAS_TEST_CHECK (ublas::norm_inf (v - ublas::column (x, 3)) / ublas::norm_inf (ublas::column (x, 3)) < 1e-12);
+}
+
+BOOST_UBLAS_TEST_DEF ( test_cholesky_substitute_complex )
+{
+    const std::size_t size = 70;
+    ublas::matrix<complex_type> a (make_spd<complex_type> (size, 11));
+    ublas::hermitian_matrix<complex_type, ublas::upper> packed (a);
+    BOOST_UBLAS_TEST_CHECK_EQ (ublas::cholesky_factorize (packed), std::size_t (0));
+
+    ublas::vector<complex_type> x (size);
+    unsigned seed = 12;
+    for (std::size_t i = 0; i < size; ++ i)
+        assign_random (x (i), seed);
+    ublas::vector<complex_type> v (ublas::prod (a, x));
+    ublas::cholesky_substitute (packed, v);
+    BOOST_UBLAS_TEST_CHECK (ublas::norm_inf (v - x) / ublas::norm_inf (x) < 1e-12);
+}
+
+BOOST_UBLAS_TEST_DEF ( test_ldlt )
+{
+    const std::size_t size = 110;
+    ublas::matrix<double> a (make_indefinite (size, 13));
+    ublas::matrix<double> factor (a);
+    ublas::symmetric_matrix<double, ublas::lower> packed (a);
+    BOOST_UBLAS_TEST_CHECK_EQ (ublas::ldlt_factorize (factor), std::size_t (0));
+    BOOST_UBLAS_TEST_CHECK_EQ (ublas::ldlt_factorize (packed), std::size_t (0));
+    BOOST_UBLAS_TEST_CHECK_EQ (ublas::norm_inf (lower_part (packed) - lower_part (factor)), 0.0);
+    // Not positive definite
+    ublas::matrix<double> not_spd (a);
+    BOOST_UBLAS_TEST_CHECK_EQ (ublas::cholesky_factorize (not_spd), std::size_t (2));
+
+    ublas::matrix<double> x (size, 25);
+    unsigned seed = 14;
+    for (std::size_t i = 0; i < x.size1 (); ++ i)
+        for (std::size_t j = 0; j < x.size2 (); ++ j)
+            x (i, j) = random_value (seed);
+    const ublas::matrix<double> b (ublas::prod (a, x));
+
+    ublas::matrix<double> blocked (b), generic (b);
+    ublas::ldlt_substitute (factor, blocked);
+    ublas::ldlt_substitute (packed, generic);
+    BOOST_UBLAS_TEST_CHECK (relative_difference (blocked, x) < 1e-12);
+    BOOST_UBLAS_TEST_CHECK (relative_difference (generic, x) < 1e-12);
+
+    ublas::vector<double> v (ublas::column (b, 0));
+    ublas::ldlt_substitute (packed, v);
+    BOOST_UBLAS_TEST_CHECK (ublas::norm_inf (v - ublas::column (x, 0)) / ublas::norm_inf (ublas::column (x, 0)) < 1e-12);
+}
+
+BOOST_UBLAS_TEST_DEF ( test_cholesky_not_positive )
+{
+    const std::size_t size = 90;
+    ublas::matrix<double> a (make_spd<double> (size, 15));
+    // The pivot of column 70 turns negative
+    a (70, 70) = -1.0;
+    ublas::symmetric_matrix<double, ublas::lower> packed (a);
+    BOOST_UBLAS_TEST_CHECK_EQ (ublas::cholesky_factorize (a), std::size_t (71));
+    BOOST_UBLAS_TEST_CHECK_EQ (ublas::cholesky_factorize (packed), std::size_t (71));
+}
+
+int main () {
+    BOOST_UBLAS_TEST_BEGIN();
+
+    BOOST_UBLAS_TEST_DO( test_cholesky_factorize );
+    BOOST_UBLAS_TEST_DO( test_cholesky_symmetric );
+    BOOST_UBLAS_TEST_DO( test_cholesky_substitute );
+    BOOST_UBLAS_TEST_DO( test_cholesky_substitute_complex );
+    BOOST_UBLAS_TEST_DO( test_ldlt );
+    BOOST_UBLAS_TEST_DO( test_cholesky_not_positive );
+
+    BOOST_UBLAS_TEST_END();
+}
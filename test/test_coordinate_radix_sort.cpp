@@ -0,0 +1,125 @@
+// Copyright (c) 2017 uBLAS developers
+// Distributed under the Boost Software License, Version 1.0. (See
+// accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+
+// A small pool and a low threshold so that the sort splits its elements
+// across threads
+#define BOOST_UBLAS_THREADS 4
+#define BOOST_UBLAS_SPARSE_PARALLEL_NNZ 64
+
+#include <map>
+#include <utility>
+
+#include <boost/numeric/ublas/matrix_sparse.hpp>
+#include <boost/numeric/ublas/vector_sparse.hpp>
+
+#include "utils.hpp"
+
+namespace ublas = boost::numeric::ublas;
+
+typedef std::map<std::pair<std::size_t, std::size_t>, double> element_map;
+
+// Appends n random elements, one in four a duplicate, sorting every batch of
+// them, and checks the result against the sums in a map by (major, minor)
+template<class L, std::size_t IB>
+bool check_matrix (std::size_t size1, std::size_t size2, std::size_t n, std::size_t batch) {
+    typedef ublas::coordinate_matrix<double, L, IB> M;
+    M m (size1, size2, n);
+    element_map sums;
+    unsigned long long seed = n;
+    std::size_t i = 0, j = 0;
+    for (std::size_t k = 0; k < n; ++ k) {
+        if (k % 4 != 3) {
+            seed = seed * 6364136223846793005ull + 1442695040888963407ull;
+            i = std::size_t (seed >> 20) % size1;
+            j = std::size_t (seed >> 40) % size2;
+        }
+        const double t = double (k % 9) - 4.0;
+        m.append_element (i, j, t);
+        sums [std::make_pair (L::index_M (i, j), L::index_m (i, j))] += t;
+        if (k % batch == batch - 1)
+            m.sort ();
+    }
+    m.sort ();
+
+    bool result = m.nnz () == sums.size ();
+    element_map::const_iterator it = sums.begin ();
+    // Sums of small integers are exact in any order
+    for (std::size_t p = 0; result && p < m.nnz (); ++ p, ++ it)
+        result = std::size_t (m.index1_data () [p]) - M::index_base () == it->first.first &&
+                 std::size_t (m.index2_data () [p]) - M::index_base () == it->first.second &&
+                 m.value_data () [p] == it->second;
+    return result;
+}
+
+BOOST_UBLAS_TEST_DEF ( test_coordinate_matrix_radix_sort )
+{
+    BOOST_UBLAS_TEST_CHECK ((check_matrix<ublas::row_major, 0> (300, 200, 20000, 20000)));
+    BOOST_UBLAS_TEST_CHECK ((check_matrix<ublas::row_major, 0> (300, 200, 20000, 3000)));
+    BOOST_UBLAS_TEST_CHECK ((check_matrix<ublas::row_major, 0> (5000, 70000, 10000, 10000)));
+    BOOST_UBLAS_TEST_CHECK ((check_matrix<ublas::column_major, 0> (300, 200, 5000, 700)));
+    BOOST_UBLAS_TEST_CHECK ((check_matrix<ublas::row_major, 1> (40, 30, 2000, 100)));
+    BOOST_UBLAS_TEST_CHECK ((check_matrix<ublas::row_major, 0> (1, 1, 100, 7)));
+}
+
+// Indices too large to pack into one key keep the comparison sort
+BOOST_UBLAS_TEST_DEF ( test_coordinate_matrix_wide )
+{
+    const std::size_t wide = std::size_t (1) << (8 * sizeof (std::size_t) - 11);
+    BOOST_UBLAS_TEST_CHECK ((check_matrix<ublas::row_major, 0> (4096, wide, 3000, 1000)));
+}
+
+// Duplicates are summed in the order they were appended
+BOOST_UBLAS_TEST_DEF ( test_coordinate_matrix_stable )
+{
+    ublas::coordinate_matrix<double> m (10, 10);
+    for (std::size_t k = 0; k < 300; ++ k)
+        m.append_element (k / 2 % 3, 7, k % 2 == 0 ? 1e16 : -1e16);
+    m.append_element (1, 7, 1.0);
+    m.sort ();
+    BOOST_UBLAS_TEST_CHECK_EQ (m.nnz (), std::size_t (3));
+    BOOST_UBLAS_TEST_CHECK_EQ (m (0, 7), 0.0);
+    BOOST_UBLAS_TEST_CHECK_EQ (m (1, 7), 1.0);
+    BOOST_UBLAS_TEST_CHECK_EQ (m (2, 7), 0.0);
+}
+
+// As check_matrix, for a vector with index array IA
+template<class IA>
+bool check_vector (std::size_t size, std::size_t n, std::size_t batch) {
+    ublas::coordinate_vector<double, 0, IA> v (size, n);
+    std::map<std::size_t, double> sums;
+    unsigned long long seed = 1;
+    for (std::size_t k = 0; k < n; ++ k) {
+        seed = seed * 6364136223846793005ull + 1442695040888963407ull;
+        const std::size_t i = std::size_t (seed >> 30) % (k % 2 == 0 ? size : 100);
+        v.append_element (i, double (k % 5));
+        sums [i] += double (k % 5);
+        if (k % batch == batch - 1)
+            v.sort ();
+    }
+    v.sort ();
+    bool result = v.nnz () == sums.size ();
+    std::map<std::size_t, double>::const_iterator it = sums.begin ();
+    for (std::size_t p = 0; result && p < v.nnz (); ++ p, ++ it)
+        result = std::size_t (v.index_data () [p]) == it->first && v.value_data () [p] == it->second;
+    return result;
+}
+
+BOOST_UBLAS_TEST_DEF ( test_coordinate_vector_radix_sort )
+{
+    BOOST_UBLAS_TEST_CHECK ((check_vector<ublas::unbounded_array<std::size_t> > (100000, 30000, 7000)));
+    // Indices narrower than std::size_t
+    BOOST_UBLAS_TEST_CHECK ((check_vector<ublas::unbounded_array<unsigned int> > (100000, 30000, 7000)));
+}
+
+int main () {
+    BOOST_UBLAS_TEST_BEGIN();
+
+    BOOST_UBLAS_TEST_DO( test_coordinate_matrix_radix_sort );
+    BOOST_UBLAS_TEST_DO( test_coordinate_matrix_wide );
+    BOOST_UBLAS_TEST_DO( test_coordinate_matrix_stable );
+    BOOST_UBLAS_TEST_DO( test_coordinate_vector_radix_sort );
+
+    BOOST_UBLAS_TEST_END();
+}
@@ -0,0 +1,161 @@
+// Copyright (c) 2017 uBLAS developers
+// Distributed under the Boost Software License, Version 1.0. (See
+// accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+
+// Small blocking parameters so that every loop of the packed product runs
+// several times, including partial blocks, with cheap test sizes.
+#define BOOST_UBLAS_GEMM_MC 8
+#define BOOST_UBLAS_GEMM_KC 16
+#define BOOST_UBLAS_GEMM_NC 32
+
+#include <boost/numeric/ublas/matrix.hpp>
+#include <boost/numeric/ublas/matrix_proxy.hpp>
+
+#include "utils.hpp"
+
+namespace ublas = boost::numeric::ublas;
+
+static const double TOL (1.0e-10);
+
+template<class M>
+void fill (M &m, int seed) {
+    for (std::size_t i = 0; i < m.size1 (); ++ i)
+        for (std::size_t j = 0; j < m.size2 (); ++ j)
+            m (i, j) = double ((i * 7 + j * 3 + seed) % 11) - 5.0;
+}
+
+// c0 + alpha a b
+template<class M, class M1, class M2>
+M reference_prod (const M1 &a, const M2 &b, const M &c0, double alpha) {
+    M c (c0);
+    for (std::size_t i = 0; i < c.size1 (); ++ i)
+        for (std::size_t j = 0; j < c.size2 (); ++ j) {
+            double t = 0;
+            for (std::size_t k = 0; k < a.size2 (); ++ k)
+                t += a (i, k) * b (k, j);
+            c (i, j) += alpha * t;
+        }
+    return c;
+}
+
+template<class M1, class M2>
+bool close (const M1 &x, const M2 &y) {
+    for (std::size_t i = 0; i < x.size1 (); ++ i)
+        for (std::size_t j = 0; j < x.size2 (); ++ j)
+            if (std::abs (x (i, j) - y (i, j)) > TOL)
+                return false;
+    return true;
+}
+
+// C = A B, C += A B and C -= A B against the reference product
+template<class M1, class M2, class M>
+bool check_prod (std::size_t size1, std::size_t size, std::size_t size2) {
+    M1 a (size1, size);
+    M2 b (size, size2);
+    fill (a, 1); fill (b, 2);
+
+    M zero (size1, size2);
+    zero.clear ();
+    M c (ublas::prod (a, b));
+    bool result = close (c, reference_prod (a, b, zero, 1.0));
+
+    M c0 (size1, size2);
+    fill (c0, 3);
+    c = c0;
+    ublas::noalias (c) += ublas::prod (a, b);
+    result = result && close (c, reference_prod (a, b, c0, 1.0));
+    c = c0;
+    ublas::noalias (c) -= ublas::prod (a, b);
+    return result && close (c, reference_prod (a, b, c0, -1.0));
+}
+
+BOOST_UBLAS_TEST_DEF ( test_gemm_row_major )
+{
+    typedef ublas::matrix<double> matrix_type;
+    BOOST_UBLAS_TEST_CHECK ((check_prod<matrix_type, matrix_type, matrix_type> (8, 16, 32)));
+    BOOST_UBLAS_TEST_CHECK ((check_prod<matrix_type, matrix_type, matrix_type> (37, 53, 29)));
+}
+
+BOOST_UBLAS_TEST_DEF ( test_gemm_column_major )
+{
+    typedef ublas::matrix<double, ublas::column_major> matrix_type;
+    BOOST_UBLAS_TEST_CHECK ((check_prod<matrix_type, matrix_type, matrix_type> (37, 53, 29)));
+}
+
+BOOST_UBLAS_TEST_DEF ( test_gemm_mixed_layout )
+{
+    typedef ublas::matrix<double> row_type;
+    typedef ublas::matrix<double, ublas::column_major> column_type;
+    BOOST_UBLAS_TEST_CHECK ((check_prod<row_type, column_type, row_type> (41, 19, 67)));
+    BOOST_UBLAS_TEST_CHECK ((check_prod<column_type, row_type, column_type> (3, 70, 5)));
+}
+
+BOOST_UBLAS_TEST_DEF ( test_gemm_c_matrix )
+{
+    BOOST_UBLAS_TEST_CHECK ((check_prod<ublas::c_matrix<double, 13, 21>, ublas::c_matrix<double, 21, 11>, ublas::c_matrix<double, 13, 11> > (13, 21, 11)));
+}
+
+BOOST_UBLAS_TEST_DEF ( test_gemm_degenerate )
+{
+    typedef ublas::matrix<double> matrix_type;
+    BOOST_UBLAS_TEST_CHECK ((check_prod<matrix_type, matrix_type, matrix_type> (1, 1, 1)));
+    BOOST_UBLAS_TEST_CHECK ((check_prod<matrix_type, matrix_type, matrix_type> (5, 0, 7)));
+}
+
+BOOST_UBLAS_TEST_DEF ( test_gemm_alpha_beta )
+{
+    typedef ublas::matrix<double> matrix_type;
+    matrix_type a (23, 45), b (45, 17), c (23, 17);
+    fill (a, 4); fill (b, 5); fill (c, 6);
+    matrix_type c0 (c);
+    for (std::size_t i = 0; i < c0.size1 (); ++ i)
+        for (std::size_t j = 0; j < c0.size2 (); ++ j)
+            c0 (i, j) *= 0.5;
+    BOOST_UBLAS_TEST_CHECK (ublas::detail::gemm_prod (c, a, b, 2.0, 0.5));
+    BOOST_UBLAS_TEST_CHECK_MATRIX_CLOSE (c, reference_prod (a, b, c0, 2.0), 23, 17, TOL);
+
+    // Aliased result and operand are left to the generic evaluation
+    matrix_type s (17, 17);
+    fill (s, 7);
+    BOOST_UBLAS_TEST_CHECK (! ublas::detail::gemm_prod (s, s, s, 1.0, 0.0));
+}
+
+// Ranges of one matrix whose storage overlaps go through the temporary of the
+// generic evaluation, disjoint ones through the kernel
+BOOST_UBLAS_TEST_DEF ( test_gemm_overlapping_ranges )
+{
+    typedef ublas::matrix<double> matrix_type;
+    typedef ublas::matrix_range<matrix_type> range_type;
+    matrix_type m (70, 40), b (30, 30);
+    fill (m, 8); fill (b, 9);
+    range_type c (m, ublas::range (0, 30), ublas::range (0, 30));
+    range_type a (m, ublas::range (10, 40), ublas::range (5, 35));
+    range_type d (m, ublas::range (40, 70), ublas::range (10, 40));
+    BOOST_UBLAS_TEST_CHECK (! ublas::detail::gemm_prod (c, a, b, 1.0, 0.0));
+    BOOST_UBLAS_TEST_CHECK (ublas::detail::dense_storage_overlaps (c, a));
+    BOOST_UBLAS_TEST_CHECK (! ublas::detail::dense_storage_overlaps (c, d));
+
+    const matrix_type zero (30, 30, 0.0);
+    const matrix_type expected (reference_prod (a, b, zero, 1.0));
+    ublas::noalias (c) = ublas::prod (a, b);
+    BOOST_UBLAS_TEST_CHECK_MATRIX_CLOSE (c, expected, 30, 30, TOL);
+
+    const matrix_type disjoint (reference_prod (d, b, zero, 1.0));
+    BOOST_UBLAS_TEST_CHECK (ublas::detail::gemm_prod (c, d, b, 1.0, 0.0));
+    BOOST_UBLAS_TEST_CHECK_MATRIX_CLOSE (c, disjoint, 30, 30, TOL);
+}
+
+int main () {
+    BOOST_UBLAS_TEST_BEGIN();
+
+    BOOST_UBLAS_TEST_DO( test_gemm_row_major );
+    BOOST_UBLAS_TEST_DO( test_gemm_column_major );
+    BOOST_UBLAS_TEST_DO( test_gemm_mixed_layout );
+    BOOST_UBLAS_TEST_DO( test_gemm_c_matrix );
+    BOOST_UBLAS_TEST_DO( test_gemm_degenerate );
+    BOOST_UBLAS_TEST_DO( test_gemm_alpha_beta );
+    BOOST_UBLAS_TEST_DO( test_gemm_overlapping_ranges );
+
+    BOOST_UBLAS_TEST_END();
+}
@@ -0,0 +1,246 @@
+// Copyright (c) 2017 uBLAS developers
+// Distributed under the Boost Software License, Version 1.0. (See
+// accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+
+#include <complex>
+#include <numeric>
+#include <sstream>
+
+#include <boost/numeric/ublas/binary_io.hpp>
+#include <boost/numeric/ublas/matrix.hpp>
+#include <boost/numeric/ublas/matrix_proxy.hpp>
+#include <boost/numeric/ublas/qr.hpp>
+#include <boost/numeric/ublas/vector.hpp>
+// Only included by functional.hpp when BOOST_UBLAS_USE_SIMD is defined
+#include <boost/numeric/ublas/detail/raw.hpp>
+
+#include "utils.hpp"
+
+namespace ublas = boost::numeric::ublas;
+
+template<class M>
+void fill (M &m) {
+    for (std::size_t i = 0; i < m.size1 (); ++ i)
+        for (std::size_t j = 0; j < m.size2 (); ++ j)
+            m (i, j) = double (i * 100 + j);
+}
+
+template<class M1, class M2>
+bool same (const M1 &a, const M2 &b) {
+    bool result = a.size1 () == b.size1 () && a.size2 () == b.size2 ();
+    for (std::size_t i = 0; result && i < a.size1 (); ++ i)
+        for (std::size_t j = 0; result && j < a.size2 (); ++ j)
+            result = a (i, j) == b (i, j);
+    return result;
+}
+
+// The elements are at their place in the storage and the padding is left
+// alone
+template<class L>
+bool check_storage (std::size_t ld) {
+    ublas::matrix<double, L> m (3, 5, ld, -1.0);
+    fill (m);
+    const std::size_t size_minor = L::size_m (3, 5);
+    bool result = m.leading_dimension () == ld && m.data ().size () == L::size_M (3, 5) * ld;
+    for (std::size_t k = 0; k < m.data ().size (); ++ k) {
+        const std::size_t major = k / ld, minor = k % ld;
+        const double expected = minor < size_minor ? double (L::index_M (major, minor) * 100 + L::index_m (major, minor)) : -1.0;
+        result = result && m.data () [k] == expected;
+    }
+    return result;
+}
+
+BOOST_UBLAS_TEST_DEF ( test_leading_dimension_storage )
+{
+    BOOST_UBLAS_TEST_CHECK (check_storage<ublas::row_major> (8));
+    BOOST_UBLAS_TEST_CHECK (check_storage<ublas::column_major> (4));
+    BOOST_UBLAS_TEST_CHECK (check_storage<ublas::row_major> (5));
+    BOOST_UBLAS_TEST_CHECK (ublas::matrix<double> (3, 5).leading_dimension () == 5);
+    BOOST_UBLAS_TEST_CHECK ((ublas::matrix<double, ublas::column_major> (3, 5).leading_dimension () == 3));
+
+    // Only lines of an even number of whole cache lines are padded
+    BOOST_UBLAS_TEST_CHECK (ublas::padded_leading_dimension<double> (1024) == 1032);
+    BOOST_UBLAS_TEST_CHECK (ublas::padded_leading_dimension<double> (1000) == 1000);
+    BOOST_UBLAS_TEST_CHECK (ublas::padded_leading_dimension<double> (1001) == 1001);
+    BOOST_UBLAS_TEST_CHECK (ublas::padded_leading_dimension<float> (32) == 48);
+    BOOST_UBLAS_TEST_CHECK (ublas::padded_leading_dimension<std::complex<double> > (512) == 516);
+    BOOST_UBLAS_TEST_CHECK (ublas::padded_leading_dimension<double> (0) == 0);
+}
+
+template<class L>
+bool check_iterators () {
+    typedef ublas::matrix<double, L> matrix_type;
+    matrix_type m (4, 6, L::size_m (4, 6) + 3, 0.0);
+    fill (m);
+    bool result = true;
+    std::size_t count = 0;
+    for (typename matrix_type::const_iterator1 it1 = m.begin1 (); it1 != m.end1 (); ++ it1)
+        for (typename matrix_type::const_iterator2 it2 = it1.begin (); it2 != it1.end (); ++ it2, ++ count)
+            result = result && *it2 == double (it2.index1 () * 100 + it2.index2 ());
+    for (typename matrix_type::iterator2 it2 = m.begin2 (); it2 != m.end2 (); ++ it2)
+        for (typename matrix_type::iterator1 it1 = it2.begin (); it1 != it2.end (); ++ it1, ++ count)
+            result = result && *it1 == double (it1.index1 () * 100 + it1.index2 ());
+    result = result && count == 48;
+    // Random access and reverse iterators
+    result = result && m.end1 () - m.begin1 () == 4 && m.end2 () - m.begin2 () == 6;
+    result = result && *(m.begin1 () + 3) == m (3, 0) && (m.begin2 () + 5).index2 () == 5;
+    result = result && *(m.find1 (0, 2, 4) - 1) == m (1, 4) && *(m.find2 (0, 2, 4) + 1) == m (2, 5);
+    result = result && *m.rbegin1 () == m (3, 0) && *m.rbegin2 () == m (0, 5);
+    return result;
+}
+
+BOOST_UBLAS_TEST_DEF ( test_leading_dimension_iterators )
+{
+    BOOST_UBLAS_TEST_CHECK (check_iterators<ublas::row_major> ());
+    BOOST_UBLAS_TEST_CHECK (check_iterators<ublas::column_major> ());
+}
+
+// Rows and columns of padded matrices, and the raw strides
+template<class L>
+bool check_proxies () {
+    typedef ublas::matrix<double, L> matrix_type;
+    matrix_type m (5, 7, L::size_m (5, 7) + 2, 0.0);
+    fill (m);
+    ublas::matrix_row<matrix_type> r (m, 2);
+    ublas::matrix_column<matrix_type> c (m, 5);
+    bool result = std::accumulate (r.begin (), r.end (), 0.0) == 7 * 200.0 + 21.0 &&
+                  std::accumulate (c.begin (), c.end (), 0.0) == 1000.0 + 5 * 5.0;
+    r (3) = -1.0;
+    c (4) = -2.0;
+    result = result && m (2, 3) == -1.0 && m (4, 5) == -2.0;
+    ublas::row (m, 0) = ublas::row (m, 4);
+    result = result && m (0, 6) == 406.0 && m (0, 5) == -2.0;
+
+    const bool row_major = L::fast_j ();
+    result = result && ublas::raw::leading_dimension (m) == int (m.leading_dimension ()) &&
+             ublas::raw::stride1 (m) == (row_major ? int (m.leading_dimension ()) : 1) &&
+             ublas::raw::stride2 (m) == (row_major ? 1 : int (m.leading_dimension ()));
+    result = result && ublas::raw::stride (r) == ublas::raw::stride2 (m) && ublas::raw::stride (c) == ublas::raw::stride1 (m);
+    return result;
+}
+
+BOOST_UBLAS_TEST_DEF ( test_leading_dimension_proxies )
+{
+    BOOST_UBLAS_TEST_CHECK (check_proxies<ublas::row_major> ());
+    BOOST_UBLAS_TEST_CHECK (check_proxies<ublas::column_major> ());
+}
+
+BOOST_UBLAS_TEST_DEF ( test_leading_dimension_resize )
+{
+    ublas::matrix<double> m (3, 4, 7, 0.0), u (3, 4);
+    fill (m);
+    fill (u);
+    m.resize (5, 6, 9, true);
+    BOOST_UBLAS_TEST_CHECK (m.leading_dimension () == 9 && same (ublas::subrange (m, 0, 3, 0, 4), u));
+    m.resize (2, 3);
+    BOOST_UBLAS_TEST_CHECK (m.leading_dimension () == 3 && same (m, ublas::subrange (u, 0, 2, 0, 3)));
+    m.resize (4, 4, 10, false);
+    BOOST_UBLAS_TEST_CHECK (m.size1 () == 4 && m.size2 () == 4 && m.leading_dimension () == 10 && m.data ().size () == 40);
+
+    ublas::matrix<double, ublas::column_major> c (3, 4);
+    fill (c);
+    c.resize (4, 4, 6, true);
+    BOOST_UBLAS_TEST_CHECK (c.leading_dimension () == 6 && same (ublas::subrange (c, 0, 3, 0, 4), u));
+
+    // Swapping exchanges the leading dimensions
+    ublas::matrix<double> s (3, 4);
+    fill (s);
+    m.resize (3, 4, 11, false);
+    m.swap (s);
+    BOOST_UBLAS_TEST_CHECK (s.leading_dimension () == 11 && m.leading_dimension () == 4 && same (m, u));
+}
+
+// Assignments of expressions of the same size keep the padding
+BOOST_UBLAS_TEST_DEF ( test_leading_dimension_assign )
+{
+    ublas::matrix<double> m (5, 7, 11, 0.0), u (5, 7);
+    fill (u);
+    m = 2.0 * u;
+    BOOST_UBLAS_TEST_CHECK (m.leading_dimension () == 11 && same (m, 2.0 * u));
+    m += u;
+    BOOST_UBLAS_TEST_CHECK (m.leading_dimension () == 11 && same (m, 3.0 * u));
+    m -= 2.0 * u;
+    BOOST_UBLAS_TEST_CHECK (m.leading_dimension () == 11 && same (m, u));
+    m = ublas::matrix<double, ublas::column_major> (2.0 * u);
+    BOOST_UBLAS_TEST_CHECK (m.leading_dimension () == 11 && same (m, 2.0 * u));
+    const ublas::matrix<double> p (m);
+    BOOST_UBLAS_TEST_CHECK (p.leading_dimension () == 11 && same (p, m));
+    m = ublas::prod (u, ublas::trans (u));
+    BOOST_UBLAS_TEST_CHECK (m.leading_dimension () == 5 && m.size1 () == 5 && m.size2 () == 5);
+}
+
+// The optimised kernels see the strides of padded matrices
+template<class L1, class L2>
+bool check_products (std::size_t size1, std::size_t size2, std::size_t size3) {
+    ublas::matrix<double, L1> a (size1, size2, L1::size_m (size1, size2) + 5, 0.0);
+    ublas::matrix<double, L2> b (size2, size3, L2::size_m (size2, size3) + 3, 0.0);
+    ublas::matrix<double, L1> c (size1, size3, L1::size_m (size1, size3) + 8, 0.0);
+    fill (a);
+    fill (b);
+    ublas::matrix<double, L1> ua_compact (size1, size2);
+    ua_compact.assign (a);
+    ublas::vector<double> x (size2), z (size1);
+    for (std::size_t j = 0; j < size2; ++ j)
+        x (j) = double (j % 7) - 3.0;
+    for (std::size_t i = 0; i < size1; ++ i)
+        z (i) = double (i % 5) - 2.0;
+    ublas::matrix<double, L2> ub_compact (size2, size3);
+    ub_compact.assign (b);
+
+    ublas::noalias (c) = ublas::prod (a, b);
+    const ublas::matrix<double> expected (ublas::prod (ua_compact, ub_compact));
+    return c.leading_dimension () == L1::size_m (size1, size3) + 8 && same (c, expected) &&
+           same (ublas::matrix<double> (ublas::prod (a, b)), expected) &&
+           ublas::norm_1 (ublas::prod (a, x) - ublas::prod (ua_compact, x)) == 0.0 &&
+           ublas::norm_1 (ublas::prod (z, a) - ublas::prod (z, ua_compact)) == 0.0 &&
+           ublas::norm_1 (ublas::prod (ublas::row (a, size1 - 1), b) - ublas::row (expected, size1 - 1)) == 0.0;
+}
+
+BOOST_UBLAS_TEST_DEF ( test_leading_dimension_products )
+{
+    BOOST_UBLAS_TEST_CHECK ((check_products<ublas::row_major, ublas::row_major> (7, 9, 5)));
+    BOOST_UBLAS_TEST_CHECK ((check_products<ublas::column_major, ublas::row_major> (33, 17, 40)));
+    BOOST_UBLAS_TEST_CHECK ((check_products<ublas::row_major, ublas::column_major> (100, 120, 80)));
+    BOOST_UBLAS_TEST_CHECK ((check_products<ublas::column_major, ublas::column_major> (130, 64, 96)));
+
+    // Factorizations in place
+    ublas::matrix<double, ublas::column_major> q (9, 4, 16, 0.0), uq (9, 4);
+    for (std::size_t i = 0; i < 9; ++ i)
+        for (std::size_t j = 0; j < 4; ++ j)
+            q (i, j) = uq (i, j) = double ((i * 7 + j * 3) % 11) - 5.0;
+    ublas::vector<double> tau (4), utau (4);
+    ublas::qr_factorize (q, tau);
+    ublas::qr_factorize (uq, utau);
+    BOOST_UBLAS_TEST_CHECK (ublas::norm_inf (q - uq) < 1e-12 && ublas::norm_inf (tau - utau) < 1e-12);
+}
+
+// Only the elements are written, the padding is not
+BOOST_UBLAS_TEST_DEF ( test_leading_dimension_binary_io )
+{
+    ublas::matrix<double> m (6, 5, 8, -1.0), u (6, 5);
+    fill (m);
+    fill (u);
+    std::stringstream padded (std::ios_base::in | std::ios_base::out | std::ios_base::binary);
+    std::stringstream compact (std::ios_base::in | std::ios_base::out | std::ios_base::binary);
+    ublas::save_binary (padded, m);
+    ublas::save_binary (compact, u);
+    BOOST_UBLAS_TEST_CHECK (padded.str () == compact.str ());
+    ublas::matrix<double> r;
+    ublas::load_binary (padded, r);
+    BOOST_UBLAS_TEST_CHECK (padded && r.leading_dimension () == 5 && same (r, u));
+}
+
+int main () {
+    BOOST_UBLAS_TEST_BEGIN();
+
+    BOOST_UBLAS_TEST_DO( test_leading_dimension_storage );
+    BOOST_UBLAS_TEST_DO( test_leading_dimension_iterators );
+    BOOST_UBLAS_TEST_DO( test_leading_dimension_proxies );
+    BOOST_UBLAS_TEST_DO( test_leading_dimension_resize );
+    BOOST_UBLAS_TEST_DO( test_leading_dimension_assign );
+    BOOST_UBLAS_TEST_DO( test_leading_dimension_products );
+    BOOST_UBLAS_TEST_DO( test_leading_dimension_binary_io );
+
+    BOOST_UBLAS_TEST_END();
+}
@@ -0,0 +1,165 @@
+// Copyright (c) 2017 uBLAS developers
+// Distributed under the Boost Software License, Version 1.0. (See
+// accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+
+// Narrow panels, a small pool and a low threshold so that the blocked
+// factorization runs many panels and splits its updates across threads
+#define BOOST_UBLAS_THREADS 4
+#define BOOST_UBLAS_FACTORIZE_BLOCK 16
+#define BOOST_UBLAS_FACTORIZE_PARALLEL_COST 1024
+#define BOOST_UBLAS_TYPE_CHECK 0
+
+#include <cmath>
+#include <limits>
+#include <vector>
+
+#include <boost/numeric/ublas/matrix.hpp>
+#include <boost/numeric/ublas/lu.hpp>
+
+#include "utils.hpp"
+#include "common/random.hpp"
+
+namespace ublas = boost::numeric::ublas;
+
+// Dense, but without the raw storage access the blocked path needs
+typedef ublas::matrix<double, ublas::row_major, std::vector<double> > unblocked_matrix;
+
+template<class M>
+M make_matrix (std::size_t size1, std::size_t size2, unsigned seed) {
+    M m (size1, size2);
+    for (std::size_t i = 0; i < size1; ++ i)
+        for (std::size_t j = 0; j < size2; ++ j)
+            m (i, j) = random_value (seed);
+    return m;
+}
+
+template<class M1, class M2>
+bool same (const M1 &m1, const M2 &m2) {
+    if (m1.size1 () != m2.size1 () || m1.size2 () != m2.size2 ())
+        return false;
+    for (std::size_t i = 0; i < m1.size1 (); ++ i)
+        for (std::size_t j = 0; j < m1.size2 (); ++ j)
+            if (m1 (i, j) != m2 (i, j))
+                return false;
+    return true;
+}
+
+// || P A - L U ||_inf relative to || A ||_inf, size and machine epsilon
+template<class M>
+double factorization_residual (const M &a, const M &lu, const ublas::permutation_matrix<> &pm) {
+    M pa (a);
+    ublas::swap_rows (pm, pa);
+    const std::size_t size = (std::min) (a.size1 (), a.size2 ());
+    ublas::matrix<double> l (a.size1 (), size), u (size, a.size2 ());
+    l.clear (); u.clear ();
+    for (std::size_t i = 0; i < a.size1 (); ++ i)
+        for (std::size_t j = 0; j < a.size2 (); ++ j) {
+            if (j < i && j < size)
+                l (i, j) = lu (i, j);
+            else if (i < size)
+                u (i, j) = lu (i, j);
+        }
+    for (std::size_t i = 0; i < size; ++ i)
+        l (i, i) = 1.0;
+    ublas::matrix<double> r (pa - ublas::prod (l, u));
+    return ublas::norm_inf (r) / (ublas::norm_inf (a) * double (a.size1 ()) * std::numeric_limits<double>::epsilon ());
+}
+
+template<class M>
+bool check_residual (std::size_t size1, std::size_t size2) {
+    M a (make_matrix<M> (size1, size2, unsigned (size1 * 31 + size2)));
+    M lu (a);
+    ublas::permutation_matrix<> pm (size1);
+    if (ublas::lu_factorize (lu, pm) != 0)
+        return false;
+    return factorization_residual (a, lu, pm) < 10.0;
+}
+
+BOOST_UBLAS_TEST_DEF ( test_lu_residual )
+{
+    BOOST_UBLAS_TEST_CHECK (check_residual<ublas::matrix<double> > (203, 203));
+    BOOST_UBLAS_TEST_CHECK ((check_residual<ublas::matrix<double, ublas::column_major> > (150, 150)));
+    // Tall and wide
+    BOOST_UBLAS_TEST_CHECK (check_residual<ublas::matrix<double> > (170, 90));
+    BOOST_UBLAS_TEST_CHECK ((check_residual<ublas::matrix<double, ublas::column_major> > (60, 130)));
+}
+
+BOOST_UBLAS_TEST_DEF ( test_lu_solve )
+{
+    typedef ublas::matrix<double> matrix_type;
+    const std::size_t size = 180;
+    matrix_type a (make_matrix<matrix_type> (size, size, 7)), lu (a);
+    matrix_type x (make_matrix<matrix_type> (size, 40, 8)), b (ublas::prod (a, x));
+    ublas::permutation_matrix<> pm (size);
+    BOOST_UBLAS_TEST_CHECK_EQ (ublas::lu_factorize (lu, pm), std::size_t (0));
+
+    matrix_type solution (b);
+    ublas::lu_substitute (lu, pm, solution);
+    matrix_type r (ublas::prod (a, solution) - b);
+    BOOST_UBLAS_TEST_CHECK (ublas::norm_inf (r) / (ublas::norm_inf (a) * ublas::norm_inf (solution) * size * std::numeric_limits<double>::epsilon ()) < 10.0);
+}
+
+// Entries in {-1, 0, 1}: most pivot candidates tie
+template<class M>
+M make_tied_matrix (std::size_t size) {
+    M m (size, size);
+    for (std::size_t i = 0; i < size; ++ i)
+        for (std::size_t j = 0; j < size; ++ j)
+            m (i, j) = double (int ((i * 7 + j * 13 + i * j) % 5) % 3) - 1.0;
+    return m;
+}
+
+template<class M>
+bool same_pivots (const M &a) {
+    const std::size_t size = a.size1 ();
+    ublas::matrix<double> blocked (a);
+    unblocked_matrix unblocked (a);
+    ublas::permutation_matrix<> pm_blocked (size), pm_unblocked (size);
+    if (ublas::lu_factorize (blocked, pm_blocked) != ublas::lu_factorize (unblocked, pm_unblocked))
+        return false;
+    for (std::size_t i = 0; i < size; ++ i)
+        if (pm_blocked (i) != pm_unblocked (i))
+            return false;
+    // The first panel and the rows of U beside it see the same operations
+    // in the same order, only the trailing updates go through gemm
+    const std::size_t block = BOOST_UBLAS_FACTORIZE_BLOCK;
+    for (std::size_t i = 0; i < size; ++ i)
+        for (std::size_t j = 0; j < size; ++ j)
+            if ((i < block || j < block) && blocked (i, j) != unblocked (i, j))
+                return false;
+    return true;
+}
+
+BOOST_UBLAS_TEST_DEF ( test_lu_pivots )
+{
+    BOOST_UBLAS_TEST_CHECK (same_pivots (make_tied_matrix<ublas::matrix<double> > (101)));
+    BOOST_UBLAS_TEST_CHECK (same_pivots (make_matrix<ublas::matrix<double> > (150, 150, 5)));
+}
+
+BOOST_UBLAS_TEST_DEF ( test_lu_singular )
+{
+    const std::size_t size = 90;
+    ublas::matrix<double> blocked (make_matrix<ublas::matrix<double> > (size, size, 3));
+    // Column 70 is zero, and stays zero through the updates
+    ublas::column (blocked, 70) = ublas::zero_vector<double> (size);
+    unblocked_matrix unblocked (blocked);
+    ublas::permutation_matrix<> pm_blocked (size), pm_unblocked (size);
+    BOOST_UBLAS_TEST_CHECK_EQ (ublas::lu_factorize (blocked, pm_blocked), std::size_t (71));
+    BOOST_UBLAS_TEST_CHECK_EQ (ublas::lu_factorize (unblocked, pm_unblocked), std::size_t (71));
+    bool pivots = true;
+    for (std::size_t i = 0; i < size; ++ i)
+        pivots = pivots && pm_blocked (i) == pm_unblocked (i);
+    BOOST_UBLAS_TEST_CHECK (pivots);
+}
+
+int main () {
+    BOOST_UBLAS_TEST_BEGIN();
+
+    BOOST_UBLAS_TEST_DO( test_lu_residual );
+    BOOST_UBLAS_TEST_DO( test_lu_solve );
+    BOOST_UBLAS_TEST_DO( test_lu_pivots );
+    BOOST_UBLAS_TEST_DO( test_lu_singular );
+
+    BOOST_UBLAS_TEST_END();
+}
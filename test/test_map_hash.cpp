@@ -0,0 +1,227 @@
+// Copyright (c) 2017 uBLAS developers
+// Distributed under the Boost Software License, Version 1.0. (See
+// accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+
+#include <complex>
+#include <map>
+#include <vector>
+
+#include <boost/numeric/ublas/matrix.hpp>
+#include <boost/numeric/ublas/matrix_sparse.hpp>
+#include <boost/numeric/ublas/vector_sparse.hpp>
+
+#include "utils.hpp"
+
+#if defined (BOOST_UBLAS_CPP_GE_2011) && ! defined (BOOST_UBLAS_NO_THREADS)
+#include <thread>
+#endif
+
+namespace ublas = boost::numeric::ublas;
+
+typedef ublas::map_hash<std::size_t, double> hash_type;
+
+// Keys in no particular order, one in three repeated
+std::size_t key (std::size_t k, std::size_t size) {
+    return k % 3 == 2 ? key (k - 2, size) : (k * 2654435761u + k / 7) % size;
+}
+
+// The elements in key order, as a std::map holds them
+bool same_elements (const hash_type &h, const std::map<std::size_t, double> &m) {
+    bool result = h.size () == m.size ();
+    std::map<std::size_t, double>::const_iterator it = m.begin ();
+    for (hash_type::const_iterator ith = h.begin (); result && ith != h.end (); ++ ith, ++ it)
+        result = ith->first == it->first && ith->second == it->second;
+    return result;
+}
+
+BOOST_UBLAS_TEST_DEF ( test_map_hash_storage )
+{
+    hash_type h;
+    std::map<std::size_t, double> m;
+    for (std::size_t k = 0; k < 5000; ++ k) {
+        h [key (k, 100000)] += double (k % 5);
+        m [key (k, 100000)] += double (k % 5);
+    }
+    BOOST_UBLAS_TEST_CHECK (same_elements (h, m));
+
+    // Lookups on the sorted elements and after new unordered insertions
+    BOOST_UBLAS_TEST_CHECK (h.find (key (7, 100000)) != h.end ());
+    BOOST_UBLAS_TEST_CHECK_EQ (h.find (key (7, 100000))->second, m [key (7, 100000)]);
+    BOOST_UBLAS_TEST_CHECK (h.find (100000) == h.end ());
+    BOOST_UBLAS_TEST_CHECK (h.insert (std::make_pair (std::size_t (100003), 1.0)).second);
+    BOOST_UBLAS_TEST_CHECK (h.insert (std::make_pair (std::size_t (5), 2.0)).second);
+    BOOST_UBLAS_TEST_CHECK (! h.insert (std::make_pair (std::size_t (5), 3.0)).second);
+    m [100003] = 1.0;
+    m [5] = 2.0;
+    BOOST_UBLAS_TEST_CHECK_EQ (h.lower_bound (6)->first, m.lower_bound (6)->first);
+    BOOST_UBLAS_TEST_CHECK (h.lower_bound (100004) == h.end ());
+    BOOST_UBLAS_TEST_CHECK (same_elements (h, m));
+
+    // Erasure keeps the order and the index
+    h.erase (h.lower_bound (5));
+    m.erase (5);
+    h.erase (h.lower_bound (50000), h.lower_bound (60000));
+    m.erase (m.lower_bound (50000), m.lower_bound (60000));
+    BOOST_UBLAS_TEST_CHECK (same_elements (h, m));
+    BOOST_UBLAS_TEST_CHECK (h.find (5) == h.end ());
+    BOOST_UBLAS_TEST_CHECK_EQ (h [100003], 1.0);
+
+    // Copies, swaps, ordered appends
+    hash_type c (h), e;
+    BOOST_UBLAS_TEST_CHECK (same_elements (c, m));
+    c.swap (e);
+    BOOST_UBLAS_TEST_CHECK (c.empty ());
+    BOOST_UBLAS_TEST_CHECK (same_elements (e, m));
+    c.push_back (c.end (), std::make_pair (std::size_t (3), 1.0));
+    c.push_back (c.end (), std::make_pair (std::size_t (9), 2.0));
+    BOOST_UBLAS_TEST_CHECK_EQ (c.size (), std::size_t (2));
+    BOOST_UBLAS_TEST_CHECK_EQ (c.find (9)->second, 2.0);
+    h.clear ();
+    BOOST_UBLAS_TEST_CHECK (h.empty ());
+    BOOST_UBLAS_TEST_CHECK (h.find (key (7, 100000)) == h.end ());
+    h.reserve (100);
+    h [4] = 1.0;
+    BOOST_UBLAS_TEST_CHECK (h.capacity () >= 100);
+    BOOST_UBLAS_TEST_CHECK_EQ (h.size (), std::size_t (1));
+}
+
+BOOST_UBLAS_TEST_DEF ( test_map_hash_vector )
+{
+    const std::size_t size = 3000;
+    ublas::mapped_vector<double, hash_type> v (size);
+    ublas::mapped_vector<double> w (size);
+    for (std::size_t k = 0; k < 2000; ++ k) {
+        v (key (k, size)) += double (k % 7) - 3.0;
+        w (key (k, size)) += double (k % 7) - 3.0;
+    }
+    BOOST_UBLAS_TEST_CHECK_EQ (v.nnz (), w.nnz ());
+    BOOST_UBLAS_TEST_CHECK_EQ (ublas::norm_inf (v - w), 0.0);
+    BOOST_UBLAS_TEST_CHECK_EQ (ublas::inner_prod (v, w), ublas::inner_prod (w, w));
+
+    // Element support and iterators
+    v.erase_element (key (0, size));
+    w.erase_element (key (0, size));
+    v.insert_element (size - 1, 4.0);
+    w.insert_element (size - 1, 4.0);
+    double sum = 0.0;
+    for (ublas::mapped_vector<double, hash_type>::const_iterator it = v.begin (); it != v.end (); ++ it)
+        sum += *it * double (it.index ());
+    double expected = 0.0;
+    for (ublas::mapped_vector<double>::const_iterator it = w.begin (); it != w.end (); ++ it)
+        expected += *it * double (it.index ());
+    BOOST_UBLAS_TEST_CHECK_EQ (sum, expected);
+
+    v.resize (size / 2);
+    w.resize (size / 2);
+    BOOST_UBLAS_TEST_CHECK_EQ (v.nnz (), w.nnz ());
+    BOOST_UBLAS_TEST_CHECK_EQ (ublas::norm_inf (v - w), 0.0);
+
+    ublas::compressed_vector<double> c;
+    v.freeze (c);
+    BOOST_UBLAS_TEST_CHECK_EQ (c.size (), size / 2);
+    BOOST_UBLAS_TEST_CHECK_EQ (c.nnz (), v.nnz ());
+    BOOST_UBLAS_TEST_CHECK_EQ (ublas::norm_inf (c - w), 0.0);
+    ublas::compressed_vector<double, 1> c1;
+    v.freeze (c1);
+    BOOST_UBLAS_TEST_CHECK_EQ (ublas::norm_inf (c1 - w), 0.0);
+}
+
+// Accumulation into a mapped_matrix with hash storage against the default
+// std::map storage, and freezing into a compressed_matrix
+template<class T, class L, std::size_t IB>
+bool check_matrix (std::size_t size1, std::size_t size2, std::size_t n) {
+    ublas::mapped_matrix<T, L, ublas::map_hash<std::size_t, T> > m (size1, size2, n / 2);
+    ublas::mapped_matrix<T, L> r (size1, size2);
+    for (std::size_t k = 0; k < n; ++ k) {
+        const std::size_t e = key (k, size1 * size2);
+        m (e / size2, e % size2) += T (double (k % 9) - 4.0);
+        r (e / size2, e % size2) += T (double (k % 9) - 4.0);
+    }
+    bool result = m.nnz () == r.nnz () && ublas::norm_inf (m - r) == 0.0;
+
+    ublas::vector<T> x (size2);
+    for (std::size_t j = 0; j < size2; ++ j)
+        x (j) = T (double (j % 5) - 2.0);
+    result = result && ublas::norm_inf (ublas::prod (m, x) - ublas::prod (r, x)) == 0.0;
+
+    ublas::compressed_matrix<T, L, IB> c (3, 3);
+    c (1, 1) = T (1.0);
+    m.freeze (c);
+    result = result && c.size1 () == size1 && c.size2 () == size2 && c.nnz () == m.nnz () &&
+             ublas::norm_inf (c - r) == 0.0 &&
+             ublas::norm_inf (ublas::prod (c, x) - ublas::prod (r, x)) == 0.0;
+
+    // Assignments from expressions keep the storage usable
+    ublas::mapped_matrix<T, L, ublas::map_hash<std::size_t, T> > t (ublas::trans (m));
+    result = result && ublas::norm_inf (t - ublas::trans (r)) == 0.0;
+    m += r;
+    result = result && ublas::norm_inf (m - T (2.0) * r) == 0.0;
+    return result;
+}
+
+BOOST_UBLAS_TEST_DEF ( test_map_hash_matrix )
+{
+    BOOST_UBLAS_TEST_CHECK ((check_matrix<double, ublas::row_major, 0> (120, 90, 3000)));
+    BOOST_UBLAS_TEST_CHECK ((check_matrix<double, ublas::column_major, 0> (120, 90, 3000)));
+    BOOST_UBLAS_TEST_CHECK ((check_matrix<double, ublas::row_major, 1> (40, 70, 500)));
+    BOOST_UBLAS_TEST_CHECK ((check_matrix<std::complex<double>, ublas::row_major, 0> (30, 20, 300)));
+    BOOST_UBLAS_TEST_CHECK ((check_matrix<double, ublas::row_major, 0> (1, 1, 3)));
+}
+
+#if defined (BOOST_UBLAS_CPP_GE_2011) && ! defined (BOOST_UBLAS_NO_THREADS)
+// Concurrent const accesses to unsorted elements, the first of which sorts them
+BOOST_UBLAS_TEST_DEF ( test_map_hash_concurrent )
+{
+    for (std::size_t round = 0; round < 20; ++ round) {
+        hash_type h;
+        std::map<std::size_t, double> m;
+        for (std::size_t k = 0; k < 2000; ++ k) {
+            h [key (k + round, 100000)] += double (k % 5);
+            m [key (k + round, 100000)] += double (k % 5);
+        }
+        const hash_type &c = h;
+        std::vector<char> results (4, 0);
+        std::vector<std::thread> threads;
+        for (std::size_t t = 0; t < results.size (); ++ t)
+            threads.push_back (std::thread ([&c, &m, &results, round, t] () {
+                const std::size_t i = key (t + round, 100000);
+                results [t] = c.find (i) != c.end () && c.find (i)->second == m.find (i)->second &&
+                              c.lower_bound (i)->first == i && same_elements (c, m);
+            }));
+        for (std::size_t t = 0; t < threads.size (); ++ t)
+            threads [t].join ();
+        for (std::size_t t = 0; t < results.size (); ++ t)
+            BOOST_UBLAS_TEST_CHECK (results [t]);
+    }
+}
+#endif
+
+// Empty matrices freeze into empty compressed matrices
+BOOST_UBLAS_TEST_DEF ( test_map_hash_empty )
+{
+    ublas::mapped_matrix<double, ublas::row_major, hash_type> m (5, 4), e;
+    ublas::compressed_matrix<double> c (2, 2);
+    c (0, 0) = 1.0;
+    m.freeze (c);
+    BOOST_UBLAS_TEST_CHECK_EQ (c.size1 (), std::size_t (5));
+    BOOST_UBLAS_TEST_CHECK_EQ (c.nnz (), std::size_t (0));
+    BOOST_UBLAS_TEST_CHECK_EQ (c (0, 0), 0.0);
+    e.freeze (c);
+    BOOST_UBLAS_TEST_CHECK_EQ (c.size1 (), std::size_t (0));
+    BOOST_UBLAS_TEST_CHECK_EQ (c.nnz (), std::size_t (0));
+}
+
+int main () {
+    BOOST_UBLAS_TEST_BEGIN();
+
+    BOOST_UBLAS_TEST_DO( test_map_hash_storage );
+    BOOST_UBLAS_TEST_DO( test_map_hash_vector );
+    BOOST_UBLAS_TEST_DO( test_map_hash_matrix );
+#if defined (BOOST_UBLAS_CPP_GE_2011) && ! defined (BOOST_UBLAS_NO_THREADS)
+    BOOST_UBLAS_TEST_DO( test_map_hash_concurrent );
+#endif
+    BOOST_UBLAS_TEST_DO( test_map_hash_empty );
+
+    BOOST_UBLAS_TEST_END();
+}
@@ -0,0 +1,339 @@
+// Copyright (c) 2017 uBLAS developers
+// Distributed under the Boost Software License, Version 1.0. (See
+// accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+
+// Small pool and threshold so that the subchains run concurrently
+#define BOOST_UBLAS_THREADS 4
+#define BOOST_UBLAS_CHAIN_PARALLEL_COST 1000
+#define BOOST_UBLAS_CHAIN_PLAN_CACHE_SIZE 4
+
+#include <vector>
+
+#include <boost/numeric/ublas/banded.hpp>
+#include <boost/numeric/ublas/matrix.hpp>
+#include <boost/numeric/ublas/matrix_proxy.hpp>
+#include <boost/numeric/ublas/matrix_sparse.hpp>
+#include <boost/numeric/ublas/triangular.hpp>
+
+#include "utils.hpp"
+
+namespace ublas = boost::numeric::ublas;
+namespace detail = boost::numeric::ublas::detail;
+
+template<class M>
+M make_matrix (std::size_t size1, std::size_t size2, int seed) {
+    M m (size1, size2);
+    for (std::size_t i = 0; i < size1; ++ i)
+        for (std::size_t j = 0; j < size2; ++ j)
+            m (i, j) = typename M::value_type ((seed + i * 5 + j * 3) % 7) - typename M::value_type (3);
+    return m;
+}
+
+template<class M1, class M2>
+bool same (const M1 &m1, const M2 &m2) {
+    if (m1.size1 () != m2.size1 () || m1.size2 () != m2.size2 ())
+        return false;
+    for (std::size_t i = 0; i < m1.size1 (); ++ i)
+        for (std::size_t j = 0; j < m1.size2 (); ++ j)
+            if (m1 (i, j) != m2 (i, j))
+                return false;
+    return true;
+}
+
+std::vector<std::size_t> dimensions (const std::size_t *first, const std::size_t *last) {
+    return std::vector<std::size_t> (first, last);
+}
+
+BOOST_UBLAS_TEST_DEF ( test_chain_plan )
+{
+    // The textbook example: ((A0 (A1 A2)) ((A3 A4) A5)) with 15125 multiply-adds
+    const std::size_t dims [] = { 30, 35, 15, 5, 10, 20, 25 };
+    detail::chain_plan plan (dimensions (dims, dims + 7));
+    BOOST_UBLAS_TEST_CHECK (plan.size () == 6);
+    BOOST_UBLAS_TEST_CHECK (plan.cost (0, 5) == 15125.);
+    BOOST_UBLAS_TEST_CHECK (plan.split (0, 5) == 2);
+    BOOST_UBLAS_TEST_CHECK (plan.split (0, 2) == 0);
+    BOOST_UBLAS_TEST_CHECK (plan.split (3, 5) == 4);
+    BOOST_UBLAS_TEST_CHECK (plan.rows (0) == 30 && plan.columns (5) == 25);
+
+    // A single product needs its result only
+    BOOST_UBLAS_TEST_CHECK (plan.peak (1, 2) == 35 * 5);
+    // (A3 A4) A5 holds A3 A4 and then its own result
+    BOOST_UBLAS_TEST_CHECK (plan.peak (3, 5) == 5 * 25 + 5 * 20);
+    // The left side of the root is smaller and is kept while the right one runs
+    BOOST_UBLAS_TEST_CHECK (plan.peak (0, 5) == 30 * 25 + 30 * 5 + 5 * 25 + 5 * 20 &&
+                            plan.left_first (0, 5));
+}
+
+BOOST_UBLAS_TEST_DEF ( test_chain_sparse_plan )
+{
+    const std::size_t dims [] = { 300, 300, 300, 300 };
+    std::vector<std::size_t> levels;
+    levels.push_back (10); levels.push_back (10); levels.push_back (0);
+
+    // Dense operands tie, so the first split, A (B C), is kept
+    detail::chain_plan dense (dimensions (dims, dims + 4));
+    BOOST_UBLAS_TEST_CHECK (dense.split (0, 2) == 0 && dense.kernel (0, 2) == detail::chain_plan::gemm_kernel);
+    BOOST_UBLAS_TEST_CHECK (dense.cost (0, 2) == 2. * 300 * 300 * 300);
+
+    // (A B) C: the product of the sparse operands stays sparse
+    detail::chain_plan sparse (dimensions (dims, dims + 4), levels);
+    BOOST_UBLAS_TEST_CHECK (sparse.split (0, 2) == 1);
+    BOOST_UBLAS_TEST_CHECK (sparse.kernel (0, 1) != detail::chain_plan::gemm_kernel &&
+                            sparse.kernel (0, 2) == detail::chain_plan::sparse_left_kernel);
+    BOOST_UBLAS_TEST_CHECK (sparse.density (0, 1) < 1e-3 && sparse.density (2, 2) == 1.);
+    BOOST_UBLAS_TEST_CHECK (sparse.cost (0, 2) < dense.cost (0, 2) / 100);
+}
+
+// The chain A0 ... A5 of the textbook example with the given scheduling
+template<class T>
+ublas::matrix<T> evaluate (const std::vector<ublas::matrix<T> > &a, bool parallel, std::size_t budget) {
+    detail::chain_operands<T> operands;
+    for (std::size_t k = 0; k < a.size (); ++ k)
+        operands.push_back (a [k]);
+    detail::chain_plan plan (operands.dimensions ());
+    ublas::matrix<T> result (plan.rows (0), plan.columns (plan.size () - 1));
+    detail::chain_evaluator<T> (plan, operands.operands (), parallel, budget).evaluate (&result.data () [0], result.size2 (), 1);
+    return result;
+}
+
+template<class T>
+bool check_schedules () {
+    const std::size_t dims [] = { 30, 35, 15, 5, 10, 20, 25 };
+    std::vector<ublas::matrix<T> > a;
+    for (std::size_t k = 0; k < 6; ++ k)
+        a.push_back (make_matrix<ublas::matrix<T> > (dims [k], dims [k + 1], int (k)));
+    ublas::matrix<T> expected (a [0]);
+    for (std::size_t k = 1; k < 6; ++ k) {
+        ublas::matrix<T> next (ublas::prod (expected, a [k]));
+        expected.swap (next);
+    }
+    return same (evaluate (a, false, 1 << 20), expected) &&
+           same (evaluate (a, true, 1 << 20), expected) &&
+           same (evaluate (a, true, 0), expected);
+}
+
+BOOST_UBLAS_TEST_DEF ( test_chain_schedules )
+{
+    BOOST_UBLAS_TEST_CHECK (check_schedules<double> ());
+    BOOST_UBLAS_TEST_CHECK (check_schedules<int> ());
+}
+
+BOOST_UBLAS_TEST_DEF ( test_chain_expressions )
+{
+    typedef ublas::matrix<double> matrix_type;
+    typedef ublas::matrix<double, ublas::column_major> column_matrix_type;
+    matrix_type a (make_matrix<matrix_type> (30, 40, 1)), c (make_matrix<matrix_type> (10, 50, 3));
+    column_matrix_type b (make_matrix<column_matrix_type> (40, 10, 2));
+    ublas::matrix<float> d (make_matrix<ublas::matrix<float> > (50, 20, 4));
+    ublas::c_matrix<double, 20, 20> e (make_matrix<ublas::c_matrix<double, 20, 20> > (20, 20, 5));
+
+    matrix_type ab (ublas::prod (a, b)), abc (ublas::prod (ab, c)), abcd (ublas::prod (abc, matrix_type (d)));
+    matrix_type expected (ublas::prod (abcd, e));
+
+    // Column major operands are read in place, other value types are copied
+    matrix_type result = a * b * c * d * e;
+    BOOST_UBLAS_TEST_CHECK (same (result, expected));
+    matrix_type pair = a * b;
+    BOOST_UBLAS_TEST_CHECK (same (pair, ab));
+}
+
+BOOST_UBLAS_TEST_DEF ( test_chain_leaves )
+{
+    typedef ublas::matrix<double> matrix_type;
+    matrix_type a (make_matrix<matrix_type> (40, 30, 1)), b (make_matrix<matrix_type> (30, 30, 2)),
+                c (make_matrix<matrix_type> (30, 50, 3)), d (make_matrix<matrix_type> (60, 40, 4));
+
+    // Sparse, structured and proxy leaves are copied through their iterators
+    ublas::compressed_matrix<double> s (30, 30);
+    for (std::size_t i = 0; i < 30; ++ i)
+        s (i, (i * 7) % 30) = double (i % 5) - 2.;
+    ublas::triangular_adaptor<matrix_type, ublas::lower> l (b);
+    ublas::banded_matrix<double> band (30, 30, 1, 2);
+    for (std::size_t i = 0; i < 30; ++ i)
+        for (std::size_t j = i > 0 ? i - 1 : 0; j < (std::min) (i + 3, std::size_t (30)); ++ j)
+            band (i, j) = double ((i + j) % 3) + 1.;
+    ublas::matrix_range<matrix_type> r (d, ublas::range (10, 40), ublas::range (5, 35));
+
+    matrix_type sm (s), lm (l), bandm (band), rm (r);
+    matrix_type expected (ublas::prod (a, sm));
+    expected = ublas::prod (expected, lm);
+    expected = ublas::prod (expected, bandm);
+    expected = ublas::prod (expected, rm);
+    expected = ublas::prod (expected, c);
+    matrix_type result = a * s * l * band * r * c;
+    BOOST_UBLAS_TEST_CHECK (same (result, expected));
+    matrix_type as = a * s, sc = s * c;
+    BOOST_UBLAS_TEST_CHECK (same (as, ublas::prod (a, sm)) && same (sc, ublas::prod (sm, c)));
+
+    // The leaves of prod () join the chain
+    detail::chain_plan_cache &cache = detail::chain_plan_cache::instance ();
+    cache.clear ();
+    matrix_type flat = a * ublas::prod (b, c);
+    BOOST_UBLAS_TEST_CHECK (same (flat, ublas::prod (matrix_type (ublas::prod (a, b)), c)));
+    std::vector<std::size_t> dims;
+    dims.push_back (40); dims.push_back (30); dims.push_back (30); dims.push_back (50);
+    cache.find (dims);
+    BOOST_UBLAS_TEST_CHECK (cache.misses () == 1 && cache.hits () == 1);
+
+    // Scalars are not chain operands
+    matrix_type twice = 2. * a, half = a * .5;
+    BOOST_UBLAS_TEST_CHECK (twice (3, 4) == 2. * a (3, 4) && half (3, 4) == .5 * a (3, 4));
+}
+
+// Sparse leaves keep their nonzeros only, whichever kernel multiplies them
+BOOST_UBLAS_TEST_DEF ( test_chain_sparse_leaves )
+{
+    typedef ublas::matrix<double> matrix_type;
+    ublas::compressed_matrix<double> s (200, 300);
+    ublas::compressed_matrix<double, ublas::column_major> t (300, 250);
+    for (std::size_t k = 0; k < 600; ++ k) {
+        s ((k * 7) % 200, (k * 13) % 300) = double (k % 5) - 2.;
+        t ((k * 11) % 300, (k * 3) % 250) = double (k % 3) + 1.;
+    }
+    // Explicit zeros, and a nearly dense leaf of another value type
+    s (1, 1) = 0.;
+    ublas::mapped_matrix<float> f (40, 40);
+    for (std::size_t i = 0; i < 40; ++ i)
+        for (std::size_t j = 0; j < 40; ++ j)
+            if ((i + j) % 9 != 0)
+                f (i, j) = float ((i * 3 + j) % 5) - 2.f;
+    matrix_type a (make_matrix<matrix_type> (10, 200, 1)), c (make_matrix<matrix_type> (250, 10, 2)),
+                d (make_matrix<matrix_type> (40, 30, 3));
+    matrix_type sm (s), tm (t), fm (f);
+
+    detail::chain_operands<double> operands;
+    operands.push_back (s);
+    operands.push_back (t);
+    BOOST_UBLAS_TEST_CHECK (operands.operands () [0].data == 0 && operands.operands () [0].sparse != 0);
+    std::size_t non_zeros = 0;
+    for (std::size_t k = 0; k < s.nnz (); ++ k)
+        non_zeros += s.value_data () [k] != 0.;
+    BOOST_UBLAS_TEST_CHECK (non_zeros < s.nnz () && operands.operands () [0].sparse->value.size () == non_zeros);
+    BOOST_UBLAS_TEST_CHECK (operands.levels () [0] >= 6 && operands.levels () [1] >= 6);
+
+    // Both factors sparse, between dense ones, and nearly dense
+    matrix_type st = s * t;
+    BOOST_UBLAS_TEST_CHECK (same (st, ublas::prod (sm, tm)));
+    matrix_type astc = a * s * t * c;
+    matrix_type expected (ublas::prod (a, sm));
+    expected = ublas::prod (expected, tm);
+    expected = ublas::prod (expected, c);
+    BOOST_UBLAS_TEST_CHECK (same (astc, expected));
+    matrix_type fd = f * d, ff = f * f;
+    BOOST_UBLAS_TEST_CHECK (same (fd, ublas::prod (fm, d)) && same (ff, ublas::prod (fm, fm)));
+
+    // A single sparse operand
+    detail::chain_operands<double> single;
+    single.push_back (s);
+    detail::chain_plan plan (single.dimensions (), single.levels ());
+    matrix_type twice (make_matrix<matrix_type> (200, 300, 4));
+    expected = twice + 2. * sm;
+    detail::chain_evaluator<double> (plan, single.operands (), false).evaluate (&twice.data () [0], 300, 1, 2., 1.);
+    BOOST_UBLAS_TEST_CHECK (same (twice, expected));
+}
+
+template<class M>
+bool check_assignments () {
+    typedef ublas::matrix<double> matrix_type;
+    matrix_type a (make_matrix<matrix_type> (12, 9, 1)), b (make_matrix<matrix_type> (9, 14, 2)),
+                c (make_matrix<matrix_type> (14, 12, 3)), d (make_matrix<matrix_type> (12, 12, 4));
+    const matrix_type abc (ublas::prod (matrix_type (ublas::prod (a, b)), c));
+    bool ok = true;
+
+    M m (make_matrix<M> (12, 12, 5));
+    matrix_type expected (m);
+    m.assign (a * b * c);
+    ok = ok && same (m, abc);
+    m += a * b * c;
+    ok = ok && same (m, matrix_type (abc + abc));
+    m -= d * d;
+    expected = abc + abc - ublas::prod (d, d);
+    ok = ok && same (m, expected);
+    m.plus_assign (d * d);
+    m.minus_assign (a * b * c);
+    ok = ok && same (m, abc);
+
+    // The target is an operand
+    M n (d);
+    n = n * d;
+    ok = ok && same (n, ublas::prod (d, d));
+    n += d * n;
+    expected = ublas::prod (d, d) + ublas::prod (d, matrix_type (ublas::prod (d, d)));
+    ok = ok && same (n, expected);
+
+    // Sums and differences of chains
+    M s = a * b * c + d;
+    ok = ok && same (s, matrix_type (abc + d));
+    M t = a * b * c - d * d;
+    ok = ok && same (t, matrix_type (abc - ublas::prod (d, d)));
+    M u = d - (a * b * c + d * d);
+    ok = ok && same (u, matrix_type (d - abc - ublas::prod (d, d)));
+    M v = d * d + (d - d * d);
+    ok = ok && same (v, d);
+    return ok;
+}
+
+BOOST_UBLAS_TEST_DEF ( test_chain_assignments )
+{
+    BOOST_UBLAS_TEST_CHECK (check_assignments<ublas::matrix<double> > ());
+    BOOST_UBLAS_TEST_CHECK ((check_assignments<ublas::matrix<double, ublas::column_major> > ()));
+    BOOST_UBLAS_TEST_CHECK ((check_assignments<ublas::c_matrix<double, 12, 12> > ()));
+    BOOST_UBLAS_TEST_CHECK ((check_assignments<ublas::bounded_matrix<double, 12, 12> > ()));
+}
+
+BOOST_UBLAS_TEST_DEF ( test_chain_plan_cache )
+{
+    typedef ublas::matrix<double> matrix_type;
+    detail::chain_plan_cache &cache = detail::chain_plan_cache::instance ();
+    cache.clear ();
+
+    matrix_type a (make_matrix<matrix_type> (6, 4, 1)), b (make_matrix<matrix_type> (4, 5, 2)),
+                c (make_matrix<matrix_type> (5, 3, 3));
+    matrix_type expected (ublas::prod (matrix_type (ublas::prod (a, b)), c));
+    matrix_type first = a * b * c;
+    matrix_type second = a * b * c;
+    BOOST_UBLAS_TEST_CHECK (same (first, expected) && same (second, expected));
+    BOOST_UBLAS_TEST_CHECK (cache.misses () == 1 && cache.hits () == 1 && cache.size () == 1);
+
+    // Same dimensions, different operands
+    matrix_type d (make_matrix<matrix_type> (5, 3, 4));
+    matrix_type third = a * b * d;
+    BOOST_UBLAS_TEST_CHECK (same (third, ublas::prod (matrix_type (ublas::prod (a, b)), d)));
+    BOOST_UBLAS_TEST_CHECK (cache.misses () == 1 && cache.hits () == 2);
+
+    // A new shape is planned and the plans are shared
+    matrix_type ab = a * b;
+    BOOST_UBLAS_TEST_CHECK (same (ab, ublas::prod (a, b)));
+    BOOST_UBLAS_TEST_CHECK (cache.misses () == 2 && cache.size () == 2);
+    std::vector<std::size_t> dims;
+    dims.push_back (6); dims.push_back (4); dims.push_back (5);
+    BOOST_UBLAS_TEST_CHECK (cache.find (dims) == cache.find (dims));
+
+    // The cache holds at most BOOST_UBLAS_CHAIN_PLAN_CACHE_SIZE plans
+    for (std::size_t n = 1; n <= 10; ++ n) {
+        dims [2] = n;
+        detail::chain_plan_cache::plan_pointer plan = cache.find (dims);
+        BOOST_UBLAS_TEST_CHECK (plan->columns (1) == n);
+        BOOST_UBLAS_TEST_CHECK (cache.size () <= 4);
+    }
+
+    cache.clear ();
+    BOOST_UBLAS_TEST_CHECK (cache.hits () == 0 && cache.misses () == 0 && cache.size () == 0);
+}
+
+int main () {
+    BOOST_UBLAS_TEST_BEGIN();
+
+    BOOST_UBLAS_TEST_DO( test_chain_plan );
+    BOOST_UBLAS_TEST_DO( test_chain_sparse_plan );
+    BOOST_UBLAS_TEST_DO( test_chain_schedules );
+    BOOST_UBLAS_TEST_DO( test_chain_expressions );
+    BOOST_UBLAS_TEST_DO( test_chain_leaves );
+    BOOST_UBLAS_TEST_DO( test_chain_sparse_leaves );
+    BOOST_UBLAS_TEST_DO( test_chain_assignments );
+    BOOST_UBLAS_TEST_DO( test_chain_plan_cache );
+
+    BOOST_UBLAS_TEST_END();
+}
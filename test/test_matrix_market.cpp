@@ -0,0 +1,259 @@
+// Copyright (c) 2017 uBLAS developers
+// Distributed under the Boost Software License, Version 1.0. (See
+// accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+
+// A small pool, small chunks and small blocks so that files are read in many
+// chunks, each parsed by several threads
+#define BOOST_UBLAS_THREADS 4
+#define BOOST_UBLAS_TEXT_BLOCK_SIZE 16
+#define BOOST_UBLAS_MATRIX_MARKET_CHUNK 256
+
+#include <clocale>
+#include <complex>
+#include <sstream>
+#include <string>
+
+#include <boost/numeric/ublas/matrix_market.hpp>
+
+#include "utils.hpp"
+
+namespace ublas = boost::numeric::ublas;
+
+typedef std::complex<double> complex_type;
+
+template<class M1, class M2>
+bool same (const M1 &a, const M2 &b) {
+    bool result = a.size1 () == b.size1 () && a.size2 () == b.size2 ();
+    for (std::size_t i = 0; result && i < a.size1 (); ++ i)
+        for (std::size_t j = 0; result && j < a.size2 (); ++ j)
+            result = a (i, j) == b (i, j);
+    return result;
+}
+
+// Reads text into a dense, a compressed and a coordinate matrix, which all
+// have to equal expected
+template<class T>
+bool check_read (const std::string &text, const ublas::matrix<T> &expected) {
+    std::istringstream ds (text), cs (text), os (text);
+    ublas::matrix<T> d;
+    ublas::compressed_matrix<T> c;
+    ublas::coordinate_matrix<T, ublas::column_major> o;
+    ublas::read_matrix_market (ds, d);
+    ublas::read_matrix_market (cs, c);
+    ublas::read_matrix_market (os, o);
+    return ds && cs && os && same (d, expected) && same (c, expected) && same (o, expected);
+}
+
+// Reading fails and leaves the matrix alone
+template<class T>
+bool check_fail (const std::string &text) {
+    std::istringstream ds (text), cs (text), os (text);
+    ublas::matrix<T> d (1, 1, T (7));
+    ublas::compressed_matrix<T> c (1, 1);
+    ublas::coordinate_matrix<T> o (1, 1);
+    c (0, 0) = T (7);
+    o (0, 0) = T (7);
+    ublas::read_matrix_market (ds, d);
+    ublas::read_matrix_market (cs, c);
+    ublas::read_matrix_market (os, o);
+    return ds.fail () && cs.fail () && os.fail () && d (0, 0) == T (7) && c (0, 0) == T (7) && o (0, 0) == T (7);
+}
+
+BOOST_UBLAS_TEST_DEF ( test_matrix_market_coordinate )
+{
+    ublas::matrix<double> m (3, 4, 0.0);
+    m (0, 0) = 1.5;
+    m (2, 1) = -2.0;
+    m (1, 3) = 1e-3;
+    BOOST_UBLAS_TEST_CHECK (check_read ("%%MatrixMarket matrix coordinate real general\n"
+                                        "% a comment\n"
+                                        "\n"
+                                        "3 4 3\n"
+                                        "1 1 1.5\n"
+                                        "3 2 -2\n"
+                                        "2 4 1e-3\n", m));
+    // Case insensitive banner, carriage returns, no final line end, and
+    // duplicates summed
+    BOOST_UBLAS_TEST_CHECK (check_read ("%%MatrixMarket MATRIX Coordinate Real General\r\n"
+                                        "3 4 4\r\n"
+                                        "1 1 1\r\n"
+                                        "3 2 -2\r\n"
+                                        "2 4 1e-3\r\n"
+                                        "1 1 0.5", m));
+
+    ublas::matrix<int> p (2, 3, 0);
+    p (0, 2) = 1;
+    p (1, 0) = 1;
+    BOOST_UBLAS_TEST_CHECK (check_read ("%%MatrixMarket matrix coordinate pattern general\n2 3 2\n1 3\n2 1\n", p));
+    BOOST_UBLAS_TEST_CHECK (check_read ("%%MatrixMarket matrix coordinate integer general\n2 3 2\n1 3 1\n2 1 1\n", p));
+
+    // More entries than elements
+    std::string duplicates ("%%MatrixMarket matrix coordinate real general\n2 2 12\n");
+    for (std::size_t k = 0; k < 12; ++ k)
+        duplicates += "1 1 1.0\n";
+    ublas::matrix<double> d (2, 2, 0.0);
+    d (0, 0) = 12;
+    BOOST_UBLAS_TEST_CHECK (check_read (duplicates, d));
+
+    ublas::matrix<complex_type> c (2, 2, complex_type ());
+    c (0, 1) = complex_type (1, -2);
+    c (1, 1) = complex_type (0, 3);
+    BOOST_UBLAS_TEST_CHECK (check_read ("%%MatrixMarket matrix coordinate complex general\n2 2 2\n1 2 1 -2\n2 2 0 3\n", c));
+    // Real files read into complex matrices
+    c (0, 1) = complex_type (1, 0);
+    c (1, 1) = complex_type (3, 0);
+    BOOST_UBLAS_TEST_CHECK (check_read ("%%MatrixMarket matrix coordinate real general\n2 2 2\n1 2 1\n2 2 3\n", c));
+}
+
+BOOST_UBLAS_TEST_DEF ( test_matrix_market_array )
+{
+    ublas::matrix<double> m (2, 3);
+    m (0, 0) = 1;  m (0, 1) = 0;  m (0, 2) = 5;
+    m (1, 0) = 2;  m (1, 1) = -4; m (1, 2) = 0;
+    // By columns
+    BOOST_UBLAS_TEST_CHECK (check_read ("%%MatrixMarket matrix array real general\n2 3\n1\n2\n0\n-4\n5\n0\n", m));
+
+    ublas::matrix<double> s (3, 3);
+    s (0, 0) = 1; s (0, 1) = 2; s (0, 2) = 3;
+    s (1, 0) = 2; s (1, 1) = 4; s (1, 2) = 5;
+    s (2, 0) = 3; s (2, 1) = 5; s (2, 2) = 6;
+    BOOST_UBLAS_TEST_CHECK (check_read ("%%MatrixMarket matrix array real symmetric\n3 3\n1\n2\n3\n4\n5\n6\n", s));
+}
+
+// The upper triangle of symmetric, skew-symmetric and hermitian files
+BOOST_UBLAS_TEST_DEF ( test_matrix_market_symmetry )
+{
+    ublas::matrix<double> s (3, 3, 0.0);
+    s (0, 0) = 1;
+    s (2, 0) = s (0, 2) = 2;
+    s (2, 1) = s (1, 2) = -3;
+    BOOST_UBLAS_TEST_CHECK (check_read ("%%MatrixMarket matrix coordinate real symmetric\n3 3 3\n1 1 1\n3 1 2\n3 2 -3\n", s));
+
+    ublas::matrix<double> k (3, 3, 0.0);
+    k (1, 0) = 4;  k (0, 1) = -4;
+    k (2, 0) = 5;  k (0, 2) = -5;
+    k (2, 1) = 6;  k (1, 2) = -6;
+    BOOST_UBLAS_TEST_CHECK (check_read ("%%MatrixMarket matrix coordinate real skew-symmetric\n3 3 3\n2 1 4\n3 2 6\n3 1 5\n", k));
+    BOOST_UBLAS_TEST_CHECK (check_read ("%%MatrixMarket matrix array real skew-symmetric\n3 3\n4\n5\n6\n", k));
+
+    // Mirrored entries count twice towards the elements
+    std::string duplicates ("%%MatrixMarket matrix coordinate real symmetric\n2 2 6\n");
+    for (std::size_t n = 0; n < 6; ++ n)
+        duplicates += "2 1 0.5\n";
+    ublas::matrix<double> d (2, 2, 0.0);
+    d (1, 0) = d (0, 1) = 3;
+    BOOST_UBLAS_TEST_CHECK (check_read (duplicates, d));
+
+    ublas::matrix<complex_type> h (2, 2, complex_type ());
+    h (0, 0) = complex_type (2, 0);
+    h (1, 0) = complex_type (1, 3);
+    h (0, 1) = complex_type (1, -3);
+    BOOST_UBLAS_TEST_CHECK (check_read ("%%MatrixMarket matrix coordinate complex hermitian\n2 2 2\n1 1 2 0\n2 1 1 3\n", h));
+}
+
+BOOST_UBLAS_TEST_DEF ( test_matrix_market_errors )
+{
+    const char *bad [] = {
+        "", "%%MatrixMarket matrix\n", "%MatrixMarket matrix coordinate real general\n1 1 1\n1 1 1\n",
+        "%%MatrixMarket vector coordinate real general\n1 1 1\n1 1 1\n",
+        "%%MatrixMarket matrix coordinate real general\n",
+        "%%MatrixMarket matrix coordinate real general\n2 2\n1 1 1\n",
+        "%%MatrixMarket matrix coordinate real general\n2 2 2 2\n1 1 1\n2 2 1\n",
+        // Too few and too many entries
+        "%%MatrixMarket matrix coordinate real general\n2 2 2\n1 1 1\n",
+        "%%MatrixMarket matrix coordinate real general\n2 2 1\n1 1 1\n2 2 1\n",
+        "%%MatrixMarket matrix array real general\n2 2\n1\n2\n3\n",
+        // Out of range, malformed and missing values
+        "%%MatrixMarket matrix coordinate real general\n2 2 1\n3 1 1\n",
+        "%%MatrixMarket matrix coordinate real general\n2 2 1\n0 1 1\n",
+        "%%MatrixMarket matrix coordinate real general\n2 2 1\n1 1 x\n",
+        "%%MatrixMarket matrix coordinate real general\n2 2 1\n1 1 1x\n",
+        "%%MatrixMarket matrix coordinate real general\n2 2 1\n1 1\n",
+        // Combinations the format excludes
+        "%%MatrixMarket matrix array pattern general\n1 1\n1\n",
+        "%%MatrixMarket matrix coordinate real hermitian\n1 1 1\n1 1 1\n",
+        "%%MatrixMarket matrix coordinate real symmetric\n2 3 1\n1 1 1\n",
+        "%%MatrixMarket matrix coordinate real unknown\n1 1 1\n1 1 1\n",
+        // Complex values for a real matrix
+        "%%MatrixMarket matrix coordinate complex general\n1 1 1\n1 1 1 0\n"
+    };
+    for (std::size_t k = 0; k < sizeof (bad) / sizeof (bad [0]); ++ k)
+        BOOST_UBLAS_TEST_CHECK (check_fail<double> (bad [k]));
+    // Real values for an integer matrix
+    BOOST_UBLAS_TEST_CHECK (check_fail<int> ("%%MatrixMarket matrix coordinate real general\n1 1 1\n1 1 1.5\n"));
+}
+
+// Writing and reading back gives the same values, in both formats and in files
+// of many chunks
+template<class M>
+bool check_round_trip (const M &m) {
+    std::stringstream s;
+    ublas::write_matrix_market (s, m);
+    M r;
+    ublas::read_matrix_market (s, r);
+    return s && same (m, r);
+}
+
+BOOST_UBLAS_TEST_DEF ( test_matrix_market_round_trip )
+{
+    ublas::matrix<double> d (41, 29);
+    ublas::compressed_matrix<double> c (300, 200);
+    ublas::coordinate_matrix<complex_type> o (50, 60);
+    for (std::size_t i = 0; i < d.size1 (); ++ i)
+        for (std::size_t j = 0; j < d.size2 (); ++ j)
+            d (i, j) = (double (i) - 20.0) / double (j + 3);
+    for (std::size_t k = 0; k < 2000; ++ k)
+        c ((k * 37) % 300, (k * 101 + k / 7) % 200) = 1.0 / double (k + 1);
+    for (std::size_t k = 0; k < 300; ++ k)
+        o ((k * 7) % 50, (k * 11) % 60) = complex_type (double (k) / 3.0, -1e-20 * double (k));
+    BOOST_UBLAS_TEST_CHECK (check_round_trip (d));
+    BOOST_UBLAS_TEST_CHECK (check_round_trip (c));
+    BOOST_UBLAS_TEST_CHECK (check_round_trip (o));
+    BOOST_UBLAS_TEST_CHECK (check_round_trip (ublas::matrix<int> (3, 2, -12)));
+    BOOST_UBLAS_TEST_CHECK (check_round_trip (ublas::compressed_matrix<double> (0, 0)));
+
+    std::ostringstream os;
+    ublas::compressed_matrix<double> e (2, 3);
+    e (1, 2) = 0.5;
+    ublas::write_matrix_market (os, e);
+    BOOST_UBLAS_TEST_CHECK (os.str () == "%%MatrixMarket matrix coordinate real general\n2 3 1\n2 3 0.5\n");
+    std::ostringstream as;
+    ublas::write_matrix_market (as, ublas::matrix<int> (2, 1, 3));
+    BOOST_UBLAS_TEST_CHECK (as.str () == "%%MatrixMarket matrix array integer general\n2 1\n3\n3\n");
+}
+
+// A C library locale with a decimal comma does not change the files; nothing
+// is checked where no such locale is installed
+BOOST_UBLAS_TEST_DEF ( test_matrix_market_c_locale )
+{
+    const char *names [] = {"de_DE.UTF-8", "de_DE.utf8", "de_DE", "fr_FR.UTF-8", "fr_FR.utf8", "fr_FR"};
+    bool comma = false;
+    for (std::size_t k = 0; ! comma && k < sizeof (names) / sizeof (names [0]); ++ k)
+        comma = std::setlocale (LC_NUMERIC, names [k]) && std::localeconv ()->decimal_point [0] == ',';
+    if (comma) {
+        ublas::matrix<double> m (2, 2, 0.0);
+        m (0, 1) = 1.5;
+        m (1, 0) = -2.25e-3;
+        BOOST_UBLAS_TEST_CHECK (check_read ("%%MatrixMarket matrix coordinate real general\n2 2 2\n1 2 1.5\n2 1 -2.25e-3\n", m));
+        std::ostringstream os;
+        ublas::compressed_matrix<double> e (2, 3);
+        e (1, 2) = 0.5;
+        ublas::write_matrix_market (os, e);
+        BOOST_UBLAS_TEST_CHECK (os.str () == "%%MatrixMarket matrix coordinate real general\n2 3 1\n2 3 0.5\n");
+    }
+    std::setlocale (LC_NUMERIC, "C");
+}
+
+int main () {
+    BOOST_UBLAS_TEST_BEGIN();
+
+    BOOST_UBLAS_TEST_DO( test_matrix_market_coordinate );
+    BOOST_UBLAS_TEST_DO( test_matrix_market_array );
+    BOOST_UBLAS_TEST_DO( test_matrix_market_symmetry );
+    BOOST_UBLAS_TEST_DO( test_matrix_market_errors );
+    BOOST_UBLAS_TEST_DO( test_matrix_market_round_trip );
+    BOOST_UBLAS_TEST_DO( test_matrix_market_c_locale );
+
+    BOOST_UBLAS_TEST_END();
+}
@@ -0,0 +1,209 @@
+// Copyright (c) 2017 uBLAS developers
+// Distributed under the Boost Software License, Version 1.0. (See
+// accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+
+// Small pool and threshold so that the tests run the multithreaded paths
+#define BOOST_UBLAS_THREADS 4
+#define BOOST_UBLAS_PARALLEL_THRESHOLD 64
+
+#include <stdexcept>
+#include <vector>
+
+#include <boost/numeric/ublas/matrix.hpp>
+#include <boost/numeric/ublas/matrix_proxy.hpp>
+#include <boost/numeric/ublas/matrix_sparse.hpp>
+#include <boost/numeric/ublas/vector_proxy.hpp>
+
+#include "utils.hpp"
+
+namespace ublas = boost::numeric::ublas;
+
+template<class M>
+M make_matrix (std::size_t size1, std::size_t size2, int seed) {
+    M m (size1, size2);
+    for (std::size_t i = 0; i < size1; ++ i)
+        for (std::size_t j = 0; j < size2; ++ j)
+            m (i, j) = double ((seed + i * 5 + j * 3) % 17) - 8.0;
+    return m;
+}
+
+ublas::vector<double> make_vector (std::size_t size, int seed) {
+    ublas::vector<double> v (size);
+    for (std::size_t i = 0; i < size; ++ i)
+        v (i) = double ((seed + i * 7) % 13) - 6.0;
+    return v;
+}
+
+template<class M1, class M2>
+bool same (const M1 &m1, const M2 &m2) {
+    if (m1.size1 () != m2.size1 () || m1.size2 () != m2.size2 ())
+        return false;
+    for (std::size_t i = 0; i < m1.size1 (); ++ i)
+        for (std::size_t j = 0; j < m1.size2 (); ++ j)
+            if (m1 (i, j) != m2 (i, j))
+                return false;
+    return true;
+}
+
+// a * m, spelled through matrix_expression so that the matrix chain operator *
+// does not apply
+template<class M>
+typename ublas::matrix_binary_scalar1_traits<const double, M, ublas::scalar_multiplies<double, double> >::result_type
+scaled (const double &a, const M &m) {
+    return a * static_cast<const ublas::matrix_expression<M> &> (m);
+}
+
+template<class M>
+bool check_elementwise () {
+    const std::size_t size1 = 67, size2 = 45;
+    M a (make_matrix<M> (size1, size2, 1)), b (make_matrix<M> (size1, size2, 2)),
+      d (make_matrix<M> (size1, size2, 3)), e (make_matrix<M> (size1, size2, 4));
+    M serial (size1, size2), parallel (size1, size2);
+
+    ublas::noalias (serial) = scaled (2.0, a) + scaled (-3.0, b) - ublas::element_prod (d, e);
+    ublas::parallel (ublas::noalias (parallel)) = scaled (2.0, a) + scaled (-3.0, b) - ublas::element_prod (d, e);
+    if (! same (serial, parallel))
+        return false;
+
+    ublas::noalias (serial) += ublas::element_prod (a, b);
+    ublas::parallel (ublas::noalias (parallel)) += ublas::element_prod (a, b);
+    ublas::noalias (serial) -= d;
+    ublas::parallel (ublas::noalias (parallel)) -= d;
+    return same (serial, parallel);
+}
+
+BOOST_UBLAS_TEST_DEF ( test_parallel_row_major )
+{
+    BOOST_UBLAS_TEST_CHECK (check_elementwise<ublas::matrix<double> > ());
+}
+
+BOOST_UBLAS_TEST_DEF ( test_parallel_column_major )
+{
+    BOOST_UBLAS_TEST_CHECK ((check_elementwise<ublas::matrix<double, ublas::column_major> > ()));
+}
+
+BOOST_UBLAS_TEST_DEF ( test_parallel_proxies )
+{
+    typedef ublas::matrix<double> matrix_type;
+    matrix_type a (make_matrix<matrix_type> (40, 30, 5));
+    matrix_type serial (make_matrix<matrix_type> (50, 50, 6)), parallel (serial);
+    ublas::range r1 (5, 45), r2 (10, 40);
+
+    ublas::noalias (ublas::project (serial, r1, r2)) = ublas::trans (ublas::trans (a)) + a;
+    ublas::parallel (ublas::noalias (ublas::project (parallel, r1, r2))) = ublas::trans (ublas::trans (a)) + a;
+    BOOST_UBLAS_TEST_CHECK (same (serial, parallel));
+
+    // Rows of a matrix vector product
+    ublas::vector<double> x (make_vector (30, 7)), y_serial (100), y_parallel (100);
+    matrix_type b (make_matrix<matrix_type> (100, 30, 8));
+    ublas::noalias (y_serial) = ublas::prod (b, x);
+    ublas::parallel (ublas::noalias (y_parallel)) = ublas::prod (b, x);
+    BOOST_UBLAS_TEST_CHECK (ublas::norm_inf (y_serial - y_parallel) == 0);
+}
+
+BOOST_UBLAS_TEST_DEF ( test_parallel_vector )
+{
+    ublas::vector<double> x (make_vector (1001, 1)), y (make_vector (1001, 2));
+    ublas::vector<double> serial (make_vector (1001, 3)), parallel (serial);
+
+    ublas::noalias (serial) = ublas::element_prod (x, y) - x;
+    ublas::parallel (ublas::noalias (parallel)) = ublas::element_prod (x, y) - x;
+    BOOST_UBLAS_TEST_CHECK (ublas::norm_inf (serial - parallel) == 0);
+
+    ublas::noalias (serial) += y;
+    ublas::parallel (ublas::noalias (parallel)) += y;
+    ublas::noalias (ublas::subrange (serial, 100, 900)) -= ublas::subrange (x, 0, 800);
+    ublas::parallel (ublas::noalias (ublas::subrange (parallel, 100, 900))) -= ublas::subrange (x, 0, 800);
+    BOOST_UBLAS_TEST_CHECK (ublas::norm_inf (serial - parallel) == 0);
+}
+
+BOOST_UBLAS_TEST_DEF ( test_parallel_serial_fallbacks )
+{
+    typedef ublas::matrix<double> matrix_type;
+    matrix_type a (make_matrix<matrix_type> (20, 20, 1)), b (make_matrix<matrix_type> (20, 20, 2));
+
+    // Below the threshold
+    matrix_type small (make_matrix<matrix_type> (4, 4, 3)), expected (small);
+    matrix_type d (make_matrix<matrix_type> (4, 4, 4));
+    ublas::noalias (expected) += d;
+    ublas::parallel (ublas::noalias (small)) += d;
+    BOOST_UBLAS_TEST_CHECK (same (small, expected));
+
+    // Products keep the packed kernel
+    matrix_type c_serial (20, 20), c_parallel (20, 20);
+    ublas::noalias (c_serial) = ublas::prod (a, b);
+    ublas::parallel (ublas::noalias (c_parallel)) = ublas::prod (a, b);
+    BOOST_UBLAS_TEST_CHECK (same (c_serial, c_parallel));
+
+    // Sparse storage
+    ublas::compressed_matrix<double> s_serial (20, 20), s_parallel (20, 20);
+    ublas::noalias (s_serial) = a;
+    ublas::parallel (ublas::noalias (s_parallel)) = a;
+    BOOST_UBLAS_TEST_CHECK (same (s_serial, s_parallel));
+}
+
+// Records which indices a parallel loop covered
+struct cover {
+    std::vector<int> *hits;
+
+    void operator () (std::size_t first, std::size_t last) const {
+        for (std::size_t i = first; i < last; ++ i)
+            ++ (*hits) [i];
+    }
+};
+
+// Runs a parallel loop inside every chunk
+struct nested_cover {
+    std::vector<int> *hits;
+
+    void operator () (std::size_t first, std::size_t last) const {
+        cover c = { hits };
+        ublas::detail::thread_pool::instance ().parallel_for (first, last, 1, c);
+    }
+};
+
+struct throwing {
+    void operator () (std::size_t first, std::size_t last) const {
+        if (first <= 50 && 50 < last)
+            throw std::runtime_error ("chunk failed");
+    }
+};
+
+BOOST_UBLAS_TEST_DEF ( test_thread_pool )
+{
+    ublas::detail::thread_pool &pool = ublas::detail::thread_pool::instance ();
+    BOOST_UBLAS_TEST_CHECK (pool.size () == 4);
+
+    std::vector<int> hits (1000, 0);
+    cover c = { &hits };
+    for (int k = 0; k < 20; ++ k)
+        pool.parallel_for (0, hits.size (), 7, c);
+    nested_cover n = { &hits };
+    pool.parallel_for (0, hits.size (), 1, n);
+    bool once = true;
+    for (std::size_t i = 0; i < hits.size (); ++ i)
+        once = once && hits [i] == 21;
+    BOOST_UBLAS_TEST_CHECK (once);
+
+    bool thrown = false;
+    try {
+        pool.parallel_for (0, 100, 1, throwing ());
+    } catch (const std::runtime_error &) {
+        thrown = true;
+    }
+    BOOST_UBLAS_TEST_CHECK (thrown);
+}
+
+int main () {
+    BOOST_UBLAS_TEST_BEGIN();
+
+    BOOST_UBLAS_TEST_DO( test_parallel_row_major );
+    BOOST_UBLAS_TEST_DO( test_parallel_column_major );
+    BOOST_UBLAS_TEST_DO( test_parallel_proxies );
+    BOOST_UBLAS_TEST_DO( test_parallel_vector );
+    BOOST_UBLAS_TEST_DO( test_parallel_serial_fallbacks );
+    BOOST_UBLAS_TEST_DO( test_thread_pool );
+
+    BOOST_UBLAS_TEST_END();
+}
@@ -0,0 +1,143 @@
+// Copyright (c) 2017 uBLAS developers
+// Distributed under the Boost Software License, Version 1.0. (See
+// accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+
+// Narrow panels, a small pool and a low threshold so that the blocked
+// factorization runs many panels and splits its updates across threads, and
+// tall problems take the TSQR path
+#define BOOST_UBLAS_THREADS 4
+#define BOOST_UBLAS_FACTORIZE_BLOCK 16
+#define BOOST_UBLAS_FACTORIZE_PARALLEL_COST 1024
+
+#include <cmath>
+#include <complex>
+#include <limits>
+#include <vector>
+
+#include <boost/numeric/ublas/matrix.hpp>
+#include <boost/numeric/ublas/matrix_proxy.hpp>
+#include <boost/numeric/ublas/qr.hpp>
+
+#include "utils.hpp"
+#include "common/random.hpp"
+
+namespace ublas = boost::numeric::ublas;
+
+typedef std::complex<double> complex_type;
+
+template<class M>
+M make_matrix (std::size_t size1, std::size_t size2, unsigned seed) {
+    M m (size1, size2);
+    for (std::size_t i = 0; i < size1; ++ i)
+        for (std::size_t j = 0; j < size2; ++ j)
+            assign_random (m (i, j), seed);
+    return m;
+}
+
+const double epsilon = std::numeric_limits<double>::epsilon ();
+
+// Q^H A = R: applying Q^H to the original matrix reproduces the factor
+template<class M>
+bool check_factorization (std::size_t size1, std::size_t size2) {
+    typedef typename M::value_type value_type;
+    const M a (make_matrix<M> (size1, size2, unsigned (size1 + size2)));
+    M qr (a);
+    ublas::vector<value_type> tau;
+    ublas::qr_factorize (qr, tau);
+    if (tau.size () != (std::min) (size1, size2))
+        return false;
+    M r (a);
+    ublas::qr_apply_adjoint (qr, tau, r);
+    double error = 0.0;
+    for (std::size_t i = 0; i < size1; ++ i)
+        for (std::size_t j = 0; j < size2; ++ j) {
+            const value_type expected = j >= i ? value_type (qr (i, j)) : value_type ();
+            error = (std::max) (error, std::abs (r (i, j) - expected));
+        }
+    return error / ublas::norm_inf (a) < 10.0 * double (size1) * epsilon;
+}
+
+BOOST_UBLAS_TEST_DEF ( test_qr_factorize )
+{
+    BOOST_UBLAS_TEST_CHECK (check_factorization<ublas::matrix<double> > (150, 70));
+    BOOST_UBLAS_TEST_CHECK ((check_factorization<ublas::matrix<double, ublas::column_major> > (97, 97)));
+    // Wide, and complex
+    BOOST_UBLAS_TEST_CHECK (check_factorization<ublas::matrix<double> > (40, 90));
+    BOOST_UBLAS_TEST_CHECK (check_factorization<ublas::matrix<complex_type> > (83, 50));
+    // No raw storage: factored through a copy
+    BOOST_UBLAS_TEST_CHECK ((check_factorization<ublas::matrix<double, ublas::row_major, std::vector<double> > > (60, 35)));
+}
+
+// A range of a larger matrix is factored in place, the rest left alone
+BOOST_UBLAS_TEST_DEF ( test_qr_range )
+{
+    typedef ublas::matrix<double> matrix_type;
+    matrix_type big (make_matrix<matrix_type> (130, 80, 3));
+    const matrix_type original (big);
+    ublas::matrix_range<matrix_type> part (big, ublas::range (10, 120), ublas::range (5, 65));
+    matrix_type copy (part);
+    ublas::vector<double> tau_part, tau_copy;
+    ublas::qr_factorize (part, tau_part);
+    ublas::qr_factorize (copy, tau_copy);
+    BOOST_UBLAS_TEST_CHECK_EQ (ublas::norm_inf (matrix_type (part) - copy), 0.0);
+    BOOST_UBLAS_TEST_CHECK_EQ (ublas::norm_inf (tau_part - tau_copy), 0.0);
+    bool untouched = true;
+    for (std::size_t i = 0; i < big.size1 (); ++ i)
+        for (std::size_t j = 0; j < big.size2 (); ++ j)
+            if (i < 10 || i >= 120 || j < 5 || j >= 65)
+                untouched = untouched && big (i, j) == original (i, j);
+    BOOST_UBLAS_TEST_CHECK (untouched);
+}
+
+// The residual of a least squares solution is orthogonal to the columns of A
+template<class T>
+bool check_least_squares (std::size_t size1, std::size_t size2, std::size_t rhs) {
+    typedef ublas::matrix<T> matrix_type;
+    const matrix_type a (make_matrix<matrix_type> (size1, size2, unsigned (size1 * 3 + size2)));
+    const matrix_type b (make_matrix<matrix_type> (size1, rhs, unsigned (size1 + rhs)));
+    const matrix_type x (ublas::least_squares_solve (a, b));
+    if (x.size1 () != size2 || x.size2 () != rhs)
+        return false;
+    const matrix_type residual (b - ublas::prod (a, x));
+    const matrix_type normal (ublas::prod (ublas::herm (a), residual));
+    return ublas::norm_inf (normal) / (ublas::norm_inf (a) * ublas::norm_inf (a) * ublas::norm_inf (x) + ublas::norm_inf (a) * ublas::norm_inf (b)) < 10.0 * double (size1) * epsilon;
+}
+
+BOOST_UBLAS_TEST_DEF ( test_least_squares )
+{
+    // Square, moderately tall and tall enough for TSQR
+    BOOST_UBLAS_TEST_CHECK (check_least_squares<double> (60, 60, 3));
+    BOOST_UBLAS_TEST_CHECK (check_least_squares<double> (200, 90, 20));
+    BOOST_UBLAS_TEST_CHECK (check_least_squares<double> (2000, 30, 5));
+    BOOST_UBLAS_TEST_CHECK (check_least_squares<double> (1003, 17, 1));
+    BOOST_UBLAS_TEST_CHECK (check_least_squares<complex_type> (700, 20, 4));
+}
+
+// Consistent systems are solved exactly, whichever path is taken
+BOOST_UBLAS_TEST_DEF ( test_least_squares_exact )
+{
+    typedef ublas::matrix<double> matrix_type;
+    for (std::size_t size1 = 100; size1 <= 3000; size1 *= 30) {
+        const matrix_type a (make_matrix<matrix_type> (size1, 25, 7));
+        const ublas::vector<double> x (ublas::column (make_matrix<matrix_type> (25, 1, 8), 0));
+        const ublas::vector<double> b (ublas::prod (a, x));
+        const ublas::vector<double> solution (ublas::least_squares_solve (a, b));
+        BOOST_UBLAS_TEST_CHECK (ublas::norm_inf (solution - x) < 1e-12);
+        // A range of the matrix works the same
+        const ublas::vector<double> range_solution (ublas::least_squares_solve (
+            ublas::project (a, ublas::range (0, size1), ublas::range (0, 25)), b));
+        BOOST_UBLAS_TEST_CHECK_EQ (ublas::norm_inf (range_solution - solution), 0.0);
+    }
+}
+
+int main () {
+    BOOST_UBLAS_TEST_BEGIN();
+
+    BOOST_UBLAS_TEST_DO( test_qr_factorize );
+    BOOST_UBLAS_TEST_DO( test_qr_range );
+    BOOST_UBLAS_TEST_DO( test_least_squares );
+    BOOST_UBLAS_TEST_DO( test_least_squares_exact );
+
+    BOOST_UBLAS_TEST_END();
+}
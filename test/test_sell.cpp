@@ -0,0 +1,248 @@
+// Copyright (c) 2017 uBLAS developers
+// Distributed under the Boost Software License, Version 1.0. (See
+// accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+
+// A small pool and a low threshold so that the products split their chunks
+// across threads
+#define BOOST_UBLAS_THREADS 4
+#define BOOST_UBLAS_SPARSE_PARALLEL_NNZ 64
+
+#include <cmath>
+#include <complex>
+#include <limits>
+#include <vector>
+
+#include <boost/numeric/ublas/matrix.hpp>
+#include <boost/numeric/ublas/matrix_sparse.hpp>
+#include <boost/numeric/ublas/vector.hpp>
+#include <boost/numeric/ublas/operation.hpp>
+
+#include "utils.hpp"
+#include "common/random.hpp"
+
+namespace ublas = boost::numeric::ublas;
+
+using ublas::test::detail::vector_close_to;
+
+typedef std::complex<double> complex_type;
+
+// Row lengths from empty to dense, so that the chunks need padding and the
+// sorting matters
+template<class M>
+M make_sparse (std::size_t size1, std::size_t size2, unsigned seed) {
+    M m (size1, size2);
+    for (std::size_t i = 0; i + 3 < size1; ++ i) {
+        const std::size_t length = i % 13 == 0 ? size2 : (i * 7) % 11;
+        for (std::size_t k = 0; k < length; ++ k) {
+            typename M::value_type t;
+            assign_random (t, seed);
+            m (i, (k * 37 + i) % size2) = t;
+        }
+    }
+    return m;
+}
+
+// prod and axpy_prod against the dense product
+template<class T, std::size_t C>
+bool check_products (std::size_t size1, std::size_t size2, std::size_t sigma, double tolerance = 1e-12) {
+    typedef ublas::compressed_matrix<T> compressed_type;
+    const compressed_type c (make_sparse<compressed_type> (size1, size2, unsigned (size1)));
+    const ublas::sliced_ell_matrix<T, C> a (c, sigma);
+    const ublas::matrix<T> d (c);
+    const ublas::vector<T> x (make_vector<T> (size2, 1)), y (make_vector<T> (size1, 2));
+    const ublas::vector<T> ax (ublas::prod (d, x));
+
+    bool result = a.nnz () == c.nnz ();
+    const ublas::vector<T> v (ublas::prod (a, x));
+    result = result && vector_close_to (v, ax, size1, tolerance);
+
+    // Accumulating and with an expression as the vector operand, against
+    // the product just checked, since y + ax can cancel below the tolerance
+    const ublas::vector<T> y_plus_v (y + v), y_minus_v (y_plus_v - T (2) * v), two_v (T (2) * v);
+    ublas::vector<T> u (y);
+    ublas::noalias (u) += ublas::prod (a, x);
+    result = result && vector_close_to (u, y_plus_v, size1, tolerance);
+    ublas::noalias (u) -= ublas::prod (a, T (2) * x);
+    result = result && vector_close_to (u, y_minus_v, size1, tolerance);
+
+    ublas::vector<T> s (size1);
+    ublas::axpy_prod (a, x, s, true);
+    result = result && vector_close_to (s, v, size1, tolerance);
+    ublas::axpy_prod (a, x, s, false);
+    result = result && vector_close_to (s, two_v, size1, tolerance);
+    return result;
+}
+
+BOOST_UBLAS_TEST_DEF ( test_sell_products )
+{
+    BOOST_UBLAS_TEST_CHECK ((check_products<double, 8> (300, 200, 64)));
+    BOOST_UBLAS_TEST_CHECK ((check_products<double, 8> (147, 400, 1)));
+    BOOST_UBLAS_TEST_CHECK ((check_products<double, 4> (203, 90, 1000)));
+    BOOST_UBLAS_TEST_CHECK ((check_products<float, 8> (300, 200, 32, 1e-5)));
+    BOOST_UBLAS_TEST_CHECK ((check_products<float, 16> (250, 120, 48, 1e-5)));
+    BOOST_UBLAS_TEST_CHECK ((check_products<double, 3> (100, 70, 10)));
+    BOOST_UBLAS_TEST_CHECK ((check_products<complex_type, 8> (120, 90, 16)));
+}
+
+// The SIMD chunks against the portable loop
+BOOST_UBLAS_TEST_DEF ( test_sell_portable )
+{
+    typedef ublas::compressed_matrix<double> compressed_type;
+    const ublas::sliced_ell_matrix<double> a (make_sparse<compressed_type> (500, 300, 5));
+    const ublas::vector<double> x (make_vector<double> (300, 6));
+    const ublas::vector<double> simd (ublas::prod (a, x));
+    const ublas::detail::simd_isa isa = ublas::detail::simd_active_isa ();
+    ublas::detail::simd_select_isa (ublas::detail::simd_none);
+    const ublas::vector<double> portable (ublas::prod (a, x));
+    ublas::detail::simd_select_isa (isa);
+    BOOST_UBLAS_TEST_CHECK_VECTOR_CLOSE (simd, portable, 500, 1e-12);
+}
+
+// Elements, iterators and the storage layout
+BOOST_UBLAS_TEST_DEF ( test_sell_structure )
+{
+    typedef ublas::compressed_matrix<double> compressed_type;
+    const compressed_type c (make_sparse<compressed_type> (101, 60, 7));
+    const ublas::sliced_ell_matrix<double> a (c, 16);
+
+    bool equal = true;
+    for (std::size_t i = 0; i < c.size1 (); ++ i)
+        for (std::size_t j = 0; j < c.size2 (); ++ j)
+            equal = equal && a (i, j) == c (i, j);
+    BOOST_UBLAS_TEST_CHECK (equal);
+
+    // Back through the sparse iterators, by rows and by columns
+    const compressed_type back (a);
+    BOOST_UBLAS_TEST_CHECK_EQ (back.nnz (), c.nnz ());
+    BOOST_UBLAS_TEST_CHECK_EQ (ublas::norm_inf (ublas::matrix<double> (back - c)), 0.0);
+    const ublas::compressed_matrix<double, ublas::column_major> by_columns (a);
+    BOOST_UBLAS_TEST_CHECK_EQ (by_columns.nnz (), c.nnz ());
+    BOOST_UBLAS_TEST_CHECK_EQ (ublas::norm_inf (ublas::matrix<double> (by_columns - c)), 0.0);
+
+    // Each window is sorted by decreasing length and holds its own rows
+    bool sorted = true;
+    for (std::size_t s = 0; s < a.size1 (); ++ s) {
+        sorted = sorted && a.permutation_data () [s] / 16 == s / 16 &&
+                 a.slot_data () [a.permutation_data () [s]] == s;
+        if (s % 16 != 0)
+            sorted = sorted && a.length_data () [s - 1] >= a.length_data () [s];
+    }
+    BOOST_UBLAS_TEST_CHECK (sorted);
+    BOOST_UBLAS_TEST_CHECK_EQ (a.chunks (), std::size_t (13));
+
+    // Without sorting the rows keep their order
+    const ublas::sliced_ell_matrix<double> unsorted (c, 1);
+    bool identity = true;
+    for (std::size_t s = 0; s < unsorted.size1 (); ++ s)
+        identity = identity && unsorted.permutation_data () [s] == s;
+    BOOST_UBLAS_TEST_CHECK (identity);
+    BOOST_UBLAS_TEST_CHECK (unsorted.value_data ().size () >= a.value_data ().size ());
+}
+
+// Construction from a coordinate matrix and a dense one, and assignment
+BOOST_UBLAS_TEST_DEF ( test_sell_sources )
+{
+    typedef ublas::coordinate_matrix<double> coordinate_type;
+    const coordinate_type m (make_sparse<coordinate_type> (90, 80, 9));
+    const ublas::vector<double> x (make_vector<double> (80, 10));
+    const ublas::vector<double> expected (ublas::prod (ublas::matrix<double> (m), x));
+
+    const ublas::vector<double> twice (2.0 * expected);
+
+    ublas::sliced_ell_matrix<double> a (m);
+    const ublas::vector<double> ax (ublas::prod (a, x));
+    BOOST_UBLAS_TEST_CHECK_VECTOR_CLOSE (ax, expected, 90, 1e-12);
+    const ublas::sliced_ell_matrix<double> b (ublas::matrix<double> (m), 8);
+    const ublas::vector<double> bx (ublas::prod (b, x));
+    BOOST_UBLAS_TEST_CHECK_VECTOR_CLOSE (bx, expected, 90, 1e-12);
+
+    a = ublas::matrix<double> (2.0 * ublas::matrix<double> (m));
+    const ublas::vector<double> ax2 (ublas::prod (a, x));
+    BOOST_UBLAS_TEST_CHECK_VECTOR_CLOSE (ax2, twice, 90, 1e-12);
+}
+
+// Results without raw storage keep the generic evaluation
+BOOST_UBLAS_TEST_DEF ( test_sell_generic_result )
+{
+    typedef ublas::compressed_matrix<double> compressed_type;
+    const ublas::sliced_ell_matrix<double> a (make_sparse<compressed_type> (200, 150, 3));
+    const ublas::vector<double> x (make_vector<double> (150, 4));
+    const ublas::vector<double> expected (ublas::prod (ublas::matrix<double> (a), x));
+    ublas::vector<double, std::vector<double> > v (ublas::prod (a, x));
+    BOOST_UBLAS_TEST_CHECK_VECTOR_CLOSE (v, expected, 200, 1e-12);
+    ublas::vector<double, std::vector<double> > w (200);
+    ublas::axpy_prod (a, x, w, true);
+    BOOST_UBLAS_TEST_CHECK_VECTOR_CLOSE (w, expected, 200, 1e-12);
+}
+
+// An infinite or NaN x (0), which the padding reads, only reaches the rows
+// that store column 0, as in the compressed product
+template<class T>
+bool check_non_finite (const T &x0, double tolerance = 1e-12) {
+    typedef typename ublas::type_traits<T>::real_type real_type;
+    typedef ublas::compressed_matrix<T> compressed_type;
+    const compressed_type c (make_sparse<compressed_type> (200, 90, 11));
+    const ublas::sliced_ell_matrix<T, 8> a (c, 32);
+    ublas::vector<T> x (make_vector<T> (90, 12));
+    x (0) = x0;
+    const ublas::vector<T> expected (ublas::prod (c, x));
+    const ublas::vector<T> v (ublas::prod (a, x));
+    bool result = true;
+    std::size_t finite = 0;
+    for (std::size_t i = 0; i < v.size (); ++ i) {
+        if (expected (i) != expected (i))
+            result = result && v (i) != v (i);
+        else if (std::abs (expected (i)) > (std::numeric_limits<real_type>::max) ())
+            result = result && v (i) == expected (i);
+        else {
+            result = result && ublas::test::detail::close_to (v (i), expected (i), tolerance);
+            ++ finite;
+        }
+    }
+    // Most rows do not store column 0
+    return result && finite > 150;
+}
+
+BOOST_UBLAS_TEST_DEF ( test_sell_non_finite )
+{
+    const double inf = std::numeric_limits<double>::infinity ();
+    const double nan = std::numeric_limits<double>::quiet_NaN ();
+    const ublas::detail::simd_isa isa = ublas::detail::simd_active_isa ();
+    for (int portable = 0; portable < 2; ++ portable) {
+        if (portable)
+            ublas::detail::simd_select_isa (ublas::detail::simd_none);
+        BOOST_UBLAS_TEST_CHECK (check_non_finite (inf));
+        BOOST_UBLAS_TEST_CHECK (check_non_finite (-inf));
+        BOOST_UBLAS_TEST_CHECK (check_non_finite (nan));
+        BOOST_UBLAS_TEST_CHECK (check_non_finite (float (nan), 1e-5));
+        BOOST_UBLAS_TEST_CHECK (check_non_finite (complex_type (inf, 0.0)));
+    }
+    ublas::detail::simd_select_isa (isa);
+}
+
+// Matrices without stored elements, and empty ones
+BOOST_UBLAS_TEST_DEF ( test_sell_empty )
+{
+    const ublas::sliced_ell_matrix<double> a (ublas::compressed_matrix<double> (50, 40)), b;
+    ublas::vector<double> v (50, 1.0), e;
+    BOOST_UBLAS_TEST_CHECK_EQ (a.value_data ().size (), std::size_t (0));
+    v = ublas::prod (a, ublas::vector<double> (40, 1.0));
+    BOOST_UBLAS_TEST_CHECK_EQ (ublas::norm_inf (v), 0.0);
+    e = ublas::prod (b, ublas::vector<double> ());
+    BOOST_UBLAS_TEST_CHECK_EQ (e.size (), std::size_t (0));
+}
+
+int main () {
+    BOOST_UBLAS_TEST_BEGIN();
+
+    BOOST_UBLAS_TEST_DO( test_sell_products );
+    BOOST_UBLAS_TEST_DO( test_sell_portable );
+    BOOST_UBLAS_TEST_DO( test_sell_structure );
+    BOOST_UBLAS_TEST_DO( test_sell_sources );
+    BOOST_UBLAS_TEST_DO( test_sell_generic_result );
+    BOOST_UBLAS_TEST_DO( test_sell_non_finite );
+    BOOST_UBLAS_TEST_DO( test_sell_empty );
+
+    BOOST_UBLAS_TEST_END();
+}
@@ -0,0 +1,194 @@
+// Copyright (c) 2017 uBLAS developers
+// Distributed under the Boost Software License, Version 1.0. (See
+// accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+
+// Runs the dense operations once with the portable loops and once per
+// instruction set the processor supports, and compares the results.
+
+#include <complex>
+#include <iostream>
+
+#include <boost/numeric/ublas/matrix.hpp>
+
+#include "utils.hpp"
+
+namespace ublas = boost::numeric::ublas;
+namespace detail = boost::numeric::ublas::detail;
+
+static const detail::simd_isa isas [] = { detail::simd_sse2, detail::simd_avx2, detail::simd_avx512 };
+static const char *isa_names [] = { "sse2", "avx2", "avx512" };
+
+template<class T>
+void fill (T &t, int seed) {
+    t = T (double ((seed * 7) % 11) - 5.0) / T (4);
+}
+template<class T>
+void fill (std::complex<T> &t, int seed) {
+    t = std::complex<T> (T ((seed * 7) % 11) - T (5), T ((seed * 3) % 13) - T (6)) / T (4);
+}
+
+template<class V>
+V make_vector (std::size_t size, int seed) {
+    V v (size);
+    for (std::size_t i = 0; i < size; ++ i)
+        fill (v (i), seed + int (i));
+    return v;
+}
+
+template<class M>
+M make_matrix (std::size_t size1, std::size_t size2, int seed) {
+    M m (size1, size2);
+    for (std::size_t i = 0; i < size1; ++ i)
+        for (std::size_t j = 0; j < size2; ++ j)
+            fill (m (i, j), seed + int (i * 5 + j * 3));
+    return m;
+}
+
+template<class T>
+double tolerance () {
+    return 1.0e-10;
+}
+template<>
+double tolerance<float> () {
+    return 1.0e-3;
+}
+template<>
+double tolerance<std::complex<float> > () {
+    return 1.0e-3;
+}
+
+template<class T>
+bool close (const T &x, const T &y) {
+    return std::abs (x - y) <= tolerance<T> () * (1 + std::abs (y));
+}
+template<class V>
+bool close_vector (const V &x, const V &y) {
+    for (std::size_t i = 0; i < x.size (); ++ i)
+        if (! close (x (i), y (i)))
+            return false;
+    return true;
+}
+template<class M>
+bool close_matrix (const M &x, const M &y) {
+    for (std::size_t i = 0; i < x.size1 (); ++ i)
+        for (std::size_t j = 0; j < x.size2 (); ++ j)
+            if (! close (x (i, j), y (i, j)))
+                return false;
+    return true;
+}
+
+// a * x, spelled through vector_expression so that the matrix chain operator *
+// does not apply
+template<class V>
+typename ublas::vector_binary_scalar1_traits<const typename V::value_type, V,
+    ublas::scalar_multiplies<typename V::value_type, typename V::value_type> >::result_type
+scaled (const typename V::value_type &a, const V &x) {
+    return a * static_cast<const ublas::vector_expression<V> &> (x);
+}
+
+// Every operation with a dispatched kernel, evaluated at the active level
+template<class T>
+struct results {
+    typedef ublas::vector<T> vector_type;
+    typedef ublas::matrix<T> matrix_type;
+    typedef ublas::matrix<T, ublas::column_major> column_matrix_type;
+
+    T inner;
+    typename ublas::type_traits<T>::real_type norm;
+    vector_type axpy;
+    vector_type row_prod;
+    vector_type column_prod;
+    matrix_type gemm;
+    T element;
+
+    results () {
+        // Odd sizes leave a remainder after the vector loops
+        const std::size_t n = 103;
+        vector_type x (make_vector<vector_type> (n, 1)), y (make_vector<vector_type> (n, 2));
+        matrix_type a (make_matrix<matrix_type> (37, n, 3));
+        column_matrix_type b (make_matrix<column_matrix_type> (n, 29, 4));
+
+        inner = ublas::inner_prod (x, y);
+        norm = ublas::norm_2 (x);
+        T alpha;
+        fill (alpha, 9);
+        axpy = y;
+        ublas::noalias (axpy) += scaled (alpha, x);
+        ublas::noalias (axpy) -= x;
+        row_prod = ublas::prod (a, x);
+        column_prod = ublas::prod (x, b);
+        gemm = ublas::prod (a, b);
+        element = ublas::prod (a, b) (5, 7);
+    }
+
+    bool operator == (const results &r) const {
+        return close (inner, r.inner) && close (norm, r.norm) &&
+               close_vector (axpy, r.axpy) && close_vector (row_prod, r.row_prod) &&
+               close_vector (column_prod, r.column_prod) && close_matrix (gemm, r.gemm) &&
+               close (element, r.element);
+    }
+};
+
+template<class T>
+bool check_isas () {
+    detail::simd_isa active = detail::simd_active_isa ();
+    detail::simd_select_isa (detail::simd_none);
+    results<T> portable;
+    bool result = true;
+    for (std::size_t k = 0; k < sizeof (isas) / sizeof (isas [0]); ++ k) {
+        if (detail::simd_select_isa (isas [k]) != isas [k]) {
+            std::cout << isa_names [k] << " not supported" << std::endl;
+            continue;
+        }
+        if (! (results<T> () == portable)) {
+            std::cout << isa_names [k] << " differs from the portable loops" << std::endl;
+            result = false;
+        }
+    }
+    detail::simd_select_isa (active);
+    return result;
+}
+
+BOOST_UBLAS_TEST_DEF ( test_simd_float )
+{
+    BOOST_UBLAS_TEST_CHECK (check_isas<float> ());
+}
+
+BOOST_UBLAS_TEST_DEF ( test_simd_double )
+{
+    BOOST_UBLAS_TEST_CHECK (check_isas<double> ());
+}
+
+BOOST_UBLAS_TEST_DEF ( test_simd_complex_float )
+{
+    BOOST_UBLAS_TEST_CHECK (check_isas<std::complex<float> > ());
+}
+
+BOOST_UBLAS_TEST_DEF ( test_simd_complex_double )
+{
+    BOOST_UBLAS_TEST_CHECK (check_isas<std::complex<double> > ());
+}
+
+BOOST_UBLAS_TEST_DEF ( test_simd_selection )
+{
+    detail::simd_isa active = detail::simd_active_isa ();
+    BOOST_UBLAS_TEST_CHECK (detail::simd_select_isa (detail::simd_none) == detail::simd_none);
+    double x [3] = { 1, 2, 3 }, t = 0;
+    BOOST_UBLAS_TEST_CHECK (! detail::simd_dot (3, x, x, t));
+    // Requests beyond the processor are clamped
+    BOOST_UBLAS_TEST_CHECK (detail::simd_select_isa (detail::simd_avx512) == detail::simd_supported_isa ());
+    detail::simd_select_isa (active);
+}
+
+int main () {
+    BOOST_UBLAS_TEST_BEGIN();
+
+    BOOST_UBLAS_TEST_DO( test_simd_float );
+    BOOST_UBLAS_TEST_DO( test_simd_double );
+    BOOST_UBLAS_TEST_DO( test_simd_complex_float );
+    BOOST_UBLAS_TEST_DO( test_simd_complex_double );
+    BOOST_UBLAS_TEST_DO( test_simd_selection );
+
+    BOOST_UBLAS_TEST_END();
+}
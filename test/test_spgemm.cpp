@@ -0,0 +1,204 @@
+// Copyright (c) 2017 uBLAS developers
+// Distributed under the Boost Software License, Version 1.0. (See
+// accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+
+// A small pool and a low threshold so that the products split their rows
+// across threads
+#define BOOST_UBLAS_THREADS 4
+#define BOOST_UBLAS_SPARSE_PARALLEL_NNZ 64
+
+#include <complex>
+
+#include <boost/numeric/ublas/matrix.hpp>
+#include <boost/numeric/ublas/matrix_sparse.hpp>
+#include <boost/numeric/ublas/operation_sparse.hpp>
+#include <boost/numeric/ublas/triangular.hpp>
+
+#include "utils.hpp"
+#include "common/random.hpp"
+
+namespace ublas = boost::numeric::ublas;
+
+using ublas::test::detail::matrix_close_to;
+
+typedef std::complex<double> complex_type;
+
+// Row lengths from empty to dense, so that some rows of the product are
+// empty and others full
+template<class M>
+M make_sparse (std::size_t size1, std::size_t size2, unsigned seed) {
+    M m (size1, size2);
+    for (std::size_t i = 0; i + 2 < size1; ++ i) {
+        const std::size_t length = i % 17 == 0 ? size2 : (i * 5) % 7;
+        for (std::size_t k = 0; k < length; ++ k) {
+            typename M::value_type t;
+            assign_random (t, seed);
+            m (i, (k * 31 + i * 3) % size2) = t;
+        }
+    }
+    return m;
+}
+
+// The stored elements are sorted, none of them zero
+template<class M>
+bool well_formed (const M &m) {
+    bool result = m.filled1 () == m.index1_data ().size ();
+    for (std::size_t k = 0; k + 1 < m.filled1 (); ++ k)
+        for (std::size_t p = m.index1_data () [k]; p < m.index1_data () [k + 1]; ++ p) {
+            result = result && m.value_data () [p] != typename M::value_type ();
+            if (p > m.index1_data () [k])
+                result = result && m.index2_data () [p - 1] < m.index2_data () [p];
+        }
+    return result;
+}
+
+// prod, assignments and sparse_prod against the dense product; the operands
+// lie on a grid of 1/1000, so the elements that do not vanish stay near or
+// above 1e-6 whatever the order of the sums
+template<class T, class L>
+bool check_products (std::size_t size1, std::size_t size2, std::size_t size3, double tolerance = 1e-8) {
+    typedef ublas::compressed_matrix<T, L> compressed_type;
+    typedef ublas::matrix<T> dense_type;
+    const compressed_type a (make_sparse<compressed_type> (size1, size2, 1)), b (make_sparse<compressed_type> (size2, size3, 2));
+    const dense_type ab (ublas::prod (dense_type (a), dense_type (b))), two_ab (T (2) * ab);
+    const dense_type bbt (ublas::prod (dense_type (b), ublas::trans (dense_type (b))));
+
+    compressed_type c (ublas::prod (a, b));
+    bool result = well_formed (c);
+    const dense_type dc (c);
+    result = result && matrix_close_to (dc, ab, size1, size3, tolerance);
+    std::size_t nnz = 0;
+    for (std::size_t i = 0; i < size1; ++ i)
+        for (std::size_t j = 0; j < size3; ++ j)
+            nnz += ab (i, j) != T () ? 1 : 0;
+    result = result && c.nnz () == nnz;
+
+    c = ublas::prod (b, ublas::compressed_matrix<T, L> (ublas::trans (b)));
+    const dense_type dbbt (c);
+    result = result && matrix_close_to (dbbt, bbt, size2, size2, tolerance);
+
+    // Assignments other than = add the product
+    compressed_type f (T (3) * ab);
+    ublas::noalias (f) = ublas::prod (a, b);
+    const dense_type df (f);
+    result = result && matrix_close_to (df, ab, size1, size3, tolerance);
+    compressed_type d (size1, size3);
+    ublas::noalias (d) += ublas::prod (a, b);
+    ublas::noalias (d) += ublas::prod (a, b);
+    const dense_type dd (d);
+    result = result && matrix_close_to (dd, two_ab, size1, size3, tolerance);
+    d -= ublas::prod (a, b);
+    const dense_type dd1 (d);
+    result = result && matrix_close_to (dd1, ab, size1, size3, tolerance);
+
+    compressed_type e (size1, size3);
+    ublas::sparse_prod (a, b, e);
+    result = result && well_formed (e);
+    const dense_type de (e);
+    result = result && matrix_close_to (de, ab, size1, size3, tolerance);
+    e = ublas::sparse_prod<compressed_type> (a, b);
+    const dense_type de1 (e);
+    result = result && matrix_close_to (de1, ab, size1, size3, tolerance);
+    return result;
+}
+
+BOOST_UBLAS_TEST_DEF ( test_spgemm_products )
+{
+    BOOST_UBLAS_TEST_CHECK ((check_products<double, ublas::row_major> (200, 150, 170)));
+    BOOST_UBLAS_TEST_CHECK ((check_products<double, ublas::column_major> (200, 150, 170)));
+    BOOST_UBLAS_TEST_CHECK ((check_products<double, ublas::row_major> (31, 5, 47)));
+    BOOST_UBLAS_TEST_CHECK ((check_products<complex_type, ublas::row_major> (80, 60, 70)));
+    BOOST_UBLAS_TEST_CHECK ((check_products<float, ublas::column_major> (60, 40, 50, 1e-5)));
+}
+
+// Triangular restrictions of sparse_prod
+BOOST_UBLAS_TEST_DEF ( test_spgemm_restriction )
+{
+    typedef ublas::compressed_matrix<double> row_type;
+    typedef ublas::compressed_matrix<double, ublas::column_major> column_type;
+    const row_type a (make_sparse<row_type> (90, 70, 3)), b (make_sparse<row_type> (70, 90, 4));
+    const ublas::matrix<double> ab (ublas::prod (ublas::matrix<double> (a), ublas::matrix<double> (b)));
+    const ublas::matrix<double> lower ((ublas::triangular_adaptor<const ublas::matrix<double>, ublas::lower> (ab)));
+    const ublas::matrix<double> upper ((ublas::triangular_adaptor<const ublas::matrix<double>, ublas::strict_upper> (ab)));
+
+    row_type c (90, 90);
+    ublas::sparse_prod (a, b, c, ublas::lower ());
+    BOOST_UBLAS_TEST_CHECK (well_formed (c));
+    const ublas::matrix<double> c_lower (c);
+    BOOST_UBLAS_TEST_CHECK_MATRIX_CLOSE (c_lower, lower, 90, 90, 1e-8);
+    ublas::sparse_prod (a, b, c, ublas::strict_upper ());
+    BOOST_UBLAS_TEST_CHECK (well_formed (c));
+    const ublas::matrix<double> c_upper (c);
+    BOOST_UBLAS_TEST_CHECK_MATRIX_CLOSE (c_upper, upper, 90, 90, 1e-8);
+
+    const column_type ca (a), cb (b);
+    column_type cc (90, 90);
+    ublas::sparse_prod (ca, cb, cc, ublas::lower ());
+    BOOST_UBLAS_TEST_CHECK (well_formed (cc));
+    const ublas::matrix<double> cc_lower (cc);
+    BOOST_UBLAS_TEST_CHECK_MATRIX_CLOSE (cc_lower, lower, 90, 90, 1e-8);
+    ublas::sparse_prod (ca, cb, cc, ublas::strict_upper ());
+    BOOST_UBLAS_TEST_CHECK (well_formed (cc));
+    const ublas::matrix<double> cc_upper (cc);
+    BOOST_UBLAS_TEST_CHECK_MATRIX_CLOSE (cc_upper, upper, 90, 90, 1e-8);
+}
+
+// Elements that cancel are not stored
+BOOST_UBLAS_TEST_DEF ( test_spgemm_cancellation )
+{
+    ublas::compressed_matrix<double> a (3, 2), b (2, 3);
+    a (0, 0) = 1; a (0, 1) = 1; a (1, 0) = 2; a (2, 1) = 3;
+    b (0, 0) = 1; b (1, 0) = -1; b (0, 2) = 4; b (1, 2) = 5;
+    const ublas::compressed_matrix<double> c (ublas::prod (a, b));
+    BOOST_UBLAS_TEST_CHECK (well_formed (c));
+    BOOST_UBLAS_TEST_CHECK_EQ (c.nnz (), std::size_t (5));
+    BOOST_UBLAS_TEST_CHECK_EQ (c (0, 0), 0.0);
+    BOOST_UBLAS_TEST_CHECK_EQ (c (0, 2), 9.0);
+    BOOST_UBLAS_TEST_CHECK_EQ (c (1, 0), 2.0);
+    BOOST_UBLAS_TEST_CHECK_EQ (c (2, 0), -3.0);
+}
+
+// Other operands keep the generic evaluation
+BOOST_UBLAS_TEST_DEF ( test_spgemm_generic )
+{
+    typedef ublas::compressed_matrix<double> compressed_type;
+    typedef ublas::coordinate_matrix<double> coordinate_type;
+    const compressed_type a (make_sparse<compressed_type> (50, 40, 5));
+    const coordinate_type b (make_sparse<coordinate_type> (40, 60, 6));
+    const ublas::matrix<double> ab (ublas::prod (ublas::matrix<double> (a), ublas::matrix<double> (b)));
+    const ublas::matrix<double> c (ublas::compressed_matrix<double> (ublas::prod (a, b)));
+    BOOST_UBLAS_TEST_CHECK_MATRIX_CLOSE (c, ab, 50, 60, 1e-8);
+    const ublas::matrix<double> d (ublas::compressed_matrix<double, ublas::column_major> (ublas::prod (a, compressed_type (b))));
+    BOOST_UBLAS_TEST_CHECK_MATRIX_CLOSE (d, ab, 50, 60, 1e-8);
+    coordinate_type e (50, 60);
+    ublas::sparse_prod (a, compressed_type (b), e);
+    const ublas::matrix<double> de (e);
+    BOOST_UBLAS_TEST_CHECK_MATRIX_CLOSE (de, ab, 50, 60, 1e-8);
+}
+
+// Products without stored elements, and empty ones
+BOOST_UBLAS_TEST_DEF ( test_spgemm_empty )
+{
+    const ublas::compressed_matrix<double> a (40, 30), b (30, 20), c (0, 30), d (30, 0);
+    const ublas::compressed_matrix<double> ab (ublas::prod (a, b));
+    BOOST_UBLAS_TEST_CHECK_EQ (ab.nnz (), std::size_t (0));
+    BOOST_UBLAS_TEST_CHECK_EQ (ab.size1 (), std::size_t (40));
+    BOOST_UBLAS_TEST_CHECK (well_formed (ab));
+    const ublas::compressed_matrix<double> cb (ublas::prod (c, b)), ad (ublas::prod (a, d));
+    BOOST_UBLAS_TEST_CHECK_EQ (cb.size1 (), std::size_t (0));
+    BOOST_UBLAS_TEST_CHECK_EQ (ad.size2 (), std::size_t (0));
+    BOOST_UBLAS_TEST_CHECK_EQ (ad.nnz (), std::size_t (0));
+}
+
+int main () {
+    BOOST_UBLAS_TEST_BEGIN();
+
+    BOOST_UBLAS_TEST_DO( test_spgemm_products );
+    BOOST_UBLAS_TEST_DO( test_spgemm_restriction );
+    BOOST_UBLAS_TEST_DO( test_spgemm_cancellation );
+    BOOST_UBLAS_TEST_DO( test_spgemm_generic );
+    BOOST_UBLAS_TEST_DO( test_spgemm_empty );
+
+    BOOST_UBLAS_TEST_END();
+}
@@ -0,0 +1,129 @@
+// Copyright (c) 2017 uBLAS developers
+// Distributed under the Boost Software License, Version 1.0. (See
+// accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+
+// A small pool and a low threshold so that the products split their rows,
+// or their buffers, across threads
+#define BOOST_UBLAS_THREADS 4
+#define BOOST_UBLAS_SPARSE_PARALLEL_NNZ 64
+
+#include <complex>
+#include <vector>
+
+#include <boost/numeric/ublas/matrix.hpp>
+#include <boost/numeric/ublas/matrix_sparse.hpp>
+#include <boost/numeric/ublas/vector.hpp>
+#include <boost/numeric/ublas/operation.hpp>
+
+#include "utils.hpp"
+#include "common/random.hpp"
+
+namespace ublas = boost::numeric::ublas;
+
+using ublas::test::detail::vector_close_to;
+
+typedef std::complex<double> complex_type;
+
+// Row lengths from empty to dense, so that splitting by rows would be
+// unbalanced, and trailing empty rows
+template<class M>
+M make_sparse (std::size_t size1, std::size_t size2, unsigned seed) {
+    M m (size1, size2);
+    for (std::size_t i = 0; i + 3 < size1; ++ i) {
+        const std::size_t length = i % 7 == 0 ? size2 : i % 5;
+        for (std::size_t k = 0; k < length; ++ k) {
+            typename M::value_type t;
+            assign_random (t, seed);
+            m (i, (k * 37 + i) % size2) = t;
+        }
+    }
+    return m;
+}
+
+// prod, prod of the transpose and axpy_prod against the dense product
+template<class T, class L>
+bool check_products (std::size_t size1, std::size_t size2) {
+    typedef ublas::compressed_matrix<T, L> sparse_type;
+    typedef ublas::matrix<T> dense_type;
+    const sparse_type a (make_sparse<sparse_type> (size1, size2, unsigned (size1)));
+    const dense_type d (a);
+    const ublas::vector<T> x (make_vector<T> (size2, 1)), y (make_vector<T> (size1, 2));
+    const ublas::vector<T> ax (ublas::prod (d, x)), aty (ublas::prod (ublas::trans (d), y));
+    const ublas::vector<T> y_plus_ax (y + ax), y_minus_ax (y - ax), two_ax (T (2) * ax);
+
+    ublas::vector<T> v (ublas::prod (a, x));
+    bool result = vector_close_to (v, ax, size1, 1e-12);
+    ublas::vector<T> w (ublas::prod (ublas::trans (a), y));
+    result = result && vector_close_to (w, aty, size2, 1e-12);
+    w = ublas::prod (y, a);
+    result = result && vector_close_to (w, aty, size2, 1e-12);
+
+    // Accumulating and with an expression as the vector operand
+    ublas::vector<T> u (y);
+    ublas::noalias (u) += ublas::prod (a, x);
+    result = result && vector_close_to (u, y_plus_ax, size1, 1e-12);
+    ublas::noalias (u) -= ublas::prod (a, T (2) * x);
+    result = result && vector_close_to (u, y_minus_ax, size1, 1e-12);
+
+    ublas::vector<T> s (size1), t (size2);
+    ublas::axpy_prod (a, x, s, true);
+    result = result && vector_close_to (s, ax, size1, 1e-12);
+    ublas::axpy_prod (y, a, t, true);
+    result = result && vector_close_to (t, aty, size2, 1e-12);
+    ublas::axpy_prod (a, x, s, false);
+    result = result && vector_close_to (s, two_ax, size1, 1e-12);
+    return result;
+}
+
+BOOST_UBLAS_TEST_DEF ( test_spmv_row_major )
+{
+    BOOST_UBLAS_TEST_CHECK ((check_products<double, ublas::row_major> (300, 200)));
+    BOOST_UBLAS_TEST_CHECK ((check_products<double, ublas::row_major> (150, 400)));
+    BOOST_UBLAS_TEST_CHECK ((check_products<complex_type, ublas::row_major> (120, 90)));
+}
+
+BOOST_UBLAS_TEST_DEF ( test_spmv_column_major )
+{
+    BOOST_UBLAS_TEST_CHECK ((check_products<double, ublas::column_major> (300, 200)));
+    BOOST_UBLAS_TEST_CHECK ((check_products<double, ublas::column_major> (150, 400)));
+    BOOST_UBLAS_TEST_CHECK ((check_products<complex_type, ublas::column_major> (120, 90)));
+}
+
+// Results without raw storage keep the generic evaluation
+BOOST_UBLAS_TEST_DEF ( test_spmv_generic_result )
+{
+    typedef ublas::compressed_matrix<double> sparse_type;
+    const sparse_type a (make_sparse<sparse_type> (200, 150, 3));
+    const ublas::vector<double> x (make_vector<double> (150, 4));
+    const ublas::vector<double> expected (ublas::prod (ublas::matrix<double> (a), x));
+    ublas::vector<double, std::vector<double> > v (ublas::prod (a, x));
+    BOOST_UBLAS_TEST_CHECK_VECTOR_CLOSE (v, expected, 200, 1e-12);
+    ublas::vector<double, std::vector<double> > w (200);
+    ublas::axpy_prod (a, x, w, true);
+    BOOST_UBLAS_TEST_CHECK_VECTOR_CLOSE (w, expected, 200, 1e-12);
+}
+
+// Matrices without stored elements, and empty ones
+BOOST_UBLAS_TEST_DEF ( test_spmv_empty )
+{
+    const ublas::compressed_matrix<double> a (50, 40), b (0, 0);
+    ublas::vector<double> v (50, 1.0), w (40, 1.0), e;
+    v = ublas::prod (a, ublas::vector<double> (40, 1.0));
+    BOOST_UBLAS_TEST_CHECK_EQ (ublas::norm_inf (v), 0.0);
+    w = ublas::prod (ublas::trans (a), ublas::vector<double> (50, 1.0));
+    BOOST_UBLAS_TEST_CHECK_EQ (ublas::norm_inf (w), 0.0);
+    e = ublas::prod (b, ublas::vector<double> ());
+    BOOST_UBLAS_TEST_CHECK_EQ (e.size (), std::size_t (0));
+}
+
+int main () {
+    BOOST_UBLAS_TEST_BEGIN();
+
+    BOOST_UBLAS_TEST_DO( test_spmv_row_major );
+    BOOST_UBLAS_TEST_DO( test_spmv_column_major );
+    BOOST_UBLAS_TEST_DO( test_spmv_generic_result );
+    BOOST_UBLAS_TEST_DO( test_spmv_empty );
+
+    BOOST_UBLAS_TEST_END();
+}
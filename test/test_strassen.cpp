@@ -0,0 +1,208 @@
+// Copyright (c) 2017 uBLAS developers
+// Distributed under the Boost Software License, Version 1.0. (See
+// accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+
+// Recurse down to small blocks so that several Strassen levels are exercised
+// with cheap test sizes.
+#define BOOST_UBLAS_STRASSEN_CUTOFF 8
+// Keep the calibration short
+#define BOOST_UBLAS_STRASSEN_CALIBRATION_LIMIT 256
+
+#include <cmath>
+
+#include <boost/numeric/ublas/matrix.hpp>
+
+#include "utils.hpp"
+
+namespace ublas = boost::numeric::ublas;
+
+static const double TOL (1.0e-10);
+
+template<class M>
+void fill (M &m, int seed) {
+    for (std::size_t i = 0; i < m.size1 (); ++ i)
+        for (std::size_t j = 0; j < m.size2 (); ++ j)
+            m (i, j) = double ((i * 7 + j * 3 + seed) % 11) - 5.0;
+}
+
+template<class M>
+M reference_prod (const M &a, const M &b) {
+    M c (a.size1 (), b.size2 ());
+    for (std::size_t i = 0; i < c.size1 (); ++ i)
+        for (std::size_t j = 0; j < c.size2 (); ++ j) {
+            double t = 0;
+            for (std::size_t k = 0; k < a.size2 (); ++ k)
+                t += a (i, k) * b (k, j);
+            c (i, j) = t;
+        }
+    return c;
+}
+
+template<class M>
+M strassen_prod (const M &a, const M &b, bool use_strassen) {
+    M c (a.size1 (), b.size2 ());
+    ublas::detail::strassen_prod<double> (a.size1 (), a.size2 (), b.size2 (), a, b, c, use_strassen);
+    return c;
+}
+
+BOOST_UBLAS_TEST_DEF ( test_strassen_square )
+{
+    typedef ublas::matrix<double> matrix_type;
+    matrix_type a (64, 64), b (64, 64);
+    fill (a, 1); fill (b, 2);
+    BOOST_UBLAS_TEST_CHECK_MATRIX_CLOSE (strassen_prod (a, b, true), reference_prod (a, b), 64, 64, TOL);
+}
+
+BOOST_UBLAS_TEST_DEF ( test_strassen_rectangular )
+{
+    typedef ublas::matrix<double, ublas::column_major> matrix_type;
+    matrix_type a (37, 53), b (53, 29);
+    fill (a, 3); fill (b, 4);
+    BOOST_UBLAS_TEST_CHECK_MATRIX_CLOSE (strassen_prod (a, b, true), reference_prod (a, b), 37, 29, TOL);
+    BOOST_UBLAS_TEST_CHECK_MATRIX_CLOSE (strassen_prod (a, b, false), reference_prod (a, b), 37, 29, TOL);
+}
+
+// C = beta C + alpha A B through strassen_gemm with the given cutoff
+template<class M1, class M2, class M>
+bool check_strassen_gemm (std::size_t size1, std::size_t size, std::size_t size2,
+                          double alpha, double beta, std::size_t cutoff) {
+    typedef ublas::detail::dense_matrix_traits<M1> traits1;
+    typedef ublas::detail::dense_matrix_traits<M2> traits2;
+    typedef ublas::detail::dense_matrix_traits<M> traits;
+    M1 a (size1, size);
+    M2 b (size, size2);
+    M c (size1, size2);
+    fill (a, 1); fill (b, 2); fill (c, 3);
+    M expected (size1, size2);
+    for (std::size_t i = 0; i < size1; ++ i)
+        for (std::size_t j = 0; j < size2; ++ j) {
+            double t = 0;
+            for (std::size_t k = 0; k < size; ++ k)
+                t += a (i, k) * b (k, j);
+            expected (i, j) = beta * c (i, j) + alpha * t;
+        }
+    ublas::detail::strassen_gemm (size1, size2, size, alpha,
+                                  traits1::data (a), traits1::stride1 (a), traits1::stride2 (a),
+                                  traits2::data (b), traits2::stride1 (b), traits2::stride2 (b),
+                                  beta, traits::data (c), traits::stride1 (c), traits::stride2 (c), cutoff);
+    for (std::size_t i = 0; i < size1; ++ i)
+        for (std::size_t j = 0; j < size2; ++ j)
+            if (std::abs (c (i, j) - expected (i, j)) > TOL)
+                return false;
+    return true;
+}
+
+BOOST_UBLAS_TEST_DEF ( test_strassen_peeling )
+{
+    typedef ublas::matrix<double> row_type;
+    typedef ublas::matrix<double, ublas::column_major> column_type;
+
+    // Every combination of odd dimensions, peeled at several levels
+    const std::size_t sizes [] = { 32, 33, 35, 47 };
+    bool result = true;
+    for (std::size_t i = 0; i < 4; ++ i)
+        for (std::size_t k = 0; k < 4; ++ k)
+            for (std::size_t j = 0; j < 4; ++ j)
+                result = result && check_strassen_gemm<row_type, row_type, row_type> (sizes [i], sizes [k], sizes [j], 1.0, 0.0, 8);
+    BOOST_UBLAS_TEST_CHECK (result);
+
+    // Skewed shapes stop recursing as soon as one dimension is small
+    BOOST_UBLAS_TEST_CHECK ((check_strassen_gemm<row_type, row_type, row_type> (71, 9, 66, 1.0, 0.0, 8)));
+    BOOST_UBLAS_TEST_CHECK ((check_strassen_gemm<row_type, row_type, row_type> (5, 90, 70, 1.0, 0.0, 8)));
+
+    // Column major and mixed storage, scaling and accumulation
+    BOOST_UBLAS_TEST_CHECK ((check_strassen_gemm<column_type, row_type, column_type> (45, 39, 41, 2.0, 0.0, 8)));
+    BOOST_UBLAS_TEST_CHECK ((check_strassen_gemm<row_type, column_type, row_type> (37, 52, 29, -1.0, 1.0, 8)));
+    BOOST_UBLAS_TEST_CHECK ((check_strassen_gemm<column_type, column_type, row_type> (40, 40, 40, 0.5, -2.0, 5)));
+}
+
+BOOST_UBLAS_TEST_DEF ( test_strassen_cutoff )
+{
+    // Fixed by the test, so nothing is measured
+    BOOST_UBLAS_TEST_CHECK_EQ (ublas::detail::strassen_cutoff<double> (), std::size_t (8));
+    BOOST_UBLAS_TEST_CHECK (ublas::detail::strassen_pays<double> (8, 100, 9));
+    BOOST_UBLAS_TEST_CHECK (! ublas::detail::strassen_pays<double> (100, 7, 100));
+
+    // One step below the root of a 40 x 40 x 40 product
+    BOOST_UBLAS_TEST_CHECK_EQ (ublas::detail::strassen_workspace_size (40, 40, 40, 21), std::size_t (3 * 20 * 20));
+    BOOST_UBLAS_TEST_CHECK_EQ (ublas::detail::strassen_workspace_size (40, 40, 40, 41), std::size_t (0));
+}
+
+BOOST_UBLAS_TEST_DEF ( test_prod )
+{
+    typedef ublas::matrix<double> matrix_type;
+    matrix_type a (19, 23), b (23, 17);
+    fill (a, 5); fill (b, 6);
+    matrix_type c = ublas::prod (a, b);
+    BOOST_UBLAS_TEST_CHECK_MATRIX_CLOSE (c, reference_prod (a, b), 19, 17, TOL);
+
+    // Large enough for Strassen steps through the dense product
+    matrix_type d (61, 45), e (45, 50);
+    fill (d, 7); fill (e, 8);
+    matrix_type f = ublas::prod (d, e);
+    BOOST_UBLAS_TEST_CHECK_MATRIX_CLOSE (f, reference_prod (d, e), 61, 50, TOL);
+    f += ublas::prod (d, e);
+    BOOST_UBLAS_TEST_CHECK_MATRIX_CLOSE (f, 2. * reference_prod (d, e), 61, 50, TOL);
+}
+
+BOOST_UBLAS_TEST_DEF ( test_workspace_reuse )
+{
+    typedef ublas::matrix<double> matrix_type;
+    typedef ublas::detail::workspace_arena<double> arena_type;
+    matrix_type a (40, 40), b (40, 40);
+    fill (a, 7); fill (b, 8);
+
+    strassen_prod (a, b, true);
+    arena_type::instance ().reset_statistics ();
+    strassen_prod (a, b, true);
+    strassen_prod (a, b, true);
+    // The arena keeps its memory, repeated products do not allocate
+    BOOST_UBLAS_TEST_CHECK_EQ (arena_type::instance ().allocations (), std::size_t (0));
+
+    // Nested leases stay valid while the arena grows
+    ublas::detail::workspace<double> outer (100);
+    BOOST_UBLAS_TEST_CHECK_EQ (reinterpret_cast<std::size_t> (outer.data ()) % BOOST_UBLAS_WORKSPACE_ALIGN, std::size_t (0));
+    outer.data () [99] = 1.0;
+    {
+        ublas::detail::workspace<double> inner (1 << 20);
+        inner.data () [0] = 2.0;
+    }
+    BOOST_UBLAS_TEST_CHECK_EQ (outer.data () [99], 1.0);
+}
+
+// The cutoff only changes when calibration is asked for, for one value type
+BOOST_UBLAS_TEST_DEF ( test_strassen_calibrate )
+{
+    typedef ublas::matrix<double> matrix_type;
+    matrix_type a (130, 130), b (130, 130);
+    fill (a, 9); fill (b, 10);
+    matrix_type c = ublas::prod (a, b);
+    BOOST_UBLAS_TEST_CHECK_EQ (ublas::detail::strassen_cutoff<double> (), std::size_t (8));
+
+    const std::size_t cutoff = ublas::detail::strassen_calibrate<double> ();
+    BOOST_UBLAS_TEST_CHECK (cutoff == 128 || cutoff == 256 || cutoff == 512);
+    BOOST_UBLAS_TEST_CHECK_EQ (ublas::detail::strassen_cutoff<double> (), cutoff);
+    BOOST_UBLAS_TEST_CHECK_EQ (ublas::detail::strassen_cutoff<float> (), std::size_t (8));
+    BOOST_UBLAS_TEST_CHECK_EQ (ublas::detail::strassen_pays<double> (cutoff, cutoff, cutoff), true);
+    BOOST_UBLAS_TEST_CHECK_EQ (ublas::detail::strassen_pays<double> (cutoff - 1, cutoff, cutoff), false);
+
+    // The check evaluates its arguments for every element
+    const matrix_type d = ublas::prod (a, b), r = reference_prod (a, b);
+    BOOST_UBLAS_TEST_CHECK_MATRIX_CLOSE (d, r, 130, 130, TOL);
+    BOOST_UBLAS_TEST_CHECK_MATRIX_CLOSE (c, d, 130, 130, TOL);
+}
+
+int main () {
+    BOOST_UBLAS_TEST_BEGIN();
+
+    BOOST_UBLAS_TEST_DO( test_strassen_square );
+    BOOST_UBLAS_TEST_DO( test_strassen_rectangular );
+    BOOST_UBLAS_TEST_DO( test_strassen_peeling );
+    BOOST_UBLAS_TEST_DO( test_strassen_cutoff );
+    BOOST_UBLAS_TEST_DO( test_prod );
+    BOOST_UBLAS_TEST_DO( test_workspace_reuse );
+    BOOST_UBLAS_TEST_DO( test_strassen_calibrate );
+
+    BOOST_UBLAS_TEST_END();
+}
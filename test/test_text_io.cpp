@@ -0,0 +1,264 @@
+// Copyright (c) 2017 uBLAS developers
+// Distributed under the Boost Software License, Version 1.0. (See
+// accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+
+// A small pool and small blocks so that matrices are parsed and formatted
+// by several threads
+#define BOOST_UBLAS_THREADS 4
+#define BOOST_UBLAS_TEXT_BLOCK_SIZE 64
+
+#include <clocale>
+#include <complex>
+#include <limits>
+#include <sstream>
+#include <string>
+
+#include <boost/numeric/ublas/matrix.hpp>
+#include <boost/numeric/ublas/vector.hpp>
+#include <boost/numeric/ublas/symmetric.hpp>
+#include <boost/numeric/ublas/hermitian.hpp>
+#include <boost/numeric/ublas/io.hpp>
+
+#include "utils.hpp"
+
+namespace ublas = boost::numeric::ublas;
+
+typedef std::complex<double> complex_type;
+
+template<class T>
+T test_value (std::size_t k) {
+    static const double values [] = {0.0, 1.0, -2.5, 1.0 / 3.0, 1e-300, -6.02214076e23, 123456789.0, 0.1, -0.0, 7.0 / 9.0};
+    return T (values [k % 10] * double (k / 10 + 1));
+}
+template<>
+int test_value<int> (std::size_t k) {
+    return int (k * 7919 % 20011) - 10005;
+}
+template<>
+complex_type test_value<complex_type> (std::size_t k) {
+    return complex_type (test_value<double> (k), test_value<double> (k + 3));
+}
+
+// The text the generic operators write, element by element through the stream
+template<class T>
+std::string stream_text (const T &t, std::streamsize precision) {
+    std::ostringstream s;
+    s.precision (precision);
+    s << t;
+    return s.str ();
+}
+template<class M>
+std::string reference_text (const M &m, std::streamsize precision) {
+    std::string s = "[" + stream_text (m.size1 (), precision) + "," + stream_text (m.size2 (), precision) + "](";
+    for (std::size_t i = 0; i < m.size1 (); ++ i) {
+        s += i > 0 ? ",(" : "(";
+        for (std::size_t j = 0; j < m.size2 (); ++ j)
+            s += (j > 0 ? "," : "") + stream_text (m (i, j), precision);
+        s += ")";
+    }
+    return s + ")";
+}
+
+template<class M1, class M2>
+bool same (const M1 &a, const M2 &b) {
+    bool result = a.size1 () == b.size1 () && a.size2 () == b.size2 ();
+    for (std::size_t i = 0; result && i < a.size1 (); ++ i)
+        for (std::size_t j = 0; result && j < a.size2 (); ++ j)
+            result = a (i, j) == b (i, j);
+    return result;
+}
+
+// Writing with the default precision matches the stream's formatting, and
+// writing with max_digits10 reads back the same values
+template<class T, class L>
+bool check_matrix (std::size_t size1, std::size_t size2) {
+    ublas::matrix<T, L> m (size1, size2);
+    for (std::size_t i = 0; i < size1; ++ i)
+        for (std::size_t j = 0; j < size2; ++ j)
+            m (i, j) = test_value<T> (i * size2 + j);
+    std::ostringstream os;
+    os << m;
+    bool result = os.str () == reference_text (m, os.precision ());
+
+    std::stringstream s;
+    s.precision (std::numeric_limits<double>::digits10 + 2);
+    s << m << " tail";
+    result = result && s.str ().compare (0, s.str ().size () - 5, reference_text (m, s.precision ())) == 0;
+    ublas::matrix<T, L> r (1, 1);
+    s >> r;
+    std::string tail;
+    s >> tail;
+    return result && s && same (m, r) && tail == "tail";
+}
+
+BOOST_UBLAS_TEST_DEF ( test_text_io_matrix )
+{
+    BOOST_UBLAS_TEST_CHECK ((check_matrix<double, ublas::row_major> (37, 23)));
+    BOOST_UBLAS_TEST_CHECK ((check_matrix<double, ublas::column_major> (23, 37)));
+    BOOST_UBLAS_TEST_CHECK ((check_matrix<float, ublas::row_major> (9, 17)));
+    BOOST_UBLAS_TEST_CHECK ((check_matrix<int, ublas::row_major> (20, 5)));
+    BOOST_UBLAS_TEST_CHECK ((check_matrix<complex_type, ublas::row_major> (13, 11)));
+    BOOST_UBLAS_TEST_CHECK ((check_matrix<double, ublas::row_major> (1, 200)));
+    BOOST_UBLAS_TEST_CHECK ((check_matrix<double, ublas::row_major> (200, 1)));
+    BOOST_UBLAS_TEST_CHECK ((check_matrix<double, ublas::row_major> (0, 4)));
+    BOOST_UBLAS_TEST_CHECK ((check_matrix<double, ublas::row_major> (4, 0)));
+
+    // Expressions without dense storage are formatted by one thread
+    ublas::matrix<double> m (30, 20);
+    for (std::size_t k = 0; k < 600; ++ k)
+        m.data () [k] = test_value<double> (k);
+    std::ostringstream os;
+    os << m + m;
+    BOOST_UBLAS_TEST_CHECK (os.str () == reference_text (ublas::matrix<double> (m + m), os.precision ()));
+}
+
+BOOST_UBLAS_TEST_DEF ( test_text_io_vector )
+{
+    ublas::vector<double> v (500);
+    for (std::size_t k = 0; k < v.size (); ++ k)
+        v (k) = test_value<double> (k);
+    std::stringstream s;
+    s.precision (17);
+    s << v;
+    ublas::vector<double> r;
+    s >> r;
+    BOOST_UBLAS_TEST_CHECK (s);
+    BOOST_UBLAS_TEST_CHECK_EQ (r.size (), v.size ());
+    BOOST_UBLAS_TEST_CHECK_EQ (ublas::norm_inf (r - v), 0.0);
+
+    ublas::vector<complex_type> c (3), d;
+    c (0) = complex_type (1, 2);
+    c (1) = complex_type (-0.5, 0);
+    c (2) = complex_type (3, -4);
+    std::ostringstream os;
+    os << c;
+    BOOST_UBLAS_TEST_CHECK (os.str () == "[3]((1,2),(-0.5,0),(3,-4))");
+    // Complex numbers as std::complex reads them
+    std::istringstream is ("[3]( (1,2), (-0.5) ,(3 , -4))");
+    is >> d;
+    BOOST_UBLAS_TEST_CHECK (is);
+    BOOST_UBLAS_TEST_CHECK_EQ (ublas::norm_inf (c - d), 0.0);
+
+    ublas::vector<double> e;
+    std::istringstream es ("[0]()");
+    es >> e;
+    BOOST_UBLAS_TEST_CHECK (es);
+    BOOST_UBLAS_TEST_CHECK_EQ (e.size (), std::size_t (0));
+}
+
+// Free white space, signs and exponents are read as streams read them
+BOOST_UBLAS_TEST_DEF ( test_text_io_syntax )
+{
+    std::istringstream is ("  [2,3] (\n ( 1 , +2.5e1 ,-3 ) ,\t(4e-1,.5, 6.) ) [1,1]((7))");
+    ublas::matrix<double> m, n;
+    is >> m >> n;
+    BOOST_UBLAS_TEST_CHECK (is);
+    BOOST_UBLAS_TEST_CHECK_EQ (m.size1 (), std::size_t (2));
+    BOOST_UBLAS_TEST_CHECK_EQ (m (0, 1), 25.0);
+    BOOST_UBLAS_TEST_CHECK_EQ (m (1, 0), 0.4);
+    BOOST_UBLAS_TEST_CHECK_EQ (m (1, 2), 6.0);
+    BOOST_UBLAS_TEST_CHECK_EQ (n (0, 0), 7.0);
+
+    // Malformed texts fail and leave the matrix alone
+    const char *bad [] = {
+        "[2,2]((1,2),(3))", "[2,2]((1,2),(3,4,5))", "[2,2]((1,2)(3,4))", "[2,2]((1,2),(3,4),(5,6))",
+        "[2,2]((1,2),(3,x))", "[2,2]((1,2),(3,4)", "[2,2]((1,2),(3,4", "(2,2)((1,2),(3,4))", "[2]((1,2),(3,4))",
+        "[2,2]x((1,2),(3,4))", "[2,2]((1,,2),(3,4))", "[2,2]((1,2),,(3,4))"
+    };
+    for (std::size_t k = 0; k < sizeof (bad) / sizeof (bad [0]); ++ k) {
+        std::istringstream bs (bad [k]);
+        bs >> n;
+        BOOST_UBLAS_TEST_CHECK (bs.fail ());
+        BOOST_UBLAS_TEST_CHECK_EQ (n.size1 (), std::size_t (1));
+        BOOST_UBLAS_TEST_CHECK_EQ (n (0, 0), 7.0);
+    }
+
+    // Streams with other flags take the generic operators
+    ublas::vector<int> h (3), g;
+    h (0) = 10;
+    h (1) = 255;
+    h (2) = 16;
+    std::stringstream hs;
+    hs << std::hex << h;
+    BOOST_UBLAS_TEST_CHECK (hs.str () == "[3](a,ff,10)");
+    hs >> g;
+    BOOST_UBLAS_TEST_CHECK (hs);
+    BOOST_UBLAS_TEST_CHECK_EQ (g (1), 255);
+    std::ostringstream ws;
+    ws.width (14);
+    ws << ublas::vector<double> (2, 1.5);
+    BOOST_UBLAS_TEST_CHECK (ws.str () == "  [2](1.5,1.5)");
+    std::ostringstream fs;
+    fs << std::fixed << ublas::vector<double> (1, 1.5);
+    BOOST_UBLAS_TEST_CHECK (fs.str () == "[1](1.500000)");
+}
+
+BOOST_UBLAS_TEST_DEF ( test_text_io_triangles )
+{
+    ublas::symmetric_matrix<double> s (40, 40), r;
+    for (std::size_t i = 0; i < 40; ++ i)
+        for (std::size_t j = 0; j <= i; ++ j)
+            s (i, j) = test_value<double> (i * 40 + j);
+    std::stringstream ss;
+    ss.precision (17);
+    ss << s;
+    ss >> r;
+    BOOST_UBLAS_TEST_CHECK (ss);
+    BOOST_UBLAS_TEST_CHECK (same (s, r));
+
+    ublas::hermitian_matrix<complex_type> h (30, 30), g;
+    for (std::size_t i = 0; i < 30; ++ i)
+        for (std::size_t j = 0; j <= i; ++ j)
+            h (i, j) = i == j ? complex_type (test_value<double> (i)) : test_value<complex_type> (i * 30 + j);
+    std::stringstream hs;
+    hs.precision (17);
+    hs << h;
+    hs >> g;
+    BOOST_UBLAS_TEST_CHECK (hs);
+    BOOST_UBLAS_TEST_CHECK (same (h, g));
+
+    // Matrices that are not symmetric, or hermitian, or square fail
+    std::istringstream a ("[2,2]((1,2),(3,4))"), b ("[2,2](((1,1),(2,1)),((2,1),(4,0)))"), c ("[2,3]((1,2,3),(2,4,5))");
+    r.resize (1, false);
+    r (0, 0) = 9.0;
+    a >> r;
+    BOOST_UBLAS_TEST_CHECK (a.fail ());
+    BOOST_UBLAS_TEST_CHECK_EQ (r (0, 0), 9.0);
+    b >> g;
+    BOOST_UBLAS_TEST_CHECK (b.fail ());
+    c >> r;
+    BOOST_UBLAS_TEST_CHECK (c.fail ());
+    std::istringstream d ("[2,2](((1,0),(2,1)),((2,-1),(4,0)))");
+    d >> g;
+    BOOST_UBLAS_TEST_CHECK (d);
+    BOOST_UBLAS_TEST_CHECK (g (1, 0) == complex_type (2, -1));
+}
+
+// A C library locale with a decimal comma does not reach the text, which
+// follows the stream's classic locale; nothing is checked where no such
+// locale is installed
+BOOST_UBLAS_TEST_DEF ( test_text_io_c_locale )
+{
+    const char *names [] = {"de_DE.UTF-8", "de_DE.utf8", "de_DE", "fr_FR.UTF-8", "fr_FR.utf8", "fr_FR"};
+    bool comma = false;
+    for (std::size_t k = 0; ! comma && k < sizeof (names) / sizeof (names [0]); ++ k)
+        comma = std::setlocale (LC_NUMERIC, names [k]) && std::localeconv ()->decimal_point [0] == ',';
+    if (comma) {
+        BOOST_UBLAS_TEST_CHECK ((check_matrix<double, ublas::row_major> (20, 30)));
+        BOOST_UBLAS_TEST_CHECK ((check_matrix<complex_type, ublas::row_major> (10, 7)));
+    }
+    std::setlocale (LC_NUMERIC, "C");
+}
+
+int main () {
+    BOOST_UBLAS_TEST_BEGIN();
+
+    BOOST_UBLAS_TEST_DO( test_text_io_matrix );
+    BOOST_UBLAS_TEST_DO( test_text_io_vector );
+    BOOST_UBLAS_TEST_DO( test_text_io_syntax );
+    BOOST_UBLAS_TEST_DO( test_text_io_triangles );
+    BOOST_UBLAS_TEST_DO( test_text_io_c_locale );
+
+    BOOST_UBLAS_TEST_END();
+}
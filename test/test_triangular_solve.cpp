@@ -0,0 +1,124 @@
+// Copyright (c) 2017 uBLAS developers
+// Distributed under the Boost Software License, Version 1.0. (See
+// accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+
+// Narrow blocks, a small pool and a low threshold so that the blocked solve
+// runs many diagonal blocks and splits the right hand sides across threads
+#define BOOST_UBLAS_THREADS 4
+#define BOOST_UBLAS_FACTORIZE_BLOCK 16
+#define BOOST_UBLAS_FACTORIZE_PARALLEL_COST 1024
+#define BOOST_UBLAS_TYPE_CHECK 0
+
+#include <cmath>
+#include <limits>
+#include <vector>
+
+#include <boost/numeric/ublas/matrix.hpp>
+#include <boost/numeric/ublas/triangular.hpp>
+#include <boost/numeric/ublas/lu.hpp>
+
+#include "utils.hpp"
+#include "common/random.hpp"
+
+namespace ublas = boost::numeric::ublas;
+
+// Dense, but without the raw storage access the blocked path needs
+typedef ublas::matrix<double, ublas::row_major, std::vector<double> > unblocked_matrix;
+
+template<class M>
+M make_matrix (std::size_t size1, std::size_t size2, unsigned seed) {
+    M m (size1, size2);
+    for (std::size_t i = 0; i < size1; ++ i)
+        for (std::size_t j = 0; j < size2; ++ j)
+            m (i, j) = random_value (seed);
+    return m;
+}
+
+// A dominant diagonal, and entries in the other triangle that the solve
+// must not read
+template<class M>
+M make_triangular (std::size_t size, unsigned seed) {
+    M m (make_matrix<M> (size, size, seed));
+    for (std::size_t i = 0; i < size; ++ i)
+        m (i, i) = 4.0 + m (i, i);
+    return m;
+}
+
+template<class M1, class M2>
+double max_difference (const M1 &m1, const M2 &m2) {
+    double d = 0.0;
+    for (std::size_t i = 0; i < m1.size1 (); ++ i)
+        for (std::size_t j = 0; j < m1.size2 (); ++ j)
+            d = (std::max) (d, std::abs (m1 (i, j) - m2 (i, j)));
+    return d;
+}
+
+template<class MA, class MB, class C>
+bool check_solve (std::size_t size, std::size_t rhs, C) {
+    MA a (make_triangular<MA> (size, unsigned (size + rhs)));
+    MB blocked (make_matrix<MB> (size, rhs, unsigned (size * rhs)));
+    unblocked_matrix unblocked (blocked);
+    ublas::inplace_solve (a, blocked, C ());
+    ublas::inplace_solve (a, unblocked, C ());
+    // Unit triangles with entries of order one grow the solution quickly
+    return max_difference (blocked, unblocked) <= 1e3 * std::numeric_limits<double>::epsilon () * ublas::norm_inf (unblocked);
+}
+
+BOOST_UBLAS_TEST_DEF ( test_triangular_solve_tags )
+{
+    typedef ublas::matrix<double> row_matrix;
+    typedef ublas::matrix<double, ublas::column_major> column_matrix;
+    BOOST_UBLAS_TEST_CHECK ((check_solve<row_matrix, row_matrix> (150, 70, ublas::lower_tag ())));
+    BOOST_UBLAS_TEST_CHECK ((check_solve<row_matrix, row_matrix> (150, 70, ublas::upper_tag ())));
+    BOOST_UBLAS_TEST_CHECK ((check_solve<row_matrix, row_matrix> (150, 70, ublas::unit_lower_tag ())));
+    BOOST_UBLAS_TEST_CHECK ((check_solve<row_matrix, row_matrix> (150, 70, ublas::unit_upper_tag ())));
+    // Mixed layouts, sizes off the block boundaries, a single right hand side
+    BOOST_UBLAS_TEST_CHECK ((check_solve<column_matrix, row_matrix> (101, 33, ublas::lower_tag ())));
+    BOOST_UBLAS_TEST_CHECK ((check_solve<row_matrix, column_matrix> (97, 45, ublas::upper_tag ())));
+    BOOST_UBLAS_TEST_CHECK ((check_solve<column_matrix, column_matrix> (83, 1, ublas::unit_upper_tag ())));
+    BOOST_UBLAS_TEST_CHECK ((check_solve<column_matrix, column_matrix> (17, 200, ublas::unit_lower_tag ())));
+}
+
+// Below one block the unblocked algorithm runs unchanged
+BOOST_UBLAS_TEST_DEF ( test_triangular_solve_small )
+{
+    ublas::matrix<double> a (make_triangular<ublas::matrix<double> > (16, 3));
+    ublas::matrix<double> blocked (make_matrix<ublas::matrix<double> > (16, 40, 4));
+    unblocked_matrix unblocked (blocked);
+    ublas::inplace_solve (a, blocked, ublas::upper_tag ());
+    ublas::inplace_solve (a, unblocked, ublas::upper_tag ());
+    BOOST_UBLAS_TEST_CHECK_EQ (max_difference (blocked, unblocked), 0.0);
+}
+
+BOOST_UBLAS_TEST_DEF ( test_lu_substitute_many )
+{
+    typedef ublas::matrix<double> matrix_type;
+    const std::size_t size = 160;
+    matrix_type a (make_matrix<matrix_type> (size, size, 7)), lu (a);
+    matrix_type x (make_matrix<matrix_type> (size, 90, 8)), b (ublas::prod (a, x));
+    ublas::permutation_matrix<> pm (size);
+    BOOST_UBLAS_TEST_CHECK_EQ (ublas::lu_factorize (lu, pm), std::size_t (0));
+
+    matrix_type solution (b);
+    ublas::lu_substitute (lu, pm, solution);
+    matrix_type r (ublas::prod (a, solution) - b);
+    BOOST_UBLAS_TEST_CHECK (ublas::norm_inf (r) / (ublas::norm_inf (a) * ublas::norm_inf (solution) * size * std::numeric_limits<double>::epsilon ()) < 10.0);
+
+    // solve () goes through the same path
+    matrix_type l (ublas::solve (lu, b, ublas::unit_lower_tag ()));
+    matrix_type lb (l);
+    ublas::inplace_solve (lu, lb, ublas::upper_tag ());
+    matrix_type u (ublas::solve (lu, l, ublas::upper_tag ()));
+    BOOST_UBLAS_TEST_CHECK_EQ (max_difference (u, lb), 0.0);
+}
+
+int main () {
+    BOOST_UBLAS_TEST_BEGIN();
+
+    BOOST_UBLAS_TEST_DO( test_triangular_solve_tags );
+    BOOST_UBLAS_TEST_DO( test_triangular_solve_small );
+    BOOST_UBLAS_TEST_DO( test_lu_substitute_many );
+
+    BOOST_UBLAS_TEST_END();
+}
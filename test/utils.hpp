@@ -151,6 +151,37 @@ bool rel_close_to(::std::complex<T1> const& x, ::std::complex<T2> const& y, T3 t
     return abs(xx-yy)/abs(yy) <= tol;
 }
 
+/// Check if the first \a n elements of two vectors are close each other (wrt a given tolerance).
+template <typename V1, typename V2, typename T>
+bool vector_close_to(V1 const& x, V2 const& y, ::std::size_t n, T tol)
+{
+    for (::std::size_t i = 0; i < n; ++i)
+    {
+        if (!close_to(x[i], y[i], tol))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+/// Check if the first \a nr x \a nc elements of two matrices are close each other (wrt a given tolerance).
+template <typename M1, typename M2, typename T>
+bool matrix_close_to(M1 const& x, M2 const& y, ::std::size_t nr, ::std::size_t nc, T tol)
+{
+    for (::std::size_t i = 0; i < nr; ++i)
+    {
+        for (::std::size_t j = 0; j < nc; ++j)
+        {
+            if (!close_to(x(i,j), y(i,j), tol))
+            {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
 }}}}}} // Namespace boost::numeric::ublas::test::detail::<unnamed>
 
 